@@ -2,26 +2,38 @@
 // Description: AVL Tree implementation with self-balancing rotations
 
 #include "AVLTree.h"
+#include "AllocationTracker.h"
+#include "IntervalTree.h"
+#include "TaskPool.h"
 #include <algorithm>
 #include <sstream>
 
-AVLTree::AVLTree() : root(nullptr), nextNodeId(0) {}
+template <typename Key, typename Compare, typename Augment>
+BasicAVLTree<Key, Compare, Augment>::BasicAVLTree(const Compare& comparator)
+    : root(nullptr), nextNodeId(0), less(comparator) {
+    shape.bind(&root);
+}
 
-AVLTree::~AVLTree() {
+template <typename Key, typename Compare, typename Augment>
+BasicAVLTree<Key, Compare, Augment>::~BasicAVLTree() {
     clear();
 }
 
-int AVLTree::getHeight(AVLNode* node) {
+template <typename Key, typename Compare, typename Augment>
+int BasicAVLTree<Key, Compare, Augment>::getHeight(AVLNode* node) {
     return node ? node->height : 0;
 }
 
-int AVLTree::getBalance(AVLNode* node) {
+template <typename Key, typename Compare, typename Augment>
+int BasicAVLTree<Key, Compare, Augment>::getBalance(AVLNode* node) {
     return node ? getHeight(node->left) - getHeight(node->right) : 0;
 }
 
-void AVLTree::updateHeight(AVLNode* node) {
+template <typename Key, typename Compare, typename Augment>
+void BasicAVLTree<Key, Compare, Augment>::updateHeight(AVLNode* node) {
     if (node) {
         node->height = 1 + std::max(getHeight(node->left), getHeight(node->right));
+        Augment::update(node);
     }
 }
 
@@ -31,10 +43,14 @@ void AVLTree::updateHeight(AVLNode* node) {
 //     x   T3   -->    T1    y
 //    / \                   / \
 //   T1  T2               T2  T3
-AVLNode* AVLTree::rotateRight(AVLNode* y) {
+template <typename Key, typename Compare, typename Augment>
+typename BasicAVLTree<Key, Compare, Augment>::AVLNode* BasicAVLTree<Key, Compare, Augment>::rotateRight(AVLNode* y) {
     AVLNode* x = y->left;
     AVLNode* T2 = x->right;
     
+    // x and y trade levels; T1 moves up one, T3 down one, T2 stays
+    shape.moveSubtree(x);
+    
     // Perform rotation
     x->right = y;
     y->left = T2;
@@ -42,6 +58,8 @@ AVLNode* AVLTree::rotateRight(AVLNode* y) {
     // Update heights
     updateHeight(y);
     updateHeight(x);
+    shape.refresh(y);
+    shape.refresh(x);
     
     return x;  // New root
 }
@@ -52,10 +70,14 @@ AVLNode* AVLTree::rotateRight(AVLNode* y) {
 //   T1  y     -->     x    T3
 //      / \           / \
 //     T2  T3       T1  T2
-AVLNode* AVLTree::rotateLeft(AVLNode* x) {
+template <typename Key, typename Compare, typename Augment>
+typename BasicAVLTree<Key, Compare, Augment>::AVLNode* BasicAVLTree<Key, Compare, Augment>::rotateLeft(AVLNode* x) {
     AVLNode* y = x->right;
     AVLNode* T2 = y->left;
     
+    // Mirror of rotateRight: T3 moves up one, T1 down one
+    shape.moveSubtree(y);
+    
     // Perform rotation
     y->left = x;
     x->right = T2;
@@ -63,32 +85,48 @@ AVLNode* AVLTree::rotateLeft(AVLNode* x) {
     // Update heights
     updateHeight(x);
     updateHeight(y);
+    shape.refresh(x);
+    shape.refresh(y);
     
     return y;  // New root
 }
 
-bool AVLTree::insert(int value, std::vector<AVLNode*>& path, RotationType& rotation) {
+template <typename Key, typename Compare, typename Augment>
+bool BasicAVLTree<Key, Compare, Augment>::insert(const Key& value, std::vector<AVLNode*>& path, RotationType& rotation) {
+    AllocationTracker::Operation scope("AVL insert");
     bool success = true;
     rotation = RotationType::NONE;
-    root = insertHelper(root, value, success, path, rotation);
+    root = insertHelper(root, value, success, path, rotation, 0);
+    if (success) lcaIndex.invalidate();
     return success;
 }
 
-AVLNode* AVLTree::insertHelper(AVLNode* node, int value, bool& success,
-                                std::vector<AVLNode*>& path, RotationType& rotation) {
+template <typename Key, typename Compare, typename Augment>
+typename BasicAVLTree<Key, Compare, Augment>::AVLNode* BasicAVLTree<Key, Compare, Augment>::insertHelper(AVLNode* node, const Key& value, bool& success,
+                                std::vector<AVLNode*>& path, RotationType& rotation, int depth) {
     // Standard BST insert
     if (node == nullptr) {
         AVLNode* newNode = new AVLNode(value, nextNodeId++);
+        Augment::update(newNode);
         path.push_back(newNode);
+        shape.addNode(depth);
+        shape.refresh(newNode);
         return newNode;
     }
     
     path.push_back(node);
     
-    if (value < node->value) {
-        node->left = insertHelper(node->left, value, success, path, rotation);
-    } else if (value > node->value) {
-        node->right = insertHelper(node->right, value, success, path, rotation);
+    // A child that kept its height leaves this node's height and balance
+    // as they were, so nothing here or above needs updating (unless the
+    // node is augmented)
+    if (less(value, node->value)) {
+        int before = getHeight(node->left);
+        node->left = insertHelper(node->left, value, success, path, rotation, depth + 1);
+        if (!AUGMENTED && getHeight(node->left) == before) return node;
+    } else if (less(node->value, value)) {
+        int before = getHeight(node->right);
+        node->right = insertHelper(node->right, value, success, path, rotation, depth + 1);
+        if (!AUGMENTED && getHeight(node->right) == before) return node;
     } else {
         // Duplicate value
         success = false;
@@ -97,31 +135,32 @@ AVLNode* AVLTree::insertHelper(AVLNode* node, int value, bool& success,
     
     // Update height
     updateHeight(node);
+    shape.refresh(node);
     
     // Get balance factor
     int balance = getBalance(node);
     
     // Left Left Case
-    if (balance > 1 && value < node->left->value) {
+    if (balance > 1 && less(value, node->left->value)) {
         rotation = RotationType::RIGHT;
         return rotateRight(node);
     }
     
     // Right Right Case
-    if (balance < -1 && value > node->right->value) {
+    if (balance < -1 && less(node->right->value, value)) {
         rotation = RotationType::LEFT;
         return rotateLeft(node);
     }
     
     // Left Right Case
-    if (balance > 1 && value > node->left->value) {
+    if (balance > 1 && less(node->left->value, value)) {
         rotation = RotationType::LEFT_RIGHT;
         node->left = rotateLeft(node->left);
         return rotateRight(node);
     }
     
     // Right Left Case
-    if (balance < -1 && value < node->right->value) {
+    if (balance < -1 && less(value, node->right->value)) {
         rotation = RotationType::RIGHT_LEFT;
         node->right = rotateRight(node->right);
         return rotateLeft(node);
@@ -130,18 +169,22 @@ AVLNode* AVLTree::insertHelper(AVLNode* node, int value, bool& success,
     return node;
 }
 
-bool AVLTree::remove(int value, std::vector<AVLNode*>& path, AVLNode*& deletedNode,
+template <typename Key, typename Compare, typename Augment>
+bool BasicAVLTree<Key, Compare, Augment>::remove(const Key& value, std::vector<AVLNode*>& path, AVLNode*& deletedNode,
                      RotationType& rotation) {
+    AllocationTracker::Operation scope("AVL delete");
     bool success = true;
     deletedNode = nullptr;
     rotation = RotationType::NONE;
-    root = deleteHelper(root, value, success, path, deletedNode, rotation);
+    root = deleteHelper(root, value, success, path, deletedNode, rotation, 0);
+    if (success) lcaIndex.invalidate();
     return success;
 }
 
-AVLNode* AVLTree::deleteHelper(AVLNode* node, int value, bool& success,
+template <typename Key, typename Compare, typename Augment>
+typename BasicAVLTree<Key, Compare, Augment>::AVLNode* BasicAVLTree<Key, Compare, Augment>::deleteHelper(AVLNode* node, const Key& value, bool& success,
                                 std::vector<AVLNode*>& path, AVLNode*& deletedNode,
-                                RotationType& rotation) {
+                                RotationType& rotation, int depth) {
     if (node == nullptr) {
         success = false;
         return nullptr;
@@ -149,10 +192,15 @@ AVLNode* AVLTree::deleteHelper(AVLNode* node, int value, bool& success,
     
     path.push_back(node);
     
-    if (value < node->value) {
-        node->left = deleteHelper(node->left, value, success, path, deletedNode, rotation);
-    } else if (value > node->value) {
-        node->right = deleteHelper(node->right, value, success, path, deletedNode, rotation);
+    // As in insertHelper, stop updating once a child keeps its height
+    if (less(value, node->value)) {
+        int before = getHeight(node->left);
+        node->left = deleteHelper(node->left, value, success, path, deletedNode, rotation, depth + 1);
+        if (!AUGMENTED && getHeight(node->left) == before) return node;
+    } else if (less(node->value, value)) {
+        int before = getHeight(node->right);
+        node->right = deleteHelper(node->right, value, success, path, deletedNode, rotation, depth + 1);
+        if (!AUGMENTED && getHeight(node->right) == before) return node;
     } else {
         // Found node to delete
         deletedNode = node;
@@ -160,6 +208,8 @@ AVLNode* AVLTree::deleteHelper(AVLNode* node, int value, bool& success,
         // Node with one child or no child
         if (node->left == nullptr || node->right == nullptr) {
             AVLNode* temp = node->left ? node->left : node->right;
+            shape.detach(node, depth);
+            shape.moveSubtree(temp);
             
             if (temp == nullptr) {
                 // No child
@@ -172,7 +222,10 @@ AVLNode* AVLTree::deleteHelper(AVLNode* node, int value, bool& success,
             // Node with two children - get inorder successor
             AVLNode* temp = findMin(node->right);
             node->value = temp->value;
-            node->right = deleteHelper(node->right, temp->value, success, path, deletedNode, rotation);
+            int before = getHeight(node->right);
+            node->right = deleteHelper(node->right, temp->value, success, path, deletedNode, rotation,
+                                       depth + 1);
+            if (!AUGMENTED && getHeight(node->right) == before) return node;
         }
     }
     
@@ -180,6 +233,7 @@ AVLNode* AVLTree::deleteHelper(AVLNode* node, int value, bool& success,
     
     // Update height
     updateHeight(node);
+    shape.refresh(node);
     
     // Get balance factor
     int balance = getBalance(node);
@@ -213,41 +267,97 @@ AVLNode* AVLTree::deleteHelper(AVLNode* node, int value, bool& success,
     return node;
 }
 
-AVLNode* AVLTree::findMin(AVLNode* node) {
+template <typename Key, typename Compare, typename Augment>
+typename BasicAVLTree<Key, Compare, Augment>::AVLNode* BasicAVLTree<Key, Compare, Augment>::findMin(AVLNode* node) {
     while (node && node->left) {
         node = node->left;
     }
     return node;
 }
 
-AVLNode* AVLTree::search(int value, std::vector<AVLNode*>& path) {
+template <typename Key, typename Compare, typename Augment>
+typename BasicAVLTree<Key, Compare, Augment>::AVLNode* BasicAVLTree<Key, Compare, Augment>::search(const Key& value, std::vector<AVLNode*>& path) {
+    AllocationTracker::Operation scope("AVL search");
     return searchHelper(root, value, path);
 }
 
-AVLNode* AVLTree::searchHelper(AVLNode* node, int value, std::vector<AVLNode*>& path) {
+template <typename Key, typename Compare, typename Augment>
+typename BasicAVLTree<Key, Compare, Augment>::AVLNode* BasicAVLTree<Key, Compare, Augment>::searchHelper(AVLNode* node, const Key& value, std::vector<AVLNode*>& path) {
     if (node == nullptr) return nullptr;
     
     path.push_back(node);
     
-    if (value < node->value) {
+    if (less(value, node->value)) {
         return searchHelper(node->left, value, path);
-    } else if (value > node->value) {
+    } else if (less(node->value, value)) {
         return searchHelper(node->right, value, path);
     }
     return node;
 }
 
-bool AVLTree::contains(int value) {
-    std::vector<AVLNode*> path;
-    return search(value, path) != nullptr;
+namespace {
+
+// 'ifTrue' if 'pick' is 1, 'ifFalse' if 0, without a branch. GCC already
+// emits cmov for a ?: after int compares but branches after double ones,
+// so this forces it: cmov on x86-64 GCC / Clang, a bit mask elsewhere.
+// 'pick' is a full register: a bool is set with "setl %sil", which merges
+// with the register's old value - the previous search's last flag - and
+// ties every search to the one before, so their cache misses stop
+// overlapping (2x slower at 1,000,000 keys).
+template <typename Node>
+const Node* selectChild(uintptr_t pick, const Node* ifFalse, const Node* ifTrue) {
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+    __asm__("test %2, %2\n\tcmovne %1, %0" : "+r"(ifFalse) : "r"(ifTrue), "r"(pick) : "cc");
+    return ifFalse;
+#else
+    uintptr_t mask = 0 - pick;
+    return reinterpret_cast<const Node*>((reinterpret_cast<uintptr_t>(ifFalse) & ~mask) |
+                                         (reinterpret_cast<uintptr_t>(ifTrue) & mask));
+#endif
 }
 
-void AVLTree::clear() {
+} // namespace
+
+// Arithmetic keys: the direction is picked with a conditional move, and the
+// only branch is "found"
+template <typename Key, typename Compare, typename Augment>
+const typename BasicAVLTree<Key, Compare, Augment>::AVLNode* BasicAVLTree<Key, Compare, Augment>::findNode(const Key& value, std::true_type) const {
+    const AVLNode* node = root;
+    while (node != nullptr) {
+        uintptr_t goLeft = less(value, node->value);
+        uintptr_t goRight = less(node->value, value);
+        if ((goLeft | goRight) == 0) {
+            return node;
+        }
+        node = selectChild(goRight, node->left, node->right);
+    }
+    return nullptr;
+}
+
+// Other keys: one three-way compare per level
+template <typename Key, typename Compare, typename Augment>
+const typename BasicAVLTree<Key, Compare, Augment>::AVLNode* BasicAVLTree<Key, Compare, Augment>::findNode(const Key& value, std::false_type) const {
+    const AVLNode* node = root;
+    while (node != nullptr) {
+        int order = Search::compare(less, value, node->value);
+        if (order == 0) {
+            return node;
+        }
+        node = order < 0 ? node->left : node->right;
+    }
+    return nullptr;
+}
+
+template <typename Key, typename Compare, typename Augment>
+void BasicAVLTree<Key, Compare, Augment>::clear() {
     clearHelper(root);
     root = nullptr;
+    lcaIndex.invalidate();
+    shape.clear();
 }
 
-void AVLTree::clearHelper(AVLNode* node) {
+template <typename Key, typename Compare, typename Augment>
+void BasicAVLTree<Key, Compare, Augment>::clearHelper(AVLNode* node) {
     if (node) {
         clearHelper(node->left);
         clearHelper(node->right);
@@ -255,21 +365,32 @@ void AVLTree::clearHelper(AVLNode* node) {
     }
 }
 
-bool AVLTree::isEmpty() const {
+template <typename Key, typename Compare, typename Augment>
+bool BasicAVLTree<Key, Compare, Augment>::isEmpty() const {
     return root == nullptr;
 }
 
-AVLNode* AVLTree::getRoot() const {
+template <typename Key, typename Compare, typename Augment>
+typename BasicAVLTree<Key, Compare, Augment>::AVLNode* BasicAVLTree<Key, Compare, Augment>::getRoot() const {
     return root;
 }
 
-std::vector<AVLNode*> AVLTree::getAllNodes() {
+template <typename Key, typename Compare, typename Augment>
+typename BasicAVLTree<Key, Compare, Augment>::AVLNode* BasicAVLTree<Key, Compare, Augment>::lowestCommonAncestor(const AVLNode* a, const AVLNode* b) {
+    // Lazily rebuilt after changes, like BST::lowestCommonAncestor
+    if (!lcaIndex.isValid()) lcaIndex.build(root);
+    return lcaIndex.query(a, b);
+}
+
+template <typename Key, typename Compare, typename Augment>
+std::vector<typename BasicAVLTree<Key, Compare, Augment>::AVLNode*> BasicAVLTree<Key, Compare, Augment>::getAllNodes() {
     std::vector<AVLNode*> nodes;
     collectNodes(root, nodes);
     return nodes;
 }
 
-void AVLTree::collectNodes(AVLNode* node, std::vector<AVLNode*>& nodes) {
+template <typename Key, typename Compare, typename Augment>
+void BasicAVLTree<Key, Compare, Augment>::collectNodes(AVLNode* node, std::vector<AVLNode*>& nodes) {
     if (node) {
         nodes.push_back(node);
         collectNodes(node->left, nodes);
@@ -277,17 +398,20 @@ void AVLTree::collectNodes(AVLNode* node, std::vector<AVLNode*>& nodes) {
     }
 }
 
-int AVLTree::getTreeHeight() const {
+template <typename Key, typename Compare, typename Augment>
+int BasicAVLTree<Key, Compare, Augment>::getTreeHeight() const {
     return root ? root->height : 0;
 }
 
-std::vector<int> AVLTree::inorderTraversal() {
-    std::vector<int> result;
+template <typename Key, typename Compare, typename Augment>
+std::vector<Key> BasicAVLTree<Key, Compare, Augment>::inorderTraversal() {
+    std::vector<Key> result;
     inorderHelper(root, result);
     return result;
 }
 
-void AVLTree::inorderHelper(AVLNode* node, std::vector<int>& result) {
+template <typename Key, typename Compare, typename Augment>
+void BasicAVLTree<Key, Compare, Augment>::inorderHelper(AVLNode* node, std::vector<Key>& result) {
     if (node) {
         inorderHelper(node->left, result);
         result.push_back(node->value);
@@ -295,7 +419,8 @@ void AVLTree::inorderHelper(AVLNode* node, std::vector<int>& result) {
     }
 }
 
-std::string AVLTree::getRotationName(RotationType type) {
+template <typename Key, typename Compare, typename Augment>
+std::string BasicAVLTree<Key, Compare, Augment>::getRotationName(RotationType type) {
     switch (type) {
         case RotationType::LEFT: return "Left Rotation";
         case RotationType::RIGHT: return "Right Rotation";
@@ -305,3 +430,435 @@ std::string AVLTree::getRotationName(RotationType type) {
     }
 }
 
+
+// ============================================================================
+// BULK LOAD
+// ============================================================================
+
+template <typename Key, typename Compare, typename Augment>
+std::vector<Key> BasicAVLTree<Key, Compare, Augment>::preorderTraversal() {
+    std::vector<Key> result;
+    std::vector<AVLNode*> stack;
+    if (root) stack.push_back(root);
+    
+    while (!stack.empty()) {
+        AVLNode* node = stack.back();
+        stack.pop_back();
+        result.push_back(node->value);
+        if (node->right) stack.push_back(node->right);
+        if (node->left) stack.push_back(node->left);
+    }
+    return result;
+}
+
+template <typename Key, typename Compare, typename Augment>
+void BasicAVLTree<Key, Compare, Augment>::loadPreorder(const std::vector<Key>& values) {
+    clear();
+    if (values.empty()) return;
+    
+    // Same construction as BST::loadPreorder
+    std::vector<AVLNode*> created;
+    created.reserve(values.size());
+    root = new AVLNode(values[0], nextNodeId++);
+    created.push_back(root);
+    
+    std::vector<AVLNode*> stack;
+    stack.push_back(root);
+    for (size_t i = 1; i < values.size(); i++) {
+        AVLNode* node = new AVLNode(values[i], nextNodeId++);
+        created.push_back(node);
+        AVLNode* parent = nullptr;
+        while (!stack.empty() && less(stack.back()->value, values[i])) {
+            parent = stack.back();
+            stack.pop_back();
+        }
+        if (parent) {
+            parent->right = node;
+        } else {
+            stack.back()->left = node;
+        }
+        stack.push_back(node);
+    }
+    
+    // Children are created after their parents, so a reverse sweep
+    // sees both subtrees before the node itself
+    for (size_t i = created.size(); i-- > 0; ) {
+        updateHeight(created[i]);
+    }
+    shape.rebuild(root);
+}
+
+
+// ============================================================================
+// BULK SET OPERATIONS
+// ============================================================================
+// Join-based, after Blelloch, Ferizovic and Sun, "Just Join for Parallel
+// Ordered Sets" (SPAA 2016). join(L, k, R) links two trees around a node k,
+// with every key of L < k < every key of R, in O(|h(L) - h(R)|) by walking
+// down the taller side. split(T, k) cuts a tree at a key in O(log n) with
+// joins. A set operation takes the root key k of 'other', splits this tree
+// at k, and recurses on the two halves, which share no keys. That is
+// O(m log(n/m + 1)) work for sizes m <= n and O(log^2 n) span.
+//
+// TaskPool runs nested loops inline, so the halves are not forked one level
+// at a time. The top levels are expanded on the calling thread into about
+// eight independent subproblems per pool thread, parallelFor runs each of
+// them sequentially, and a backwards sweep joins the results.
+// ============================================================================
+
+namespace {
+
+enum class SetOp { UNION, INTERSECTION, DIFFERENCE };
+
+// Expand no further once either tree is this short (about 100 nodes)
+const int PARALLEL_MIN_HEIGHT = 7;
+
+template <typename Node>
+int heightOf(const Node* node) {
+    return node ? node->height : 0;
+}
+
+template <typename Node>
+void fixHeight(Node* node) {
+    node->height = 1 + std::max(heightOf(node->left), heightOf(node->right));
+    Node::AugmentType::update(node);
+}
+
+// Rotations without the ShapeStats bookkeeping; the result is recounted
+// once at the end. Like every height change here they go through
+// fixHeight(), which also updates the node's Augment fields.
+template <typename Node>
+Node* rotateRightUncounted(Node* y) {
+    Node* x = y->left;
+    y->left = x->right;
+    x->right = y;
+    fixHeight(y);
+    fixHeight(x);
+    return x;
+}
+
+template <typename Node>
+Node* rotateLeftUncounted(Node* x) {
+    Node* y = x->right;
+    x->right = y->left;
+    y->left = x;
+    fixHeight(x);
+    fixHeight(y);
+    return y;
+}
+
+template <typename Node>
+Node* joinTrees(Node* left, Node* key, Node* right);
+
+// 'left' is at least two levels taller: walk down its right spine to a
+// subtree about as tall as 'right', link there, and rebalance on the way up
+template <typename Node>
+Node* joinRight(Node* left, Node* key, Node* right) {
+    Node* inner = left->right;
+    Node* joined;
+    if (heightOf(inner) <= heightOf(right) + 1) {
+        key->left = inner;
+        key->right = right;
+        fixHeight(key);
+        joined = key;
+        if (heightOf(joined) > heightOf(left->left) + 1) {
+            // Right-Left case
+            left->right = rotateRightUncounted(joined);
+            fixHeight(left);
+            return rotateLeftUncounted(left);
+        }
+    } else {
+        joined = joinRight(inner, key, right);
+    }
+    left->right = joined;
+    fixHeight(left);
+    if (heightOf(joined) > heightOf(left->left) + 1) return rotateLeftUncounted(left);
+    return left;
+}
+
+// Mirror of joinRight
+template <typename Node>
+Node* joinLeft(Node* left, Node* key, Node* right) {
+    Node* inner = right->left;
+    Node* joined;
+    if (heightOf(inner) <= heightOf(left) + 1) {
+        key->left = left;
+        key->right = inner;
+        fixHeight(key);
+        joined = key;
+        if (heightOf(joined) > heightOf(right->right) + 1) {
+            // Left-Right case
+            right->left = rotateLeftUncounted(joined);
+            fixHeight(right);
+            return rotateRightUncounted(right);
+        }
+    } else {
+        joined = joinLeft(left, key, inner);
+    }
+    right->left = joined;
+    fixHeight(right);
+    if (heightOf(joined) > heightOf(right->right) + 1) return rotateRightUncounted(right);
+    return right;
+}
+
+template <typename Node>
+Node* joinTrees(Node* left, Node* key, Node* right) {
+    if (heightOf(left) > heightOf(right) + 1) return joinRight(left, key, right);
+    if (heightOf(right) > heightOf(left) + 1) return joinLeft(left, key, right);
+    key->left = left;
+    key->right = right;
+    fixHeight(key);
+    return key;
+}
+
+// Cut a tree into the keys below 'value', the node holding it (nullptr if
+// absent, otherwise detached) and the keys above it
+template <typename Node, typename Key, typename Compare>
+void splitTree(Node* node, const Key& value, const Compare& compare,
+               Node*& less, Node*& found, Node*& greater) {
+    if (node == nullptr) {
+        less = found = greater = nullptr;
+        return;
+    }
+    Node* left = node->left;
+    Node* right = node->right;
+    Node* middle;
+    if (compare(value, node->value)) {
+        splitTree(left, value, compare, less, found, middle);
+        greater = joinTrees(middle, node, right);
+    } else if (compare(node->value, value)) {
+        splitTree(right, value, compare, middle, found, greater);
+        less = joinTrees(left, node, middle);
+    } else {
+        less = left;
+        greater = right;
+        found = node;
+        node->left = node->right = nullptr;
+        fixHeight(node);
+    }
+}
+
+// Detach the largest node of a non-empty tree and return the rest
+template <typename Node>
+Node* splitLast(Node* node, Node*& last) {
+    if (node->right == nullptr) {
+        Node* rest = node->left;
+        node->left = nullptr;
+        fixHeight(node);
+        last = node;
+        return rest;
+    }
+    Node* rest = splitLast(node->right, last);
+    return joinTrees(node->left, node, rest);
+}
+
+// join() without a middle key: borrow the largest key of 'left'
+template <typename Node>
+Node* joinPair(Node* left, Node* right) {
+    if (left == nullptr) return right;
+    Node* last;
+    Node* rest = splitLast(left, last);
+    return joinTrees(rest, last, right);
+}
+
+template <typename Node>
+void deleteTree(Node* node) {
+    if (node) {
+        deleteTree(node->left);
+        deleteTree(node->right);
+        delete node;
+    }
+}
+
+// Nodes moved over from 'other' get ids above every id of this tree
+template <typename Node>
+void offsetIds(Node* node, int offset) {
+    if (node) {
+        node->id += offset;
+        offsetIds(node->left, offset);
+        offsetIds(node->right, offset);
+    }
+}
+
+// Result when 'a' (this tree) or 'b' (other) is empty
+template <typename Node>
+Node* setOpBase(SetOp op, Node* a, Node* b, int idOffset) {
+    switch (op) {
+        case SetOp::UNION:
+            if (a) return a;
+            offsetIds(b, idOffset);
+            return b;
+        case SetOp::INTERSECTION:
+            deleteTree(a);
+            deleteTree(b);
+            return nullptr;
+        default:
+            deleteTree(b);
+            return a;
+    }
+}
+
+// One level of the recursion: split 'a' at the root key of 'b'. 'pivot' is
+// the node between the two halves in the result, or nullptr if the key is
+// not in it. Where both trees hold the key, this tree's node is kept.
+template <typename Node>
+struct SetOpStep {
+    Node* aLess;
+    Node* aGreater;
+    Node* bLess;
+    Node* bGreater;
+    Node* pivot;
+};
+
+template <typename Node, typename Compare>
+SetOpStep<Node> splitAtRoot(SetOp op, Node* a, Node* b, int idOffset, const Compare& compare) {
+    SetOpStep<Node> step;
+    Node* found;
+    splitTree(a, b->value, compare, step.aLess, found, step.aGreater);
+    step.bLess = b->left;
+    step.bGreater = b->right;
+    b->left = b->right = nullptr;
+
+    if (op == SetOp::UNION && found == nullptr) {
+        b->id += idOffset;
+        step.pivot = b;
+        return step;
+    }
+    delete b;
+    if (op == SetOp::DIFFERENCE) {
+        delete found;
+        step.pivot = nullptr;
+    } else {
+        step.pivot = found;
+    }
+    return step;
+}
+
+template <typename Node>
+Node* combine(Node* pivot, Node* left, Node* right) {
+    return pivot ? joinTrees(left, pivot, right) : joinPair(left, right);
+}
+
+template <typename Node, typename Compare>
+Node* setOpSequential(SetOp op, Node* a, Node* b, int idOffset, const Compare& compare) {
+    if (a == nullptr || b == nullptr) return setOpBase(op, a, b, idOffset);
+    SetOpStep<Node> step = splitAtRoot(op, a, b, idOffset, compare);
+    Node* left = setOpSequential(op, step.aLess, step.bLess, idOffset, compare);
+    Node* right = setOpSequential(op, step.aGreater, step.bGreater, idOffset, compare);
+    return combine(step.pivot, left, right);
+}
+
+// The expanded top levels: a subproblem still to run ('leaf'), or a join
+// of two later pieces around 'pivot'
+template <typename Node>
+struct SetOpPiece {
+    Node* a;
+    Node* b;
+    Node* pivot;
+    size_t left;
+    size_t right;
+    bool leaf;
+    Node* result;
+};
+
+template <typename Node, typename Compare>
+size_t expandSetOp(SetOp op, Node* a, Node* b, int idOffset, const Compare& compare, int levels,
+                   std::vector<SetOpPiece<Node>>& pieces, std::vector<size_t>& leaves) {
+    size_t index = pieces.size();
+    pieces.push_back(SetOpPiece<Node>{a, b, nullptr, 0, 0, true, nullptr});
+    if (levels == 0 || std::min(heightOf(a), heightOf(b)) < PARALLEL_MIN_HEIGHT) {
+        leaves.push_back(index);
+        return index;
+    }
+    SetOpStep<Node> step = splitAtRoot(op, a, b, idOffset, compare);
+    size_t left = expandSetOp(op, step.aLess, step.bLess, idOffset, compare, levels - 1, pieces, leaves);
+    size_t right = expandSetOp(op, step.aGreater, step.bGreater, idOffset, compare, levels - 1,
+                               pieces, leaves);
+    SetOpPiece<Node>& piece = pieces[index];
+    piece.leaf = false;
+    piece.pivot = step.pivot;
+    piece.left = left;
+    piece.right = right;
+    return index;
+}
+
+template <typename Node, typename Compare>
+Node* runSetOp(SetOp op, Node* a, Node* b, int idOffset, const Compare& compare) {
+    TaskPool& pool = TaskPool::shared();
+    if (pool.size() == 1) return setOpSequential(op, a, b, idOffset, compare);
+
+    int levels = 0;
+    while ((1u << levels) < pool.size() * 8) levels++;
+    std::vector<SetOpPiece<Node>> pieces;
+    std::vector<size_t> leaves;
+    expandSetOp(op, a, b, idOffset, compare, levels, pieces, leaves);
+
+    pool.parallelFor(leaves.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            SetOpPiece<Node>& piece = pieces[leaves[i]];
+            piece.result = setOpSequential(op, piece.a, piece.b, idOffset, compare);
+        }
+    });
+
+    // Pieces come after their parent, so a backwards sweep sees both
+    // halves of a join before the join itself
+    for (size_t i = pieces.size(); i-- > 0; ) {
+        SetOpPiece<Node>& piece = pieces[i];
+        if (!piece.leaf) {
+            piece.result = combine(piece.pivot, pieces[piece.left].result, pieces[piece.right].result);
+        }
+    }
+    return pieces[0].result;
+}
+
+} // namespace
+
+template <typename Key, typename Compare, typename Augment>
+void BasicAVLTree<Key, Compare, Augment>::unionWith(BasicAVLTree& other) {
+    AllocationTracker::Operation scope("AVL union");
+    if (&other == this) return;
+    root = runSetOp(SetOp::UNION, root, other.root, nextNodeId, less);
+    nextNodeId += other.nextNodeId;
+    finishSetOperation(other);
+}
+
+template <typename Key, typename Compare, typename Augment>
+void BasicAVLTree<Key, Compare, Augment>::intersectWith(BasicAVLTree& other) {
+    AllocationTracker::Operation scope("AVL intersection");
+    if (&other == this) return;
+    root = runSetOp(SetOp::INTERSECTION, root, other.root, 0, less);
+    finishSetOperation(other);
+}
+
+template <typename Key, typename Compare, typename Augment>
+void BasicAVLTree<Key, Compare, Augment>::differenceWith(BasicAVLTree& other) {
+    AllocationTracker::Operation scope("AVL difference");
+    if (&other == this) {
+        clear();
+        return;
+    }
+    root = runSetOp(SetOp::DIFFERENCE, root, other.root, 0, less);
+    finishSetOperation(other);
+}
+
+template <typename Key, typename Compare, typename Augment>
+void BasicAVLTree<Key, Compare, Augment>::finishSetOperation(BasicAVLTree& other) {
+    other.root = nullptr;
+    other.lcaIndex.invalidate();
+    other.shape.clear();
+    lcaIndex.invalidate();
+    shape.invalidate();
+}
+
+// ============================================================================
+// INSTANTIATIONS
+// ============================================================================
+// The key types the visualizer and the benchmarks use, and the augmented
+// tree behind IntervalTree
+
+template class BasicAVLTree<int>;
+template class BasicAVLTree<long long>;
+template class BasicAVLTree<double>;
+template class BasicAVLTree<std::string>;
+template class BasicAVLTree<ShortKey>;
+template class BasicAVLTree<Interval, KeyCompare<Interval>, MaxEndpoint>;
@@ -2,20 +2,62 @@
 // Description: AVL Tree - Self-balancing Binary Search Tree
 // AVL trees maintain balance by ensuring the height difference between
 // left and right subtrees is at most 1. Rotations restore balance.
+//
+// BasicAVLTree<Key, Compare> is templated on the key type; AVLTree is the
+// int tree the visualizer, console and exporters use. The members are
+// defined in AVLTree.cpp and instantiated there for int, long long,
+// double, std::string and ShortKey (see KeyTypes.h).
+//
+// An optional Augment policy keeps extra per-node data that depends on the
+// subtree, such as IntervalTree's largest endpoint. Nodes derive from the
+// policy, so its fields are node fields, and the tree calls its static
+// update(node) whenever a node's children or height change: on the insert
+// and delete paths, in every rotation and in bulk loads and joins, always
+// below before above. NoAugment adds no fields and no work.
+//
+// find() / contains() descend without recording a path, specialized per
+// key type at compile time (see KeySearch):
+// - arithmetic keys descend without branching on the direction. Each level
+//   is one load, two compares and a conditional move that picks the child.
+//   The only branch is "found", taken once per search, so it is always
+//   predicted.
+// - other keys compare three-way, since one compare may cost more than a
+//   mispredicted branch, and branch on its result
 
 #ifndef AVLTREE_H
 #define AVLTREE_H
 
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 #include <string>
+#include "KeyTypes.h"
+#include "TreeLca.h"
+#include "MemoryAccount.h"
+#include "ShapeStats.h"
+
+// ============================================================================
+// AUGMENTATION
+// ============================================================================
+// The default policy: nothing to keep up to date
+struct NoAugment {
+    template <typename Node>
+    static void update(Node*) {}
+};
 
 // ============================================================================
 // AVL NODE STRUCTURE
 // ============================================================================
-struct AVLNode {
-    int value;
-    AVLNode* left;
-    AVLNode* right;
+template <typename Key, typename Augment = NoAugment>
+struct BasicAVLNode : TrackedAllocation<MemoryAccount::STRUCTURE_NODES>, Augment {
+    typedef Augment AugmentType;
+    
+
+    Key value;
+    int shapeCode;      // ShapeStats bucket (see ShapeStats.h)
+    BasicAVLNode* left;
+    BasicAVLNode* right;
     int height;         // Height of subtree rooted at this node
     
     // Visual properties
@@ -23,11 +65,13 @@ struct AVLNode {
     float x, y;
     float targetX, targetY;
     
-    AVLNode(int val, int nodeId) 
-        : value(val), left(nullptr), right(nullptr), height(1),
+    BasicAVLNode(const Key& val, int nodeId)
+        : value(val), shapeCode(-1), left(nullptr), right(nullptr), height(1),
           id(nodeId), x(0), y(0), targetX(0), targetY(0) {}
 };
 
+typedef BasicAVLNode<int> AVLNode;
+
 // Rotation type for animation
 enum class RotationType {
     NONE,
@@ -40,10 +84,26 @@ enum class RotationType {
 // ============================================================================
 // AVL TREE CLASS
 // ============================================================================
-class AVLTree {
+template <typename Key = int, typename Compare = KeyCompare<Key>, typename Augment = NoAugment>
+class BasicAVLTree {
+public:
+    typedef Key KeyType;
+    typedef BasicAVLNode<Key, Augment> AVLNode;
+    typedef AVLNode NodeType;
+
 private:
+    typedef KeySearch<Key, Compare> Search;
+    
+    // An augmented node's fields change even when its height doesn't, so
+    // insert and delete can't stop early on the way back up
+    static const bool AUGMENTED = !std::is_same<Augment, NoAugment>::value;
+
     AVLNode* root;
     int nextNodeId;
+    Compare less;
+    EulerTourLCA<AVLNode> lcaIndex;     // Stale after any change (see TreeLca.h)
+    mutable ShapeStats shape;           // Updated along each insert / delete path;
+                                        // recounted on read after a set operation
     
     // Get height of a node (0 if null)
     int getHeight(AVLNode* node);
@@ -51,7 +111,7 @@ private:
     // Get balance factor (left height - right height)
     int getBalance(AVLNode* node);
     
-    // Update height of a node
+    // Update height of a node, then its Augment fields
     void updateHeight(AVLNode* node);
     
     // Rotation operations
@@ -59,19 +119,24 @@ private:
     AVLNode* rotateLeft(AVLNode* x);
     
     // Recursive insert with balancing
-    AVLNode* insertHelper(AVLNode* node, int value, bool& success, 
-                          std::vector<AVLNode*>& path, RotationType& rotation);
+    AVLNode* insertHelper(AVLNode* node, const Key& value, bool& success,
+                          std::vector<AVLNode*>& path, RotationType& rotation, int depth);
     
     // Recursive delete with balancing
-    AVLNode* deleteHelper(AVLNode* node, int value, bool& success,
+    AVLNode* deleteHelper(AVLNode* node, const Key& value, bool& success,
                           std::vector<AVLNode*>& path, AVLNode*& deletedNode,
-                          RotationType& rotation);
+                          RotationType& rotation, int depth);
     
     // Find minimum node
     AVLNode* findMin(AVLNode* node);
     
     // Recursive search
-    AVLNode* searchHelper(AVLNode* node, int value, std::vector<AVLNode*>& path);
+    AVLNode* searchHelper(AVLNode* node, const Key& value, std::vector<AVLNode*>& path);
+    
+    // Path-free descents for find(): branchless (arithmetic keys) or
+    // three-way
+    const AVLNode* findNode(const Key& value, std::true_type branchless) const;
+    const AVLNode* findNode(const Key& value, std::false_type branchless) const;
     
     // Clear all nodes
     void clearHelper(AVLNode* node);
@@ -80,24 +145,35 @@ private:
     void collectNodes(AVLNode* node, std::vector<AVLNode*>& nodes);
     
     // In-order traversal helper
-    void inorderHelper(AVLNode* node, std::vector<int>& result);
+    void inorderHelper(AVLNode* node, std::vector<Key>& result);
+    
+    // Empty 'other' and recount this tree after a bulk set operation
+    void finishSetOperation(BasicAVLTree& other);
 
 public:
-    AVLTree();
-    ~AVLTree();
+    explicit BasicAVLTree(const Compare& comparator = Compare());
+    ~BasicAVLTree();
+    
+    BasicAVLTree(const BasicAVLTree&) = delete;
+    BasicAVLTree& operator=(const BasicAVLTree&) = delete;
     
     // Insert a value (returns rotation type for animation)
-    bool insert(int value, std::vector<AVLNode*>& path, RotationType& rotation);
+    bool insert(const Key& value, std::vector<AVLNode*>& path, RotationType& rotation);
     
     // Delete a value
-    bool remove(int value, std::vector<AVLNode*>& path, AVLNode*& deletedNode, 
+    bool remove(const Key& value, std::vector<AVLNode*>& path, AVLNode*& deletedNode,
                 RotationType& rotation);
     
     // Search for a value
-    AVLNode* search(int value, std::vector<AVLNode*>& path);
+    AVLNode* search(const Key& value, std::vector<AVLNode*>& path);
+    
+    // Node holding the value (nullptr if absent), without recording a path
+    const AVLNode* find(const Key& value) const {
+        return findNode(value, std::integral_constant<bool, Search::BRANCHLESS>());
+    }
     
     // Check if contains
-    bool contains(int value);
+    bool contains(const Key& value) const { return find(value) != nullptr; }
     
     // Clear tree
     void clear();
@@ -111,15 +187,41 @@ public:
     // Get all nodes
     std::vector<AVLNode*> getAllNodes();
     
+    // O(1) lowest common ancestor, as BST::lowestCommonAncestor
+    AVLNode* lowestCommonAncestor(const AVLNode* a, const AVLNode* b);
+    
     // Get tree height
     int getTreeHeight() const;
     
+    // Live shape statistics (depth histogram, balance factors, leaves)
+    const ShapeStats& getShapeStats() const {
+        if (shape.isStale()) shape.rebuild(root);
+        return shape;
+    }
+    
     // In-order traversal
-    std::vector<int> inorderTraversal();
+    std::vector<Key> inorderTraversal();
+    
+    // Pre-order traversal (loadPreorder() rebuilds the same shape)
+    std::vector<Key> preorderTraversal();
+    
+    // Replace the tree with one built from a pre-order sequence in O(n)
+    void loadPreorder(const std::vector<Key>& values);
+    
+    // Bulk set operations, join-based with the top levels forked onto
+    // TaskPool::shared() (see AVLTree.cpp). The result replaces this tree
+    // and 'other' is left empty: its nodes are moved over or freed. Work is
+    // O(m log(n/m + 1)) for sizes m <= n, plus freeing the dropped nodes.
+    // The shape statistics are recounted in O(n) when next read.
+    void unionWith(BasicAVLTree& other);
+    void intersectWith(BasicAVLTree& other);
+    void differenceWith(BasicAVLTree& other);   // Keeps the keys not in 'other'
     
     // Get rotation name for display
     static std::string getRotationName(RotationType type);
 };
 
+typedef BasicAVLTree<> AVLTree;
+
 #endif // AVLTREE_H
 
@@ -0,0 +1,226 @@
+// File: AllocationTracker.cpp
+// Description: Thread-local allocation counters and, with
+// ALLOCATION_TRACKER defined, the replacement global operator new / delete
+
+#include "AllocationTracker.h"
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <new>
+
+const int AllocationTracker::MAX_OPERATIONS;
+
+namespace {
+    // Trivial, so it is zero-initialized without a TLS init guard and
+    // operator new can touch it at any time, even during thread startup
+    struct ThreadState {
+        AllocationTracker::FrameStats current;
+        AllocationTracker::FrameStats last;
+        AllocationTracker::Phase phase;
+        size_t quiet;
+        AllocationTracker::OperationStats operations[AllocationTracker::MAX_OPERATIONS];
+        int operationCount;
+        AllocationTracker::OperationStats* active;
+        AllocationTracker::OperationStats* latest;
+        int ignoring;
+    };
+
+    thread_local ThreadState state;
+}
+
+// ============================================================================
+// FRAMES
+// ============================================================================
+
+bool AllocationTracker::enabled() {
+#ifdef ALLOCATION_TRACKER
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AllocationTracker::beginFrame() {
+    state.last = state.current;
+    state.current = FrameStats();
+    state.phase = EVENTS;
+    state.quiet = state.last.totalAllocations() == 0 ? state.quiet + 1 : 0;
+}
+
+void AllocationTracker::setPhase(Phase phase) {
+    state.phase = phase;
+}
+
+const AllocationTracker::FrameStats& AllocationTracker::lastFrame() {
+    return state.last;
+}
+
+size_t AllocationTracker::quietFrames() {
+    return state.quiet;
+}
+
+const char* AllocationTracker::phaseName(Phase phase) {
+    switch (phase) {
+        case EVENTS: return "events";
+        case UPDATE: return "update";
+        case DRAW:   return "draw";
+        default:     return "?";
+    }
+}
+
+// ============================================================================
+// OPERATIONS
+// ============================================================================
+
+AllocationTracker::OperationStats* AllocationTracker::enterOperation(const char* name) {
+    OperationStats* entry = nullptr;
+    for (int i = 0; i < state.operationCount && entry == nullptr; i++) {
+        OperationStats& candidate = state.operations[i];
+        if (candidate.name == name || std::strcmp(candidate.name, name) == 0) {
+            entry = &candidate;
+        }
+    }
+    if (entry == nullptr) {
+        // The last slot collects everything once the table is full
+        if (state.operationCount < MAX_OPERATIONS) {
+            entry = &state.operations[state.operationCount++];
+            entry->name = state.operationCount < MAX_OPERATIONS ? name : "(other)";
+        } else {
+            entry = &state.operations[MAX_OPERATIONS - 1];
+        }
+    }
+
+    entry->calls++;
+    entry->lastAllocations = 0;
+    entry->lastBytes = 0;
+    OperationStats* previous = state.active;
+    state.active = entry;
+    state.latest = entry;
+    return previous;
+}
+
+void AllocationTracker::leaveOperation(OperationStats* previous) {
+    state.active = previous;
+}
+
+int AllocationTracker::operationCount() {
+    return state.operationCount;
+}
+
+const AllocationTracker::OperationStats& AllocationTracker::operation(int index) {
+    return state.operations[index];
+}
+
+const AllocationTracker::OperationStats* AllocationTracker::lastOperation() {
+    return state.latest;
+}
+
+void AllocationTracker::print(std::ostream& out) {
+    out << "  " << std::left << std::setw(24) << "operation" << std::right
+        << std::setw(12) << "calls" << std::setw(14) << "allocs/call" << std::setw(14) << "bytes/call" << "\n";
+    for (int i = 0; i < state.operationCount; i++) {
+        const OperationStats& entry = state.operations[i];
+        double calls = static_cast<double>(entry.calls);
+        out << "  " << std::left << std::setw(24) << entry.name << std::right
+            << std::setw(12) << entry.calls << std::fixed << std::setprecision(2)
+            << std::setw(14) << static_cast<double>(entry.allocations) / calls
+            << std::setw(14) << static_cast<double>(entry.bytes) / calls << "\n";
+    }
+}
+
+// ============================================================================
+// COUNTING
+// ============================================================================
+
+void AllocationTracker::setIgnoring(bool ignoring) {
+    state.ignoring += ignoring ? 1 : -1;
+}
+
+void AllocationTracker::recordAllocation(size_t bytes) {
+    if (state.ignoring > 0) {
+        return;
+    }
+    state.current.allocations[state.phase]++;
+    state.current.bytes[state.phase] += bytes;
+    if (OperationStats* entry = state.active) {
+        entry->allocations++;
+        entry->bytes += bytes;
+        entry->lastAllocations++;
+        entry->lastBytes += bytes;
+    }
+}
+
+void AllocationTracker::recordFree() {
+    if (state.ignoring > 0) {
+        return;
+    }
+    state.current.frees++;
+}
+
+#ifdef ALLOCATION_TRACKER
+
+// ============================================================================
+// REPLACEMENT OPERATOR NEW / DELETE
+// ============================================================================
+// Aligned (std::align_val_t) forms keep the library versions; nothing in
+// the visualizer over-aligns.
+
+void* operator new(std::size_t size) {
+    AllocationTracker::recordAllocation(size);
+    if (size == 0) size = 1;
+    for (;;) {
+        if (void* memory = std::malloc(size)) {
+            return memory;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return ::operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return ::operator new(size, std::nothrow);
+}
+
+void operator delete(void* memory) noexcept {
+    if (memory != nullptr) {
+        AllocationTracker::recordFree();
+        std::free(memory);
+    }
+}
+
+void operator delete[](void* memory) noexcept {
+    ::operator delete(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    ::operator delete(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    ::operator delete(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    ::operator delete(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    ::operator delete(memory);
+}
+
+#endif // ALLOCATION_TRACKER
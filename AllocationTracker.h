@@ -0,0 +1,126 @@
+// File: AllocationTracker.h
+// Description: Opt-in global allocation counting, attributed to the phase
+// of the current frame and to the structure operation that is running.
+//
+// Built with -DALLOCATION_TRACKER, AllocationTracker.cpp replaces the
+// global operator new / delete. Every allocation is then counted in
+// thread-local counters, so the render loop can be checked for the goal of
+// zero allocations per frame once nothing changes:
+// - Each mode loop calls beginFrame() at the top, and setPhase(UPDATE) /
+//   setPhase(DRAW) where those parts start. beginFrame() moves the
+//   counters of the frame that just ended into lastFrame().
+// - Structure operations open an Operation scope ("BST insert", ...).
+//   Allocations inside it are charged to that operation as well; nested
+//   scopes charge the innermost one.
+// Counters are per thread: the HUD shows the main thread's. Work handed to
+// TaskPool threads is counted on those threads.
+//
+// Without the define nothing is replaced, enabled() is false and the
+// Operation scope is an empty object.
+//
+// MemoryAccount answers "how much memory does each layer hold"; this
+// answers "who allocates, and how often".
+
+#ifndef ALLOCATION_TRACKER_H
+#define ALLOCATION_TRACKER_H
+
+#include <cstddef>
+#include <iostream>
+
+// ============================================================================
+// ALLOCATION TRACKER
+// ============================================================================
+class AllocationTracker {
+public:
+    enum Phase {
+        EVENTS,             // From beginFrame() through the event loop
+        UPDATE,             // Console / socket commands and animation updates
+        DRAW,               // window.clear() to window.display()
+        PHASE_COUNT
+    };
+
+    struct FrameStats {
+        size_t allocations[PHASE_COUNT];
+        size_t bytes[PHASE_COUNT];
+        size_t frees;
+
+        size_t totalAllocations() const { return allocations[EVENTS] + allocations[UPDATE] + allocations[DRAW]; }
+        size_t totalBytes() const { return bytes[EVENTS] + bytes[UPDATE] + bytes[DRAW]; }
+    };
+
+    struct OperationStats {
+        const char* name;   // The string literal given to Operation
+        size_t calls;
+        size_t allocations; // Over all calls
+        size_t bytes;
+        size_t lastAllocations;
+        size_t lastBytes;
+    };
+
+    static const int MAX_OPERATIONS = 48;
+
+    // Charges the allocations of its lifetime to 'name', which must be a
+    // string literal (it is kept, not copied)
+    class Operation {
+#ifdef ALLOCATION_TRACKER
+        OperationStats* previous;
+    public:
+        explicit Operation(const char* name) : previous(AllocationTracker::enterOperation(name)) {}
+        ~Operation() { AllocationTracker::leaveOperation(previous); }
+#else
+    public:
+        explicit Operation(const char*) {}
+#endif
+        Operation(const Operation&) = delete;
+        Operation& operator=(const Operation&) = delete;
+    };
+
+    // Allocations during its lifetime are not counted (the HUD uses it so
+    // that drawing the numbers does not change them)
+    class Ignore {
+#ifdef ALLOCATION_TRACKER
+    public:
+        Ignore() { AllocationTracker::setIgnoring(true); }
+        ~Ignore() { AllocationTracker::setIgnoring(false); }
+#else
+    public:
+        Ignore() {}
+#endif
+        Ignore(const Ignore&) = delete;
+        Ignore& operator=(const Ignore&) = delete;
+    };
+
+    // True when built with ALLOCATION_TRACKER
+    static bool enabled();
+
+    // Frame bookkeeping for the calling thread
+    static void beginFrame();
+    static void setPhase(Phase phase);
+    static const FrameStats& lastFrame();
+
+    // Frames in a row, up to the last one, without a single allocation
+    static size_t quietFrames();
+
+    // Operations seen by the calling thread, in first-use order
+    static int operationCount();
+    static const OperationStats& operation(int index);
+
+    // The operation scope entered most recently (nullptr if none yet)
+    static const OperationStats* lastOperation();
+
+    static const char* phaseName(Phase phase);
+
+    // Operation table: calls, allocations per call, bytes per call
+    static void print(std::ostream& out);
+
+    // Called by the replacement operator new / delete
+    static void recordAllocation(size_t bytes);
+    static void recordFree();
+
+private:
+    static OperationStats* enterOperation(const char* name);
+    static void leaveOperation(OperationStats* previous);
+    static void setIgnoring(bool ignoring);
+};
+
+#endif // ALLOCATION_TRACKER_H
@@ -4,16 +4,21 @@
 // Each operation tracks the path taken for animation purposes.
 
 #include "BST.h"
+#include "AllocationTracker.h"
+#include <algorithm>
 
 // ============================================================================
 // CONSTRUCTOR & DESTRUCTOR
 // ============================================================================
 
-BST::BST() : root(nullptr), nextNodeId(0) {
+template <typename Key, typename Compare>
+BasicBST<Key, Compare>::BasicBST(const Compare& comparator) : root(nullptr), nextNodeId(0), less(comparator) {
     // Start with an empty tree
+    shape.bind(&root);
 }
 
-BST::~BST() {
+template <typename Key, typename Compare>
+BasicBST<Key, Compare>::~BasicBST() {
     // Clean up all dynamically allocated nodes
     clear();
 }
@@ -27,37 +32,55 @@ BST::~BST() {
 // - If value == current node: duplicate (not allowed)
 // ============================================================================
 
-bool BST::insert(int value, std::vector<Node*>& path) {
-    bool success = true;
-    root = insertHelper(root, value, success, path);
-    return success;
-}
-
-Node* BST::insertHelper(Node* node, int value, bool& success, std::vector<Node*>& path) {
-    // Base case: found an empty spot, create new node here
-    if (node == nullptr) {
-        Node* newNode = new Node(value, nextNodeId++);
-        path.push_back(newNode);  // New node is also part of the path
-        return newNode;
-    }
+template <typename Key, typename Compare>
+bool BasicBST<Key, Compare>::insert(const Key& value, std::vector<Node*>& path) {
+    AllocationTracker::Operation scope("BST insert");
+    size_t begin = path.size();
     
-    // Add current node to the path (we're visiting it)
-    path.push_back(node);
+    // Walk down to the empty spot, recording every node we visit
+    Node* parent = nullptr;
+    Node* node = root;
+    while (node != nullptr) {
+        path.push_back(node);
+        bool goLeft = less(value, node->value);
+        if (!goLeft && !less(node->value, value)) {
+            return false;       // Duplicate: nothing changes
+        }
+        parent = node;
+        node = goLeft ? node->left : node->right;
+    }
     
-    if (value < node->value) {
-        // Value is smaller: go to left subtree
-        node->left = insertHelper(node->left, value, success, path);
-    } 
-    else if (value > node->value) {
-        // Value is larger: go to right subtree
-        node->right = insertHelper(node->right, value, success, path);
-    } 
-    else {
-        // Value already exists: this is a duplicate
-        success = false;
+    // Found an empty spot, create the new node here
+    Node* newNode = new Node(value, nextNodeId++);
+    if (parent == nullptr) {
+        root = newNode;
+    } else if (less(value, parent->value)) {
+        parent->left = newNode;
+    } else {
+        parent->right = newNode;
     }
+    path.push_back(newNode);  // New node is also part of the path
+    shape.addNode(static_cast<int>(path.size() - begin - 1));
+    shape.refresh(newNode);
     
-    return node;
+    // The new leaf made its parent's subtree taller
+    fixHeights(path, begin, path.size() - 1);
+    lcaIndex.invalidate();
+    return true;
+}
+
+// Walk back up from path[end - 1]. Each of these nodes had a child that
+// changed height, so its own height and balance factor are recomputed.
+// Once a node's height stays the same, nothing above it changes.
+template <typename Key, typename Compare>
+void BasicBST<Key, Compare>::fixHeights(const std::vector<Node*>& path, size_t begin, size_t end) {
+    for (size_t i = end; i-- > begin;) {
+        Node* node = path[i];
+        int before = node->height;
+        updateHeight(node);
+        shape.refresh(node);
+        if (node->height == before) break;
+    }
 }
 
 // ============================================================================
@@ -69,78 +92,67 @@ Node* BST::insertHelper(Node* node, int value, bool& success, std::vector<Node*>
 // 3. Node has two children: replace with inorder successor (smallest in right subtree)
 // ============================================================================
 
-bool BST::remove(int value, std::vector<Node*>& path, 
+template <typename Key, typename Compare>
+bool BasicBST<Key, Compare>::remove(const Key& value, std::vector<Node*>& path, 
                  Node*& deletedNode, Node*& successor) {
-    bool success = true;
+    AllocationTracker::Operation scope("BST delete");
     deletedNode = nullptr;
     successor = nullptr;
-    root = deleteHelper(root, value, success, path, deletedNode, successor);
-    return success;
-}
-
-Node* BST::deleteHelper(Node* node, int value, bool& success, 
-                        std::vector<Node*>& path, Node*& deletedNode, Node*& successor) {
-    // Base case: value not found in tree
+    size_t begin = path.size();
+    
+    // Search for the node, recording the path
+    Node* node = root;
+    while (node != nullptr) {
+        bool goLeft = less(value, node->value);
+        if (!goLeft && !less(node->value, value)) break;
+        path.push_back(node);
+        node = goLeft ? node->left : node->right;
+    }
     if (node == nullptr) {
-        success = false;
-        return nullptr;
+        return false;           // Value not found in tree
     }
     
-    // Add current node to path (we're visiting it during search)
+    // FOUND THE NODE TO DELETE!
     path.push_back(node);
+    deletedNode = node;
     
-    if (value < node->value) {
-        // Value is smaller: search in left subtree
-        node->left = deleteHelper(node->left, value, success, path, deletedNode, successor);
-    } 
-    else if (value > node->value) {
-        // Value is larger: search in right subtree
-        node->right = deleteHelper(node->right, value, success, path, deletedNode, successor);
-    } 
-    else {
-        // FOUND THE NODE TO DELETE!
-        deletedNode = node;
-        
-        // Case 1: No left child (includes leaf nodes)
-        if (node->left == nullptr) {
-            Node* rightChild = node->right;
-            // Don't delete the node yet - let the animation handle it
-            return rightChild;
-        }
-        
-        // Case 2: No right child
-        if (node->right == nullptr) {
-            Node* leftChild = node->left;
-            return leftChild;
-        }
-        
-        // Case 3: Node has two children
-        // Find the inorder successor (smallest value in right subtree)
-        std::vector<Node*> successorPath;
-        successor = findMinWithPath(node->right, successorPath);
-        
+    // Case 3: Node has two children
+    // Find the inorder successor (smallest value in right subtree). It
+    // takes the node's place in the value order and is unlinked instead.
+    if (node->left != nullptr && node->right != nullptr) {
         // Add successor path to the main path for animation
-        for (Node* n : successorPath) {
-            path.push_back(n);
-        }
+        successor = findMinWithPath(node->right, path);
         
         // Copy the successor's value to this node
         node->value = successor->value;
-        
-        // Delete the successor from the right subtree
-        bool tempSuccess = true;
-        Node* tempDeleted = nullptr;
-        Node* tempSuccessor = nullptr;
-        std::vector<Node*> tempPath;
-        node->right = deleteHelper(node->right, successor->value, tempSuccess, 
-                                   tempPath, tempDeleted, tempSuccessor);
     }
     
-    return node;
+    // The node that leaves the tree is the last one on the path and has at
+    // most one child (Cases 1 and 2, or the successor, which has no left
+    // child). That child's subtree moves up into its place.
+    // Don't delete the node yet - let the animation handle it.
+    Node* removed = path.back();
+    Node* child = removed->left ? removed->left : removed->right;
+    Node* parent = path.size() - begin > 1 ? path[path.size() - 2] : nullptr;
+    if (parent == nullptr) {
+        root = child;
+    } else if (parent->left == removed) {
+        parent->left = child;
+    } else {
+        parent->right = child;
+    }
+    int depth = static_cast<int>(path.size() - begin - 1);
+    shape.detach(removed, depth);
+    shape.moveSubtree(child);
+    
+    fixHeights(path, begin, path.size() - 1);
+    lcaIndex.invalidate();
+    return true;
 }
 
 // Find the minimum value node in a subtree (leftmost node)
-Node* BST::findMin(Node* node) {
+template <typename Key, typename Compare>
+typename BasicBST<Key, Compare>::Node* BasicBST<Key, Compare>::findMin(Node* node) {
     if (node == nullptr) return nullptr;
     while (node->left != nullptr) {
         node = node->left;
@@ -149,7 +161,8 @@ Node* BST::findMin(Node* node) {
 }
 
 // Find minimum and track the path (for animation)
-Node* BST::findMinWithPath(Node* node, std::vector<Node*>& path) {
+template <typename Key, typename Compare>
+typename BasicBST<Key, Compare>::Node* BasicBST<Key, Compare>::findMinWithPath(Node* node, std::vector<Node*>& path) {
     if (node == nullptr) return nullptr;
     while (node->left != nullptr) {
         path.push_back(node);
@@ -168,90 +181,119 @@ Node* BST::findMinWithPath(Node* node, std::vector<Node*>& path) {
 // - If value == current: found it!
 // ============================================================================
 
-Node* BST::search(int value, std::vector<Node*>& path) {
-    return searchHelper(root, value, path);
-}
-
-Node* BST::searchHelper(Node* node, int value, std::vector<Node*>& path) {
-    // Base case: reached end without finding
-    if (node == nullptr) {
-        return nullptr;
-    }
-    
-    // Add this node to the path (we're visiting it)
-    path.push_back(node);
-    
-    if (value < node->value) {
-        // Value is smaller: search left
-        return searchHelper(node->left, value, path);
-    } 
-    else if (value > node->value) {
-        // Value is larger: search right
-        return searchHelper(node->right, value, path);
-    } 
-    else {
-        // Found it!
-        return node;
+template <typename Key, typename Compare>
+typename BasicBST<Key, Compare>::Node* BasicBST<Key, Compare>::search(const Key& value, std::vector<Node*>& path) {
+    AllocationTracker::Operation scope("BST search");
+    Node* node = root;
+    while (node != nullptr) {
+        // Add this node to the path (we're visiting it)
+        path.push_back(node);
+        
+        if (less(value, node->value)) {
+            node = node->left;      // Value is smaller: search left
+        } 
+        else if (less(node->value, value)) {
+            node = node->right;     // Value is larger: search right
+        } 
+        else {
+            return node;            // Found it!
+        }
     }
+    return nullptr;                 // Reached the end without finding
 }
 
 // ============================================================================
 // UTILITY FUNCTIONS
 // ============================================================================
 
-bool BST::contains(int value) {
+template <typename Key, typename Compare>
+bool BasicBST<Key, Compare>::contains(const Key& value) {
     std::vector<Node*> path;
     return search(value, path) != nullptr;
 }
 
-void BST::clear() {
-    clearHelper(root);
+template <typename Key, typename Compare>
+void BasicBST<Key, Compare>::clear() {
+    // Delete every node with an explicit stack, so a degenerate tree as
+    // deep as it is large can't overflow the call stack
+    std::vector<Node*> stack;
+    if (root) stack.push_back(root);
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        if (node->left) stack.push_back(node->left);
+        if (node->right) stack.push_back(node->right);
+        delete node;
+    }
     root = nullptr;
+    lcaIndex.invalidate();
+    shape.clear();
 }
 
-void BST::clearHelper(Node* node) {
-    if (node == nullptr) return;
-    
-    // Recursively delete children first (post-order)
-    clearHelper(node->left);
-    clearHelper(node->right);
-    
-    // Then delete this node
-    delete node;
-}
-
-bool BST::isEmpty() const {
+template <typename Key, typename Compare>
+bool BasicBST<Key, Compare>::isEmpty() const {
     return root == nullptr;
 }
 
-Node* BST::getRoot() const {
+template <typename Key, typename Compare>
+typename BasicBST<Key, Compare>::Node* BasicBST<Key, Compare>::getRoot() const {
     return root;
 }
 
-std::vector<Node*> BST::getAllNodes() {
+// ============================================================================
+// LOWEST COMMON ANCESTOR
+// ============================================================================
+// The index is rebuilt lazily: mutations only mark it stale, so a run of
+// inserts pays nothing and the first query afterwards pays O(n) once.
+// ============================================================================
+
+template <typename Key, typename Compare>
+typename BasicBST<Key, Compare>::Node* BasicBST<Key, Compare>::lowestCommonAncestor(const Node* a, const Node* b) {
+    if (!lcaIndex.isValid()) lcaIndex.build(root);
+    return lcaIndex.query(a, b);
+}
+
+template <typename Key, typename Compare>
+std::vector<typename BasicBST<Key, Compare>::Node*> BasicBST<Key, Compare>::getAllNodes() {
     std::vector<Node*> nodes;
     collectNodes(root, nodes);
     return nodes;
 }
 
-void BST::collectNodes(Node* node, std::vector<Node*>& nodes) {
-    if (node == nullptr) return;
-    nodes.push_back(node);
-    collectNodes(node->left, nodes);
-    collectNodes(node->right, nodes);
+// Pre-order (each node before its subtrees), with an explicit stack
+template <typename Key, typename Compare>
+void BasicBST<Key, Compare>::collectNodes(Node* node, std::vector<Node*>& nodes) {
+    std::vector<Node*> stack;
+    if (node) stack.push_back(node);
+    while (!stack.empty()) {
+        node = stack.back();
+        stack.pop_back();
+        nodes.push_back(node);
+        if (node->right) stack.push_back(node->right);
+        if (node->left) stack.push_back(node->left);
+    }
 }
 
-int BST::getHeight() const {
-    return getHeightHelper(root);
+template <typename Key, typename Compare>
+int BasicBST<Key, Compare>::getHeight() const {
+    return root ? root->height : 0;
 }
 
-int BST::getHeightHelper(Node* node) const {
+template <typename Key, typename Compare>
+int BasicBST<Key, Compare>::getHeightHelper(Node* node) const {
     if (node == nullptr) return 0;
     int leftHeight = getHeightHelper(node->left);
     int rightHeight = getHeightHelper(node->right);
     return 1 + std::max(leftHeight, rightHeight);
 }
 
+template <typename Key, typename Compare>
+void BasicBST<Key, Compare>::updateHeight(Node* node) {
+    int leftHeight = node->left ? node->left->height : 0;
+    int rightHeight = node->right ? node->right->height : 0;
+    node->height = 1 + std::max(leftHeight, rightHeight);
+}
+
 // ============================================================================
 // IN-ORDER TRAVERSAL
 // ============================================================================
@@ -259,17 +301,100 @@ int BST::getHeightHelper(Node* node) const {
 // For a BST, this gives values in sorted order!
 // ============================================================================
 
-std::vector<int> BST::inorderTraversal() {
-    std::vector<int> result;
+template <typename Key, typename Compare>
+std::vector<Key> BasicBST<Key, Compare>::inorderTraversal() {
+    std::vector<Key> result;
     inorderHelper(root, result);
     return result;
 }
 
-void BST::inorderHelper(Node* node, std::vector<int>& result) {
-    if (node == nullptr) return;
+template <typename Key, typename Compare>
+void BasicBST<Key, Compare>::inorderHelper(Node* node, std::vector<Key>& result) {
+    // Go left as far as possible, then visit and continue in the right
+    // subtree: Left -> Current -> Right without recursion
+    std::vector<Node*> stack;
+    while (node != nullptr || !stack.empty()) {
+        while (node != nullptr) {
+            stack.push_back(node);
+            node = node->left;
+        }
+        node = stack.back();
+        stack.pop_back();
+        result.push_back(node->value);
+        node = node->right;
+    }
+}
+
+// ============================================================================
+// BULK LOAD
+// ============================================================================
+// Both directions are iterative so very deep trees can't overflow the stack.
+// ============================================================================
+
+template <typename Key, typename Compare>
+std::vector<Key> BasicBST<Key, Compare>::preorderTraversal() {
+    std::vector<Key> result;
+    std::vector<Node*> stack;
+    if (root) stack.push_back(root);
+    
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        result.push_back(node->value);
+        
+        // Push right first so the left subtree is visited first
+        if (node->right) stack.push_back(node->right);
+        if (node->left) stack.push_back(node->left);
+    }
+    return result;
+}
+
+template <typename Key, typename Compare>
+void BasicBST<Key, Compare>::loadPreorder(const std::vector<Key>& values) {
+    clear();
+    if (values.empty()) return;
     
-    inorderHelper(node->left, result);   // Visit left subtree
-    result.push_back(node->value);        // Visit current node
-    inorderHelper(node->right, result);  // Visit right subtree
+    // 'stack' holds the path of nodes still waiting for a right child.
+    // A value larger than the stack top belongs to the right of the last
+    // node popped that is smaller than it; otherwise it is a left child.
+    root = new Node(values[0], nextNodeId++);
+    std::vector<Node*> stack;
+    stack.push_back(root);
+    std::vector<Node*> created;
+    created.reserve(values.size());
+    created.push_back(root);
+    
+    for (size_t i = 1; i < values.size(); i++) {
+        Node* node = new Node(values[i], nextNodeId++);
+        Node* parent = nullptr;
+        while (!stack.empty() && less(stack.back()->value, values[i])) {
+            parent = stack.back();
+            stack.pop_back();
+        }
+        if (parent) {
+            parent->right = node;
+        } else {
+            stack.back()->left = node;
+        }
+        stack.push_back(node);
+        created.push_back(node);
+    }
+    
+    // Children come after their parent in pre-order, so a backwards sweep
+    // sees every child's height before its parent's
+    for (size_t i = created.size(); i-- > 0;) {
+        updateHeight(created[i]);
+    }
+    shape.rebuild(root);
 }
 
+// ============================================================================
+// INSTANTIATIONS
+// ============================================================================
+// The key types the visualizer and the benchmarks use, as for BasicAVLTree
+
+template class BasicBST<int>;
+template class BasicBST<long long>;
+template class BasicBST<double>;
+template class BasicBST<std::string>;
+template class BasicBST<ShortKey>;
@@ -1,39 +1,56 @@
 // File: BST.h
 // Description: Binary Search Tree data structure declaration.
 // This file defines the Node structure and the BST class with all operations.
-// The BST stores integers and supports insert, delete, search, and traversal.
+// The BST supports insert, delete, search, and traversal.
+//
+// BasicBST<Key, Compare> is templated on the key type like BasicAVLTree;
+// BST is the int tree the visualizer, console and exporters use. The
+// members are defined in BST.cpp and instantiated there for int, long long,
+// double, std::string and ShortKey (see KeyTypes.h).
 
 #ifndef BST_H
 #define BST_H
 
 #include <vector>
 #include <functional>
+#include <string>
+#include "KeyTypes.h"
+#include "TreeLca.h"
+#include "MemoryAccount.h"
+#include "ShapeStats.h"
 
 // ============================================================================
 // NODE STRUCTURE
 // ============================================================================
 // Each node in the BST contains:
-// - value: the integer stored in this node
+// - value: the key stored in this node
+// - height: nodes on the longest path down to a leaf (1 for a leaf)
 // - left/right: pointers to child nodes (nullptr if no child)
 // - id: unique identifier for animation purposes
+// - shapeCode: the ShapeStats bucket this node is counted in
 // - x, y: visual position on screen (managed by Visualizer)
 // ============================================================================
-struct Node {
-    int value;
-    Node* left;
-    Node* right;
+template <typename Key>
+struct BasicNode : TrackedAllocation<MemoryAccount::STRUCTURE_NODES> {
+    Key value;
+    int height;         // Kept by BST; not maintained by ScapegoatTree
+    BasicNode* left;
+    BasicNode* right;
     
     // Visual properties (used by Visualizer for drawing/animation)
     int id;             // Unique node ID for tracking in animations
+    int shapeCode;      // Kept by BST (see ShapeStats.h)
     float x, y;         // Current visual position
     float targetX, targetY;  // Target position for smooth movement
     
     // Constructor
-    Node(int val, int nodeId) 
-        : value(val), left(nullptr), right(nullptr), 
-          id(nodeId), x(0), y(0), targetX(0), targetY(0) {}
+    BasicNode(const Key& val, int nodeId) 
+        : value(val), height(1), left(nullptr), right(nullptr), 
+          id(nodeId), shapeCode(-1), x(0), y(0), targetX(0), targetY(0) {}
 };
 
+typedef BasicNode<int> Node;
+
 // ============================================================================
 // BST CLASS
 // ============================================================================
@@ -43,26 +60,33 @@ struct Node {
 // - Deletion: Remove a value using standard BST deletion algorithm
 // - Searching: Find a value and return the path taken
 // - Traversal: Get all nodes in various orders
+// All of them loop instead of recursing: ascending input (the console's
+// "insert 1..100000") makes a chain as deep as the tree is large.
 // ============================================================================
-class BST {
+template <typename Key = int, typename Compare = KeyCompare<Key>>
+class BasicBST {
+public:
+    typedef Key KeyType;
+    typedef BasicNode<Key> Node;
+    typedef Node NodeType;
+
 private:
     Node* root;         // Pointer to the root node
     int nextNodeId;     // Counter for assigning unique IDs to nodes
+    Compare less;       // Key order
+    EulerTourLCA<Node> lcaIndex;    // Stale after any change (see TreeLca.h)
+    ShapeStats shape;   // Updated along each insert / delete path
 
     // ========================================================================
     // PRIVATE HELPER FUNCTIONS
     // ========================================================================
     
-    // Recursively insert a value into the subtree rooted at 'node'
-    // Returns the (possibly new) root of the subtree
-    // Sets 'success' to false if the value already exists
-    Node* insertHelper(Node* node, int value, bool& success, std::vector<Node*>& path);
+    // Recompute heights and balance buckets on path[begin, end), deepest
+    // first, after the child of path[end - 1] changed height
+    void fixHeights(const std::vector<Node*>& path, size_t begin, size_t end);
     
-    // Recursively delete a value from the subtree rooted at 'node'
-    // Returns the (possibly new) root of the subtree
-    // Sets 'success' to false if the value doesn't exist
-    Node* deleteHelper(Node* node, int value, bool& success, 
-                       std::vector<Node*>& path, Node*& deletedNode, Node*& successor);
+    // Recompute a node's height from its children
+    void updateHeight(Node* node);
     
     // Find the node with minimum value in a subtree (leftmost node)
     // Used during deletion when node has two children
@@ -71,12 +95,6 @@ private:
     // Find the node with minimum value and track the path
     Node* findMinWithPath(Node* node, std::vector<Node*>& path);
     
-    // Recursively search for a value
-    Node* searchHelper(Node* node, int value, std::vector<Node*>& path);
-    
-    // Recursively delete all nodes in the subtree
-    void clearHelper(Node* node);
-    
     // Collect all nodes in the tree (for iteration/drawing)
     void collectNodes(Node* node, std::vector<Node*>& nodes);
 
@@ -84,8 +102,11 @@ public:
     // ========================================================================
     // CONSTRUCTOR & DESTRUCTOR
     // ========================================================================
-    BST();
-    ~BST();
+    explicit BasicBST(const Compare& comparator = Compare());
+    ~BasicBST();
+    
+    BasicBST(const BasicBST&) = delete;
+    BasicBST& operator=(const BasicBST&) = delete;
 
     // ========================================================================
     // PUBLIC INTERFACE
@@ -94,22 +115,22 @@ public:
     // Insert a value into the BST
     // Returns true if insertion was successful, false if value already exists
     // 'path' will contain the nodes visited during insertion (for animation)
-    bool insert(int value, std::vector<Node*>& path);
+    bool insert(const Key& value, std::vector<Node*>& path);
     
     // Delete a value from the BST
     // Returns true if deletion was successful, false if value not found
     // 'path' contains nodes visited, 'deletedNode' is the removed node,
     // 'successor' is the inorder successor (if applicable)
-    bool remove(int value, std::vector<Node*>& path, 
+    bool remove(const Key& value, std::vector<Node*>& path, 
                 Node*& deletedNode, Node*& successor);
     
     // Search for a value in the BST
     // Returns pointer to the node if found, nullptr otherwise
     // 'path' contains all nodes visited during the search
-    Node* search(int value, std::vector<Node*>& path);
+    Node* search(const Key& value, std::vector<Node*>& path);
     
     // Check if a value exists in the tree
-    bool contains(int value);
+    bool contains(const Key& value);
     
     // Remove all nodes from the tree
     void clear();
@@ -123,14 +144,32 @@ public:
     // Get all nodes in the tree
     std::vector<Node*> getAllNodes();
     
+    // Lowest common ancestor of two nodes of this tree in O(1) (nullptr if
+    // either isn't in it). The first query after a change rebuilds the
+    // Euler tour index in O(n); not safe to call from several threads.
+    Node* lowestCommonAncestor(const Node* a, const Node* b);
+    
     // Get height of the tree (for layout calculations)
     int getHeight() const;
     int getHeightHelper(Node* node) const;
     
+    // Live shape statistics (depth histogram, balance factors, leaves)
+    const ShapeStats& getShapeStats() const { return shape; }
+    
     // In-order traversal: returns values in sorted order
-    std::vector<int> inorderTraversal();
-    void inorderHelper(Node* node, std::vector<int>& result);
+    std::vector<Key> inorderTraversal();
+    void inorderHelper(Node* node, std::vector<Key>& result);
+    
+    // Pre-order traversal: root first. Loading this sequence with
+    // loadPreorder() rebuilds exactly the same tree shape.
+    std::vector<Key> preorderTraversal();
+    
+    // Replace the tree with one built from a pre-order sequence in O(n)
+    // (used to restore saved sessions without re-running every insert)
+    void loadPreorder(const std::vector<Key>& values);
 };
 
+typedef BasicBST<> BST;
+
 #endif // BST_H
 
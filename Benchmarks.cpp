@@ -0,0 +1,2080 @@
+// File: Benchmarks.cpp
+// Description: Benchmark implementations and the name -> function table
+
+#include "Benchmarks.h"
+#include "AllocationTracker.h"
+#include "AVLTree.h"
+#include "BST.h"
+#include "BloomFilter.h"
+#include "ConcurrentAVL.h"
+#include "CuckooFilter.h"
+#include "ExternalSort.h"
+#include "FilterHash.h"
+#include "IntervalTree.h"
+#include "InvariantChecker.h"
+#include "KdTree.h"
+#include "LinkedList.h"
+#include "MemoryAccount.h"
+#include "MinHeap.h"
+#include "PerfCounters.h"
+#include "Rope.h"
+#include "ScapegoatTree.h"
+#include "SlidingWindow.h"
+#include "StreamSketch.h"
+#include "TaskPool.h"
+#include "TopK.h"
+#include "UnrolledList.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef int (*BenchmarkFn)(size_t size, std::ostream& out);
+
+struct BenchmarkEntry {
+    const char* name;
+    const char* description;
+    size_t defaultSize;
+    BenchmarkFn run;
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// Hardware counters for measured loops, opened once per run. Events the
+// machine does not provide print as "-".
+PerfCounters& hardwareCounters() {
+    static PerfCounters counters;
+    return counters;
+}
+
+// Column titles matching counterColumns()
+std::string counterHeader() {
+    std::ostringstream ss;
+    ss << std::setw(9) << "cycles" << std::setw(8) << "instr" << std::setw(6) << "IPC";
+    for (int e = PerfCounters::L1D_MISSES; e < PerfCounters::EVENT_COUNT; e++) {
+        ss << std::setw(11) << PerfCounters::name(static_cast<PerfCounters::Event>(e));
+    }
+    return ss.str();
+}
+
+// Each counter divided by 'operations'
+std::string counterColumns(const PerfCounters::Sample& sample, size_t operations) {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    auto perOp = [&](int event, int width) {
+        if (sample.valid[event] && operations > 0) {
+            ss << std::setw(width) << static_cast<double>(sample.values[event]) / operations;
+        } else {
+            ss << std::setw(width) << "-";
+        }
+    };
+    perOp(PerfCounters::CYCLES, 9);
+    perOp(PerfCounters::INSTRUCTIONS, 8);
+    if (sample.valid[PerfCounters::CYCLES] && sample.valid[PerfCounters::INSTRUCTIONS] &&
+        sample.values[PerfCounters::CYCLES] > 0) {
+        ss << std::setprecision(2) << std::setw(6)
+           << static_cast<double>(sample.values[PerfCounters::INSTRUCTIONS]) /
+                  sample.values[PerfCounters::CYCLES]
+           << std::setprecision(1);
+    } else {
+        ss << std::setw(6) << "-";
+    }
+    for (int e = PerfCounters::L1D_MISSES; e < PerfCounters::EVENT_COUNT; e++) {
+        perOp(e, 11);
+    }
+    return ss.str();
+}
+
+// One line under the benchmark title saying whether counters are read
+void describeCounters(std::ostream& out) {
+    PerfCounters& counters = hardwareCounters();
+    if (counters.available()) {
+        out << "  hardware counters per operation (user space, this thread)\n";
+    } else {
+        out << "  hardware counters unavailable: " << counters.unavailableReason() << "\n";
+    }
+}
+
+// ----------------------------------------------------------------------------
+// INTERVAL TREE
+// ----------------------------------------------------------------------------
+// Mostly short intervals with some long ones, so the max-endpoint pruning
+// has to cope with subtrees whose maxHigh reaches far to the right.
+// ----------------------------------------------------------------------------
+struct Span {
+    int low;
+    int high;
+};
+
+long long linearOverlap(const std::vector<Span>& spans, int low, int high) {
+    long long found = 0;
+    for (const Span& span : spans) {
+        if (span.low <= high && span.high >= low) found++;
+    }
+    return found;
+}
+
+int benchInterval(size_t size, std::ostream& out) {
+    const int RANGE = 100000000;
+    const int QUERIES = 1000;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> start(0, RANGE);
+    std::uniform_int_distribution<int> shortLength(0, 1000);
+    std::uniform_int_distribution<int> longLength(0, 100000);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    std::vector<Span> spans;
+    spans.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+        int low = start(rng);
+        int length = percent(rng) < 99 ? shortLength(rng) : longLength(rng);
+        spans.push_back({low, low + length});
+    }
+
+    out << "Interval tree: " << size << " intervals in [0, " << RANGE << "], "
+        << QUERIES << " stabbing + " << QUERIES << " overlap queries\n";
+    out << std::fixed << std::setprecision(3);
+
+    IntervalTree tree;
+    std::vector<IntervalNode*> path;
+    auto buildStart = std::chrono::steady_clock::now();
+    for (const Span& span : spans) {
+        path.clear();
+        tree.insert(span.low, span.high, path);
+    }
+    out << "  build            " << elapsedMs(buildStart) << " ms ("
+        << tree.size() << " distinct, height " << tree.getTreeHeight() << ")\n";
+
+    // Query windows: points, then ranges of up to 10,000
+    std::vector<Span> queries;
+    for (int i = 0; i < 2 * QUERIES; i++) {
+        int low = start(rng);
+        int width = i < QUERIES ? 0 : shortLength(rng) * 10;
+        queries.push_back({low, low + width});
+    }
+
+    // Duplicates are rejected by the tree, so compare against the unique set
+    std::vector<Span> unique;
+    unique.reserve(tree.size());
+    std::vector<IntervalNode*> stack;
+    if (tree.getRoot()) stack.push_back(tree.getRoot());
+    while (!stack.empty()) {
+        IntervalNode* node = stack.back();
+        stack.pop_back();
+        unique.push_back({node->value.low, node->value.high});
+        if (node->left) stack.push_back(node->left);
+        if (node->right) stack.push_back(node->right);
+    }
+
+    bool agree = true;
+    for (int pass = 0; pass < 2; pass++) {
+        const char* label = pass == 0 ? "stab   " : "overlap";
+        size_t first = pass == 0 ? 0 : QUERIES;
+
+        std::vector<long long> treeCounts;
+        std::vector<IntervalNode*> matches;
+        auto treeStart = std::chrono::steady_clock::now();
+        for (size_t q = first; q < first + QUERIES; q++) {
+            matches.clear();
+            if (pass == 0) tree.stab(queries[q].low, matches);
+            else tree.overlap(queries[q].low, queries[q].high, matches);
+            treeCounts.push_back(static_cast<long long>(matches.size()));
+        }
+        double treeMs = elapsedMs(treeStart);
+
+        long long totalMatches = 0;
+        auto linearStart = std::chrono::steady_clock::now();
+        for (size_t q = first; q < first + QUERIES; q++) {
+            long long found = linearOverlap(unique, queries[q].low, queries[q].high);
+            if (found != treeCounts[q - first]) agree = false;
+            totalMatches += found;
+        }
+        double linearMs = elapsedMs(linearStart);
+
+        // Work per query, from a traced sample
+        std::vector<IntervalQueryStep> trace;
+        long long visited = 0, pruned = 0;
+        for (size_t q = first; q < first + 100; q++) {
+            trace.clear();
+            matches.clear();
+            tree.overlap(queries[q].low, queries[q].high, matches, &trace);
+            for (const IntervalQueryStep& step : trace) {
+                if (step.kind == IntervalQueryStep::VISIT) visited++;
+                else if (step.kind == IntervalQueryStep::PRUNED) pruned++;
+            }
+        }
+
+        out << "  " << label << "  tree " << std::setw(9) << treeMs / QUERIES << " ms/query"
+            << "   linear " << std::setw(9) << linearMs / QUERIES << " ms/query"
+            << std::setprecision(1)
+            << "   speedup " << (treeMs > 0 ? linearMs / treeMs : 0.0) << "x\n"
+            << "           " << static_cast<double>(totalMatches) / QUERIES << " matches, "
+            << visited / 100.0 << " nodes visited, "
+            << pruned / 100.0 << " subtrees pruned per query\n"
+            << std::setprecision(3);
+    }
+
+    out << (agree ? "  results agree with the linear scan\n"
+                  : "  MISMATCH between tree and linear scan\n");
+    return agree ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// K-D TREE
+// ----------------------------------------------------------------------------
+// k nearest neighbours for a batch of queries: one thread, then the batch
+// split over the task pool. Brute force (distance to every point plus a
+// partial selection) runs on a sample and must give the same distances;
+// ties may pick different points, so distances are compared, not indices.
+// ----------------------------------------------------------------------------
+int benchKdTree(size_t size, std::ostream& out) {
+    const int RANGE = 1000000;
+    const int K = 8;
+    const size_t QUERIES = 20000;
+    const size_t BRUTE_QUERIES = 200;
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> coordinate(0, RANGE);
+    std::vector<KdPoint> points(size);
+    for (KdPoint& point : points) {
+        point.x = coordinate(rng);
+        point.y = coordinate(rng);
+    }
+    std::vector<KdPoint> queries(QUERIES);
+    for (KdPoint& query : queries) {
+        query.x = coordinate(rng);
+        query.y = coordinate(rng);
+    }
+
+    TaskPool& pool = TaskPool::shared();
+    out << "K-d tree: " << size << " points in [0, " << RANGE << "]^2, "
+        << QUERIES << " queries, k = " << K << ", " << pool.size() << " threads\n";
+    out << std::fixed << std::setprecision(4);
+
+    KdTree tree;
+    auto buildStart = std::chrono::steady_clock::now();
+    tree.build(points);
+    out << "  build (median split)  " << std::setprecision(1) << elapsedMs(buildStart)
+        << " ms, height " << tree.getTreeHeight() << "\n" << std::setprecision(4);
+
+    // Sequential batch
+    std::vector<std::vector<KdNeighbor>> results(QUERIES);
+    auto serialStart = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < QUERIES; q++) {
+        tree.nearest(queries[q].x, queries[q].y, K, results[q]);
+    }
+    double serialMs = elapsedMs(serialStart);
+
+    // Same batch over the pool; each chunk reuses its own result vectors
+    std::vector<std::vector<KdNeighbor>> parallelResults(QUERIES);
+    auto parallelStart = std::chrono::steady_clock::now();
+    pool.parallelFor(QUERIES, 256, [&](size_t begin, size_t end) {
+        for (size_t q = begin; q < end; q++) {
+            tree.nearest(queries[q].x, queries[q].y, K, parallelResults[q]);
+        }
+    });
+    double parallelMs = elapsedMs(parallelStart);
+
+    // Brute force on a sample
+    bool agree = true;
+    std::vector<long long> distances(size);
+    auto bruteStart = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < BRUTE_QUERIES; q++) {
+        for (size_t i = 0; i < size; i++) {
+            long long dx = static_cast<long long>(points[i].x) - queries[q].x;
+            long long dy = static_cast<long long>(points[i].y) - queries[q].y;
+            distances[i] = dx * dx + dy * dy;
+        }
+        size_t k = std::min<size_t>(K, size);
+        std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+        if (results[q].size() != k) agree = false;
+        for (size_t i = 0; i < k && agree; i++) {
+            if (results[q][i].distanceSquared != distances[i] ||
+                parallelResults[q][i].distanceSquared != distances[i]) agree = false;
+        }
+    }
+    double bruteMs = elapsedMs(bruteStart);
+
+    double serialPer = serialMs / QUERIES;
+    double parallelPer = parallelMs / QUERIES;
+    double brutePer = bruteMs / BRUTE_QUERIES;
+    out << "  brute force  " << std::setw(10) << brutePer << " ms/query (" << BRUTE_QUERIES << " sampled)\n"
+        << "  tree         " << std::setw(10) << serialPer << " ms/query"
+        << std::setprecision(1) << "   " << brutePer / serialPer << "x vs brute force\n" << std::setprecision(4)
+        << "  tree, pool   " << std::setw(10) << parallelPer << " ms/query"
+        << std::setprecision(1) << "   " << serialMs / parallelMs << "x vs one thread\n" << std::setprecision(4);
+
+    // Search effort, from a traced sample
+    std::vector<KdQueryStep> trace;
+    std::vector<KdNeighbor> sample;
+    long long visited = 0, pruned = 0;
+    for (size_t q = 0; q < 100; q++) {
+        trace.clear();
+        tree.nearest(queries[q].x, queries[q].y, K, sample, &trace);
+        for (const KdQueryStep& step : trace) {
+            if (step.kind == KdQueryStep::VISIT) visited++;
+            else if (step.kind == KdQueryStep::PRUNED) pruned++;
+        }
+    }
+    out << std::setprecision(1) << "  " << visited / 100.0 << " nodes visited, "
+        << pruned / 100.0 << " subtrees pruned per query\n";
+
+    out << (agree ? "  results agree with brute force\n"
+                  : "  MISMATCH between tree and brute force\n");
+    return agree ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// BLOOM / CUCKOO FILTERS
+// ----------------------------------------------------------------------------
+// 'size' distinct keys are inserted and 'size' other keys are queried, so
+// every hit on the second set is a false positive. Keys come from an odd
+// multiplier (a bijection on 32 bits), so both sets are guaranteed disjoint.
+// Throughput is compared with exact membership in the repo's BST and AVL
+// tree on the same keys.
+// ----------------------------------------------------------------------------
+double megaOpsPerSecond(size_t operations, double ms) {
+    return ms > 0 ? operations / ms / 1000.0 : 0.0;
+}
+
+int benchFilters(size_t size, std::ostream& out) {
+    std::vector<int> keys(2 * size);
+    for (size_t i = 0; i < keys.size(); i++) {
+        keys[i] = static_cast<int>(static_cast<uint32_t>(i) * 2654435761u + 0x1234567u);
+    }
+    const int* present = keys.data();
+    const int* absent = keys.data() + size;
+    std::vector<uint8_t> results(size);
+
+    out << "Filters: " << size << " keys inserted, " << size
+        << " absent keys queried, batch hashing: " << FilterHash::instructionSet() << "\n";
+    out << std::fixed;
+
+    // False-positive rate against memory
+    bool noFalseNegatives = true;
+    out << "  false positives        bits/key   hashes   measured FPR  unblocked est.\n";
+    const double BITS_PER_KEY[] = {4, 6, 8, 10, 12, 16, 20};
+    for (double bitsPerKey : BITS_PER_KEY) {
+        BloomFilter bloom(size, bitsPerKey);
+        bloom.insertBatch(present, size);
+        if (bloom.containsBatch(present, size, results.data()) != size) noFalseNegatives = false;
+        size_t falsePositives = bloom.containsBatch(absent, size, results.data());
+        double actualBits = static_cast<double>(bloom.sizeInBits()) / size;
+        out << "  blocked Bloom         " << std::setprecision(1) << std::setw(9) << actualBits
+            << std::setw(9) << bloom.getHashCount()
+            << std::setprecision(5) << std::setw(15) << static_cast<double>(falsePositives) / size
+            << std::setw(11) << BloomFilter::expectedFalsePositiveRate(actualBits, bloom.getHashCount())
+            << "\n";
+    }
+
+    CuckooFilter<uint8_t> cuckoo8(size);
+    CuckooFilter<uint16_t> cuckoo16(size);
+    size_t stored8 = cuckoo8.insertBatch(present, size);
+    size_t stored16 = cuckoo16.insertBatch(present, size);
+    if (cuckoo8.containsBatch(present, size, results.data()) != size ||
+        cuckoo16.containsBatch(present, size, results.data()) != size ||
+        stored8 != size || stored16 != size) noFalseNegatives = false;
+    size_t falsePositives8 = cuckoo8.containsBatch(absent, size, results.data());
+    size_t falsePositives16 = cuckoo16.containsBatch(absent, size, results.data());
+    out << "  cuckoo, 8-bit fp      " << std::setprecision(1) << std::setw(9)
+        << static_cast<double>(cuckoo8.sizeInBits()) / size << "        -"
+        << std::setprecision(5) << std::setw(15) << static_cast<double>(falsePositives8) / size
+        << std::setw(11) << CuckooFilter<uint8_t>::expectedFalsePositiveRate()
+        << std::setprecision(2) << "   (load " << cuckoo8.loadFactor() << ")\n";
+    out << "  cuckoo, 16-bit fp     " << std::setprecision(1) << std::setw(9)
+        << static_cast<double>(cuckoo16.sizeInBits()) / size << "        -"
+        << std::setprecision(5) << std::setw(15) << static_cast<double>(falsePositives16) / size
+        << std::setw(11) << CuckooFilter<uint16_t>::expectedFalsePositiveRate()
+        << std::setprecision(2) << "   (load " << cuckoo16.loadFactor() << ")\n";
+
+    // Throughput
+    out << std::setprecision(1);
+    out << "  throughput (Mops/s)            insert    query\n";
+    auto row = [&out, size](const char* label, double insertMs, double queryMs) {
+        out << "  " << std::left << std::setw(28) << label << std::right
+            << std::setw(9) << megaOpsPerSecond(size, insertMs)
+            << std::setw(9) << megaOpsPerSecond(2 * size, queryMs) << "\n";
+    };
+
+    std::vector<uint32_t> h1(size), h2(size);
+    auto hashStart = std::chrono::steady_clock::now();
+    FilterHash::hashBatchScalar(present, size, h1.data(), h2.data());
+    double scalarHashMs = elapsedMs(hashStart);
+    hashStart = std::chrono::steady_clock::now();
+    FilterHash::hashBatch(present, size, h1.data(), h2.data());
+    double batchHashMs = elapsedMs(hashStart);
+    out << "  hashing only, scalar        " << std::setw(9) << megaOpsPerSecond(size, scalarHashMs) << "\n"
+        << "  hashing only, " << std::left << std::setw(14) << FilterHash::instructionSet() << std::right
+        << std::setw(9) << megaOpsPerSecond(size, batchHashMs) << "\n";
+
+    // Queries run over present and absent keys alike
+    size_t sink = 0;
+    {
+        BloomFilter bloom(size, 10);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < size; i++) bloom.insert(present[i]);
+        double insertMs = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < 2 * size; i++) sink += bloom.contains(keys[i]);
+        row("Bloom 10 b/key, per key", insertMs, elapsedMs(start));
+
+        bloom.clear();
+        start = std::chrono::steady_clock::now();
+        bloom.insertBatch(present, size);
+        insertMs = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        sink += bloom.containsBatch(present, size, results.data());
+        sink += bloom.containsBatch(absent, size, results.data());
+        row("Bloom 10 b/key, batched", insertMs, elapsedMs(start));
+    }
+    {
+        CuckooFilter<uint16_t> cuckoo(size);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < size; i++) cuckoo.insert(present[i]);
+        double insertMs = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < 2 * size; i++) sink += cuckoo.contains(keys[i]);
+        row("cuckoo 16-bit, per key", insertMs, elapsedMs(start));
+
+        cuckoo.clear();
+        start = std::chrono::steady_clock::now();
+        cuckoo.insertBatch(present, size);
+        insertMs = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        sink += cuckoo.containsBatch(present, size, results.data());
+        sink += cuckoo.containsBatch(absent, size, results.data());
+        row("cuckoo 16-bit, batched", insertMs, elapsedMs(start));
+    }
+    {
+        BST bst;
+        std::vector<Node*> path;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < size; i++) {
+            path.clear();
+            bst.insert(present[i], path);
+        }
+        double insertMs = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < 2 * size; i++) sink += bst.contains(keys[i]);
+        row("BST::contains (exact)", insertMs, elapsedMs(start));
+    }
+    {
+        AVLTree avl;
+        std::vector<AVLNode*> path;
+        RotationType rotation;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < size; i++) {
+            path.clear();
+            avl.insert(present[i], path, rotation);
+        }
+        double insertMs = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < 2 * size; i++) sink += avl.contains(keys[i]);
+        row("AVLTree::contains (exact)", insertMs, elapsedMs(start));
+    }
+    out << "  (" << sink << " positive answers in total)\n";
+
+    out << (noFalseNegatives ? "  no false negatives\n"
+                             : "  FALSE NEGATIVE or failed insert detected\n");
+    return noFalseNegatives ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// SCAPEGOAT TREE
+// ----------------------------------------------------------------------------
+// Random and ascending inserts followed by lookups of present and absent
+// keys. The plain BST only runs the random order; ascending keys would make
+// it a list with quadratic insert time.
+// ----------------------------------------------------------------------------
+int benchScapegoat(size_t size, std::ostream& out) {
+    std::vector<int> randomKeys(2 * size);
+    for (size_t i = 0; i < randomKeys.size(); i++) {
+        // Multiplying by an odd constant is a bijection, so keys are distinct
+        randomKeys[i] = static_cast<int>(static_cast<uint32_t>(i) * 2654435761u + 0x1234567u);
+    }
+    std::vector<int> ascendingKeys(2 * size);
+    for (size_t i = 0; i < ascendingKeys.size(); i++) {
+        ascendingKeys[i] = static_cast<int>(i);
+    }
+
+    out << "Scapegoat tree: " << size << " inserts, " << 2 * size
+        << " lookups (half absent) per row\n";
+    out << "  bytes per node: Node " << sizeof(Node) << ", AVLNode " << sizeof(AVLNode)
+        << " (AVL balance field " << sizeof(AVLNode::height)
+        << " B; the scapegoat tree keeps no per-node balance data)\n";
+    describeCounters(out);
+    out << std::fixed << std::setprecision(1);
+    out << "  order      tree                 insert Mops/s  search Mops/s  height      rebuilds"
+        << "  | per search:" << counterHeader() << "\n";
+
+    bool ok = true;
+    size_t sink = 0;
+    PerfCounters& counters = hardwareCounters();
+    auto row = [&out, size](const char* order, const char* label, double insertMs,
+                            double searchMs, int height, const std::string& rebuilds,
+                            const PerfCounters::Sample& searchCounters) {
+        out << "  " << std::left << std::setw(11) << order << std::setw(21) << label << std::right
+            << std::setw(14) << megaOpsPerSecond(size, insertMs)
+            << std::setw(15) << megaOpsPerSecond(2 * size, searchMs)
+            << std::setw(8) << height << std::setw(14) << rebuilds
+            << "  |            " << counterColumns(searchCounters, 2 * size) << "\n";
+    };
+
+    const char* ORDERS[] = {"random", "ascending"};
+    for (int order = 0; order < 2; order++) {
+        const std::vector<int>& keys = order == 0 ? randomKeys : ascendingKeys;
+        {
+            ScapegoatTree tree;
+            std::vector<Node*> path;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < size; i++) {
+                path.clear();
+                tree.insert(keys[i], path);
+            }
+            double insertMs = elapsedMs(start);
+            counters.start();
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < 2 * size; i++) sink += tree.contains(keys[i]);
+            double searchMs = elapsedMs(start);
+            PerfCounters::Sample searchCounters = counters.stop();
+
+            int height = tree.getHeight();
+            std::vector<int> values = tree.inorderTraversal();
+            if (static_cast<size_t>(tree.size()) != size || values.size() != size ||
+                !std::is_sorted(values.begin(), values.end()) ||
+                height - 1 > tree.getDepthLimit()) {
+                ok = false;
+            }
+            row(ORDERS[order], "ScapegoatTree a=2/3", insertMs, searchMs, height,
+                std::to_string(tree.getRebuildCount()) + " (" +
+                std::to_string(tree.getRebuiltNodeCount() / static_cast<long long>(size)) + "n)",
+                searchCounters);
+        }
+        {
+            AVLTree avl;
+            std::vector<AVLNode*> path;
+            RotationType rotation;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < size; i++) {
+                path.clear();
+                avl.insert(keys[i], path, rotation);
+            }
+            double insertMs = elapsedMs(start);
+            counters.start();
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < 2 * size; i++) sink += avl.contains(keys[i]);
+            double searchMs = elapsedMs(start);
+            PerfCounters::Sample searchCounters = counters.stop();
+            row(ORDERS[order], "AVLTree", insertMs, searchMs,
+                avl.getTreeHeight(), "-", searchCounters);
+        }
+        if (order == 0) {
+            BST bst;
+            std::vector<Node*> path;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < size; i++) {
+                path.clear();
+                bst.insert(keys[i], path);
+            }
+            double insertMs = elapsedMs(start);
+            counters.start();
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < 2 * size; i++) sink += bst.contains(keys[i]);
+            double searchMs = elapsedMs(start);
+            PerfCounters::Sample searchCounters = counters.stop();
+            row(ORDERS[order], "BST (unbalanced)", insertMs, searchMs,
+                bst.getHeight(), "-", searchCounters);
+        }
+    }
+    out << "  (" << sink << " keys found in total, expected " << 5 * size << ")\n";
+
+    if (sink != 5 * size) ok = false;
+    out << (ok ? "  scapegoat trees sorted, complete and within the depth bound\n"
+               : "  MISMATCH: scapegoat tree order, size or depth bound broken\n");
+    return ok ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// LOWEST COMMON ANCESTOR
+// ----------------------------------------------------------------------------
+// Random node pairs from a 1M-node tree (fewer if the batch is smaller).
+// The baseline is the textbook walk: record both root paths and return the
+// last node they share, O(height) per query.
+// ----------------------------------------------------------------------------
+template <typename NodeT>
+void rootPath(NodeT* root, int value, std::vector<NodeT*>& path) {
+    path.clear();
+    for (NodeT* node = root; node; node = value < node->value ? node->left : node->right) {
+        path.push_back(node);
+        if (node->value == value) break;
+    }
+}
+
+template <typename NodeT>
+NodeT* lcaByRootPaths(NodeT* root, int a, int b, std::vector<NodeT*>& pathA,
+                      std::vector<NodeT*>& pathB) {
+    rootPath(root, a, pathA);
+    rootPath(root, b, pathB);
+    NodeT* last = nullptr;
+    for (size_t i = 0; i < pathA.size() && i < pathB.size() && pathA[i] == pathB[i]; i++) {
+        last = pathA[i];
+    }
+    return last;
+}
+
+template <typename TreeT, typename NodeT>
+bool benchLcaOn(const char* label, TreeT& tree, const std::vector<NodeT*>& nodes,
+                const std::vector<uint32_t>& pairs, std::ostream& out) {
+    size_t queries = pairs.size() / 2;
+
+    auto start = std::chrono::steady_clock::now();
+    tree.lowestCommonAncestor(nodes[0], nodes[0]);     // Builds the index
+    double buildMs = elapsedMs(start);
+
+    long long fastSum = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < queries; q++) {
+        fastSum += tree.lowestCommonAncestor(nodes[pairs[2 * q]], nodes[pairs[2 * q + 1]])->id;
+    }
+    double fastMs = elapsedMs(start);
+
+    long long walkSum = 0;
+    std::vector<NodeT*> pathA, pathB;
+    start = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < queries; q++) {
+        walkSum += lcaByRootPaths(tree.getRoot(), nodes[pairs[2 * q]]->value,
+                                  nodes[pairs[2 * q + 1]]->value, pathA, pathB)->id;
+    }
+    double walkMs = elapsedMs(start);
+
+    out << "  " << std::left << std::setw(9) << label << std::right
+        << std::setw(10) << buildMs << std::setw(12) << megaOpsPerSecond(queries, fastMs)
+        << std::setw(12) << megaOpsPerSecond(queries, walkMs)
+        << std::setw(9) << (fastMs > 0 ? walkMs / fastMs : 0.0) << "x\n";
+    return fastSum == walkSum;
+}
+
+int benchLca(size_t size, std::ostream& out) {
+    size_t nodeCount = std::max<size_t>(2, std::min<size_t>(size, 1000000));
+    std::vector<int> keys(nodeCount);
+    for (size_t i = 0; i < nodeCount; i++) {
+        keys[i] = static_cast<int>(static_cast<uint32_t>(i) * 2654435761u + 0x1234567u);
+    }
+
+    BST bst;
+    AVLTree avl;
+    std::vector<Node*> path;
+    std::vector<AVLNode*> avlPath;
+    RotationType rotation;
+    for (int key : keys) {
+        path.clear();
+        avlPath.clear();
+        bst.insert(key, path);
+        avl.insert(key, avlPath, rotation);
+    }
+    std::vector<Node*> bstNodes = bst.getAllNodes();
+    std::vector<AVLNode*> avlNodes = avl.getAllNodes();
+
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(nodeCount - 1));
+    std::vector<uint32_t> pairs(2 * size);
+    for (uint32_t& index : pairs) index = pick(rng);
+
+    out << "LCA: " << size << " queries on random node pairs, " << nodeCount << "-node trees (height BST "
+        << bst.getHeight() << ", AVL " << avl.getTreeHeight() << ")\n";
+    out << std::fixed << std::setprecision(1);
+    out << "  tree      index ms  O(1) Mq/s  walk Mq/s  speedup\n";
+    bool ok = benchLcaOn("BST", bst, bstNodes, pairs, out);
+    ok = benchLcaOn("AVLTree", avl, avlNodes, pairs, out) && ok;
+
+    out << (ok ? "  Euler tour answers match the root-path walk\n"
+               : "  MISMATCH between Euler tour and root-path walk\n");
+    return ok ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// EXTERNAL SORT
+// ----------------------------------------------------------------------------
+// 'size' random int32 values are written to a temporary file and sorted
+// with a memory limit of 1/8 of the file, so there are at least 8 runs to
+// merge. For reference the same values are sorted with std::sort in
+// memory. The output is checked for order and for the same sum as the input.
+// (Unless the file is larger than the page cache, the "disk" reads are
+// served from RAM; the run and merge phases still do every read and write.)
+// ----------------------------------------------------------------------------
+int benchExternalSort(size_t size, std::ostream& out) {
+    std::vector<int> values(size);
+    std::mt19937 rng(11);
+    long long inputSum = 0;
+    for (int& value : values) {
+        value = static_cast<int>(rng());
+        inputSum += value;
+    }
+    std::string input = "sort_bench_input.bin";
+    std::string output = "sort_bench_output.bin";
+    std::string error;
+    if (!MappedIntFile::write(input, values, error)) {
+        out << error << "\n";
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::sort(values.begin(), values.end());
+    double memoryMs = elapsedMs(start);
+    values.clear();
+    values.shrink_to_fit();
+
+    size_t limit = std::max<size_t>(1, size * sizeof(int) / 8);
+    ExternalSort sorter(limit, TaskPool::shared());
+    if (!sorter.sortFile(input, output, error)) {
+        out << error << "\n";
+        std::remove(input.c_str());
+        return 2;
+    }
+    const ExternalSortStats& stats = sorter.getStats();
+
+    MappedIntFile sorted;
+    bool ok = sorted.open(output, error) && sorted.size() == size;
+    long long outputSum = 0;
+    for (size_t i = 0; ok && i < sorted.size(); i++) {
+        if (i > 0 && sorted.data()[i] < sorted.data()[i - 1]) ok = false;
+        outputSum += sorted.data()[i];
+    }
+    ok = ok && outputSum == inputSum;
+    sorted.close();
+
+    double megabytes = size * sizeof(int) / 1048576.0;
+    double totalMs = stats.runMs + stats.mergeMs;
+    out << "External sort: " << size << " values (" << std::fixed << std::setprecision(1) << megabytes
+        << " MB) with a " << limit / 1048576.0 << " MB memory limit, " << TaskPool::shared().size()
+        << " thread(s)\n";
+    out << "  phase            ms      MB/s\n";
+    out << "  runs       " << std::setw(9) << stats.runMs << std::setw(10) << megabytes / (stats.runMs / 1000.0)
+        << "   (" << stats.runs << " runs)\n";
+    out << "  merge      " << std::setw(9) << stats.mergeMs << std::setw(10) << megabytes / (stats.mergeMs / 1000.0)
+        << "   (" << stats.mergePasses << " pass, MinHeap of " << stats.runs << " heads)\n";
+    out << "  total      " << std::setw(9) << totalMs << std::setw(10) << megabytes / (totalMs / 1000.0) << "\n";
+    out << "  std::sort  " << std::setw(9) << memoryMs << std::setw(10) << megabytes / (memoryMs / 1000.0)
+        << "   (everything in memory, for reference)\n";
+    out << (ok ? "  output is sorted and has the input's checksum\n"
+               : "  OUTPUT NOT SORTED OR CHECKSUM MISMATCH\n");
+
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+    return ok ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// SLIDING WINDOW
+// ----------------------------------------------------------------------------
+// A random walk of 'size' values is written to a temporary int32 file and
+// mapped. For every width from 10 to 1,000,000 the monotonic deques run over
+// the whole stream. Rescanning each window, or rebuilding two MinHeaps per
+// window, is O(width) per value, so those baselines only run on evenly
+// spread sample windows within a fixed budget; their rate is windows per
+// second, and the deque answers on the same windows must match.
+// ----------------------------------------------------------------------------
+int benchWindow(size_t size, std::ostream& out) {
+    const size_t SCAN_BUDGET = 200000000;       // Values visited by the rescans
+    const size_t HEAP_BUDGET = 4000000;         // Heap inserts per width
+    const size_t BLOCK = 1 << 16;
+
+    std::vector<int> values(size);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> step(-1000, 1000);
+    int level = 0;
+    for (int& value : values) {
+        level = std::max(-1000000000, std::min(1000000000, level + step(rng)));
+        value = level;
+    }
+    std::string path = "window_bench_stream.bin";
+    std::string error;
+    if (!MappedIntFile::write(path, values, error)) {
+        out << error << "\n";
+        return 2;
+    }
+    values.clear();
+    values.shrink_to_fit();
+
+    MappedIntFile file;
+    if (!file.open(path, error)) {
+        out << error << "\n";
+        std::remove(path.c_str());
+        return 2;
+    }
+    const int* data = file.data();
+    size_t n = file.size();
+
+    out << "Sliding window min + max over " << n << " values (random walk, "
+        << (file.isMapped() ? "memory-mapped" : "read into memory") << ")\n";
+    out << std::fixed << std::setprecision(1);
+    out << "     width  deque M/s  scan win/s  heap win/s     vs scan     vs heap  max deque\n";
+
+    bool ok = true;
+    std::vector<int> minOut(BLOCK), maxOut(BLOCK);
+    std::vector<int> heapPath;
+    for (size_t width = 10; width <= 1000000 && width <= n; width *= 10) {
+        size_t windows = n - width + 1;
+
+        // Sample windows (by last index), evenly spread
+        size_t scanSamples = std::max<size_t>(1, std::min(windows, SCAN_BUDGET / width));
+        size_t heapSamples = std::max<size_t>(1, std::min(windows, HEAP_BUDGET / width));
+        std::vector<size_t> ends(scanSamples);
+        for (size_t i = 0; i < scanSamples; i++) {
+            ends[i] = width - 1 + static_cast<size_t>(static_cast<double>(i) * windows / scanSamples);
+        }
+
+        // Deques over the whole stream, keeping the sampled answers
+        SlidingWindow window(width);
+        std::vector<int> dequeMin(scanSamples), dequeMax(scanSamples);
+        size_t nextSample = 0;
+        size_t longest = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t base = 0; base < n; base += BLOCK) {
+            size_t count = std::min(BLOCK, n - base);
+            window.pushBlock(data + base, count, minOut.data(), maxOut.data());
+            while (nextSample < scanSamples && ends[nextSample] < base + count) {
+                dequeMin[nextSample] = minOut[ends[nextSample] - base];
+                dequeMax[nextSample] = maxOut[ends[nextSample] - base];
+                nextSample++;
+            }
+            longest = std::max(longest, std::max(window.minDequeSize(), window.maxDequeSize()));
+        }
+        double dequeMs = elapsedMs(start);
+
+        // Naive rescan of each sampled window
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < scanSamples; i++) {
+            int low = data[ends[i]];
+            int high = low;
+            for (size_t j = ends[i] + 1 - width; j < ends[i]; j++) {
+                low = std::min(low, data[j]);
+                high = std::max(high, data[j]);
+            }
+            ok = ok && low == dequeMin[i] && high == dequeMax[i];
+        }
+        double scanMs = elapsedMs(start);
+
+        // Rebuild a min heap (and a min heap of negated values) per window
+        MinHeap lowHeap, highHeap;
+        size_t stride = scanSamples / heapSamples;
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < heapSamples; i++) {
+            size_t sample = i * stride;
+            lowHeap.clear();
+            highHeap.clear();
+            for (size_t j = ends[sample] + 1 - width; j <= ends[sample]; j++) {
+                heapPath.clear();
+                lowHeap.insert(data[j], heapPath);
+                heapPath.clear();
+                highHeap.insert(-data[j], heapPath);
+            }
+            ok = ok && lowHeap.peekMin()->value == dequeMin[sample] &&
+                 -highHeap.peekMin()->value == dequeMax[sample];
+        }
+        double heapMs = elapsedMs(start);
+
+        double dequeRate = windows / (dequeMs / 1000.0);
+        double scanRate = scanSamples / (scanMs / 1000.0);
+        double heapRate = heapSamples / (heapMs / 1000.0);
+        out << std::setw(10) << width << std::setw(11) << megaOpsPerSecond(windows, dequeMs)
+            << std::setprecision(0) << std::setw(12) << scanRate << std::setw(12) << heapRate
+            << std::setprecision(1) << std::setw(11) << dequeRate / scanRate << "x"
+            << std::setw(11) << dequeRate / heapRate << "x" << std::setw(10) << longest << "\n";
+    }
+
+    out << (ok ? "  deque, rescan and heap answers match on every sampled window\n"
+               : "  MISMATCH between deque and baseline answers\n");
+    file.close();
+    std::remove(path.c_str());
+    return ok ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// ROPE
+// ----------------------------------------------------------------------------
+// A generated text file of 'size' bytes is opened both ways: mapped into a
+// Rope and read into a std::string. The same random edits (inserts and
+// deletes of up to 64 bytes, and split + concat at random offsets) are then
+// applied to both and the final texts compared. std::string shifts the
+// whole tail on every edit, so it only gets a few thousand of them; the
+// rope's own edit rate is measured again over a much longer run.
+// ----------------------------------------------------------------------------
+struct TextEdit {
+    int kind;           // 0 = insert, 1 = erase, 2 = split + concat
+    double where;       // Offset as a fraction of the current length
+    size_t count;
+};
+
+int benchRope(size_t size, std::ostream& out) {
+    const size_t COMPARED_EDITS = 4000;
+    const size_t ROPE_ONLY_EDITS = 1000000;
+
+    std::string path = "rope_bench_text.txt";
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        std::string line;
+        size_t written = 0;
+        for (size_t number = 1; written < size; number++) {
+            line = "Line " + std::to_string(number) + ": the quick brown fox jumps over the lazy dog.\n";
+            line.resize(std::min(line.size(), size - written));
+            file << line;
+            written += line.size();
+        }
+        if (!file) {
+            out << "Could not write " << path << "\n";
+            return 2;
+        }
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> where(0.0, 1.0);
+    std::uniform_int_distribution<size_t> count(1, 64);
+    std::uniform_int_distribution<int> kind(0, 99);
+    auto makeEdits = [&](size_t n) {
+        std::vector<TextEdit> edits(n);
+        for (TextEdit& edit : edits) {
+            int roll = kind(rng);
+            edit.kind = roll < 55 ? 0 : roll < 95 ? 1 : 2;
+            edit.where = where(rng);
+            edit.count = count(rng);
+        }
+        return edits;
+    };
+    const std::string insertText(64, '#');
+
+    // Open
+    std::string error;
+    Rope rope;
+    auto start = std::chrono::steady_clock::now();
+    if (!rope.loadFile(path, error)) {
+        out << error << "\n";
+        std::remove(path.c_str());
+        return 2;
+    }
+    double ropeOpenMs = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    std::string flat;
+    {
+        std::ifstream file(path, std::ios::binary);
+        flat.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    double flatOpenMs = elapsedMs(start);
+
+    out << "Rope: " << size << "-byte text, " << rope.leafCount() << " leaves of up to "
+        << Rope::LEAF_SIZE << " bytes (height " << rope.getHeight() << ")\n";
+    out << std::fixed << std::setprecision(1);
+    out << "  open:   mapped rope " << ropeOpenMs << " ms, std::string read " << flatOpenMs << " ms\n";
+
+    // Same edits on both
+    std::vector<TextEdit> edits = makeEdits(COMPARED_EDITS);
+    start = std::chrono::steady_clock::now();
+    for (const TextEdit& edit : edits) {
+        size_t pos = static_cast<size_t>(edit.where * rope.length());
+        if (edit.kind == 0) {
+            rope.insert(pos, insertText.substr(0, edit.count));
+        } else if (edit.kind == 1) {
+            rope.erase(pos, edit.count);
+        } else {
+            Rope tail = rope.split(pos);
+            rope.concat(tail);
+        }
+    }
+    double ropeMs = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    for (const TextEdit& edit : edits) {
+        size_t pos = static_cast<size_t>(edit.where * flat.size());
+        if (edit.kind == 0) {
+            flat.insert(pos, insertText, 0, edit.count);
+        } else if (edit.kind == 1) {
+            flat.erase(pos, edit.count);
+        } else {
+            std::string tail = flat.substr(pos);
+            flat.resize(pos);
+            flat += tail;
+        }
+    }
+    double flatMs = elapsedMs(start);
+
+    bool ok = rope.length() == flat.size() && rope.toString() == flat;
+    out << "  " << COMPARED_EDITS << " edits:  rope " << std::setprecision(0)
+        << COMPARED_EDITS / (ropeMs / 1000.0) << " edits/s, std::string "
+        << COMPARED_EDITS / (flatMs / 1000.0) << " edits/s (" << std::setprecision(1)
+        << (ropeMs > 0 ? flatMs / ropeMs : 0.0) << "x)\n";
+    flat.clear();
+    flat.shrink_to_fit();
+
+    // Longer rope-only run
+    edits = makeEdits(ROPE_ONLY_EDITS);
+    start = std::chrono::steady_clock::now();
+    for (const TextEdit& edit : edits) {
+        size_t pos = static_cast<size_t>(edit.where * rope.length());
+        if (edit.kind == 0) {
+            rope.insert(pos, insertText.substr(0, edit.count));
+        } else if (edit.kind == 1) {
+            rope.erase(pos, edit.count);
+        } else {
+            Rope tail = rope.split(pos);
+            rope.concat(tail);
+        }
+    }
+    ropeMs = elapsedMs(start);
+    out << "  " << ROPE_ONLY_EDITS << " more rope edits: " << megaOpsPerSecond(ROPE_ONLY_EDITS, ropeMs)
+        << " M edits/s, now " << rope.leafCount() << " leaves (height " << rope.getHeight() << ")\n";
+
+    out << (ok ? "  rope and std::string texts match\n"
+               : "  MISMATCH between rope and std::string\n");
+    rope.clear();
+    std::remove(path.c_str());
+    return ok ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// STREAM SKETCHES
+// ----------------------------------------------------------------------------
+// A Zipf-distributed stream (1M possible keys, exponent 1.1) is written to a
+// temporary file and run through the same report as --sketch, so the
+// memory-mapped path is what gets measured.
+// ----------------------------------------------------------------------------
+int benchSketch(size_t size, std::ostream& out) {
+    std::vector<int> values;
+    auto generateStart = std::chrono::steady_clock::now();
+    StreamSketch::generateZipf(size, 1000000, 1.1, 99, values);
+    double generateMs = elapsedMs(generateStart);
+
+    std::string path = "sketch_bench_stream.bin";
+    std::string error;
+    if (!MappedIntFile::write(path, values, error)) {
+        out << error << "\n";
+        return 2;
+    }
+    values.clear();
+    values.shrink_to_fit();
+    out << "Zipf stream (s = 1.1, 1,000,000 keys): " << size << " values generated in "
+        << std::fixed << std::setprecision(0) << generateMs << " ms\n";
+
+    int result = StreamSketch::analyzeFile(path, out);
+    std::remove(path.c_str());
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+// TOP-K
+// ----------------------------------------------------------------------------
+// 'size' random int32 values are written to a temporary file and mapped.
+// For K from 10 to 100,000 the parallel query runs with the SIMD block
+// filter and with a plain per-value threshold compare; std::nth_element
+// on an in-memory copy is the reference. Throughput is in GB/s of stream.
+// ----------------------------------------------------------------------------
+int benchTopK(size_t size, std::ostream& out) {
+    std::vector<int> values(size);
+    std::mt19937 rng(5);
+    for (int& value : values) value = static_cast<int>(rng());
+    std::string path = "topk_bench_stream.bin";
+    std::string error;
+    if (!MappedIntFile::write(path, values, error)) {
+        out << error << "\n";
+        return 2;
+    }
+
+    MappedIntFile file;
+    if (!file.open(path, error)) {
+        out << error << "\n";
+        std::remove(path.c_str());
+        return 2;
+    }
+    const int* data = file.data();
+    size_t n = file.size();
+    TaskPool& pool = TaskPool::shared();
+    double gigabytes = n * sizeof(int) / 1e9;
+
+    out << "Top-K over " << n << " values (" << (file.isMapped() ? "memory-mapped" : "read into memory")
+        << "), " << pool.size() << " thread(s), " << TopKQuery::instructionSet() << " filter\n";
+    out << std::fixed << std::setprecision(2);
+    out << "         K  SIMD GB/s  scalar GB/s  nth_element GB/s  vs scalar  vs nth  heap touched\n";
+
+    bool ok = true;
+    for (size_t k = 10; k <= 100000 && k <= n; k *= 10) {
+        // Warm the page cache so the first K is not charged for the reads
+        if (k == 10) {
+            TopKQuery warm(k);
+            warm.run(data, n, pool);
+        }
+
+        TopKQuery vectorQuery(k);
+        vectorQuery.run(data, n, pool, true);
+        TopKQuery scalarQuery(k);
+        scalarQuery.run(data, n, pool, false);
+
+        auto start = std::chrono::steady_clock::now();
+        std::nth_element(values.begin(), values.begin() + (k - 1), values.end(), std::greater<int>());
+        std::sort(values.begin(), values.begin() + k, std::greater<int>());
+        double selectMs = elapsedMs(start);
+        std::vector<int> expected(values.begin(), values.begin() + k);
+        std::copy(data, data + n, values.begin());          // Undo the reordering
+
+        ok = ok && vectorQuery.getResult() == expected && scalarQuery.getResult() == expected;
+
+        double vectorRate = gigabytes / (vectorQuery.getStats().ms / 1000.0);
+        double scalarRate = gigabytes / (scalarQuery.getStats().ms / 1000.0);
+        double selectRate = gigabytes / (selectMs / 1000.0);
+        out << std::setw(10) << k << std::setw(11) << vectorRate << std::setw(13) << scalarRate
+            << std::setw(18) << selectRate << std::setw(10) << vectorRate / scalarRate << "x"
+            << std::setw(7) << vectorRate / selectRate << "x" << std::setw(13) << std::setprecision(4)
+            << 100.0 * vectorQuery.getStats().heapUpdates / n << "%\n" << std::setprecision(2);
+    }
+
+    out << (ok ? "  SIMD, scalar and nth_element agree for every K\n"
+               : "  MISMATCH between top-K results\n");
+    file.close();
+    std::remove(path.c_str());
+    return ok ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// UNROLLED LIST
+// ----------------------------------------------------------------------------
+// For n = size / 10 and n = size, a LinkedList is built by inserting after
+// random existing nodes (so list order and allocation order differ, as in
+// a list that has been edited for a while) and an UnrolledList receives
+// the same sequence. Both are traversed (summing the values), searched for
+// values at random positions, and receive inserts at the middle position.
+// Search and middle-insert rates are elements walked per second.
+// ----------------------------------------------------------------------------
+int benchUnrolled(size_t size, std::ostream& out) {
+    const int CAPACITY = 32;
+    std::mt19937 rng(9);
+
+    out << "Unrolled list (" << CAPACITY << " values per block) vs LinkedList\n";
+    out << std::fixed << std::setprecision(1);
+
+    bool ok = true;
+    for (size_t n = std::max<size_t>(size / 10, 1); n <= size; n *= 10) {
+        // Scattered LinkedList: every node goes after a random earlier one
+        LinkedList list;
+        std::vector<ListNode*> handles;
+        handles.reserve(n);
+        handles.push_back(list.insertAfter(nullptr, static_cast<int>(rng() % 1000000)));
+        for (size_t i = 1; i < n; i++) {
+            handles.push_back(list.insertAfter(handles[rng() % handles.size()], static_cast<int>(rng() % 1000000)));
+        }
+        handles.clear();
+        handles.shrink_to_fit();
+
+        std::vector<int> sequence;
+        sequence.reserve(n);
+        for (ListNode* node = list.getHead(); node != nullptr; node = node->next) sequence.push_back(node->value);
+        UnrolledList unrolled(CAPACITY);
+        unrolled.loadValues(sequence);
+
+        // Traversal
+        const int PASSES = 3;
+        long long listSum = 0, unrolledSum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < PASSES; pass++) {
+            for (ListNode* node = list.getHead(); node != nullptr; node = node->next) listSum += node->value;
+        }
+        double listScanMs = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < PASSES; pass++) {
+            for (UnrolledBlock* block = unrolled.getHead(); block != nullptr; block = block->next) {
+                for (int i = 0; i < block->count; i++) unrolledSum += block->values[i];
+            }
+        }
+        double unrolledScanMs = elapsedMs(start);
+        ok = ok && listSum == unrolledSum;
+
+        // Search for values at random positions (the first occurrence counts)
+        size_t queries = std::max<size_t>(5, 50000000 / n);
+        std::vector<int> targets(queries);
+        for (int& target : targets) target = sequence[rng() % n];
+        size_t listWalked = 0;          // Same targets, so the same count for both
+        start = std::chrono::steady_clock::now();
+        for (int target : targets) {
+            for (ListNode* node = list.getHead(); node != nullptr; node = node->next) {
+                listWalked++;
+                if (node->value == target) break;
+            }
+        }
+        double listSearchMs = elapsedMs(start);
+        std::vector<UnrolledBlock*> path;
+        start = std::chrono::steady_clock::now();
+        for (int target : targets) {
+            int offset;
+            path.clear();
+            ok = ok && unrolled.search(target, offset, path) != nullptr;
+        }
+        double unrolledSearchMs = elapsedMs(start);
+
+        // Inserts at the middle position: walk there, then insert
+        start = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < queries; q++) {
+            size_t middle = static_cast<size_t>(list.getSize()) / 2;
+            ListNode* before = list.getHead();
+            for (size_t i = 1; i < middle; i++) before = before->next;
+            list.insertAfter(before, static_cast<int>(q));
+        }
+        double listInsertMs = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < queries; q++) {
+            path.clear();
+            unrolled.insertAt(unrolled.getSize() / 2, static_cast<int>(q), path);
+        }
+        double unrolledInsertMs = elapsedMs(start);
+
+        // Same sequence afterwards
+        UnrolledBlock* block = unrolled.getHead();
+        int offset = 0;
+        for (ListNode* node = list.getHead(); ok && node != nullptr; node = node->next) {
+            if (block == nullptr) {
+                ok = false;
+                break;
+            }
+            ok = block->values[offset] == node->value;
+            if (++offset == block->count) {
+                block = block->next;
+                offset = 0;
+            }
+        }
+        ok = ok && block == nullptr;
+
+        double walkedPerInsert = n / 2.0;
+        out << "  n = " << n << "   bytes/value: LinkedList " << sizeof(ListNode) << ", unrolled "
+            << static_cast<double>(unrolled.memoryBytes()) / unrolled.getSize() << "\n";
+        out << "    operation             LinkedList M/s  Unrolled M/s   speedup\n";
+        auto row = [&](const char* name, double listRate, double unrolledRate) {
+            out << "    " << std::left << std::setw(22) << name << std::right << std::setw(14) << listRate
+                << std::setw(14) << unrolledRate << std::setw(9) << unrolledRate / listRate << "x\n";
+        };
+        row("traverse (values)", megaOpsPerSecond(PASSES * n, listScanMs),
+            megaOpsPerSecond(PASSES * n, unrolledScanMs));
+        row("search (walked)", megaOpsPerSecond(listWalked, listSearchMs),
+            megaOpsPerSecond(listWalked, unrolledSearchMs));
+        row("middle insert (walked)", megaOpsPerSecond(static_cast<size_t>(queries * walkedPerInsert), listInsertMs),
+            megaOpsPerSecond(static_cast<size_t>(queries * walkedPerInsert), unrolledInsertMs));
+    }
+
+    out << (ok ? "  both lists hold the same sequence and agree on every query\n"
+               : "  MISMATCH between LinkedList and unrolled list\n");
+    return ok ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// TREE LAYOUTS
+// ----------------------------------------------------------------------------
+// One key set, four memory layouts, the same random lookups (half absent):
+// - BST / AVLTree: one heap node per key (value, two pointers and the
+//   visual fields), linked by pointers
+// - pool tree: the AVLTree's shape copied into one array in pre-order with
+//   32-bit child indices, so a left child sits next to its parent
+// - frozen array: the sorted keys in breadth-first (Eytzinger) order, the
+//   children of k at 2k and 2k + 1, searched without a branch on the key
+// Time alone hides why one layout wins; the cache and TLB misses per
+// lookup show it.
+// ----------------------------------------------------------------------------
+// Plain descent over the pointer nodes; BST / AVLTree::contains also
+// record the search path, which would time the allocator instead
+template <typename NodeT>
+bool pointerContains(const NodeT* node, int key) {
+    while (node != nullptr) {
+        if (key == node->value) return true;
+        node = key < node->value ? node->left : node->right;
+    }
+    return false;
+}
+
+struct PoolNode {
+    int value;
+    int left;           // Index into the pool, -1 if none
+    int right;
+};
+
+int copyToPool(const AVLNode* node, std::vector<PoolNode>& pool) {
+    if (node == nullptr) return -1;
+    int index = static_cast<int>(pool.size());
+    pool.push_back({node->value, -1, -1});
+    int left = copyToPool(node->left, pool);
+    int right = copyToPool(node->right, pool);
+    pool[index].left = left;
+    pool[index].right = right;
+    return index;
+}
+
+bool poolContains(const std::vector<PoolNode>& pool, int key) {
+    int index = pool.empty() ? -1 : 0;
+    while (index >= 0) {
+        const PoolNode& node = pool[index];
+        if (key == node.value) return true;
+        index = key < node.value ? node.left : node.right;
+    }
+    return false;
+}
+
+// In-order walk over the implicit tree fills it from the sorted keys
+void fillFrozen(const std::vector<int>& sorted, std::vector<int>& frozen, size_t& next, size_t k) {
+    if (k >= frozen.size()) return;
+    fillFrozen(sorted, frozen, next, 2 * k);
+    frozen[k] = sorted[next++];
+    fillFrozen(sorted, frozen, next, 2 * k + 1);
+}
+
+// 'frozen' is 1-based; slot 0 is unused
+bool frozenContains(const std::vector<int>& frozen, int key) {
+    size_t n = frozen.size() - 1;
+    size_t k = 1;
+    while (k <= n) {
+        k = 2 * k + (frozen[k] < key);
+    }
+    // Drop the right turns taken after the last left turn; k is then the
+    // smallest key >= 'key' (0 if there is none)
+    while (k & 1) k >>= 1;
+    k >>= 1;
+    return k != 0 && frozen[k] == key;
+}
+
+int benchLayout(size_t size, std::ostream& out) {
+    // Distinct pseudo-random keys (odd multiplier = bijection); the second
+    // half is never inserted
+    std::vector<int> keys(2 * size);
+    for (size_t i = 0; i < keys.size(); i++) {
+        keys[i] = static_cast<int>(static_cast<uint32_t>(i) * 2654435761u + 0x9e3779b9u);
+    }
+    std::vector<int> queries(keys);
+    std::shuffle(queries.begin(), queries.end(), std::mt19937(42));
+
+    out << "Tree layouts: " << size << " keys, " << queries.size()
+        << " random lookups (half absent) per layout\n";
+    describeCounters(out);
+
+    BST bst;
+    AVLTree avl;
+    {
+        std::vector<Node*> bstPath;
+        std::vector<AVLNode*> avlPath;
+        RotationType rotation;
+        for (size_t i = 0; i < size; i++) {
+            bstPath.clear();
+            bst.insert(keys[i], bstPath);
+            avlPath.clear();
+            avl.insert(keys[i], avlPath, rotation);
+        }
+    }
+    std::vector<PoolNode> pool;
+    pool.reserve(size);
+    copyToPool(avl.getRoot(), pool);
+
+    std::vector<int> sorted(keys.begin(), keys.begin() + size);
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> frozen(size + 1);
+    size_t next = 0;
+    fillFrozen(sorted, frozen, next, 1);
+
+    out << std::fixed << std::setprecision(1);
+    out << "  layout             B/key  height  ns/lookup" << counterHeader() << "\n";
+
+    PerfCounters& counters = hardwareCounters();
+    bool ok = true;
+    auto measure = [&](const char* label, size_t bytesPerKey, int height,
+                       const auto& contains) {
+        size_t found = 0;
+        counters.start();
+        auto start = std::chrono::steady_clock::now();
+        for (int key : queries) found += contains(key);
+        double ms = elapsedMs(start);
+        PerfCounters::Sample sample = counters.stop();
+        if (found != size) ok = false;
+        out << "  " << std::left << std::setw(17) << label << std::right
+            << std::setw(7) << bytesPerKey << std::setw(8) << height
+            << std::setw(11) << ms * 1e6 / queries.size()
+            << counterColumns(sample, queries.size()) << "\n";
+    };
+
+    const Node* bstRoot = bst.getRoot();
+    const AVLNode* avlRoot = avl.getRoot();
+    measure("BST", sizeof(Node), bst.getHeight(),
+            [bstRoot](int key) { return pointerContains(bstRoot, key); });
+    measure("AVLTree", sizeof(AVLNode), avl.getTreeHeight(),
+            [avlRoot](int key) { return pointerContains(avlRoot, key); });
+    measure("pool tree", sizeof(PoolNode), avl.getTreeHeight(),
+            [&pool](int key) { return poolContains(pool, key); });
+    int frozenHeight = 0;
+    for (size_t k = size; k > 0; k >>= 1) frozenHeight++;
+    measure("frozen array", sizeof(int), frozenHeight,
+            [&frozen](int key) { return frozenContains(frozen, key); });
+
+    out << (ok ? "  every layout found exactly the inserted keys\n"
+               : "  MISMATCH: a layout found the wrong number of keys\n");
+    return ok ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// CONCURRENT AVL
+// ----------------------------------------------------------------------------
+// A key range of 2 * size, half of it inserted up front, and 4 * size random
+// operations split evenly over 1..N threads, for three read / write mixes.
+// Writes are half inserts, half removes, so the size stays about the same.
+// ConcurrentAVL runs against an AVLTree behind one std::mutex. Each thread
+// counts its successful inserts minus removes, so the final size of both
+// sets can be checked exactly.
+// ----------------------------------------------------------------------------
+template <typename SetOps>
+double runConcurrentMix(int threads, size_t operations, int range, int readPercent,
+                        SetOps& set, long long& sizeChange) {
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::atomic<long long> change(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(1000 + t);
+            std::uniform_int_distribution<int> key(0, range - 1);
+            std::uniform_int_distribution<int> percent(0, 99);
+            size_t count = operations / threads;
+            long long local = 0;
+
+            // Start together, so the slowest thread to be created does not
+            // run alone for a while
+            ready++;
+            while (!go.load()) std::this_thread::yield();
+            for (size_t i = 0; i < count; i++) {
+                int p = percent(rng);
+                int k = key(rng);
+                if (p < readPercent) {
+                    set.contains(k);
+                } else if ((p - readPercent) % 2 == 0) {
+                    local += set.insert(k);
+                } else {
+                    local -= set.remove(k);
+                }
+            }
+            change += local;
+        });
+    }
+    while (ready.load() < threads) std::this_thread::yield();
+    auto start = std::chrono::steady_clock::now();
+    go.store(true);
+    for (std::thread& worker : workers) worker.join();
+    sizeChange = change.load();
+    return elapsedMs(start);
+}
+
+// AVLTree behind a single mutex, with the same interface as ConcurrentAVL
+struct LockedAVL {
+    std::mutex mutex;
+    AVLTree tree;
+    std::vector<AVLNode*> path;
+
+    bool insert(int value) {
+        std::lock_guard<std::mutex> guard(mutex);
+        RotationType rotation;
+        path.clear();
+        return tree.insert(value, path, rotation);
+    }
+    bool remove(int value) {
+        std::lock_guard<std::mutex> guard(mutex);
+        RotationType rotation;
+        AVLNode* deleted = nullptr;
+        path.clear();
+        bool success = tree.remove(value, path, deleted, rotation);
+        delete deleted;
+        return success;
+    }
+    bool contains(int value) {
+        std::lock_guard<std::mutex> guard(mutex);
+        path.clear();
+        return tree.search(value, path) != nullptr;
+    }
+};
+
+// Threads insert and remove their own keys (key % threads == thread) from a
+// small shared range, so their repairs keep meeting on the same few nodes.
+// Each thread knows exactly which of its keys are present, so afterwards the
+// tree is checked key by key as well as with validate(). Odd rounds hold the
+// locks for a microsecond to shuffle the interleavings.
+bool stressDisjointUpdates(int threads, int keysPerThread, size_t operations, int round,
+                           std::string& error) {
+    ConcurrentAVL concurrent;
+    concurrent.setLockHoldMicros(round % 2);
+    std::vector<std::vector<char>> present(threads, std::vector<char>(keysPerThread, 0));
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(round * 100 + t);
+            std::vector<char>& mine = present[t];
+            for (size_t i = 0; i < operations; i++) {
+                int slot = static_cast<int>(rng() % keysPerThread);
+                int key = slot * threads + t;
+                if (rng() & 1) {
+                    if (concurrent.insert(key)) mine[slot] = 1;
+                } else {
+                    if (concurrent.remove(key)) mine[slot] = 0;
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    if (!concurrent.validate(error)) return false;
+    for (int t = 0; t < threads; t++) {
+        for (int slot = 0; slot < keysPerThread; slot++) {
+            if (concurrent.contains(slot * threads + t) != (present[t][slot] != 0)) {
+                error = "key " + std::to_string(slot * threads + t) + " is wrongly " +
+                        (present[t][slot] ? "missing" : "present");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int benchConcurrent(size_t size, std::ostream& out) {
+    const int range = static_cast<int>(2 * size);
+    const size_t operations = 4 * size;
+    int maxThreads = std::max(4, static_cast<int>(std::thread::hardware_concurrency()));
+
+    std::vector<int> initial(range);
+    for (int i = 0; i < range; i++) initial[i] = i;
+    std::shuffle(initial.begin(), initial.end(), std::mt19937(3));
+    initial.resize(size);
+
+    out << "Concurrent sets: " << size << " of " << range << " keys present, " << operations
+        << " operations per run, " << std::thread::hardware_concurrency() << " hardware thread(s)\n";
+    out << std::fixed << std::setprecision(2);
+    out << "  reads  threads  ConcurrentAVL Mops/s  mutex + AVLTree Mops/s  speedup  retries\n";
+
+    bool ok = true;
+    const int READ_PERCENTS[] = {100, 90, 50};
+    for (int readPercent : READ_PERCENTS) {
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            ConcurrentAVL concurrent;
+            LockedAVL locked;
+            for (int key : initial) {
+                concurrent.insert(key);
+                locked.insert(key);
+            }
+
+            long long concurrentChange = 0;
+            long long lockedChange = 0;
+            double concurrentMs = runConcurrentMix(threads, operations, range, readPercent,
+                                                   concurrent, concurrentChange);
+            double lockedMs = runConcurrentMix(threads, operations, range, readPercent,
+                                               locked, lockedChange);
+
+            std::string error;
+            size_t done = operations / threads * threads;
+            if (!concurrent.validate(error)) {
+                out << "  ConcurrentAVL invalid after the run: " << error << "\n";
+                ok = false;
+            }
+            if (concurrent.size() != size + concurrentChange ||
+                locked.tree.inorderTraversal().size() != size + lockedChange) ok = false;
+
+            out << std::setw(6) << readPercent << "%" << std::setw(9) << threads
+                << std::setw(22) << megaOpsPerSecond(done, concurrentMs)
+                << std::setw(24) << megaOpsPerSecond(done, lockedMs)
+                << std::setw(8) << lockedMs / concurrentMs << "x"
+                << std::setw(9) << concurrent.retries() << "\n";
+        }
+    }
+
+    const int STRESS_THREADS = 8;
+    const int STRESS_ROUNDS = 8;
+    const size_t stressOperations = std::min<size_t>(size, 20000);
+    int invalidRounds = 0;
+    for (int round = 0; round < STRESS_ROUNDS; round++) {
+        std::string error;
+        if (!stressDisjointUpdates(STRESS_THREADS, 64, stressOperations, round, error)) {
+            out << "  stress round " << round << " left ConcurrentAVL invalid: " << error << "\n";
+            invalidRounds++;
+        }
+    }
+    out << "  stress: " << STRESS_THREADS << " threads x " << stressOperations
+        << " inserts / removes of their own keys, " << STRESS_ROUNDS - invalidRounds << " / "
+        << STRESS_ROUNDS << " rounds valid\n";
+    if (invalidRounds > 0) ok = false;
+
+    out << (ok ? "  both sets end with exactly the keys their threads added; ConcurrentAVL is a valid AVL tree\n"
+               : "  MISMATCH: a set lost or gained keys, or ConcurrentAVL is invalid\n");
+    return ok ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// AVL SET OPERATIONS
+// ----------------------------------------------------------------------------
+// AVLTree::unionWith / intersectWith / differenceWith vs moving the keys of
+// one tree into the other one insert or remove at a time. Two cases: two
+// sets of 'size' keys sharing half of them, and size / 1000 keys against
+// 'size'. Trees are built from sorted keys in O(n) outside the timing, and
+// again for every run, since the bulk operations consume their input.
+// ----------------------------------------------------------------------------
+void balancedPreorder(const std::vector<int>& sorted, size_t begin, size_t end,
+                      std::vector<int>& preorder) {
+    if (begin == end) return;
+    size_t middle = begin + (end - begin) / 2;
+    preorder.push_back(sorted[middle]);
+    balancedPreorder(sorted, begin, middle, preorder);
+    balancedPreorder(sorted, middle + 1, end, preorder);
+}
+
+void loadSorted(AVLTree& tree, const std::vector<int>& sorted) {
+    std::vector<int> preorder;
+    preorder.reserve(sorted.size());
+    balancedPreorder(sorted, 0, sorted.size(), preorder);
+    tree.loadPreorder(preorder);
+}
+
+// Height of a subtree, or -1 if a stored height or the balance is wrong
+int checkedAVLHeight(const AVLNode* node) {
+    if (node == nullptr) return 0;
+    int left = checkedAVLHeight(node->left);
+    int right = checkedAVLHeight(node->right);
+    if (left < 0 || right < 0 || std::abs(left - right) > 1) return -1;
+    int height = 1 + std::max(left, right);
+    return node->height == height ? height : -1;
+}
+
+int benchSetOps(size_t size, std::ostream& out) {
+    const size_t small = std::max<size_t>(size / 1000, 2);
+
+    // Distinct pseudo-random keys, as in benchLayout
+    std::vector<int> keys(2 * size);
+    for (size_t i = 0; i < keys.size(); i++) {
+        keys[i] = static_cast<int>(static_cast<uint32_t>(i) * 2654435761u + 0x9e3779b9u);
+    }
+    auto sortedRange = [&keys](size_t begin, size_t end) {
+        std::vector<int> sorted(keys.begin() + begin, keys.begin() + end);
+        std::sort(sorted.begin(), sorted.end());
+        return sorted;
+    };
+
+    struct SetCase {
+        std::string label;
+        std::vector<int> a;
+        std::vector<int> b;
+    };
+    // Each 'b' overlaps half of itself with 'a'
+    std::vector<SetCase> cases;
+    cases.push_back(SetCase{std::to_string(size) + " | " + std::to_string(size),
+                            sortedRange(0, size), sortedRange(size / 2, size / 2 + size)});
+    cases.push_back(SetCase{std::to_string(size) + " | " + std::to_string(small),
+                            sortedRange(0, size), sortedRange(size - small / 2, size - small / 2 + small)});
+
+    out << "AVL set operations: join-based bulk operations vs one insert / remove per key, "
+        << TaskPool::shared().size() << " thread(s)\n";
+    out << std::fixed << std::setprecision(1);
+    out << "  sizes                   operation     bulk ms  per key ms  speedup  result keys\n";
+
+    const char* OPERATIONS[] = {"union", "intersection", "difference"};
+    bool ok = true;
+    for (const SetCase& setCase : cases) {
+        for (int op = 0; op < 3; op++) {
+            std::vector<int> expected;
+            if (op == 0) {
+                std::set_union(setCase.a.begin(), setCase.a.end(), setCase.b.begin(), setCase.b.end(),
+                               std::back_inserter(expected));
+            } else if (op == 1) {
+                std::set_intersection(setCase.a.begin(), setCase.a.end(), setCase.b.begin(),
+                                      setCase.b.end(), std::back_inserter(expected));
+            } else {
+                std::set_difference(setCase.a.begin(), setCase.a.end(), setCase.b.begin(),
+                                    setCase.b.end(), std::back_inserter(expected));
+            }
+
+            double bulkMs;
+            {
+                AVLTree a;
+                AVLTree b;
+                loadSorted(a, setCase.a);
+                loadSorted(b, setCase.b);
+                auto start = std::chrono::steady_clock::now();
+                if (op == 0) a.unionWith(b);
+                else if (op == 1) a.intersectWith(b);
+                else a.differenceWith(b);
+                bulkMs = elapsedMs(start);
+                if (a.inorderTraversal() != expected || !b.isEmpty() ||
+                    checkedAVLHeight(a.getRoot()) < 0) ok = false;
+            }
+
+            // Union and difference insert or remove each key of 'b' in 'a';
+            // intersection inserts the keys of 'b' found in 'a' into a new
+            // tree and then frees 'a', as intersectWith() frees what it drops
+            double perKeyMs;
+            {
+                AVLTree a;
+                AVLTree result;
+                loadSorted(a, setCase.a);
+                std::vector<AVLNode*> path;
+                RotationType rotation;
+                auto start = std::chrono::steady_clock::now();
+                for (int key : setCase.b) {
+                    path.clear();
+                    if (op == 0) {
+                        a.insert(key, path, rotation);
+                    } else if (op == 1) {
+                        if (a.search(key, path)) {
+                            path.clear();
+                            result.insert(key, path, rotation);
+                        }
+                    } else {
+                        AVLNode* deleted = nullptr;
+                        a.remove(key, path, deleted, rotation);
+                        delete deleted;
+                    }
+                }
+                if (op == 1) a.clear();
+                perKeyMs = elapsedMs(start);
+                if ((op == 1 ? result : a).inorderTraversal() != expected) ok = false;
+            }
+
+            out << "  " << std::left << std::setw(24) << setCase.label << std::setw(12)
+                << OPERATIONS[op] << std::right << std::setw(10) << bulkMs
+                << std::setw(12) << perKeyMs << std::setw(8) << perKeyMs / bulkMs << "x"
+                << std::setw(13) << expected.size() << "\n";
+        }
+    }
+
+    out << (ok ? "  bulk and per-key results match std::set_* and are valid AVL trees\n"
+               : "  MISMATCH: a result has the wrong keys or is not a valid AVL tree\n");
+    return ok ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// TYPED KEYS
+// ----------------------------------------------------------------------------
+// BasicAVLTree with each supported key type, 'size' keys inserted in random
+// order and 2 * size random lookups (half absent). Three comparisons:
+// - int: AVLTree::contains (branchless descent) vs the branching walk of
+//   benchLayout over the same nodes
+// - int64 / double: BasicAVLTree<long long> / <double>
+// - strings: ShortKey vs std::string for 13- to 24-character ids, once with
+//   random first bytes and once all starting with "session:", where every
+//   prefix compare ties and bytes 8..15 decide
+// ----------------------------------------------------------------------------
+size_t keyHeapBytes(const std::string& key) {
+    return key.capacity() > 15 ? key.capacity() + 1 : 0;
+}
+size_t keyHeapBytes(const ShortKey& key) {
+    return key.isInline() ? 0 : (key.size() + 7) & ~static_cast<size_t>(7);
+}
+template <typename Key>
+size_t keyHeapBytes(const Key&) {
+    return 0;
+}
+
+// Distinct ids: a splitmix64 bijection in base 36 (13 characters), padded
+// to 13..24 characters by the hash itself
+std::string makeId(uint64_t index, const std::string& prefix) {
+    uint64_t h = index + 0x9e3779b97f4a7c15ull;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    std::string id = prefix;
+    uint64_t digits = h;
+    for (int i = 0; i < 13; i++) {
+        id += "0123456789abcdefghijklmnopqrstuvwxyz"[digits % 36];
+        digits /= 36;
+    }
+    id.append(static_cast<size_t>(h >> 60) % 12, 'x');
+    return id;
+}
+
+// Insert keys[0, size), then look up 'queries'. Returns false if the
+// lookups found a different number of keys than were inserted.
+template <typename Tree>
+bool measureKeyed(std::ostream& out, const char* type, const char* label,
+                  const std::vector<typename Tree::KeyType>& keys,
+                  const std::vector<typename Tree::KeyType>& queries, size_t size) {
+    Tree tree;
+    size_t heapBytes = 0;
+    std::vector<typename Tree::NodeType*> path;
+    RotationType rotation;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < size; i++) {
+        path.clear();
+        tree.insert(keys[i], path, rotation);
+    }
+    double insertMs = elapsedMs(start);
+    for (size_t i = 0; i < size; i++) {
+        heapBytes += keyHeapBytes(keys[i]);
+    }
+
+    PerfCounters& counters = hardwareCounters();
+    size_t found = 0;
+    counters.start();
+    start = std::chrono::steady_clock::now();
+    for (const typename Tree::KeyType& key : queries) {
+        found += tree.contains(key);
+    }
+    double lookupMs = elapsedMs(start);
+    PerfCounters::Sample sample = counters.stop();
+
+    out << "  " << std::left << std::setw(14) << type << std::setw(22) << label << std::right
+        << std::setw(7) << sizeof(typename Tree::NodeType) + heapBytes / size
+        << std::setw(7) << tree.getTreeHeight()
+        << std::setw(11) << insertMs * 1e6 / size
+        << std::setw(11) << lookupMs * 1e6 / queries.size()
+        << counterColumns(sample, queries.size()) << "\n";
+    return found == size && tree.getShapeStats().size() == size;
+}
+
+int benchKeys(size_t size, std::ostream& out) {
+    // Distinct pseudo-random ints as in benchLayout; the other key types
+    // are derived from them, so every set has 'size' distinct members
+    std::vector<int> intKeys(2 * size);
+    for (size_t i = 0; i < intKeys.size(); i++) {
+        intKeys[i] = static_cast<int>(static_cast<uint32_t>(i) * 2654435761u + 0x9e3779b9u);
+    }
+    std::vector<size_t> order(intKeys.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    // Keys in insertion order and the same keys in query order
+    auto build = [&](auto convert, auto& keys, auto& queries) {
+        keys.resize(intKeys.size());
+        queries.resize(intKeys.size());
+        for (size_t i = 0; i < intKeys.size(); i++) keys[i] = convert(i);
+        for (size_t i = 0; i < order.size(); i++) queries[i] = keys[order[i]];
+    };
+
+    out << "Typed keys: " << size << " keys per tree, " << 2 * size
+        << " random lookups (half absent)\n";
+    describeCounters(out);
+    out << std::fixed << std::setprecision(1);
+    out << "  key type      tree                   B/key height  ns/insert  ns/lookup"
+        << counterHeader() << "\n";
+
+    bool ok = true;
+    {
+        std::vector<int> keys, queries;
+        build([&](size_t i) { return intKeys[i]; }, keys, queries);
+        ok = measureKeyed<AVLTree>(out, "int", "AVLTree", keys, queries, size) && ok;
+
+        // The same keys searched with a branch per level (see pointerContains)
+        AVLTree avl;
+        std::vector<AVLNode*> path;
+        RotationType rotation;
+        for (size_t i = 0; i < size; i++) {
+            path.clear();
+            avl.insert(keys[i], path, rotation);
+        }
+        PerfCounters& counters = hardwareCounters();
+        const AVLNode* root = avl.getRoot();
+        size_t found = 0;
+        counters.start();
+        auto start = std::chrono::steady_clock::now();
+        for (int key : queries) found += pointerContains(root, key);
+        double lookupMs = elapsedMs(start);
+        PerfCounters::Sample sample = counters.stop();
+        ok = ok && found == size;
+        out << "  " << std::left << std::setw(14) << "int" << std::setw(22) << "branching walk" << std::right
+            << std::setw(7) << sizeof(AVLNode) << std::setw(7) << avl.getTreeHeight()
+            << std::setw(11) << "-"
+            << std::setw(11) << lookupMs * 1e6 / queries.size()
+            << counterColumns(sample, queries.size()) << "\n";
+    }
+    {
+        // Spread over all 64 bits (odd multiplier = bijection)
+        std::vector<long long> keys, queries;
+        build([](size_t i) { return static_cast<long long>(i * 0x9e3779b97f4a7c15ull); }, keys, queries);
+        ok = measureKeyed<BasicAVLTree<long long>>(out, "int64", "BasicAVLTree", keys, queries, size) && ok;
+    }
+    {
+        std::vector<double> keys, queries;
+        build([&](size_t i) { return intKeys[i] / 1024.0; }, keys, queries);
+        ok = measureKeyed<BasicAVLTree<double>>(out, "double", "BasicAVLTree", keys, queries, size) && ok;
+    }
+    for (const char* prefix : {"", "session:"}) {
+        const char* type = *prefix ? "\"session:\"+id" : "id";
+        std::vector<std::string> keys, queries;
+        build([&](size_t i) { return makeId(i, prefix); }, keys, queries);
+        ok = measureKeyed<BasicAVLTree<std::string>>(out, type, "std::string", keys, queries, size) && ok;
+
+        std::vector<ShortKey> shortKeys, shortQueries;
+        build([&](size_t i) { return ShortKey(keys[i]); }, shortKeys, shortQueries);
+        keys.clear();
+        keys.shrink_to_fit();
+        queries.clear();
+        queries.shrink_to_fit();
+        ok = measureKeyed<BasicAVLTree<ShortKey>>(out, type, "ShortKey", shortKeys, shortQueries, size) && ok;
+    }
+
+    out << "  B/key: node size plus heap bytes of the key\n";
+    out << (ok ? "  every tree found exactly the inserted keys\n"
+               : "  MISMATCH: a tree found the wrong number of keys\n");
+    return ok ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+// DEEP CHAIN
+// ----------------------------------------------------------------------------
+// Ascending keys turn the unbalanced BST into one chain as deep as it is
+// large, as "insert 1..100000" does from the console. The chain is loaded
+// in O(n) with loadPreorder() (inserting it key by key is quadratic), then
+// every BST operation runs at full depth: inserts and searches past the
+// deep end, removes at both ends, the invariant check, the traversals and
+// clear(). Afterwards the chain must still be a valid BST of the expected
+// size and height.
+// ----------------------------------------------------------------------------
+int benchChain(size_t size, std::ostream& out) {
+    const size_t OPS = std::min<size_t>(100, size / 2);
+    const int depth = static_cast<int>(size);
+
+    std::vector<int> keys(size);
+    for (size_t i = 0; i < size; i++) keys[i] = static_cast<int>(i);
+
+    out << "Deep chain: BST of " << size << " ascending keys (height " << size << "), "
+        << OPS << " operations per row\n";
+    out << std::fixed << std::setprecision(1);
+    out << "  operation                 ms  nodes walked per op\n";
+    auto row = [&out](const char* name, double ms, size_t walked) {
+        out << "  " << std::left << std::setw(22) << name << std::right << std::setw(8) << ms
+            << std::setw(21) << walked << "\n";
+    };
+
+    bool ok = true;
+    BST bst;
+    auto start = std::chrono::steady_clock::now();
+    bst.loadPreorder(keys);
+    row("loadPreorder", elapsedMs(start), 0);
+    ok = ok && bst.getHeight() == depth;
+
+    // Each new key hangs below the deepest node
+    std::vector<Node*> path;
+    size_t walked = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < OPS; i++) {
+        path.clear();
+        ok = bst.insert(depth + static_cast<int>(i), path) && ok;
+        walked += path.size();
+    }
+    row("insert at the bottom", elapsedMs(start), walked / OPS);
+    ok = ok && bst.getHeight() == depth + static_cast<int>(OPS);
+
+    walked = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < OPS; i++) {
+        path.clear();
+        ok = bst.search(depth + static_cast<int>(i), path) != nullptr && ok;
+        walked += path.size();
+    }
+    row("search the bottom", elapsedMs(start), walked / OPS);
+
+    // The deepest nodes, then the root, which splices out the rest of the
+    // chain below it
+    Node* deletedNode = nullptr;
+    Node* successor = nullptr;
+    walked = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = OPS; i-- > 0;) {
+        path.clear();
+        ok = bst.remove(depth + static_cast<int>(i), path, deletedNode, successor) && ok;
+        delete (successor ? successor : deletedNode);
+        walked += path.size();
+    }
+    row("remove at the bottom", elapsedMs(start), walked / OPS);
+    walked = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < OPS; i++) {
+        path.clear();
+        ok = bst.remove(static_cast<int>(i), path, deletedNode, successor) && ok;
+        delete (successor ? successor : deletedNode);
+        walked += path.size();
+    }
+    row("remove the root", elapsedMs(start), walked / OPS);
+
+    size_t expected = size - OPS;
+    start = std::chrono::steady_clock::now();
+    InvariantReport report = InvariantChecker::check(bst);
+    row("invariant check", elapsedMs(start), 0);
+    if (!report.valid) out << "  " << report.summary() << "\n";
+    start = std::chrono::steady_clock::now();
+    std::vector<int> values = bst.inorderTraversal();
+    size_t nodeCount = bst.getAllNodes().size();
+    row("inorder + getAllNodes", elapsedMs(start), 0);
+    ok = ok && report.valid && bst.getHeight() == static_cast<int>(expected) &&
+         values.size() == expected && nodeCount == expected &&
+         std::is_sorted(values.begin(), values.end()) && values.front() == static_cast<int>(OPS);
+
+    start = std::chrono::steady_clock::now();
+    bst.clear();
+    row("clear", elapsedMs(start), 0);
+    ok = ok && bst.isEmpty();
+
+    out << (ok ? "  every operation completed at full depth; the chain stayed a valid BST\n"
+               : "  MISMATCH: an operation failed or left an invalid chain\n");
+    return ok ? 0 : 1;
+}
+
+const BenchmarkEntry BENCHMARKS[] = {
+    {"interval", "IntervalTree stabbing / overlap queries vs linear scan", 1000000, benchInterval},
+    {"kdtree", "KdTree k-nearest-neighbour batches vs brute force", 1000000, benchKdTree},
+    {"filters", "Bloom / cuckoo filter FPR and throughput vs BST / AVL", 1000000, benchFilters},
+    {"sketch", "Count-min / HyperLogLog over a mapped file vs exact hash map", 10000000, benchSketch},
+    {"scapegoat", "ScapegoatTree memory and insert / search vs AVLTree and BST", 1000000, benchScapegoat},
+    {"lca", "BST / AVLTree O(1) lowest common ancestor vs root-path walk", 10000000, benchLca},
+    {"rope", "Rope edits on a mapped text file vs std::string", 64u << 20, benchRope},
+    {"window", "Sliding-window min / max deques vs rescans and MinHeap rebuilds", 100000000, benchWindow},
+    {"sort", "External k-way merge sort at 8x the memory limit vs in-memory std::sort", 100000000, benchExternalSort},
+    {"topk", "Parallel top-K with a SIMD threshold filter vs scalar filter and nth_element", 100000000, benchTopK},
+    {"unrolled", "Unrolled list traversal, search and middle insert vs LinkedList", 10000000, benchUnrolled},
+    {"layout", "BST / AVLTree / pool tree / frozen array lookups with hardware counters", 1000000, benchLayout},
+    {"concurrent", "ConcurrentAVL vs mutex + AVLTree, 1..N threads, three read / write mixes", 1000000, benchConcurrent},
+    {"setops", "AVLTree join-based union / intersection / difference vs per-key insert / remove", 10000000, benchSetOps},
+    {"keys", "AVLTree with int / int64 / double / ShortKey keys vs std::string keys", 1000000, benchKeys},
+    {"chain", "Unbalanced BST insert / search / remove / clear on a chain as deep as it is long", 1000000, benchChain},
+};
+
+} // namespace
+
+// ============================================================================
+// ENTRY POINTS
+// ============================================================================
+
+int Benchmarks::run(const std::string& name, size_t size, std::ostream& out) {
+    for (const BenchmarkEntry& entry : BENCHMARKS) {
+        if (name == entry.name) {
+            MemoryAccount::resetPeaks();
+            int status = entry.run(size > 0 ? size : entry.defaultSize, out);
+            // Peaks show what the run held at once; live bytes left over
+            // after it are structures it did not free
+            out << "\n";
+            MemoryAccount::print(out, true);
+            if (AllocationTracker::enabled()) {
+                out << "\n";
+                AllocationTracker::print(out);
+            }
+            return status;
+        }
+    }
+    if (name != "list") {
+        out << "Unknown benchmark: " << name << "\n";
+    }
+    list(out);
+    return name == "list" ? 0 : 2;
+}
+
+void Benchmarks::list(std::ostream& out) {
+    out << "Benchmarks (--bench NAME [--bench-size N]):\n";
+    for (const BenchmarkEntry& entry : BENCHMARKS) {
+        out << "  " << std::left << std::setw(11) << entry.name << std::right
+            << entry.description << " (default size " << entry.defaultSize << ")\n";
+    }
+}
@@ -0,0 +1,91 @@
+// File: Benchmarks.h
+// Description: Built-in micro-benchmarks that compare a structure against
+// the obvious baseline on large generated data sets. Results (and a check
+// that both sides agree) are printed to stdout.
+//
+// Usage:
+//   DSVisualizer --bench NAME [--bench-size N]
+//   DSVisualizer --bench list
+//
+// Benchmarks:
+//   interval   IntervalTree stabbing / overlap queries vs a linear scan
+//              (default 1,000,000 intervals)
+//   kdtree     KdTree 8-nearest-neighbour queries, serial and batched over
+//              TaskPool, vs brute force (default 1,000,000 points)
+//   filters    Blocked Bloom and cuckoo filters: false-positive rate vs
+//              bits per key, insert / query throughput per key and batched
+//              (SIMD hashing), vs BST / AVLTree::contains (default 1,000,000)
+//   sketch     Count-min sketch + HyperLogLog over a memory-mapped Zipf
+//              stream, parallel ingest vs exact counting in a hash map
+//              (default 10,000,000 values)
+//   scapegoat  ScapegoatTree bytes per node and insert / search throughput
+//              for random and ascending keys vs AVLTree (and BST for random
+//              keys), with rebuild counts (default 1,000,000)
+//   lca        Lowest common ancestor through the Euler tour index of BST and
+//              AVLTree vs walking both root paths (default 10,000,000
+//              queries on 1,000,000-node trees)
+//   rope       Rope opened by mapping a generated text file, random inserts,
+//              deletes and split + concat vs the same edits on a std::string
+//              (default 64 MB)
+//   window     Sliding-window min + max with monotonic deques over a mapped
+//              random walk, for widths 10 to 1,000,000, vs rescanning each
+//              window and rebuilding MinHeaps per window on sampled windows
+//              (default 100,000,000 values)
+//   sort       ExternalSort of a random int32 file 8x larger than its memory
+//              limit: run formation and MinHeap merge throughput, with
+//              in-memory std::sort for reference (default 100,000,000)
+//   topk       Parallel TopKQuery over a mapped random file for K = 10 to
+//              100,000 in GB/s, SIMD block filter vs a scalar threshold
+//              compare and std::nth_element (default 100,000,000 values)
+//   unrolled   UnrolledList traversal, search and middle-insert throughput
+//              vs a LinkedList built in scattered order, at size / 10 and
+//              size elements (default 10,000,000)
+//   layout     Random lookups in one key set stored as a BST, an AVLTree,
+//              a pool-allocated tree with index links and a frozen
+//              Eytzinger array: bytes per key, ns and hardware counters
+//              per lookup (default 1,000,000 keys)
+//   concurrent ConcurrentAVL vs an AVLTree behind one std::mutex for 1 to N
+//              threads and 100 / 90 / 50% reads, with retries and a validity
+//              check afterwards, then 8 threads inserting and removing
+//              disjoint keys with validate() after each round
+//              (default 1,000,000 keys)
+//   setops     AVLTree::unionWith / intersectWith / differenceWith vs one
+//              insert or remove per key, for two equal sets and for a set
+//              1000x smaller (default 10,000,000 keys)
+//   keys       BasicAVLTree insert / lookup with int, int64, double and
+//              string keys: branchless int descent vs a branching walk,
+//              ShortKey vs std::string ids with random and shared prefixes
+//              (default 1,000,000 keys)
+//   chain      Ascending keys in an unbalanced BST, one chain as deep as it
+//              is large: inserts, searches and removes at the deep end and
+//              at the root, invariant check, traversals and clear, with the
+//              result checked (default depth 1,000,000)
+//
+// "scapegoat", "layout" and "keys" read hardware counters (PerfCounters) around
+// each measured loop and report cycles, instructions, L1D / LLC misses,
+// branch misses and dTLB misses per operation. Where perf events are not
+// available (most containers) the columns show "-" and the reason is
+// printed once.
+//
+// After each benchmark the MemoryAccount breakdown is printed: peak bytes
+// per category during the run, and anything still allocated afterwards.
+// Builds with ALLOCATION_TRACKER also print allocations per call for each
+// structure operation (main thread only).
+
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+class Benchmarks {
+public:
+    // Run one benchmark; size 0 picks its default. Returns the exit code.
+    static int run(const std::string& name, size_t size, std::ostream& out);
+
+    // Print the available benchmarks
+    static void list(std::ostream& out);
+};
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,67 @@
+// File: BloomFilter.h
+// Description: Blocked Bloom filter over int keys.
+// The bit array is split into 512-bit blocks, each one cache line and
+// aligned to one. A key's first hash picks a block and all of its k bits
+// are set / tested inside that block, so a lookup touches exactly one
+// cache line instead of k random ones. The price is a slightly higher
+// false-positive rate than a classic Bloom filter with the same memory,
+// because keys are not spread perfectly evenly over the blocks.
+//
+// Batched insert / lookup hash all keys first (vectorized, see FilterHash)
+// and prefetch the blocks a few keys ahead of where they are tested.
+
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class BloomFilter {
+public:
+    static const int BLOCK_BITS = 512;
+    static const int BLOCK_WORDS = BLOCK_BITS / 64;
+    static const int MAX_HASHES = 16;
+
+private:
+    std::vector<uint64_t> storage;  // Over-allocated by one block for alignment
+    uint64_t* blocks;               // First cache-line-aligned word in 'storage'
+    uint32_t blockCount;
+    int hashCount;
+    size_t insertedCount;
+
+    uint64_t* blockFor(uint32_t h1) const;
+    static void setBits(uint64_t* block, uint32_t h2, int hashes);
+    static bool testBits(const uint64_t* block, uint32_t h2, int hashes);
+
+public:
+    // Sized for 'expectedKeys' at 'bitsPerKey' bits each; the number of
+    // hashes is the usual optimum bitsPerKey * ln 2
+    BloomFilter(size_t expectedKeys, double bitsPerKey);
+
+    // 'blocks' points into 'storage', so copies would alias
+    BloomFilter(const BloomFilter&) = delete;
+    BloomFilter& operator=(const BloomFilter&) = delete;
+
+    void insert(int key);
+    bool contains(int key) const;   // False positives possible, no false negatives
+
+    void insertBatch(const int* keys, size_t count);
+    // results[i] = contains(keys[i]); returns how many were reported present
+    size_t containsBatch(const int* keys, size_t count, uint8_t* results) const;
+
+    void clear();
+    size_t size() const { return insertedCount; }
+    size_t sizeInBits() const { return static_cast<size_t>(blockCount) * BLOCK_BITS; }
+    uint32_t getBlockCount() const { return blockCount; }
+    int getHashCount() const { return hashCount; }
+
+    // Bit access and a key's bit positions, for drawing
+    bool testBit(size_t bit) const;
+    void bitPositions(int key, std::vector<size_t>& bits) const;
+
+    // Classic (unblocked) estimate (1 - e^(-k/b))^k for reference
+    static double expectedFalsePositiveRate(double bitsPerKey, int hashes);
+};
+
+#endif // BLOOM_FILTER_H
@@ -0,0 +1,837 @@
+// File: CommandLanguage.cpp
+// Description: Lexer, recursive-descent parser and tree-walking interpreter
+// for the batch-operation language. Values from ranges and rand(...) are
+// generated on the fly, so 'insert 1..1e7' never builds a 10M-element list.
+
+#include "CommandLanguage.h"
+#include "StructureExporter.h"
+#include <cctype>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+
+// ============================================================================
+// CHECKED ARITHMETIC
+// ============================================================================
+// Signed overflow is undefined, so every operator checks first. Each
+// returns false (and leaves 'result' unspecified) when the exact result
+// does not fit in a long long.
+
+namespace {
+
+bool checkedAdd(long long a, long long b, long long& result) {
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_add_overflow(a, b, &result);
+#else
+    if ((b > 0 && a > LLONG_MAX - b) || (b < 0 && a < LLONG_MIN - b)) return false;
+    result = a + b;
+    return true;
+#endif
+}
+
+bool checkedSub(long long a, long long b, long long& result) {
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_sub_overflow(a, b, &result);
+#else
+    if ((b < 0 && a > LLONG_MAX + b) || (b > 0 && a < LLONG_MIN + b)) return false;
+    result = a - b;
+    return true;
+#endif
+}
+
+bool checkedMul(long long a, long long b, long long& result) {
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_mul_overflow(a, b, &result);
+#else
+    if (a > 0) {
+        if (b > 0 ? a > LLONG_MAX / b : b < LLONG_MIN / a) return false;
+    } else {
+        if (b > 0 ? a < LLONG_MIN / b : a != 0 && b < LLONG_MAX / a) return false;
+    }
+    result = a * b;
+    return true;
+#endif
+}
+
+} // namespace
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+CommandInterpreter::CommandInterpreter(StructureAdapter& adapter)
+    : target(&adapter), position(0), timingDepth(0)
+{
+    output = [](const std::string&, bool) {};
+}
+
+bool CommandInterpreter::needsMoreInput(const std::string& source) {
+    int depth = 0;
+    bool inComment = false;
+    for (char c : source) {
+        if (c == '\n') inComment = false;
+        else if (c == '#') inComment = true;
+        else if (!inComment && c == '{') depth++;
+        else if (!inComment && c == '}') depth--;
+    }
+    return depth > 0;
+}
+
+// ============================================================================
+// LEXER
+// ============================================================================
+
+bool CommandInterpreter::tokenize(const std::string& source) {
+    tokens.clear();
+    bool space = true;
+    size_t i = 0;
+
+    auto push = [&](TokenType type, const std::string& text, long long number, size_t column) {
+        tokens.push_back({type, text, number, space, static_cast<int>(column)});
+        space = false;
+    };
+
+    while (i < source.size()) {
+        char c = source[i];
+
+        if (c == ' ' || c == '\t' || c == '\r') {
+            space = true;
+            i++;
+        }
+        else if (c == '\n') {
+            push(TokenType::NEWLINE, "\n", 0, i);
+            space = true;
+            i++;
+        }
+        else if (c == '#') {
+            while (i < source.size() && source[i] != '\n') i++;
+        }
+        else if (std::isdigit(static_cast<unsigned char>(c))) {
+            // Integer digits, optional exponent ('1e6'). Values are integers,
+            // so a fraction is an error rather than silently rounded (but
+            // '1..5' is a range, not a fraction).
+            size_t start = i;
+            while (i < source.size() && std::isdigit(static_cast<unsigned char>(source[i]))) i++;
+            if (i + 1 < source.size() && source[i] == '.' &&
+                std::isdigit(static_cast<unsigned char>(source[i + 1]))) {
+                parseError = "fractional number at column " + std::to_string(start + 1) +
+                             " (values are integers)";
+                return false;
+            }
+            errno = 0;
+            long long value = std::strtoll(source.c_str() + start, nullptr, 10);
+            bool inRange = errno == 0;
+            if (i < source.size() && (source[i] == 'e' || source[i] == 'E')) {
+                size_t j = i + 1;
+                if (j < source.size() && source[j] == '+') j++;
+                if (j < source.size() && source[j] == '-') {
+                    parseError = "negative exponent at column " + std::to_string(start + 1) +
+                                 " (values are integers)";
+                    return false;
+                }
+                if (j < source.size() && std::isdigit(static_cast<unsigned char>(source[j]))) {
+                    i = j;
+                    long long exponent = 0;
+                    while (i < source.size() && std::isdigit(static_cast<unsigned char>(source[i]))) {
+                        if (exponent < 100) exponent = exponent * 10 + (source[i] - '0');
+                        i++;
+                    }
+                    for (long long e = 0; e < exponent && inRange && value != 0; e++) {
+                        inRange = checkedMul(value, 10, value);
+                    }
+                }
+            }
+            if (!inRange) {
+                parseError = "number out of range at column " + std::to_string(start + 1);
+                return false;
+            }
+            push(TokenType::NUMBER, source.substr(start, i - start), value, start);
+        }
+        else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            size_t start = i;
+            while (i < source.size() &&
+                   (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_')) i++;
+            push(TokenType::IDENT, source.substr(start, i - start), 0, start);
+        }
+        else if (c == '.' && i + 1 < source.size() && source[i + 1] == '.') {
+            push(TokenType::SYMBOL, "..", 0, i);
+            i += 2;
+        }
+        else if (std::string(",;{}()=+-*/%").find(c) != std::string::npos) {
+            push(TokenType::SYMBOL, std::string(1, c), 0, i);
+            i++;
+        }
+        else {
+            parseError = "unexpected character '" + std::string(1, c) +
+                         "' at column " + std::to_string(i + 1);
+            return false;
+        }
+    }
+
+    tokens.push_back({TokenType::END, "", 0, true, static_cast<int>(source.size())});
+    return true;
+}
+
+const CommandInterpreter::Token& CommandInterpreter::peek(size_t ahead) const {
+    size_t index = std::min(position + ahead, tokens.size() - 1);
+    return tokens[index];
+}
+
+bool CommandInterpreter::accept(const std::string& symbol) {
+    const Token& token = peek();
+    if ((token.type == TokenType::SYMBOL || token.type == TokenType::IDENT) && token.text == symbol) {
+        position++;
+        return true;
+    }
+    return false;
+}
+
+bool CommandInterpreter::expect(const std::string& symbol) {
+    if (accept(symbol)) return true;
+    return fail("expected '" + symbol + "'");
+}
+
+bool CommandInterpreter::atStatementEnd() const {
+    const Token& token = peek();
+    return token.type == TokenType::END || token.type == TokenType::NEWLINE ||
+           (token.type == TokenType::SYMBOL && (token.text == ";" || token.text == "}"));
+}
+
+bool CommandInterpreter::fail(const std::string& message) {
+    if (parseError.empty()) {
+        const Token& token = peek();
+        std::string where = token.type == TokenType::END ? "end of input"
+                          : token.type == TokenType::NEWLINE ? "end of line"
+                          : "'" + token.text + "'";
+        parseError = message + " near " + where;
+    }
+    return false;
+}
+
+// ============================================================================
+// PARSER
+// ============================================================================
+
+bool CommandInterpreter::parseBlock(std::vector<std::unique_ptr<Statement>>& body) {
+    if (!expect("{")) return false;
+    while (true) {
+        while (peek().type == TokenType::NEWLINE || accept(";")) {
+            if (peek().type == TokenType::NEWLINE) position++;
+        }
+        if (accept("}")) return true;
+        if (peek().type == TokenType::END) return fail("missing '}'");
+
+        std::unique_ptr<Statement> stmt = parseStatement();
+        if (!stmt) return false;
+        body.push_back(std::move(stmt));
+    }
+}
+
+std::unique_ptr<CommandInterpreter::Statement> CommandInterpreter::parseStatement() {
+    std::unique_ptr<Statement> stmt(new Statement());
+    const Token& token = peek();
+
+    if (token.type == TokenType::SYMBOL && token.text == "{") {
+        stmt->kind = Statement::BLOCK;
+        if (!parseBlock(stmt->body)) return nullptr;
+        return stmt;
+    }
+    if (token.type != TokenType::IDENT) {
+        fail("expected a command");
+        return nullptr;
+    }
+
+    std::string keyword = token.text;
+    position++;
+
+    if (keyword == "insert" || keyword == "delete" || keyword == "remove" || keyword == "search") {
+        stmt->kind = Statement::OPERATION;
+        stmt->op = keyword == "remove" ? "delete" : keyword;
+        if (!parseValueList(stmt->values)) return nullptr;
+    }
+    else if (keyword == "pop") {
+        stmt->kind = Statement::POP;
+        if (!atStatementEnd()) {
+            stmt->count = parseExpression();
+            if (!stmt->count) return nullptr;
+        }
+    }
+    else if (keyword == "sleep") {
+        stmt->kind = Statement::SLEEP;
+        stmt->count = parseExpression();
+        if (!stmt->count) return nullptr;
+    }
+    else if (keyword == "clear") {
+        stmt->kind = Statement::CLEAR;
+    }
+    else if (keyword == "print") {
+        stmt->kind = Statement::PRINT;
+    }
+    else if (keyword == "shape") {
+        stmt->kind = Statement::SHAPE;
+    }
+    else if (keyword == "check") {
+        stmt->kind = Statement::CHECK;
+    }
+    else if (keyword == "help") {
+        stmt->kind = Statement::HELP;
+    }
+    else if (keyword == "export") {
+        stmt->kind = Statement::EXPORT;
+        if (peek().type != TokenType::IDENT || (peek().text != "dot" && peek().text != "json")) {
+            fail("expected 'dot' or 'json'");
+            return nullptr;
+        }
+        stmt->name = peek().text;
+        position++;
+    }
+    else if (keyword == "use") {
+        stmt->kind = Statement::USE;
+        if (peek().type != TokenType::IDENT) {
+            fail("expected a structure name");
+            return nullptr;
+        }
+        stmt->name = peek().text;
+        position++;
+    }
+    else if (keyword == "repeat") {
+        stmt->kind = Statement::REPEAT;
+        stmt->count = parseExpression();
+        if (!stmt->count || !parseBlock(stmt->body)) return nullptr;
+    }
+    else if (keyword == "for") {
+        stmt->kind = Statement::FOR;
+        if (peek().type != TokenType::IDENT) {
+            fail("expected a loop variable");
+            return nullptr;
+        }
+        stmt->name = peek().text;
+        position++;
+        if (!expect("in")) return nullptr;
+        ValueSource source;
+        if (!parseValueSource(source)) return nullptr;
+        stmt->values.push_back(std::move(source));
+        if (!parseBlock(stmt->body)) return nullptr;
+    }
+    else if (keyword == "time") {
+        stmt->kind = Statement::TIME;
+        if (!parseBlock(stmt->body)) return nullptr;
+    }
+    else {
+        position--;
+        fail("unknown command");
+        return nullptr;
+    }
+
+    if (!atStatementEnd()) {
+        fail("unexpected input");
+        return nullptr;
+    }
+    return stmt;
+}
+
+bool CommandInterpreter::parseValueList(std::vector<ValueSource>& values) {
+    if (atStatementEnd()) return fail("expected at least one value");
+    while (!atStatementEnd()) {
+        ValueSource source;
+        if (!parseValueSource(source)) return false;
+        values.push_back(std::move(source));
+        accept(",");
+    }
+    return true;
+}
+
+bool CommandInterpreter::parseValueSource(ValueSource& source) {
+    // rand(count, seed=S, min=A, max=B)
+    if (peek().type == TokenType::IDENT && peek().text == "rand" &&
+        peek(1).type == TokenType::SYMBOL && peek(1).text == "(") {
+        position += 2;
+        source.kind = ValueSource::RANDOM;
+        source.first = parseExpression();
+        if (!source.first) return false;
+        while (accept(",")) {
+            if (peek().type != TokenType::IDENT) return fail("expected option name");
+            std::string option = peek().text;
+            if (option != "seed" && option != "min" && option != "max") {
+                return fail("unknown rand option");
+            }
+            position++;
+            if (!expect("=")) return false;
+            source.options[option] = parseExpression();
+            if (!source.options[option]) return false;
+        }
+        return expect(")");
+    }
+
+    source.kind = ValueSource::SINGLE;
+    source.first = parseExpression();
+    if (!source.first) return false;
+
+    if (accept("..")) {
+        source.kind = ValueSource::RANGE;
+        source.last = parseExpression();
+        if (!source.last) return false;
+        if (accept("step")) {
+            source.step = parseExpression();
+            if (!source.step) return false;
+        }
+    }
+    return true;
+}
+
+// expression := term (('+' | '-') term)*
+// A '-' with a space before it but not after ("insert 1 -2") starts a new
+// value instead of subtracting.
+std::unique_ptr<CommandInterpreter::Expr> CommandInterpreter::parseExpression() {
+    std::unique_ptr<Expr> left = parseTerm();
+    while (left) {
+        const Token& token = peek();
+        if (token.type != TokenType::SYMBOL || (token.text != "+" && token.text != "-")) break;
+        if (token.spaceBefore && !peek(1).spaceBefore) break;
+
+        position++;
+        std::unique_ptr<Expr> node(new Expr());
+        node->kind = Expr::BINARY;
+        node->op = token.text[0];
+        node->left = std::move(left);
+        node->right = parseTerm();
+        if (!node->right) return nullptr;
+        left = std::move(node);
+    }
+    return left;
+}
+
+// term := unary (('*' | '/' | '%') unary)*
+std::unique_ptr<CommandInterpreter::Expr> CommandInterpreter::parseTerm() {
+    std::unique_ptr<Expr> left = parseUnary();
+    while (left) {
+        const Token& token = peek();
+        if (token.type != TokenType::SYMBOL ||
+            (token.text != "*" && token.text != "/" && token.text != "%")) break;
+
+        position++;
+        std::unique_ptr<Expr> node(new Expr());
+        node->kind = Expr::BINARY;
+        node->op = token.text[0];
+        node->left = std::move(left);
+        node->right = parseUnary();
+        if (!node->right) return nullptr;
+        left = std::move(node);
+    }
+    return left;
+}
+
+// unary := '-' unary | NUMBER | IDENT | '(' expression ')'
+std::unique_ptr<CommandInterpreter::Expr> CommandInterpreter::parseUnary() {
+    const Token& token = peek();
+    std::unique_ptr<Expr> node(new Expr());
+
+    if (token.type == TokenType::SYMBOL && token.text == "-") {
+        position++;
+        node->kind = Expr::NEGATE;
+        node->left = parseUnary();
+        if (!node->left) return nullptr;
+        return node;
+    }
+    if (token.type == TokenType::NUMBER) {
+        node->kind = Expr::NUMBER;
+        node->number = token.number;
+        position++;
+        return node;
+    }
+    if (token.type == TokenType::IDENT && token.text != "step") {
+        node->kind = Expr::VARIABLE;
+        node->name = token.text;
+        position++;
+        return node;
+    }
+    if (accept("(")) {
+        std::unique_ptr<Expr> inner = parseExpression();
+        if (!inner || !expect(")")) return nullptr;
+        return inner;
+    }
+
+    fail("expected a value");
+    return nullptr;
+}
+
+// ============================================================================
+// EXECUTION
+// ============================================================================
+
+bool CommandInterpreter::run(const std::string& source) {
+    stats = BatchStats();
+    parseError.clear();
+    position = 0;
+
+    if (!tokenize(source)) {
+        output("Syntax error: " + parseError, true);
+        return false;
+    }
+
+    // Parse everything first so a typo late in the program doesn't leave
+    // the structure half-modified
+    std::vector<std::unique_ptr<Statement>> program;
+    while (true) {
+        while (peek().type == TokenType::NEWLINE || accept(";")) {
+            if (peek().type == TokenType::NEWLINE) position++;
+        }
+        if (peek().type == TokenType::END) break;
+
+        std::unique_ptr<Statement> stmt = parseStatement();
+        if (!stmt) {
+            output("Syntax error: " + parseError, true);
+            return false;
+        }
+        program.push_back(std::move(stmt));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = true;
+    for (const auto& stmt : program) {
+        if (!execute(*stmt)) {
+            ok = false;
+            break;
+        }
+    }
+    stats.elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return ok;
+}
+
+bool CommandInterpreter::evaluate(const Expr& expr, long long& result) {
+    long long a = 0, b = 0;
+    switch (expr.kind) {
+        case Expr::NUMBER:
+            result = expr.number;
+            return true;
+
+        case Expr::VARIABLE: {
+            auto it = variables.find(expr.name);
+            if (it == variables.end()) {
+                output("Error: unknown variable '" + expr.name + "'", true);
+                return false;
+            }
+            result = it->second;
+            return true;
+        }
+
+        case Expr::NEGATE:
+            if (!evaluate(*expr.left, a)) return false;
+            if (!checkedSub(0, a, result)) {
+                output("Error: arithmetic overflow", true);
+                return false;
+            }
+            return true;
+
+        case Expr::BINARY:
+            if (!evaluate(*expr.left, a) || !evaluate(*expr.right, b)) return false;
+            switch (expr.op) {
+                case '+': if (checkedAdd(a, b, result)) return true; break;
+                case '-': if (checkedSub(a, b, result)) return true; break;
+                case '*': if (checkedMul(a, b, result)) return true; break;
+                case '/':
+                case '%':
+                    if (b == 0) {
+                        output("Error: division by zero", true);
+                        return false;
+                    }
+                    // LLONG_MIN / -1 overflows; LLONG_MIN % -1 is 0 but is
+                    // undefined in C++ as well
+                    if (b == -1) {
+                        if (expr.op == '%') result = 0;
+                        else if (!checkedSub(0, a, result)) break;
+                        return true;
+                    }
+                    result = expr.op == '/' ? a / b : a % b;
+                    return true;
+                default:
+                    return false;
+            }
+            output("Error: arithmetic overflow", true);
+            return false;
+    }
+    return false;
+}
+
+bool CommandInterpreter::forEachValue(const std::vector<ValueSource>& values,
+                                      const std::function<bool(int)>& callback, long long& count) {
+    auto emit = [&](long long v) -> bool {
+        if (v < INT_MIN || v > INT_MAX) {
+            output("Error: value " + std::to_string(v) + " does not fit in an int", true);
+            return false;
+        }
+        count++;
+        return callback(static_cast<int>(v));
+    };
+
+    for (const ValueSource& source : values) {
+        long long first = 0;
+        if (!evaluate(*source.first, first)) return false;
+
+        if (source.kind == ValueSource::SINGLE) {
+            if (!emit(first)) return false;
+        }
+        else if (source.kind == ValueSource::RANGE) {
+            long long last = 0, step = 1;
+            if (!evaluate(*source.last, last)) return false;
+            if (source.step && !evaluate(*source.step, step)) return false;
+            if (step == 0) {
+                output("Error: range step cannot be 0", true);
+                return false;
+            }
+            // Stop when the next value would not fit in a long long; it
+            // would be past 'last' anyway
+            if (step > 0) {
+                for (long long v = first; v <= last; ) {
+                    if (!emit(v)) return false;
+                    if (!checkedAdd(v, step, v)) break;
+                }
+            } else {
+                for (long long v = first; v >= last; ) {
+                    if (!emit(v)) return false;
+                    if (!checkedAdd(v, step, v)) break;
+                }
+            }
+        }
+        else {
+            long long minValue = 0, maxValue = 999999, seed = 0;
+            bool seeded = source.options.count("seed") > 0;
+            if (source.options.count("min") && !evaluate(*source.options.at("min"), minValue)) return false;
+            if (source.options.count("max") && !evaluate(*source.options.at("max"), maxValue)) return false;
+            if (seeded && !evaluate(*source.options.at("seed"), seed)) return false;
+            if (minValue > maxValue) {
+                output("Error: rand min is greater than max", true);
+                return false;
+            }
+
+            std::mt19937_64 rng(seeded ? static_cast<unsigned long long>(seed) : std::random_device()());
+            std::uniform_int_distribution<long long> dist(minValue, maxValue);
+            for (long long i = 0; i < first; i++) {
+                if (!emit(dist(rng))) return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool CommandInterpreter::applyOperation(const std::string& op, int value, bool verbose) {
+    // Only single-value statements are reported per operation; batches are
+    // applied silently and the caller redraws once at the end
+    bool notify = verbose && timingDepth == 0;
+    if (notify && beforeOp) beforeOp(op, value);
+
+    pathBuffer.clear();
+    bool success;
+    if (op == "insert") success = target->insert(value, pathBuffer);
+    else if (op == "delete") success = target->remove(value, pathBuffer);
+    else success = target->search(value, pathBuffer);
+
+    stats.operations++;
+    stats.nodesVisited += static_cast<long long>(pathBuffer.size());
+    if (success) stats.succeeded++;
+    else stats.failed++;
+
+    if (notify && afterOp) afterOp(op, value, success, pathBuffer);
+
+    if (verbose) {
+        std::string v = std::to_string(value);
+        if (op == "insert") {
+            output(success ? "Inserted: " + v : "Error: " + v + " already exists!", !success);
+        } else if (op == "delete") {
+            output(success ? "Deleted: " + v : "Error: " + v + " not found!", !success);
+        } else {
+            output(success ? "Found: " + v : v + " not found.", false);
+        }
+    }
+    return true;
+}
+
+bool CommandInterpreter::execute(const Statement& stmt) {
+    switch (stmt.kind) {
+        case Statement::OPERATION: {
+            // A single plain value gets the classic one-line message;
+            // anything larger gets a summary instead of one line per value
+            bool verbose = stmt.values.size() == 1 && stmt.values[0].kind == ValueSource::SINGLE;
+            BatchStats before = stats;
+            long long count = 0;
+            bool ok = forEachValue(stmt.values, [&](int v) {
+                return applyOperation(stmt.op, v, verbose);
+            }, count);
+            if (ok && !verbose && timingDepth == 0) {
+                output(stmt.op + ": " + std::to_string(count) + " values (ok " +
+                       std::to_string(stats.succeeded - before.succeeded) + ", failed " +
+                       std::to_string(stats.failed - before.failed) + ")", false);
+            }
+            return ok;
+        }
+
+        case Statement::POP: {
+            long long count = 1;
+            if (stmt.count && !evaluate(*stmt.count, count)) return false;
+            long long removed = 0;
+            int value = 0;
+            for (long long i = 0; i < count; i++) {
+                stats.operations++;
+                if (!target->pop(value)) {
+                    stats.failed++;
+                    break;
+                }
+                stats.succeeded++;
+                removed++;
+                if (count == 1 && timingDepth == 0 && afterOp) {
+                    afterOp("pop", value, true, std::vector<int>());
+                }
+            }
+            if (count == 1) {
+                output(removed ? "Removed: " + std::to_string(value)
+                               : "Error: " + target->name() + " is empty!", removed == 0);
+            } else if (timingDepth == 0) {
+                output("pop: removed " + std::to_string(removed) + " of " + std::to_string(count), false);
+            }
+            return true;
+        }
+
+        case Statement::CLEAR:
+            target->clear();
+            output(target->name() + " cleared!", false);
+            return true;
+
+        case Statement::PRINT:
+            output(target->toString(), false);
+            return true;
+
+        case Statement::SHAPE: {
+            const ShapeStats* shape = target->shapeStats();
+            if (shape == nullptr) {
+                output("Error: no shape statistics for " + target->name(), true);
+                return false;
+            }
+            std::istringstream lines(shape->toString());
+            std::string line;
+            while (std::getline(lines, line)) {
+                output(line, false);
+            }
+            return true;
+        }
+
+        case Statement::CHECK: {
+            InvariantReport report = target->checkInvariants();
+            output(target->name() + ": " + report.summary(), !report.valid);
+            return report.valid;
+        }
+
+        case Statement::HELP:
+            printHelp();
+            return true;
+
+        case Statement::EXPORT: {
+            ExportFormat format = stmt.name == "dot" ? ExportFormat::DOT : ExportFormat::JSON;
+            std::string file = StructureExporter::defaultFileName(target->kind(), format);
+            std::string error;
+            if (!StructureExporter::exportStructure(*target, format, file, error)) {
+                output("Error: " + error, true);
+                return false;
+            }
+            output("Exported to " + file, false);
+            return true;
+        }
+
+        case Statement::SLEEP: {
+            long long ms = 0;
+            if (!evaluate(*stmt.count, ms)) return false;
+            if (ms > 0) std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+            return true;
+        }
+
+        case Statement::USE: {
+            StructureKind kind;
+            if (!StructureAdapter::parseKind(stmt.name, kind)) {
+                output("Error: unknown structure '" + stmt.name + "'", true);
+                return false;
+            }
+            StructureAdapter* next = selectStructure ? selectStructure(kind) : nullptr;
+            if (next == nullptr) {
+                output("Error: 'use' is not available here", true);
+                return false;
+            }
+            target = next;
+            output("Using " + target->name(), false);
+            return true;
+        }
+
+        case Statement::REPEAT: {
+            long long count = 0;
+            if (!evaluate(*stmt.count, count)) return false;
+            for (long long i = 0; i < count; i++) {
+                for (const auto& child : stmt.body) {
+                    if (!execute(*child)) return false;
+                }
+            }
+            return true;
+        }
+
+        case Statement::FOR: {
+            bool hadPrevious = variables.count(stmt.name) > 0;
+            long long previous = hadPrevious ? variables[stmt.name] : 0;
+            long long count = 0;
+            bool ok = forEachValue(stmt.values, [&](int v) {
+                variables[stmt.name] = v;
+                for (const auto& child : stmt.body) {
+                    if (!execute(*child)) return false;
+                }
+                return true;
+            }, count);
+            if (hadPrevious) variables[stmt.name] = previous;
+            else variables.erase(stmt.name);
+            return ok;
+        }
+
+        case Statement::TIME: {
+            BatchStats before = stats;
+            timingDepth++;
+            auto start = std::chrono::steady_clock::now();
+            bool ok = true;
+            for (const auto& child : stmt.body) {
+                if (!execute(*child)) {
+                    ok = false;
+                    break;
+                }
+            }
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            timingDepth--;
+
+            long long ops = stats.operations - before.operations;
+            std::ostringstream ss;
+            ss << std::fixed << std::setprecision(3) << "time: " << ms << " ms | "
+               << ops << " ops | ok " << (stats.succeeded - before.succeeded)
+               << " | failed " << (stats.failed - before.failed)
+               << " | visited " << (stats.nodesVisited - before.nodesVisited);
+            if (ms > 0) {
+                ss << std::setprecision(2) << " | " << (ops / ms / 1000.0) << " M ops/s";
+            }
+            output(ss.str(), false);
+            return ok;
+        }
+
+        case Statement::BLOCK:
+            for (const auto& child : stmt.body) {
+                if (!execute(*child)) return false;
+            }
+            return true;
+    }
+    return false;
+}
+
+void CommandInterpreter::printHelp() {
+    output("insert|delete|search VALUES   e.g. insert 5, 1..100 step 7, rand(1e4, seed=3)", false);
+    output("pop [N] | clear | print | shape | check | sleep MS | use bst|avl|list|stack|queue|heap|scapegoat", false);
+    output("export dot|json", false);
+    output("repeat N { ... } | for i in 1..10 { insert i*i } | time { ... }", false);
+}
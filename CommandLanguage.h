@@ -0,0 +1,169 @@
+// File: CommandLanguage.h
+// Description: A small batch-operation language for the console and the
+// headless driver. Lets users apply thousands of operations at once
+// instead of one button click (and one full animation) per value.
+//
+// Syntax overview (statements are separated by ';' or newlines):
+//   insert 5, 8 12                   - plain values (commas optional)
+//   insert 1..100000 step 7          - inclusive ranges
+//   insert rand(1e6, seed=3)         - 1e6 random values (options: seed, min, max)
+//   delete 3, 1..10                  - mixed lists
+//   search i*2 + 1                   - 64-bit integer expressions (+ - * / %);
+//                                      overflow is an error, and so is a
+//                                      fraction such as 1.5 (1e6 is fine)
+//   pop [N]                          - pop / dequeue / extract-min N times
+//   repeat 10 { insert rand(100) }   - loops
+//   for i in 1..50 step 2 { insert i*i }
+//   time { insert 1..1e5 }           - report elapsed time and counters
+//   export dot|json                  - write <structure>_export.dot / .json
+//   shape                            - tree shape statistics (bst, avl)
+//   check                            - verify the structure's invariants
+//   clear | print | sleep MS | use bst | help
+
+#ifndef COMMAND_LANGUAGE_H
+#define COMMAND_LANGUAGE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include "StructureAdapter.h"
+
+// ============================================================================
+// BATCH STATISTICS
+// ============================================================================
+// Counters collected while a program runs (reset per run and per 'time').
+// ============================================================================
+struct BatchStats {
+    long long operations;
+    long long succeeded;
+    long long failed;
+    long long nodesVisited;     // Sum of path lengths
+    double elapsedMs;
+
+    BatchStats() : operations(0), succeeded(0), failed(0), nodesVisited(0), elapsedMs(0) {}
+};
+
+// ============================================================================
+// COMMAND INTERPRETER CLASS
+// ============================================================================
+class CommandInterpreter {
+public:
+    // Receives every output line; isError marks failures
+    typedef std::function<void(const std::string& message, bool isError)> OutputFn;
+
+    // Called before / after an operation of a single-value statement (for
+    // animation). Batches don't trigger them - redraw once after run().
+    // 'op' is "insert", "delete", "search" or "pop".
+    typedef std::function<void(const std::string& op, int value)> BeforeOpFn;
+    typedef std::function<void(const std::string& op, int value, bool success,
+                               const std::vector<int>& pathIds)> AfterOpFn;
+
+    // Switches the active structure for 'use'; returns nullptr if not allowed
+    typedef std::function<StructureAdapter*(StructureKind kind)> SelectFn;
+
+private:
+    // ------------------------------------------------------------------------
+    // Lexer
+    // ------------------------------------------------------------------------
+    enum class TokenType { NUMBER, IDENT, SYMBOL, NEWLINE, END };
+
+    struct Token {
+        TokenType type;
+        std::string text;
+        long long number;
+        bool spaceBefore;       // Whitespace precedes this token
+        int column;
+    };
+
+    // ------------------------------------------------------------------------
+    // Syntax tree
+    // ------------------------------------------------------------------------
+    struct Expr {
+        enum Kind { NUMBER, VARIABLE, BINARY, NEGATE } kind;
+        long long number;
+        std::string name;
+        char op;
+        std::unique_ptr<Expr> left, right;
+    };
+
+    // One item of a value list: a single expression, a range or rand(...)
+    struct ValueSource {
+        enum Kind { SINGLE, RANGE, RANDOM } kind;
+        std::unique_ptr<Expr> first;        // value / range start / rand count
+        std::unique_ptr<Expr> last;         // range end
+        std::unique_ptr<Expr> step;         // range step (optional)
+        std::unordered_map<std::string, std::unique_ptr<Expr>> options;  // rand options
+    };
+
+    struct Statement {
+        enum Kind { OPERATION, POP, CLEAR, PRINT, SHAPE, CHECK, SLEEP, USE, HELP, EXPORT,
+                    REPEAT, FOR, TIME, BLOCK } kind;
+        std::string op;                     // insert / delete / search
+        std::vector<ValueSource> values;    // operation arguments / for range
+        std::unique_ptr<Expr> count;        // repeat count, pop count, sleep ms
+        std::string name;                   // loop variable / structure / export format
+        std::vector<std::unique_ptr<Statement>> body;
+    };
+
+    StructureAdapter* target;
+    OutputFn output;
+    BeforeOpFn beforeOp;
+    AfterOpFn afterOp;
+    SelectFn selectStructure;
+
+    std::vector<Token> tokens;
+    size_t position;
+    std::string parseError;
+
+    std::unordered_map<std::string, long long> variables;
+    BatchStats stats;
+    int timingDepth;                // > 0 inside 'time { }': no per-op callbacks
+    std::vector<int> pathBuffer;    // Reused for every operation
+
+    // Lexer / parser
+    bool tokenize(const std::string& source);
+    const Token& peek(size_t ahead = 0) const;
+    bool accept(const std::string& symbol);
+    bool expect(const std::string& symbol);
+    bool atStatementEnd() const;
+    bool fail(const std::string& message);
+
+    std::unique_ptr<Statement> parseStatement();
+    bool parseBlock(std::vector<std::unique_ptr<Statement>>& body);
+    bool parseValueList(std::vector<ValueSource>& values);
+    bool parseValueSource(ValueSource& source);
+    std::unique_ptr<Expr> parseExpression();
+    std::unique_ptr<Expr> parseTerm();
+    std::unique_ptr<Expr> parseUnary();
+
+    // Execution
+    bool execute(const Statement& stmt);
+    bool evaluate(const Expr& expr, long long& result);
+    bool forEachValue(const std::vector<ValueSource>& values,
+                      const std::function<bool(int)>& callback, long long& count);
+    bool applyOperation(const std::string& op, int value, bool verbose);
+    void printHelp();
+
+public:
+    explicit CommandInterpreter(StructureAdapter& adapter);
+
+    void setOutput(OutputFn fn) { output = fn; }
+    void setOperationCallbacks(BeforeOpFn before, AfterOpFn after) { beforeOp = before; afterOp = after; }
+    void setStructureSelector(SelectFn fn) { selectStructure = fn; }
+
+    // Parse and run a program. Returns false on syntax or runtime errors
+    // (the message has already been sent to the output callback).
+    bool run(const std::string& source);
+
+    // Counters of the last run()
+    const BatchStats& getStats() const { return stats; }
+
+    // True if 'source' has unbalanced '{' (more input is needed)
+    static bool needsMoreInput(const std::string& source);
+
+    StructureAdapter& getTarget() { return *target; }
+};
+
+#endif // COMMAND_LANGUAGE_H
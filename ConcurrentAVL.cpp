@@ -0,0 +1,798 @@
+// File: ConcurrentAVL.cpp
+// Description: Optimistic concurrent AVL tree (see ConcurrentAVL.h).
+// The structure follows the paper's algorithm function by function, so
+// the names below match it: attempt* descend optimistically, *Locked
+// functions run with the named nodes locked.
+
+#include "ConcurrentAVL.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <thread>
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+ConcurrentAVL::NodeLock::NodeLock(ConcurrentNode* lockedNode) : node(lockedNode) {
+    if (node == nullptr) return;
+    while (node->locked.exchange(true, std::memory_order_acquire)) {
+        while (node->locked.load(std::memory_order_relaxed)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+ConcurrentAVL::NodeLock::~NodeLock() {
+    if (node) node->locked.store(false, std::memory_order_release);
+}
+
+ConcurrentNode* ConcurrentAVL::child(const ConcurrentNode* node, int dir) {
+    return dir < 0 ? node->left.load() : node->right.load();
+}
+
+void ConcurrentAVL::setChild(ConcurrentNode* node, int dir, ConcurrentNode* newChild) {
+    if (dir < 0) {
+        node->left.store(newChild);
+    } else {
+        node->right.store(newChild);
+    }
+}
+
+int ConcurrentAVL::heightOf(const ConcurrentNode* node) {
+    return node ? node->height.load() : 0;
+}
+
+void ConcurrentAVL::waitUntilNotShrinking(const ConcurrentNode* node) {
+    // A rotation relinks at most three nodes, so a short spin usually does
+    for (int spins = 0; node->version.load() & SHRINKING; spins++) {
+        if (spins >= 64) std::this_thread::yield();
+    }
+}
+
+void ConcurrentAVL::holdLocks() const {
+    int micros = lockHoldMicros.load(std::memory_order_relaxed);
+    if (micros > 0) std::this_thread::sleep_for(std::chrono::microseconds(micros));
+}
+
+ConcurrentAVL::Attempt ConcurrentAVL::retry() const {
+    retryCount.fetch_add(1, std::memory_order_relaxed);
+    return Attempt::RETRY;
+}
+
+void ConcurrentAVL::retire(ConcurrentNode* node) {
+    std::lock_guard<std::mutex> guard(retiredMutex);
+    retired.push_back(node);
+}
+
+// ============================================================================
+// CONSTRUCTOR & DESTRUCTOR
+// ============================================================================
+
+ConcurrentAVL::ConcurrentAVL()
+    : rootHolder(new ConcurrentNode(INT_MIN, -1, nullptr)), nextNodeId(0),
+      lockHoldMicros(0), retryCount(0) {}
+
+ConcurrentAVL::~ConcurrentAVL() {
+    clear();
+    delete rootHolder;
+}
+
+// ============================================================================
+// CONTAINS
+// ============================================================================
+// Hand-over-hand validation: read the child link, then check that 'node'
+// has not shrunk since our caller validated the link to 'node'. Once both
+// links were valid at the same moment, 'node' no longer matters and the
+// descent continues below 'child' with the child's version.
+// ============================================================================
+
+bool ConcurrentAVL::contains(int value) const {
+    while (true) {
+        Attempt result = attemptContains(value, rootHolder, +1, rootHolder->version.load());
+        if (result != Attempt::RETRY) return result == Attempt::YES;
+    }
+}
+
+ConcurrentAVL::Attempt ConcurrentAVL::attemptContains(int value, const ConcurrentNode* node, int dir,
+                                                      uint64_t nodeVersion) const {
+    while (true) {
+        ConcurrentNode* next = child(node, dir);
+        if (next == nullptr) {
+            // Valid only if 'node' still covers 'value'
+            if (node->version.load() != nodeVersion) return retry();
+            return Attempt::NO;
+        }
+        if (value == next->value) {
+            return next->present.load() ? Attempt::YES : Attempt::NO;
+        }
+
+        uint64_t nextVersion = next->version.load();
+        if (nextVersion & (SHRINKING | UNLINKED)) {
+            waitUntilNotShrinking(next);
+            if (node->version.load() != nodeVersion) return retry();
+        } else if (next != child(node, dir)) {
+            // The link changed after we read the child's version
+            if (node->version.load() != nodeVersion) return retry();
+        } else {
+            if (node->version.load() != nodeVersion) return retry();
+            Attempt result = attemptContains(value, next, value < next->value ? -1 : +1, nextVersion);
+            if (result != Attempt::RETRY) return result;
+        }
+    }
+}
+
+// ============================================================================
+// INSERT
+// ============================================================================
+
+bool ConcurrentAVL::insert(int value) {
+    while (true) {
+        Attempt result = attemptInsert(value, rootHolder, +1, rootHolder->version.load());
+        if (result != Attempt::RETRY) return result == Attempt::YES;
+    }
+}
+
+ConcurrentAVL::Attempt ConcurrentAVL::attemptInsert(int value, ConcurrentNode* node, int dir,
+                                                    uint64_t nodeVersion) {
+    while (true) {
+        ConcurrentNode* next = child(node, dir);
+        if (node->version.load() != nodeVersion) return retry();
+
+        if (next == nullptr) {
+            ConcurrentNode* damaged;
+            {
+                NodeLock lock(node);
+                // Holding the lock, no rotation can move 'node' any more
+                if (node->version.load() != nodeVersion) return retry();
+                if (child(node, dir) != nullptr) continue;      // Lost a race; read it again
+
+                setChild(node, dir, new ConcurrentNode(value, nextNodeId.fetch_add(1), node));
+                holdLocks();
+                damaged = fixHeightLocked(node);
+            }
+            fixHeightAndRebalance(damaged);
+            return Attempt::YES;
+        }
+
+        if (value == next->value) {
+            Attempt result = attemptRevive(next);
+            if (result != Attempt::RETRY) return result;
+            continue;
+        }
+
+        uint64_t nextVersion = next->version.load();
+        if (nextVersion & (SHRINKING | UNLINKED)) {
+            waitUntilNotShrinking(next);
+        } else if (next == child(node, dir)) {
+            if (node->version.load() != nodeVersion) return retry();
+            Attempt result = attemptInsert(value, next, value < next->value ? -1 : +1, nextVersion);
+            if (result != Attempt::RETRY) return result;
+        }
+    }
+}
+
+ConcurrentAVL::Attempt ConcurrentAVL::attemptRevive(ConcurrentNode* node) {
+    if (node->present.load()) return Attempt::NO;
+
+    // Turn a routing node back into a member of the set
+    NodeLock lock(node);
+    if (node->version.load() & UNLINKED) return retry();
+    if (node->present.load()) return Attempt::NO;
+    node->present.store(true);
+    holdLocks();
+    return Attempt::YES;
+}
+
+// ============================================================================
+// REMOVE
+// ============================================================================
+
+bool ConcurrentAVL::remove(int value) {
+    while (true) {
+        Attempt result = attemptRemove(value, rootHolder, +1, rootHolder->version.load());
+        if (result != Attempt::RETRY) return result == Attempt::YES;
+    }
+}
+
+ConcurrentAVL::Attempt ConcurrentAVL::attemptRemove(int value, ConcurrentNode* node, int dir,
+                                                    uint64_t nodeVersion) {
+    while (true) {
+        ConcurrentNode* next = child(node, dir);
+        if (node->version.load() != nodeVersion) return retry();
+        if (next == nullptr) return Attempt::NO;
+
+        if (value == next->value) {
+            Attempt result = attemptRemoveNode(node, next);
+            if (result != Attempt::RETRY) return result;
+            continue;
+        }
+
+        uint64_t nextVersion = next->version.load();
+        if (nextVersion & (SHRINKING | UNLINKED)) {
+            waitUntilNotShrinking(next);
+        } else if (next == child(node, dir)) {
+            if (node->version.load() != nodeVersion) return retry();
+            Attempt result = attemptRemove(value, next, value < next->value ? -1 : +1, nextVersion);
+            if (result != Attempt::RETRY) return result;
+        }
+    }
+}
+
+ConcurrentAVL::Attempt ConcurrentAVL::attemptRemoveNode(ConcurrentNode* parent, ConcurrentNode* node) {
+    if (!node->present.load()) return Attempt::NO;
+
+    if (node->left.load() == nullptr || node->right.load() == nullptr) {
+        // At most one child: splice the node out, which needs the parent too
+        ConcurrentNode* damaged;
+        {
+            NodeLock parentLock(parent);
+            if ((parent->version.load() & UNLINKED) || node->parent.load() != parent) return retry();
+
+            NodeLock nodeLock(node);
+            if (!node->present.load()) return Attempt::NO;
+            if (!attemptUnlinkLocked(parent, node)) return retry();
+            holdLocks();
+            damaged = fixHeightLocked(parent);
+        }
+        fixHeightAndRebalance(damaged);
+        return Attempt::YES;
+    }
+
+    // Two children: leave the node in place as a routing node
+    NodeLock lock(node);
+    if (node->version.load() & UNLINKED) return retry();
+    if (!node->present.load()) return Attempt::NO;
+    if (node->left.load() == nullptr || node->right.load() == nullptr) return retry();
+    node->present.store(false);
+    holdLocks();
+    return Attempt::YES;
+}
+
+bool ConcurrentAVL::attemptUnlinkLocked(ConcurrentNode* parent, ConcurrentNode* node, bool childLocked) {
+    ConcurrentNode* parentLeft = parent->left.load();
+    if (parentLeft != node && parent->right.load() != node) return false;
+
+    ConcurrentNode* nodeLeft = node->left.load();
+    ConcurrentNode* nodeRight = node->right.load();
+    if (nodeLeft != nullptr && nodeRight != nullptr) return false;
+
+    ConcurrentNode* splice = nodeLeft ? nodeLeft : nodeRight;
+    setChild(parent, parentLeft == node ? -1 : +1, splice);
+    if (splice) {
+        NodeLock spliceLock(childLocked ? nullptr : splice);
+        splice->parent.store(parent);
+    }
+
+    // Readers standing on 'node' see UNLINKED and step back to the parent
+    node->version.store(UNLINKED);
+    node->present.store(false);
+    retire(node);
+    return true;
+}
+
+// ============================================================================
+// REBALANCING
+// ============================================================================
+// Every thread that changes a node repairs it afterwards, walking upwards
+// to the root or until nothing is left to do. The reads in nodeCondition()
+// are not atomic together, but a node changed in between has another
+// thread responsible for repairing it, so a "nothing required" answer is
+// safe. Two rules keep that true:
+// - a height is only stored under its node's lock, computed from children
+//   that are locked too (rotations) or read again after the store
+//   (fixHeightLocked), so no concurrent change to a child is lost
+// - after a rebalance the walk comes back to the parent it held, since a
+//   rotation can return a damaged node below it and leave the parent's
+//   height stale
+// ============================================================================
+
+int ConcurrentAVL::nodeCondition(const ConcurrentNode* node) const {
+    ConcurrentNode* nodeLeft = node->left.load();
+    ConcurrentNode* nodeRight = node->right.load();
+
+    if ((nodeLeft == nullptr || nodeRight == nullptr) && !node->present.load()) {
+        return UNLINK_REQUIRED;
+    }
+
+    int height = node->height.load();
+    int leftHeight = heightOf(nodeLeft);
+    int rightHeight = heightOf(nodeRight);
+
+    int newHeight = 1 + std::max(leftHeight, rightHeight);
+    int balance = leftHeight - rightHeight;
+    if (balance < -1 || balance > 1) return REBALANCE_REQUIRED;
+
+    return height != newHeight ? newHeight : NOTHING_REQUIRED;
+}
+
+void ConcurrentAVL::fixHeightAndRebalance(ConcurrentNode* node) {
+    // Parents of rebalanced nodes, checked again once the walk above the
+    // damaged node they returned has ended
+    std::vector<ConcurrentNode*> recheck;
+    while (true) {
+        if (node != nullptr && (node->version.load() & UNLINKED)) {
+            // Spliced out meanwhile. Its old parent lost a child and may
+            // need repair, so the walk goes on from there.
+            node = node->parent.load();
+            continue;
+        }
+
+        // The holder has no parent, so a walk stops below it
+        bool done = node == nullptr || node->parent.load() == nullptr;
+        int condition = done ? NOTHING_REQUIRED : nodeCondition(node);
+        if (condition == NOTHING_REQUIRED) {
+            if (recheck.empty()) return;
+            node = recheck.back();
+            recheck.pop_back();
+            continue;
+        }
+
+        if (condition != UNLINK_REQUIRED && condition != REBALANCE_REQUIRED) {
+            NodeLock lock(node);
+            node = fixHeightLocked(node);
+        } else {
+            ConcurrentNode* parent = node->parent.load();
+            NodeLock parentLock(parent);
+            if (!(parent->version.load() & UNLINKED) && node->parent.load() == parent) {
+                NodeLock nodeLock(node);
+                node = rebalanceLocked(parent, node);
+                recheck.push_back(parent);
+            }
+            // Otherwise 'node' moved; look at it again
+        }
+    }
+}
+
+ConcurrentNode* ConcurrentAVL::fixHeightLocked(ConcurrentNode* node) {
+    // The children are not locked, so one may store a new height while we
+    // store ours. Reading them again after the store closes that race. All
+    // of these accesses are sequentially consistent, so either we see the
+    // child's new height here, or the child's thread sees our store when
+    // it checks this node next.
+    bool changed = false;
+    while (true) {
+        int condition = nodeCondition(node);
+        switch (condition) {
+            case REBALANCE_REQUIRED:
+            case UNLINK_REQUIRED:
+                return node;        // Needs the parent's lock as well
+            case NOTHING_REQUIRED:
+                return changed ? node->parent.load() : nullptr;
+            default:
+                node->height.store(condition);
+                changed = true;
+        }
+    }
+}
+
+ConcurrentNode* ConcurrentAVL::rebalanceLocked(ConcurrentNode* parent, ConcurrentNode* node) {
+    ConcurrentNode* nodeLeft = node->left.load();
+    ConcurrentNode* nodeRight = node->right.load();
+
+    if ((nodeLeft == nullptr || nodeRight == nullptr) && !node->present.load()) {
+        // A routing node that lost a child is no longer needed
+        if (attemptUnlinkLocked(parent, node)) return fixHeightLocked(parent);
+        return node;
+    }
+
+    // Heights only change under their node's lock, so with both children
+    // locked the heights read below stay exact until we are done
+    NodeLock leftLock(nodeLeft);
+    NodeLock rightLock(nodeRight);
+    int height = node->height.load();
+    int leftHeight = heightOf(nodeLeft);
+    int rightHeight = heightOf(nodeRight);
+    int newHeight = 1 + std::max(leftHeight, rightHeight);
+    int balance = leftHeight - rightHeight;
+
+    if (balance > 1) return rebalanceToRightLocked(parent, node, nodeLeft);
+    if (balance < -1) return rebalanceToLeftLocked(parent, node, nodeRight);
+    if (newHeight != height) {
+        node->height.store(newHeight);
+        return fixHeightLocked(parent);
+    }
+    return nullptr;
+}
+
+ConcurrentNode* ConcurrentAVL::rebalanceToRightLocked(ConcurrentNode* parent, ConcurrentNode* node,
+                                                      ConcurrentNode* nodeLeft) {
+    // The left side is too tall, so rotate right; first rotate the left
+    // child left if its inner subtree is the taller one. Every node whose
+    // height a rotation reads or moves is locked first, one level at a time.
+    ConcurrentNode* leftLeft = nodeLeft->left.load();
+    ConcurrentNode* leftRight = nodeLeft->right.load();
+    NodeLock leftLeftLock(leftLeft);
+    NodeLock leftRightLock(leftRight);
+    int leftLeftHeight = heightOf(leftLeft);
+    if (leftLeftHeight >= heightOf(leftRight)) {
+        return rotateRightLocked(parent, node, nodeLeft, leftRight);
+    }
+
+    // The double rotation moves both children of 'leftRight' as well.
+    // Only do it if it leaves the left child balanced; otherwise rotate the
+    // left child on its own first, and 'node' is rebalanced after that.
+    ConcurrentNode* leftRightLeft = leftRight->left.load();
+    NodeLock innerLeftLock(leftRightLeft);
+    NodeLock innerRightLock(leftRight->right.load());
+    int innerBalance = leftLeftHeight - heightOf(leftRightLeft);
+    if (innerBalance >= -1 && innerBalance <= 1) {
+        return rotateRightOverLeftLocked(parent, node, nodeLeft, leftRight);
+    }
+    return rotateLeftLocked(node, nodeLeft, leftRight, leftRightLeft);
+}
+
+ConcurrentNode* ConcurrentAVL::rebalanceToLeftLocked(ConcurrentNode* parent, ConcurrentNode* node,
+                                                     ConcurrentNode* nodeRight) {
+    // Mirror of rebalanceToRightLocked
+    ConcurrentNode* rightLeft = nodeRight->left.load();
+    ConcurrentNode* rightRight = nodeRight->right.load();
+    NodeLock rightLeftLock(rightLeft);
+    NodeLock rightRightLock(rightRight);
+    int rightRightHeight = heightOf(rightRight);
+    if (rightRightHeight >= heightOf(rightLeft)) {
+        return rotateLeftLocked(parent, node, nodeRight, rightLeft);
+    }
+
+    ConcurrentNode* rightLeftRight = rightLeft->right.load();
+    NodeLock innerLeftLock(rightLeft->left.load());
+    NodeLock innerRightLock(rightLeftRight);
+    int innerBalance = rightRightHeight - heightOf(rightLeftRight);
+    if (innerBalance >= -1 && innerBalance <= 1) {
+        return rotateLeftOverRightLocked(parent, node, nodeRight, rightLeft);
+    }
+    return rotateRightLocked(node, nodeRight, rightLeft, rightLeftRight);
+}
+
+// Right rotation of 'node' under 'parent'. 'node' moves down, so it is
+// marked shrinking while the links change. The caller holds the locks of
+// all of these nodes (except nulls):
+//        node              nodeLeft
+//       /    \             /      \       LL: up one level
+//   nodeLeft  R    -->   LL       node
+//    /    \                      /    \    R: down one level
+//   LL  leftRight           leftRight  R
+ConcurrentNode* ConcurrentAVL::rotateRightLocked(ConcurrentNode* parent, ConcurrentNode* node,
+                                                 ConcurrentNode* nodeLeft, ConcurrentNode* leftRight) {
+    holdLocks();
+    uint64_t nodeVersion = node->version.load();
+    ConcurrentNode* parentLeft = parent->left.load();
+    int rightHeight = heightOf(node->right.load());
+    int leftLeftHeight = heightOf(nodeLeft->left.load());
+    int leftRightHeight = heightOf(leftRight);
+
+    node->version.store(nodeVersion | SHRINKING);
+
+    node->left.store(leftRight);
+    if (leftRight) leftRight->parent.store(node);
+    nodeLeft->right.store(node);
+    node->parent.store(nodeLeft);
+    setChild(parent, parentLeft == node ? -1 : +1, nodeLeft);
+    nodeLeft->parent.store(parent);
+
+    int newNodeHeight = 1 + std::max(leftRightHeight, rightHeight);
+    node->height.store(newNodeHeight);
+    nodeLeft->height.store(1 + std::max(leftLeftHeight, newNodeHeight));
+
+    node->version.store(nodeVersion + SHRINK_COUNT_INCREMENT);
+
+    // 'node' is the deepest damaged node: it may still be out of balance,
+    // or be a routing node that lost a child
+    int nodeBalance = leftRightHeight - rightHeight;
+    if (nodeBalance < -1 || nodeBalance > 1) return node;
+    if ((leftRight == nullptr || rightHeight == 0) && !node->present.load()) return node;
+
+    int leftBalance = leftLeftHeight - newNodeHeight;
+    if (leftBalance < -1 || leftBalance > 1) return nodeLeft;
+    if (leftLeftHeight == 0 && !nodeLeft->present.load()) return nodeLeft;
+
+    return fixHeightLocked(parent);
+}
+
+ConcurrentNode* ConcurrentAVL::rotateLeftLocked(ConcurrentNode* parent, ConcurrentNode* node,
+                                                ConcurrentNode* nodeRight, ConcurrentNode* rightLeft) {
+    holdLocks();
+    uint64_t nodeVersion = node->version.load();
+    ConcurrentNode* parentLeft = parent->left.load();
+    int leftHeight = heightOf(node->left.load());
+    int rightLeftHeight = heightOf(rightLeft);
+    int rightRightHeight = heightOf(nodeRight->right.load());
+
+    node->version.store(nodeVersion | SHRINKING);
+
+    node->right.store(rightLeft);
+    if (rightLeft) rightLeft->parent.store(node);
+    nodeRight->left.store(node);
+    node->parent.store(nodeRight);
+    setChild(parent, parentLeft == node ? -1 : +1, nodeRight);
+    nodeRight->parent.store(parent);
+
+    int newNodeHeight = 1 + std::max(leftHeight, rightLeftHeight);
+    node->height.store(newNodeHeight);
+    nodeRight->height.store(1 + std::max(newNodeHeight, rightRightHeight));
+
+    node->version.store(nodeVersion + SHRINK_COUNT_INCREMENT);
+
+    int nodeBalance = rightLeftHeight - leftHeight;
+    if (nodeBalance < -1 || nodeBalance > 1) return node;
+    if ((rightLeft == nullptr || leftHeight == 0) && !node->present.load()) return node;
+
+    int rightBalance = rightRightHeight - newNodeHeight;
+    if (rightBalance < -1 || rightBalance > 1) return nodeRight;
+    if (rightRightHeight == 0 && !nodeRight->present.load()) return nodeRight;
+
+    return fixHeightLocked(parent);
+}
+
+// Left-right double rotation in one step: 'leftRight' becomes the subtree
+// root, and both 'node' and 'nodeLeft' move down. The caller also holds
+// the locks of both children of 'leftRight'.
+ConcurrentNode* ConcurrentAVL::rotateRightOverLeftLocked(ConcurrentNode* parent, ConcurrentNode* node,
+                                                         ConcurrentNode* nodeLeft, ConcurrentNode* leftRight) {
+    holdLocks();
+    uint64_t nodeVersion = node->version.load();
+    uint64_t leftVersion = nodeLeft->version.load();
+
+    ConcurrentNode* parentLeft = parent->left.load();
+    ConcurrentNode* leftRightLeft = leftRight->left.load();
+    ConcurrentNode* leftRightRight = leftRight->right.load();
+    int rightHeight = heightOf(node->right.load());
+    int leftLeftHeight = heightOf(nodeLeft->left.load());
+    int leftRightLeftHeight = heightOf(leftRightLeft);
+    int leftRightRightHeight = heightOf(leftRightRight);
+
+    node->version.store(nodeVersion | SHRINKING);
+    nodeLeft->version.store(leftVersion | SHRINKING);
+
+    node->left.store(leftRightRight);
+    if (leftRightRight) leftRightRight->parent.store(node);
+    nodeLeft->right.store(leftRightLeft);
+    if (leftRightLeft) leftRightLeft->parent.store(nodeLeft);
+
+    leftRight->left.store(nodeLeft);
+    nodeLeft->parent.store(leftRight);
+    leftRight->right.store(node);
+    node->parent.store(leftRight);
+
+    setChild(parent, parentLeft == node ? -1 : +1, leftRight);
+    leftRight->parent.store(parent);
+
+    int newNodeHeight = 1 + std::max(leftRightRightHeight, rightHeight);
+    node->height.store(newNodeHeight);
+    int newLeftHeight = 1 + std::max(leftLeftHeight, leftRightLeftHeight);
+    nodeLeft->height.store(newLeftHeight);
+    leftRight->height.store(1 + std::max(newLeftHeight, newNodeHeight));
+
+    node->version.store(nodeVersion + SHRINK_COUNT_INCREMENT);
+    nodeLeft->version.store(leftVersion + SHRINK_COUNT_INCREMENT);
+
+    // The caller checked that 'nodeLeft' ends up balanced, but a routing
+    // 'nodeLeft' may have lost a child. Nobody else is responsible for it,
+    // so splice it out now, while we hold the locks. Its remaining child
+    // (its old left child, or 'leftRightLeft') is locked already.
+    if ((leftLeftHeight == 0 || leftRightLeft == nullptr) && !nodeLeft->present.load()) {
+        attemptUnlinkLocked(leftRight, nodeLeft, true);
+        newLeftHeight = heightOf(leftRight->left.load());
+        leftRight->height.store(1 + std::max(newLeftHeight, newNodeHeight));
+    }
+
+    int nodeBalance = leftRightRightHeight - rightHeight;
+    if (nodeBalance < -1 || nodeBalance > 1) return node;
+    if ((leftRightRight == nullptr || rightHeight == 0) && !node->present.load()) return node;
+
+    int topBalance = newLeftHeight - newNodeHeight;
+    if (topBalance < -1 || topBalance > 1) return leftRight;
+
+    return fixHeightLocked(parent);
+}
+
+ConcurrentNode* ConcurrentAVL::rotateLeftOverRightLocked(ConcurrentNode* parent, ConcurrentNode* node,
+                                                         ConcurrentNode* nodeRight, ConcurrentNode* rightLeft) {
+    holdLocks();
+    uint64_t nodeVersion = node->version.load();
+    uint64_t rightVersion = nodeRight->version.load();
+
+    ConcurrentNode* parentLeft = parent->left.load();
+    ConcurrentNode* rightLeftLeft = rightLeft->left.load();
+    ConcurrentNode* rightLeftRight = rightLeft->right.load();
+    int leftHeight = heightOf(node->left.load());
+    int rightRightHeight = heightOf(nodeRight->right.load());
+    int rightLeftLeftHeight = heightOf(rightLeftLeft);
+    int rightLeftRightHeight = heightOf(rightLeftRight);
+
+    node->version.store(nodeVersion | SHRINKING);
+    nodeRight->version.store(rightVersion | SHRINKING);
+
+    node->right.store(rightLeftLeft);
+    if (rightLeftLeft) rightLeftLeft->parent.store(node);
+    nodeRight->left.store(rightLeftRight);
+    if (rightLeftRight) rightLeftRight->parent.store(nodeRight);
+
+    rightLeft->right.store(nodeRight);
+    nodeRight->parent.store(rightLeft);
+    rightLeft->left.store(node);
+    node->parent.store(rightLeft);
+
+    setChild(parent, parentLeft == node ? -1 : +1, rightLeft);
+    rightLeft->parent.store(parent);
+
+    int newNodeHeight = 1 + std::max(leftHeight, rightLeftLeftHeight);
+    node->height.store(newNodeHeight);
+    int newRightHeight = 1 + std::max(rightLeftRightHeight, rightRightHeight);
+    nodeRight->height.store(newRightHeight);
+    rightLeft->height.store(1 + std::max(newNodeHeight, newRightHeight));
+
+    node->version.store(nodeVersion + SHRINK_COUNT_INCREMENT);
+    nodeRight->version.store(rightVersion + SHRINK_COUNT_INCREMENT);
+
+    if ((rightRightHeight == 0 || rightLeftRight == nullptr) && !nodeRight->present.load()) {
+        attemptUnlinkLocked(rightLeft, nodeRight, true);
+        newRightHeight = heightOf(rightLeft->right.load());
+        rightLeft->height.store(1 + std::max(newNodeHeight, newRightHeight));
+    }
+
+    int nodeBalance = rightLeftLeftHeight - leftHeight;
+    if (nodeBalance < -1 || nodeBalance > 1) return node;
+    if ((rightLeftLeft == nullptr || leftHeight == 0) && !node->present.load()) return node;
+
+    int topBalance = newRightHeight - newNodeHeight;
+    if (topBalance < -1 || topBalance > 1) return rightLeft;
+
+    return fixHeightLocked(parent);
+}
+
+// ============================================================================
+// QUIESCENT OPERATIONS
+// ============================================================================
+
+void ConcurrentAVL::clear() {
+    std::vector<ConcurrentNode*> stack;
+    if (ConcurrentNode* root = rootHolder->right.load()) stack.push_back(root);
+    while (!stack.empty()) {
+        ConcurrentNode* node = stack.back();
+        stack.pop_back();
+        if (ConcurrentNode* left = node->left.load()) stack.push_back(left);
+        if (ConcurrentNode* right = node->right.load()) stack.push_back(right);
+        delete node;
+    }
+    rootHolder->right.store(nullptr);
+    rootHolder->height.store(1);
+    reclaim();
+}
+
+void ConcurrentAVL::reclaim() {
+    std::lock_guard<std::mutex> guard(retiredMutex);
+    for (ConcurrentNode* node : retired) {
+        delete node;
+    }
+    retired.clear();
+    retired.shrink_to_fit();
+}
+
+size_t ConcurrentAVL::retiredCount() {
+    std::lock_guard<std::mutex> guard(retiredMutex);
+    return retired.size();
+}
+
+size_t ConcurrentAVL::size() const {
+    size_t count = 0;
+    std::vector<const ConcurrentNode*> stack;
+    if (const ConcurrentNode* root = rootHolder->right.load()) stack.push_back(root);
+    while (!stack.empty()) {
+        const ConcurrentNode* node = stack.back();
+        stack.pop_back();
+        if (node->present.load()) count++;
+        if (const ConcurrentNode* left = node->left.load()) stack.push_back(left);
+        if (const ConcurrentNode* right = node->right.load()) stack.push_back(right);
+    }
+    return count;
+}
+
+int ConcurrentAVL::getHeight() const {
+    return heightOf(rootHolder->right.load());
+}
+
+ConcurrentNode* ConcurrentAVL::getRoot() const {
+    return rootHolder->right.load();
+}
+
+void ConcurrentAVL::snapshot(std::vector<NodeState>& nodes, size_t limit) const {
+    nodes.clear();
+
+    // (node, index of the parent's state, -1 left / +1 right)
+    struct Pending {
+        const ConcurrentNode* node;
+        int parent;
+        int dir;
+    };
+    std::vector<Pending> stack;
+    if (const ConcurrentNode* root = rootHolder->right.load()) stack.push_back({root, -1, 0});
+
+    // A racing rotation can make the walk revisit nodes, so 'limit' is
+    // what guarantees it ends
+    while (!stack.empty() && nodes.size() < limit) {
+        Pending item = stack.back();
+        stack.pop_back();
+        const ConcurrentNode* node = item.node;
+
+        int index = static_cast<int>(nodes.size());
+        nodes.push_back({node->id, node->value, node->height.load(), node->present.load(),
+                         node->locked.load(), (node->version.load() & SHRINKING) != 0, -1, -1});
+        if (item.parent >= 0) {
+            if (item.dir < 0) {
+                nodes[item.parent].left = index;
+            } else {
+                nodes[item.parent].right = index;
+            }
+        }
+
+        if (const ConcurrentNode* right = node->right.load()) stack.push_back({right, index, +1});
+        if (const ConcurrentNode* left = node->left.load()) stack.push_back({left, index, -1});
+    }
+}
+
+bool ConcurrentAVL::validate(std::string& error) const {
+    // (node, exclusive key bounds); bounds are long long so INT_MIN/INT_MAX
+    // keys still fit strictly inside them
+    struct Pending {
+        const ConcurrentNode* node;
+        long long low;
+        long long high;
+    };
+    std::vector<Pending> stack;
+    const ConcurrentNode* root = rootHolder->right.load();
+    if (root) {
+        if (root->parent.load() != rootHolder) {
+            error = "root " + std::to_string(root->value) + " has a wrong parent link";
+            return false;
+        }
+        stack.push_back({root, (long long)INT_MIN - 1, (long long)INT_MAX + 1});
+    }
+
+    while (!stack.empty()) {
+        Pending item = stack.back();
+        stack.pop_back();
+        const ConcurrentNode* node = item.node;
+        std::string name = "node " + std::to_string(node->value);
+
+        if (node->value <= item.low || node->value >= item.high) {
+            error = name + " is out of key order";
+            return false;
+        }
+        if (node->locked.load()) {
+            error = name + " is still locked";
+            return false;
+        }
+        if (node->version.load() & (SHRINKING | UNLINKED)) {
+            error = name + " is marked shrinking or unlinked";
+            return false;
+        }
+
+        const ConcurrentNode* left = node->left.load();
+        const ConcurrentNode* right = node->right.load();
+        if ((left && left->parent.load() != node) || (right && right->parent.load() != node)) {
+            error = name + " has a child with a wrong parent link";
+            return false;
+        }
+        if (!node->present.load() && (!left || !right)) {
+            error = name + " is a routing node with fewer than two children";
+            return false;
+        }
+
+        int leftHeight = heightOf(left);
+        int rightHeight = heightOf(right);
+        if (node->height.load() != 1 + std::max(leftHeight, rightHeight)) {
+            error = name + " has height " + std::to_string(node->height.load()) +
+                    ", expected " + std::to_string(1 + std::max(leftHeight, rightHeight));
+            return false;
+        }
+        if (leftHeight - rightHeight < -1 || leftHeight - rightHeight > 1) {
+            error = name + " is out of balance (" + std::to_string(leftHeight - rightHeight) + ")";
+            return false;
+        }
+
+        if (left) stack.push_back({left, item.low, node->value});
+        if (right) stack.push_back({right, node->value, item.high});
+    }
+    return true;
+}
@@ -0,0 +1,196 @@
+// File: ConcurrentAVL.h
+// Description: Thread-safe ordered set of ints, a relaxed-balance AVL tree
+// with optimistic concurrency (Bronson, Casper, Chafi, Olukotun: "A
+// Practical Concurrent Binary Search Tree", PPoPP 2010).
+//
+// - contains() takes no locks. It descends hand over hand, and reads every
+//   node's version number before and after following one of its links. A
+//   rotation moves a node down, so the keys the node covers shrink. It marks
+//   the node "shrinking" while it relinks, and bumps the version afterwards.
+//   A reader that sees a changed version steps back to the parent and
+//   retries from there, not from the root.
+// - insert() / remove() descend the same way and then lock only the nodes
+//   they change: the parent of a new leaf, a node and its parent for an
+//   unlink. A rotation locks the rotated nodes and every node whose height
+//   it reads, up to eight. Locks are taken top-down.
+// - remove() of a node with two children only clears its 'present' flag and
+//   leaves it as a routing node ("partially external" tree). Rebalancing
+//   splices routing nodes out once they have fewer than two children, and
+//   insert() of the same key revives one.
+// - Heights are repaired after each update, walking up from the changed
+//   node to the root, and rotations run where a node is out of balance.
+//   The walk also goes back to the parent of every node it rebalanced or
+//   found unlinked, so no damaged ancestor is left behind. For a moment a
+//   node may be off by more than one. Once no update is running the tree is
+//   a strict AVL tree again.
+//
+// Unlinked nodes may still be in use by a concurrent reader, so they are
+// retired rather than deleted, and freed by reclaim(), clear() or the
+// destructor. Those three and validate() must not run concurrently with
+// other calls.
+//
+// For the visualizer, setLockHoldMicros() makes writers sleep while holding
+// their locks, so the locked nodes stay on screen long enough to see.
+// snapshot() copies the current shape while the writers keep running.
+
+#ifndef CONCURRENT_AVL_H
+#define CONCURRENT_AVL_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "MemoryAccount.h"
+
+// ============================================================================
+// CONCURRENT NODE
+// ============================================================================
+struct ConcurrentNode : TrackedAllocation<MemoryAccount::STRUCTURE_NODES> {
+    const int value;
+    const int id;
+    std::atomic<int> height;
+    std::atomic<bool> present;          // False = routing node (key not in the set)
+    std::atomic<bool> locked;           // Spin lock
+    std::atomic<uint64_t> version;      // Shrink count, SHRINKING / UNLINKED bits
+    std::atomic<ConcurrentNode*> parent;
+    std::atomic<ConcurrentNode*> left;
+    std::atomic<ConcurrentNode*> right;
+
+    ConcurrentNode(int val, int nodeId, ConcurrentNode* parentNode)
+        : value(val), id(nodeId), height(1), present(true), locked(false), version(0),
+          parent(parentNode), left(nullptr), right(nullptr) {}
+};
+
+// ============================================================================
+// CONCURRENT AVL CLASS
+// ============================================================================
+class ConcurrentAVL {
+public:
+    // Version bits (see the header comment)
+    static const uint64_t UNLINKED = 1;
+    static const uint64_t SHRINKING = 2;
+    static const uint64_t SHRINK_COUNT_INCREMENT = 4;
+
+    // One node as seen by snapshot(); children are indices (-1 = none)
+    struct NodeState {
+        int id;
+        int value;
+        int height;
+        bool present;
+        bool locked;
+        bool shrinking;
+        int left;
+        int right;
+    };
+
+private:
+    enum class Attempt { NO, YES, RETRY };
+
+    // Special results of nodeCondition(); any other value is a new height
+    static const int UNLINK_REQUIRED = -1;
+    static const int REBALANCE_REQUIRED = -2;
+    static const int NOTHING_REQUIRED = -3;
+
+    // The real root is rootHolder->right. The holder's version never
+    // changes, so every descent can start from it.
+    ConcurrentNode* rootHolder;
+    std::atomic<int> nextNodeId;
+    std::atomic<int> lockHoldMicros;
+    mutable std::atomic<unsigned long long> retryCount;
+
+    std::mutex retiredMutex;
+    std::vector<ConcurrentNode*> retired;   // Unlinked, freed by reclaim()
+
+    // RAII spin lock on one node (nothing for nullptr)
+    class NodeLock {
+        ConcurrentNode* node;
+    public:
+        explicit NodeLock(ConcurrentNode* lockedNode);
+        ~NodeLock();
+        NodeLock(const NodeLock&) = delete;
+        NodeLock& operator=(const NodeLock&) = delete;
+    };
+
+    static ConcurrentNode* child(const ConcurrentNode* node, int dir);
+    static void setChild(ConcurrentNode* node, int dir, ConcurrentNode* newChild);
+    static int heightOf(const ConcurrentNode* node);
+    static void waitUntilNotShrinking(const ConcurrentNode* node);
+    void holdLocks() const;
+
+    // Optimistic descents below 'node' in direction 'dir' (-1 left, +1
+    // right), valid while node->version == nodeVersion
+    Attempt attemptContains(int value, const ConcurrentNode* node, int dir, uint64_t nodeVersion) const;
+    Attempt attemptInsert(int value, ConcurrentNode* node, int dir, uint64_t nodeVersion);
+    Attempt attemptRemove(int value, ConcurrentNode* node, int dir, uint64_t nodeVersion);
+    Attempt attemptRevive(ConcurrentNode* node);
+    Attempt attemptRemoveNode(ConcurrentNode* parent, ConcurrentNode* node);
+    Attempt retry() const;
+
+    // Rebalancing. '...Locked' functions expect the named nodes locked and
+    // return the next damaged node to repair (nullptr when done). A node's
+    // 'parent' and 'height' only change under its own lock, so rebalancing
+    // also locks every node whose height a rotation reads: the children of
+    // the rotated nodes and the subtrees that move to a new parent.
+    int nodeCondition(const ConcurrentNode* node) const;
+    void fixHeightAndRebalance(ConcurrentNode* node);
+    ConcurrentNode* fixHeightLocked(ConcurrentNode* node);
+    ConcurrentNode* rebalanceLocked(ConcurrentNode* parent, ConcurrentNode* node);
+    ConcurrentNode* rebalanceToRightLocked(ConcurrentNode* parent, ConcurrentNode* node,
+                                           ConcurrentNode* nodeLeft);
+    ConcurrentNode* rebalanceToLeftLocked(ConcurrentNode* parent, ConcurrentNode* node,
+                                          ConcurrentNode* nodeRight);
+    ConcurrentNode* rotateRightLocked(ConcurrentNode* parent, ConcurrentNode* node,
+                                      ConcurrentNode* nodeLeft, ConcurrentNode* leftRight);
+    ConcurrentNode* rotateLeftLocked(ConcurrentNode* parent, ConcurrentNode* node,
+                                     ConcurrentNode* nodeRight, ConcurrentNode* rightLeft);
+    ConcurrentNode* rotateRightOverLeftLocked(ConcurrentNode* parent, ConcurrentNode* node,
+                                              ConcurrentNode* nodeLeft, ConcurrentNode* leftRight);
+    ConcurrentNode* rotateLeftOverRightLocked(ConcurrentNode* parent, ConcurrentNode* node,
+                                              ConcurrentNode* nodeRight, ConcurrentNode* rightLeft);
+    bool attemptUnlinkLocked(ConcurrentNode* parent, ConcurrentNode* node, bool childLocked = false);
+    void retire(ConcurrentNode* node);
+
+public:
+    ConcurrentAVL();
+    ~ConcurrentAVL();
+
+    ConcurrentAVL(const ConcurrentAVL&) = delete;
+    ConcurrentAVL& operator=(const ConcurrentAVL&) = delete;
+
+    // Thread-safe set operations (false = already present / not found)
+    bool insert(int value);
+    bool remove(int value);
+    bool contains(int value) const;
+
+    // Not thread-safe: frees every node, including retired ones
+    void clear();
+
+    // Not thread-safe: frees the retired nodes. Call it while no other
+    // operation runs, e.g. after joining the worker threads.
+    void reclaim();
+    size_t retiredCount();
+
+    // Walk the tree; exact only while no update runs
+    size_t size() const;
+    int getHeight() const;
+    ConcurrentNode* getRoot() const;
+
+    // Descents that had to step back because a rotation moved a node
+    unsigned long long retries() const { return retryCount.load(std::memory_order_relaxed); }
+
+    // Visualizer slow motion: writers sleep this long while holding locks
+    void setLockHoldMicros(int micros) { lockHoldMicros.store(micros, std::memory_order_relaxed); }
+
+    // Pre-order copy of at most 'limit' nodes, taken while writers run. Not
+    // a consistent cut: a node moved by a rotation may show up twice or not
+    // at all.
+    void snapshot(std::vector<NodeState>& nodes, size_t limit) const;
+
+    // Check a quiescent tree: key order, parent links, heights, AVL balance,
+    // no routing node with fewer than two children, no lock held. Returns
+    // false with a description of the first problem.
+    bool validate(std::string& error) const;
+};
+
+#endif // CONCURRENT_AVL_H
@@ -0,0 +1,430 @@
+// File: ControlServer.cpp
+// Description: Socket ingest thread and simulation-side command application
+// for the control server. See ControlServer.h for the wire protocol.
+
+#include "ControlServer.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define CONTROL_SERVER_SUPPORTED 1
+#endif
+
+#if defined(CONTROL_SERVER_SUPPORTED) && !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0
+#endif
+
+// ============================================================================
+// CONSTRUCTOR & DESTRUCTOR
+// ============================================================================
+
+ControlServer::ControlServer(const std::string& socketPath)
+    : path(socketPath), listenFd(-1), running(false), shutdownFlag(false),
+      drainIndex(0), drainProgress(0)
+{
+    wakePipe[0] = wakePipe[1] = -1;
+}
+
+ControlServer::~ControlServer() {
+    stop();
+}
+
+// ============================================================================
+// START / STOP
+// ============================================================================
+
+bool ControlServer::start(std::string& error) {
+#ifdef CONTROL_SERVER_SUPPORTED
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        error = "invalid socket path '" + path + "'";
+        return false;
+    }
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    // A stale socket from a previous run blocks bind(); never remove anything else
+    struct stat info;
+    if (lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+        unlink(path.c_str());
+    }
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0 ||
+        bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listenFd, 16) < 0 ||
+        pipe(wakePipe) < 0) {
+        error = std::string("cannot listen on '") + path + "': " + std::strerror(errno);
+        if (listenFd >= 0) close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL) | O_NONBLOCK);
+    fcntl(wakePipe[0], F_SETFL, fcntl(wakePipe[0], F_GETFL) | O_NONBLOCK);
+    fcntl(wakePipe[1], F_SETFL, fcntl(wakePipe[1], F_GETFL) | O_NONBLOCK);
+
+    running = true;
+    ingestThread = std::thread(&ControlServer::ingestLoop, this);
+    return true;
+#else
+    error = "control sockets need a POSIX system";
+    return false;
+#endif
+}
+
+void ControlServer::stop() {
+#ifdef CONTROL_SERVER_SUPPORTED
+    if (!running) return;
+
+    running = false;
+    wake();
+    dataReady.notify_all();
+    if (ingestThread.joinable()) {
+        ingestThread.join();
+    }
+
+    close(listenFd);
+    close(wakePipe[0]);
+    close(wakePipe[1]);
+    listenFd = wakePipe[0] = wakePipe[1] = -1;
+    unlink(path.c_str());
+#endif
+}
+
+void ControlServer::wake() {
+#ifdef CONTROL_SERVER_SUPPORTED
+    char byte = 1;
+    // A full pipe already guarantees a wake-up, so the result doesn't matter
+    ssize_t ignored = write(wakePipe[1], &byte, 1);
+    (void)ignored;
+#endif
+}
+
+// ============================================================================
+// INGEST THREAD
+// ============================================================================
+
+void ControlServer::ingestLoop() {
+#ifdef CONTROL_SERVER_SUPPORTED
+    std::vector<Connection> connections;
+    std::vector<pollfd> fds;
+    int nextId = 1;
+
+    while (running) {
+        bool backpressure;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            backpressure = incoming.values.size() > MAX_QUEUED_VALUES;
+        }
+
+        // [0] wake pipe, [1] listening socket, [2..] connections
+        fds.clear();
+        fds.push_back({wakePipe[0], POLLIN, 0});
+        fds.push_back({listenFd, POLLIN, 0});
+        for (const Connection& conn : connections) {
+            short events = backpressure ? 0 : POLLIN;
+            if (!conn.outbox.empty()) events |= POLLOUT;
+            fds.push_back({conn.fd, events, 0});
+        }
+
+        // While throttled, poll again soon to see whether the queue drained
+        if (poll(fds.data(), fds.size(), backpressure ? 2 : 100) < 0 && errno != EINTR) {
+            break;
+        }
+        if (!running) break;
+
+        if (fds[0].revents & POLLIN) {
+            char drain[64];
+            while (read(wakePipe[0], drain, sizeof(drain)) > 0) {}
+        }
+
+        if (fds[1].revents & POLLIN) {
+            int fd;
+            while ((fd = accept(listenFd, nullptr, nullptr)) >= 0) {
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                int bufferSize = 1 << 20;
+                setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+                Connection conn;
+                conn.fd = fd;
+                conn.id = nextId++;
+                connections.push_back(conn);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                acks[conn.id] = AckState{0, 0, 0, false};
+            }
+        }
+
+        // Read from every readable connection; drop closed or misbehaving ones
+        for (size_t i = 0; i < connections.size(); ) {
+            short revents = fds.size() > i + 2 ? fds[i + 2].revents : 0;
+            bool alive = true;
+            if (revents & (POLLIN | POLLHUP | POLLERR)) {
+                alive = readConnection(connections[i]);
+            }
+            if (!alive) {
+                close(connections[i].fd);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    acks.erase(connections[i].id);
+                }
+                connections.erase(connections.begin() + i);
+                fds.erase(fds.begin() + i + 2);
+            } else {
+                i++;
+            }
+        }
+
+        flushAcks(connections);
+    }
+
+    for (Connection& conn : connections) {
+        close(conn.fd);
+    }
+#endif
+}
+
+bool ControlServer::readConnection(Connection& conn) {
+#ifdef CONTROL_SERVER_SUPPORTED
+    // Read a bounded amount per wake-up so one busy client can't starve the others
+    const size_t CHUNK = 256 * 1024;
+    for (int round = 0; round < 8; round++) {
+        size_t used = conn.buffer.size();
+        conn.buffer.resize(used + CHUNK);
+        ssize_t got = recv(conn.fd, conn.buffer.data() + used, CHUNK, 0);
+        conn.buffer.resize(used + (got > 0 ? static_cast<size_t>(got) : 0));
+
+        if (got == 0) return false;     // Peer closed
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        if (!parseFrames(conn)) return false;
+        if (static_cast<size_t>(got) < CHUNK) break;
+    }
+    return true;
+#else
+    (void)conn;
+    return false;
+#endif
+}
+
+bool ControlServer::parseFrames(Connection& conn) {
+    const char* data = conn.buffer.data();
+    size_t available = conn.buffer.size();
+    size_t pos = 0;
+    bool added = false;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (available - pos >= HEADER_SIZE) {
+        uint8_t op = static_cast<uint8_t>(data[pos]);
+        uint8_t structure = static_cast<uint8_t>(data[pos + 1]);
+        uint32_t count;
+        std::memcpy(&count, data + pos + 4, sizeof(count));
+
+        if (op < OP_INSERT || op > OP_SHUTDOWN || count > MAX_FRAME_VALUES ||
+            structure > static_cast<uint8_t>(StructureKind::SCAPEGOAT) + 1) {
+            lock.unlock();
+            std::cerr << "Control: protocol error from client " << conn.id
+                      << " (op " << static_cast<int>(op) << ", count " << count
+                      << "), closing connection" << std::endl;
+            return false;
+        }
+
+        bool hasValues = op == OP_INSERT || op == OP_DELETE || op == OP_SEARCH;
+        size_t frameSize = HEADER_SIZE + (hasValues ? count * sizeof(int32_t) : 0);
+        if (available - pos < frameSize) break;
+
+        Command cmd = {op, structure, conn.id, count, incoming.values.size()};
+        if (hasValues) {
+            incoming.values.resize(cmd.offset + count);
+            std::memcpy(incoming.values.data() + cmd.offset, data + pos + HEADER_SIZE,
+                        count * sizeof(int32_t));
+        }
+        incoming.commands.push_back(cmd);
+        added = true;
+        pos += frameSize;
+    }
+    lock.unlock();
+
+    // Keep only the incomplete tail
+    conn.buffer.erase(conn.buffer.begin(), conn.buffer.begin() + pos);
+
+    if (added) {
+        dataReady.notify_one();
+    }
+    return true;
+}
+
+void ControlServer::flushAcks(std::vector<Connection>& connections) {
+#ifdef CONTROL_SERVER_SUPPORTED
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Connection& conn : connections) {
+            auto it = acks.find(conn.id);
+            if (it == acks.end() || !it->second.dirty) continue;
+
+            uint32_t ack[4] = {it->second.framesApplied, it->second.succeeded, it->second.failed, 0};
+            conn.outbox.append(reinterpret_cast<const char*>(ack), ACK_SIZE);
+            it->second.dirty = false;
+        }
+    }
+
+    for (Connection& conn : connections) {
+        if (conn.outbox.empty()) continue;
+        ssize_t sent = send(conn.fd, conn.outbox.data(), conn.outbox.size(), MSG_NOSIGNAL);
+        if (sent > 0) {
+            conn.outbox.erase(0, static_cast<size_t>(sent));
+        }
+        // On EAGAIN the rest goes out when poll() reports POLLOUT; a dead peer
+        // is noticed by the next read
+    }
+#else
+    (void)connections;
+#endif
+}
+
+// ============================================================================
+// SIMULATION SIDE
+// ============================================================================
+
+bool ControlServer::waitForCommands(int timeoutMs) {
+    if (drainIndex < draining.commands.size()) return true;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    dataReady.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                       [this] { return !incoming.empty() || !running; });
+    return !incoming.empty();
+}
+
+size_t ControlServer::applyPending(StructureAdapter*& active, const SelectFn& select, double budgetMs) {
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::microseconds(static_cast<long long>(budgetMs * 1000.0));
+    std::unordered_map<int, AckState> progress;
+    size_t applied = 0;
+
+    while (true) {
+        if (drainIndex >= draining.commands.size()) {
+            // Current batch done: swap in whatever the ingest thread collected
+            draining.clear();
+            drainIndex = 0;
+            drainProgress = 0;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (incoming.empty()) break;
+            std::swap(incoming, draining);
+        }
+
+        if (!applyCommand(draining.commands[drainIndex], active, select, progress, deadline, applied)) {
+            break;      // Out of time in the middle of a frame
+        }
+        drainIndex++;
+        drainProgress = 0;
+
+        if (std::chrono::steady_clock::now() >= deadline) break;
+    }
+
+    // Publish the batch's progress as one ack per connection
+    if (!progress.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& entry : progress) {
+                auto it = acks.find(entry.first);
+                if (it == acks.end()) continue;     // Client already gone
+                it->second.framesApplied += entry.second.framesApplied;
+                it->second.succeeded += entry.second.succeeded;
+                it->second.failed += entry.second.failed;
+                it->second.dirty = true;
+            }
+        }
+        wake();
+    }
+
+    return applied;
+}
+
+bool ControlServer::applyCommand(const Command& cmd, StructureAdapter*& active, const SelectFn& select,
+                                 std::unordered_map<int, AckState>& progress,
+                                 const std::chrono::steady_clock::time_point& deadline, size_t& applied) {
+    AckState& state = progress.emplace(cmd.connection, AckState{0, 0, 0, false}).first->second;
+
+    StructureAdapter* target = active;
+    if (cmd.structure != 0) {
+        target = select ? select(static_cast<StructureKind>(cmd.structure - 1)) : nullptr;
+    }
+
+    if (target == nullptr) {
+        uint32_t failures = std::max<uint32_t>(cmd.count, 1);
+        state.failed += failures;
+        totals.failed += failures;
+        state.framesApplied++;
+        return true;
+    }
+
+    auto record = [&](bool ok) {
+        if (ok) { state.succeeded++; totals.succeeded++; }
+        else    { state.failed++; totals.failed++; }
+        totals.operations++;
+        applied++;
+    };
+
+    switch (cmd.op) {
+        case OP_INSERT:
+        case OP_DELETE:
+        case OP_SEARCH:
+        case OP_POP: {
+            const int32_t* values = draining.values.data() + cmd.offset;
+            for (uint32_t i = drainProgress; i < cmd.count; i++) {
+                bool ok;
+                pathBuffer.clear();
+                switch (cmd.op) {
+                    case OP_INSERT: ok = target->insert(values[i], pathBuffer); break;
+                    case OP_DELETE: ok = target->remove(values[i], pathBuffer); break;
+                    case OP_SEARCH: ok = target->search(values[i], pathBuffer); break;
+                    default: {
+                        int popped;
+                        ok = target->pop(popped);
+                        break;
+                    }
+                }
+                record(ok);
+
+                // Check the clock only every so often - it costs more than an insert
+                if ((i & 1023) == 1023 && i + 1 < cmd.count &&
+                    std::chrono::steady_clock::now() >= deadline) {
+                    drainProgress = i + 1;
+                    return false;
+                }
+            }
+            break;
+        }
+
+        case OP_CLEAR:
+            target->clear();
+            record(true);
+            break;
+
+        case OP_USE:
+            active = target;
+            record(true);
+            break;
+
+        case OP_SHUTDOWN:
+            shutdownFlag = true;
+            record(true);
+            break;
+    }
+
+    state.framesApplied++;
+    return true;
+}
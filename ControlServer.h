@@ -0,0 +1,154 @@
+// File: ControlServer.h
+// Description: Optional Unix-domain socket server that lets external test
+// harnesses stream operations into a running visualizer.
+//
+// A background ingest thread accepts connections and parses frames into a
+// queue. The simulation side (the GUI loop or the headless driver) applies
+// the queue to its structures with applyPending() on its own schedule, so
+// rendering never waits on the socket and vice versa.
+//
+// Protocol (host byte order - the socket is local):
+//   Request: u8 op | u8 structure | u16 reserved | u32 count | i32 values[]
+//     op        1 insert, 2 delete, 3 search  - 'count' values follow
+//               4 pop                         - pop 'count' times, no values
+//               5 clear, 6 use, 7 shutdown    - no values
+//     structure 0 = active structure, otherwise StructureKind + 1
+//   Ack:     u32 framesApplied | u32 succeeded | u32 failed | u32 reserved
+//     Counters are cumulative per connection. One ack is sent per applied
+//     batch (not per frame), so clients can pipeline any number of frames
+//     and wait until framesApplied reaches the number they have sent.
+
+#ifndef CONTROL_SERVER_H
+#define CONTROL_SERVER_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
+#include "StructureAdapter.h"
+
+// ============================================================================
+// CONTROL SERVER CLASS
+// ============================================================================
+class ControlServer {
+public:
+    enum Op : uint8_t {
+        OP_INSERT = 1,
+        OP_DELETE = 2,
+        OP_SEARCH = 3,
+        OP_POP = 4,
+        OP_CLEAR = 5,
+        OP_USE = 6,
+        OP_SHUTDOWN = 7
+    };
+
+    // Resolves the structure named in a frame; nullptr if it isn't available
+    typedef std::function<StructureAdapter*(StructureKind kind)> SelectFn;
+
+    // Totals over all connections (simulation side)
+    struct Totals {
+        uint64_t operations;
+        uint64_t succeeded;
+        uint64_t failed;
+
+        Totals() : operations(0), succeeded(0), failed(0) {}
+    };
+
+private:
+    static const size_t HEADER_SIZE = 8;
+    static const size_t ACK_SIZE = 16;
+    static const uint32_t MAX_FRAME_VALUES = 1u << 24;     // Larger frames are a protocol error
+    static const size_t MAX_QUEUED_VALUES = 8u << 20;      // Stop reading beyond this (backpressure)
+
+    // One parsed frame; values live in the owning batch
+    struct Command {
+        uint8_t op;
+        uint8_t structure;
+        int connection;
+        uint32_t count;
+        size_t offset;
+    };
+
+    // Ingest fills one batch while the simulation drains the other;
+    // they are swapped under the mutex, never copied
+    struct Batch {
+        std::vector<Command> commands;
+        std::vector<int32_t> values;
+
+        void clear() { commands.clear(); values.clear(); }
+        bool empty() const { return commands.empty(); }
+    };
+
+    struct Connection {
+        int fd;
+        int id;
+        std::vector<char> buffer;   // Bytes not yet parsed into frames
+        std::string outbox;         // Ack bytes the socket didn't take yet
+    };
+
+    struct AckState {
+        uint32_t framesApplied;
+        uint32_t succeeded;
+        uint32_t failed;
+        bool dirty;                 // Changed since the last ack was sent
+    };
+
+    std::string path;
+    int listenFd;
+    int wakePipe[2];                // Wakes the ingest thread to send acks / stop
+    std::thread ingestThread;
+    std::atomic<bool> running;
+    std::atomic<bool> shutdownFlag;
+
+    std::mutex mutex;
+    std::condition_variable dataReady;
+    Batch incoming;                                 // Guarded by mutex
+    std::unordered_map<int, AckState> acks;         // Guarded by mutex
+
+    // Simulation side only
+    Batch draining;
+    size_t drainIndex;              // Next command in 'draining'
+    uint32_t drainProgress;         // Values of that command already applied
+    std::vector<int> pathBuffer;
+    Totals totals;
+
+    // Ingest thread
+    void ingestLoop();
+    bool readConnection(Connection& conn);
+    bool parseFrames(Connection& conn);
+    void flushAcks(std::vector<Connection>& connections);
+    void wake();
+
+    // Simulation side: apply one command (or part of it); returns true when complete
+    bool applyCommand(const Command& cmd, StructureAdapter*& active, const SelectFn& select,
+                      std::unordered_map<int, AckState>& progress,
+                      const std::chrono::steady_clock::time_point& deadline, size_t& applied);
+
+public:
+    explicit ControlServer(const std::string& socketPath);
+    ~ControlServer();
+
+    // Bind the socket and start the ingest thread. On failure 'error' is set.
+    bool start(std::string& error);
+    void stop();
+
+    // Apply queued commands for at most budgetMs on the calling thread.
+    // 'active' is updated by 'use' frames. Returns the number of operations applied.
+    size_t applyPending(StructureAdapter*& active, const SelectFn& select, double budgetMs);
+
+    // Block until commands are queued (or the timeout passes)
+    bool waitForCommands(int timeoutMs);
+
+    bool isRunning() const { return running; }
+    bool shutdownRequested() const { return shutdownFlag; }
+    const Totals& getTotals() const { return totals; }
+    const std::string& getPath() const { return path; }
+};
+
+#endif // CONTROL_SERVER_H
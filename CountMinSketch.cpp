@@ -0,0 +1,114 @@
+// File: CountMinSketch.cpp
+// Description: Count-min sketch implementation
+
+#include "CountMinSketch.h"
+#include "FilterHash.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const size_t BATCH_CHUNK = 256;
+}
+
+CountMinSketch::CountMinSketch(uint32_t sketchWidth, int sketchDepth)
+    : width(std::max<uint32_t>(1, sketchWidth)), depth(std::max(1, sketchDepth)), total(0)
+{
+    counters.assign(static_cast<size_t>(width) * depth, 0);
+}
+
+CountMinSketch CountMinSketch::forError(double epsilon, double delta) {
+    epsilon = std::max(1e-9, epsilon);
+    delta = std::min(0.5, std::max(1e-9, delta));
+    uint32_t w = static_cast<uint32_t>(std::ceil(std::exp(1.0) / epsilon));
+    int d = static_cast<int>(std::ceil(std::log(1.0 / delta)));
+    return CountMinSketch(w, d);
+}
+
+// ============================================================================
+// HASHING
+// ============================================================================
+// Row i uses h1 + i * h2 (Kirsch-Mitzenmacher), mapped onto [0, width)
+// with a multiply-shift instead of a division.
+// ============================================================================
+
+uint32_t CountMinSketch::column(uint32_t h1, uint32_t h2, int row) const {
+    uint32_t h = h1 + static_cast<uint32_t>(row) * h2;
+    return static_cast<uint32_t>((static_cast<uint64_t>(h) * width) >> 32);
+}
+
+// ============================================================================
+// UPDATE / QUERY
+// ============================================================================
+
+uint32_t CountMinSketch::addHashed(uint32_t h1, uint32_t h2, uint32_t count) {
+    uint32_t smallest = UINT32_MAX;
+    for (int row = 0; row < depth; row++) {
+        uint32_t& cell = counters[static_cast<size_t>(row) * width + column(h1, h2, row)];
+        cell += count;
+        smallest = std::min(smallest, cell);
+    }
+    total += count;
+    return smallest;
+}
+
+void CountMinSketch::add(int key, uint32_t count) {
+    uint32_t h1, h2;
+    FilterHash::hash(key, h1, h2);
+    addHashed(h1, h2, count);
+}
+
+void CountMinSketch::addBatch(const int* keys, size_t count) {
+    uint32_t h1[BATCH_CHUNK], h2[BATCH_CHUNK];
+    for (size_t offset = 0; offset < count; offset += BATCH_CHUNK) {
+        size_t n = std::min(BATCH_CHUNK, count - offset);
+        FilterHash::hashBatch(keys + offset, n, h1, h2);
+        for (size_t i = 0; i < n; i++) {
+            addHashed(h1[i], h2[i]);
+        }
+    }
+}
+
+uint32_t CountMinSketch::estimateHashed(uint32_t h1, uint32_t h2) const {
+    uint32_t smallest = UINT32_MAX;
+    for (int row = 0; row < depth; row++) {
+        smallest = std::min(smallest, counters[static_cast<size_t>(row) * width + column(h1, h2, row)]);
+    }
+    return smallest;
+}
+
+uint64_t CountMinSketch::estimate(int key) const {
+    uint32_t h1, h2;
+    FilterHash::hash(key, h1, h2);
+    return estimateHashed(h1, h2);
+}
+
+// ============================================================================
+// UTILITIES
+// ============================================================================
+
+bool CountMinSketch::merge(const CountMinSketch& other) {
+    if (other.width != width || other.depth != depth) return false;
+    for (size_t i = 0; i < counters.size(); i++) {
+        counters[i] += other.counters[i];
+    }
+    total += other.total;
+    return true;
+}
+
+void CountMinSketch::clear() {
+    std::fill(counters.begin(), counters.end(), 0);
+    total = 0;
+}
+
+uint32_t CountMinSketch::maxCounter() const {
+    return counters.empty() ? 0 : *std::max_element(counters.begin(), counters.end());
+}
+
+void CountMinSketch::cells(int key, std::vector<uint32_t>& columns) const {
+    uint32_t h1, h2;
+    FilterHash::hash(key, h1, h2);
+    columns.clear();
+    for (int row = 0; row < depth; row++) {
+        columns.push_back(column(h1, h2, row));
+    }
+}
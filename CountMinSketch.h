@@ -0,0 +1,59 @@
+// File: CountMinSketch.h
+// Description: Count-min sketch for approximate per-key counts in a stream.
+// 'depth' rows of 'width' counters; a key adds to one counter per row and
+// its estimate is the smallest of those counters. Estimates never
+// undercount, and overcount by at most e/width of the stream length with
+// probability 1 - e^-depth (see forError()).
+//
+// Sketches with the same dimensions and hashing are merged by adding their
+// counters, so a stream can be split across threads and the partial
+// sketches combined at the end.
+//
+// Counters are 32-bit: one key may be counted up to ~4 billion times.
+
+#ifndef COUNT_MIN_SKETCH_H
+#define COUNT_MIN_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class CountMinSketch {
+private:
+    std::vector<uint32_t> counters;     // Row-major, depth * width
+    uint32_t width;
+    int depth;
+    uint64_t total;
+
+    uint32_t column(uint32_t h1, uint32_t h2, int row) const;
+
+public:
+    CountMinSketch(uint32_t width, int depth);
+
+    // Smallest sketch whose error is below epsilon * N with probability 1 - delta
+    static CountMinSketch forError(double epsilon, double delta);
+
+    void add(int key, uint32_t count = 1);
+    // Add with precomputed hashes (FilterHash); returns the key's new estimate
+    uint32_t addHashed(uint32_t h1, uint32_t h2, uint32_t count = 1);
+    void addBatch(const int* keys, size_t count);
+
+    uint64_t estimate(int key) const;
+    uint32_t estimateHashed(uint32_t h1, uint32_t h2) const;
+
+    // False (and nothing changes) if the dimensions differ
+    bool merge(const CountMinSketch& other);
+    void clear();
+
+    uint32_t getWidth() const { return width; }
+    int getDepth() const { return depth; }
+    uint64_t getTotal() const { return total; }
+    size_t sizeInBytes() const { return counters.size() * sizeof(uint32_t); }
+
+    // Counter access and a key's cells, for drawing
+    uint32_t counter(int row, uint32_t col) const { return counters[static_cast<size_t>(row) * width + col]; }
+    uint32_t maxCounter() const;
+    void cells(int key, std::vector<uint32_t>& columns) const;
+};
+
+#endif // COUNT_MIN_SKETCH_H
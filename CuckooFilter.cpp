@@ -0,0 +1,256 @@
+// File: CuckooFilter.cpp
+// Description: Cuckoo filter implementation (instantiated for 8- and
+// 16-bit fingerprints at the bottom of the file)
+
+#include "CuckooFilter.h"
+#include "FilterHash.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CUCKOO_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define CUCKOO_PREFETCH(address) ((void)(address))
+#endif
+
+namespace {
+    const size_t BATCH_CHUNK = 256;
+    const size_t PREFETCH_DISTANCE = 8;
+}
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+template <typename FingerprintT>
+CuckooFilter<FingerprintT>::CuckooFilter(size_t expectedKeys)
+    : bucketCount(1), storedCount(0), hasVictim(false), victimBucket(0),
+      victimFingerprint(0), kickState(12345)
+{
+    size_t needed = static_cast<size_t>(std::ceil(expectedKeys / (SLOTS * 0.95)));
+    bucketCount = static_cast<uint32_t>(std::max<size_t>(1, needed));
+    table.assign(static_cast<size_t>(bucketCount) * SLOTS, 0);
+}
+
+// ============================================================================
+// HASHING
+// ============================================================================
+
+template <typename FingerprintT>
+FingerprintT CuckooFilter<FingerprintT>::fingerprintOf(uint32_t h2) {
+    // Top bits of the second hash; 0 marks an empty slot, so remap it
+    FingerprintT fingerprint = static_cast<FingerprintT>(h2 >> (32 - FINGERPRINT_BITS));
+    return fingerprint == 0 ? 1 : fingerprint;
+}
+
+template <typename FingerprintT>
+uint32_t CuckooFilter<FingerprintT>::bucketFor(uint32_t hash) const {
+    // Multiply-shift maps the hash onto [0, bucketCount) without a division
+    return static_cast<uint32_t>((static_cast<uint64_t>(hash) * bucketCount) >> 32);
+}
+
+template <typename FingerprintT>
+uint32_t CuckooFilter<FingerprintT>::alternateBucket(uint32_t bucket, FingerprintT fingerprint) const {
+    // (hash(fingerprint) - bucket) mod n: applying it twice gives 'bucket'
+    // back, and unlike the usual xor it works for any table size
+    uint32_t offset = bucketFor(static_cast<uint32_t>(fingerprint) * 0x5bd1e995u);
+    return offset >= bucket ? offset - bucket : offset + bucketCount - bucket;
+}
+
+// ============================================================================
+// BUCKET OPERATIONS
+// ============================================================================
+
+template <typename FingerprintT>
+bool CuckooFilter<FingerprintT>::bucketHas(uint32_t bucket, FingerprintT fingerprint) const {
+    const FingerprintT* slots = &table[static_cast<size_t>(bucket) * SLOTS];
+    return slots[0] == fingerprint || slots[1] == fingerprint ||
+           slots[2] == fingerprint || slots[3] == fingerprint;
+}
+
+template <typename FingerprintT>
+bool CuckooFilter<FingerprintT>::addToBucket(uint32_t bucket, FingerprintT fingerprint) {
+    FingerprintT* slots = &table[static_cast<size_t>(bucket) * SLOTS];
+    for (int i = 0; i < SLOTS; i++) {
+        if (slots[i] == 0) {
+            slots[i] = fingerprint;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename FingerprintT>
+bool CuckooFilter<FingerprintT>::removeFromBucket(uint32_t bucket, FingerprintT fingerprint) {
+    FingerprintT* slots = &table[static_cast<size_t>(bucket) * SLOTS];
+    for (int i = 0; i < SLOTS; i++) {
+        if (slots[i] == fingerprint) {
+            slots[i] = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// INSERT / LOOKUP
+// ============================================================================
+
+template <typename FingerprintT>
+bool CuckooFilter<FingerprintT>::insertHashed(uint32_t h1, uint32_t h2) {
+    if (hasVictim) return false;
+
+    FingerprintT fingerprint = fingerprintOf(h2);
+    uint32_t bucket = bucketFor(h1);
+    uint32_t other = alternateBucket(bucket, fingerprint);
+    if (addToBucket(bucket, fingerprint) || addToBucket(other, fingerprint)) {
+        storedCount++;
+        return true;
+    }
+
+    // Both full: evict a random occupant to its other bucket, and repeat
+    if (kickState & 1) bucket = other;
+    for (int kick = 0; kick < MAX_KICKS; kick++) {
+        kickState = kickState * 1103515245u + 12345u;
+        int victimSlot = static_cast<int>((kickState >> 16) % SLOTS);
+        std::swap(fingerprint, table[static_cast<size_t>(bucket) * SLOTS + victimSlot]);
+        bucket = alternateBucket(bucket, fingerprint);
+        if (addToBucket(bucket, fingerprint)) {
+            storedCount++;
+            return true;
+        }
+    }
+
+    // Keep the last homeless fingerprint so no inserted key is lost
+    hasVictim = true;
+    victimBucket = bucket;
+    victimFingerprint = fingerprint;
+    storedCount++;
+    return true;
+}
+
+template <typename FingerprintT>
+bool CuckooFilter<FingerprintT>::containsHashed(uint32_t h1, uint32_t h2) const {
+    FingerprintT fingerprint = fingerprintOf(h2);
+    uint32_t bucket = bucketFor(h1);
+    uint32_t other = alternateBucket(bucket, fingerprint);
+    if (bucketHas(bucket, fingerprint) || bucketHas(other, fingerprint)) return true;
+    return hasVictim && victimFingerprint == fingerprint &&
+           (victimBucket == bucket || victimBucket == other);
+}
+
+template <typename FingerprintT>
+bool CuckooFilter<FingerprintT>::insert(int key) {
+    uint32_t h1, h2;
+    FilterHash::hash(key, h1, h2);
+    return insertHashed(h1, h2);
+}
+
+template <typename FingerprintT>
+bool CuckooFilter<FingerprintT>::contains(int key) const {
+    uint32_t h1, h2;
+    FilterHash::hash(key, h1, h2);
+    return containsHashed(h1, h2);
+}
+
+template <typename FingerprintT>
+bool CuckooFilter<FingerprintT>::remove(int key) {
+    uint32_t h1, h2;
+    FilterHash::hash(key, h1, h2);
+    FingerprintT fingerprint = fingerprintOf(h2);
+    uint32_t bucket = bucketFor(h1);
+    uint32_t other = alternateBucket(bucket, fingerprint);
+
+    if (hasVictim && victimFingerprint == fingerprint &&
+        (victimBucket == bucket || victimBucket == other)) {
+        hasVictim = false;
+        storedCount--;
+        return true;
+    }
+    if (!removeFromBucket(bucket, fingerprint) && !removeFromBucket(other, fingerprint)) {
+        return false;
+    }
+    storedCount--;
+
+    // A slot just opened up; give the stashed fingerprint another chance
+    if (hasVictim) {
+        uint32_t victimOther = alternateBucket(victimBucket, victimFingerprint);
+        if (addToBucket(victimBucket, victimFingerprint) ||
+            addToBucket(victimOther, victimFingerprint)) {
+            hasVictim = false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// BATCHES
+// ============================================================================
+
+template <typename FingerprintT>
+size_t CuckooFilter<FingerprintT>::insertBatch(const int* keys, size_t count) {
+    uint32_t h1[BATCH_CHUNK], h2[BATCH_CHUNK];
+    size_t inserted = 0;
+    for (size_t offset = 0; offset < count; offset += BATCH_CHUNK) {
+        size_t n = std::min(BATCH_CHUNK, count - offset);
+        FilterHash::hashBatch(keys + offset, n, h1, h2);
+        for (size_t i = 0; i < n; i++) {
+            if (i + PREFETCH_DISTANCE < n) {
+                CUCKOO_PREFETCH(&table[static_cast<size_t>(bucketFor(h1[i + PREFETCH_DISTANCE])) * SLOTS]);
+            }
+            if (insertHashed(h1[i], h2[i])) inserted++;
+        }
+    }
+    return inserted;
+}
+
+template <typename FingerprintT>
+size_t CuckooFilter<FingerprintT>::containsBatch(const int* keys, size_t count, uint8_t* results) const {
+    uint32_t h1[BATCH_CHUNK], h2[BATCH_CHUNK];
+    size_t found = 0;
+    for (size_t offset = 0; offset < count; offset += BATCH_CHUNK) {
+        size_t n = std::min(BATCH_CHUNK, count - offset);
+        FilterHash::hashBatch(keys + offset, n, h1, h2);
+        for (size_t i = 0; i < n; i++) {
+            if (i + PREFETCH_DISTANCE < n) {
+                uint32_t ahead = bucketFor(h1[i + PREFETCH_DISTANCE]);
+                CUCKOO_PREFETCH(&table[static_cast<size_t>(ahead) * SLOTS]);
+                CUCKOO_PREFETCH(&table[static_cast<size_t>(
+                    alternateBucket(ahead, fingerprintOf(h2[i + PREFETCH_DISTANCE]))) * SLOTS]);
+            }
+            bool present = containsHashed(h1[i], h2[i]);
+            results[offset + i] = present ? 1 : 0;
+            found += present ? 1 : 0;
+        }
+    }
+    return found;
+}
+
+// ============================================================================
+// UTILITIES
+// ============================================================================
+
+template <typename FingerprintT>
+void CuckooFilter<FingerprintT>::clear() {
+    std::fill(table.begin(), table.end(), 0);
+    storedCount = 0;
+    hasVictim = false;
+}
+
+template <typename FingerprintT>
+void CuckooFilter<FingerprintT>::candidates(int key, size_t& first, size_t& second,
+                                            FingerprintT& fingerprint) const {
+    uint32_t h1, h2;
+    FilterHash::hash(key, h1, h2);
+    fingerprint = fingerprintOf(h2);
+    first = bucketFor(h1);
+    second = alternateBucket(static_cast<uint32_t>(first), fingerprint);
+}
+
+template <typename FingerprintT>
+double CuckooFilter<FingerprintT>::expectedFalsePositiveRate() {
+    return 2.0 * SLOTS / std::pow(2.0, FINGERPRINT_BITS);
+}
+
+template class CuckooFilter<uint8_t>;
+template class CuckooFilter<uint16_t>;
@@ -0,0 +1,83 @@
+// File: CuckooFilter.h
+// Description: Cuckoo filter over int keys with 8- or 16-bit fingerprints.
+// The table has n buckets with 4 fingerprint slots each. A key's
+// fingerprint may live in one of two buckets: i1 from its first hash and
+// i2 = (hash(fingerprint) - i1) mod n, so either bucket can be computed
+// from the other plus the fingerprint alone - which is what lets an
+// occupant be kicked to its alternate bucket without knowing its key.
+// (The original xor form needs n to be a power of two, which can leave the
+// table half empty; the subtraction works for any n, so the table is sized
+// for 95% load.)
+//
+// Unlike a Bloom filter it supports removal, and at the same memory it
+// gives a lower false-positive rate once fingerprints are 8+ bits. A
+// lookup reads two buckets (two cache lines at most).
+//
+// When a chain of kicks gives up, the homeless fingerprint is kept in a
+// one-entry stash so nothing inserted is ever lost; the filter then counts
+// as full and further inserts fail until something is removed.
+//
+// Inserting the same key twice stores two copies (it can then be removed
+// twice), as in the original design.
+
+#ifndef CUCKOO_FILTER_H
+#define CUCKOO_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+template <typename FingerprintT>
+class CuckooFilter {
+public:
+    static const int SLOTS = 4;
+    static const int FINGERPRINT_BITS = static_cast<int>(sizeof(FingerprintT) * 8);
+    static const int MAX_KICKS = 500;
+
+private:
+    std::vector<FingerprintT> table;    // bucketCount * SLOTS, 0 = empty slot
+    uint32_t bucketCount;
+    size_t storedCount;
+    bool hasVictim;
+    uint32_t victimBucket;
+    FingerprintT victimFingerprint;
+    uint32_t kickState;                 // LCG choosing which slot to evict
+
+    static FingerprintT fingerprintOf(uint32_t h2);
+    uint32_t bucketFor(uint32_t hash) const;
+    uint32_t alternateBucket(uint32_t bucket, FingerprintT fingerprint) const;
+    bool bucketHas(uint32_t bucket, FingerprintT fingerprint) const;
+    bool addToBucket(uint32_t bucket, FingerprintT fingerprint);
+    bool removeFromBucket(uint32_t bucket, FingerprintT fingerprint);
+    bool insertHashed(uint32_t h1, uint32_t h2);
+    bool containsHashed(uint32_t h1, uint32_t h2) const;
+
+public:
+    // Enough buckets for 'expectedKeys' at up to 95% load
+    explicit CuckooFilter(size_t expectedKeys);
+
+    bool insert(int key);           // False when the filter is full
+    bool contains(int key) const;   // False positives possible, no false negatives
+    bool remove(int key);           // Only remove keys that were inserted
+
+    // Return how many were inserted / reported present
+    size_t insertBatch(const int* keys, size_t count);
+    size_t containsBatch(const int* keys, size_t count, uint8_t* results) const;
+
+    void clear();
+    size_t size() const { return storedCount; }
+    size_t getBucketCount() const { return bucketCount; }
+    size_t capacity() const { return getBucketCount() * SLOTS; }
+    double loadFactor() const { return static_cast<double>(storedCount) / capacity(); }
+    size_t sizeInBits() const { return capacity() * FINGERPRINT_BITS; }
+    bool isFull() const { return hasVictim; }
+
+    // Slot contents and a key's candidate buckets, for drawing
+    FingerprintT slot(size_t bucket, int index) const { return table[bucket * SLOTS + index]; }
+    void candidates(int key, size_t& first, size_t& second, FingerprintT& fingerprint) const;
+
+    // Upper bound 2 * SLOTS / 2^f for reference
+    static double expectedFalsePositiveRate();
+};
+
+#endif // CUCKOO_FILTER_H
@@ -0,0 +1,341 @@
+// File: ExternalSort.cpp
+// Description: Run formation, k-way merge and the --sort report
+
+#include "ExternalSort.h"
+#include "MinHeap.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+
+const size_t ExternalSort::MAX_FAN_IN;
+const size_t ExternalSort::MIN_BUFFER_BYTES;
+
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// Sequential reader of one run with a private buffer
+class RunReader {
+private:
+    std::FILE* file;
+    std::vector<int> buffer;
+    size_t position;
+    size_t filled;
+
+public:
+    RunReader() : file(nullptr), position(0), filled(0) {}
+    ~RunReader() {
+        if (file) std::fclose(file);
+    }
+    RunReader(const RunReader&) = delete;
+    RunReader& operator=(const RunReader&) = delete;
+
+    bool open(const std::string& path, size_t bufferValues) {
+        file = std::fopen(path.c_str(), "rb");
+        buffer.resize(bufferValues);
+        return file != nullptr;
+    }
+
+    bool next(int& value) {
+        if (position == filled) {
+            filled = std::fread(buffer.data(), sizeof(int), buffer.size(), file);
+            position = 0;
+            if (filled == 0) return false;
+        }
+        value = buffer[position++];
+        return true;
+    }
+};
+
+// Buffered writer; write errors are reported by finish()
+class RunWriter {
+private:
+    std::FILE* file;
+    std::vector<int> buffer;
+    size_t filled;
+    bool failed;
+
+    void flush() {
+        if (filled > 0 && std::fwrite(buffer.data(), sizeof(int), filled, file) != filled) failed = true;
+        filled = 0;
+    }
+
+public:
+    RunWriter() : file(nullptr), filled(0), failed(false) {}
+    ~RunWriter() {
+        if (file) std::fclose(file);
+    }
+    RunWriter(const RunWriter&) = delete;
+    RunWriter& operator=(const RunWriter&) = delete;
+
+    bool open(const std::string& path, size_t bufferValues) {
+        file = std::fopen(path.c_str(), "wb");
+        buffer.resize(bufferValues);
+        return file != nullptr;
+    }
+
+    void write(int value) {
+        buffer[filled++] = value;
+        if (filled == buffer.size()) flush();
+    }
+
+    bool finish() {
+        flush();
+        if (std::fclose(file) != 0) failed = true;
+        file = nullptr;
+        return !failed;
+    }
+};
+
+// Sort values[0, count) on the pool; returns whichever of the two buffers
+// ends up holding the sorted data
+int* sortChunk(int* values, int* scratch, size_t count, TaskPool& pool) {
+    size_t slices = std::max<size_t>(1, std::min<size_t>(pool.size(), count / 65536));
+    std::vector<size_t> bounds(slices + 1);
+    for (size_t i = 0; i <= slices; i++) bounds[i] = count * i / slices;
+
+    pool.parallelFor(slices, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) std::sort(values + bounds[i], values + bounds[i + 1]);
+    });
+
+    // Merge neighbouring slices until one is left
+    int* source = values;
+    int* target = scratch;
+    while (bounds.size() > 2) {
+        size_t pieces = bounds.size() - 1;
+        pool.parallelFor((pieces + 1) / 2, 1, [&](size_t begin, size_t end) {
+            for (size_t pair = begin; pair < end; pair++) {
+                size_t low = bounds[2 * pair];
+                size_t middle = bounds[std::min(2 * pair + 1, pieces)];
+                size_t high = bounds[std::min(2 * pair + 2, pieces)];
+                std::merge(source + low, source + middle, source + middle, source + high, target + low);
+            }
+        });
+        std::vector<size_t> merged;
+        for (size_t i = 0; i < pieces; i += 2) merged.push_back(bounds[i]);
+        merged.push_back(count);
+        bounds.swap(merged);
+        std::swap(source, target);
+    }
+    return source;
+}
+
+void removeFiles(const std::vector<std::string>& paths) {
+    for (const std::string& path : paths) std::remove(path.c_str());
+}
+
+} // namespace
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+ExternalSort::ExternalSort(size_t memoryLimitBytes, TaskPool& taskPool)
+    : memoryBytes(std::max(memoryLimitBytes, 4 * MIN_BUFFER_BYTES)), pool(taskPool)
+{
+}
+
+size_t ExternalSort::fanIn() const {
+    // Each run and the output need a buffer of at least MIN_BUFFER_BYTES
+    size_t buffers = memoryBytes / MIN_BUFFER_BYTES;
+    return std::max<size_t>(2, std::min(MAX_FAN_IN, buffers - 1));
+}
+
+// ============================================================================
+// RUN FORMATION
+// ============================================================================
+
+bool ExternalSort::formRuns(const std::string& input, const std::string& prefix,
+                            std::vector<std::string>& runs, std::string& error) {
+    std::FILE* in = std::fopen(input.c_str(), "rb");
+    if (!in) {
+        error = "Could not open " + input;
+        return false;
+    }
+
+    // Half the budget for the chunk, half for the merge scratch
+    size_t chunkValues = memoryBytes / (2 * sizeof(int));
+    std::vector<int> chunk(chunkValues);
+    std::vector<int> scratch(chunkValues);
+
+    bool ok = true;
+    size_t count;
+    while (ok && (count = std::fread(chunk.data(), sizeof(int), chunkValues, in)) > 0) {
+        const int* sorted = sortChunk(chunk.data(), scratch.data(), count, pool);
+
+        std::string path = prefix + std::to_string(runs.size());
+        std::FILE* out = std::fopen(path.c_str(), "wb");
+        if (!out) {
+            error = "Could not create " + path;
+            ok = false;
+            break;
+        }
+        runs.push_back(path);
+        bool written = std::fwrite(sorted, sizeof(int), count, out) == count;
+        if (std::fclose(out) != 0 || !written) {
+            error = "Could not write " + path;
+            ok = false;
+        }
+        stats.values += count;
+    }
+    std::fclose(in);
+    return ok;
+}
+
+// ============================================================================
+// K-WAY MERGE
+// ============================================================================
+
+bool ExternalSort::mergeRuns(const std::vector<std::string>& runs, const std::string& output,
+                             std::string& error) {
+    // Every run and the output get an equal share of the budget; at most
+    // fanIn() runs keeps that share at MIN_BUFFER_BYTES or more
+    size_t bufferBytes = memoryBytes / (runs.size() + 1);
+    size_t bufferValues = bufferBytes / sizeof(int);
+
+    std::vector<RunReader> readers(runs.size());
+    for (size_t r = 0; r < runs.size(); r++) {
+        if (!readers[r].open(runs[r], bufferValues)) {
+            error = "Could not open " + runs[r];
+            return false;
+        }
+    }
+    RunWriter writer;
+    if (!writer.open(output, bufferValues)) {
+        error = "Could not create " + output;
+        return false;
+    }
+
+    MinHeap heap;
+    std::vector<int> siftPath;
+    int value;
+    for (size_t r = 0; r < runs.size(); r++) {
+        if (readers[r].next(value)) heap.insert(value, siftPath, static_cast<int>(r));
+    }
+
+    // Output the smallest head; the same run supplies its replacement
+    while (!heap.isEmpty()) {
+        HeapNode* top = heap.peekMin();
+        writer.write(top->value);
+        int run = top->source;
+        siftPath.clear();
+        if (readers[run].next(value)) {
+            heap.replaceMin(value, run, siftPath);
+        } else {
+            delete heap.extractMin(siftPath);
+        }
+    }
+
+    if (!writer.finish()) {
+        error = "Could not write " + output;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// DRIVER
+// ============================================================================
+
+bool ExternalSort::sortFile(const std::string& input, const std::string& output, std::string& error) {
+    stats = ExternalSortStats();
+    std::string prefix = output + ".run";
+    std::vector<std::string> runs;
+
+    auto start = std::chrono::steady_clock::now();
+    if (!formRuns(input, prefix, runs, error)) {
+        removeFiles(runs);
+        return false;
+    }
+    stats.runs = runs.size();
+    stats.runMs = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    size_t maxRuns = fanIn();
+    while (runs.size() > maxRuns) {
+        // Too many runs for useful buffers: merge groups into longer runs
+        std::vector<std::string> longer;
+        for (size_t first = 0; first < runs.size(); first += maxRuns) {
+            std::vector<std::string> group(runs.begin() + first,
+                                           runs.begin() + std::min(runs.size(), first + maxRuns));
+            std::string path = prefix + "p" + std::to_string(stats.mergePasses) + "_" +
+                               std::to_string(longer.size());
+            longer.push_back(path);
+            bool merged = mergeRuns(group, path, error);
+            removeFiles(group);
+            if (!merged) {
+                removeFiles(std::vector<std::string>(runs.begin() + first + group.size(), runs.end()));
+                removeFiles(longer);
+                return false;
+            }
+        }
+        runs.swap(longer);
+        stats.mergePasses++;
+    }
+
+    bool merged = mergeRuns(runs, output, error);
+    removeFiles(runs);
+    stats.mergePasses++;
+    stats.mergeMs = elapsedMs(start);
+    return merged;
+}
+
+bool ExternalSort::isSortedFile(const std::string& path, size_t& values, std::string& error) {
+    RunReader reader;
+    if (!reader.open(path, (1u << 20) / sizeof(int))) {
+        error = "Could not open " + path;
+        return false;
+    }
+    values = 0;
+    int previous = 0;
+    int value;
+    bool sorted = true;
+    while (reader.next(value)) {
+        if (values > 0 && value < previous) sorted = false;
+        previous = value;
+        values++;
+    }
+    return sorted;
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+int ExternalSort::run(const std::string& input, const std::string& output,
+                      size_t memoryLimitBytes, std::ostream& out) {
+    TaskPool& pool = TaskPool::shared();
+    ExternalSort sorter(memoryLimitBytes, pool);
+    std::string error;
+    if (!sorter.sortFile(input, output, error)) {
+        out << error << "\n";
+        return 2;
+    }
+    const ExternalSortStats& stats = sorter.getStats();
+
+    double megabytes = stats.values * sizeof(int) / 1048576.0;
+    double limit = sorter.memoryBytes / 1048576.0;
+    out << std::fixed << std::setprecision(1);
+    out << "External sort: " << input << " -> " << output << ", " << stats.values << " values ("
+        << megabytes << " MB, " << (limit > 0 ? megabytes / limit : 0.0) << "x the "
+        << limit << " MB memory limit)\n";
+    out << "  runs:   " << stats.runs << " sorted runs in " << stats.runMs << " ms ("
+        << (stats.runMs > 0 ? megabytes / (stats.runMs / 1000.0) : 0.0) << " MB/s, "
+        << pool.size() << " thread(s))\n";
+    out << "  merge:  " << stats.mergePasses << " pass(es) through a MinHeap of run heads in "
+        << stats.mergeMs << " ms (" << (stats.mergeMs > 0 ? megabytes / (stats.mergeMs / 1000.0) : 0.0)
+        << " MB/s)\n";
+    double totalMs = stats.runMs + stats.mergeMs;
+    out << "  total:  " << totalMs << " ms (" << (totalMs > 0 ? megabytes / (totalMs / 1000.0) : 0.0)
+        << " MB/s)\n";
+
+    size_t checked = 0;
+    bool sorted = isSortedFile(output, checked, error);
+    bool ok = sorted && checked == stats.values;
+    out << (ok ? "  output is sorted and complete\n" : "  OUTPUT IS NOT SORTED OR INCOMPLETE\n");
+    return ok ? 0 : 1;
+}
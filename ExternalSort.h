@@ -0,0 +1,88 @@
+// File: ExternalSort.h
+// Description: Out-of-core sort for raw int32 files larger than memory.
+//
+// 1. Run formation: the input is read in chunks that fit the memory limit.
+//    Each chunk is cut into one slice per TaskPool thread, the slices are
+//    sorted in parallel and then merged pairwise (in parallel, ping-ponging
+//    between the chunk and a scratch buffer of the same size), and the
+//    sorted chunk is written out as a run file.
+// 2. Merge: a MinHeap holds the current head of every run, tagged with
+//    its run number. The minimum is written out and replaced in place by
+//    the next value of the same run (MinHeap::replaceMin), so each output
+//    value costs one O(log k) sift. Every run is read through its own large
+//    buffer, so the disk sees long sequential reads rather than one seek
+//    per value.
+//    One merge reads at most fanIn() runs: as many as the budget holds
+//    buffers of MIN_BUFFER_BYTES (one more is the output), capped at
+//    MAX_FAN_IN. With more runs, groups of runs are first merged into
+//    longer runs, so the buffers never get too small.
+//
+// Memory use stays within the limit: half of it for a chunk and half for
+// the scratch buffer during run formation, then shared among the run
+// buffers and the output buffer during the merge. The limit is at least
+// 4 * MIN_BUFFER_BYTES (256 KB); a smaller one is raised to that.
+//
+// Usage:
+//   DSVisualizer --sort INPUT OUTPUT [--sort-memory MB]   (default 256 MB)
+
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "TaskPool.h"
+
+// ============================================================================
+// SORT STATISTICS
+// ============================================================================
+struct ExternalSortStats {
+    size_t values;
+    size_t runs;            // Initial runs
+    int mergePasses;        // 1 unless the fan-in limit forced more
+    double runMs;           // Read, sort and write the runs
+    double mergeMs;
+
+    ExternalSortStats() : values(0), runs(0), mergePasses(0), runMs(0), mergeMs(0) {}
+};
+
+// ============================================================================
+// EXTERNAL SORT CLASS
+// ============================================================================
+class ExternalSort {
+public:
+    static const size_t MAX_FAN_IN = 256;
+    static const size_t MIN_BUFFER_BYTES = 64 * 1024;
+
+private:
+    size_t memoryBytes;
+    TaskPool& pool;
+    ExternalSortStats stats;
+
+    // Runs merged at once: min(MAX_FAN_IN, memoryBytes / MIN_BUFFER_BYTES - 1)
+    size_t fanIn() const;
+
+    bool formRuns(const std::string& input, const std::string& prefix,
+                  std::vector<std::string>& runs, std::string& error);
+    bool mergeRuns(const std::vector<std::string>& runs, const std::string& output,
+                   std::string& error);
+
+public:
+    ExternalSort(size_t memoryLimitBytes, TaskPool& taskPool);
+
+    // Sort the int32 values of 'input' into 'output'. Run files are created
+    // next to 'output' and removed again.
+    bool sortFile(const std::string& input, const std::string& output, std::string& error);
+
+    const ExternalSortStats& getStats() const { return stats; }
+
+    // True if the int32 file is in non-decreasing order (streamed)
+    static bool isSortedFile(const std::string& path, size_t& values, std::string& error);
+
+    // --sort: sort, verify and print a report. Returns the exit code.
+    static int run(const std::string& input, const std::string& output,
+                   size_t memoryLimitBytes, std::ostream& out);
+};
+
+#endif // EXTERNAL_SORT_H
@@ -0,0 +1,110 @@
+// File: FilterHash.cpp
+// Description: Scalar and SIMD batch hashing for the filters
+
+#include "FilterHash.h"
+
+// The SIMD versions are compiled for their instruction set with a function
+// attribute, so they exist without -mavx2 / -msse4.1; the CPU is asked at
+// run time which one it can execute
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FILTER_HASH_DISPATCH
+#endif
+
+void FilterHash::hashBatchScalar(const int* keys, size_t count, uint32_t* h1, uint32_t* h2) {
+    for (size_t i = 0; i < count; i++) {
+        hash(keys[i], h1[i], h2[i]);
+    }
+}
+
+#if defined(FILTER_HASH_DISPATCH)
+
+namespace {
+    __attribute__((target("avx2")))
+    inline __m256i mix8(__m256i x) {
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+        x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(0x85ebca6bu)));
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 13));
+        x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(0xc2b2ae35u)));
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+        return x;
+    }
+
+    __attribute__((target("avx2")))
+    void hashBatchAvx2(const int* keys, size_t count, uint32_t* h1, uint32_t* h2) {
+        const __m256i seed1 = _mm256_set1_epi32(static_cast<int>(FilterHash::SEED1));
+        const __m256i seed2 = _mm256_set1_epi32(static_cast<int>(FilterHash::SEED2));
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(h1 + i), mix8(_mm256_xor_si256(k, seed1)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(h2 + i), mix8(_mm256_xor_si256(k, seed2)));
+        }
+        FilterHash::hashBatchScalar(keys + i, count - i, h1 + i, h2 + i);
+    }
+
+    __attribute__((target("sse4.1")))
+    inline __m128i mix4(__m128i x) {
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+        x = _mm_mullo_epi32(x, _mm_set1_epi32(static_cast<int>(0x85ebca6bu)));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 13));
+        x = _mm_mullo_epi32(x, _mm_set1_epi32(static_cast<int>(0xc2b2ae35u)));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+        return x;
+    }
+
+    __attribute__((target("sse4.1")))
+    void hashBatchSse41(const int* keys, size_t count, uint32_t* h1, uint32_t* h2) {
+        const __m128i seed1 = _mm_set1_epi32(static_cast<int>(FilterHash::SEED1));
+        const __m128i seed2 = _mm_set1_epi32(static_cast<int>(FilterHash::SEED2));
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(h1 + i), mix4(_mm_xor_si128(k, seed1)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(h2 + i), mix4(_mm_xor_si128(k, seed2)));
+        }
+        FilterHash::hashBatchScalar(keys + i, count - i, h1 + i, h2 + i);
+    }
+
+    typedef void (*BatchFunction)(const int*, size_t, uint32_t*, uint32_t*);
+
+    struct BatchImplementation {
+        BatchFunction function;
+        const char* name;
+    };
+
+    // Chosen once, on first use
+    const BatchImplementation& batchImplementation() {
+        static const BatchImplementation chosen = []() {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return BatchImplementation{hashBatchAvx2, "AVX2"};
+            }
+            if (__builtin_cpu_supports("sse4.1")) {
+                return BatchImplementation{hashBatchSse41, "SSE4.1"};
+            }
+            return BatchImplementation{FilterHash::hashBatchScalar, "scalar"};
+        }();
+        return chosen;
+    }
+}
+
+void FilterHash::hashBatch(const int* keys, size_t count, uint32_t* h1, uint32_t* h2) {
+    batchImplementation().function(keys, count, h1, h2);
+}
+
+const char* FilterHash::instructionSet() {
+    return batchImplementation().name;
+}
+
+#else
+
+void FilterHash::hashBatch(const int* keys, size_t count, uint32_t* h1, uint32_t* h2) {
+    hashBatchScalar(keys, count, h1, h2);
+}
+
+const char* FilterHash::instructionSet() {
+    return "scalar";
+}
+
+#endif
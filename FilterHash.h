@@ -0,0 +1,56 @@
+// File: FilterHash.h
+// Description: Key hashing shared by the approximate-membership filters
+// and the stream sketches. Every key gets two independent 32-bit hashes
+// (murmur3's finalizer with two seeds): h1 picks the block / bucket, h2
+// the bits / fingerprint. Together they form the 64-bit hash HyperLogLog
+// needs.
+//
+// hashBatch() hashes many keys at once. The finalizer is only shifts, xors
+// and 32-bit multiplies, so it maps directly onto SIMD lanes: 8 keys per
+// instruction with AVX2, 4 with SSE4.1. Both are built on x86 with GCC or
+// Clang whatever the compiler flags, and the first call picks the best one
+// the CPU supports; elsewhere the scalar loop is used. All three produce
+// identical hashes.
+
+#ifndef FILTER_HASH_H
+#define FILTER_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+class FilterHash {
+public:
+    static const uint32_t SEED1 = 0x9e3779b9u;
+    static const uint32_t SEED2 = 0x7f4a7c15u;
+
+    // murmur3 fmix32
+    static inline uint32_t mix(uint32_t x) {
+        x ^= x >> 16;
+        x *= 0x85ebca6bu;
+        x ^= x >> 13;
+        x *= 0xc2b2ae35u;
+        x ^= x >> 16;
+        return x;
+    }
+
+    static inline void hash(int key, uint32_t& h1, uint32_t& h2) {
+        uint32_t k = static_cast<uint32_t>(key);
+        h1 = mix(k ^ SEED1);
+        h2 = mix(k ^ SEED2);
+    }
+
+    static inline uint64_t combine(uint32_t h1, uint32_t h2) {
+        return (static_cast<uint64_t>(h1) << 32) | h2;
+    }
+
+    // Hash 'count' keys into h1[] / h2[] (vectorized when available)
+    static void hashBatch(const int* keys, size_t count, uint32_t* h1, uint32_t* h2);
+
+    // Always the plain loop (for comparison in the benchmarks)
+    static void hashBatchScalar(const int* keys, size_t count, uint32_t* h1, uint32_t* h2);
+
+    // "AVX2", "SSE4.1" or "scalar"
+    static const char* instructionSet();
+};
+
+#endif // FILTER_HASH_H
@@ -110,7 +110,7 @@ void Button::setText(const std::string& text) {
 TextInput::TextInput(float x, float y, float width, float height,
                      const std::string& placeholderText, sf::Font& fontRef,
                      bool numOnly)
-    : font(&fontRef), isFocused(false), numericOnly(numOnly),
+    : font(&fontRef), isFocused(false), kind(numOnly ? INTEGER : TEXT), maxLength(10),
       cursorBlinkTimer(0), cursorVisible(true)
 {
     // Setup the input box
@@ -177,13 +177,21 @@ void TextInput::handleEvent(const sf::Event& event, const sf::RenderWindow& wind
             
             // Check if we should accept this character
             bool accept = true;
-            if (numericOnly) {
+            if (kind == INTEGER) {
                 // Only accept digits and minus sign (at start)
                 accept = (c >= '0' && c <= '9') || 
                          (c == '-' && inputString.empty());
+            } else if (kind == DECIMAL) {
+                // Digits, one point, an exponent; signs at the start or after 'e'
+                char previous = inputString.empty() ? '\0' : inputString.back();
+                accept = (c >= '0' && c <= '9') ||
+                         (c == '.' && inputString.find('.') == std::string::npos) ||
+                         ((c == 'e' || c == 'E') && inputString.find_first_of("eE") == std::string::npos) ||
+                         ((c == '-' || c == '+') &&
+                          (inputString.empty() || previous == 'e' || previous == 'E'));
             }
             
-            if (accept && inputString.length() < 10) {  // Max 10 chars
+            if (accept && inputString.length() < maxLength) {
                 inputString += c;
                 displayText.setString(inputString);
             }
@@ -255,6 +263,12 @@ bool TextInput::getAsInt(int& result) const {
     }
 }
 
+void TextInput::setKind(Kind newKind, size_t newMaxLength) {
+    kind = newKind;
+    maxLength = newMaxLength;
+    clear();
+}
+
 // ============================================================================
 // SLIDER IMPLEMENTATION
 // ============================================================================
@@ -463,3 +477,164 @@ bool MessageBox::isVisible() const {
     return visible;
 }
 
+
+// ============================================================================
+// CONSOLE PANEL IMPLEMENTATION
+// ============================================================================
+
+ConsolePanel::ConsolePanel(float x, float y, float width, float height, sf::Font& fontRef)
+    : font(&fontRef), historyIndex(0), open(false), hasSubmission(false),
+      cursorBlinkTimer(0), cursorVisible(true)
+{
+    background.setPosition(x, y);
+    background.setSize(sf::Vector2f(width, height));
+    background.setFillColor(sf::Color(20, 20, 26, 235));
+    background.setOutlineThickness(1.0f);
+    background.setOutlineColor(Config::TEXTBOX_BORDER);
+
+    inputBar.setPosition(x, y + height - 26);
+    inputBar.setSize(sf::Vector2f(width, 26));
+    inputBar.setFillColor(Config::TEXTBOX_BG);
+    inputBar.setOutlineThickness(1.0f);
+    inputBar.setOutlineColor(Config::TEXTBOX_ACTIVE_BORDER);
+
+    lineText.setFont(*font);
+    lineText.setCharacterSize(Config::LABEL_FONT_SIZE);
+
+    inputText.setFont(*font);
+    inputText.setCharacterSize(Config::LABEL_FONT_SIZE);
+    inputText.setFillColor(Config::TEXT_COLOR);
+    inputText.setPosition(x + 8, y + height - 22);
+    inputText.setString("> ");
+}
+
+bool ConsolePanel::handleEvent(const sf::Event& event) {
+    // Toggle keys work whether or not the console is open
+    if (event.type == sf::Event::KeyPressed &&
+        (event.key.code == sf::Keyboard::F1 || event.key.code == sf::Keyboard::Tilde)) {
+        setOpen(!open);
+        return true;
+    }
+
+    if (!open) return false;
+
+    if (event.type == sf::Event::KeyPressed) {
+        switch (event.key.code) {
+            case sf::Keyboard::Escape:
+                setOpen(false);
+                return true;
+
+            case sf::Keyboard::Enter:
+                if (!inputString.empty()) {
+                    submitted = inputString;
+                    hasSubmission = true;
+                    history.push_back(inputString);
+                    historyIndex = static_cast<int>(history.size());
+                    print("> " + inputString);
+                    inputString.clear();
+                }
+                break;
+
+            case sf::Keyboard::Up:
+                if (historyIndex > 0) {
+                    inputString = history[--historyIndex];
+                }
+                break;
+
+            case sf::Keyboard::Down:
+                if (historyIndex < static_cast<int>(history.size())) {
+                    historyIndex++;
+                    inputString = historyIndex < static_cast<int>(history.size())
+                                ? history[historyIndex] : std::string();
+                }
+                break;
+
+            default:
+                break;
+        }
+        inputText.setString("> " + inputString);
+        return true;
+    }
+
+    if (event.type == sf::Event::TextEntered) {
+        if (event.text.unicode == 8) {  // Backspace
+            if (!inputString.empty()) inputString.pop_back();
+        }
+        // '`' and '~' are the toggle key, not part of the language
+        else if (event.text.unicode >= 32 && event.text.unicode < 127 &&
+                 event.text.unicode != '`' && event.text.unicode != '~') {
+            inputString += static_cast<char>(event.text.unicode);
+        }
+        inputText.setString("> " + inputString);
+        cursorBlinkTimer = 0;
+        cursorVisible = true;
+        return true;
+    }
+
+    return false;
+}
+
+void ConsolePanel::update(float deltaTime) {
+    if (open) {
+        cursorBlinkTimer += deltaTime;
+        if (cursorBlinkTimer >= 0.5f) {
+            cursorBlinkTimer = 0;
+            cursorVisible = !cursorVisible;
+        }
+    }
+}
+
+void ConsolePanel::draw(sf::RenderWindow& window) {
+    if (!open) return;
+
+    window.draw(background);
+    window.draw(inputBar);
+
+    // Newest lines at the bottom, as many as fit above the input bar
+    float lineHeight = Config::LABEL_FONT_SIZE + 4.0f;
+    float x = background.getPosition().x + 8;
+    float y = inputBar.getPosition().y - lineHeight - 2;
+    float top = background.getPosition().y + 4;
+
+    for (auto it = scrollback.rbegin(); it != scrollback.rend() && y >= top; ++it) {
+        lineText.setString(it->text.c_str());
+        lineText.setFillColor(it->isError ? Config::ERROR_COLOR : Config::TEXT_SECONDARY);
+        lineText.setPosition(x, y);
+        window.draw(lineText);
+        y -= lineHeight;
+    }
+
+    window.draw(inputText);
+
+    if (cursorVisible) {
+        sf::FloatRect bounds = inputText.getGlobalBounds();
+        sf::RectangleShape cursor(sf::Vector2f(2, Config::LABEL_FONT_SIZE + 2.0f));
+        cursor.setFillColor(Config::TEXT_COLOR);
+        cursor.setPosition(bounds.left + bounds.width + 3, inputBar.getPosition().y + 5);
+        window.draw(cursor);
+    }
+}
+
+void ConsolePanel::print(const std::string& text, bool isError) {
+    scrollback.push_back({TrackedString(text.data(), text.size()), isError});
+    while (scrollback.size() > MAX_LINES) {
+        scrollback.pop_front();
+    }
+}
+
+bool ConsolePanel::takeCommand(std::string& command) {
+    if (!hasSubmission) return false;
+    command = submitted;
+    hasSubmission = false;
+    return true;
+}
+
+bool ConsolePanel::isOpen() const {
+    return open;
+}
+
+void ConsolePanel::setOpen(bool isOpen) {
+    open = isOpen;
+    cursorBlinkTimer = 0;
+    cursorVisible = true;
+}
@@ -1,6 +1,6 @@
 // File: GUIElements.h
 // Description: Custom GUI elements built with SFML shapes.
-// Contains: Button, TextInput, Slider, and MessageBox classes.
+// Contains: Button, TextInput, Slider, MessageBox and ConsolePanel classes.
 // These are simple implementations suitable for a beginner-level project.
 
 #ifndef GUI_ELEMENTS_H
@@ -8,8 +8,11 @@
 
 #include <SFML/Graphics.hpp>
 #include <string>
+#include <vector>
+#include <deque>
 #include <functional>
 #include "Config.h"
+#include "MemoryAccount.h"
 
 // ============================================================================
 // BUTTON CLASS
@@ -52,9 +55,18 @@ public:
 // ============================================================================
 // A text field where users can type.
 // Click to focus, type to enter text.
-// Only accepts numeric input (for this BST project).
+// Accepts integers by default; setKind() switches to decimals or free text
+// (the typed-key mode).
 // ============================================================================
 class TextInput {
+public:
+    // Characters the field accepts
+    enum Kind {
+        INTEGER,        // Digits, minus sign at the start
+        DECIMAL,        // Also '.', 'e' / 'E' and a sign after the 'e'
+        TEXT            // Any printable ASCII
+    };
+
 private:
     sf::RectangleShape box;         // The input box
     sf::Text displayText;           // Text shown in the box
@@ -63,7 +75,8 @@ private:
     
     std::string inputString;        // The actual string content
     bool isFocused;                 // Is this input currently active?
-    bool numericOnly;               // Only allow numbers?
+    Kind kind;
+    size_t maxLength;
     
     // Cursor blink animation
     sf::RectangleShape cursor;
@@ -96,6 +109,9 @@ public:
     
     // Try to get input as integer. Returns true if valid, stores result.
     bool getAsInt(int& result) const;
+    
+    // Change what the field accepts and its length limit (clears it)
+    void setKind(Kind newKind, size_t newMaxLength);
 };
 
 // ============================================================================
@@ -182,5 +198,62 @@ public:
     bool isVisible() const;
 };
 
+// ============================================================================
+// CONSOLE PANEL CLASS
+// ============================================================================
+// A drop-down command console at the bottom of the visualization area.
+// F1 or ~ toggles it, Enter submits the line, Escape closes it.
+// Keeps a scrollback of output lines and a history of commands (Up/Down).
+// ============================================================================
+class ConsolePanel {
+private:
+    sf::RectangleShape background;
+    sf::RectangleShape inputBar;
+    sf::Text lineText;              // Reused for every scrollback line
+    sf::Text inputText;
+    sf::Font* font;
+
+    struct Line {
+        TrackedString text;
+        bool isError;
+    };
+    std::deque<Line, TrackingAllocator<Line, MemoryAccount::TEXT>> scrollback;
+    std::vector<std::string> history;
+    int historyIndex;               // == history.size() when not browsing
+
+    std::string inputString;
+    std::string submitted;          // Last submitted command (until taken)
+    bool open;
+    bool hasSubmission;
+
+    float cursorBlinkTimer;
+    bool cursorVisible;
+
+    static const size_t MAX_LINES = 200;
+
+public:
+    // Constructor: position, size, font
+    ConsolePanel(float x, float y, float width, float height, sf::Font& font);
+
+    // Handle events. Returns true if the event was consumed by the console
+    // (so the mode should not act on it, e.g. Escape while open).
+    bool handleEvent(const sf::Event& event);
+
+    // Update cursor blink animation
+    void update(float deltaTime);
+
+    // Draw if open
+    void draw(sf::RenderWindow& window);
+
+    // Append a line of output
+    void print(const std::string& text, bool isError = false);
+
+    // Fetch the command submitted with Enter. Returns false if there is none.
+    bool takeCommand(std::string& command);
+
+    bool isOpen() const;
+    void setOpen(bool isOpen);
+};
+
 #endif // GUI_ELEMENTS_H
 
@@ -0,0 +1,325 @@
+// File: HeadlessDriver.cpp
+// Description: Script-driven, window-less front end for the structures.
+
+#include "HeadlessDriver.h"
+#include "ControlServer.h"
+#include "StructureExporter.h"
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+// ============================================================================
+// CONSTRUCTOR & DESTRUCTOR
+// ============================================================================
+
+HeadlessDriver::HeadlessDriver(const HeadlessOptions& opts)
+    : bstAdapter(bst), avlAdapter(avl), listAdapter(list),
+      stackAdapter(stack), queueAdapter(queue), heapAdapter(heap),
+      scapegoatAdapter(scapegoat),
+      active(&bstAdapter), interpreter(bstAdapter), options(opts),
+      terminal(nullptr), errorCount(0)
+{
+    if (options.terminal) {
+        terminal = new TerminalRenderer(std::cout);
+    }
+
+    interpreter.setOutput([this](const std::string& message, bool isError) {
+        report(message, isError);
+    });
+    interpreter.setStructureSelector([this](StructureKind kind) {
+        active = adapterFor(kind);
+        return active;
+    });
+    interpreter.setOperationCallbacks(
+        [this](const std::string& op, int value) { beforeOperation(op, value); },
+        [this](const std::string& op, int value, bool success, const std::vector<int>& pathIds) {
+            afterOperation(op, value, success, pathIds);
+        });
+}
+
+HeadlessDriver::~HeadlessDriver() {
+    delete terminal;
+}
+
+// ============================================================================
+// ARGUMENT PARSING
+// ============================================================================
+
+bool HeadlessDriver::parseArguments(int argc, char* argv[], HeadlessOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            options.enabled = true;
+        } else if (arg == "--term") {
+            options.terminal = true;
+        } else if (arg == "--delay" && i + 1 < argc) {
+            options.stepDelayMs = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--control-socket" && i + 1 < argc) {
+            options.controlSocket = argv[++i];
+        } else if (arg == "--export" && i + 1 < argc) {
+            options.exportPath = argv[++i];
+            ExportFormat format;
+            if (!StructureExporter::formatFromPath(options.exportPath, format)) {
+                std::cerr << "--export needs a .dot or .json file name" << std::endl;
+                return false;
+            }
+        } else if (arg == "--check") {
+            options.checkInvariants = true;
+        } else if (arg == "--bench" && i + 1 < argc) {
+            options.benchmark = argv[++i];
+        } else if (arg == "--bench-size" && i + 1 < argc) {
+            options.benchmarkSize = static_cast<size_t>(std::max(0LL, std::atoll(argv[++i])));
+        } else if (arg == "--sketch" && i + 1 < argc) {
+            options.sketchPath = argv[++i];
+        } else if (arg == "--sort" && i + 2 < argc) {
+            options.sortInput = argv[++i];
+            options.sortOutput = argv[++i];
+        } else if (arg == "--sort-memory" && i + 1 < argc) {
+            options.sortMemoryMB = static_cast<size_t>(std::max(1LL, std::atoll(argv[++i])));
+        } else if (arg == "--script" && i + 1 < argc) {
+            options.scriptPath = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-') {
+            options.scriptPath = arg;
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// MAIN LOOP
+// ============================================================================
+
+int HeadlessDriver::run() {
+    std::ifstream file;
+    if (!options.scriptPath.empty()) {
+        file.open(options.scriptPath);
+        if (!file) {
+            std::cerr << "Could not open script: " << options.scriptPath << std::endl;
+            return 2;
+        }
+    }
+    std::istream& input = options.scriptPath.empty() ? std::cin : file;
+
+    // A control socket replaces stdin as the command source
+    bool readInput = options.controlSocket.empty() || !options.scriptPath.empty();
+
+    bool interactive = false;
+#if defined(__unix__) || defined(__APPLE__)
+    interactive = options.scriptPath.empty() && isatty(STDIN_FILENO);
+#endif
+
+    if (terminal) {
+        drawFrame(HighlightMap());
+    }
+
+    std::string line;
+    std::string chunk;
+    bool quit = !readInput;
+    while (!quit) {
+        if (interactive && terminal) {
+            // The prompt lives on the last row, which the renderer never uses.
+            // Pressing Enter scrolls the screen, so repaint fully afterwards.
+            std::cout << "\x1b[" << terminal->getRows() << ";1H\x1b[2K\x1b[?25h"
+                      << (chunk.empty() ? "> " : ". ") << std::flush;
+        } else if (interactive) {
+            std::cout << (chunk.empty() ? "> " : ". ") << std::flush;
+        }
+
+        if (!std::getline(input, line)) break;
+
+        if (interactive && terminal) {
+            terminal->invalidate();
+        }
+
+        std::istringstream first(line);
+        std::string word;
+        if (chunk.empty() && first >> word && (word == "quit" || word == "exit")) {
+            quit = true;
+            continue;
+        }
+
+        // Keep reading until every '{' has been closed
+        chunk += line + "\n";
+        if (!CommandInterpreter::needsMoreInput(chunk)) {
+            executeChunk(chunk);
+            chunk.clear();
+        }
+    }
+
+    if (!chunk.empty()) {
+        executeChunk(chunk);
+    }
+
+    if (!options.controlSocket.empty()) {
+        serveControlSocket();
+    }
+
+    if (!options.exportPath.empty()) {
+        ExportFormat format;
+        StructureExporter::formatFromPath(options.exportPath, format);
+        std::string error;
+        if (StructureExporter::exportStructure(*active, format, options.exportPath, error)) {
+            report("Exported to " + options.exportPath);
+        } else {
+            report("Error: " + error, true);
+        }
+    }
+
+    if (options.checkInvariants) {
+        checkAllStructures();
+    }
+
+    if (terminal) {
+        terminal->shutdown();
+    }
+    return errorCount > 0 ? 1 : 0;
+}
+
+void HeadlessDriver::executeChunk(const std::string& chunk) {
+    interpreter.run(chunk);
+
+    // One redraw for the whole chunk, however many operations it ran
+    if (terminal) {
+        drawFrame(HighlightMap());
+    }
+}
+
+void HeadlessDriver::checkAllStructures() {
+    StructureAdapter* adapters[] = {&bstAdapter, &avlAdapter, &listAdapter, &stackAdapter,
+                                    &queueAdapter, &heapAdapter, &scapegoatAdapter};
+    for (StructureAdapter* adapter : adapters) {
+        InvariantReport result = adapter->checkInvariants();
+        report(adapter->name() + ": " + result.summary(), !result.valid);
+    }
+}
+
+void HeadlessDriver::serveControlSocket() {
+    ControlServer server(options.controlSocket);
+    std::string error;
+    if (!server.start(error)) {
+        report("Error: " + error, true);
+        return;
+    }
+    report("Control socket listening on " + server.getPath());
+    if (terminal) {
+        drawFrame(HighlightMap());
+    }
+
+    ControlServer::SelectFn select = [this](StructureKind kind) { return adapterFor(kind); };
+    auto lastFrame = std::chrono::steady_clock::now();
+    bool dirty = false;
+
+    while (!server.shutdownRequested()) {
+        server.waitForCommands(50);
+
+        // Short slices while animating so the frame rate holds; ingest keeps
+        // queueing in the background either way
+        if (server.applyPending(active, select, terminal ? 15.0 : 100.0) > 0) {
+            dirty = true;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (terminal && dirty && now - lastFrame >= std::chrono::milliseconds(33)) {
+            status = "Control: " + std::to_string(server.getTotals().operations) + " operations";
+            drawFrame(HighlightMap());
+            lastFrame = now;
+            dirty = false;
+        }
+    }
+
+    const ControlServer::Totals& totals = server.getTotals();
+    report("Control: " + std::to_string(totals.operations) + " operations (ok " +
+           std::to_string(totals.succeeded) + ", failed " + std::to_string(totals.failed) + ")");
+    if (terminal) {
+        drawFrame(HighlightMap());
+    }
+}
+
+void HeadlessDriver::beforeOperation(const std::string& op, int value) {
+    // Animate the search first - the node is gone after the removal
+    if (!terminal || op != "delete") return;
+    StructureKind k = active->kind();
+    if (k == StructureKind::STACK || k == StructureKind::QUEUE) return;
+
+    std::vector<int> searchPath;
+    bool found = active->search(value, searchPath);
+    animatePath(searchPath, found ? searchPath.back() : -1, Config::NODE_DELETE_FILL);
+}
+
+void HeadlessDriver::afterOperation(const std::string& op, int /*value*/, bool success,
+                                    const std::vector<int>& pathIds) {
+    if (!terminal || pathIds.empty()) return;
+
+    if (op == "insert") {
+        animatePath(pathIds, pathIds.back(), success ? Config::NODE_NEW_FILL : Config::NODE_DELETE_FILL);
+    } else if (op == "search") {
+        animatePath(pathIds, success ? pathIds.back() : -1, Config::NODE_FOUND_FILL);
+    }
+}
+
+// ============================================================================
+// TERMINAL ANIMATION
+// ============================================================================
+
+void HeadlessDriver::drawFrame(const HighlightMap& highlights) {
+    StructureSnapshot snap;
+    active->snapshot(snap);
+
+    terminal->beginFrame();
+    terminal->drawSnapshot(snap, 0, highlights);
+    terminal->putText(terminal->getRows() - 2, 1, status,
+                      status.compare(0, 5, "Error") == 0 ? Config::ERROR_COLOR : Config::TEXT_COLOR);
+    terminal->present();
+}
+
+void HeadlessDriver::animatePath(const std::vector<int>& pathIds, int targetId,
+                                 const sf::Color& targetColor) {
+    HighlightMap highlights;
+    for (int id : pathIds) {
+        highlights[id] = Config::NODE_HIGHLIGHT_FILL;
+        drawFrame(highlights);
+        pause(options.stepDelayMs);
+    }
+    if (targetId >= 0) {
+        highlights[targetId] = targetColor;
+        drawFrame(highlights);
+        pause(options.stepDelayMs * 3);
+    }
+}
+
+void HeadlessDriver::pause(int milliseconds) {
+    if (milliseconds > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+    }
+}
+
+void HeadlessDriver::report(const std::string& message, bool isError) {
+    if (isError) errorCount++;
+    status = message;
+    if (!terminal) {
+        (isError ? std::cerr : std::cout) << message << std::endl;
+    }
+}
+
+StructureAdapter* HeadlessDriver::adapterFor(StructureKind kind) {
+    switch (kind) {
+        case StructureKind::BST: return &bstAdapter;
+        case StructureKind::AVL: return &avlAdapter;
+        case StructureKind::LINKED_LIST: return &listAdapter;
+        case StructureKind::STACK: return &stackAdapter;
+        case StructureKind::QUEUE: return &queueAdapter;
+        case StructureKind::MIN_HEAP: return &heapAdapter;
+        case StructureKind::SCAPEGOAT: return &scapegoatAdapter;
+    }
+    return &bstAdapter;
+}
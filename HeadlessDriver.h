@@ -0,0 +1,121 @@
+// File: HeadlessDriver.h
+// Description: Runs the visualizer without opening a window.
+// Commands are read from a script file (or stdin) and applied to one of
+// the data structures. With --term the operations are animated in the
+// terminal through TerminalRenderer; otherwise results are printed as text.
+//
+// Usage:
+//   DSVisualizer --headless [script.txt] [--term] [--delay MS] [--control-socket PATH]
+//                [--export FILE.dot|FILE.json] [--check]
+//
+// Scripts use the command language from CommandLanguage.h, plus 'quit'.
+// 'use bst|avl|list|stack|queue|heap|scapegoat' switches the active structure.
+// Single-value commands are animated step by step with --term; batches
+// (ranges, rand, loops) are applied at full speed and drawn once.
+//
+// With --control-socket the script (if any) runs first, then the driver
+// applies commands from socket clients (see ControlServer.h) until one of
+// them sends 'shutdown'. Without a script stdin is not read.
+// --export writes the active structure once everything else has finished.
+// --check then verifies the invariants of every structure (see
+// InvariantChecker.h); a broken one makes the exit code non-zero.
+
+#ifndef HEADLESS_DRIVER_H
+#define HEADLESS_DRIVER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "StructureAdapter.h"
+#include "TerminalRenderer.h"
+#include "CommandLanguage.h"
+
+// ============================================================================
+// HEADLESS OPTIONS
+// ============================================================================
+struct HeadlessOptions {
+    bool enabled;               // --headless was given
+    bool terminal;              // Animate with the ANSI renderer
+    int stepDelayMs;            // Delay per highlighted node
+    std::string scriptPath;     // Empty = read commands from stdin
+    std::string controlSocket;  // Unix socket path for ControlServer (optional)
+    std::string exportPath;     // Write the final structure here (.dot / .json)
+    bool checkInvariants;       // --check: verify all structures at the end
+    std::string benchmark;      // --bench NAME: run a benchmark instead (see Benchmarks.h)
+    size_t benchmarkSize;       // --bench-size N (0 = the benchmark's default)
+    std::string sketchPath;     // --sketch FILE: stream sketch report (see StreamSketch.h)
+    std::string sortInput;      // --sort IN OUT: external sort (see ExternalSort.h)
+    std::string sortOutput;
+    size_t sortMemoryMB;        // --sort-memory MB
+
+    HeadlessOptions()
+        : enabled(false), terminal(false), stepDelayMs(120), checkInvariants(false),
+          benchmarkSize(0), sortMemoryMB(256) {}
+};
+
+// ============================================================================
+// HEADLESS DRIVER CLASS
+// ============================================================================
+class HeadlessDriver {
+private:
+    // All structures live for the whole run, so switching back and forth
+    // with 'use' keeps their contents
+    BST bst;
+    AVLTree avl;
+    LinkedList list;
+    Stack stack;
+    Queue queue;
+    MinHeap heap;
+    ScapegoatTree scapegoat;
+
+    BSTAdapter bstAdapter;
+    AVLAdapter avlAdapter;
+    LinkedListAdapter listAdapter;
+    StackAdapter stackAdapter;
+    QueueAdapter queueAdapter;
+    MinHeapAdapter heapAdapter;
+    ScapegoatAdapter scapegoatAdapter;
+
+    StructureAdapter* active;
+    CommandInterpreter interpreter;
+    HeadlessOptions options;
+    TerminalRenderer* terminal;     // nullptr in plain text mode
+    std::string status;             // Last result, shown under the drawing
+    int errorCount;
+
+    // Execute one complete chunk of script (braces balanced)
+    void executeChunk(const std::string& chunk);
+
+    // Apply socket commands until a client asks to shut down
+    void serveControlSocket();
+    
+    // --check: report the invariant check of every structure
+    void checkAllStructures();
+
+    // Interpreter callbacks: animate single operations in the terminal
+    void beforeOperation(const std::string& op, int value);
+    void afterOperation(const std::string& op, int value, bool success,
+                        const std::vector<int>& pathIds);
+
+    // Terminal animation helpers
+    void drawFrame(const HighlightMap& highlights);
+    void animatePath(const std::vector<int>& pathIds, int targetId, const sf::Color& targetColor);
+    void pause(int milliseconds);
+
+    // Report a result (status line in terminal mode, stdout otherwise)
+    void report(const std::string& message, bool isError = false);
+
+    StructureAdapter* adapterFor(StructureKind kind);
+
+public:
+    explicit HeadlessDriver(const HeadlessOptions& opts);
+    ~HeadlessDriver();
+
+    // Run the script; returns the process exit code (non-zero on errors)
+    int run();
+
+    // Parse command-line flags. Returns false if the arguments are invalid.
+    static bool parseArguments(int argc, char* argv[], HeadlessOptions& options);
+};
+
+#endif // HEADLESS_DRIVER_H
@@ -0,0 +1,120 @@
+// File: HyperLogLog.cpp
+// Description: HyperLogLog implementation
+
+#include "HyperLogLog.h"
+#include "FilterHash.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const size_t BATCH_CHUNK = 256;
+
+    // Leading zeros of a non-zero 64-bit value
+    inline int leadingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(value);
+#else
+        int zeros = 0;
+        while (!(value & (uint64_t(1) << 63))) {
+            value <<= 1;
+            zeros++;
+        }
+        return zeros;
+#endif
+    }
+}
+
+HyperLogLog::HyperLogLog(int bits)
+    : precision(std::max(static_cast<int>(MIN_PRECISION), std::min(bits, static_cast<int>(MAX_PRECISION))))
+{
+    registers.assign(size_t(1) << precision, 0);
+}
+
+// ============================================================================
+// UPDATE
+// ============================================================================
+
+void HyperLogLog::addHashed(uint64_t hash) {
+    size_t index = static_cast<size_t>(hash >> (64 - precision));
+    // A guard bit below the remaining bits caps the rank at 64 - precision + 1
+    uint64_t rest = (hash << precision) | (uint64_t(1) << (precision - 1));
+    uint8_t rank = static_cast<uint8_t>(leadingZeros(rest) + 1);
+    if (rank > registers[index]) registers[index] = rank;
+}
+
+void HyperLogLog::add(int key) {
+    uint32_t h1, h2;
+    FilterHash::hash(key, h1, h2);
+    addHashed(FilterHash::combine(h1, h2));
+}
+
+void HyperLogLog::addBatch(const int* keys, size_t count) {
+    uint32_t h1[BATCH_CHUNK], h2[BATCH_CHUNK];
+    for (size_t offset = 0; offset < count; offset += BATCH_CHUNK) {
+        size_t n = std::min(BATCH_CHUNK, count - offset);
+        FilterHash::hashBatch(keys + offset, n, h1, h2);
+        for (size_t i = 0; i < n; i++) {
+            addHashed(FilterHash::combine(h1[i], h2[i]));
+        }
+    }
+}
+
+// ============================================================================
+// ESTIMATE
+// ============================================================================
+
+double HyperLogLog::estimate() const {
+    double m = static_cast<double>(registers.size());
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t value : registers) {
+        sum += std::ldexp(1.0, -value);
+        if (value == 0) zeros++;
+    }
+
+    double alpha;
+    switch (precision) {
+        case 4:  alpha = 0.673; break;
+        case 5:  alpha = 0.697; break;
+        case 6:  alpha = 0.709; break;
+        default: alpha = 0.7213 / (1.0 + 1.079 / m); break;
+    }
+    double raw = alpha * m * m / sum;
+
+    // Small range: linear counting is far more accurate while registers are empty
+    if (raw <= 2.5 * m && zeros > 0) {
+        return m * std::log(m / zeros);
+    }
+    // 64-bit hashes: no large-range correction needed
+    return raw;
+}
+
+double HyperLogLog::standardError() const {
+    return 1.04 / std::sqrt(static_cast<double>(registers.size()));
+}
+
+// ============================================================================
+// UTILITIES
+// ============================================================================
+
+bool HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.precision != precision) return false;
+    for (size_t i = 0; i < registers.size(); i++) {
+        registers[i] = std::max(registers[i], other.registers[i]);
+    }
+    return true;
+}
+
+void HyperLogLog::clear() {
+    std::fill(registers.begin(), registers.end(), 0);
+}
+
+void HyperLogLog::histogram(std::vector<size_t>& counts) const {
+    counts.assign(66, 0);
+    for (uint8_t value : registers) {
+        counts[value]++;
+    }
+    while (counts.size() > 1 && counts.back() == 0) {
+        counts.pop_back();
+    }
+}
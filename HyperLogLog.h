@@ -0,0 +1,51 @@
+// File: HyperLogLog.h
+// Description: HyperLogLog distinct-count estimator.
+// 2^precision one-byte registers. A key's 64-bit hash picks a register
+// with its top 'precision' bits; the register keeps the longest run of
+// leading zeros (+1) seen in the remaining bits. The harmonic mean of
+// 2^-register over all registers estimates the number of distinct keys
+// with a standard error of about 1.04 / sqrt(2^precision); small
+// cardinalities switch to linear counting over the empty registers.
+//
+// Merging two sketches of the same precision takes the per-register
+// maximum, which gives exactly the sketch of the combined stream.
+
+#ifndef HYPER_LOG_LOG_H
+#define HYPER_LOG_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class HyperLogLog {
+public:
+    static const int MIN_PRECISION = 4;
+    static const int MAX_PRECISION = 18;
+
+private:
+    std::vector<uint8_t> registers;
+    int precision;
+
+public:
+    explicit HyperLogLog(int precision = 14);
+
+    void add(int key);
+    void addHashed(uint64_t hash);      // FilterHash::combine(h1, h2)
+    void addBatch(const int* keys, size_t count);
+
+    double estimate() const;
+    double standardError() const;
+
+    // False (and nothing changes) if the precisions differ
+    bool merge(const HyperLogLog& other);
+    void clear();
+
+    int getPrecision() const { return precision; }
+    size_t getRegisterCount() const { return registers.size(); }
+    uint8_t getRegister(size_t index) const { return registers[index]; }
+
+    // counts[v] = number of registers holding v (for drawing)
+    void histogram(std::vector<size_t>& counts) const;
+};
+
+#endif // HYPER_LOG_LOG_H
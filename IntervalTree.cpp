@@ -0,0 +1,126 @@
+// File: IntervalTree.cpp
+// Description: Interval tree on the augmented AVL tree
+
+#include "IntervalTree.h"
+#include <sstream>
+
+IntervalTree::IntervalTree() : count(0) {}
+
+// ============================================================================
+// INSERT / DELETE
+// ============================================================================
+// The AVL tree rebalances and calls MaxEndpoint::update() on every node
+// whose subtree changed, so maxHigh is right again once it returns.
+// ============================================================================
+
+bool IntervalTree::insert(int low, int high, std::vector<IntervalNode*>& path) {
+    if (low > high) return false;
+    RotationType rotation;
+    bool success = tree.insert(Interval{low, high}, path, rotation);
+    if (success) count++;
+    return success;
+}
+
+bool IntervalTree::remove(int low, int high, std::vector<int>& pathIds) {
+    std::vector<IntervalNode*> path;
+    IntervalNode* deletedNode = nullptr;
+    RotationType rotation;
+    bool success = tree.remove(Interval{low, high}, path, deletedNode, rotation);
+    for (IntervalNode* node : path) {
+        pathIds.push_back(node->id);
+    }
+    delete deletedNode;
+    if (success) count--;
+    return success;
+}
+
+// ============================================================================
+// QUERIES
+// ============================================================================
+
+void IntervalTree::stab(int point, std::vector<IntervalNode*>& matches,
+                        std::vector<IntervalQueryStep>* trace) const {
+    overlap(point, point, matches, trace);
+}
+
+void IntervalTree::overlap(int low, int high, std::vector<IntervalNode*>& matches,
+                           std::vector<IntervalQueryStep>* trace) const {
+    // Explicit stack; the left child is pushed last so results come out
+    // roughly in order and the trace reads left to right
+    std::vector<IntervalNode*> stack;
+    if (IntervalNode* root = tree.getRoot()) stack.push_back(root);
+
+    while (!stack.empty()) {
+        IntervalNode* node = stack.back();
+        stack.pop_back();
+
+        // Every interval below ends before the query starts
+        if (node->maxHigh < low) {
+            if (trace) trace->push_back(IntervalQueryStep(IntervalQueryStep::PRUNED, node->id));
+            continue;
+        }
+
+        if (trace) trace->push_back(IntervalQueryStep(IntervalQueryStep::VISIT, node->id));
+        if (node->value.low <= high && node->value.high >= low) {
+            matches.push_back(node);
+            if (trace) trace->push_back(IntervalQueryStep(IntervalQueryStep::MATCH, node->id));
+        }
+
+        // Everything on the right starts at or after this node's low
+        if (node->right) {
+            if (node->value.low > high) {
+                if (trace) trace->push_back(IntervalQueryStep(IntervalQueryStep::PRUNED, node->right->id));
+            } else {
+                stack.push_back(node->right);
+            }
+        }
+        if (node->left) {
+            stack.push_back(node->left);
+        }
+    }
+}
+
+// ============================================================================
+// UTILITIES
+// ============================================================================
+
+void IntervalTree::clear() {
+    tree.clear();
+    count = 0;
+}
+
+bool IntervalTree::isEmpty() const {
+    return tree.isEmpty();
+}
+
+int IntervalTree::size() const {
+    return count;
+}
+
+IntervalNode* IntervalTree::getRoot() const {
+    return tree.getRoot();
+}
+
+int IntervalTree::getTreeHeight() const {
+    return tree.getTreeHeight();
+}
+
+std::string IntervalTree::toString() const {
+    std::ostringstream ss;
+    std::vector<IntervalNode*> stack;
+    IntervalNode* current = tree.getRoot();
+    bool first = true;
+    while (current || !stack.empty()) {
+        while (current) {
+            stack.push_back(current);
+            current = current->left;
+        }
+        current = stack.back();
+        stack.pop_back();
+        if (!first) ss << " ";
+        ss << "[" << current->value.low << "," << current->value.high << "]";
+        first = false;
+        current = current->right;
+    }
+    return ss.str();
+}
@@ -0,0 +1,103 @@
+// File: IntervalTree.h
+// Description: Interval tree - an AVL tree of closed intervals [low, high]
+// ordered by (low, high), where every node also stores the largest 'high'
+// in its subtree. It is a BasicAVLTree with the MaxEndpoint augmentation
+// (see AVLTree.h), so the balancing is the AVL tree's own. That one extra field lets stabbing and overlap queries
+// skip whole subtrees: if a subtree's max endpoint is left of the query,
+// nothing in it can overlap; if a node starts right of the query, neither
+// can anything in its right subtree.
+//
+// Queries visit O(log n) nodes plus the nodes that lead to the k results
+// (O(min(n, k log n)) in the worst case, close to O(log n + k) on typical
+// data). The optional trace records visited, matching and pruned nodes so
+// the GUI can show which subtrees were never looked at.
+
+#ifndef INTERVAL_TREE_H
+#define INTERVAL_TREE_H
+
+#include <vector>
+#include <string>
+#include "AVLTree.h"
+
+// ============================================================================
+// INTERVAL KEY AND AUGMENTATION
+// ============================================================================
+// Closed interval, ordered by low endpoint, then high endpoint
+struct Interval {
+    int low;
+    int high;
+
+    friend bool operator<(const Interval& a, const Interval& b) {
+        return a.low != b.low ? a.low < b.low : a.high < b.high;
+    }
+};
+
+// Node fields: the largest 'high' in the subtree rooted here
+struct MaxEndpoint {
+    int maxHigh;
+
+    template <typename Node>
+    static void update(Node* node) {
+        int largest = node->value.high;
+        if (node->left && node->left->maxHigh > largest) largest = node->left->maxHigh;
+        if (node->right && node->right->maxHigh > largest) largest = node->right->maxHigh;
+        node->maxHigh = largest;
+    }
+};
+
+typedef BasicAVLNode<Interval, MaxEndpoint> IntervalNode;
+
+// ============================================================================
+// QUERY TRACE
+// ============================================================================
+// What a query did, in visiting order
+struct IntervalQueryStep {
+    enum Kind {
+        VISIT,          // Node compared against the query
+        MATCH,          // Node's interval overlaps the query
+        PRUNED          // Whole subtree rooted at nodeId skipped
+    };
+
+    Kind kind;
+    int nodeId;
+
+    IntervalQueryStep(Kind k, int id) : kind(k), nodeId(id) {}
+};
+
+// ============================================================================
+// INTERVAL TREE CLASS
+// ============================================================================
+class IntervalTree {
+private:
+    BasicAVLTree<Interval, KeyCompare<Interval>, MaxEndpoint> tree;
+    int count;
+
+public:
+    IntervalTree();
+
+    // Insert [low, high]; fails for an exact duplicate or low > high
+    bool insert(int low, int high, std::vector<IntervalNode*>& path);
+
+    // Remove the interval [low, high]. 'pathIds' gets the ids on the search
+    // path (ids, not pointers: the removed node is freed).
+    bool remove(int low, int high, std::vector<int>& pathIds);
+
+    // All intervals containing 'point'
+    void stab(int point, std::vector<IntervalNode*>& matches,
+              std::vector<IntervalQueryStep>* trace = nullptr) const;
+
+    // All intervals overlapping [low, high]
+    void overlap(int low, int high, std::vector<IntervalNode*>& matches,
+                 std::vector<IntervalQueryStep>* trace = nullptr) const;
+
+    void clear();
+    bool isEmpty() const;
+    int size() const;
+    IntervalNode* getRoot() const;
+    int getTreeHeight() const;
+
+    // In-order as "[low,high] ..." (for display)
+    std::string toString() const;
+};
+
+#endif // INTERVAL_TREE_H
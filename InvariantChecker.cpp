@@ -0,0 +1,456 @@
+// File: InvariantChecker.cpp
+// Description: Full (parallel) and sampled integrity checks of the
+// structures. See InvariantChecker.h for the rules.
+
+#include "InvariantChecker.h"
+#include "AVLTree.h"
+#include "BST.h"
+#include "LinkedList.h"
+#include "MinHeap.h"
+#include "Queue.h"
+#include "ScapegoatTree.h"
+#include "Stack.h"
+#include "TaskPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+std::string InvariantReport::summary() const {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    if (valid) {
+        ss << "valid, " << nodesChecked << " nodes checked (" << elapsedMs << " ms)";
+    } else {
+        ss << "INVALID: " << error;
+    }
+    return ss.str();
+}
+
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// Pieces to cut a large structure into: about eight per pool thread
+size_t partCount(size_t nodes) {
+    TaskPool& pool = TaskPool::shared();
+    if (nodes < InvariantChecker::PARALLEL_MIN_NODES || pool.size() == 1) return 1;
+    return pool.size() * 8;
+}
+
+void runParts(size_t parts, const TaskPool::RangeFn& body) {
+    if (parts > 1) {
+        TaskPool::shared().parallelFor(parts, 1, body);
+    } else {
+        body(0, parts);
+    }
+}
+
+// Merge per-part reports in order, so the first problem reported is the
+// same however the parts were scheduled
+void mergeReports(const std::vector<InvariantReport>& parts, InvariantReport& report) {
+    for (const InvariantReport& part : parts) {
+        report.nodesChecked += part.nodesChecked;
+        if (!part.valid) report.fail(part.error);
+    }
+}
+
+// Ids are small non-negative ints handed out by a counter, so one bit per
+// possible id finds duplicates in O(n). Lists are marked in parallel.
+void checkUniqueIds(const std::vector<std::vector<int>>& idLists, InvariantReport& report) {
+    int largest = -1;
+    for (const std::vector<int>& ids : idLists) {
+        for (int id : ids) {
+            if (id < 0) {
+                report.fail("node id " + std::to_string(id) + " is negative");
+                return;
+            }
+            largest = std::max(largest, id);
+        }
+    }
+    if (largest < 0) return;
+
+    std::vector<std::atomic<uint64_t>> seen(static_cast<size_t>(largest) / 64 + 1);
+    std::vector<int> duplicates(idLists.size(), -1);
+    runParts(idLists.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            for (int id : idLists[i]) {
+                uint64_t bit = uint64_t(1) << (id & 63);
+                if (seen[id >> 6].fetch_or(bit, std::memory_order_relaxed) & bit) {
+                    duplicates[i] = id;
+                    break;
+                }
+            }
+        }
+    });
+    for (int id : duplicates) {
+        if (id >= 0) {
+            report.fail("node id " + std::to_string(id) + " is used twice");
+            return;
+        }
+    }
+}
+
+std::string describe(int id, int value) {
+    return "node #" + std::to_string(id) + " (" + std::to_string(value) + ")";
+}
+
+// ----------------------------------------------------------------------------
+// TREES
+// ----------------------------------------------------------------------------
+
+// What a tree check verifies besides key order and ids
+struct TreeRules {
+    bool heights;       // 'height' is 1 + the taller child's
+    bool balance;       // Child heights differ by at most one (AVL)
+};
+
+// A subtree whose keys must lie strictly between 'low' and 'high'
+template <typename NodeT>
+struct BoundedNode {
+    const NodeT* node;
+    long long low;
+    long long high;
+};
+
+template <typename NodeT>
+int heightOf(const NodeT* node) {
+    return node ? node->height : 0;
+}
+
+// The rules of one node, using its children's stored heights. Checking
+// every node this way also proves the stored heights right, bottom-up.
+template <typename NodeT>
+void checkTreeNode(const BoundedNode<NodeT>& entry, const TreeRules& rules, InvariantReport& report) {
+    const NodeT* node = entry.node;
+    if (node->value <= entry.low || node->value >= entry.high) {
+        report.fail(describe(node->id, node->value) + " is out of key order");
+        return;
+    }
+    if (!rules.heights) return;
+    int left = heightOf(node->left);
+    int right = heightOf(node->right);
+    if (node->height != 1 + std::max(left, right)) {
+        report.fail(describe(node->id, node->value) + " stores height " + std::to_string(node->height) +
+                    ", its children have " + std::to_string(left) + " and " + std::to_string(right));
+    } else if (rules.balance && std::abs(left - right) > 1) {
+        report.fail(describe(node->id, node->value) + " has balance factor " +
+                    std::to_string(left - right));
+    }
+}
+
+template <typename NodeT>
+void pushChildren(const BoundedNode<NodeT>& entry, std::vector<BoundedNode<NodeT>>& out) {
+    const NodeT* node = entry.node;
+    if (node->left) out.push_back(BoundedNode<NodeT>{node->left, entry.low, node->value});
+    if (node->right) out.push_back(BoundedNode<NodeT>{node->right, node->value, entry.high});
+}
+
+// Iterative, so a degenerate BST can't overflow the stack. More than
+// 'limit' nodes means a cycle or a wrong size; stop there.
+template <typename NodeT>
+void checkSubtree(const BoundedNode<NodeT>& start, const TreeRules& rules, size_t limit,
+                  InvariantReport& report, std::vector<int>& ids) {
+    std::vector<BoundedNode<NodeT>> stack;
+    stack.push_back(start);
+    while (!stack.empty() && report.valid) {
+        BoundedNode<NodeT> entry = stack.back();
+        stack.pop_back();
+        if (++report.nodesChecked > limit) {
+            report.fail("more nodes than the tree's size of " + std::to_string(limit) + " (a cycle?)");
+            return;
+        }
+        checkTreeNode(entry, rules, report);
+        ids.push_back(entry.node->id);
+        pushChildren(entry, stack);
+    }
+}
+
+template <typename NodeT>
+InvariantReport checkTree(const NodeT* root, size_t size, const TreeRules& rules) {
+    auto start = std::chrono::steady_clock::now();
+    InvariantReport report;
+    std::vector<BoundedNode<NodeT>> parts;
+    if (root) parts.push_back(BoundedNode<NodeT>{root, LLONG_MIN, LLONG_MAX});
+
+    // Check the top levels here, breadth-first, until there are enough
+    // subtrees below them to keep every thread busy. A few dozen levels at
+    // most: a degenerate BST stays one subtree however deep this goes.
+    std::vector<int> topIds;
+    size_t wanted = partCount(size);
+    for (int level = 0; level < 32 && parts.size() > 0 && parts.size() < wanted && report.valid; level++) {
+        std::vector<BoundedNode<NodeT>> next;
+        for (const BoundedNode<NodeT>& entry : parts) {
+            report.nodesChecked++;
+            checkTreeNode(entry, rules, report);
+            topIds.push_back(entry.node->id);
+            pushChildren(entry, next);
+        }
+        parts.swap(next);
+    }
+
+    std::vector<InvariantReport> partReports(parts.size());
+    std::vector<std::vector<int>> ids(parts.size() + 1);
+    ids[0].swap(topIds);
+    size_t limit = size;
+    runParts(parts.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            checkSubtree(parts[i], rules, limit, partReports[i], ids[i + 1]);
+        }
+    });
+    mergeReports(partReports, report);
+
+    if (report.valid && report.nodesChecked != size) {
+        report.fail("found " + std::to_string(report.nodesChecked) + " nodes, the tree's size is " +
+                    std::to_string(size));
+    }
+    if (report.valid) checkUniqueIds(ids, report);
+    report.elapsedMs = elapsedMs(start);
+    return report;
+}
+
+// Random root-to-leaf descents until the budget is used up
+template <typename NodeT>
+InvariantReport sampleTree(const NodeT* root, const TreeRules& rules, InvariantSampler& sampler) {
+    auto start = std::chrono::steady_clock::now();
+    InvariantReport report;
+    while (root && report.valid && report.nodesChecked < sampler.budget()) {
+        BoundedNode<NodeT> entry{root, LLONG_MIN, LLONG_MAX};
+        while (entry.node && report.valid && report.nodesChecked < sampler.budget()) {
+            report.nodesChecked++;
+            checkTreeNode(entry, rules, report);
+            const NodeT* node = entry.node;
+            if (sampler.nextBit()) {
+                entry = BoundedNode<NodeT>{node->left, entry.low, node->value};
+            } else {
+                entry = BoundedNode<NodeT>{node->right, node->value, entry.high};
+            }
+        }
+    }
+    report.elapsedMs = elapsedMs(start);
+    return report;
+}
+
+// ----------------------------------------------------------------------------
+// ARRAYS (heap, stack, queue)
+// ----------------------------------------------------------------------------
+
+// 'checkAt(index, node, report)' adds the structure's own rule for one
+// element; every element must exist and have a unique id
+template <typename NodeT, typename CheckAt>
+InvariantReport checkArray(const std::vector<NodeT*>& nodes, const CheckAt& checkAt) {
+    auto start = std::chrono::steady_clock::now();
+    InvariantReport report;
+    size_t parts = std::min(partCount(nodes.size()), std::max<size_t>(nodes.size(), 1));
+    std::vector<InvariantReport> partReports(parts);
+    std::vector<std::vector<int>> ids(parts);
+    runParts(parts, [&](size_t begin, size_t end) {
+        for (size_t part = begin; part < end; part++) {
+            size_t first = nodes.size() * part / parts;
+            size_t last = nodes.size() * (part + 1) / parts;
+            InvariantReport& partReport = partReports[part];
+            ids[part].reserve(last - first);
+            for (size_t i = first; i < last && partReport.valid; i++) {
+                partReport.nodesChecked++;
+                if (nodes[i] == nullptr) {
+                    partReport.fail("element " + std::to_string(i) + " is missing");
+                    break;
+                }
+                checkAt(i, nodes[i], partReport);
+                ids[part].push_back(nodes[i]->id);
+            }
+        }
+    });
+    mergeReports(partReports, report);
+    if (report.valid) checkUniqueIds(ids, report);
+    report.elapsedMs = elapsedMs(start);
+    return report;
+}
+
+template <typename NodeT, typename NodeAt, typename CheckAt>
+InvariantReport sampleArray(size_t count, const NodeAt& nodeAt, const CheckAt& checkAt,
+                            InvariantSampler& sampler) {
+    auto start = std::chrono::steady_clock::now();
+    InvariantReport report;
+    size_t samples = std::min(count, sampler.budget());
+    for (size_t s = 0; s < samples && report.valid; s++) {
+        size_t i = sampler.nextIndex(count);
+        const NodeT* node = nodeAt(i);
+        report.nodesChecked++;
+        if (node == nullptr) {
+            report.fail("element " + std::to_string(i) + " is missing");
+        } else {
+            checkAt(i, node, report);
+        }
+    }
+    report.elapsedMs = elapsedMs(start);
+    return report;
+}
+
+// Heap rule for element i: not smaller than its parent
+template <typename NodeAt>
+void checkHeapParent(size_t i, const HeapNode* node, const NodeAt& nodeAt, InvariantReport& report) {
+    if (i == 0) return;
+    const HeapNode* parent = nodeAt((i - 1) / 2);
+    if (parent && parent->value > node->value) {
+        report.fail(describe(node->id, node->value) + " at index " + std::to_string(i) +
+                    " is smaller than its parent " + describe(parent->id, parent->value));
+    }
+}
+
+// ----------------------------------------------------------------------------
+// LINKED LIST
+// ----------------------------------------------------------------------------
+
+// head, tail and size agree with each other; O(1)
+void checkListEnds(const LinkedList& list, InvariantReport& report) {
+    const ListNode* head = list.getHead();
+    const ListNode* tail = list.getTail();
+    if ((head == nullptr) != (list.getSize() == 0) || (tail == nullptr) != (list.getSize() == 0)) {
+        report.fail("head, tail and size " + std::to_string(list.getSize()) + " disagree");
+    } else if (tail && tail->next != nullptr) {
+        report.fail("the tail " + describe(tail->id, tail->value) + " has a next node");
+    }
+}
+
+// Walk at most 'limit' nodes from 'node', the node at position 'index' (0 is
+// the head). A walk that reaches the end must have seen exactly 'size' nodes
+// counting from the head and finished at the tail. Returns the node it
+// stopped at, nullptr at the end.
+const ListNode* walkList(const LinkedList& list, const ListNode* node, size_t index, size_t limit,
+                         InvariantReport& report, std::vector<int>* ids) {
+    const size_t size = static_cast<size_t>(list.getSize());
+    const ListNode* last = nullptr;
+    for (size_t walked = 0; node && walked < limit; walked++) {
+        if (++index > size) {
+            report.fail("more nodes than the list's size of " + std::to_string(size) + " (a cycle?)");
+            return nullptr;
+        }
+        report.nodesChecked++;
+        if (ids) ids->push_back(node->id);
+        last = node;
+        node = node->next;
+    }
+    if (node) return node;  // Stopped at the limit
+    if (index != size) {
+        report.fail("found " + std::to_string(index) + " nodes, the list's size is " +
+                    std::to_string(size));
+    } else if (last != nullptr && last != list.getTail()) {
+        report.fail("the last node " + describe(last->id, last->value) + " is not the tail");
+    }
+    return nullptr;
+}
+
+} // namespace
+
+// ============================================================================
+// FULL CHECKS
+// ============================================================================
+
+InvariantReport InvariantChecker::check(const BST& tree) {
+    return checkTree(tree.getRoot(), tree.getShapeStats().size(), TreeRules{true, false});
+}
+
+InvariantReport InvariantChecker::check(const AVLTree& tree) {
+    return checkTree(tree.getRoot(), tree.getShapeStats().size(), TreeRules{true, true});
+}
+
+InvariantReport InvariantChecker::check(const ScapegoatTree& tree) {
+    // Scapegoat nodes carry no height (see ScapegoatTree.h)
+    return checkTree(tree.getRoot(), static_cast<size_t>(tree.size()), TreeRules{false, false});
+}
+
+InvariantReport InvariantChecker::check(MinHeap& heap) {
+    std::vector<HeapNode*> nodes = heap.getAllNodes();
+    auto nodeAt = [&nodes](size_t i) { return nodes[i]; };
+    return checkArray(nodes, [&nodeAt](size_t i, const HeapNode* node, InvariantReport& report) {
+        checkHeapParent(i, node, nodeAt, report);
+    });
+}
+
+InvariantReport InvariantChecker::check(const LinkedList& list) {
+    // A list can only be walked in order, so this one runs on one thread
+    auto start = std::chrono::steady_clock::now();
+    InvariantReport report;
+    checkListEnds(list, report);
+    std::vector<std::vector<int>> ids(1);
+    if (report.valid) walkList(list, list.getHead(), 0, SIZE_MAX, report, &ids[0]);
+    if (report.valid) checkUniqueIds(ids, report);
+    report.elapsedMs = elapsedMs(start);
+    return report;
+}
+
+InvariantReport InvariantChecker::check(Stack& stack) {
+    return checkArray(stack.getAllNodes(), [](size_t, const StackNode*, InvariantReport&) {});
+}
+
+InvariantReport InvariantChecker::check(Queue& queue) {
+    return checkArray(queue.getAllNodes(), [](size_t, const QueueNode*, InvariantReport&) {});
+}
+
+// ============================================================================
+// SAMPLED CHECKS
+// ============================================================================
+
+InvariantReport InvariantChecker::sample(const BST& tree, InvariantSampler& sampler) {
+    return sampleTree(tree.getRoot(), TreeRules{true, false}, sampler);
+}
+
+InvariantReport InvariantChecker::sample(const AVLTree& tree, InvariantSampler& sampler) {
+    return sampleTree(tree.getRoot(), TreeRules{true, true}, sampler);
+}
+
+InvariantReport InvariantChecker::sample(const ScapegoatTree& tree, InvariantSampler& sampler) {
+    return sampleTree(tree.getRoot(), TreeRules{false, false}, sampler);
+}
+
+InvariantReport InvariantChecker::sample(MinHeap& heap, InvariantSampler& sampler) {
+    auto nodeAt = [&heap](size_t i) { return heap.getNode(static_cast<int>(i)); };
+    return sampleArray<HeapNode>(static_cast<size_t>(heap.getSize()), nodeAt,
+                                 [&nodeAt](size_t i, const HeapNode* node, InvariantReport& report) {
+                                     checkHeapParent(i, node, nodeAt, report);
+                                 },
+                                 sampler);
+}
+
+InvariantReport InvariantChecker::sample(const LinkedList& list, InvariantSampler& sampler) {
+    auto start = std::chrono::steady_clock::now();
+    InvariantReport report;
+    checkListEnds(list, report);
+
+    // Go on from the last walk while the list is unchanged, and from the
+    // head again once a walk reached the end
+    InvariantSampler::ListCursor& cursor = sampler.listCursor();
+    if (cursor.list != &list || cursor.version != list.getVersion() || cursor.node == nullptr) {
+        cursor.node = list.getHead();
+        cursor.index = 0;
+    }
+    const ListNode* stop = nullptr;
+    if (report.valid) stop = walkList(list, cursor.node, cursor.index, sampler.budget(), report, nullptr);
+    cursor.list = &list;
+    cursor.version = list.getVersion();
+    cursor.index = stop ? cursor.index + report.nodesChecked : 0;
+    cursor.node = stop;
+    report.elapsedMs = elapsedMs(start);
+    return report;
+}
+
+InvariantReport InvariantChecker::sample(Stack& stack, InvariantSampler& sampler) {
+    return sampleArray<StackNode>(static_cast<size_t>(stack.getSize()),
+                                  [&stack](size_t i) { return stack.getNode(static_cast<int>(i)); },
+                                  [](size_t, const StackNode*, InvariantReport&) {}, sampler);
+}
+
+InvariantReport InvariantChecker::sample(Queue& queue, InvariantSampler& sampler) {
+    return sampleArray<QueueNode>(static_cast<size_t>(queue.getSize()),
+                                  [&queue](size_t i) { return queue.getNode(static_cast<int>(i)); },
+                                  [](size_t, const QueueNode*, InvariantReport&) {}, sampler);
+}
@@ -0,0 +1,125 @@
+// File: InvariantChecker.h
+// Description: Integrity checks for every structure, for use after bulk
+// loads, trace replays and concurrent experiments:
+// - BST / AVL / scapegoat: key order (each key strictly inside the range
+//   its ancestors allow), node count against the tree's own size
+// - BST / AVL: stored heights; AVL also balance factors within -1..+1
+// - min-heap: every parent <= its children
+// - linked list: head / tail / size agree, the walk from the head ends at
+//   the tail, no cycle
+// - all structures: no missing node, node ids unique
+//
+// Every rule is local to a node and its children. So a tree can be cut into
+// independent subtrees: above PARALLEL_MIN_NODES the top levels are checked
+// on the calling thread and the subtrees below them run over TaskPool. Heaps,
+// stacks and queues are cut into index ranges the same way. Ids are marked
+// in a shared bitmap afterwards, also in parallel.
+//
+// The sampled mode checks at most InvariantSampler::budget() nodes per
+// call, so the GUI can run it every frame on any size: random root-to-leaf
+// descents in trees, random indices in heaps, stacks and queues. A list can
+// only be walked from the head, so for a list it checks the ends plus the
+// next stretch of nodes, going on where the last call stopped while the list
+// is unchanged; repeated calls cover the whole list. It cannot see duplicate
+// ids.
+//
+// Checks stop at the first problem and describe it in the report.
+
+#ifndef INVARIANT_CHECKER_H
+#define INVARIANT_CHECKER_H
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include "AVLTree.h"
+#include "BST.h"
+#include "MinHeap.h"
+
+class ScapegoatTree;
+class LinkedList;
+struct ListNode;
+class Stack;
+class Queue;
+
+// ============================================================================
+// INVARIANT REPORT
+// ============================================================================
+struct InvariantReport {
+    bool valid;
+    size_t nodesChecked;
+    std::string error;          // First problem found; empty when valid
+    double elapsedMs;
+
+    InvariantReport() : valid(true), nodesChecked(0), elapsedMs(0) {}
+
+    // Record a problem (only the first one is kept)
+    void fail(const std::string& message) {
+        if (valid) {
+            valid = false;
+            error = message;
+        }
+    }
+
+    // One line: "valid, 1000 nodes checked (0.4 ms)" or the problem
+    std::string summary() const;
+};
+
+// ============================================================================
+// INVARIANT SAMPLER
+// ============================================================================
+// State of the sampled mode, kept between frames
+class InvariantSampler {
+public:
+    // Where the last sampled list walk stopped. Only valid for that list at
+    // that version (see LinkedList::getVersion()).
+    struct ListCursor {
+        const LinkedList* list;
+        unsigned long long version;
+        const ListNode* node;       // Next node to check
+        size_t index;               // Its position, 0 for the head
+
+        ListCursor() : list(nullptr), version(0), node(nullptr), index(0) {}
+    };
+
+private:
+    std::mt19937 random;
+    size_t nodeBudget;
+    ListCursor cursor;
+
+public:
+    explicit InvariantSampler(size_t budget = 256) : random(12345), nodeBudget(budget) {}
+
+    size_t budget() const { return nodeBudget; }
+    bool nextBit() { return (random() & 1) != 0; }
+    size_t nextIndex(size_t count) { return count ? random() % count : 0; }
+    ListCursor& listCursor() { return cursor; }
+};
+
+// ============================================================================
+// INVARIANT CHECKER
+// ============================================================================
+class InvariantChecker {
+public:
+    // Fewer nodes than this are checked on the calling thread alone
+    static const size_t PARALLEL_MIN_NODES = 1 << 16;
+
+    // Full checks
+    static InvariantReport check(const BST& tree);
+    static InvariantReport check(const AVLTree& tree);
+    static InvariantReport check(const ScapegoatTree& tree);
+    static InvariantReport check(MinHeap& heap);
+    static InvariantReport check(const LinkedList& list);
+    static InvariantReport check(Stack& stack);
+    static InvariantReport check(Queue& queue);
+
+    // Sampled checks (see above)
+    static InvariantReport sample(const BST& tree, InvariantSampler& sampler);
+    static InvariantReport sample(const AVLTree& tree, InvariantSampler& sampler);
+    static InvariantReport sample(const ScapegoatTree& tree, InvariantSampler& sampler);
+    static InvariantReport sample(MinHeap& heap, InvariantSampler& sampler);
+    static InvariantReport sample(const LinkedList& list, InvariantSampler& sampler);
+    static InvariantReport sample(Stack& stack, InvariantSampler& sampler);
+    static InvariantReport sample(Queue& queue, InvariantSampler& sampler);
+};
+
+#endif // INVARIANT_CHECKER_H
@@ -0,0 +1,199 @@
+// File: KdTree.cpp
+// Description: Median-split build and pruned searches for KdTree
+
+#include "KdTree.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+    int coordinate(const KdPoint& point, int axis) {
+        return axis == 0 ? point.x : point.y;
+    }
+    int coordinate(const KdNode& node, int axis) {
+        return axis == 0 ? node.x : node.y;
+    }
+}
+
+// ============================================================================
+// BUILD
+// ============================================================================
+// Ranges are split at their median with nth_element (O(n) per level). The
+// work stack pops left halves first, so nodes are written in pre-order and
+// a left child always lands right after its parent.
+// ============================================================================
+
+void KdTree::build(const std::vector<KdPoint>& points) {
+    struct Task {
+        size_t lo, hi;      // Range in 'work'
+        int depth;
+        int parent;         // -1 for the root
+        bool isRight;
+    };
+
+    std::vector<KdPoint> work(points);
+    nodes.clear();
+    nodes.reserve(work.size());
+    height = 0;
+
+    std::vector<Task> stack;
+    if (!work.empty()) stack.push_back({0, work.size(), 0, -1, false});
+
+    while (!stack.empty()) {
+        Task task = stack.back();
+        stack.pop_back();
+
+        int axis = task.depth % 2;
+        size_t mid = task.lo + (task.hi - task.lo) / 2;
+        std::nth_element(work.begin() + task.lo, work.begin() + mid, work.begin() + task.hi,
+                         [axis](const KdPoint& a, const KdPoint& b) {
+                             return coordinate(a, axis) < coordinate(b, axis);
+                         });
+
+        int index = static_cast<int>(nodes.size());
+        nodes.push_back({work[mid].x, work[mid].y, -1, static_cast<uint8_t>(axis), false});
+        if (task.parent >= 0) {
+            if (task.isRight) nodes[task.parent].right = index;
+            else nodes[task.parent].hasLeft = true;
+        }
+        height = std::max(height, task.depth + 1);
+
+        if (mid + 1 < task.hi) stack.push_back({mid + 1, task.hi, task.depth + 1, index, true});
+        if (task.lo < mid) stack.push_back({task.lo, mid, task.depth + 1, index, false});
+    }
+}
+
+// ============================================================================
+// NEAREST NEIGHBOURS
+// ============================================================================
+// Depth-first, near side first. Each stacked subtree carries a lower bound
+// on its distance to the query (the squared distance to the splitting
+// lines crossed to reach it); once k candidates are known, subtrees whose
+// bound is no better than the k-th best are skipped.
+// ============================================================================
+
+void KdTree::nearest(int x, int y, int k, std::vector<KdNeighbor>& result,
+                     std::vector<KdQueryStep>* trace) const {
+    struct Entry {
+        int node;
+        long long bound;
+    };
+    auto farther = [](const KdNeighbor& a, const KdNeighbor& b) {
+        return a.distanceSquared < b.distanceSquared;
+    };
+
+    result.clear();
+    if (nodes.empty() || k <= 0) return;
+
+    // Max-heap of the best k so far (worst on top)
+    std::vector<KdNeighbor> best;
+    best.reserve(static_cast<size_t>(k) + 1);
+    std::vector<Entry> stack;
+    stack.push_back({0, 0});
+
+    while (!stack.empty()) {
+        Entry entry = stack.back();
+        stack.pop_back();
+
+        bool full = static_cast<int>(best.size()) == k;
+        if (full && entry.bound >= best.front().distanceSquared) {
+            if (trace) trace->push_back(KdQueryStep(KdQueryStep::PRUNED, entry.node));
+            continue;
+        }
+
+        const KdNode& node = nodes[entry.node];
+        if (trace) trace->push_back(KdQueryStep(KdQueryStep::VISIT, entry.node));
+
+        long long dx = static_cast<long long>(x) - node.x;
+        long long dy = static_cast<long long>(y) - node.y;
+        long long distance = dx * dx + dy * dy;
+        if (!full || distance < best.front().distanceSquared) {
+            if (full) {
+                std::pop_heap(best.begin(), best.end(), farther);
+                best.pop_back();
+            }
+            best.push_back({entry.node, distance});
+            std::push_heap(best.begin(), best.end(), farther);
+            if (trace) trace->push_back(KdQueryStep(KdQueryStep::MATCH, entry.node));
+        }
+
+        long long diff = node.axis == 0 ? dx : dy;
+        int left = node.hasLeft ? entry.node + 1 : -1;
+        int nearChild = diff <= 0 ? left : node.right;
+        int farChild = diff <= 0 ? node.right : left;
+
+        // Far side first so the near side is searched first
+        if (farChild >= 0) stack.push_back({farChild, std::max(entry.bound, diff * diff)});
+        if (nearChild >= 0) stack.push_back({nearChild, entry.bound});
+    }
+
+    std::sort_heap(best.begin(), best.end(), farther);
+    result.swap(best);
+}
+
+// ============================================================================
+// RANGE SEARCH
+// ============================================================================
+
+void KdTree::range(int minX, int minY, int maxX, int maxY, std::vector<int>& result,
+                   std::vector<KdQueryStep>* trace) const {
+    if (nodes.empty()) return;
+
+    std::vector<int> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+        const KdNode& node = nodes[index];
+        if (trace) trace->push_back(KdQueryStep(KdQueryStep::VISIT, index));
+
+        if (node.x >= minX && node.x <= maxX && node.y >= minY && node.y <= maxY) {
+            result.push_back(index);
+            if (trace) trace->push_back(KdQueryStep(KdQueryStep::MATCH, index));
+        }
+
+        // Left holds coordinates <= the split, right holds >= the split
+        int split = coordinate(node, node.axis);
+        int low = node.axis == 0 ? minX : minY;
+        int high = node.axis == 0 ? maxX : maxY;
+        int left = node.hasLeft ? index + 1 : -1;
+
+        if (node.right >= 0) {
+            if (high >= split) stack.push_back(node.right);
+            else if (trace) trace->push_back(KdQueryStep(KdQueryStep::PRUNED, node.right));
+        }
+        if (left >= 0) {
+            if (low <= split) stack.push_back(left);
+            else if (trace) trace->push_back(KdQueryStep(KdQueryStep::PRUNED, left));
+        }
+    }
+}
+
+// ============================================================================
+// UTILITIES
+// ============================================================================
+
+void KdTree::clear() {
+    nodes.clear();
+    height = 0;
+}
+
+bool KdTree::isEmpty() const {
+    return nodes.empty();
+}
+
+int KdTree::size() const {
+    return static_cast<int>(nodes.size());
+}
+
+int KdTree::getTreeHeight() const {
+    return height;
+}
+
+std::vector<KdPoint> KdTree::getPoints() const {
+    std::vector<KdPoint> points;
+    points.reserve(nodes.size());
+    for (const KdNode& node : nodes) {
+        points.push_back({node.x, node.y});
+    }
+    return points;
+}
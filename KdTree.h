@@ -0,0 +1,96 @@
+// File: KdTree.h
+// Description: 2-d tree of integer points built by median splits.
+// Nodes live in one flat array in pre-order: a node's left subtree follows
+// it directly and only the right child index is stored, so a search walks
+// forward through memory and the whole tree is a single allocation.
+// Levels alternate between splitting on x (even depth) and y (odd depth).
+//
+// The tree is built in one pass from a point set (O(n log n), balanced by
+// construction). Adding points means rebuilding - fine for the GUI sizes
+// and the usual way k-d trees are used for static data.
+//
+// Queries can record a trace (visited / matched / pruned subtrees) that the
+// GUI animates, together with the half-planes that were ruled out.
+
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#include <vector>
+#include <cstdint>
+#include "MemoryAccount.h"
+
+// ============================================================================
+// POINT & NODE STRUCTURES
+// ============================================================================
+struct KdPoint {
+    int x;
+    int y;
+};
+
+struct KdNode {
+    int x, y;
+    int right;          // Index of the right child, -1 if none
+    uint8_t axis;       // 0 = split on x, 1 = split on y
+    bool hasLeft;       // Left child (if any) is at index + 1
+};
+
+// ============================================================================
+// QUERY TRACE
+// ============================================================================
+struct KdQueryStep {
+    enum Kind {
+        VISIT,          // Node's point compared against the query
+        MATCH,          // Point is a result (range) or the new best (nearest)
+        PRUNED          // Subtree rooted at 'node' skipped: the region on the
+                        // far side of the parent's split can't contain results
+    };
+
+    Kind kind;
+    int node;           // Index into the node array
+
+    KdQueryStep(Kind k, int index) : kind(k), node(index) {}
+};
+
+// One nearest-neighbour result
+struct KdNeighbor {
+    int node;
+    long long distanceSquared;
+};
+
+// ============================================================================
+// KD TREE CLASS
+// ============================================================================
+class KdTree {
+private:
+    std::vector<KdNode, TrackingAllocator<KdNode, MemoryAccount::STRUCTURE_NODES>> nodes;
+    int height;
+
+public:
+    KdTree() : height(0) {}
+
+    // Replace the contents with 'points' (duplicates are kept)
+    void build(const std::vector<KdPoint>& points);
+
+    // The k points closest to (x, y), nearest first
+    void nearest(int x, int y, int k, std::vector<KdNeighbor>& result,
+                 std::vector<KdQueryStep>* trace = nullptr) const;
+
+    // Indices of all points inside the rectangle (inclusive bounds)
+    void range(int minX, int minY, int maxX, int maxY, std::vector<int>& result,
+               std::vector<KdQueryStep>* trace = nullptr) const;
+
+    void clear();
+    bool isEmpty() const;
+    int size() const;
+    int getTreeHeight() const;
+
+    // Node access for drawing (root is index 0)
+    const KdNode& getNode(int index) const { return nodes[index]; }
+    int leftChild(int index) const { return nodes[index].hasLeft ? index + 1 : -1; }
+    int rightChild(int index) const { return nodes[index].right; }
+
+    // All stored points, in node order
+    std::vector<KdPoint> getPoints() const;
+};
+
+#endif // KD_TREE_H
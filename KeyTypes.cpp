@@ -0,0 +1,154 @@
+// File: KeyTypes.cpp
+// Description: ShortKey storage and KeyFormat parsing / formatting
+
+#include "KeyTypes.h"
+#include "MemoryAccount.h"
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// ============================================================================
+// SHORT KEY
+// ============================================================================
+
+namespace {
+    // Heap buffers are whole words, so compareTail() can read a word past
+    // the last character
+    size_t heapBytes(size_t count) {
+        return (count + 7) & ~static_cast<size_t>(7);
+    }
+}
+
+void ShortKey::assign(const char* chars, size_t count) {
+    release();
+    length = static_cast<uint32_t>(count);
+    // Zero padding, so the bytes past the end compare as nothing
+    std::memset(storage, 0, INLINE_CAPACITY);
+    if (count <= INLINE_CAPACITY) {
+        std::memcpy(storage, chars, count);
+    } else {
+        // Long keys are counted with the nodes that hold them
+        size_t bytes = heapBytes(count);
+        char* heap = new char[bytes];
+        std::memset(heap + bytes - 8, 0, 8);
+        std::memcpy(heap, chars, count);
+        MemoryAccount::allocated(MemoryAccount::STRUCTURE_NODES, bytes);
+        std::memcpy(storage, &heap, sizeof(heap));
+        std::memcpy(storage + PREFIX_BYTES, chars + PREFIX_BYTES, INLINE_CAPACITY - PREFIX_BYTES);
+    }
+
+    // Big-endian, so comparing prefixes as integers orders like memcmp
+    prefixBits = 0;
+    size_t prefixLength = count < PREFIX_BYTES ? count : PREFIX_BYTES;
+    for (size_t i = 0; i < PREFIX_BYTES; i++) {
+        prefixBits <<= 8;
+        if (i < prefixLength) prefixBits |= static_cast<unsigned char>(chars[i]);
+    }
+}
+
+void ShortKey::release() {
+    if (!isInline()) {
+        MemoryAccount::released(MemoryAccount::STRUCTURE_NODES, heapBytes(length));
+        delete[] heapChars();
+    }
+    length = 0;
+    prefixBits = 0;
+}
+
+ShortKey::ShortKey(ShortKey&& other) noexcept : prefixBits(other.prefixBits), length(other.length) {
+    // Copying the storage moves either the inline bytes or the heap pointer
+    std::memcpy(storage, other.storage, INLINE_CAPACITY);
+    other.length = 0;
+    other.prefixBits = 0;
+}
+
+ShortKey& ShortKey::operator=(const ShortKey& other) {
+    if (this != &other) {
+        assign(other.data(), other.size());
+    }
+    return *this;
+}
+
+ShortKey& ShortKey::operator=(ShortKey&& other) noexcept {
+    if (this != &other) {
+        release();
+        prefixBits = other.prefixBits;
+        length = other.length;
+        std::memcpy(storage, other.storage, INLINE_CAPACITY);
+        other.length = 0;
+        other.prefixBits = 0;
+    }
+    return *this;
+}
+
+int ShortKey::compareTail(const ShortKey& a, const ShortKey& b) {
+    // The first 16 bytes (or all of a shorter key, padded with zeros)
+    // already match. The heap copies are zero padded to whole words and
+    // compared a word at a time. A word that runs past the shorter key
+    // compares its zeros against the longer key's bytes, and the shorter
+    // key orders first either way.
+    size_t common = a.length < b.length ? a.length : b.length;
+    if (common > INLINE_CAPACITY) {
+        // Both longer than INLINE_CAPACITY, so both on the heap
+        const char* aChars = a.heapChars();
+        const char* bChars = b.heapChars();
+        for (size_t offset = INLINE_CAPACITY; offset < common; offset += 8) {
+            uint64_t aWord = loadBigEndian(aChars + offset);
+            uint64_t bWord = loadBigEndian(bChars + offset);
+            if (aWord != bWord) return aWord < bWord ? -1 : 1;
+        }
+    }
+    return (a.length > b.length) - (a.length < b.length);
+}
+
+// ============================================================================
+// KEY FORMAT
+// ============================================================================
+
+bool KeyFormat<int>::parse(const std::string& text, int& key) {
+    long long wide;
+    if (!KeyFormat<long long>::parse(text, wide) || wide < INT32_MIN || wide > INT32_MAX) {
+        return false;
+    }
+    key = static_cast<int>(wide);
+    return true;
+}
+
+bool KeyFormat<long long>::parse(const std::string& text, long long& key) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    long long value = std::strtoll(text.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0') return false;
+    key = value;
+    return true;
+}
+
+bool KeyFormat<double>::parse(const std::string& text, double& key) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (*end != '\0' || !std::isfinite(value)) return false;
+    key = value;
+    return true;
+}
+
+std::string KeyFormat<double>::format(double key) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.6g", key);
+    return buffer;
+}
+
+bool KeyFormat<ShortKey>::parse(const std::string& text, ShortKey& key) {
+    if (text.empty()) return false;
+    key = ShortKey(text);
+    return true;
+}
+
+bool KeyFormat<std::string>::parse(const std::string& text, std::string& key) {
+    if (text.empty()) return false;
+    key = text;
+    return true;
+}
@@ -0,0 +1,201 @@
+// File: KeyTypes.h
+// Description: Key types and comparisons for the key-templated structures
+// (BasicAVLTree, BasicBST, BasicMinHeap):
+// - ShortKey: a string key for short ids. Keys of up to 16 bytes are stored
+//   inside the key itself, longer ones on the heap. The first 8 bytes are
+//   also cached as one big-endian integer, so most comparisons are a single
+//   64-bit compare that never touches the characters. Bytes 8..15 are kept
+//   inside the key at any length (a long key stores its heap pointer in
+//   place of bytes 0..7), so keys with a common 8-byte prefix such as
+//   "session:" still compare without reaching the heap. Only keys that
+//   share 16 bytes read further, a word at a time.
+// - KeyCompare<Key>: the default comparator (operator<; ShortKey uses its
+//   prefix compare)
+// - KeySearch<Key, Compare>: the three-way compare the tree uses, and
+//   whether a descent may run without branching on the comparisons. That is
+//   chosen at compile time: integer and floating-point keys compare in a
+//   couple of instructions, so their searches pick the next child with a
+//   conditional move and never mispredict. Other keys branch on a
+//   three-way compare, because one comparison costs more than a
+//   mispredicted branch.
+// - KeyFormat<Key>: parse / format for the GUI and the benchmarks
+//
+// Doubles are ordered by operator<, so NaN is not a valid key;
+// KeyFormat<double>::parse() rejects it.
+
+#ifndef KEY_TYPES_H
+#define KEY_TYPES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+// ============================================================================
+// SHORT KEY
+// ============================================================================
+class ShortKey {
+public:
+    static const size_t INLINE_CAPACITY = 16;
+    static const size_t PREFIX_BYTES = 8;
+
+private:
+    uint64_t prefixBits;        // First 8 bytes, big-endian, zero padded
+    uint32_t length;
+    // Bytes 8..15 of the key at [8, 16), zero padded, at any length. A key
+    // of up to INLINE_CAPACITY bytes holds bytes 0..7 at [0, 8) too; a
+    // longer one its heap pointer, and the whole key on the heap.
+    char storage[INLINE_CAPACITY];
+
+    char* heapChars() const {
+        char* chars;
+        std::memcpy(&chars, storage, sizeof(chars));
+        return chars;
+    }
+
+    // Bytes 8..15, big-endian, zero padded
+    uint64_t secondWord() const { return loadBigEndian(storage + PREFIX_BYTES); }
+
+    void assign(const char* chars, size_t count);
+    void release();
+
+    // Compare the bytes after the first 16 a word at a time, then the lengths
+    static int compareTail(const ShortKey& a, const ShortKey& b);
+
+public:
+    // 8 bytes as an integer that orders like memcmp
+    static uint64_t loadBigEndian(const char* bytes) {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__BYTE_ORDER__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        return __builtin_bswap64(word);
+#else
+        const unsigned char* b = reinterpret_cast<const unsigned char*>(bytes);
+        word = 0;
+        for (int i = 0; i < 8; i++) word = (word << 8) | b[i];
+        return word;
+#endif
+    }
+
+    ShortKey() : prefixBits(0), length(0) { std::memset(storage, 0, INLINE_CAPACITY); }
+    ShortKey(const char* chars, size_t count) : prefixBits(0), length(0) { assign(chars, count); }
+    explicit ShortKey(const std::string& text) : prefixBits(0), length(0) { assign(text.data(), text.size()); }
+    ShortKey(const ShortKey& other) : prefixBits(0), length(0) { assign(other.data(), other.size()); }
+    ShortKey(ShortKey&& other) noexcept;
+    ShortKey& operator=(const ShortKey& other);
+    ShortKey& operator=(ShortKey&& other) noexcept;
+    ~ShortKey() { release(); }
+
+    size_t size() const { return length; }
+    bool isInline() const { return length <= INLINE_CAPACITY; }
+    const char* data() const { return isInline() ? storage : heapChars(); }
+    uint64_t prefix() const { return prefixBits; }
+    std::string str() const { return std::string(data(), length); }
+
+    // <0, 0, >0 like memcmp (bytes compare as unsigned)
+    static int compare(const ShortKey& a, const ShortKey& b) {
+        if (a.prefixBits != b.prefixBits) {
+            return a.prefixBits < b.prefixBits ? -1 : 1;
+        }
+        uint64_t aWord = a.secondWord();
+        uint64_t bWord = b.secondWord();
+        if (aWord != bWord) {
+            return aWord < bWord ? -1 : 1;
+        }
+        return compareTail(a, b);
+    }
+
+    friend bool operator<(const ShortKey& a, const ShortKey& b) { return compare(a, b) < 0; }
+    friend bool operator==(const ShortKey& a, const ShortKey& b) {
+        return a.prefixBits == b.prefixBits && a.secondWord() == b.secondWord() &&
+               compareTail(a, b) == 0;
+    }
+};
+
+// ============================================================================
+// COMPARATORS
+// ============================================================================
+// Strict weak order, like std::less
+template <typename Key>
+struct KeyCompare {
+    bool operator()(const Key& a, const Key& b) const { return a < b; }
+};
+
+// Three-way compare and search strategy for a key / comparator pair
+template <typename Key, typename Compare>
+struct KeySearch {
+    static const bool BRANCHLESS = std::is_arithmetic<Key>::value;
+
+    static int compare(const Compare& less, const Key& a, const Key& b) {
+        return static_cast<int>(less(b, a)) - static_cast<int>(less(a, b));
+    }
+};
+
+template <>
+struct KeySearch<ShortKey, KeyCompare<ShortKey>> {
+    static const bool BRANCHLESS = false;
+
+    static int compare(const KeyCompare<ShortKey>&, const ShortKey& a, const ShortKey& b) {
+        return ShortKey::compare(a, b);
+    }
+};
+
+template <>
+struct KeySearch<std::string, KeyCompare<std::string>> {
+    static const bool BRANCHLESS = false;
+
+    static int compare(const KeyCompare<std::string>&, const std::string& a, const std::string& b) {
+        return a.compare(b);
+    }
+};
+
+// ============================================================================
+// KEY FORMAT
+// ============================================================================
+// name(): shown in the GUI; MAX_INPUT: longest text input accepted
+template <typename Key>
+struct KeyFormat;
+
+template <>
+struct KeyFormat<int> {
+    static const size_t MAX_INPUT = 11;
+    static const char* name() { return "int"; }
+    static bool parse(const std::string& text, int& key);
+    static std::string format(int key) { return std::to_string(key); }
+};
+
+template <>
+struct KeyFormat<long long> {
+    static const size_t MAX_INPUT = 20;
+    static const char* name() { return "int64"; }
+    static bool parse(const std::string& text, long long& key);
+    static std::string format(long long key) { return std::to_string(key); }
+};
+
+template <>
+struct KeyFormat<double> {
+    static const size_t MAX_INPUT = 24;
+    static const char* name() { return "double"; }
+    static bool parse(const std::string& text, double& key);        // Rejects NaN and inf
+    static std::string format(double key);                          // %.6g
+};
+
+template <>
+struct KeyFormat<ShortKey> {
+    static const size_t MAX_INPUT = 32;
+    static const char* name() { return "string"; }
+    static bool parse(const std::string& text, ShortKey& key);      // Any non-empty text
+    static std::string format(const ShortKey& key) { return key.str(); }
+};
+
+template <>
+struct KeyFormat<std::string> {
+    static const size_t MAX_INPUT = 32;
+    static const char* name() { return "std::string"; }
+    static bool parse(const std::string& text, std::string& key);   // Any non-empty text
+    static std::string format(const std::string& key) { return key; }
+};
+
+#endif // KEY_TYPES_H
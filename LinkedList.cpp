@@ -2,40 +2,43 @@
 // Description: Singly Linked List implementation.
 
 #include "LinkedList.h"
+#include "AllocationTracker.h"
 #include <sstream>
 
-LinkedList::LinkedList() : head(nullptr), tail(nullptr), nextNodeId(0), size(0) {}
+namespace {
+
+// Shared by all lists, so ids stay unique when nodes move between lists
+int nextListNodeId = 0;
+unsigned long long nextListVersion = 0;
+
+} // namespace
+
+LinkedList::LinkedList() : head(nullptr), tail(nullptr), size(0), version(++nextListVersion) {}
 
 LinkedList::~LinkedList() {
     clear();
 }
 
 bool LinkedList::insertAtTail(int value, std::vector<ListNode*>& path) {
-    ListNode* newNode = new ListNode(value, nextNodeId++);
+    AllocationTracker::Operation scope("List insert tail");
+    ListNode* newNode = new ListNode(value, nextListNodeId++);
     
     if (head == nullptr) {
-        // Empty list
         head = tail = newNode;
-        path.push_back(newNode);
     } else {
-        // Traverse to show animation path
-        ListNode* current = head;
-        while (current != nullptr) {
-            path.push_back(current);
-            current = current->next;
-        }
-        // Add at tail
         tail->next = newNode;
         tail = newNode;
-        path.push_back(newNode);
     }
     
+    path.push_back(newNode);
     size++;
+    markChanged();
     return true;
 }
 
 bool LinkedList::insertAtHead(int value, std::vector<ListNode*>& path) {
-    ListNode* newNode = new ListNode(value, nextNodeId++);
+    AllocationTracker::Operation scope("List insert head");
+    ListNode* newNode = new ListNode(value, nextListNodeId++);
     
     if (head == nullptr) {
         head = tail = newNode;
@@ -46,10 +49,12 @@ bool LinkedList::insertAtHead(int value, std::vector<ListNode*>& path) {
     
     path.push_back(newNode);
     size++;
+    markChanged();
     return true;
 }
 
 bool LinkedList::remove(int value, std::vector<ListNode*>& path, ListNode*& deletedNode) {
+    AllocationTracker::Operation scope("List delete");
     deletedNode = nullptr;
     
     if (head == nullptr) {
@@ -65,6 +70,7 @@ bool LinkedList::remove(int value, std::vector<ListNode*>& path, ListNode*& dele
             tail = nullptr;
         }
         size--;
+        markChanged();
         return true;
     }
     
@@ -83,6 +89,7 @@ bool LinkedList::remove(int value, std::vector<ListNode*>& path, ListNode*& dele
                 tail = prev;
             }
             size--;
+            markChanged();
             return true;
         }
         prev = current;
@@ -93,6 +100,7 @@ bool LinkedList::remove(int value, std::vector<ListNode*>& path, ListNode*& dele
 }
 
 ListNode* LinkedList::search(int value, std::vector<ListNode*>& path) {
+    AllocationTracker::Operation scope("List search");
     ListNode* current = head;
     
     while (current != nullptr) {
@@ -106,6 +114,98 @@ ListNode* LinkedList::search(int value, std::vector<ListNode*>& path) {
     return nullptr;
 }
 
+void LinkedList::traversalTo(const ListNode* node, std::vector<ListNode*>& path) const {
+    for (ListNode* current = head; current != nullptr; current = current->next) {
+        path.push_back(current);
+        if (current == node) {
+            return;
+        }
+    }
+}
+
+// ============================================================================
+// HANDLE-BASED OPERATIONS (O(1))
+// ============================================================================
+
+ListNode* LinkedList::insertAfter(ListNode* position, int value) {
+    AllocationTracker::Operation scope("List insert after");
+    ListNode* newNode = new ListNode(value, nextListNodeId++);
+    
+    if (position == nullptr) {
+        newNode->next = head;
+        head = newNode;
+    } else {
+        newNode->next = position->next;
+        position->next = newNode;
+    }
+    if (newNode->next == nullptr) {
+        tail = newNode;
+    }
+    
+    size++;
+    markChanged();
+    return newNode;
+}
+
+bool LinkedList::eraseAfter(ListNode* position, ListNode*& deletedNode) {
+    ListNode*& link = position == nullptr ? head : position->next;
+    deletedNode = link;
+    if (deletedNode == nullptr) {
+        return false;
+    }
+    
+    link = deletedNode->next;
+    if (deletedNode == tail) {
+        tail = position;
+    }
+    deletedNode->next = nullptr;
+    size--;
+    markChanged();
+    return true;
+}
+
+void LinkedList::spliceAfter(ListNode* position, LinkedList& other) {
+    if (&other == this || other.head == nullptr) {
+        return;
+    }
+    
+    ListNode*& link = position == nullptr ? head : position->next;
+    other.tail->next = link;
+    if (link == nullptr) {
+        tail = other.tail;
+    }
+    link = other.head;
+    size += other.size;
+    
+    other.head = other.tail = nullptr;
+    other.size = 0;
+    markChanged();
+    other.markChanged();
+}
+
+bool LinkedList::spliceAfter(ListNode* position, LinkedList& other, ListNode* otherPosition) {
+    ListNode* candidate = otherPosition == nullptr ? other.head : otherPosition->next;
+    if (candidate == nullptr) {
+        return false;
+    }
+    if (candidate == position) {
+        return true;            // Already right after itself
+    }
+    
+    ListNode* moved = nullptr;
+    other.eraseAfter(otherPosition, moved);
+    
+    ListNode*& link = position == nullptr ? head : position->next;
+    moved->next = link;
+    link = moved;
+    if (moved->next == nullptr) {
+        tail = moved;
+    }
+    size++;
+    markChanged();
+    return true;
+}
+
 bool LinkedList::contains(int value) {
     std::vector<ListNode*> path;
     return search(value, path) != nullptr;
@@ -120,6 +220,7 @@ void LinkedList::clear() {
     }
     head = tail = nullptr;
     size = 0;
+    markChanged();
 }
 
 bool LinkedList::isEmpty() const {
@@ -134,6 +235,18 @@ ListNode* LinkedList::getHead() const {
     return head;
 }
 
+ListNode* LinkedList::getTail() const {
+    return tail;
+}
+
+unsigned long long LinkedList::getVersion() const {
+    return version;
+}
+
+void LinkedList::markChanged() {
+    version = ++nextListVersion;
+}
+
 std::vector<ListNode*> LinkedList::getAllNodes() {
     std::vector<ListNode*> nodes;
     ListNode* current = head;
@@ -163,3 +276,18 @@ std::string LinkedList::toString() {
     return ss.str();
 }
 
+
+void LinkedList::loadValues(const std::vector<int>& values) {
+    clear();
+    for (int value : values) {
+        ListNode* newNode = new ListNode(value, nextListNodeId++);
+        if (head == nullptr) {
+            head = tail = newNode;
+        } else {
+            tail->next = newNode;
+            tail = newNode;
+        }
+        size++;
+    }
+    markChanged();
+}
@@ -1,17 +1,24 @@
 // File: LinkedList.h
 // Description: Singly Linked List data structure for visualization.
 // Supports insert at head/tail, delete, and search operations.
+//
+// Head and tail inserts are O(1). Node pointers double as handles:
+// insertAfter(), eraseAfter() and spliceAfter() work at a node the caller
+// already holds, also in O(1), so large lists can be edited without scans.
+// A nullptr handle means "before the head". Node ids come from one counter
+// shared by all lists, so nodes keep their ids when spliced between lists.
 
 #ifndef LINKEDLIST_H
 #define LINKEDLIST_H
 
 #include <vector>
 #include <string>
+#include "MemoryAccount.h"
 
 // ============================================================================
 // LINKED LIST NODE
 // ============================================================================
-struct ListNode {
+struct ListNode : TrackedAllocation<MemoryAccount::STRUCTURE_NODES> {
     int value;
     ListNode* next;
     
@@ -32,14 +39,18 @@ class LinkedList {
 private:
     ListNode* head;
     ListNode* tail;
-    int nextNodeId;
     int size;
+    unsigned long long version;
+    
+    // Give the list a new version after a change to its links
+    void markChanged();
 
 public:
     LinkedList();
     ~LinkedList();
     
-    // Insert at the end (tail)
+    // Insert at the end (tail) in O(1); 'path' receives the new node only.
+    // Call traversalTo() for the head-to-tail walk the animation can show.
     bool insertAtTail(int value, std::vector<ListNode*>& path);
     
     // Insert at the beginning (head)
@@ -51,6 +62,25 @@ public:
     // Search for a value
     ListNode* search(int value, std::vector<ListNode*>& path);
     
+    // Append the nodes from the head up to and including 'node' to 'path'
+    // (O(position), for animations only)
+    void traversalTo(const ListNode* node, std::vector<ListNode*>& path) const;
+    
+    // Insert a new node after 'position' (nullptr: at the head); returns it
+    ListNode* insertAfter(ListNode* position, int value);
+    
+    // Unlink the node after 'position' (nullptr: the head). The caller
+    // deletes 'deletedNode', as with remove(). False if there is none.
+    bool eraseAfter(ListNode* position, ListNode*& deletedNode);
+    
+    // Move every node of 'other' after 'position' (nullptr: to the front),
+    // leaving 'other' empty
+    void spliceAfter(ListNode* position, LinkedList& other);
+    
+    // Move the single node after 'otherPosition' in 'other' (nullptr: its
+    // head) to after 'position' in this list. False if there is none.
+    bool spliceAfter(ListNode* position, LinkedList& other, ListNode* otherPosition);
+    
     // Check if contains value
     bool contains(int value);
     
@@ -66,11 +96,22 @@ public:
     // Get head node
     ListNode* getHead() const;
     
+    // Get tail node
+    ListNode* getTail() const;
+    
+    // Changes whenever a node is added, removed or relinked. Versions are
+    // unique across lists, so a node pointer saved along with the list and
+    // its version is still valid while both match.
+    unsigned long long getVersion() const;
+    
     // Get all nodes
     std::vector<ListNode*> getAllNodes();
     
     // Get values as string
     std::string toString();
+    
+    // Replace the contents with 'values' (head first) in O(n)
+    void loadValues(const std::vector<int>& values);
 };
 
 #endif // LINKEDLIST_H
@@ -0,0 +1,64 @@
+// File: MemoryAccount.cpp
+// Description: Counter storage and reporting for MemoryAccount
+
+#include "MemoryAccount.h"
+#include <iomanip>
+#include <sstream>
+
+MemoryAccount::Counter MemoryAccount::counters[MemoryAccount::CATEGORY_COUNT];
+
+size_t MemoryAccount::totalBytes() {
+    size_t total = 0;
+    for (int c = 0; c < CATEGORY_COUNT; c++) {
+        total += bytes(static_cast<Category>(c));
+    }
+    return total;
+}
+
+void MemoryAccount::resetPeaks() {
+    for (Counter& counter : counters) {
+        counter.peak.store(counter.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+const char* MemoryAccount::name(Category category) {
+    switch (category) {
+        case STRUCTURE_NODES: return "structure nodes";
+        case NODE_VISUALS:    return "node visuals";
+        case EDGE_VISUALS:    return "edge visuals";
+        case ANIMATION_STEPS: return "animation steps";
+        case TEXT:            return "text";
+        case EXPORT_BUFFERS:  return "export buffers";
+        default:              return "?";
+    }
+}
+
+std::string MemoryAccount::formatBytes(size_t bytes) {
+    static const char* const UNITS[] = {"B", "KB", "MB", "GB", "TB"};
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (value >= 1024.0 && unit < 4) {
+        value /= 1024.0;
+        unit++;
+    }
+    std::ostringstream ss;
+    if (unit == 0) ss << bytes << " B";
+    else ss << std::fixed << std::setprecision(1) << value << " " << UNITS[unit];
+    return ss.str();
+}
+
+void MemoryAccount::print(std::ostream& out, bool withPeaks) {
+    out << "  " << std::left << std::setw(16) << "memory" << std::right
+        << std::setw(10) << "live" << std::setw(12) << "allocs";
+    if (withPeaks) out << std::setw(12) << "peak";
+    out << "\n";
+    for (int c = 0; c < CATEGORY_COUNT; c++) {
+        Category category = static_cast<Category>(c);
+        out << "  " << std::left << std::setw(16) << name(category) << std::right
+            << std::setw(10) << formatBytes(bytes(category)) << std::setw(12) << blocks(category);
+        if (withPeaks) out << std::setw(12) << formatBytes(peakBytes(category));
+        out << "\n";
+    }
+    out << "  " << std::left << std::setw(16) << "total" << std::right
+        << std::setw(10) << formatBytes(totalBytes()) << "\n";
+}
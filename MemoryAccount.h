@@ -0,0 +1,145 @@
+// File: MemoryAccount.h
+// Description: Live memory accounting per layer of the visualizer, so a
+// large data set that runs out of memory can be traced to the structure
+// itself, its visual state, queued animation steps, text or exports.
+//
+// The counters are fed by the allocations themselves, with one exception
+// noted below:
+// - TrackedAllocation<C> is a base for node types; its class-level
+//   operator new / delete count every node allocated with new.
+// - TrackingAllocator<T, C> is a standard allocator for containers
+//   (std::vector, std::deque, std::unordered_map, strings); it counts
+//   every block the container requests, buckets and growth slack included.
+// - The exception: PNG export's two sf::Image buffers live in SFML's own
+//   storage, so they are counted as width * height * 4 bytes each while
+//   the export runs. That part of EXPORT_BUFFERS is computed, not measured.
+// Counts are bytes requested from the allocator (malloc's own per-block
+// overhead is not visible here). They are atomic, so structures built on
+// TaskPool threads are counted too.
+//
+// The GUI shows the breakdown with F3; --bench prints it after each run.
+
+#ifndef MEMORY_ACCOUNT_H
+#define MEMORY_ACCOUNT_H
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <new>
+#include <string>
+
+// ============================================================================
+// MEMORY ACCOUNT
+// ============================================================================
+class MemoryAccount {
+public:
+    enum Category {
+        STRUCTURE_NODES,    // Nodes / blocks of the data structures
+        NODE_VISUALS,       // Per-node drawing state (positions, colors)
+        EDGE_VISUALS,       // Per-edge drawing state
+        ANIMATION_STEPS,    // Queued animation steps
+        TEXT,               // Cached labels and console text
+        EXPORT_BUFFERS,     // DOT / JSON write buffers; PNG capture by pixel size
+        CATEGORY_COUNT
+    };
+
+private:
+    struct Counter {
+        std::atomic<size_t> bytes;
+        std::atomic<size_t> blocks;
+        std::atomic<size_t> peak;
+    };
+    static Counter counters[CATEGORY_COUNT];
+
+public:
+    static void allocated(Category category, size_t bytes) {
+        Counter& counter = counters[category];
+        size_t now = counter.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        counter.blocks.fetch_add(1, std::memory_order_relaxed);
+        size_t peak = counter.peak.load(std::memory_order_relaxed);
+        while (now > peak && !counter.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void released(Category category, size_t bytes) {
+        counters[category].bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        counters[category].blocks.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Live bytes / allocations, and the largest byte count since resetPeaks()
+    static size_t bytes(Category category) { return counters[category].bytes.load(std::memory_order_relaxed); }
+    static size_t blocks(Category category) { return counters[category].blocks.load(std::memory_order_relaxed); }
+    static size_t peakBytes(Category category) { return counters[category].peak.load(std::memory_order_relaxed); }
+    static size_t totalBytes();
+
+    // Peaks restart from the current values
+    static void resetPeaks();
+
+    static const char* name(Category category);
+
+    // "512 B", "14.2 KB", "3.1 MB", ...
+    static std::string formatBytes(size_t bytes);
+
+    // One line per category: live bytes, allocations and (optionally) peak
+    static void print(std::ostream& out, bool withPeaks);
+};
+
+// ============================================================================
+// NODE BASE
+// ============================================================================
+// struct Node : TrackedAllocation<MemoryAccount::STRUCTURE_NODES> { ... };
+// Empty, so it adds nothing to the node's size.
+template <MemoryAccount::Category C>
+struct TrackedAllocation {
+    static void* operator new(size_t size) {
+        void* memory = ::operator new(size);
+        MemoryAccount::allocated(C, size);
+        return memory;
+    }
+
+    static void operator delete(void* memory, size_t size) noexcept {
+        MemoryAccount::released(C, size);
+        ::operator delete(memory);
+    }
+};
+
+// ============================================================================
+// CONTAINER ALLOCATOR
+// ============================================================================
+template <typename T, MemoryAccount::Category C>
+class TrackingAllocator {
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind {
+        typedef TrackingAllocator<U, C> other;
+    };
+
+    TrackingAllocator() noexcept {}
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U, C>&) noexcept {}
+
+    T* allocate(size_t count) {
+        T* memory = static_cast<T*>(::operator new(count * sizeof(T)));
+        MemoryAccount::allocated(C, count * sizeof(T));
+        return memory;
+    }
+
+    void deallocate(T* memory, size_t count) noexcept {
+        MemoryAccount::released(C, count * sizeof(T));
+        ::operator delete(memory);
+    }
+};
+
+template <typename T, typename U, MemoryAccount::Category C>
+bool operator==(const TrackingAllocator<T, C>&, const TrackingAllocator<U, C>&) { return true; }
+
+template <typename T, typename U, MemoryAccount::Category C>
+bool operator!=(const TrackingAllocator<T, C>&, const TrackingAllocator<U, C>&) { return false; }
+
+// Counted string for cached text
+typedef std::basic_string<char, std::char_traits<char>,
+                          TrackingAllocator<char, MemoryAccount::TEXT>> TrackedString;
+
+#endif // MEMORY_ACCOUNT_H
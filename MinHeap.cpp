@@ -2,38 +2,74 @@
 // Description: Min-Heap implementation with sift-up and sift-down
 
 #include "MinHeap.h"
+#include "AllocationTracker.h"
 #include <sstream>
 #include <algorithm>
 
-MinHeap::MinHeap() : nextNodeId(0) {}
+template <typename Key, typename Compare>
+BasicMinHeap<Key, Compare>::BasicMinHeap(const Compare& comparator) : nextNodeId(0), less(comparator) {}
 
-MinHeap::~MinHeap() {
+template <typename Key, typename Compare>
+BasicMinHeap<Key, Compare>::~BasicMinHeap() {
     clear();
 }
 
-void MinHeap::swap(int i, int j) {
+template <typename Key, typename Compare>
+void BasicMinHeap<Key, Compare>::swap(int i, int j) {
     HeapNode* temp = heap[i];
     heap[i] = heap[j];
     heap[j] = temp;
 }
 
-void MinHeap::insert(int value, std::vector<int>& siftPath) {
+template <typename Key, typename Compare>
+void BasicMinHeap<Key, Compare>::siftDown(int index, std::vector<int>& siftPath) {
+    int current = index;
+    while (true) {
+        int smallest = current;
+        int left = leftChild(current);
+        int right = rightChild(current);
+        
+        if (left < static_cast<int>(heap.size()) && 
+            less(heap[left]->value, heap[smallest]->value)) {
+            smallest = left;
+        }
+        
+        if (right < static_cast<int>(heap.size()) && 
+            less(heap[right]->value, heap[smallest]->value)) {
+            smallest = right;
+        }
+        
+        if (smallest != current) {
+            siftPath.push_back(smallest);
+            swap(current, smallest);
+            current = smallest;
+        } else {
+            break;
+        }
+    }
+}
+
+template <typename Key, typename Compare>
+void BasicMinHeap<Key, Compare>::insert(const Key& value, std::vector<int>& siftPath, int source) {
+    AllocationTracker::Operation scope("Heap insert");
     // Create new node and add at end
-    HeapNode* newNode = new HeapNode(value, nextNodeId++);
+    HeapNode* newNode = new HeapNode(value, nextNodeId++, source);
     heap.push_back(newNode);
     
     // Sift up to maintain heap property
     int current = static_cast<int>(heap.size()) - 1;
     siftPath.push_back(current);
     
-    while (current > 0 && heap[parent(current)]->value > heap[current]->value) {
+    while (current > 0 && less(heap[current]->value, heap[parent(current)]->value)) {
         swap(current, parent(current));
         current = parent(current);
         siftPath.push_back(current);
     }
 }
 
-HeapNode* MinHeap::extractMin(std::vector<int>& siftPath) {
+template <typename Key, typename Compare>
+typename BasicMinHeap<Key, Compare>::HeapNode* BasicMinHeap<Key, Compare>::extractMin(std::vector<int>& siftPath) {
+    AllocationTracker::Operation scope("Heap extract-min");
     if (heap.empty()) return nullptr;
     
     HeapNode* minNode = heap[0];
@@ -45,55 +81,46 @@ HeapNode* MinHeap::extractMin(std::vector<int>& siftPath) {
     
     if (!heap.empty()) {
         // Sift down to maintain heap property
-        int current = 0;
-        
-        while (true) {
-            int smallest = current;
-            int left = leftChild(current);
-            int right = rightChild(current);
-            
-            if (left < static_cast<int>(heap.size()) && 
-                heap[left]->value < heap[smallest]->value) {
-                smallest = left;
-            }
-            
-            if (right < static_cast<int>(heap.size()) && 
-                heap[right]->value < heap[smallest]->value) {
-                smallest = right;
-            }
-            
-            if (smallest != current) {
-                siftPath.push_back(smallest);
-                swap(current, smallest);
-                current = smallest;
-            } else {
-                break;
-            }
-        }
+        siftDown(0, siftPath);
     }
     
     return minNode;
 }
 
-HeapNode* MinHeap::peekMin() {
+template <typename Key, typename Compare>
+void BasicMinHeap<Key, Compare>::replaceMin(const Key& value, int source, std::vector<int>& siftPath) {
+    AllocationTracker::Operation scope("Heap replace-min");
+    if (heap.empty()) return;
+    heap[0]->value = value;
+    heap[0]->source = source;
+    siftPath.push_back(0);
+    siftDown(0, siftPath);
+}
+
+template <typename Key, typename Compare>
+typename BasicMinHeap<Key, Compare>::HeapNode* BasicMinHeap<Key, Compare>::peekMin() {
     return heap.empty() ? nullptr : heap[0];
 }
 
-int MinHeap::search(int value, std::vector<int>& searchPath) {
+template <typename Key, typename Compare>
+int BasicMinHeap<Key, Compare>::search(const Key& value, std::vector<int>& searchPath) {
+    AllocationTracker::Operation scope("Heap search");
     for (int i = 0; i < static_cast<int>(heap.size()); i++) {
         searchPath.push_back(i);
-        if (heap[i]->value == value) {
+        if (equivalent(heap[i]->value, value)) {
             return i;
         }
     }
     return -1;
 }
 
-bool MinHeap::remove(int value, std::vector<int>& siftPath) {
+template <typename Key, typename Compare>
+bool BasicMinHeap<Key, Compare>::remove(const Key& value, std::vector<int>& siftPath) {
+    AllocationTracker::Operation scope("Heap delete");
     // Find the value
     int index = -1;
     for (int i = 0; i < static_cast<int>(heap.size()); i++) {
-        if (heap[i]->value == value) {
+        if (equivalent(heap[i]->value, value)) {
             index = i;
             break;
         }
@@ -118,12 +145,12 @@ bool MinHeap::remove(int value, std::vector<int>& siftPath) {
             int right = rightChild(current);
             
             if (left < static_cast<int>(heap.size()) && 
-                heap[left]->value < heap[smallest]->value) {
+                less(heap[left]->value, heap[smallest]->value)) {
                 smallest = left;
             }
             
             if (right < static_cast<int>(heap.size()) && 
-                heap[right]->value < heap[smallest]->value) {
+                less(heap[right]->value, heap[smallest]->value)) {
                 smallest = right;
             }
             
@@ -137,7 +164,7 @@ bool MinHeap::remove(int value, std::vector<int>& siftPath) {
         }
         
         // Also try sift up in case new value is smaller than parent
-        while (current > 0 && heap[parent(current)]->value > heap[current]->value) {
+        while (current > 0 && less(heap[current]->value, heap[parent(current)]->value)) {
             swap(current, parent(current));
             current = parent(current);
             siftPath.push_back(current);
@@ -147,46 +174,73 @@ bool MinHeap::remove(int value, std::vector<int>& siftPath) {
     return true;
 }
 
-void MinHeap::clear() {
+template <typename Key, typename Compare>
+void BasicMinHeap<Key, Compare>::clear() {
     for (HeapNode* node : heap) {
         delete node;
     }
     heap.clear();
 }
 
-bool MinHeap::isEmpty() const {
+template <typename Key, typename Compare>
+bool BasicMinHeap<Key, Compare>::isEmpty() const {
     return heap.empty();
 }
 
-int MinHeap::getSize() const {
+template <typename Key, typename Compare>
+int BasicMinHeap<Key, Compare>::getSize() const {
     return static_cast<int>(heap.size());
 }
 
-std::vector<HeapNode*> MinHeap::getAllNodes() {
+template <typename Key, typename Compare>
+std::vector<typename BasicMinHeap<Key, Compare>::HeapNode*> BasicMinHeap<Key, Compare>::getAllNodes() {
     return heap;
 }
 
-HeapNode* MinHeap::getNode(int index) {
+template <typename Key, typename Compare>
+typename BasicMinHeap<Key, Compare>::HeapNode* BasicMinHeap<Key, Compare>::getNode(int index) {
     if (index >= 0 && index < static_cast<int>(heap.size())) {
         return heap[index];
     }
     return nullptr;
 }
 
-std::string MinHeap::toString() {
+template <typename Key, typename Compare>
+std::string BasicMinHeap<Key, Compare>::toString() {
     if (heap.empty()) return "[ Empty ]";
     
     std::ostringstream ss;
     ss << "[ ";
     for (size_t i = 0; i < heap.size(); i++) {
-        ss << heap[i]->value;
+        ss << KeyFormat<Key>::format(heap[i]->value);
         if (i < heap.size() - 1) ss << ", ";
     }
     ss << " ]";
     return ss.str();
 }
 
-bool MinHeap::isValidIndex(int index) const {
+template <typename Key, typename Compare>
+bool BasicMinHeap<Key, Compare>::isValidIndex(int index) const {
     return index >= 0 && index < static_cast<int>(heap.size());
 }
 
+
+template <typename Key, typename Compare>
+void BasicMinHeap<Key, Compare>::loadValues(const std::vector<Key>& values) {
+    clear();
+    heap.reserve(values.size());
+    for (const Key& value : values) {
+        heap.push_back(new HeapNode(value, nextNodeId++));
+    }
+}
+
+// ============================================================================
+// INSTANTIATIONS
+// ============================================================================
+// The key types the visualizer and the benchmarks use, as for BasicAVLTree
+
+template class BasicMinHeap<int>;
+template class BasicMinHeap<long long>;
+template class BasicMinHeap<double>;
+template class BasicMinHeap<std::string>;
+template class BasicMinHeap<ShortKey>;
@@ -2,33 +2,53 @@
 // Description: Min-Heap data structure (Priority Queue)
 // A complete binary tree where each parent is smaller than its children.
 // Supports insert (with sift-up) and extract-min (with sift-down).
+//
+// BasicMinHeap<Key, Compare> is templated on the key type like
+// BasicAVLTree; MinHeap is the int heap the visualizer, the k-way merge and
+// top-K use. The members are defined in MinHeap.cpp and instantiated there
+// for int, long long, double, std::string and ShortKey (see KeyTypes.h).
 
 #ifndef MINHEAP_H
 #define MINHEAP_H
 
 #include <vector>
 #include <string>
+#include "KeyTypes.h"
+#include "MemoryAccount.h"
 
 // ============================================================================
 // HEAP NODE STRUCTURE
 // ============================================================================
-struct HeapNode {
-    int value;
+template <typename Key>
+struct BasicHeapNode : TrackedAllocation<MemoryAccount::STRUCTURE_NODES> {
+    Key value;
     int id;
+    int source;         // Caller's tag, e.g. the run a merged value came from
     float x, y;
     float targetX, targetY;
     
-    HeapNode(int val, int nodeId) 
-        : value(val), id(nodeId), x(0), y(0), targetX(0), targetY(0) {}
+    BasicHeapNode(const Key& val, int nodeId, int tag = -1) 
+        : value(val), id(nodeId), source(tag), x(0), y(0), targetX(0), targetY(0) {}
 };
 
+typedef BasicHeapNode<int> HeapNode;
+
 // ============================================================================
 // MIN HEAP CLASS
 // ============================================================================
-class MinHeap {
+template <typename Key = int, typename Compare = KeyCompare<Key>>
+class BasicMinHeap {
+public:
+    typedef Key KeyType;
+    typedef BasicHeapNode<Key> HeapNode;
+
 private:
     std::vector<HeapNode*> heap;
     int nextNodeId;
+    Compare less;
+    
+    // Neither key orders before the other
+    bool equivalent(const Key& a, const Key& b) const { return !less(a, b) && !less(b, a); }
     
     // Get parent index
     int parent(int i) { return (i - 1) / 2; }
@@ -41,25 +61,36 @@ private:
     
     // Swap two elements
     void swap(int i, int j);
+    
+    // Move the element at 'index' down until both children are larger
+    void siftDown(int index, std::vector<int>& siftPath);
 
 public:
-    MinHeap();
-    ~MinHeap();
+    explicit BasicMinHeap(const Compare& comparator = Compare());
+    ~BasicMinHeap();
+    
+    BasicMinHeap(const BasicMinHeap&) = delete;
+    BasicMinHeap& operator=(const BasicMinHeap&) = delete;
     
     // Insert a value (sift-up animation path returned)
-    void insert(int value, std::vector<int>& siftPath);
+    void insert(const Key& value, std::vector<int>& siftPath, int source = -1);
     
     // Extract minimum (sift-down animation path returned)
     HeapNode* extractMin(std::vector<int>& siftPath);
     
+    // Overwrite the minimum with a new value and sift it down: one pass
+    // instead of extractMin() + insert(), and the node (with its id) is
+    // reused. The k-way merge calls this for every value it outputs.
+    void replaceMin(const Key& value, int source, std::vector<int>& siftPath);
+    
     // Peek at minimum without removing
     HeapNode* peekMin();
     
     // Search for a value (returns index, -1 if not found)
-    int search(int value, std::vector<int>& searchPath);
+    int search(const Key& value, std::vector<int>& searchPath);
     
     // Delete a specific value
-    bool remove(int value, std::vector<int>& siftPath);
+    bool remove(const Key& value, std::vector<int>& siftPath);
     
     // Clear heap
     void clear();
@@ -76,12 +107,17 @@ public:
     // Get node at index
     HeapNode* getNode(int index);
     
-    // Get heap as string
+    // Get heap as string (keys formatted by KeyFormat<Key>)
     std::string toString();
     
+    // Replace the contents with 'values' in array order (must be a valid heap)
+    void loadValues(const std::vector<Key>& values);
+    
     // Check if index is valid
     bool isValidIndex(int index) const;
 };
 
+typedef BasicMinHeap<> MinHeap;
+
 #endif // MINHEAP_H
 
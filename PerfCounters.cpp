@@ -0,0 +1,158 @@
+// File: PerfCounters.cpp
+// Description: perf_event_open wrappers for PerfCounters
+
+#include "PerfCounters.h"
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define PERF_COUNTERS_SUPPORTED 1
+#endif
+
+PerfCounters::Sample::Sample() {
+    for (int e = 0; e < EVENT_COUNT; e++) {
+        values[e] = 0;
+        valid[e] = false;
+    }
+}
+
+#ifdef PERF_COUNTERS_SUPPORTED
+
+namespace {
+    uint64_t cacheConfig(uint64_t cache, uint64_t op, uint64_t result) {
+        return cache | (op << 8) | (result << 16);
+    }
+
+    int openEvent(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+}
+
+PerfCounters::PerfCounters() {
+    static const struct {
+        uint32_t type;
+        uint64_t config;
+    } EVENTS[EVENT_COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                         PERF_COUNT_HW_CACHE_RESULT_MISS)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                         PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    };
+
+    int firstError = 0;
+    for (int e = 0; e < EVENT_COUNT; e++) {
+        fds[e] = openEvent(EVENTS[e].type, EVENTS[e].config);
+        if (fds[e] < 0 && firstError == 0) firstError = errno;
+    }
+
+    if (!available()) {
+        switch (firstError) {
+            case EACCES:
+            case EPERM:
+                reason = "perf events not permitted (container seccomp policy or "
+                         "/proc/sys/kernel/perf_event_paranoid)";
+                break;
+            case ENOENT:
+            case ENODEV:
+            case EOPNOTSUPP:
+                reason = "no hardware PMU exposed (virtual machine or container)";
+                break;
+            case ENOSYS:
+                reason = "kernel built without perf events";
+                break;
+            default:
+                reason = std::string("perf_event_open failed: ") + std::strerror(firstError);
+                break;
+        }
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds) {
+        if (fd >= 0) close(fd);
+    }
+}
+
+void PerfCounters::start() {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+PerfCounters::Sample PerfCounters::stop() {
+    for (int fd : fds) {
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    Sample sample;
+    for (int e = 0; e < EVENT_COUNT; e++) {
+        // value, time enabled, time running
+        uint64_t data[3];
+        if (fds[e] < 0 || read(fds[e], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) ||
+            data[2] == 0) {
+            continue;
+        }
+        sample.values[e] = data[2] < data[1]
+            ? static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2])
+            : data[0];
+        sample.valid[e] = true;
+    }
+    return sample;
+}
+
+#else
+
+PerfCounters::PerfCounters() : reason("hardware counters need Linux perf_event_open") {
+    for (int e = 0; e < EVENT_COUNT; e++) {
+        fds[e] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters() {}
+
+void PerfCounters::start() {}
+
+PerfCounters::Sample PerfCounters::stop() {
+    return Sample();
+}
+
+#endif // PERF_COUNTERS_SUPPORTED
+
+bool PerfCounters::available() const {
+    for (int fd : fds) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+const char* PerfCounters::name(Event event) {
+    switch (event) {
+        case CYCLES:        return "cycles";
+        case INSTRUCTIONS:  return "instr";
+        case L1D_MISSES:    return "L1D miss";
+        case LLC_MISSES:    return "LLC miss";
+        case BRANCH_MISSES: return "br miss";
+        case DTLB_MISSES:   return "dTLB miss";
+        default:            return "?";
+    }
+}
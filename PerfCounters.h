@@ -0,0 +1,74 @@
+// File: PerfCounters.h
+// Description: Hardware performance counters around a measured loop, read
+// through Linux perf_event_open: cycles, instructions, L1D / last-level
+// cache misses, branch misses and dTLB misses.
+//
+// Each counter is opened on its own, so a machine (or VM) that lacks one
+// event still reports the others. Containers often forbid perf events
+// altogether (seccomp, perf_event_paranoid); then available() is false,
+// unavailableReason() says why, and start() / stop() do nothing. Other
+// platforms always report unavailable.
+//
+// Counts cover the calling thread in user space only; work handed to
+// TaskPool threads is not included. When the kernel multiplexes more
+// events than the PMU has slots, counts are scaled up by
+// time enabled / time running.
+//
+// Usage:
+//   PerfCounters counters;
+//   counters.start();
+//   ... measured loop ...
+//   PerfCounters::Sample sample = counters.stop();
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+// ============================================================================
+// PERF COUNTERS
+// ============================================================================
+class PerfCounters {
+public:
+    enum Event {
+        CYCLES,
+        INSTRUCTIONS,
+        L1D_MISSES,         // L1 data cache read misses
+        LLC_MISSES,         // Last-level cache misses
+        BRANCH_MISSES,
+        DTLB_MISSES,        // Data TLB read misses
+        EVENT_COUNT
+    };
+
+    struct Sample {
+        uint64_t values[EVENT_COUNT];
+        bool valid[EVENT_COUNT];    // False if the event could not be opened
+
+        Sample();
+    };
+
+private:
+    int fds[EVENT_COUNT];           // -1 = not available
+    std::string reason;
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // True if at least one event could be opened
+    bool available() const;
+    bool available(Event event) const { return fds[event] >= 0; }
+    const std::string& unavailableReason() const { return reason; }
+
+    // Reset and enable all counters / disable them and read the counts
+    void start();
+    Sample stop();
+
+    static const char* name(Event event);
+};
+
+#endif // PERF_COUNTERS_H
@@ -2,6 +2,7 @@
 // Description: Queue (FIFO) implementation.
 
 #include "Queue.h"
+#include "AllocationTracker.h"
 #include <sstream>
 
 Queue::Queue() : nextNodeId(0) {}
@@ -11,12 +12,14 @@ Queue::~Queue() {
 }
 
 QueueNode* Queue::enqueue(int value) {
+    AllocationTracker::Operation scope("Queue enqueue");
     QueueNode* newNode = new QueueNode(value, nextNodeId++);
     elements.push_back(newNode);
     return newNode;
 }
 
 QueueNode* Queue::dequeue() {
+    AllocationTracker::Operation scope("Queue dequeue");
     if (elements.empty()) {
         return nullptr;
     }
@@ -41,6 +44,7 @@ QueueNode* Queue::peekRear() {
 }
 
 QueueNode* Queue::search(int value, std::vector<QueueNode*>& path) {
+    AllocationTracker::Operation scope("Queue search");
     // Search from front to rear
     for (size_t i = 0; i < elements.size(); i++) {
         path.push_back(elements[i]);
@@ -92,3 +96,18 @@ std::string Queue::toString() {
     return ss.str();
 }
 
+
+void Queue::loadValues(const std::vector<int>& values) {
+    clear();
+    elements.reserve(values.size());
+    for (int value : values) {
+        elements.push_back(new QueueNode(value, nextNodeId++));
+    }
+}
+
+QueueNode* Queue::getNode(int index) {
+    if (index >= 0 && index < static_cast<int>(elements.size())) {
+        return elements[index];
+    }
+    return nullptr;
+}
@@ -7,11 +7,12 @@
 
 #include <vector>
 #include <string>
+#include "MemoryAccount.h"
 
 // ============================================================================
 // QUEUE NODE
 // ============================================================================
-struct QueueNode {
+struct QueueNode : TrackedAllocation<MemoryAccount::STRUCTURE_NODES> {
     int value;
     int id;
     float x, y;
@@ -63,8 +64,14 @@ public:
     // Get all nodes (from front to rear)
     std::vector<QueueNode*> getAllNodes();
     
+    // Get node at index (0 = front) without copying the whole queue
+    QueueNode* getNode(int index);
+    
     // Get values as string
     std::string toString();
+    
+    // Replace the contents with 'values' (front first) in O(n)
+    void loadValues(const std::vector<int>& values);
 };
 
 #endif // QUEUE_H
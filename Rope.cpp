@@ -0,0 +1,515 @@
+// File: Rope.cpp
+// Description: Rope join / split, in-place leaf edits and file mapping
+
+#include "Rope.h"
+#include <algorithm>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ROPE_MMAP
+#endif
+
+const size_t Rope::LEAF_SIZE;     // Passed by reference to std::min
+
+namespace {
+
+int nextRopeNodeId = 0;
+
+int heightOf(const RopeNode* node) { return node ? node->height : 0; }
+size_t lengthOf(const RopeNode* node) { return node ? node->length : 0; }
+
+void update(RopeNode* node) {
+    node->length = node->left->length + node->right->length;
+    node->height = 1 + std::max(node->left->height, node->right->height);
+}
+
+RopeNode* newLeaf(const char* data, size_t length, bool mapped) {
+    RopeNode* leaf = new RopeNode();
+    leaf->left = leaf->right = nullptr;
+    leaf->length = length;
+    leaf->height = 1;
+    leaf->id = nextRopeNodeId++;
+    leaf->mapped = mapped ? data : nullptr;
+    if (!mapped) leaf->text.assign(data, length);
+    return leaf;
+}
+
+RopeNode* newInternal(RopeNode* left, RopeNode* right) {
+    RopeNode* node = new RopeNode();
+    node->left = left;
+    node->right = right;
+    node->id = nextRopeNodeId++;
+    node->mapped = nullptr;
+    update(node);
+    return node;
+}
+
+RopeNode* rotateRight(RopeNode* node) {
+    RopeNode* pivot = node->left;
+    node->left = pivot->right;
+    pivot->right = node;
+    update(node);
+    update(pivot);
+    return pivot;
+}
+
+RopeNode* rotateLeft(RopeNode* node) {
+    RopeNode* pivot = node->right;
+    node->right = pivot->left;
+    pivot->left = node;
+    update(node);
+    update(pivot);
+    return pivot;
+}
+
+RopeNode* rebalance(RopeNode* node) {
+    update(node);
+    int balance = node->left->height - node->right->height;
+    if (balance > 1) {
+        if (node->left->left->height < node->left->right->height) {
+            node->left = rotateLeft(node->left);
+        }
+        return rotateRight(node);
+    }
+    if (balance < -1) {
+        if (node->right->right->height < node->right->left->height) {
+            node->right = rotateRight(node->right);
+        }
+        return rotateLeft(node);
+    }
+    return node;
+}
+
+// ----------------------------------------------------------------------------
+// JOIN / SPLIT
+// ----------------------------------------------------------------------------
+
+// Concatenate two balanced trees
+RopeNode* joinTrees(RopeNode* left, RopeNode* right) {
+    if (!left) return right;
+    if (!right) return left;
+    if (left->height > right->height + 1) {
+        left->right = joinTrees(left->right, right);
+        return rebalance(left);
+    }
+    if (right->height > left->height + 1) {
+        right->left = joinTrees(left, right->left);
+        return rebalance(right);
+    }
+    return newInternal(left, right);
+}
+
+// Cut 'node' into [0, pos) and [pos, length); consumes 'node'
+void splitTree(RopeNode* node, size_t pos, RopeNode*& left, RopeNode*& right) {
+    if (!node) {
+        left = right = nullptr;
+        return;
+    }
+    if (pos == 0) {
+        left = nullptr;
+        right = node;
+        return;
+    }
+    if (pos >= node->length) {
+        left = node;
+        right = nullptr;
+        return;
+    }
+
+    if (node->isLeaf()) {
+        // Mapped leaves are sliced in place; owned text is copied in halves
+        const char* data = node->leafData();
+        bool mapped = node->mapped != nullptr;
+        left = newLeaf(data, pos, mapped);
+        right = newLeaf(data + pos, node->length - pos, mapped);
+        delete node;
+        return;
+    }
+
+    RopeNode* leftChild = node->left;
+    RopeNode* rightChild = node->right;
+    size_t leftLength = leftChild->length;
+    delete node;
+
+    if (pos < leftLength) {
+        RopeNode* middle;
+        splitTree(leftChild, pos, left, middle);
+        right = joinTrees(middle, rightChild);
+    } else if (pos > leftLength) {
+        RopeNode* middle;
+        splitTree(rightChild, pos - leftLength, middle, right);
+        left = joinTrees(leftChild, middle);
+    } else {
+        left = leftChild;
+        right = rightChild;
+    }
+}
+
+// Balanced tree over leaves[begin, end)
+RopeNode* buildBalanced(const std::vector<RopeNode*>& leaves, size_t begin, size_t end) {
+    if (begin >= end) return nullptr;
+    if (end - begin == 1) return leaves[begin];
+    size_t middle = begin + (end - begin) / 2;
+    return newInternal(buildBalanced(leaves, begin, middle), buildBalanced(leaves, middle, end));
+}
+
+RopeNode* buildFromText(const char* data, size_t length, bool mapped) {
+    std::vector<RopeNode*> leaves;
+    leaves.reserve(length / Rope::LEAF_SIZE + 1);
+    for (size_t offset = 0; offset < length; offset += Rope::LEAF_SIZE) {
+        leaves.push_back(newLeaf(data + offset, std::min(Rope::LEAF_SIZE, length - offset), mapped));
+    }
+    return buildBalanced(leaves, 0, leaves.size());
+}
+
+const RopeNode* edgeLeaf(const RopeNode* node, bool rightmost) {
+    while (!node->isLeaf()) node = rightmost ? node->right : node->left;
+    return node;
+}
+
+// joinTrees(), but when the two leaves meeting at the seam fit into one
+// chunk they are merged. Every edit ends with this join, so the pieces an
+// edit cuts off are folded back into their neighbours instead of piling up
+// as tiny leaves.
+RopeNode* joinMerged(RopeNode* left, RopeNode* right) {
+    if (!left || !right) return left ? left : right;
+    const RopeNode* last = edgeLeaf(left, true);
+    const RopeNode* first = edgeLeaf(right, false);
+    if (last->length + first->length > Rope::LEAF_SIZE) return joinTrees(left, right);
+
+    // Cuts at leaf boundaries only free internal nodes
+    RopeNode* leftRest;
+    RopeNode* lastLeaf;
+    RopeNode* firstLeaf;
+    RopeNode* rightRest;
+    splitTree(left, left->length - last->length, leftRest, lastLeaf);
+    splitTree(right, first->length, firstLeaf, rightRest);
+
+    std::string text;
+    text.reserve(lastLeaf->length + firstLeaf->length);
+    text.append(lastLeaf->leafData(), lastLeaf->length);
+    text.append(firstLeaf->leafData(), firstLeaf->length);
+    delete lastLeaf;
+    delete firstLeaf;
+    return joinTrees(joinTrees(leftRest, newLeaf(text.data(), text.size(), false)), rightRest);
+}
+
+// Leaf holding 'offset' (updated to the offset inside it); 'path' gets the
+// internal nodes above it. At a leaf boundary 'preferLeft' picks the
+// leaf that ends there rather than the one that starts there.
+RopeNode* findLeaf(RopeNode* node, size_t& offset, std::vector<RopeNode*>& path, bool preferLeft) {
+    while (!node->isLeaf()) {
+        path.push_back(node);
+        size_t leftLength = node->left->length;
+        if (offset < leftLength || (preferLeft && offset == leftLength)) {
+            node = node->left;
+        } else {
+            offset -= leftLength;
+            node = node->right;
+        }
+    }
+    return node;
+}
+
+// Copy a mapped leaf's bytes so it can be edited in place
+void makeOwned(RopeNode* leaf) {
+    if (leaf->mapped) {
+        leaf->text.assign(leaf->mapped, leaf->length);
+        leaf->mapped = nullptr;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// MAPPED TEXT FILE
+// ============================================================================
+
+MappedTextFile::MappedTextFile() : bytes(nullptr), count(0), mapping(nullptr) {}
+
+MappedTextFile::~MappedTextFile() {
+#ifdef ROPE_MMAP
+    if (mapping) munmap(mapping, count);
+#endif
+}
+
+bool MappedTextFile::open(const std::string& path, std::string& error) {
+#ifdef ROPE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "Could not open " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        error = "Could not read " + path;
+        return false;
+    }
+    if (info.st_size > 0) {
+        void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            error = "Could not map " + path;
+            return false;
+        }
+        mapping = address;
+        count = static_cast<size_t>(info.st_size);
+        bytes = static_cast<const char*>(address);
+    }
+    ::close(fd);                    // The mapping stays valid
+    return true;
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        error = "Could not open " + path;
+        return false;
+    }
+    owned.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(&owned[0], static_cast<std::streamsize>(owned.size()));
+    bytes = owned.data();
+    count = owned.size();
+    return true;
+#endif
+}
+
+// ============================================================================
+// CONSTRUCTION
+// ============================================================================
+
+Rope::Rope() : root(nullptr) {}
+
+Rope::Rope(const std::string& text) : root(buildFromText(text.data(), text.size(), false)) {}
+
+Rope::~Rope() {
+    clear();
+}
+
+Rope::Rope(Rope&& other) : root(other.root), files(std::move(other.files)) {
+    other.root = nullptr;
+    other.files.clear();
+}
+
+Rope& Rope::operator=(Rope&& other) {
+    if (this != &other) {
+        clear();
+        root = other.root;
+        files = std::move(other.files);
+        other.root = nullptr;
+        other.files.clear();
+    }
+    return *this;
+}
+
+void Rope::destroy(RopeNode* node) {
+    std::vector<RopeNode*> stack;
+    if (node) stack.push_back(node);
+    while (!stack.empty()) {
+        RopeNode* current = stack.back();
+        stack.pop_back();
+        if (current->left) stack.push_back(current->left);
+        if (current->right) stack.push_back(current->right);
+        delete current;
+    }
+}
+
+void Rope::clear() {
+    destroy(root);
+    root = nullptr;
+    files.clear();
+}
+
+bool Rope::loadFile(const std::string& path, std::string& error) {
+    std::shared_ptr<MappedTextFile> file = std::make_shared<MappedTextFile>();
+    if (!file->open(path, error)) return false;
+    clear();
+    root = buildFromText(file->data(), file->size(), true);
+    if (root) files.push_back(file);
+    return true;
+}
+
+bool Rope::saveFile(const std::string& path, std::string& error) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "Could not create " + path;
+        return false;
+    }
+    // In-order leaf walk; each leaf is written straight from its storage
+    std::vector<const RopeNode*> stack;
+    const RopeNode* current = root;
+    while ((current || !stack.empty()) && out) {
+        while (current) {
+            stack.push_back(current);
+            current = current->left;
+        }
+        current = stack.back();
+        stack.pop_back();
+        if (current->isLeaf()) {
+            out.write(current->leafData(), static_cast<std::streamsize>(current->length));
+        }
+        current = current->right;
+    }
+    if (!out) {
+        error = "Could not write " + path;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// EDITING
+// ============================================================================
+
+void Rope::insert(size_t pos, const std::string& text) {
+    if (text.empty()) return;
+    pos = std::min(pos, length());
+
+    // Fast path: the leaf at 'pos' has room (a mapped one is copied first)
+    if (root) {
+        std::vector<RopeNode*> path;
+        size_t offset = pos;
+        RopeNode* leaf = findLeaf(root, offset, path, true);
+        if (leaf->length + text.size() <= LEAF_SIZE) {
+            makeOwned(leaf);
+            leaf->text.insert(offset, text.data(), text.size());
+            leaf->length = leaf->text.size();
+            for (RopeNode* ancestor : path) ancestor->length += text.size();
+            return;
+        }
+    }
+
+    RopeNode* left;
+    RopeNode* right;
+    splitTree(root, pos, left, right);
+    root = joinMerged(joinMerged(left, buildFromText(text.data(), text.size(), false)), right);
+}
+
+void Rope::erase(size_t pos, size_t count) {
+    size_t total = length();
+    if (pos >= total || count == 0) return;
+    count = std::min(count, total - pos);
+
+    // Fast path: the range lies inside one leaf and doesn't empty it
+    std::vector<RopeNode*> path;
+    size_t offset = pos;
+    RopeNode* leaf = findLeaf(root, offset, path, false);
+    if (offset + count <= leaf->length && count < leaf->length) {
+        makeOwned(leaf);
+        leaf->text.erase(offset, count);
+        leaf->length = leaf->text.size();
+        for (RopeNode* ancestor : path) ancestor->length -= count;
+        return;
+    }
+
+    RopeNode* left;
+    RopeNode* rest;
+    RopeNode* middle;
+    RopeNode* right;
+    splitTree(root, pos, left, rest);
+    splitTree(rest, count, middle, right);
+    destroy(middle);
+    root = joinMerged(left, right);
+    if (!root) files.clear();
+}
+
+Rope Rope::split(size_t pos) {
+    Rope tail;
+    RopeNode* left;
+    RopeNode* right;
+    splitTree(root, std::min(pos, length()), left, right);
+    root = left;
+    tail.root = right;
+    if (right) tail.files = files;
+    if (!left) files.clear();
+    return tail;
+}
+
+void Rope::concat(Rope& other) {
+    if (&other == this) return;
+    root = joinMerged(root, other.root);
+    for (const std::shared_ptr<MappedTextFile>& file : other.files) {
+        // Halves of one split share their files; keep a single reference
+        if (std::find(files.begin(), files.end(), file) == files.end()) files.push_back(file);
+    }
+    other.root = nullptr;
+    other.files.clear();
+}
+
+// ============================================================================
+// READING
+// ============================================================================
+
+char Rope::charAt(size_t pos) const {
+    const RopeNode* node = root;
+    if (!node || pos >= node->length) return '\0';
+    while (!node->isLeaf()) {
+        if (pos < node->left->length) {
+            node = node->left;
+        } else {
+            pos -= node->left->length;
+            node = node->right;
+        }
+    }
+    return node->leafData()[pos];
+}
+
+void Rope::appendRange(const RopeNode* node, size_t pos, size_t count, std::string& out) {
+    // Recursion depth is the tree height
+    if (!node || count == 0) return;
+    if (node->isLeaf()) {
+        out.append(node->leafData() + pos, std::min(count, node->length - pos));
+        return;
+    }
+    size_t leftLength = node->left->length;
+    if (pos < leftLength) {
+        size_t fromLeft = std::min(count, leftLength - pos);
+        appendRange(node->left, pos, fromLeft, out);
+        appendRange(node->right, 0, count - fromLeft, out);
+    } else {
+        appendRange(node->right, pos - leftLength, count, out);
+    }
+}
+
+std::string Rope::substr(size_t pos, size_t count) const {
+    std::string out;
+    size_t total = length();
+    if (pos >= total) return out;
+    count = std::min(count, total - pos);
+    out.reserve(count);
+    appendRange(root, pos, count, out);
+    return out;
+}
+
+std::string Rope::toString() const {
+    return substr(0, length());
+}
+
+size_t Rope::length() const {
+    return lengthOf(root);
+}
+
+int Rope::getHeight() const {
+    return heightOf(root);
+}
+
+size_t Rope::leafCount() const {
+    size_t leaves = 0;
+    std::vector<const RopeNode*> stack;
+    if (root) stack.push_back(root);
+    while (!stack.empty()) {
+        const RopeNode* node = stack.back();
+        stack.pop_back();
+        if (node->isLeaf()) {
+            leaves++;
+        } else {
+            stack.push_back(node->left);
+            stack.push_back(node->right);
+        }
+    }
+    return leaves;
+}
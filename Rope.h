@@ -0,0 +1,124 @@
+// File: Rope.h
+// Description: Rope - a balanced tree of text chunks for large documents.
+// Leaves hold up to LEAF_SIZE bytes; an internal node only knows the total
+// length and height of its subtree. Finding an offset walks down by the
+// left lengths, so insert, erase, split and concat at any offset cost
+// O(log n) node operations plus at most a few KB of copying, where a flat
+// std::string moves everything after the edit point.
+//
+// Balance is kept AVL-style (children's heights differ by at most one).
+// Everything is built on two primitives:
+// - join(a, b): concatenate two balanced trees in O(|height difference|)
+//   by walking down the taller one's spine and rebalancing on the way up
+// - split(t, pos): cut along the path to 'pos' and join the pieces
+// An edit that stays inside one leaf skips both and changes it in place.
+// Otherwise the two leaves meeting at each new seam are merged when they
+// fit into one chunk, so repeated edits don't leave a trail of tiny leaves.
+//
+// loadFile() memory-maps the file and points the leaves straight into the
+// mapping, so opening a multi-GB file reads nothing up front. Those leaves
+// are read-only: splitting one only slices the pointer, and editing inside
+// one first copies its (at most LEAF_SIZE) bytes. Ropes created by split()
+// keep the mapping alive for as long as any of them still references it.
+
+#ifndef ROPE_H
+#define ROPE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "MemoryAccount.h"
+
+// ============================================================================
+// MAPPED TEXT FILE
+// ============================================================================
+class MappedTextFile {
+private:
+    const char* bytes;
+    size_t count;
+    void* mapping;                  // mmap() result, nullptr if not mapped
+    std::string owned;              // Fallback when mmap is unavailable
+
+public:
+    MappedTextFile();
+    ~MappedTextFile();
+    MappedTextFile(const MappedTextFile&) = delete;
+    MappedTextFile& operator=(const MappedTextFile&) = delete;
+
+    bool open(const std::string& path, std::string& error);
+
+    const char* data() const { return bytes; }
+    size_t size() const { return count; }
+    bool isMapped() const { return mapping != nullptr; }
+};
+
+// ============================================================================
+// ROPE NODE
+// ============================================================================
+struct RopeNode : TrackedAllocation<MemoryAccount::STRUCTURE_NODES> {
+    RopeNode* left;
+    RopeNode* right;
+    size_t length;          // Bytes in this subtree
+    int height;             // 1 for leaves
+    int id;                 // Unique, for TreeCanvas animations
+
+    // Leaves only: text inside a mapped file, or owned text
+    const char* mapped;     // nullptr = the text lives in 'text'
+    std::basic_string<char, std::char_traits<char>,
+                      TrackingAllocator<char, MemoryAccount::STRUCTURE_NODES>> text;
+
+    bool isLeaf() const { return left == nullptr; }
+    const char* leafData() const { return mapped ? mapped : text.data(); }
+};
+
+// ============================================================================
+// ROPE CLASS
+// ============================================================================
+class Rope {
+public:
+    static const size_t LEAF_SIZE = 4096;
+
+private:
+    RopeNode* root;
+    std::vector<std::shared_ptr<MappedTextFile>> files;    // Mapped leaves point here
+
+    static void destroy(RopeNode* node);
+    static void appendRange(const RopeNode* node, size_t pos, size_t count, std::string& out);
+
+public:
+    Rope();
+    explicit Rope(const std::string& text);
+    ~Rope();
+    Rope(Rope&& other);
+    Rope& operator=(Rope&& other);
+    Rope(const Rope&) = delete;
+    Rope& operator=(const Rope&) = delete;
+
+    // Replace the contents with a memory-mapped file
+    bool loadFile(const std::string& path, std::string& error);
+    bool saveFile(const std::string& path, std::string& error) const;
+
+    // Offsets past the end are clamped to length()
+    void insert(size_t pos, const std::string& text);
+    void erase(size_t pos, size_t count);
+
+    // Keep [0, pos) and return [pos, length()) as a new rope
+    Rope split(size_t pos);
+    // Append 'other' (left empty afterwards)
+    void concat(Rope& other);
+
+    char charAt(size_t pos) const;
+    std::string substr(size_t pos, size_t count) const;
+    std::string toString() const;
+
+    void clear();
+    size_t length() const;
+    bool isEmpty() const { return root == nullptr; }
+    int getHeight() const;
+    size_t leafCount() const;
+    bool usesMappedFile() const { return !files.empty(); }
+    RopeNode* getRoot() const { return root; }
+};
+
+#endif // ROPE_H
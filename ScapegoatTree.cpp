@@ -0,0 +1,361 @@
+// File: ScapegoatTree.cpp
+// Description: Scapegoat tree operations and in-place subtree rebuilding
+
+#include "ScapegoatTree.h"
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <cmath>
+
+// ============================================================================
+// CONSTRUCTOR & DESTRUCTOR
+// ============================================================================
+
+ScapegoatTree::ScapegoatTree(double balance)
+    : root(nullptr), nextNodeId(0), count(0), maxCount(0),
+      alpha(std::max(0.55, std::min(balance, 0.95))),
+      pending(nullptr), pendingParent(nullptr),
+      rebuildCount(0), rebuiltNodes(0)
+{
+}
+
+ScapegoatTree::~ScapegoatTree() {
+    clear();
+}
+
+void ScapegoatTree::setAlpha(double balance) {
+    alpha = std::max(0.55, std::min(balance, 0.95));
+}
+
+void ScapegoatTree::clearHelper(Node* node) {
+    std::vector<Node*> stack;
+    if (node) stack.push_back(node);
+    while (!stack.empty()) {
+        Node* current = stack.back();
+        stack.pop_back();
+        if (current->left) stack.push_back(current->left);
+        if (current->right) stack.push_back(current->right);
+        delete current;
+    }
+}
+
+void ScapegoatTree::clear() {
+    clearHelper(root);
+    root = nullptr;
+    count = 0;
+    maxCount = 0;
+    pending = nullptr;
+    pendingParent = nullptr;
+}
+
+// ============================================================================
+// BALANCE HELPERS
+// ============================================================================
+
+int ScapegoatTree::depthLimit(int n) const {
+    // floor(log_{1/alpha} n); the small epsilon keeps exact powers exact
+    return static_cast<int>(std::floor(std::log(static_cast<double>(n)) /
+                                       std::log(1.0 / alpha) + 1e-9));
+}
+
+int ScapegoatTree::subtreeSize(Node* node) {
+    int size = 0;
+    scratch.clear();
+    if (node) scratch.push_back(node);
+    while (!scratch.empty()) {
+        Node* current = scratch.back();
+        scratch.pop_back();
+        size++;
+        if (current->left) scratch.push_back(current->left);
+        if (current->right) scratch.push_back(current->right);
+    }
+    return size;
+}
+
+// ============================================================================
+// IN-PLACE REBUILD
+// ============================================================================
+// 1. Tree to vine: rotate every left child up until no node has one. The
+//    nodes then form a sorted list through their right pointers.
+// 2. Vine to tree: take the middle node as the root, build the left half
+//    from the nodes before it and the right half from the ones after it.
+//    Consuming the vine in order makes this O(n) with O(log n) recursion.
+// ============================================================================
+
+Node* ScapegoatTree::rebuildSubtree(Node* node, int& size) {
+    Node pseudoRoot(0, -1);
+    pseudoRoot.right = node;
+    Node* tail = &pseudoRoot;
+    Node* rest = node;
+    size = 0;
+    while (rest) {
+        if (rest->left == nullptr) {
+            tail = rest;
+            rest = rest->right;
+            size++;
+        } else {
+            // Right rotation at 'rest'
+            Node* left = rest->left;
+            rest->left = left->right;
+            left->right = rest;
+            rest = left;
+            tail->right = left;
+        }
+    }
+
+    Node* head = pseudoRoot.right;
+    return buildBalanced(head, size);
+}
+
+Node* ScapegoatTree::buildBalanced(Node*& head, int n) {
+    if (n <= 0) return nullptr;
+    int leftSize = (n - 1) / 2;
+    Node* left = buildBalanced(head, leftSize);
+    Node* middle = head;
+    head = head->right;
+    middle->left = left;
+    middle->right = buildBalanced(head, n - 1 - leftSize);
+    return middle;
+}
+
+void ScapegoatTree::rebuildPending() {
+    if (!pending) return;
+
+    bool wholeTree = pendingParent == nullptr;
+    bool isLeft = !wholeTree && pendingParent->left == pending;
+    int size = 0;
+    Node* rebuilt = rebuildSubtree(pending, size);
+
+    if (wholeTree) {
+        root = rebuilt;
+        maxCount = count;
+    } else if (isLeft) {
+        pendingParent->left = rebuilt;
+    } else {
+        pendingParent->right = rebuilt;
+    }
+
+    rebuildCount++;
+    rebuiltNodes += size;
+    pending = nullptr;
+    pendingParent = nullptr;
+}
+
+// ============================================================================
+// INSERT
+// ============================================================================
+
+bool ScapegoatTree::insert(int value, std::vector<Node*>& path, bool deferRebuild) {
+    AllocationTracker::Operation scope("Scapegoat insert");
+    rebuildPending();
+
+    size_t start = path.size();
+    Node* parent = nullptr;
+    Node* current = root;
+    while (current) {
+        path.push_back(current);
+        if (value == current->value) return false;
+        parent = current;
+        current = value < current->value ? current->left : current->right;
+    }
+
+    Node* node = new Node(value, nextNodeId++);
+    if (!parent) root = node;
+    else if (value < parent->value) parent->left = node;
+    else parent->right = node;
+    path.push_back(node);
+    count++;
+    maxCount = std::max(maxCount, count);
+
+    int depth = static_cast<int>(path.size() - start) - 1;
+    if (depth <= depthLimit(count)) return true;
+
+    // Too deep: climb until a child holds more than alpha of its parent's
+    // subtree. Such an ancestor must exist, or the depth would be in bounds.
+    int childSize = 1;
+    Node* child = node;
+    for (size_t i = path.size() - 1; i-- > start; ) {
+        Node* ancestor = path[i];
+        Node* sibling = ancestor->left == child ? ancestor->right : ancestor->left;
+        int ancestorSize = 1 + childSize + subtreeSize(sibling);
+        if (childSize > alpha * ancestorSize) {
+            pending = ancestor;
+            pendingParent = i > start ? path[i - 1] : nullptr;
+            break;
+        }
+        childSize = ancestorSize;
+        child = ancestor;
+    }
+
+    if (!deferRebuild) rebuildPending();
+    return true;
+}
+
+// ============================================================================
+// REMOVE
+// ============================================================================
+
+bool ScapegoatTree::remove(int value, std::vector<int>& pathIds, bool deferRebuild) {
+    AllocationTracker::Operation scope("Scapegoat delete");
+    rebuildPending();
+
+    Node* parent = nullptr;
+    Node* node = root;
+    while (node && node->value != value) {
+        pathIds.push_back(node->id);
+        parent = node;
+        node = value < node->value ? node->left : node->right;
+    }
+    if (!node) return false;
+    pathIds.push_back(node->id);
+
+    // Two children: the in-order successor's value moves up and the
+    // successor node (which has no left child) is the one unlinked
+    if (node->left && node->right) {
+        Node* successorParent = node;
+        Node* successor = node->right;
+        pathIds.push_back(successor->id);
+        while (successor->left) {
+            successorParent = successor;
+            successor = successor->left;
+            pathIds.push_back(successor->id);
+        }
+        node->value = successor->value;
+        parent = successorParent;
+        node = successor;
+    }
+
+    Node* child = node->left ? node->left : node->right;
+    if (!parent) root = child;
+    else if (parent->left == node) parent->left = child;
+    else parent->right = child;
+    delete node;
+    count--;
+
+    if (count == 0) {
+        maxCount = 0;
+    } else if (count < alpha * maxCount) {
+        pending = root;
+        pendingParent = nullptr;
+        if (!deferRebuild) rebuildPending();
+    }
+    return true;
+}
+
+// ============================================================================
+// SEARCH
+// ============================================================================
+
+Node* ScapegoatTree::search(int value, std::vector<Node*>& path) {
+    AllocationTracker::Operation scope("Scapegoat search");
+    rebuildPending();
+    Node* current = root;
+    while (current) {
+        path.push_back(current);
+        if (value == current->value) return current;
+        current = value < current->value ? current->left : current->right;
+    }
+    return nullptr;
+}
+
+bool ScapegoatTree::contains(int value) const {
+    Node* current = root;
+    while (current) {
+        if (value == current->value) return true;
+        current = value < current->value ? current->left : current->right;
+    }
+    return false;
+}
+
+// ============================================================================
+// TRAVERSALS & BULK LOADING
+// ============================================================================
+
+int ScapegoatTree::getHeight() const {
+    struct Frame {
+        Node* node;
+        int depth;
+    };
+    int height = 0;
+    std::vector<Frame> stack;
+    if (root) stack.push_back({root, 1});
+    while (!stack.empty()) {
+        Frame frame = stack.back();
+        stack.pop_back();
+        height = std::max(height, frame.depth);
+        if (frame.node->left) stack.push_back({frame.node->left, frame.depth + 1});
+        if (frame.node->right) stack.push_back({frame.node->right, frame.depth + 1});
+    }
+    return height;
+}
+
+std::vector<int> ScapegoatTree::inorderTraversal() const {
+    std::vector<int> result;
+    std::vector<Node*> stack;
+    Node* current = root;
+    while (current || !stack.empty()) {
+        while (current) {
+            stack.push_back(current);
+            current = current->left;
+        }
+        current = stack.back();
+        stack.pop_back();
+        result.push_back(current->value);
+        current = current->right;
+    }
+    return result;
+}
+
+std::vector<int> ScapegoatTree::preorderTraversal() const {
+    std::vector<int> result;
+    std::vector<Node*> stack;
+    if (root) stack.push_back(root);
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        result.push_back(node->value);
+        if (node->right) stack.push_back(node->right);
+        if (node->left) stack.push_back(node->left);
+    }
+    return result;
+}
+
+void ScapegoatTree::loadSorted(std::vector<int> values) {
+    clear();
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+
+    // Build the vine directly, then let the rebuild builder balance it
+    Node* head = nullptr;
+    for (size_t i = values.size(); i-- > 0; ) {
+        Node* node = new Node(values[i], nextNodeId++);
+        node->right = head;
+        head = node;
+    }
+    count = maxCount = static_cast<int>(values.size());
+    root = buildBalanced(head, count);
+}
+
+void ScapegoatTree::loadPreorder(const std::vector<int>& values) {
+    clear();
+    if (values.empty()) return;
+
+    // Same construction as BST::loadPreorder
+    root = new Node(values[0], nextNodeId++);
+    std::vector<Node*> stack;
+    stack.push_back(root);
+    for (size_t i = 1; i < values.size(); i++) {
+        Node* node = new Node(values[i], nextNodeId++);
+        Node* parent = nullptr;
+        while (!stack.empty() && stack.back()->value < values[i]) {
+            parent = stack.back();
+            stack.pop_back();
+        }
+        if (parent) {
+            parent->right = node;
+        } else {
+            stack.back()->left = node;
+        }
+        stack.push_back(node);
+    }
+    count = maxCount = static_cast<int>(values.size());
+}
@@ -0,0 +1,100 @@
+// File: ScapegoatTree.h
+// Description: Scapegoat tree - a self-balancing BST that stores no balance
+// data at all. Nodes are plain BST 'Node's; the tree only remembers its
+// size and the largest size since the last full rebuild.
+//
+// Insert works like an ordinary BST insert. If the new node lands deeper
+// than log_{1/alpha}(n), the walk back up finds the first ancestor whose
+// child on the path holds more than alpha of its subtree (the "scapegoat")
+// and that subtree is rebuilt into a perfectly balanced one. When deletes
+// shrink the tree below alpha * (largest size), the whole tree is rebuilt.
+// Rebuilds are O(size of the subtree) but rare, so operations are O(log n)
+// amortized. Without deletes no node is deeper than log_{1/alpha}(n);
+// deletes can add up to two levels until the next full rebuild.
+//
+// Rebuilds reuse the nodes in place: the subtree is flattened into a
+// sorted "vine" through the right pointers by rotations (no extra memory),
+// and the vine is cut into a balanced tree by buildBalanced(), the same
+// builder that loadSorted() uses to bulk-load sorted values.
+//
+// The GUI passes deferRebuild = true to show the unbalanced shape first and
+// then call rebuildPending() as a separate collapse-and-rebuild step. Any
+// other operation completes a pending rebuild before it starts.
+
+#ifndef SCAPEGOAT_TREE_H
+#define SCAPEGOAT_TREE_H
+
+#include <vector>
+#include "BST.h"
+
+class ScapegoatTree {
+private:
+    Node* root;
+    int nextNodeId;
+    int count;
+    int maxCount;           // Largest 'count' since the last full rebuild
+    double alpha;           // Weight-balance factor, 0.5 < alpha < 1
+
+    Node* pending;          // Scapegoat waiting for rebuildPending()
+    Node* pendingParent;    // Its parent (nullptr = it is the root)
+
+    long long rebuildCount;
+    long long rebuiltNodes;
+    std::vector<Node*> scratch;     // Reused traversal stack
+
+    int depthLimit(int n) const;
+    int subtreeSize(Node* node);
+
+    // Rebuild the subtree at 'node' in place; returns its new root and
+    // stores the number of nodes in 'size'
+    static Node* rebuildSubtree(Node* node, int& size);
+    // Cut a sorted vine of 'n' nodes (linked through 'right') into a
+    // balanced tree; advances 'head' past the nodes used
+    static Node* buildBalanced(Node*& head, int n);
+
+    void clearHelper(Node* node);
+
+public:
+    explicit ScapegoatTree(double alpha = 2.0 / 3.0);
+    ~ScapegoatTree();
+    ScapegoatTree(const ScapegoatTree&) = delete;
+    ScapegoatTree& operator=(const ScapegoatTree&) = delete;
+
+    // 'path' gets the nodes visited, ending with the new node on success
+    bool insert(int value, std::vector<Node*>& path, bool deferRebuild = false);
+
+    // Frees the removed node; 'pathIds' are the ids visited (including the
+    // successor's path when the node had two children)
+    bool remove(int value, std::vector<int>& pathIds, bool deferRebuild = false);
+
+    Node* search(int value, std::vector<Node*>& path);
+    bool contains(int value) const;
+
+    // Deferred rebuild (see above)
+    bool hasPendingRebuild() const { return pending != nullptr; }
+    Node* pendingScapegoat() const { return pending; }
+    void rebuildPending();
+
+    void clear();
+    bool isEmpty() const { return root == nullptr; }
+    int size() const { return count; }
+    Node* getRoot() const { return root; }
+    int getHeight() const;
+    double getAlpha() const { return alpha; }
+    // A new alpha applies from the next insert / delete on
+    void setAlpha(double balance);
+    // An insert deeper than this triggers a rebuild: floor(log_{1/alpha} n)
+    int getDepthLimit() const { return count > 0 ? depthLimit(count) : 0; }
+    long long getRebuildCount() const { return rebuildCount; }
+    long long getRebuiltNodeCount() const { return rebuiltNodes; }
+
+    std::vector<int> inorderTraversal() const;
+    std::vector<int> preorderTraversal() const;
+
+    // Bulk loading in O(n): loadSorted() builds a perfectly balanced tree
+    // (duplicates are dropped), loadPreorder() restores an exact shape
+    void loadSorted(std::vector<int> values);
+    void loadPreorder(const std::vector<int>& values);
+};
+
+#endif // SCAPEGOAT_TREE_H
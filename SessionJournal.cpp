@@ -0,0 +1,354 @@
+// File: SessionJournal.cpp
+// Description: Journal / snapshot files and recovery for SessionJournal.
+
+#include "SessionJournal.h"
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace {
+    const char SNAPSHOT_MAGIC[4] = {'D', 'S', 'V', 'S'};
+    const char JOURNAL_MAGIC[4] = {'D', 'S', 'V', 'J'};
+    const uint32_t FORMAT_VERSION = 1;
+
+    struct SnapshotHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t generation;
+        uint32_t kind;
+        uint64_t count;
+    };
+
+    struct JournalHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t generation;
+        uint32_t kind;
+    };
+
+    // Make sure the data reached the disk before the file is renamed into place
+    bool flushToDisk(FILE* file) {
+        if (std::fflush(file) != 0) return false;
+#if defined(__unix__) || defined(__APPLE__)
+        fsync(fileno(file));
+#endif
+        return true;
+    }
+
+    bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+        std::remove(to.c_str());    // rename() won't overwrite on Windows
+#endif
+        return std::rename(from.c_str(), to.c_str()) == 0;
+    }
+}
+
+// ============================================================================
+// CONSTRUCTOR & DESTRUCTOR
+// ============================================================================
+
+SessionJournal::SessionJournal(const std::string& name, StructureAdapter& structureAdapter)
+    : adapter(structureAdapter),
+      snapshotPath("session_" + name + ".snapshot"),
+      journalPath("session_" + name + ".journal"),
+      journal(nullptr), generation(0), journalRecords(0)
+{
+}
+
+SessionJournal::~SessionJournal() {
+    sync();
+    if (journal) {
+        std::fclose(journal);
+    }
+}
+
+// ============================================================================
+// RECOVERY
+// ============================================================================
+
+size_t SessionJournal::restore() {
+    std::vector<int> values;
+    std::vector<Record> records;
+
+    generation = 0;
+    readSnapshot(values);
+    bool journalClean = readJournal(records);
+
+    replay(values, records);
+
+    // Fold the replayed tail into a new snapshot; this also drops a torn
+    // last record so appending starts on a record boundary
+    if (!records.empty() || !journalClean) {
+        compact();
+    } else {
+        journal = std::fopen(journalPath.c_str(), "ab");
+        journalRecords = 0;
+    }
+
+    return static_cast<size_t>(adapter.size());
+}
+
+bool SessionJournal::readSnapshot(std::vector<int>& values) {
+    FILE* file = std::fopen(snapshotPath.c_str(), "rb");
+    if (!file) return false;
+
+    SnapshotHeader header;
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+              std::memcmp(header.magic, SNAPSHOT_MAGIC, 4) == 0 &&
+              header.version == FORMAT_VERSION &&
+              header.kind == static_cast<uint32_t>(adapter.kind());
+    if (ok) {
+        values.resize(static_cast<size_t>(header.count));
+        ok = values.empty() ||
+             std::fread(values.data(), sizeof(int), values.size(), file) == values.size();
+    }
+    std::fclose(file);
+
+    if (!ok) {
+        std::cerr << "Ignoring unreadable snapshot " << snapshotPath << std::endl;
+        values.clear();
+        return false;
+    }
+    generation = header.generation;
+    return true;
+}
+
+bool SessionJournal::readJournal(std::vector<Record>& records) {
+    FILE* file = std::fopen(journalPath.c_str(), "rb");
+    if (!file) return false;
+
+    JournalHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, JOURNAL_MAGIC, 4) != 0 ||
+        header.version != FORMAT_VERSION ||
+        header.kind != static_cast<uint32_t>(adapter.kind()) ||
+        header.generation != generation) {
+        // Stale (already part of the snapshot) or foreign: start over
+        std::fclose(file);
+        return false;
+    }
+
+    // Read in large blocks; a partial record at the end is from a crash
+    std::vector<char> block(RECORD_SIZE * 8192);
+    size_t leftover = 0;
+    size_t got;
+    while ((got = std::fread(block.data() + leftover, 1, block.size() - leftover, file)) > 0) {
+        size_t available = leftover + got;
+        size_t whole = available / RECORD_SIZE;
+        for (size_t i = 0; i < whole; i++) {
+            const char* raw = block.data() + i * RECORD_SIZE;
+            Record record;
+            record.op = static_cast<uint8_t>(raw[0]);
+            std::memcpy(&record.value, raw + 4, sizeof(int32_t));
+            records.push_back(record);
+        }
+        leftover = available - whole * RECORD_SIZE;
+        std::memmove(block.data(), block.data() + whole * RECORD_SIZE, leftover);
+    }
+    std::fclose(file);
+
+    return leftover == 0;
+}
+
+void SessionJournal::replay(std::vector<int>& values, const std::vector<Record>& records) {
+    StructureKind kind = adapter.kind();
+    bool linear = kind == StructureKind::LINKED_LIST || kind == StructureKind::STACK ||
+                  kind == StructureKind::QUEUE;
+
+    if (!linear) {
+        // Trees: the shape depends on the order of operations, so the tail
+        // really has to be re-applied (each step is only O(height))
+        adapter.bulkLoad(values);
+        std::vector<int> path;
+        for (const Record& record : records) {
+            path.clear();
+            int popped;
+            switch (record.op) {
+                case OP_INSERT:
+                case OP_INSERT_HEAD: adapter.insert(record.value, path); break;
+                case OP_REMOVE:      adapter.remove(record.value, path); break;
+                case OP_POP:         adapter.pop(popped); break;
+                case OP_CLEAR:       adapter.clear(); break;
+            }
+        }
+        return;
+    }
+
+    // Linear structures: replay on plain values, then build the nodes once.
+    // (Dequeuing from Queue's vector is O(n) per call; a deque is O(1).)
+    std::deque<int> model(values.begin(), values.end());
+    bool fromBack = kind == StructureKind::STACK;
+    for (const Record& record : records) {
+        switch (record.op) {
+            case OP_INSERT:
+                model.push_back(record.value);
+                break;
+            case OP_INSERT_HEAD:
+                model.push_front(record.value);
+                break;
+            case OP_REMOVE:
+                if (kind == StructureKind::LINKED_LIST) {
+                    auto it = std::find(model.begin(), model.end(), record.value);
+                    if (it != model.end()) model.erase(it);
+                    break;
+                }
+                // Stack / queue remove means pop
+                // fall through
+            case OP_POP:
+                if (model.empty()) break;
+                if (fromBack) model.pop_back();
+                else model.pop_front();
+                break;
+            case OP_CLEAR:
+                model.clear();
+                break;
+        }
+    }
+
+    values.assign(model.begin(), model.end());
+    adapter.bulkLoad(values);
+}
+
+// ============================================================================
+// RECORDING
+// ============================================================================
+
+void SessionJournal::record(Op op, int value) {
+    char raw[RECORD_SIZE] = {0};
+    raw[0] = static_cast<char>(op);
+    std::memcpy(raw + 4, &value, sizeof(int32_t));
+    buffer.insert(buffer.end(), raw, raw + RECORD_SIZE);
+    journalRecords++;
+
+    if (buffer.size() >= FLUSH_BYTES && journal) {
+        std::fwrite(buffer.data(), 1, buffer.size(), journal);
+        buffer.clear();
+    }
+}
+
+void SessionJournal::sync() {
+    if (!journal) {
+        buffer.clear();     // restore() was never called (or failed)
+        return;
+    }
+
+    if (!buffer.empty()) {
+        std::fwrite(buffer.data(), 1, buffer.size(), journal);
+        buffer.clear();
+    }
+    // Hand the data to the OS every frame: that is enough to survive an
+    // application crash. Snapshots are additionally fsync'ed.
+    std::fflush(journal);
+
+    if (journalRecords >= COMPACT_RECORDS) {
+        compact();
+    }
+}
+
+// ============================================================================
+// COMPACTION
+// ============================================================================
+// The snapshot is written under the next generation first; the journal is
+// replaced afterwards. A crash in between leaves a journal with the old
+// generation, which restore() ignores - its records are in the snapshot.
+// ============================================================================
+
+void SessionJournal::compact() {
+    uint32_t next = generation + 1;
+    if (!writeSnapshot(next)) {
+        std::cerr << "Could not write " << snapshotPath << "; keeping the journal" << std::endl;
+        if (!journal) journal = std::fopen(journalPath.c_str(), "ab");
+        return;
+    }
+    generation = next;
+    startJournal(next);
+}
+
+bool SessionJournal::writeSnapshot(uint32_t newGeneration) {
+    std::vector<int> values;
+    adapter.exportValues(values);
+
+    SnapshotHeader header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+    header.version = FORMAT_VERSION;
+    header.generation = newGeneration;
+    header.kind = static_cast<uint32_t>(adapter.kind());
+    header.count = values.size();
+
+    std::string temp = snapshotPath + ".tmp";
+    FILE* file = std::fopen(temp.c_str(), "wb");
+    if (!file) return false;
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (values.empty() ||
+               std::fwrite(values.data(), sizeof(int), values.size(), file) == values.size()) &&
+              flushToDisk(file);
+    std::fclose(file);
+
+    return ok && replaceFile(temp, snapshotPath);
+}
+
+bool SessionJournal::startJournal(uint32_t newGeneration) {
+    if (journal) {
+        std::fclose(journal);
+        journal = nullptr;
+    }
+    // Everything buffered so far is part of the snapshot
+    buffer.clear();
+    journalRecords = 0;
+
+    JournalHeader header;
+    std::memcpy(header.magic, JOURNAL_MAGIC, 4);
+    header.version = FORMAT_VERSION;
+    header.generation = newGeneration;
+    header.kind = static_cast<uint32_t>(adapter.kind());
+
+    std::string temp = journalPath + ".tmp";
+    FILE* file = std::fopen(temp.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 && flushToDisk(file);
+    std::fclose(file);
+
+    if (ok && replaceFile(temp, journalPath)) {
+        journal = std::fopen(journalPath.c_str(), "ab");
+    }
+    return journal != nullptr;
+}
+
+// ============================================================================
+// JOURNALED ADAPTER
+// ============================================================================
+
+bool JournaledAdapter::insert(int value, std::vector<int>& pathIds) {
+    bool ok = inner.insert(value, pathIds);
+    if (ok) journal.record(SessionJournal::OP_INSERT, value);
+    return ok;
+}
+
+bool JournaledAdapter::remove(int value, std::vector<int>& pathIds) {
+    bool ok = inner.remove(value, pathIds);
+    if (ok) journal.record(SessionJournal::OP_REMOVE, value);
+    return ok;
+}
+
+bool JournaledAdapter::pop(int& value) {
+    bool ok = inner.pop(value);
+    if (ok) journal.record(SessionJournal::OP_POP);
+    return ok;
+}
+
+void JournaledAdapter::clear() {
+    inner.clear();
+    journal.record(SessionJournal::OP_CLEAR);
+}
+
+void JournaledAdapter::bulkLoad(const std::vector<int>& values) {
+    // Not expressible as records - snapshot the result instead
+    inner.bulkLoad(values);
+    journal.compact();
+}
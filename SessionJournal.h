@@ -0,0 +1,115 @@
+// File: SessionJournal.h
+// Description: Crash-safe persistence for the structure of a mode.
+// Every successful change is appended to a journal; from time to time the
+// whole structure is written as a compact snapshot and the journal starts
+// over. Entering a mode (or restarting after a crash) restores the last
+// session by bulk-loading the snapshot and replaying the journal tail.
+//
+// Files (in the working directory, next to the PNG exports):
+//   session_<name>.snapshot  - header + values in StructureAdapter::exportValues order
+//   session_<name>.journal   - header + fixed 8-byte records {u8 op, 3 pad, i32 value}
+// Both headers carry a generation number. A journal whose generation does
+// not match the snapshot is stale (the app died while compacting) and is
+// ignored, so no operation is ever applied twice.
+
+#ifndef SESSION_JOURNAL_H
+#define SESSION_JOURNAL_H
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "StructureAdapter.h"
+
+// ============================================================================
+// SESSION JOURNAL CLASS
+// ============================================================================
+class SessionJournal {
+public:
+    enum Op : uint8_t {
+        OP_INSERT = 1,          // Adapter insert (tail / push / enqueue for linear kinds)
+        OP_INSERT_HEAD = 2,     // Linked list head insert
+        OP_REMOVE = 3,          // Adapter remove (value ignored for stack / queue)
+        OP_POP = 4,             // Adapter pop
+        OP_CLEAR = 5
+    };
+
+private:
+    static const size_t RECORD_SIZE = 8;
+    static const size_t FLUSH_BYTES = 64 * 1024;           // Write out at least this often
+    static const uint32_t COMPACT_RECORDS = 1u << 16;      // Bounds the replay on recovery
+
+    struct Record {
+        uint8_t op;
+        int32_t value;
+    };
+
+    StructureAdapter& adapter;
+    std::string snapshotPath;
+    std::string journalPath;
+
+    FILE* journal;                  // Open for appending after restore()
+    std::vector<char> buffer;       // Records not yet written
+    uint32_t generation;
+    uint32_t journalRecords;        // Records since the last snapshot
+
+    bool readSnapshot(std::vector<int>& values);
+    bool readJournal(std::vector<Record>& records);
+    void replay(std::vector<int>& values, const std::vector<Record>& records);
+    bool writeSnapshot(uint32_t newGeneration);
+    bool startJournal(uint32_t newGeneration);
+
+public:
+    // 'name' picks the files ("bst" -> session_bst.*)
+    SessionJournal(const std::string& name, StructureAdapter& adapter);
+    ~SessionJournal();
+
+    // Rebuild the structure from disk and start journaling.
+    // Returns the number of values restored.
+    size_t restore();
+
+    // Remember a successful operation (buffered)
+    void record(Op op, int value = 0);
+
+    // Write buffered records; compacts into a snapshot when the journal is long.
+    // Call once per frame.
+    void sync();
+
+    // Write a snapshot now and start an empty journal
+    void compact();
+};
+
+// ============================================================================
+// JOURNALED ADAPTER
+// ============================================================================
+// Forwards to another adapter and records every successful change, so the
+// console and the control socket are journaled without knowing about it.
+// ============================================================================
+class JournaledAdapter : public StructureAdapter {
+private:
+    StructureAdapter& inner;
+    SessionJournal& journal;
+public:
+    JournaledAdapter(StructureAdapter& adapter, SessionJournal& sessionJournal)
+        : inner(adapter), journal(sessionJournal) {}
+    StructureKind kind() const override { return inner.kind(); }
+    std::string name() const override { return inner.name(); }
+    bool insert(int value, std::vector<int>& pathIds) override;
+    bool remove(int value, std::vector<int>& pathIds) override;
+    bool search(int value, std::vector<int>& pathIds) override { return inner.search(value, pathIds); }
+    bool pop(int& value) override;
+    void clear() override;
+    int size() override { return inner.size(); }
+    std::string toString() override { return inner.toString(); }
+    void snapshot(StructureSnapshot& snap) override { inner.snapshot(snap); }
+    void exportValues(std::vector<int>& values) override { inner.exportValues(values); }
+    void bulkLoad(const std::vector<int>& values) override;
+    void visitShape(ShapeVisitor& visitor) override { inner.visitShape(visitor); }
+    const ShapeStats* shapeStats() const override { return inner.shapeStats(); }
+    InvariantReport checkInvariants() override { return inner.checkInvariants(); }
+    InvariantReport sampleInvariants(InvariantSampler& sampler) override {
+        return inner.sampleInvariants(sampler);
+    }
+};
+
+#endif // SESSION_JOURNAL_H
@@ -0,0 +1,131 @@
+// File: ShapeStats.cpp
+// Description: Counter updates and summaries for ShapeStats
+
+#include "ShapeStats.h"
+#include <iomanip>
+#include <sstream>
+
+const int ShapeStats::BALANCE_BUCKETS;
+
+ShapeStats::ShapeStats() : rootSlot(nullptr), countDepths(nullptr) {
+    clear();
+}
+
+void ShapeStats::clear() {
+    stale = false;
+    depthsStale = false;
+    depthCounts.clear();
+    nodes = 0;
+    leaves = 0;
+    pathLength = 0;
+    for (int b = 0; b < BALANCE_BUCKETS; b++) {
+        balanceCounts[b] = 0;
+    }
+}
+
+// ============================================================================
+// DEPTHS
+// ============================================================================
+
+void ShapeStats::addNode(int depth) {
+    if (stale) return;
+    nodes++;
+    if (depthsStale) return;
+    if (depthCounts.size() <= static_cast<size_t>(depth)) {
+        depthCounts.resize(depth + 1, 0);
+    }
+    depthCounts[depth]++;
+    pathLength += depth;
+}
+
+void ShapeStats::removeNode(int depth) {
+    if (stale) return;
+    nodes--;
+    if (depthsStale) return;
+    depthCounts[depth]--;
+    pathLength -= depth;
+    trim();
+}
+
+void ShapeStats::trim() const {
+    while (!depthCounts.empty() && depthCounts.back() == 0) {
+        depthCounts.pop_back();
+    }
+}
+
+void ShapeStats::updateDepths() const {
+    if (!depthsStale || countDepths == nullptr) return;
+    countDepths(rootSlot, depthCounts, pathLength);
+    depthsStale = false;
+}
+
+int ShapeStats::height() const {
+    updateDepths();
+    return static_cast<int>(depthCounts.size());
+}
+
+unsigned long long ShapeStats::internalPathLength() const {
+    updateDepths();
+    return pathLength;
+}
+
+double ShapeStats::averageDepth() const {
+    updateDepths();
+    return nodes ? static_cast<double>(pathLength) / nodes : 0.0;
+}
+
+size_t ShapeStats::depthCount(int depth) const {
+    updateDepths();
+    return depth >= 0 && static_cast<size_t>(depth) < depthCounts.size() ? depthCounts[depth] : 0;
+}
+
+// ============================================================================
+// BALANCE FACTORS
+// ============================================================================
+
+const char* ShapeStats::bucketLabel(int bucket) {
+    static const char* const LABELS[BALANCE_BUCKETS] = {"<=-3", "-2", "-1", "0", "+1", "+2", ">=+3"};
+    return bucket >= 0 && bucket < BALANCE_BUCKETS ? LABELS[bucket] : "?";
+}
+
+// ============================================================================
+// SUMMARY
+// ============================================================================
+
+unsigned long long ShapeStats::minimumPathLength(size_t count) {
+    // Full levels 0..k-1 hold 2^k - 1 nodes; the rest sit at depth k
+    unsigned long long total = 0;
+    unsigned long long levelSize = 1;
+    unsigned long long depth = 0;
+    while (count > 0) {
+        unsigned long long here = count < levelSize ? count : levelSize;
+        total += here * depth;
+        count -= static_cast<size_t>(here);
+        levelSize *= 2;
+        depth++;
+    }
+    return total;
+}
+
+std::string ShapeStats::toString() const {
+    updateDepths();
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "nodes " << nodes << ", leaves " << leaves << ", height " << height()
+       << ", avg depth " << averageDepth() << "\n";
+    ss << "internal path length " << pathLength << " (complete tree: "
+       << minimumPathLength(nodes) << ")\n";
+    ss << "balance factors:";
+    for (int b = 0; b < BALANCE_BUCKETS; b++) {
+        ss << " " << bucketLabel(b) << ":" << balanceCounts[b];
+    }
+    ss << "\nnodes per depth:";
+    for (size_t d = 0; d < depthCounts.size(); d++) {
+        if (d == 16 && depthCounts.size() > 20) {
+            ss << " ... (" << depthCounts.size() - 16 << " more levels)";
+            break;
+        }
+        ss << " " << depthCounts[d];
+    }
+    return ss.str();
+}
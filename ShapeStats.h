@@ -0,0 +1,210 @@
+// File: ShapeStats.h
+// Description: Live shape statistics of a binary search tree. BST and
+// AVLTree keep one up to date as they change, so the numbers are there
+// without walking getAllNodes() every frame:
+// - nodes per depth (the root is depth 0), which gives the height, the
+//   internal path length (sum of all depths) and the average depth
+// - nodes per balance factor, height(left) - height(right). Buckets run
+//   from "-3 or less" to "3 or more", because a degenerate BST has
+//   unbounded factors.
+// - leaf count
+//
+// The trees report every change:
+// - addNode / detach: a node joins or leaves at a depth
+// - moveSubtree: a subtree moves up or down (a delete splices out a node
+//   with one child, an AVL rotation swaps two levels)
+// - refresh(node): the node's children or their heights may have changed
+// Each node stores the bucket it is counted in ('shapeCode', -1 = not
+// counted), so a refresh replaces exactly what was counted before.
+//
+// Cost: an insert or delete touches only the nodes on its path, and BST
+// stops refreshing at the first node whose height didn't change. Node,
+// leaf and balance factor counts are always current. A moved subtree would
+// shift the depth of every node in it, which is O(n) for a splice near the
+// top of a degenerate BST. So a move only marks the depth figures (depth
+// histogram, height, internal path length, average depth) stale, and the
+// first read of one recounts them in one walk over the tree. Mutations
+// stay O(path) whether or not anything is watching; the walk is paid once
+// per read after a change, and only by whoever reads depths (the F4 chart,
+// the console's 'shape').
+//
+// A bulk change that reshapes the whole tree (AVLTree's set operations)
+// calls invalidate() instead. Every report is then ignored until the owner
+// recounts with rebuild(), which it does on the next read.
+//
+// The owner passes the address of its root pointer to bind(), so a stale
+// depth figure can be recounted from a const reference.
+//
+// NodeT needs 'left', 'right', 'height' (0 for nullptr children, 1 for a
+// leaf) and 'shapeCode'.
+
+#ifndef SHAPE_STATS_H
+#define SHAPE_STATS_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// SHAPE STATS CLASS
+// ============================================================================
+class ShapeStats {
+public:
+    static const int BALANCE_BUCKETS = 7;  // <= -3, -2, -1, 0, 1, 2, >= 3
+
+private:
+    // Depth figures; recounted on read when 'depthsStale'
+    mutable std::vector<size_t> depthCounts;            // Index = depth; no trailing zeros
+    mutable unsigned long long pathLength;              // Sum of all depths
+    mutable bool depthsStale;
+
+    size_t nodes;
+    size_t leaves;
+    size_t balanceCounts[BALANCE_BUCKETS];
+    bool stale;                             // Counts are wrong until rebuild()
+
+    // The owner's root pointer and a walk that counts depths below it
+    const void* rootSlot;
+    void (*countDepths)(const void* rootSlot, std::vector<size_t>& counts,
+                        unsigned long long& length);
+
+    // A node's code is bucket * 2 + (leaf ? 1 : 0)
+    void uncount(int code) {
+        if (code < 0) return;
+        balanceCounts[code / 2]--;
+        if (code & 1) leaves--;
+    }
+    void count(int code) {
+        balanceCounts[code / 2]++;
+        if (code & 1) leaves++;
+    }
+    void trim() const;                                  // Drop empty deepest levels
+    void updateDepths() const;                          // Recount if stale
+
+    template <typename NodeT>
+    static int heightOf(const NodeT* node) { return node ? node->height : 0; }
+
+    template <typename NodeT>
+    static void countTreeDepths(const void* rootSlot, std::vector<size_t>& counts,
+                                unsigned long long& length);
+
+public:
+    ShapeStats();
+
+    void clear();
+    
+    // Recount stale depth figures from '*root' (the owner's root member)
+    template <typename NodeT>
+    void bind(NodeT* const* root) {
+        rootSlot = root;
+        countDepths = &countTreeDepths<NodeT>;
+    }
+
+    // Stop counting until the next rebuild()
+    void invalidate() { stale = true; }
+    bool isStale() const { return stale; }
+
+    // Depth bookkeeping
+    void addNode(int depth);
+    void removeNode(int depth);
+
+    // Recount a node's balance factor and leaf status
+    template <typename NodeT>
+    void refresh(NodeT* node) {
+        if (stale) return;
+        int code = bucketOf(heightOf(node->left) - heightOf(node->right)) * 2 +
+                   (node->left == nullptr && node->right == nullptr ? 1 : 0);
+        if (code == node->shapeCode) return;
+        uncount(node->shapeCode);
+        count(code);
+        node->shapeCode = code;
+    }
+
+    // A node at 'depth' leaves the tree (its subtrees are handled separately)
+    template <typename NodeT>
+    void detach(NodeT* node, int depth) {
+        if (stale) return;
+        uncount(node->shapeCode);
+        node->shapeCode = -1;
+        removeNode(depth);
+    }
+
+    // The nodes of 'subtree' moved to other depths (recounted on read)
+    template <typename NodeT>
+    void moveSubtree(const NodeT* subtree) {
+        if (subtree != nullptr) depthsStale = true;
+    }
+
+    // Count a whole tree from scratch (after a bulk load); heights must be
+    // current
+    template <typename NodeT>
+    void rebuild(NodeT* root);
+
+    size_t size() const { return nodes; }
+    size_t leafCount() const { return leaves; }
+    int height() const;
+    unsigned long long internalPathLength() const;
+    double averageDepth() const;
+    size_t depthCount(int depth) const;
+    size_t balanceCount(int bucket) const { return balanceCounts[bucket]; }
+
+    // Bucket for a balance factor, and its label ("<=-3", "-2", ... ">=3")
+    static int bucketOf(int balance) {
+        return balance < -3 ? 0 : balance > 3 ? BALANCE_BUCKETS - 1 : balance + 3;
+    }
+    static const char* bucketLabel(int bucket);
+
+    // Internal path length of a complete tree with 'count' nodes, the
+    // smallest any binary tree of that size can have
+    static unsigned long long minimumPathLength(size_t count);
+
+    // Multi-line text summary (console 'shape' command)
+    std::string toString() const;
+};
+
+// ============================================================================
+// TEMPLATE IMPLEMENTATION
+// ============================================================================
+
+template <typename NodeT>
+void ShapeStats::countTreeDepths(const void* rootSlot, std::vector<size_t>& counts,
+                                 unsigned long long& length) {
+    counts.clear();
+    length = 0;
+    const NodeT* root = *static_cast<NodeT* const*>(rootSlot);
+    if (root == nullptr) return;
+    // Iterative, since a degenerate BST can be as deep as it is large
+    std::vector<std::pair<const NodeT*, int>> stack;
+    stack.push_back(std::make_pair(root, 0));
+    while (!stack.empty()) {
+        const NodeT* node = stack.back().first;
+        int depth = stack.back().second;
+        stack.pop_back();
+        if (counts.size() <= static_cast<size_t>(depth)) counts.resize(depth + 1, 0);
+        counts[depth]++;
+        length += depth;
+        if (node->left) stack.push_back(std::make_pair(node->left, depth + 1));
+        if (node->right) stack.push_back(std::make_pair(node->right, depth + 1));
+    }
+}
+
+template <typename NodeT>
+void ShapeStats::rebuild(NodeT* root) {
+    clear();
+    if (root == nullptr) return;
+    std::vector<std::pair<NodeT*, int>> stack;
+    stack.push_back(std::make_pair(root, 0));
+    while (!stack.empty()) {
+        NodeT* node = stack.back().first;
+        int depth = stack.back().second;
+        stack.pop_back();
+        addNode(depth);
+        node->shapeCode = -1;
+        refresh(node);
+        if (node->left) stack.push_back(std::make_pair(node->left, depth + 1));
+        if (node->right) stack.push_back(std::make_pair(node->right, depth + 1));
+    }
+}
+
+#endif // SHAPE_STATS_H
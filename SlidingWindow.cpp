@@ -0,0 +1,75 @@
+// File: SlidingWindow.cpp
+// Description: Monotonic deque updates for sliding-window min / max
+
+#include "SlidingWindow.h"
+
+SlidingWindow::SlidingWindow(size_t windowWidth)
+    : mask(0), minHead(0), minTail(0), maxHead(0), maxTail(0), width(1), pushed(0)
+{
+    reset(windowWidth);
+}
+
+void SlidingWindow::reset(size_t windowWidth) {
+    width = windowWidth > 0 ? windowWidth : 1;
+    size_t capacity = 1;
+    while (capacity < width) capacity <<= 1;
+    minRing.assign(capacity, WindowEntry());
+    maxRing.assign(capacity, WindowEntry());
+    mask = capacity - 1;
+    minHead = minTail = maxHead = maxTail = 0;
+    pushed = 0;
+}
+
+// Shared by push() and pushBlock(); the evictions checks fold away in the
+// pushBlock() copy, where the argument is a constant nullptr
+inline void SlidingWindow::advance(int value, std::vector<Eviction>* evictions) {
+    uint64_t index = pushed++;
+
+    // Expire: the front entry left the window when 'index' arrived. Only
+    // the front can have expired, since indices grow towards the back.
+    if (minHead != minTail && minRing[minHead & mask].index + width <= index) {
+        if (evictions) evictions->push_back({minRing[minHead & mask], false, true});
+        minHead++;
+    }
+    if (maxHead != maxTail && maxRing[maxHead & mask].index + width <= index) {
+        if (evictions) evictions->push_back({maxRing[maxHead & mask], true, true});
+        maxHead++;
+    }
+
+    // Dominate: newer and at least as good beats older
+    while (minHead != minTail && minRing[(minTail - 1) & mask].value >= value) {
+        minTail--;
+        if (evictions) evictions->push_back({minRing[minTail & mask], false, false});
+    }
+    while (maxHead != maxTail && maxRing[(maxTail - 1) & mask].value <= value) {
+        maxTail--;
+        if (evictions) evictions->push_back({maxRing[maxTail & mask], true, false});
+    }
+
+    minRing[minTail++ & mask] = {index, value};
+    maxRing[maxTail++ & mask] = {index, value};
+}
+
+void SlidingWindow::push(int value, std::vector<Eviction>* evictions) {
+    advance(value, evictions);
+}
+
+void SlidingWindow::pushBlock(const int* values, size_t count, int* minOut, int* maxOut) {
+    for (size_t i = 0; i < count; i++) {
+        advance(values[i], nullptr);
+        if (minOut) minOut[i] = minRing[minHead & mask].value;
+        if (maxOut) maxOut[i] = maxRing[maxHead & mask].value;
+    }
+}
+
+int SlidingWindow::getMin() const {
+    return minHead != minTail ? minRing[minHead & mask].value : 0;
+}
+
+int SlidingWindow::getMax() const {
+    return maxHead != maxTail ? maxRing[maxHead & mask].value : 0;
+}
+
+size_t SlidingWindow::memoryBytes() const {
+    return (minRing.capacity() + maxRing.capacity()) * sizeof(WindowEntry);
+}
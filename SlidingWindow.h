@@ -0,0 +1,82 @@
+// File: SlidingWindow.h
+// Description: Sliding-window minimum and maximum over an integer stream
+// with two monotonic deques, amortized O(1) per element.
+//
+// The min deque holds the window's elements that could still become its
+// minimum: their values strictly increase from front to back. Pushing x
+// - drops the front if it has slid out of the window ("expired")
+// - pops every back entry >= x: x is newer and no larger, so those can
+//   never be the minimum again ("dominated")
+// - appends x
+// The front is then the window minimum. Each element enters and leaves a
+// deque at most once, hence O(1) amortized; a deque never holds more than
+// 'width' entries. The max deque is the same with the comparison flipped.
+//
+// Both deques are ring buffers sized to the next power of two >= width,
+// allocated once by reset().
+
+#ifndef SLIDING_WINDOW_H
+#define SLIDING_WINDOW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct WindowEntry {
+    uint64_t index;     // Position in the stream
+    int value;
+};
+
+class SlidingWindow {
+public:
+    // One entry removed by push(), for the animation
+    struct Eviction {
+        WindowEntry entry;
+        bool fromMax;       // Max deque (else min deque)
+        bool expired;       // Slid out of the window (else dominated)
+    };
+
+private:
+    std::vector<WindowEntry> minRing;
+    std::vector<WindowEntry> maxRing;
+    size_t mask;
+    uint64_t minHead, minTail;      // Ever-increasing; slot = counter & mask
+    uint64_t maxHead, maxTail;
+    size_t width;
+    uint64_t pushed;
+
+    void advance(int value, std::vector<Eviction>* evictions);
+
+public:
+    explicit SlidingWindow(size_t windowWidth = 1);
+
+    // Empty the window and change its width (at least 1)
+    void reset(size_t windowWidth);
+
+    // Append the next stream value; 'evictions' (if given) receives the
+    // entries dropped from either deque, expired ones first
+    void push(int value, std::vector<Eviction>* evictions = nullptr);
+
+    // push() each value and write the min / max of the window ending at it
+    // (outputs may be nullptr). Windows at the start of the stream are
+    // shorter until 'width' values have arrived.
+    void pushBlock(const int* values, size_t count, int* minOut, int* maxOut);
+
+    // Extremes of the current window (0 before the first push)
+    int getMin() const;
+    int getMax() const;
+
+    size_t getWidth() const { return width; }
+    uint64_t getPushed() const { return pushed; }
+    bool isFull() const { return pushed >= width; }
+
+    // Deque contents, front (oldest) first
+    size_t minDequeSize() const { return static_cast<size_t>(minTail - minHead); }
+    size_t maxDequeSize() const { return static_cast<size_t>(maxTail - maxHead); }
+    const WindowEntry& minDequeAt(size_t i) const { return minRing[(minHead + i) & mask]; }
+    const WindowEntry& maxDequeAt(size_t i) const { return maxRing[(maxHead + i) & mask]; }
+
+    size_t memoryBytes() const;
+};
+
+#endif // SLIDING_WINDOW_H
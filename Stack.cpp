@@ -2,6 +2,7 @@
 // Description: Stack (LIFO) implementation.
 
 #include "Stack.h"
+#include "AllocationTracker.h"
 #include <sstream>
 
 Stack::Stack() : nextNodeId(0) {}
@@ -11,12 +12,14 @@ Stack::~Stack() {
 }
 
 StackNode* Stack::push(int value) {
+    AllocationTracker::Operation scope("Stack push");
     StackNode* newNode = new StackNode(value, nextNodeId++);
     elements.push_back(newNode);
     return newNode;
 }
 
 StackNode* Stack::pop() {
+    AllocationTracker::Operation scope("Stack pop");
     if (elements.empty()) {
         return nullptr;
     }
@@ -34,6 +37,7 @@ StackNode* Stack::peek() {
 }
 
 StackNode* Stack::search(int value, std::vector<StackNode*>& path) {
+    AllocationTracker::Operation scope("Stack search");
     // Search from top to bottom
     for (int i = static_cast<int>(elements.size()) - 1; i >= 0; i--) {
         path.push_back(elements[i]);
@@ -86,3 +90,18 @@ std::string Stack::toString() {
     return ss.str();
 }
 
+
+void Stack::loadValues(const std::vector<int>& values) {
+    clear();
+    elements.reserve(values.size());
+    for (int value : values) {
+        elements.push_back(new StackNode(value, nextNodeId++));
+    }
+}
+
+StackNode* Stack::getNode(int index) {
+    if (index >= 0 && index < static_cast<int>(elements.size())) {
+        return elements[index];
+    }
+    return nullptr;
+}
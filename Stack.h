@@ -7,11 +7,12 @@
 
 #include <vector>
 #include <string>
+#include "MemoryAccount.h"
 
 // ============================================================================
 // STACK NODE
 // ============================================================================
-struct StackNode {
+struct StackNode : TrackedAllocation<MemoryAccount::STRUCTURE_NODES> {
     int value;
     int id;
     float x, y;
@@ -60,8 +61,14 @@ public:
     // Get all nodes (from bottom to top)
     std::vector<StackNode*> getAllNodes();
     
+    // Get node at index (0 = bottom) without copying the whole stack
+    StackNode* getNode(int index);
+    
     // Get values as string (top to bottom)
     std::string toString();
+    
+    // Replace the contents with 'values' (bottom first) in O(n)
+    void loadValues(const std::vector<int>& values);
 };
 
 #endif // STACK_H
@@ -0,0 +1,349 @@
+// File: StreamSketch.cpp
+// Description: Memory-mapped input, parallel sketch ingest and the
+// --sketch report
+
+#include "StreamSketch.h"
+#include "FilterHash.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define STREAM_SKETCH_MMAP
+#endif
+
+namespace {
+    const size_t BATCH_CHUNK = 256;
+
+    bool hasSuffix(const std::string& text, const std::string& suffix) {
+        return text.size() >= suffix.size() &&
+               text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    double elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+// ============================================================================
+// MAPPED INPUT FILE
+// ============================================================================
+
+MappedIntFile::MappedIntFile()
+    : values(nullptr), count(0), mapping(nullptr), mappedBytes(0)
+{
+}
+
+MappedIntFile::~MappedIntFile() {
+    close();
+}
+
+void MappedIntFile::close() {
+#ifdef STREAM_SKETCH_MMAP
+    if (mapping) munmap(mapping, mappedBytes);
+#endif
+    mapping = nullptr;
+    mappedBytes = 0;
+    owned.clear();
+    owned.shrink_to_fit();
+    values = nullptr;
+    count = 0;
+}
+
+bool MappedIntFile::open(const std::string& path, std::string& error) {
+    close();
+
+    // Text trace: parse into memory
+    if (hasSuffix(path, ".txt") || hasSuffix(path, ".trace")) {
+        std::ifstream in(path);
+        if (!in) {
+            error = "Could not open " + path;
+            return false;
+        }
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(in, line)) {
+            lineNumber++;
+            size_t comment = line.find('#');
+            if (comment != std::string::npos) line.erase(comment);
+            std::istringstream tokens(line);
+            std::string token;
+            while (tokens >> token) {
+                char* end = nullptr;
+                long long value = std::strtoll(token.c_str(), &end, 10);
+                if (*end != '\0' || value < INT32_MIN || value > INT32_MAX) {
+                    error = path + ":" + std::to_string(lineNumber) + ": not an integer: " + token;
+                    owned.clear();
+                    return false;
+                }
+                owned.push_back(static_cast<int>(value));
+            }
+        }
+        values = owned.data();
+        count = owned.size();
+        return true;
+    }
+
+#ifdef STREAM_SKETCH_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "Could not open " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size % sizeof(int) != 0) {
+        ::close(fd);
+        error = path + " is not a file of 32-bit integers";
+        return false;
+    }
+    if (info.st_size > 0) {
+        void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            error = "Could not map " + path;
+            return false;
+        }
+        // One front-to-back pass: let the kernel read ahead aggressively
+        madvise(address, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+        mapping = address;
+        mappedBytes = static_cast<size_t>(info.st_size);
+        values = static_cast<const int*>(address);
+        count = mappedBytes / sizeof(int);
+    }
+    ::close(fd);                    // The mapping stays valid
+    return true;
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        error = "Could not open " + path;
+        return false;
+    }
+    std::streamsize bytes = in.tellg();
+    if (bytes % static_cast<std::streamsize>(sizeof(int)) != 0) {
+        error = path + " is not a file of 32-bit integers";
+        return false;
+    }
+    owned.resize(static_cast<size_t>(bytes) / sizeof(int));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(owned.data()), bytes);
+    values = owned.data();
+    count = owned.size();
+    return true;
+#endif
+}
+
+bool MappedIntFile::write(const std::string& path, const std::vector<int>& data, std::string& error) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "Could not create " + path;
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(data.data()),
+              static_cast<std::streamsize>(data.size() * sizeof(int)));
+    if (!out) {
+        error = "Could not write " + path;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// INGEST
+// ============================================================================
+
+StreamSketch::StreamSketch(uint32_t width, int depth, int precision)
+    : counts(width, depth), distinct(precision), itemCount(0)
+{
+}
+
+void StreamSketch::ingest(const int* values, size_t count, double phi, TaskPool& pool) {
+    phi = std::min(1.0, std::max(1e-6, phi));
+    size_t segments = pool.size();
+    size_t segmentLength = (count + segments - 1) / segments;
+
+    std::vector<CountMinSketch> partCounts(segments,
+        CountMinSketch(counts.getWidth(), counts.getDepth()));
+    std::vector<HyperLogLog> partDistinct(segments, HyperLogLog(distinct.getPrecision()));
+    std::vector<std::vector<int>> partCandidates(segments);
+
+    pool.parallelFor(segments, 1, [&](size_t first, size_t last) {
+        for (size_t s = first; s < last; s++) {
+            size_t begin = std::min(count, s * segmentLength);
+            size_t end = std::min(count, begin + segmentLength);
+            CountMinSketch& sketch = partCounts[s];
+            HyperLogLog& registers = partDistinct[s];
+
+            // Pruned back to the keys still above phi whenever it outgrows this
+            std::unordered_set<int> candidates;
+            size_t candidateLimit = static_cast<size_t>(4.0 / phi) + 16;
+
+            uint32_t h1[BATCH_CHUNK], h2[BATCH_CHUNK];
+            size_t seen = 0;
+            for (size_t offset = begin; offset < end; offset += BATCH_CHUNK) {
+                size_t n = std::min(BATCH_CHUNK, end - offset);
+                FilterHash::hashBatch(values + offset, n, h1, h2);
+                for (size_t i = 0; i < n; i++) {
+                    uint32_t estimate = sketch.addHashed(h1[i], h2[i]);
+                    registers.addHashed(FilterHash::combine(h1[i], h2[i]));
+                    seen++;
+                    if (estimate >= phi * seen) candidates.insert(values[offset + i]);
+                }
+                if (candidates.size() > candidateLimit) {
+                    for (auto it = candidates.begin(); it != candidates.end();) {
+                        if (sketch.estimate(*it) < phi * seen) it = candidates.erase(it);
+                        else ++it;
+                    }
+                }
+            }
+            partCandidates[s].assign(candidates.begin(), candidates.end());
+        }
+    });
+
+    counts.clear();
+    distinct.clear();
+    std::unordered_set<int> candidates;
+    for (size_t s = 0; s < segments; s++) {
+        counts.merge(partCounts[s]);
+        distinct.merge(partDistinct[s]);
+        candidates.insert(partCandidates[s].begin(), partCandidates[s].end());
+    }
+    itemCount = count;
+
+    heavyHitters.clear();
+    for (int key : candidates) {
+        uint64_t estimate = counts.estimate(key);
+        if (estimate >= phi * count) heavyHitters.push_back({key, estimate});
+    }
+    std::sort(heavyHitters.begin(), heavyHitters.end(), [](const HeavyHitter& a, const HeavyHitter& b) {
+        return a.estimate != b.estimate ? a.estimate > b.estimate : a.key < b.key;
+    });
+}
+
+// ============================================================================
+// SYNTHETIC STREAMS
+// ============================================================================
+
+void StreamSketch::generateZipf(size_t count, size_t universe, double exponent,
+                                unsigned seed, std::vector<int>& values) {
+    universe = std::max<size_t>(1, universe);
+    std::vector<double> cumulative(universe);
+    double sum = 0;
+    for (size_t rank = 0; rank < universe; rank++) {
+        sum += 1.0 / std::pow(static_cast<double>(rank + 1), exponent);
+        cumulative[rank] = sum;
+    }
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, sum);
+    values.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        size_t rank = std::lower_bound(cumulative.begin(), cumulative.end(), uniform(rng)) - cumulative.begin();
+        rank = std::min(rank, universe - 1);
+        // Odd multiplier and xor are both bijections, so ranks stay distinct
+        values[i] = static_cast<int>((static_cast<uint32_t>(rank + 1) * 2654435761u) ^ 0x5bd1e995u);
+    }
+}
+
+// ============================================================================
+// --sketch REPORT
+// ============================================================================
+
+int StreamSketch::analyzeFile(const std::string& path, std::ostream& out) {
+    const double PHI = 0.001;               // Heavy hitter: >= 0.1% of the stream
+    const double EPSILON = 0.0001;          // Count error <= 0.01% of the stream ...
+    const double DELTA = 0.001;             // ... with probability 99.9%
+    const int PRECISION = 14;
+
+    auto openStart = std::chrono::steady_clock::now();
+    MappedIntFile file;
+    std::string error;
+    if (!file.open(path, error)) {
+        out << error << "\n";
+        return 2;
+    }
+    double openMs = elapsedMs(openStart);
+    const int* values = file.data();
+    size_t count = file.size();
+
+    TaskPool& pool = TaskPool::shared();
+    CountMinSketch shape = CountMinSketch::forError(EPSILON, DELTA);
+    StreamSketch sketch(shape.getWidth(), shape.getDepth(), PRECISION);
+
+    out << std::fixed << std::setprecision(1);
+    out << "Stream: " << path << ", " << count << " values ("
+        << count * sizeof(int) / 1048576.0 << " MB, " << (file.isMapped() ? "memory-mapped" : "parsed")
+        << " in " << openMs << " ms)\n";
+
+    auto sketchStart = std::chrono::steady_clock::now();
+    sketch.ingest(values, count, PHI, pool);
+    double sketchMs = elapsedMs(sketchStart);
+
+    auto exactStart = std::chrono::steady_clock::now();
+    std::unordered_map<int, uint64_t> exact;
+    for (size_t i = 0; i < count; i++) {
+        exact[values[i]]++;
+    }
+    double exactMs = elapsedMs(exactStart);
+
+    // Approximate hash-map footprint: one node per key plus the bucket array
+    double exactBytes = exact.size() * (sizeof(void*) + sizeof(std::pair<const int, uint64_t>) + 8.0) +
+                        exact.bucket_count() * sizeof(void*);
+    double sketchBytes = static_cast<double>(sketch.getCounts().sizeInBytes() +
+                                             sketch.getDistinct().getRegisterCount());
+
+    out << "  ingest         sketches " << std::setw(9) << sketchMs << " ms ("
+        << std::setprecision(1) << (sketchMs > 0 ? count / sketchMs / 1000.0 : 0.0) << " M/s, "
+        << pool.size() << (pool.size() == 1 ? " thread, " : " threads, ") << sketchBytes / 1024.0 << " KB)\n"
+        << "                 hash map " << std::setw(9) << exactMs << " ms ("
+        << (exactMs > 0 ? count / exactMs / 1000.0 : 0.0) << " M/s, 1 thread, "
+        << exactBytes / 1024.0 << " KB)\n";
+
+    double distinctEstimate = sketch.getDistinct().estimate();
+    double distinctError = exact.empty() ? 0.0
+        : 100.0 * (distinctEstimate - exact.size()) / exact.size();
+    out << "  distinct       HyperLogLog " << std::setprecision(0) << distinctEstimate
+        << ", exact " << exact.size() << std::setprecision(2) << " (error " << distinctError
+        << "%, expected +/-" << 100.0 * sketch.getDistinct().standardError() << "%)\n";
+
+    // Heavy hitters: every key with >= phi * N occurrences must be reported
+    size_t trueHeavy = 0;
+    for (const auto& entry : exact) {
+        if (entry.second >= PHI * count) trueHeavy++;
+    }
+    size_t found = 0;
+    uint64_t worstOvercount = 0;
+    bool undercount = false;
+    for (const HeavyHitter& hitter : sketch.getHeavyHitters()) {
+        uint64_t truth = exact.count(hitter.key) ? exact.at(hitter.key) : 0;
+        if (truth >= PHI * count) found++;
+        if (hitter.estimate < truth) undercount = true;
+        worstOvercount = std::max(worstOvercount, hitter.estimate - std::min(hitter.estimate, truth));
+    }
+    out << "  heavy hitters  (>= " << std::setprecision(1) << 100.0 * PHI << "% of the stream) "
+        << sketch.getHeavyHitters().size() << " reported, " << found << " of " << trueHeavy
+        << " true ones found; worst overcount " << worstOvercount << " (bound "
+        << std::setprecision(0) << std::exp(1.0) / shape.getWidth() * count << ")\n";
+
+    out << "      key           estimate        exact\n";
+    for (size_t i = 0; i < sketch.getHeavyHitters().size() && i < 10; i++) {
+        const HeavyHitter& hitter = sketch.getHeavyHitters()[i];
+        out << "  " << std::setw(11) << hitter.key << std::setw(15) << hitter.estimate
+            << std::setw(13) << (exact.count(hitter.key) ? exact.at(hitter.key) : 0) << "\n";
+    }
+
+    bool ok = found == trueHeavy && !undercount;
+    out << (ok ? "  all heavy hitters found, no undercounts\n"
+               : "  MISSED heavy hitter or undercount\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+// File: StreamSketch.h
+// Description: Streaming analytics over large integer files: a count-min
+// sketch for heavy hitters and a HyperLogLog for the number of distinct
+// values, built in one pass.
+//
+// Input files are either raw native-endian int32 values (any name), which
+// are memory-mapped so a multi-gigabyte stream never has to be copied, or
+// text traces (*.txt / *.trace: whitespace-separated integers, '#' starts
+// a comment), which are parsed into memory.
+//
+// Ingest splits the stream into one segment per TaskPool thread. Each
+// segment fills its own sketches (no shared counters, no atomics) and the
+// partial sketches are merged at the end. Heavy-hitter candidates are kept
+// per segment: a key whose estimate reaches phi * (items seen so far) is
+// remembered. A key with at least phi * N occurrences overall has at least
+// phi * N_s in some segment s, so it is always among the candidates; the
+// merged sketch then decides which candidates really pass phi * N.
+//
+// Usage:
+//   DSVisualizer --sketch FILE     Sketch FILE and compare with exact counts
+
+#ifndef STREAM_SKETCH_H
+#define STREAM_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "CountMinSketch.h"
+#include "HyperLogLog.h"
+#include "TaskPool.h"
+
+// ============================================================================
+// MAPPED INPUT FILE
+// ============================================================================
+class MappedIntFile {
+private:
+    const int* values;
+    size_t count;
+    void* mapping;                  // mmap() result, nullptr if not mapped
+    size_t mappedBytes;
+    std::vector<int> owned;         // Parsed text traces / no-mmap fallback
+
+public:
+    MappedIntFile();
+    ~MappedIntFile();
+    MappedIntFile(const MappedIntFile&) = delete;
+    MappedIntFile& operator=(const MappedIntFile&) = delete;
+
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    const int* data() const { return values; }
+    size_t size() const { return count; }
+    bool isMapped() const { return mapping != nullptr; }
+
+    // Write values as a raw int32 file
+    static bool write(const std::string& path, const std::vector<int>& values, std::string& error);
+};
+
+// ============================================================================
+// STREAM SKETCH
+// ============================================================================
+struct HeavyHitter {
+    int key;
+    uint64_t estimate;
+};
+
+class StreamSketch {
+private:
+    CountMinSketch counts;
+    HyperLogLog distinct;
+    std::vector<HeavyHitter> heavyHitters;     // Estimate >= phi * N, largest first
+    uint64_t itemCount;
+
+public:
+    StreamSketch(uint32_t width, int depth, int precision);
+
+    // Replace the contents with a sketch of values[0..count), built in
+    // parallel; heavy hitters are keys with at least phi * count occurrences
+    void ingest(const int* values, size_t count, double phi, TaskPool& pool);
+
+    const CountMinSketch& getCounts() const { return counts; }
+    const HyperLogLog& getDistinct() const { return distinct; }
+    const std::vector<HeavyHitter>& getHeavyHitters() const { return heavyHitters; }
+    uint64_t getItemCount() const { return itemCount; }
+
+    // Synthetic skewed stream: 'count' draws from 'universe' keys with
+    // Zipf exponent 'exponent'. Ranks are scrambled into arbitrary ints.
+    static void generateZipf(size_t count, size_t universe, double exponent,
+                             unsigned seed, std::vector<int>& values);
+
+    // Sketch a file and compare against an exact hash-map count
+    // (the --sketch command); returns the exit code
+    static int analyzeFile(const std::string& path, std::ostream& out);
+};
+
+#endif // STREAM_SKETCH_H
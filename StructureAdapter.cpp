@@ -0,0 +1,555 @@
+// File: StructureAdapter.cpp
+// Description: Adapter implementations - thin wrappers that translate
+// node-pointer paths into id paths and take care of freeing removed nodes.
+
+#include "StructureAdapter.h"
+#include <sstream>
+
+bool StructureAdapter::parseKind(const std::string& text, StructureKind& kind) {
+    if (text == "bst") { kind = StructureKind::BST; return true; }
+    if (text == "avl") { kind = StructureKind::AVL; return true; }
+    if (text == "list" || text == "linkedlist") { kind = StructureKind::LINKED_LIST; return true; }
+    if (text == "stack") { kind = StructureKind::STACK; return true; }
+    if (text == "queue") { kind = StructureKind::QUEUE; return true; }
+    if (text == "heap" || text == "minheap") { kind = StructureKind::MIN_HEAP; return true; }
+    if (text == "scapegoat") { kind = StructureKind::SCAPEGOAT; return true; }
+    return false;
+}
+
+// Helper: format a value list the way the GUI panels do
+static std::string formatValues(const std::vector<int>& values) {
+    if (values.empty()) return "[ Empty ]";
+    std::ostringstream ss;
+    ss << "[ ";
+    for (size_t i = 0; i < values.size(); i++) {
+        ss << values[i];
+        if (i < values.size() - 1) ss << ", ";
+    }
+    ss << " ]";
+    return ss.str();
+}
+
+// ============================================================================
+// BST ADAPTER
+// ============================================================================
+
+bool BSTAdapter::insert(int value, std::vector<int>& pathIds) {
+    std::vector<Node*> path;
+    bool success = bst.insert(value, path);
+    for (Node* n : path) pathIds.push_back(n->id);
+    return success;
+}
+
+bool BSTAdapter::remove(int value, std::vector<int>& pathIds) {
+    std::vector<Node*> path;
+    Node* deletedNode = nullptr;
+    Node* successor = nullptr;
+    bool success = bst.remove(value, path, deletedNode, successor);
+    for (Node* n : path) pathIds.push_back(n->id);
+
+    // With two children the successor is the node that leaves the tree;
+    // 'deletedNode' keeps its place and just takes the successor's value.
+    if (success) {
+        delete (successor ? successor : deletedNode);
+    }
+    return success;
+}
+
+bool BSTAdapter::search(int value, std::vector<int>& pathIds) {
+    std::vector<Node*> path;
+    Node* result = bst.search(value, path);
+    for (Node* n : path) pathIds.push_back(n->id);
+    return result != nullptr;
+}
+
+bool BSTAdapter::pop(int& value) {
+    // Remove the minimum (leftmost) value
+    Node* node = bst.getRoot();
+    if (node == nullptr) return false;
+    while (node->left) node = node->left;
+    value = node->value;
+    std::vector<int> pathIds;
+    return remove(value, pathIds);
+}
+
+void BSTAdapter::clear() {
+    bst.clear();
+}
+
+int BSTAdapter::size() {
+    return static_cast<int>(bst.getAllNodes().size());
+}
+
+std::string BSTAdapter::toString() {
+    return formatValues(bst.inorderTraversal());
+}
+
+void BSTAdapter::snapshot(StructureSnapshot& snap) {
+    snap.shape = SnapshotShape::TREE;
+    snap.title = name();
+    computeTidyLayout(bst.getRoot(), snap.cells, snap.height);
+}
+
+void BSTAdapter::exportValues(std::vector<int>& values) {
+    values = bst.preorderTraversal();
+}
+
+void BSTAdapter::bulkLoad(const std::vector<int>& values) {
+    bst.loadPreorder(values);
+}
+
+void BSTAdapter::visitShape(ShapeVisitor& visitor) {
+    visitor.beginTree(kind());
+    Node* root = bst.getRoot();
+    visitPostorder(root, [&visitor](Node* node, int height) {
+        visitor.treeNode(node->id, node->value, height,
+                         node->left ? node->left->id : -1,
+                         node->right ? node->right->id : -1);
+    });
+    visitor.endTree(root ? root->id : -1);
+}
+
+// ============================================================================
+// SCAPEGOAT ADAPTER
+// ============================================================================
+
+bool ScapegoatAdapter::insert(int value, std::vector<int>& pathIds) {
+    std::vector<Node*> path;
+    bool success = tree.insert(value, path);
+    for (Node* n : path) pathIds.push_back(n->id);
+    return success;
+}
+
+bool ScapegoatAdapter::remove(int value, std::vector<int>& pathIds) {
+    return tree.remove(value, pathIds);
+}
+
+bool ScapegoatAdapter::search(int value, std::vector<int>& pathIds) {
+    std::vector<Node*> path;
+    Node* result = tree.search(value, path);
+    for (Node* n : path) pathIds.push_back(n->id);
+    return result != nullptr;
+}
+
+bool ScapegoatAdapter::pop(int& value) {
+    // Remove the minimum (leftmost) value
+    Node* node = tree.getRoot();
+    if (node == nullptr) return false;
+    while (node->left) node = node->left;
+    value = node->value;
+    std::vector<int> pathIds;
+    return tree.remove(value, pathIds);
+}
+
+void ScapegoatAdapter::clear() {
+    tree.clear();
+}
+
+int ScapegoatAdapter::size() {
+    return tree.size();
+}
+
+std::string ScapegoatAdapter::toString() {
+    return formatValues(tree.inorderTraversal());
+}
+
+void ScapegoatAdapter::snapshot(StructureSnapshot& snap) {
+    snap.shape = SnapshotShape::TREE;
+    snap.title = name();
+    computeTidyLayout(tree.getRoot(), snap.cells, snap.height);
+}
+
+void ScapegoatAdapter::exportValues(std::vector<int>& values) {
+    values = tree.preorderTraversal();
+}
+
+void ScapegoatAdapter::bulkLoad(const std::vector<int>& values) {
+    tree.loadPreorder(values);
+}
+
+void ScapegoatAdapter::visitShape(ShapeVisitor& visitor) {
+    visitor.beginTree(kind());
+    Node* root = tree.getRoot();
+    visitPostorder(root, [&visitor](Node* node, int height) {
+        visitor.treeNode(node->id, node->value, height,
+                         node->left ? node->left->id : -1,
+                         node->right ? node->right->id : -1);
+    });
+    visitor.endTree(root ? root->id : -1);
+}
+
+// ============================================================================
+// AVL ADAPTER
+// ============================================================================
+
+bool AVLAdapter::insert(int value, std::vector<int>& pathIds) {
+    std::vector<AVLNode*> path;
+    RotationType rotation;
+    bool success = avl.insert(value, path, rotation);
+    for (AVLNode* n : path) pathIds.push_back(n->id);
+    return success;
+}
+
+bool AVLAdapter::remove(int value, std::vector<int>& pathIds) {
+    std::vector<AVLNode*> path;
+    AVLNode* deletedNode = nullptr;
+    RotationType rotation;
+    bool success = avl.remove(value, path, deletedNode, rotation);
+    for (AVLNode* n : path) pathIds.push_back(n->id);
+    if (success && deletedNode) {
+        delete deletedNode;
+    }
+    return success;
+}
+
+bool AVLAdapter::search(int value, std::vector<int>& pathIds) {
+    std::vector<AVLNode*> path;
+    AVLNode* result = avl.search(value, path);
+    for (AVLNode* n : path) pathIds.push_back(n->id);
+    return result != nullptr;
+}
+
+bool AVLAdapter::pop(int& value) {
+    AVLNode* node = avl.getRoot();
+    if (node == nullptr) return false;
+    while (node->left) node = node->left;
+    value = node->value;
+    std::vector<int> pathIds;
+    return remove(value, pathIds);
+}
+
+void AVLAdapter::clear() {
+    avl.clear();
+}
+
+int AVLAdapter::size() {
+    return static_cast<int>(avl.getAllNodes().size());
+}
+
+std::string AVLAdapter::toString() {
+    return formatValues(avl.inorderTraversal());
+}
+
+void AVLAdapter::snapshot(StructureSnapshot& snap) {
+    snap.shape = SnapshotShape::TREE;
+    snap.title = name();
+    computeTidyLayout(avl.getRoot(), snap.cells, snap.height);
+}
+
+void AVLAdapter::exportValues(std::vector<int>& values) {
+    values = avl.preorderTraversal();
+}
+
+void AVLAdapter::bulkLoad(const std::vector<int>& values) {
+    avl.loadPreorder(values);
+}
+
+void AVLAdapter::visitShape(ShapeVisitor& visitor) {
+    visitor.beginTree(kind());
+    AVLNode* root = avl.getRoot();
+    visitPostorder(root, [&visitor](AVLNode* node, int /*height*/) {
+        visitor.treeNode(node->id, node->value, node->height,
+                         node->left ? node->left->id : -1,
+                         node->right ? node->right->id : -1);
+    });
+    visitor.endTree(root ? root->id : -1);
+}
+
+// ============================================================================
+// LINKED LIST ADAPTER
+// ============================================================================
+
+bool LinkedListAdapter::insert(int value, std::vector<int>& pathIds) {
+    std::vector<ListNode*> path;
+    bool success = list.insertAtTail(value, path);
+    for (ListNode* n : path) pathIds.push_back(n->id);
+    return success;
+}
+
+bool LinkedListAdapter::remove(int value, std::vector<int>& pathIds) {
+    std::vector<ListNode*> path;
+    ListNode* deletedNode = nullptr;
+    bool success = list.remove(value, path, deletedNode);
+    for (ListNode* n : path) pathIds.push_back(n->id);
+    if (deletedNode) delete deletedNode;
+    return success;
+}
+
+bool LinkedListAdapter::search(int value, std::vector<int>& pathIds) {
+    std::vector<ListNode*> path;
+    ListNode* result = list.search(value, path);
+    for (ListNode* n : path) pathIds.push_back(n->id);
+    return result != nullptr;
+}
+
+bool LinkedListAdapter::pop(int& value) {
+    ListNode* head = list.getHead();
+    if (head == nullptr) return false;
+    value = head->value;
+    std::vector<int> pathIds;
+    return remove(value, pathIds);
+}
+
+void LinkedListAdapter::clear() {
+    list.clear();
+}
+
+int LinkedListAdapter::size() {
+    return list.getSize();
+}
+
+std::string LinkedListAdapter::toString() {
+    return list.toString();
+}
+
+void LinkedListAdapter::snapshot(StructureSnapshot& snap) {
+    snap.shape = SnapshotShape::LINKED;
+    snap.title = name();
+    snap.height = 1;
+    computeLinearLayout(list.getAllNodes(), snap.cells);
+}
+
+void LinkedListAdapter::exportValues(std::vector<int>& values) {
+    values.clear();
+    values.reserve(list.getSize());
+    for (ListNode* node = list.getHead(); node != nullptr; node = node->next) {
+        values.push_back(node->value);
+    }
+}
+
+void LinkedListAdapter::bulkLoad(const std::vector<int>& values) {
+    list.loadValues(values);
+}
+
+void LinkedListAdapter::visitShape(ShapeVisitor& visitor) {
+    visitor.beginSequence(kind());
+    for (ListNode* node = list.getHead(); node != nullptr; node = node->next) {
+        visitor.element(node->id, node->value);
+    }
+    visitor.endSequence();
+}
+
+// ============================================================================
+// STACK ADAPTER
+// ============================================================================
+
+bool StackAdapter::insert(int value, std::vector<int>& pathIds) {
+    StackNode* node = stack.push(value);
+    pathIds.push_back(node->id);
+    return true;
+}
+
+bool StackAdapter::remove(int /*value*/, std::vector<int>& pathIds) {
+    StackNode* top = stack.pop();
+    if (top == nullptr) return false;
+    pathIds.push_back(top->id);
+    delete top;
+    return true;
+}
+
+bool StackAdapter::search(int value, std::vector<int>& pathIds) {
+    std::vector<StackNode*> path;
+    StackNode* result = stack.search(value, path);
+    for (StackNode* n : path) pathIds.push_back(n->id);
+    return result != nullptr;
+}
+
+bool StackAdapter::pop(int& value) {
+    StackNode* top = stack.pop();
+    if (top == nullptr) return false;
+    value = top->value;
+    delete top;
+    return true;
+}
+
+void StackAdapter::clear() {
+    stack.clear();
+}
+
+int StackAdapter::size() {
+    return stack.getSize();
+}
+
+std::string StackAdapter::toString() {
+    return stack.toString();
+}
+
+void StackAdapter::snapshot(StructureSnapshot& snap) {
+    snap.shape = SnapshotShape::STACK;
+    snap.title = name();
+    snap.height = 1;
+    computeLinearLayout(stack.getAllNodes(), snap.cells);
+}
+
+void StackAdapter::exportValues(std::vector<int>& values) {
+    values.clear();
+    for (StackNode* node : stack.getAllNodes()) {
+        values.push_back(node->value);
+    }
+}
+
+void StackAdapter::bulkLoad(const std::vector<int>& values) {
+    stack.loadValues(values);
+}
+
+void StackAdapter::visitShape(ShapeVisitor& visitor) {
+    visitor.beginSequence(kind());
+    for (int i = stack.getSize() - 1; i >= 0; i--) {
+        StackNode* node = stack.getNode(i);
+        visitor.element(node->id, node->value);
+    }
+    visitor.endSequence();
+}
+
+// ============================================================================
+// QUEUE ADAPTER
+// ============================================================================
+
+bool QueueAdapter::insert(int value, std::vector<int>& pathIds) {
+    QueueNode* node = queue.enqueue(value);
+    pathIds.push_back(node->id);
+    return true;
+}
+
+bool QueueAdapter::remove(int /*value*/, std::vector<int>& pathIds) {
+    QueueNode* front = queue.dequeue();
+    if (front == nullptr) return false;
+    pathIds.push_back(front->id);
+    delete front;
+    return true;
+}
+
+bool QueueAdapter::search(int value, std::vector<int>& pathIds) {
+    std::vector<QueueNode*> path;
+    QueueNode* result = queue.search(value, path);
+    for (QueueNode* n : path) pathIds.push_back(n->id);
+    return result != nullptr;
+}
+
+bool QueueAdapter::pop(int& value) {
+    QueueNode* front = queue.dequeue();
+    if (front == nullptr) return false;
+    value = front->value;
+    delete front;
+    return true;
+}
+
+void QueueAdapter::clear() {
+    queue.clear();
+}
+
+int QueueAdapter::size() {
+    return queue.getSize();
+}
+
+std::string QueueAdapter::toString() {
+    return queue.toString();
+}
+
+void QueueAdapter::snapshot(StructureSnapshot& snap) {
+    snap.shape = SnapshotShape::QUEUE;
+    snap.title = name();
+    snap.height = 1;
+    computeLinearLayout(queue.getAllNodes(), snap.cells);
+}
+
+void QueueAdapter::exportValues(std::vector<int>& values) {
+    values.clear();
+    for (QueueNode* node : queue.getAllNodes()) {
+        values.push_back(node->value);
+    }
+}
+
+void QueueAdapter::bulkLoad(const std::vector<int>& values) {
+    queue.loadValues(values);
+}
+
+void QueueAdapter::visitShape(ShapeVisitor& visitor) {
+    visitor.beginSequence(kind());
+    for (int i = 0; i < queue.getSize(); i++) {
+        QueueNode* node = queue.getNode(i);
+        visitor.element(node->id, node->value);
+    }
+    visitor.endSequence();
+}
+
+// ============================================================================
+// MIN HEAP ADAPTER
+// ============================================================================
+// The heap reports array indices; they are translated to the ids of the
+// nodes sitting at those indices once the sift has finished.
+// ============================================================================
+
+bool MinHeapAdapter::insert(int value, std::vector<int>& pathIds) {
+    std::vector<int> siftPath;
+    heap.insert(value, siftPath);
+    for (int index : siftPath) {
+        if (HeapNode* n = heap.getNode(index)) pathIds.push_back(n->id);
+    }
+    return true;
+}
+
+bool MinHeapAdapter::remove(int value, std::vector<int>& pathIds) {
+    std::vector<int> siftPath;
+    bool success = heap.remove(value, siftPath);
+    for (int index : siftPath) {
+        if (HeapNode* n = heap.getNode(index)) pathIds.push_back(n->id);
+    }
+    return success;
+}
+
+bool MinHeapAdapter::search(int value, std::vector<int>& pathIds) {
+    std::vector<int> searchPath;
+    int index = heap.search(value, searchPath);
+    for (int i : searchPath) {
+        if (HeapNode* n = heap.getNode(i)) pathIds.push_back(n->id);
+    }
+    return index >= 0;
+}
+
+bool MinHeapAdapter::pop(int& value) {
+    std::vector<int> siftPath;
+    HeapNode* minNode = heap.extractMin(siftPath);
+    if (minNode == nullptr) return false;
+    value = minNode->value;
+    delete minNode;
+    return true;
+}
+
+void MinHeapAdapter::clear() {
+    heap.clear();
+}
+
+int MinHeapAdapter::size() {
+    return heap.getSize();
+}
+
+std::string MinHeapAdapter::toString() {
+    return heap.toString();
+}
+
+void MinHeapAdapter::snapshot(StructureSnapshot& snap) {
+    snap.shape = SnapshotShape::TREE;
+    snap.title = name();
+    computeImplicitLayout(heap.getAllNodes(), snap.cells, snap.height);
+}
+
+void MinHeapAdapter::exportValues(std::vector<int>& values) {
+    values.clear();
+    for (HeapNode* node : heap.getAllNodes()) {
+        values.push_back(node->value);
+    }
+}
+
+void MinHeapAdapter::bulkLoad(const std::vector<int>& values) {
+    heap.loadValues(values);
+}
+
+void MinHeapAdapter::visitShape(ShapeVisitor& visitor) {
+    visitor.beginSequence(kind());
+    for (int i = 0; i < heap.getSize(); i++) {
+        HeapNode* node = heap.getNode(i);
+        visitor.element(node->id, node->value);
+    }
+    visitor.endSequence();
+}
@@ -0,0 +1,285 @@
+// File: StructureAdapter.h
+// Description: A common interface over all data structures.
+// The GUI modes talk to their structure directly, but tools that work
+// with "whatever structure is active" (the headless driver, the terminal
+// renderer) go through these adapters instead.
+// Adapters never own the structure they wrap.
+
+#ifndef STRUCTURE_ADAPTER_H
+#define STRUCTURE_ADAPTER_H
+
+#include <string>
+#include <vector>
+#include "BST.h"
+#include "AVLTree.h"
+#include "LinkedList.h"
+#include "Stack.h"
+#include "Queue.h"
+#include "MinHeap.h"
+#include "ScapegoatTree.h"
+#include "InvariantChecker.h"
+#include "TreeLayout.h"
+
+// ============================================================================
+// STRUCTURE KIND
+// ============================================================================
+enum class StructureKind {
+    BST,
+    AVL,
+    LINKED_LIST,
+    STACK,
+    QUEUE,
+    MIN_HEAP,
+    SCAPEGOAT
+};
+
+// ============================================================================
+// SHAPE VISITOR
+// ============================================================================
+// Receives the shape of a structure one node at a time (see
+// StructureExporter), so nothing proportional to its size is built.
+// - trees arrive in post-order (children first); -1 means "no child"
+// - everything else arrives as a sequence: list head first, stack top
+//   first, queue front first, heap in array order (index i has children
+//   2i+1 and 2i+2)
+// ============================================================================
+class ShapeVisitor {
+public:
+    virtual ~ShapeVisitor() {}
+
+    virtual void beginTree(StructureKind kind) = 0;
+    virtual void treeNode(int id, int value, int height, int leftId, int rightId) = 0;
+    virtual void endTree(int rootId) = 0;
+
+    virtual void beginSequence(StructureKind kind) = 0;
+    virtual void element(int id, int value) = 0;
+    virtual void endSequence() = 0;
+};
+
+// ============================================================================
+// STRUCTURE ADAPTER (ABSTRACT)
+// ============================================================================
+// Every operation fills 'pathIds' with the ids of the nodes it visited,
+// in order, so callers can animate it without knowing the node type.
+// - insert: push / enqueue for stacks and queues, tail insert for lists
+// - remove: value-based where the structure supports it; stacks and queues
+//           always pop / dequeue (the value is ignored)
+// - pop:    pop, dequeue, extract-min, or remove the list head
+// ============================================================================
+class StructureAdapter {
+public:
+    virtual ~StructureAdapter() {}
+
+    virtual StructureKind kind() const = 0;
+    virtual std::string name() const = 0;
+
+    virtual bool insert(int value, std::vector<int>& pathIds) = 0;
+    virtual bool remove(int value, std::vector<int>& pathIds) = 0;
+    virtual bool search(int value, std::vector<int>& pathIds) = 0;
+    virtual bool pop(int& value) = 0;
+    virtual void clear() = 0;
+    virtual int size() = 0;
+
+    // Contents as a one-line string (same format as the GUI panels)
+    virtual std::string toString() = 0;
+
+    // Capture the current shape for renderers that don't use SFML
+    virtual void snapshot(StructureSnapshot& snap) = 0;
+
+    // Save / restore the contents in O(n). bulkLoad(exportValues()) rebuilds
+    // the same structure - trees keep their exact shape (pre-order).
+    virtual void exportValues(std::vector<int>& values) = 0;
+    virtual void bulkLoad(const std::vector<int>& values) = 0;
+
+    // Stream the shape to 'visitor' using O(height) extra memory
+    virtual void visitShape(ShapeVisitor& visitor) = 0;
+
+    // Live shape statistics for trees that maintain them (BST, AVL);
+    // nullptr otherwise
+    virtual const ShapeStats* shapeStats() const { return nullptr; }
+
+    // Integrity checks (see InvariantChecker.h): every node, or a sample of
+    // at most sampler.budget() nodes
+    virtual InvariantReport checkInvariants() = 0;
+    virtual InvariantReport sampleInvariants(InvariantSampler& sampler) = 0;
+
+    // Parse a structure name ("bst", "avl", "list", "stack", "queue", "heap",
+    // "scapegoat")
+    static bool parseKind(const std::string& text, StructureKind& kind);
+};
+
+// ============================================================================
+// CONCRETE ADAPTERS
+// ============================================================================
+
+class BSTAdapter : public StructureAdapter {
+private:
+    BST& bst;
+public:
+    explicit BSTAdapter(BST& tree) : bst(tree) {}
+    StructureKind kind() const override { return StructureKind::BST; }
+    std::string name() const override { return "Binary Search Tree"; }
+    const ShapeStats* shapeStats() const override { return &bst.getShapeStats(); }
+    InvariantReport checkInvariants() override { return InvariantChecker::check(bst); }
+    InvariantReport sampleInvariants(InvariantSampler& sampler) override {
+        return InvariantChecker::sample(bst, sampler);
+    }
+    bool insert(int value, std::vector<int>& pathIds) override;
+    bool remove(int value, std::vector<int>& pathIds) override;
+    bool search(int value, std::vector<int>& pathIds) override;
+    bool pop(int& value) override;
+    void clear() override;
+    int size() override;
+    std::string toString() override;
+    void snapshot(StructureSnapshot& snap) override;
+    void exportValues(std::vector<int>& values) override;
+    void bulkLoad(const std::vector<int>& values) override;
+    void visitShape(ShapeVisitor& visitor) override;
+};
+
+class ScapegoatAdapter : public StructureAdapter {
+private:
+    ScapegoatTree& tree;
+public:
+    explicit ScapegoatAdapter(ScapegoatTree& scapegoat) : tree(scapegoat) {}
+    StructureKind kind() const override { return StructureKind::SCAPEGOAT; }
+    std::string name() const override { return "Scapegoat Tree"; }
+    InvariantReport checkInvariants() override { return InvariantChecker::check(tree); }
+    InvariantReport sampleInvariants(InvariantSampler& sampler) override {
+        return InvariantChecker::sample(tree, sampler);
+    }
+    bool insert(int value, std::vector<int>& pathIds) override;
+    bool remove(int value, std::vector<int>& pathIds) override;
+    bool search(int value, std::vector<int>& pathIds) override;
+    bool pop(int& value) override;
+    void clear() override;
+    int size() override;
+    std::string toString() override;
+    void snapshot(StructureSnapshot& snap) override;
+    void exportValues(std::vector<int>& values) override;
+    void bulkLoad(const std::vector<int>& values) override;
+    void visitShape(ShapeVisitor& visitor) override;
+};
+
+class AVLAdapter : public StructureAdapter {
+private:
+    AVLTree& avl;
+public:
+    explicit AVLAdapter(AVLTree& tree) : avl(tree) {}
+    StructureKind kind() const override { return StructureKind::AVL; }
+    std::string name() const override { return "AVL Tree"; }
+    const ShapeStats* shapeStats() const override { return &avl.getShapeStats(); }
+    InvariantReport checkInvariants() override { return InvariantChecker::check(avl); }
+    InvariantReport sampleInvariants(InvariantSampler& sampler) override {
+        return InvariantChecker::sample(avl, sampler);
+    }
+    bool insert(int value, std::vector<int>& pathIds) override;
+    bool remove(int value, std::vector<int>& pathIds) override;
+    bool search(int value, std::vector<int>& pathIds) override;
+    bool pop(int& value) override;
+    void clear() override;
+    int size() override;
+    std::string toString() override;
+    void snapshot(StructureSnapshot& snap) override;
+    void exportValues(std::vector<int>& values) override;
+    void bulkLoad(const std::vector<int>& values) override;
+    void visitShape(ShapeVisitor& visitor) override;
+};
+
+class LinkedListAdapter : public StructureAdapter {
+private:
+    LinkedList& list;
+public:
+    explicit LinkedListAdapter(LinkedList& linkedList) : list(linkedList) {}
+    StructureKind kind() const override { return StructureKind::LINKED_LIST; }
+    std::string name() const override { return "Linked List"; }
+    InvariantReport checkInvariants() override { return InvariantChecker::check(list); }
+    InvariantReport sampleInvariants(InvariantSampler& sampler) override {
+        return InvariantChecker::sample(list, sampler);
+    }
+    bool insert(int value, std::vector<int>& pathIds) override;
+    bool remove(int value, std::vector<int>& pathIds) override;
+    bool search(int value, std::vector<int>& pathIds) override;
+    bool pop(int& value) override;
+    void clear() override;
+    int size() override;
+    std::string toString() override;
+    void snapshot(StructureSnapshot& snap) override;
+    void exportValues(std::vector<int>& values) override;
+    void bulkLoad(const std::vector<int>& values) override;
+    void visitShape(ShapeVisitor& visitor) override;
+};
+
+class StackAdapter : public StructureAdapter {
+private:
+    Stack& stack;
+public:
+    explicit StackAdapter(Stack& s) : stack(s) {}
+    StructureKind kind() const override { return StructureKind::STACK; }
+    std::string name() const override { return "Stack (LIFO)"; }
+    InvariantReport checkInvariants() override { return InvariantChecker::check(stack); }
+    InvariantReport sampleInvariants(InvariantSampler& sampler) override {
+        return InvariantChecker::sample(stack, sampler);
+    }
+    bool insert(int value, std::vector<int>& pathIds) override;
+    bool remove(int value, std::vector<int>& pathIds) override;
+    bool search(int value, std::vector<int>& pathIds) override;
+    bool pop(int& value) override;
+    void clear() override;
+    int size() override;
+    std::string toString() override;
+    void snapshot(StructureSnapshot& snap) override;
+    void exportValues(std::vector<int>& values) override;
+    void bulkLoad(const std::vector<int>& values) override;
+    void visitShape(ShapeVisitor& visitor) override;
+};
+
+class QueueAdapter : public StructureAdapter {
+private:
+    Queue& queue;
+public:
+    explicit QueueAdapter(Queue& q) : queue(q) {}
+    StructureKind kind() const override { return StructureKind::QUEUE; }
+    std::string name() const override { return "Queue (FIFO)"; }
+    InvariantReport checkInvariants() override { return InvariantChecker::check(queue); }
+    InvariantReport sampleInvariants(InvariantSampler& sampler) override {
+        return InvariantChecker::sample(queue, sampler);
+    }
+    bool insert(int value, std::vector<int>& pathIds) override;
+    bool remove(int value, std::vector<int>& pathIds) override;
+    bool search(int value, std::vector<int>& pathIds) override;
+    bool pop(int& value) override;
+    void clear() override;
+    int size() override;
+    std::string toString() override;
+    void snapshot(StructureSnapshot& snap) override;
+    void exportValues(std::vector<int>& values) override;
+    void bulkLoad(const std::vector<int>& values) override;
+    void visitShape(ShapeVisitor& visitor) override;
+};
+
+class MinHeapAdapter : public StructureAdapter {
+private:
+    MinHeap& heap;
+public:
+    explicit MinHeapAdapter(MinHeap& h) : heap(h) {}
+    StructureKind kind() const override { return StructureKind::MIN_HEAP; }
+    std::string name() const override { return "Min-Heap"; }
+    InvariantReport checkInvariants() override { return InvariantChecker::check(heap); }
+    InvariantReport sampleInvariants(InvariantSampler& sampler) override {
+        return InvariantChecker::sample(heap, sampler);
+    }
+    bool insert(int value, std::vector<int>& pathIds) override;
+    bool remove(int value, std::vector<int>& pathIds) override;
+    bool search(int value, std::vector<int>& pathIds) override;
+    bool pop(int& value) override;
+    void clear() override;
+    int size() override;
+    std::string toString() override;
+    void snapshot(StructureSnapshot& snap) override;
+    void exportValues(std::vector<int>& values) override;
+    void bulkLoad(const std::vector<int>& values) override;
+    void visitShape(ShapeVisitor& visitor) override;
+};
+
+#endif // STRUCTURE_ADAPTER_H
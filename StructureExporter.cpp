@@ -0,0 +1,327 @@
+// File: StructureExporter.cpp
+// Description: DOT / JSON shape writers and the buffered file writer.
+
+#include "StructureExporter.h"
+#include <cstring>
+#include <cerrno>
+
+// ============================================================================
+// BUFFERED WRITER
+// ============================================================================
+
+BufferedWriter::BufferedWriter(const std::string& path, size_t capacity)
+    : file(std::fopen(path.c_str(), "wb")), buffer(capacity), used(0), failed(false)
+{
+}
+
+BufferedWriter::~BufferedWriter() {
+    close();
+}
+
+void BufferedWriter::flushBuffer() {
+    if (used > 0 && file) {
+        if (std::fwrite(buffer.data(), 1, used, file) != used) failed = true;
+    }
+    used = 0;
+}
+
+void BufferedWriter::write(const char* text, size_t length) {
+    if (used + length > buffer.size()) {
+        flushBuffer();
+        if (length > buffer.size()) {
+            // Larger than the whole buffer: write straight through
+            if (file && std::fwrite(text, 1, length, file) != length) failed = true;
+            return;
+        }
+    }
+    std::memcpy(buffer.data() + used, text, length);
+    used += length;
+}
+
+void BufferedWriter::write(const char* text) {
+    write(text, std::strlen(text));
+}
+
+void BufferedWriter::put(char c) {
+    if (used == buffer.size()) flushBuffer();
+    buffer[used++] = c;
+}
+
+void BufferedWriter::writeInt(long long value) {
+    // Digits are produced backwards into a small scratch area
+    char digits[24];
+    int length = 0;
+    unsigned long long magnitude = value < 0 ? 0ULL - static_cast<unsigned long long>(value)
+                                             : static_cast<unsigned long long>(value);
+    do {
+        digits[length++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) digits[length++] = '-';
+
+    if (used + length > buffer.size()) flushBuffer();
+    while (length > 0) {
+        buffer[used++] = digits[--length];
+    }
+}
+
+bool BufferedWriter::close() {
+    if (!file) return false;
+    flushBuffer();
+    if (std::fclose(file) != 0) failed = true;
+    file = nullptr;
+    return !failed;
+}
+
+// ============================================================================
+// SHAPE WRITERS
+// ============================================================================
+
+namespace {
+
+const char* kindName(StructureKind kind) {
+    switch (kind) {
+        case StructureKind::BST: return "bst";
+        case StructureKind::AVL: return "avl";
+        case StructureKind::LINKED_LIST: return "list";
+        case StructureKind::STACK: return "stack";
+        case StructureKind::QUEUE: return "queue";
+        case StructureKind::MIN_HEAP: return "heap";
+        case StructureKind::SCAPEGOAT: return "scapegoat";
+    }
+    return "unknown";
+}
+
+const char* sequenceOrder(StructureKind kind) {
+    switch (kind) {
+        case StructureKind::LINKED_LIST: return "head-first";
+        case StructureKind::STACK: return "top-first";
+        case StructureKind::QUEUE: return "front-first";
+        default: return "array";
+    }
+}
+
+// ----------------------------------------------------------------------------
+// JSON
+// ----------------------------------------------------------------------------
+class JsonWriter : public ShapeVisitor {
+private:
+    BufferedWriter& out;
+    long long count;
+
+    void begin(StructureKind kind) {
+        out.write("{\"type\":\"");
+        out.write(kindName(kind));
+        out.write("\",");
+        count = 0;
+    }
+
+    void separator() {
+        if (count++ > 0) out.put(',');
+    }
+
+    void end() {
+        out.write("],\"count\":");
+        out.writeInt(count);
+        out.write("}\n");
+    }
+
+public:
+    explicit JsonWriter(BufferedWriter& writer) : out(writer), count(0) {}
+
+    void beginTree(StructureKind kind) override {
+        begin(kind);
+        out.write("\"nodes\":[");
+    }
+
+    void treeNode(int id, int value, int height, int leftId, int rightId) override {
+        separator();
+        out.put('[');
+        out.writeInt(id);
+        out.put(',');
+        out.writeInt(value);
+        out.put(',');
+        out.writeInt(height);
+        out.put(',');
+        out.writeInt(leftId);
+        out.put(',');
+        out.writeInt(rightId);
+        out.put(']');
+    }
+
+    void endTree(int rootId) override {
+        // The root is only known for sure at the end of a post-order walk
+        out.write("],\"root\":");
+        out.writeInt(rootId);
+        out.write(",\"count\":");
+        out.writeInt(count);
+        out.write("}\n");
+    }
+
+    void beginSequence(StructureKind kind) override {
+        begin(kind);
+        out.write("\"order\":\"");
+        out.write(sequenceOrder(kind));
+        out.write("\",\"nodes\":[");
+    }
+
+    void element(int id, int value) override {
+        separator();
+        out.put('[');
+        out.writeInt(id);
+        out.put(',');
+        out.writeInt(value);
+        out.put(']');
+    }
+
+    void endSequence() override {
+        end();
+    }
+};
+
+// ----------------------------------------------------------------------------
+// DOT
+// ----------------------------------------------------------------------------
+// Tree nodes are named n<id>; left / right edges leave from the sw / se
+// ports so Graphviz keeps the sides apart. Heap nodes are named by array
+// index (the id goes into the 'id' attribute) so the implicit parent
+// edges can be written without remembering earlier elements.
+// ----------------------------------------------------------------------------
+class DotWriter : public ShapeVisitor {
+private:
+    BufferedWriter& out;
+    StructureKind kind;
+    long long index;
+    int previousId;
+
+    void header(const char* nodeShape, const char* direction) {
+        out.write("digraph ");
+        out.write(kindName(kind));
+        out.write(" {\n  rankdir=");
+        out.write(direction);
+        out.write(";\n  node [shape=");
+        out.write(nodeShape);
+        out.write(", fontname=\"Arial\"];\n");
+    }
+
+    void edge(const char* prefix, long long from, const char* port, long long to) {
+        out.write("  ");
+        out.write(prefix);
+        out.writeInt(from);
+        out.write(port);
+        out.write(" -> ");
+        out.write(prefix);
+        out.writeInt(to);
+        out.write(";\n");
+    }
+
+public:
+    explicit DotWriter(BufferedWriter& writer)
+        : out(writer), kind(StructureKind::BST), index(0), previousId(-1) {}
+
+    void beginTree(StructureKind treeKind) override {
+        kind = treeKind;
+        header("circle", "TB");
+    }
+
+    void treeNode(int id, int value, int height, int leftId, int rightId) override {
+        out.write("  n");
+        out.writeInt(id);
+        out.write(" [label=\"");
+        out.writeInt(value);
+        out.write("\\nh=");
+        out.writeInt(height);
+        out.write("\"];\n");
+        if (leftId >= 0) edge("n", id, ":sw", leftId);
+        if (rightId >= 0) edge("n", id, ":se", rightId);
+    }
+
+    void endTree(int /*rootId*/) override {
+        out.write("}\n");
+    }
+
+    void beginSequence(StructureKind sequenceKind) override {
+        kind = sequenceKind;
+        index = 0;
+        previousId = -1;
+        if (kind == StructureKind::MIN_HEAP) header("circle", "TB");
+        else if (kind == StructureKind::STACK) header("box", "TB");
+        else header("box", "LR");
+    }
+
+    void element(int id, int value) override {
+        if (kind == StructureKind::MIN_HEAP) {
+            out.write("  i");
+            out.writeInt(index);
+            out.write(" [label=\"");
+            out.writeInt(value);
+            out.write("\", id=\"n");
+            out.writeInt(id);
+            out.write("\"];\n");
+            if (index > 0) edge("i", (index - 1) / 2, (index % 2 == 1) ? ":sw" : ":se", index);
+        } else {
+            out.write("  n");
+            out.writeInt(id);
+            out.write(" [label=\"");
+            out.writeInt(value);
+            out.write("\"];\n");
+            if (previousId >= 0) edge("n", previousId, "", id);
+        }
+        previousId = id;
+        index++;
+    }
+
+    void endSequence() override {
+        out.write("}\n");
+    }
+};
+
+} // namespace
+
+// ============================================================================
+// STRUCTURE EXPORTER
+// ============================================================================
+
+bool StructureExporter::exportStructure(StructureAdapter& adapter, ExportFormat format,
+                                        const std::string& path, std::string& error) {
+    BufferedWriter writer(path);
+    if (!writer.isOpen()) {
+        error = "cannot open '" + path + "': " + std::strerror(errno);
+        return false;
+    }
+
+    if (format == ExportFormat::JSON) {
+        JsonWriter json(writer);
+        adapter.visitShape(json);
+    } else {
+        DotWriter dot(writer);
+        adapter.visitShape(dot);
+    }
+
+    if (!writer.close()) {
+        error = "write to '" + path + "' failed";
+        return false;
+    }
+    return true;
+}
+
+bool StructureExporter::formatFromPath(const std::string& path, ExportFormat& format) {
+    size_t dot = path.rfind('.');
+    if (dot == std::string::npos) return false;
+    std::string extension = path.substr(dot + 1);
+    if (extension == "dot" || extension == "gv") {
+        format = ExportFormat::DOT;
+        return true;
+    }
+    if (extension == "json") {
+        format = ExportFormat::JSON;
+        return true;
+    }
+    return false;
+}
+
+std::string StructureExporter::defaultFileName(StructureKind kind, ExportFormat format) {
+    // Same stems as the PNG exports of the GUI modes
+    std::string stem = kind == StructureKind::LINKED_LIST ? "linkedlist" : kindName(kind);
+    return stem + "_export" + (format == ExportFormat::DOT ? ".dot" : ".json");
+}
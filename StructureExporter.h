@@ -0,0 +1,74 @@
+// File: StructureExporter.h
+// Description: Writes the shape of any structure to Graphviz DOT or to a
+// compact JSON format for downstream tools (PNG export only has pixels).
+// Structures are streamed through StructureAdapter::visitShape and a
+// buffered writer, so memory use does not grow with the node count.
+//
+// JSON layout:
+//   trees:  {"type":"bst","root":ID,"nodes":[[id,value,height,left,right],...],"count":N}
+//           children are -1 when absent; nodes are listed children-first
+//   others: {"type":"stack","order":"top-first","nodes":[[id,value],...],"count":N}
+//           order is head-first (list), top-first (stack), front-first
+//           (queue) or array (heap: index i has children 2i+1 and 2i+2)
+
+#ifndef STRUCTURE_EXPORTER_H
+#define STRUCTURE_EXPORTER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "StructureAdapter.h"
+#include "MemoryAccount.h"
+
+enum class ExportFormat {
+    DOT,
+    JSON
+};
+
+// ============================================================================
+// BUFFERED WRITER
+// ============================================================================
+// A minimal output buffer with fast integer formatting. Much cheaper than
+// iostreams when writing tens of millions of small numbers.
+// ============================================================================
+class BufferedWriter {
+private:
+    FILE* file;
+    std::vector<char, TrackingAllocator<char, MemoryAccount::EXPORT_BUFFERS>> buffer;
+    size_t used;
+    bool failed;
+
+    void flushBuffer();
+
+public:
+    explicit BufferedWriter(const std::string& path, size_t capacity = 1 << 18);
+    ~BufferedWriter();
+
+    bool isOpen() const { return file != nullptr; }
+
+    void write(const char* text, size_t length);
+    void write(const char* text);
+    void put(char c);
+    void writeInt(long long value);
+
+    // Flush and close; returns false if any write failed
+    bool close();
+};
+
+// ============================================================================
+// STRUCTURE EXPORTER
+// ============================================================================
+class StructureExporter {
+public:
+    // Write 'adapter' to 'path'. On failure 'error' describes the problem.
+    static bool exportStructure(StructureAdapter& adapter, ExportFormat format,
+                                const std::string& path, std::string& error);
+
+    // ".dot"/".gv" -> DOT, ".json" -> JSON
+    static bool formatFromPath(const std::string& path, ExportFormat& format);
+
+    // e.g. "bst_export.dot", matching the PNG export names
+    static std::string defaultFileName(StructureKind kind, ExportFormat format);
+};
+
+#endif // STRUCTURE_EXPORTER_H
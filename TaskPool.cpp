@@ -0,0 +1,130 @@
+// File: TaskPool.cpp
+// Description: Worker threads and chunk scheduling for TaskPool
+
+#include "TaskPool.h"
+#include <algorithm>
+
+namespace {
+    // Set while a thread runs pool work, so nested loops run inline
+    thread_local bool insideWorker = false;
+}
+
+// ============================================================================
+// CONSTRUCTOR & DESTRUCTOR
+// ============================================================================
+
+TaskPool::TaskPool(unsigned threads)
+    : body(nullptr), count(0), grain(1), nextIndex(0), pendingChunks(0),
+      activeWorkers(0), generation(0), stopping(false)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // The calling thread works too
+    for (unsigned i = 1; i < threads; i++) {
+        workers.emplace_back(&TaskPool::workerLoop, this);
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned TaskPool::size() const {
+    return static_cast<unsigned>(workers.size()) + 1;
+}
+
+TaskPool& TaskPool::shared() {
+    static TaskPool pool;
+    return pool;
+}
+
+// ============================================================================
+// SCHEDULING
+// ============================================================================
+// A worker only joins a job while 'body' is set, and the caller clears it
+// only after all chunks are done and no worker is still inside the job.
+// So a worker that wakes late can never run a finished job's body against
+// the next job's counter.
+// ============================================================================
+
+void TaskPool::workerLoop() {
+    insideWorker = true;
+    unsigned long long seen = 0;
+
+    while (true) {
+        const RangeFn* job;
+        size_t jobCount, jobGrain;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            if (body == nullptr) continue;      // Already finished
+            job = body;
+            jobCount = count;
+            jobGrain = grain;
+            activeWorkers++;
+        }
+
+        runChunks(*job, jobCount, jobGrain);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            activeWorkers--;
+        }
+        finished.notify_all();
+    }
+}
+
+void TaskPool::runChunks(const RangeFn& job, size_t jobCount, size_t jobGrain) {
+    while (true) {
+        size_t begin = nextIndex.fetch_add(jobGrain);
+        if (begin >= jobCount) return;
+        job(begin, std::min(jobCount, begin + jobGrain));
+        if (pendingChunks.fetch_sub(1) == 1) {
+            // Lock so the caller can't miss the wake-up between its check and wait
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.notify_all();
+        }
+    }
+}
+
+void TaskPool::parallelFor(size_t loopCount, size_t loopGrain, const RangeFn& loopBody) {
+    if (loopCount == 0) return;
+    loopGrain = std::max<size_t>(1, loopGrain);
+
+    // Not worth waking anyone (or already on a pool thread)
+    if (workers.empty() || insideWorker || loopCount <= loopGrain) {
+        loopBody(0, loopCount);
+        return;
+    }
+
+    std::lock_guard<std::mutex> callLock(callMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        body = &loopBody;
+        count = loopCount;
+        grain = loopGrain;
+        nextIndex.store(0);
+        pendingChunks.store((loopCount + loopGrain - 1) / loopGrain);
+        generation++;
+    }
+    wake.notify_all();
+
+    // The caller's own chunks count as pool work too (for nested loops)
+    insideWorker = true;
+    runChunks(loopBody, loopCount, loopGrain);
+    insideWorker = false;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return pendingChunks.load() == 0 && activeWorkers == 0; });
+    body = nullptr;
+}
@@ -0,0 +1,71 @@
+// File: TaskPool.h
+// Description: A small fixed-size thread pool for data-parallel loops.
+// parallelFor() splits [0, count) into chunks that the workers and the
+// calling thread claim from a shared counter, and returns when every chunk
+// is done. Used by the benchmarks and the batch operations that scale
+// with the core count; the GUI loop itself stays single-threaded.
+//
+// One loop runs at a time (concurrent callers queue up). A parallelFor()
+// issued from inside a worker runs inline, so nesting cannot deadlock.
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// TASK POOL CLASS
+// ============================================================================
+class TaskPool {
+public:
+    // body(begin, end) processes the half-open index range [begin, end)
+    typedef std::function<void(size_t begin, size_t end)> RangeFn;
+
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex callMutex;               // Serializes parallelFor() callers
+    std::mutex mutex;                   // Guards the job fields below
+    std::condition_variable wake;       // Workers wait for a job here
+    std::condition_variable finished;   // The caller waits for completion here
+
+    // Current job
+    const RangeFn* body;
+    size_t count;
+    size_t grain;
+    std::atomic<size_t> nextIndex;
+    std::atomic<size_t> pendingChunks;  // Chunks not yet completed
+    unsigned activeWorkers;             // Workers currently inside the job
+    unsigned long long generation;      // Bumped per job so workers see it once
+    bool stopping;
+
+    void workerLoop();
+
+    // Claim and run chunks of a job until none are left
+    void runChunks(const RangeFn& job, size_t jobCount, size_t jobGrain);
+
+public:
+    // 0 threads = one per hardware thread (the caller counts as one)
+    explicit TaskPool(unsigned threads = 0);
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    // Threads working on a loop, including the caller
+    unsigned size() const;
+
+    // Run 'body' over [0, count) in chunks of at least 'grain' indices
+    void parallelFor(size_t count, size_t grain, const RangeFn& body);
+
+    // Process-wide pool, created on first use
+    static TaskPool& shared();
+};
+
+#endif // TASK_POOL_H
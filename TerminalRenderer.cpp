@@ -0,0 +1,374 @@
+// File: TerminalRenderer.cpp
+// Description: ANSI terminal renderer implementation.
+// Frames are composed into a cell buffer and diffed against the previous
+// frame, so an animation step only costs the few cells it changes.
+
+#include "TerminalRenderer.h"
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+// Box-drawing glyphs
+namespace {
+    const char32_t H_LINE = U'\u2500';       // ─
+    const char32_t V_LINE = U'\u2502';       // │
+    const char32_t TOP_LEFT = U'\u250C';     // ┌
+    const char32_t TOP_RIGHT = U'\u2510';    // ┐
+    const char32_t BOTTOM_LEFT = U'\u2514';  // └
+    const char32_t BOTTOM_RIGHT = U'\u2518'; // ┘
+    const char32_t TEE_UP = U'\u2534';       // ┴
+}
+
+// ============================================================================
+// CONSTRUCTOR & DESTRUCTOR
+// ============================================================================
+
+TerminalRenderer::TerminalRenderer(std::ostream& output)
+    : out(output), rows(40), cols(120), needsClear(true), hasDrawn(false)
+{
+    detectSize();
+    front.assign(rows * cols, Cell());
+    back.assign(rows * cols, Cell());
+}
+
+TerminalRenderer::~TerminalRenderer() {
+    shutdown();
+}
+
+void TerminalRenderer::detectSize() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0) {
+        rows = size.ws_row;
+        cols = size.ws_col;
+        return;
+    }
+#endif
+    // Not a terminal (or unknown platform): honour the usual variables
+    if (const char* envCols = std::getenv("COLUMNS")) {
+        cols = std::max(20, std::atoi(envCols));
+    }
+    if (const char* envRows = std::getenv("LINES")) {
+        rows = std::max(10, std::atoi(envRows));
+    }
+}
+
+// ============================================================================
+// CELL BUFFER
+// ============================================================================
+
+void TerminalRenderer::beginFrame() {
+    std::fill(back.begin(), back.end(), Cell());
+}
+
+void TerminalRenderer::putGlyph(int row, int col, char32_t glyph, const sf::Color& color, bool bold) {
+    if (row < 0 || row >= rows || col < 0 || col >= cols) return;
+    Cell& cell = back[row * cols + col];
+    cell.glyph = glyph;
+    cell.color = color;
+    cell.bold = bold;
+}
+
+void TerminalRenderer::putText(int row, int col, const std::string& text, const sf::Color& color, bool bold) {
+    // Decode UTF-8 so box characters in labels take a single cell
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        char32_t glyph = c;
+        int extra = 0;
+        if (c >= 0xF0) { glyph = c & 0x07; extra = 3; }
+        else if (c >= 0xE0) { glyph = c & 0x0F; extra = 2; }
+        else if (c >= 0xC0) { glyph = c & 0x1F; extra = 1; }
+        i++;
+        for (int k = 0; k < extra && i < text.size(); k++, i++) {
+            glyph = (glyph << 6) | (static_cast<unsigned char>(text[i]) & 0x3F);
+        }
+        putGlyph(row, col++, glyph, color, bold);
+    }
+}
+
+void TerminalRenderer::appendUtf8(std::string& buffer, char32_t glyph) {
+    if (glyph < 0x80) {
+        buffer += static_cast<char>(glyph);
+    } else if (glyph < 0x800) {
+        buffer += static_cast<char>(0xC0 | (glyph >> 6));
+        buffer += static_cast<char>(0x80 | (glyph & 0x3F));
+    } else if (glyph < 0x10000) {
+        buffer += static_cast<char>(0xE0 | (glyph >> 12));
+        buffer += static_cast<char>(0x80 | ((glyph >> 6) & 0x3F));
+        buffer += static_cast<char>(0x80 | (glyph & 0x3F));
+    } else {
+        buffer += static_cast<char>(0xF0 | (glyph >> 18));
+        buffer += static_cast<char>(0x80 | ((glyph >> 12) & 0x3F));
+        buffer += static_cast<char>(0x80 | ((glyph >> 6) & 0x3F));
+        buffer += static_cast<char>(0x80 | (glyph & 0x3F));
+    }
+}
+
+// ============================================================================
+// PRESENT (INCREMENTAL REDRAW)
+// ============================================================================
+// Only cells that differ from the previous frame are written. The cursor
+// position and the current SGR state are tracked so consecutive changed
+// cells on a row need neither a cursor move nor a color escape.
+// ============================================================================
+
+void TerminalRenderer::present() {
+    std::string buffer;
+    buffer.reserve(4096);
+
+    if (needsClear) {
+        // Hide cursor and clear once; after this we only patch cells
+        buffer += "\x1b[?25l\x1b[2J";
+        std::fill(front.begin(), front.end(), Cell());
+        needsClear = false;
+        hasDrawn = true;
+    }
+
+    int cursorRow = -1, cursorCol = -1;
+    bool haveStyle = false;
+    Cell style;
+
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            const Cell& cell = back[r * cols + c];
+            if (cell == front[r * cols + c]) continue;
+
+            if (r != cursorRow || c != cursorCol) {
+                buffer += "\x1b[" + std::to_string(r + 1) + ";" + std::to_string(c + 1) + "H";
+            }
+            if (!haveStyle || cell.bold != style.bold || cell.color.r != style.color.r ||
+                cell.color.g != style.color.g || cell.color.b != style.color.b) {
+                buffer += cell.bold ? "\x1b[0;1;38;2;" : "\x1b[0;38;2;";
+                buffer += std::to_string(cell.color.r) + ";" + std::to_string(cell.color.g) +
+                          ";" + std::to_string(cell.color.b) + "m";
+                style = cell;
+                haveStyle = true;
+            }
+            appendUtf8(buffer, cell.glyph);
+            cursorRow = r;
+            cursorCol = c + 1;
+        }
+    }
+
+    if (haveStyle) buffer += "\x1b[0m";
+    out << buffer;
+    out.flush();
+    front = back;
+}
+
+void TerminalRenderer::invalidate() {
+    needsClear = true;
+}
+
+void TerminalRenderer::shutdown() {
+    if (!hasDrawn) return;  // Nothing was ever drawn
+    out << "\x1b[0m\x1b[" << rows << ";1H\x1b[?25h\n";
+    out.flush();
+    hasDrawn = false;
+    needsClear = true;
+}
+
+int TerminalRenderer::getRows() const {
+    return rows;
+}
+
+int TerminalRenderer::getCols() const {
+    return cols;
+}
+
+// ============================================================================
+// SNAPSHOT DRAWING
+// ============================================================================
+
+void TerminalRenderer::drawSnapshot(const StructureSnapshot& snap, int top, const HighlightMap& highlights) {
+    putText(top, 1, snap.title, Config::TEXT_SECONDARY, true);
+    top += 2;
+
+    if (snap.cells.empty()) {
+        putText(top, 2, "(empty)", Config::TEXT_SECONDARY);
+        return;
+    }
+
+    switch (snap.shape) {
+        case SnapshotShape::TREE:
+            drawTree(snap, top, highlights, Config::NODE_DEFAULT_OUTLINE);
+            break;
+        case SnapshotShape::LINKED:
+            drawBoxes(snap, top, highlights, Config::LINKEDLIST_COLOR, true);
+            break;
+        case SnapshotShape::QUEUE:
+            drawBoxes(snap, top, highlights, Config::QUEUE_COLOR, false);
+            break;
+        case SnapshotShape::STACK:
+            drawStack(snap, top, highlights, Config::STACK_COLOR);
+            break;
+    }
+}
+
+// Trees: one column per node (tidy layout scaled to the widest label),
+// two rows per level - labels, then the connectors to the children.
+void TerminalRenderer::drawTree(const StructureSnapshot& snap, int top, const HighlightMap& highlights,
+                                const sf::Color& baseColor) {
+    int cellWidth = 3;
+    for (const LayoutCell& cell : snap.cells) {
+        cellWidth = std::max(cellWidth, static_cast<int>(std::to_string(cell.value).size()) + 1);
+    }
+    int totalWidth = static_cast<int>(snap.cells.size()) * cellWidth;
+
+    // Horizontal scroll: center on the deepest highlighted node (or the root)
+    int offset = 0;
+    if (totalWidth <= cols) {
+        offset = (cols - totalWidth) / 2;
+    } else {
+        const LayoutCell* focus = nullptr;
+        for (const LayoutCell& cell : snap.cells) {
+            bool isHighlighted = highlights.count(cell.id) > 0;
+            if ((isHighlighted && (!focus || cell.depth > focus->depth)) ||
+                (!focus && cell.depth == 0)) {
+                focus = &cell;
+            }
+        }
+        int focusX = focus->column * cellWidth + cellWidth / 2;
+        offset = std::max(cols - totalWidth, std::min(0, cols / 2 - focusX));
+    }
+
+    // Center column of every node, and which children each parent has
+    std::unordered_map<int, int> centers;
+    std::unordered_map<int, int> depths;
+    std::unordered_map<int, int> childMask;  // bit 0 = left, bit 1 = right
+    for (const LayoutCell& cell : snap.cells) {
+        centers[cell.id] = offset + cell.column * cellWidth + cellWidth / 2;
+        depths[cell.id] = cell.depth;
+        if (cell.parentId >= 0) {
+            childMask[cell.parentId] |= cell.isLeftChild ? 1 : 2;
+        }
+    }
+
+    // Connectors
+    for (const LayoutCell& cell : snap.cells) {
+        if (cell.parentId < 0) continue;
+        int row = top + depths[cell.parentId] * 2 + 1;
+        int childX = centers[cell.id];
+        int parentX = centers[cell.parentId];
+
+        bool lit = highlights.count(cell.id) && highlights.count(cell.parentId);
+        sf::Color color = lit ? Config::EDGE_HIGHLIGHT_COLOR : Config::EDGE_COLOR;
+
+        int from = std::min(childX, parentX) + 1;
+        int to = std::max(childX, parentX);
+        for (int x = from; x < to; x++) {
+            putGlyph(row, x, H_LINE, color);
+        }
+        putGlyph(row, childX, cell.isLeftChild ? TOP_LEFT : TOP_RIGHT, color);
+
+        int mask = childMask[cell.parentId];
+        char32_t joint = mask == 3 ? TEE_UP : (mask == 1 ? BOTTOM_RIGHT : BOTTOM_LEFT);
+        putGlyph(row, parentX, joint, lit ? color : Config::EDGE_COLOR);
+    }
+
+    // Labels
+    for (const LayoutCell& cell : snap.cells) {
+        std::string label = std::to_string(cell.value);
+        auto it = highlights.find(cell.id);
+        bool isHighlighted = it != highlights.end();
+        putText(top + cell.depth * 2, centers[cell.id] - static_cast<int>(label.size()) / 2, label,
+                isHighlighted ? it->second : baseColor, isHighlighted);
+    }
+}
+
+// Lists and queues: a row of boxes, wrapped to the terminal width
+void TerminalRenderer::drawBoxes(const StructureSnapshot& snap, int top, const HighlightMap& highlights,
+                                 const sf::Color& baseColor, bool arrows) {
+    const int gap = arrows ? 4 : 1;
+    int x = 2;
+    int row = top + 1;  // Leave a row for HEAD / FRONT / REAR markers
+
+    for (size_t i = 0; i < snap.cells.size(); i++) {
+        const LayoutCell& cell = snap.cells[i];
+        std::string label = std::to_string(cell.value);
+        int width = static_cast<int>(label.size()) + 4;
+
+        if (x + width + gap > cols && x > 2) {
+            x = 2;
+            row += 5;
+        }
+
+        auto it = highlights.find(cell.id);
+        bool isHighlighted = it != highlights.end();
+        sf::Color color = isHighlighted ? it->second : baseColor;
+
+        putGlyph(row, x, TOP_LEFT, color);
+        putGlyph(row, x + width - 1, TOP_RIGHT, color);
+        putGlyph(row + 2, x, BOTTOM_LEFT, color);
+        putGlyph(row + 2, x + width - 1, BOTTOM_RIGHT, color);
+        for (int k = 1; k < width - 1; k++) {
+            putGlyph(row, x + k, H_LINE, color);
+            putGlyph(row + 2, x + k, H_LINE, color);
+        }
+        putGlyph(row + 1, x, V_LINE, color);
+        putGlyph(row + 1, x + width - 1, V_LINE, color);
+        putText(row + 1, x + 2, label, isHighlighted ? it->second : Config::TEXT_COLOR, isHighlighted);
+
+        if (i == 0) {
+            putText(row - 1, x, arrows ? "HEAD" : "FRONT", Config::SUCCESS_COLOR, true);
+        } else if (!arrows && i + 1 == snap.cells.size()) {
+            putText(row - 1, x, "REAR", Config::TEXT_SECONDARY, true);
+        }
+
+        x += width;
+        if (arrows) {
+            bool last = i + 1 == snap.cells.size();
+            putText(row + 1, x, last ? "\u2500\u2500> NULL" : "\u2500\u2500> ", Config::ARROW_COLOR);
+        }
+        x += gap;
+    }
+}
+
+// Stacks: vertical boxes with the top element first
+void TerminalRenderer::drawStack(const StructureSnapshot& snap, int top, const HighlightMap& highlights,
+                                 const sf::Color& baseColor) {
+    int labelWidth = 1;
+    for (const LayoutCell& cell : snap.cells) {
+        labelWidth = std::max(labelWidth, static_cast<int>(std::to_string(cell.value).size()));
+    }
+    int width = labelWidth + 4;
+    int x = std::max(2, cols / 2 - width / 2);
+
+    int available = std::max(1, rows - top - 3);
+    int count = static_cast<int>(snap.cells.size());
+    int shown = std::min(count, available);
+
+    for (int k = 1; k < width - 1; k++) {
+        putGlyph(top, x + k, H_LINE, baseColor);
+        putGlyph(top + shown + 1, x + k, H_LINE, baseColor);
+    }
+    putGlyph(top, x, TOP_LEFT, baseColor);
+    putGlyph(top, x + width - 1, TOP_RIGHT, baseColor);
+    putGlyph(top + shown + 1, x, BOTTOM_LEFT, baseColor);
+    putGlyph(top + shown + 1, x + width - 1, BOTTOM_RIGHT, baseColor);
+
+    for (int i = 0; i < shown; i++) {
+        const LayoutCell& cell = snap.cells[count - 1 - i];
+        int row = top + 1 + i;
+        std::string label = std::to_string(cell.value);
+
+        auto it = highlights.find(cell.id);
+        bool isHighlighted = it != highlights.end();
+
+        putGlyph(row, x, V_LINE, baseColor);
+        putGlyph(row, x + width - 1, V_LINE, baseColor);
+        putText(row, x + 2 + (labelWidth - static_cast<int>(label.size())) / 2, label,
+                isHighlighted ? it->second : Config::TEXT_COLOR, isHighlighted);
+    }
+
+    putText(top + 1, x + width + 2, "<-- TOP", Config::SUCCESS_COLOR, true);
+    if (shown < count) {
+        putText(top + shown + 1, x + width + 2,
+                "(" + std::to_string(count - shown) + " more below)", Config::TEXT_SECONDARY);
+    }
+}
@@ -0,0 +1,94 @@
+// File: TerminalRenderer.h
+// Description: ANSI terminal backend for drawing structure snapshots.
+// Draws trees, lists, stacks, queues and heaps with box-drawing characters
+// and 24-bit colors taken from Config, so remote sessions without a display
+// see the same palette as the SFML window.
+// Redraws are incremental: the renderer keeps the previous frame and only
+// emits cursor-addressed updates for cells that actually changed.
+
+#ifndef TERMINAL_RENDERER_H
+#define TERMINAL_RENDERER_H
+
+#include <SFML/Graphics.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Config.h"
+#include "TreeLayout.h"
+
+// Node id -> color override for the current frame (highlights)
+typedef std::unordered_map<int, sf::Color> HighlightMap;
+
+// ============================================================================
+// TERMINAL RENDERER CLASS
+// ============================================================================
+class TerminalRenderer {
+private:
+    // One character cell on screen
+    struct Cell {
+        char32_t glyph;
+        sf::Color color;
+        bool bold;
+
+        Cell() : glyph(U' '), color(Config::TEXT_COLOR), bold(false) {}
+        bool operator==(const Cell& other) const {
+            // Blanks look the same whatever their color
+            if (glyph == U' ' && other.glyph == U' ') return true;
+            return glyph == other.glyph && bold == other.bold &&
+                   color.r == other.color.r && color.g == other.color.g &&
+                   color.b == other.color.b;
+        }
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+    std::ostream& out;
+    int rows, cols;
+    std::vector<Cell> front;        // What the terminal currently shows
+    std::vector<Cell> back;         // Frame being composed
+    bool needsClear;                // Next present() repaints everything
+    bool hasDrawn;                  // Anything was sent to the terminal
+
+    // Query terminal size (falls back to 120x40)
+    void detectSize();
+
+    // Append the UTF-8 encoding of a code point
+    static void appendUtf8(std::string& buffer, char32_t glyph);
+
+    // Drawing helpers for each snapshot shape
+    void drawTree(const StructureSnapshot& snap, int top, const HighlightMap& highlights,
+                  const sf::Color& baseColor);
+    void drawBoxes(const StructureSnapshot& snap, int top, const HighlightMap& highlights,
+                   const sf::Color& baseColor, bool arrows);
+    void drawStack(const StructureSnapshot& snap, int top, const HighlightMap& highlights,
+                   const sf::Color& baseColor);
+
+public:
+    explicit TerminalRenderer(std::ostream& output);
+    ~TerminalRenderer();
+
+    // Start composing a new frame (clears the back buffer)
+    void beginFrame();
+
+    // Put a single glyph / a string at a cell position (clipped to screen)
+    void putGlyph(int row, int col, char32_t glyph, const sf::Color& color, bool bold = false);
+    void putText(int row, int col, const std::string& text, const sf::Color& color, bool bold = false);
+
+    // Draw a structure snapshot starting at row 'top'
+    void drawSnapshot(const StructureSnapshot& snap, int top, const HighlightMap& highlights);
+
+    // Send the changed cells to the terminal
+    void present();
+
+    // Forget what the terminal shows (e.g. after it scrolled); the next
+    // present() clears the screen and repaints every cell
+    void invalidate();
+
+    // Restore cursor and move below the drawing
+    void shutdown();
+
+    int getRows() const;
+    int getCols() const;
+};
+
+#endif // TERMINAL_RENDERER_H
@@ -0,0 +1,197 @@
+// File: TopK.cpp
+// Description: Threshold-filtered scan and parallel merge for top-K
+
+#include "TopK.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+// With GCC or Clang on x86 both filters are compiled for their instruction
+// set with a function attribute, whatever the compiler flags, and the CPU
+// is asked at run time which one it can execute
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define TOP_K_AVX2
+#define TOP_K_SSE2
+#define TOP_K_TARGET(isa) __attribute__((target(isa)))
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TOP_K_SSE2
+#define TOP_K_TARGET(isa)
+#endif
+
+TopKQuery::TopKQuery(size_t count)
+    : k(count)
+{
+}
+
+// ============================================================================
+// BLOCK FILTERS
+// ============================================================================
+// Each returns the start of the first block from 'i' on that holds a value
+// above 'threshold', or where fewer than one block of values is left
+
+namespace {
+
+#if defined(TOP_K_AVX2)
+TOP_K_TARGET("avx2")
+size_t skipBlocksAvx2(const int* values, size_t i, size_t count, int threshold) {
+    const __m256i limit = _mm256_set1_epi32(threshold);
+    for (; i + 32 <= count; i += 32) {
+        const __m256i* block = reinterpret_cast<const __m256i*>(values + i);
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_loadu_si256(block), limit),
+                            _mm256_cmpgt_epi32(_mm256_loadu_si256(block + 1), limit)),
+            _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_loadu_si256(block + 2), limit),
+                            _mm256_cmpgt_epi32(_mm256_loadu_si256(block + 3), limit)));
+        if (!_mm256_testz_si256(hit, hit)) break;
+    }
+    return i;
+}
+#endif
+
+#if defined(TOP_K_SSE2)
+TOP_K_TARGET("sse2")
+size_t skipBlocksSse2(const int* values, size_t i, size_t count, int threshold) {
+    const __m128i limit = _mm_set1_epi32(threshold);
+    for (; i + 16 <= count; i += 16) {
+        const __m128i* block = reinterpret_cast<const __m128i*>(values + i);
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpgt_epi32(_mm_loadu_si128(block), limit),
+                         _mm_cmpgt_epi32(_mm_loadu_si128(block + 1), limit)),
+            _mm_or_si128(_mm_cmpgt_epi32(_mm_loadu_si128(block + 2), limit),
+                         _mm_cmpgt_epi32(_mm_loadu_si128(block + 3), limit)));
+        if (_mm_movemask_epi8(hit) != 0) break;
+    }
+    return i;
+}
+#endif
+
+struct BlockFilter {
+    size_t (*skip)(const int* values, size_t i, size_t count, int threshold);
+    size_t blockValues;
+    const char* name;
+};
+
+// Chosen once, on first use; 'skip' is null when there is no SIMD filter
+const BlockFilter& blockFilter() {
+    static const BlockFilter chosen = []() {
+#if defined(TOP_K_AVX2)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return BlockFilter{skipBlocksAvx2, 32, "AVX2"};
+        if (__builtin_cpu_supports("sse2")) return BlockFilter{skipBlocksSse2, 16, "SSE2"};
+#elif defined(TOP_K_SSE2)
+        return BlockFilter{skipBlocksSse2, 16, "SSE2"};
+#endif
+        return BlockFilter{nullptr, 0, "scalar"};
+    }();
+    return chosen;
+}
+
+} // namespace
+
+// ============================================================================
+// SEGMENT SCAN
+// ============================================================================
+
+size_t TopKQuery::offer(MinHeap& heap, size_t k, const int* values, size_t count,
+                        bool vectorFilter, size_t* candidates) {
+    if (k == 0) return 0;
+    std::vector<int> siftPath;
+    size_t updates = 0;
+    size_t passed = 0;
+    size_t i = 0;
+
+    // Until the heap holds k values every value is kept
+    for (; i < count && static_cast<size_t>(heap.getSize()) < k; i++) {
+        siftPath.clear();
+        heap.insert(values[i], siftPath);
+        updates++;
+        passed++;
+    }
+
+    int threshold = heap.isEmpty() ? 0 : heap.peekMin()->value;
+    auto consider = [&](int value) {
+        if (value > threshold) {
+            siftPath.clear();
+            heap.replaceMin(value, -1, siftPath);
+            threshold = heap.peekMin()->value;
+            updates++;
+        }
+    };
+
+    // Whole blocks below the threshold are skipped after one compare per
+    // vector; a block with a hit is rechecked value by value, since the
+    // threshold rises with every replacement
+    const BlockFilter& filter = blockFilter();
+    if (vectorFilter && filter.skip) {
+        size_t block = filter.blockValues;
+        while ((i = filter.skip(values, i, count, threshold)) + block <= count) {
+            int blockThreshold = threshold;
+            for (size_t j = i; j < i + block; j++) {
+                if (values[j] > blockThreshold) passed++;
+                consider(values[j]);
+            }
+            i += block;
+        }
+    }
+
+    for (; i < count; i++) {
+        if (values[i] > threshold) passed++;
+        consider(values[i]);
+    }
+
+    if (candidates) *candidates += passed;
+    return updates;
+}
+
+// ============================================================================
+// PARALLEL QUERY
+// ============================================================================
+
+void TopKQuery::run(const int* values, size_t count, TaskPool& pool, bool vectorFilter) {
+    auto start = std::chrono::steady_clock::now();
+    stats = TopKStats();
+    stats.values = count;
+    result.clear();
+
+    // A segment much shorter than k would spend its time filling the heap
+    size_t segments = std::max<size_t>(1, std::min<size_t>(pool.size(), count / (4 * k + 1)));
+    size_t segmentLength = (count + segments - 1) / segments;
+
+    std::vector<std::unique_ptr<MinHeap>> heaps(segments);
+    std::vector<size_t> updates(segments, 0);
+    std::vector<size_t> passed(segments, 0);
+
+    pool.parallelFor(segments, 1, [&](size_t first, size_t last) {
+        for (size_t s = first; s < last; s++) {
+            size_t begin = std::min(count, s * segmentLength);
+            size_t end = std::min(count, begin + segmentLength);
+            heaps[s].reset(new MinHeap());
+            updates[s] = offer(*heaps[s], k, values + begin, end - begin, vectorFilter, &passed[s]);
+        }
+    });
+
+    // The answer is among the union of the partial top-k sets
+    std::vector<int> partial;
+    for (size_t s = 1; s < segments; s++) {
+        partial.clear();
+        for (HeapNode* node : heaps[s]->getAllNodes()) partial.push_back(node->value);
+        updates[0] += offer(*heaps[0], k, partial.data(), partial.size(), false);
+    }
+
+    for (HeapNode* node : heaps[0]->getAllNodes()) result.push_back(node->value);
+    std::sort(result.begin(), result.end(), std::greater<int>());
+
+    for (size_t s = 0; s < segments; s++) {
+        stats.heapUpdates += updates[s];
+        stats.candidates += passed[s];
+    }
+    stats.ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+const char* TopKQuery::instructionSet() {
+    return blockFilter().name;
+}
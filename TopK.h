@@ -0,0 +1,70 @@
+// File: TopK.h
+// Description: Parallel streaming top-K: the K largest values of an
+// integer stream (typically a memory-mapped MappedIntFile) in one pass.
+//
+// The stream is split into one segment per TaskPool thread. Each segment
+// keeps the K largest values it has seen in its own MinHeap, bounded to K
+// entries: once full, the heap minimum is the K-th largest so far (the
+// threshold), and a value only matters if it beats it, in which case it
+// replaces the minimum (MinHeap::replaceMin). The partial heaps are merged
+// by offering the other segments' values to the first heap.
+//
+// On random data the threshold climbs quickly and after the first few
+// K * ln(N / K) values almost nothing beats it. The scan therefore compares
+// whole blocks against the threshold with SIMD (8 lanes with AVX2, 4 with
+// SSE2) and only looks at single values when some lane passed; most of the
+// stream never touches the heap. As in FilterHash, the AVX2 filter is
+// built whatever the compiler flags and the first scan picks the best one
+// the CPU supports; all paths return identical results.
+
+#ifndef TOP_K_H
+#define TOP_K_H
+
+#include <cstddef>
+#include <vector>
+#include "MinHeap.h"
+#include "TaskPool.h"
+
+// ============================================================================
+// QUERY STATISTICS
+// ============================================================================
+struct TopKStats {
+    size_t values;
+    size_t candidates;      // Values that passed the block filter
+    size_t heapUpdates;     // Inserts and replaceMin() calls, merge included
+    double ms;
+
+    TopKStats() : values(0), candidates(0), heapUpdates(0), ms(0) {}
+};
+
+// ============================================================================
+// TOP-K QUERY CLASS
+// ============================================================================
+class TopKQuery {
+private:
+    size_t k;
+    std::vector<int> result;        // Largest first
+    TopKStats stats;
+
+public:
+    explicit TopKQuery(size_t count);
+
+    // Replace the result with the k largest of values[0, count). With
+    // 'vectorFilter' false every value is compared one by one (for the
+    // benchmark); the result is the same.
+    void run(const int* values, size_t count, TaskPool& pool, bool vectorFilter = true);
+
+    // Feed values[0, count) into 'heap', keeping at most k entries;
+    // returns the number of heap updates. The per-segment step of run().
+    static size_t offer(MinHeap& heap, size_t k, const int* values, size_t count,
+                        bool vectorFilter, size_t* candidates = nullptr);
+
+    const std::vector<int>& getResult() const { return result; }
+    const TopKStats& getStats() const { return stats; }
+    size_t getK() const { return k; }
+
+    // "AVX2", "SSE2" or "scalar"
+    static const char* instructionSet();
+};
+
+#endif // TOP_K_H
@@ -0,0 +1,216 @@
+// File: TreeCanvas.cpp
+// Description: Drawing and step animation for TreeCanvas
+
+#include "TreeCanvas.h"
+#include <algorithm>
+#include <cmath>
+
+const sf::Color TreeCanvas::VISITED_FILL = Config::NODE_HIGHLIGHT_FILL;
+const sf::Color TreeCanvas::MATCH_FILL = Config::NODE_FOUND_FILL;
+const sf::Color TreeCanvas::PRUNED_FILL(60, 60, 72);
+
+TreeCanvas::TreeCanvas(float x, float y, float width, float height,
+                       const std::string& canvasTitle, sf::Font& fontRef)
+    : font(&fontRef), title(canvasTitle),
+      areaX(x), areaY(y), areaWidth(width), areaHeight(height),
+      boxWidth(72.0f), levelSpacing(Config::VERTICAL_SPACING),
+      stepTimer(0), speedFactor(Config::DEFAULT_ANIMATION_SPEED)
+{
+}
+
+// ============================================================================
+// COLORING & ANIMATION
+// ============================================================================
+
+void TreeCanvas::setColor(int nodeId, const sf::Color& fill) {
+    auto it = views.find(nodeId);
+    if (it != views.end()) {
+        it->second.fillColor = fill;
+    }
+}
+
+bool TreeCanvas::getColor(int nodeId, sf::Color& fill) const {
+    auto it = views.find(nodeId);
+    if (it == views.end()) return false;
+    fill = it->second.fillColor;
+    return true;
+}
+
+void TreeCanvas::resetColors() {
+    for (auto& pair : views) {
+        pair.second.fillColor = Config::NODE_DEFAULT_FILL;
+    }
+}
+
+void TreeCanvas::applyStep(const Step& step) {
+    if (!step.wholeSubtree) {
+        setColor(step.nodeId, step.fill);
+        return;
+    }
+
+    // Layout order is in-order, so a subtree is one contiguous run of ids
+    // around its root; walk outwards while the parent chain reaches it
+    auto inSubtree = [this, &step](int id) {
+        while (id >= 0) {
+            if (id == step.nodeId) return true;
+            auto it = views.find(id);
+            if (it == views.end()) return false;
+            id = it->second.parentId;
+        }
+        return false;
+    };
+    auto rootPos = std::find(order.begin(), order.end(), step.nodeId);
+    if (rootPos == order.end()) return;
+    for (auto it = rootPos; it != order.end() && inSubtree(*it); ++it) {
+        setColor(*it, step.fill);
+    }
+    for (auto it = rootPos; it != order.begin() && inSubtree(*(it - 1)); --it) {
+        setColor(*(it - 1), step.fill);
+    }
+}
+
+void TreeCanvas::queueStep(int nodeId, const sf::Color& fill, bool wholeSubtree) {
+    if (steps.empty()) stepTimer = 0;
+    steps.push_back({nodeId, fill, wholeSubtree});
+}
+
+void TreeCanvas::clearSteps() {
+    // Finish instantly: the final colors are what matters
+    while (!steps.empty()) {
+        applyStep(steps.front());
+        steps.pop_front();
+    }
+}
+
+bool TreeCanvas::isAnimating() const {
+    return !steps.empty();
+}
+
+void TreeCanvas::setSpeed(float speed) {
+    speedFactor = std::max(Config::MIN_ANIMATION_SPEED,
+                           std::min(speed, Config::MAX_ANIMATION_SPEED));
+}
+
+bool TreeCanvas::isEmpty() const {
+    return views.empty();
+}
+
+// ============================================================================
+// UPDATE
+// ============================================================================
+
+void TreeCanvas::update(float deltaTime) {
+    // Glide towards the layout positions
+    float moveSpeed = 10.0f * speedFactor;
+    for (auto& pair : views) {
+        NodeView& view = pair.second;
+        float dx = view.targetX - view.x;
+        float dy = view.targetY - view.y;
+        if (std::abs(dx) > 0.5f || std::abs(dy) > 0.5f) {
+            float t = std::min(1.0f, moveSpeed * deltaTime);
+            view.x += dx * t;
+            view.y += dy * t;
+        } else {
+            view.x = view.targetX;
+            view.y = view.targetY;
+        }
+    }
+
+    // One coloring step per (scaled) step duration
+    if (!steps.empty()) {
+        stepTimer += deltaTime * speedFactor;
+        float stepDuration = Config::DEFAULT_ANIMATION_DURATION * 0.6f;
+        while (!steps.empty() && stepTimer >= stepDuration) {
+            applyStep(steps.front());
+            steps.pop_front();
+            stepTimer -= stepDuration;
+        }
+    }
+}
+
+// ============================================================================
+// DRAWING
+// ============================================================================
+
+void TreeCanvas::draw(sf::RenderWindow& window) {
+    sf::RectangleShape background;
+    background.setPosition(areaX - 10, areaY - 10);
+    background.setSize(sf::Vector2f(areaWidth + 20, areaHeight + 20));
+    background.setFillColor(Config::TREE_AREA_COLOR);
+    background.setOutlineThickness(1);
+    background.setOutlineColor(sf::Color(60, 60, 70));
+    window.draw(background);
+
+    sf::Text titleText;
+    titleText.setFont(*font);
+    titleText.setString(title);
+    titleText.setCharacterSize(Config::TITLE_FONT_SIZE);
+    titleText.setFillColor(Config::TEXT_SECONDARY);
+    titleText.setPosition(areaX, areaY - 35);
+    window.draw(titleText);
+
+    float boxHeight = 30.0f;
+
+    // Edges behind the boxes
+    for (int id : order) {
+        const NodeView& view = views.at(id);
+        auto parent = views.find(view.parentId);
+        if (parent == views.end()) continue;
+        sf::Vertex line[] = {
+            sf::Vertex(sf::Vector2f(parent->second.x, parent->second.y + boxHeight / 2), Config::EDGE_COLOR),
+            sf::Vertex(sf::Vector2f(view.x, view.y - boxHeight / 2), Config::EDGE_COLOR)
+        };
+        window.draw(line, 2, sf::Lines);
+    }
+
+    // Small boxes can't hold a label; large trees are drawn as shapes only
+    bool showLabels = boxWidth >= 30.0f;
+    unsigned int labelSize = boxWidth >= 60.0f ? 13 : 10;
+
+    sf::RectangleShape box;
+    box.setOutlineThickness(2);
+    sf::Text text;
+    text.setFont(*font);
+    text.setFillColor(Config::TEXT_COLOR);
+
+    for (int id : order) {
+        const NodeView& view = views.at(id);
+        box.setSize(sf::Vector2f(boxWidth, boxHeight));
+        box.setOrigin(boxWidth / 2, boxHeight / 2);
+        box.setPosition(view.x, view.y);
+        box.setFillColor(view.fillColor);
+        box.setOutlineColor(view.fillColor == Config::NODE_DEFAULT_FILL
+                            ? Config::NODE_DEFAULT_OUTLINE : sf::Color(220, 220, 230));
+        window.draw(box);
+
+        if (!showLabels) continue;
+
+        text.setString(view.label.c_str());
+        text.setCharacterSize(labelSize);
+        sf::FloatRect bounds = text.getLocalBounds();
+        text.setOrigin(bounds.left + bounds.width / 2, bounds.top + bounds.height / 2);
+        text.setPosition(view.x, view.y);
+        window.draw(text);
+
+        if (!view.detail.empty()) {
+            text.setString(view.detail.c_str());
+            text.setCharacterSize(10);
+            bounds = text.getLocalBounds();
+            text.setOrigin(bounds.left + bounds.width / 2, 0);
+            text.setPosition(view.x, view.y + boxHeight / 2 + 2);
+            window.draw(text);
+        }
+    }
+
+    if (views.empty()) {
+        sf::Text emptyText;
+        emptyText.setFont(*font);
+        emptyText.setString("Tree is empty\nInsert values to visualize!");
+        emptyText.setCharacterSize(16);
+        emptyText.setFillColor(sf::Color(120, 120, 130));
+        sf::FloatRect bounds = emptyText.getLocalBounds();
+        emptyText.setOrigin(bounds.width / 2, bounds.height / 2);
+        emptyText.setPosition(areaX + areaWidth / 2, areaY + areaHeight / 2);
+        window.draw(emptyText);
+    }
+}
@@ -0,0 +1,162 @@
+// File: TreeCanvas.h
+// Description: General-purpose binary tree view for the newer tree modes.
+// Visualizer is written around BST::Node; TreeCanvas only needs a node type
+// with 'id', 'left' and 'right' plus a function that labels each node, so
+// any tree can be drawn and animated without its own visualizer class.
+// Nodes are boxes (labels such as "[3,9]" don't fit in a circle) placed with
+// the tidy in-order layout from TreeLayout.h, and glide to new positions.
+//
+// Animations are a queue of coloring steps played one per step duration:
+// color one node (e.g. "visited") or a whole subtree (e.g. "pruned").
+// Colors stay until resetColors(), so the result remains on screen.
+
+#ifndef TREE_CANVAS_H
+#define TREE_CANVAS_H
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Config.h"
+#include "TreeLayout.h"
+#include "MemoryAccount.h"
+
+class TreeCanvas {
+public:
+    // One coloring step of an animation
+    struct Step {
+        int nodeId;
+        sf::Color fill;
+        bool wholeSubtree;
+    };
+
+private:
+    struct NodeView {
+        int parentId;
+        TrackedString label;        // Main text inside the box
+        TrackedString detail;       // Small text under the box (may be empty)
+        float x, y;                 // Current position
+        float targetX, targetY;
+        sf::Color fillColor;
+    };
+
+    typedef std::unordered_map<int, NodeView, std::hash<int>, std::equal_to<int>,
+                               TrackingAllocator<std::pair<const int, NodeView>,
+                                                 MemoryAccount::NODE_VISUALS>> ViewMap;
+
+    ViewMap views;
+    std::vector<int, TrackingAllocator<int, MemoryAccount::NODE_VISUALS>> order;  // Ids in layout order (parents resolved by id)
+    sf::Font* font;
+    std::string title;
+
+    float areaX, areaY, areaWidth, areaHeight;
+    float boxWidth;                 // Shrinks when many nodes share the width
+    float levelSpacing;
+
+    std::deque<Step, TrackingAllocator<Step, MemoryAccount::ANIMATION_STEPS>> steps;
+    float stepTimer;
+    float speedFactor;
+
+    void applyStep(const Step& step);
+
+public:
+    TreeCanvas(float x, float y, float width, float height,
+               const std::string& title, sf::Font& font);
+
+    // Replace the displayed tree. 'describe(node, label, detail)' fills the
+    // texts. Nodes that already existed keep their position and color.
+    template <typename NodeT, typename DescribeFn>
+    void setTree(NodeT* root, DescribeFn describe);
+
+    // Coloring
+    void setColor(int nodeId, const sf::Color& fill);
+    void resetColors();
+
+    // Current fill of a node (lets a mode draw companion views in sync)
+    bool getColor(int nodeId, sf::Color& fill) const;
+
+    // Animation queue
+    void queueStep(int nodeId, const sf::Color& fill, bool wholeSubtree = false);
+    void clearSteps();
+    bool isAnimating() const;
+    void setSpeed(float speed);
+
+    void update(float deltaTime);
+    void draw(sf::RenderWindow& window);
+
+    bool isEmpty() const;
+
+    // Colors shared by the tree modes
+    static const sf::Color VISITED_FILL;
+    static const sf::Color MATCH_FILL;
+    static const sf::Color PRUNED_FILL;
+};
+
+// ============================================================================
+// TEMPLATE IMPLEMENTATION
+// ============================================================================
+
+template <typename NodeT, typename DescribeFn>
+void TreeCanvas::setTree(NodeT* root, DescribeFn describe) {
+    // computeTidyLayout emits cells in in-order, so a second in-order walk
+    // lines the node pointers up with the cells
+    std::vector<LayoutCell> cells;
+    int height = 0;
+    computeTidyLayout(root, cells, height);
+
+    std::vector<NodeT*> nodes;
+    nodes.reserve(cells.size());
+    std::vector<NodeT*> stack;
+    NodeT* current = root;
+    while (current != nullptr || !stack.empty()) {
+        while (current != nullptr) {
+            stack.push_back(current);
+            current = current->left;
+        }
+        current = stack.back();
+        stack.pop_back();
+        nodes.push_back(current);
+        current = current->right;
+    }
+
+    // Fit the columns and levels into the drawing area
+    float columnWidth = cells.empty() ? areaWidth : areaWidth / static_cast<float>(cells.size());
+    boxWidth = std::max(8.0f, std::min(72.0f, columnWidth - 4.0f));
+    levelSpacing = height > 1 ? std::min(Config::VERTICAL_SPACING,
+                                         (areaHeight - 60.0f) / static_cast<float>(height - 1))
+                              : Config::VERTICAL_SPACING;
+
+    ViewMap updated;
+    std::string label, detail;
+    order.clear();
+    for (size_t i = 0; i < cells.size(); i++) {
+        const LayoutCell& cell = cells[i];
+        NodeView view;
+        auto previous = views.find(cell.id);
+        if (previous != views.end()) {
+            view = previous->second;
+        } else {
+            view.fillColor = Config::NODE_DEFAULT_FILL;
+            view.x = -1.0f;         // Placed at its target below
+        }
+        view.parentId = cell.parentId;
+        label.clear();
+        detail.clear();
+        describe(nodes[i], label, detail);
+        view.label.assign(label.data(), label.size());
+        view.detail.assign(detail.data(), detail.size());
+        view.targetX = areaX + columnWidth * (static_cast<float>(cell.column) + 0.5f);
+        view.targetY = areaY + 30.0f + levelSpacing * static_cast<float>(cell.depth);
+        if (view.x < 0) {
+            view.x = view.targetX;
+            view.y = view.targetY;
+        }
+        updated[cell.id] = view;
+        order.push_back(cell.id);
+    }
+    views.swap(updated);
+}
+
+#endif // TREE_CANVAS_H
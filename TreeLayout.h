@@ -0,0 +1,221 @@
+// File: TreeLayout.h
+// Description: Structure-agnostic layout used by the non-SFML renderers.
+// A "snapshot" is a flat list of cells (id, value, column, depth, parent)
+// that can be drawn without knowing which data structure produced it.
+// Trees use a tidy in-order layout: every node gets its own column, so
+// subtrees never overlap no matter how deep or lopsided the tree is.
+
+#ifndef TREE_LAYOUT_H
+#define TREE_LAYOUT_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+// ============================================================================
+// LAYOUT CELL
+// ============================================================================
+// One drawable element of a snapshot.
+// - column: in-order rank for trees, position for linear structures
+// - depth: tree level (0 = root); always 0 for linear structures
+// - parentId: id of the parent node (-1 for the root / first element)
+// ============================================================================
+struct LayoutCell {
+    int id;
+    int value;
+    int column;
+    int depth;
+    int parentId;
+    bool isLeftChild;
+
+    LayoutCell(int nodeId, int val, int col, int d, int parent, bool left)
+        : id(nodeId), value(val), column(col), depth(d),
+          parentId(parent), isLeftChild(left) {}
+};
+
+// ============================================================================
+// STRUCTURE SNAPSHOT
+// ============================================================================
+// How a snapshot should be drawn
+enum class SnapshotShape {
+    TREE,           // Binary tree (BST, AVL, heap)
+    LINKED,         // Boxes joined by arrows (linked list)
+    STACK,          // Vertical boxes, top element last
+    QUEUE           // Horizontal boxes, front element first
+};
+
+struct StructureSnapshot {
+    SnapshotShape shape;
+    std::string title;
+    std::vector<LayoutCell> cells;
+    int height;                 // Number of tree levels (1 for linear)
+
+    StructureSnapshot() : shape(SnapshotShape::TREE), height(0) {}
+};
+
+// LayoutCell::value of a node. Only int keys are kept; trees with other key
+// types (BasicAVLTree<ShortKey>, ...) are labelled by their renderer and leave it 0.
+inline int layoutValue(int value) { return value; }
+
+template <typename Value>
+int layoutValue(const Value&) { return 0; }
+
+// ============================================================================
+// TIDY TREE LAYOUT
+// ============================================================================
+// Works for any node type with 'id', 'value', 'left' and 'right' members
+// (Node, BasicAVLNode). The traversal is iterative so degenerate trees built
+// from sorted input do not overflow the call stack.
+// ============================================================================
+template <typename NodeT>
+void computeTidyLayout(NodeT* root, std::vector<LayoutCell>& cells, int& height) {
+    struct Frame {
+        NodeT* node;
+        int depth;
+        int parentId;
+        bool isLeft;
+    };
+
+    cells.clear();
+    height = 0;
+
+    std::vector<Frame> stack;
+    NodeT* current = root;
+    int depth = 0;
+    int parentId = -1;
+    bool isLeft = false;
+    int column = 0;
+
+    while (current != nullptr || !stack.empty()) {
+        // Walk down the left spine
+        while (current != nullptr) {
+            stack.push_back({current, depth, parentId, isLeft});
+            parentId = current->id;
+            current = current->left;
+            depth++;
+            isLeft = true;
+        }
+
+        // Visit
+        Frame frame = stack.back();
+        stack.pop_back();
+        cells.push_back(LayoutCell(frame.node->id, layoutValue(frame.node->value), column++,
+                                   frame.depth, frame.parentId, frame.isLeft));
+        if (frame.depth + 1 > height) {
+            height = frame.depth + 1;
+        }
+
+        // Continue with the right subtree
+        current = frame.node->right;
+        depth = frame.depth + 1;
+        parentId = frame.node->id;
+        isLeft = false;
+    }
+}
+
+// ============================================================================
+// IMPLICIT (ARRAY) TREE LAYOUT
+// ============================================================================
+// Same tidy layout for array-backed complete trees (MinHeap), where the
+// children of index i live at 2i+1 and 2i+2.
+// ============================================================================
+template <typename NodeT>
+void computeImplicitLayout(const std::vector<NodeT*>& nodes,
+                           std::vector<LayoutCell>& cells, int& height) {
+    cells.clear();
+    height = 0;
+
+    int count = static_cast<int>(nodes.size());
+    std::vector<int> stack;
+    int current = count > 0 ? 0 : -1;
+    int column = 0;
+
+    while (current != -1 || !stack.empty()) {
+        while (current != -1) {
+            stack.push_back(current);
+            int left = 2 * current + 1;
+            current = left < count ? left : -1;
+        }
+
+        int index = stack.back();
+        stack.pop_back();
+
+        int depth = 0;
+        for (int i = index; i > 0; i = (i - 1) / 2) depth++;
+
+        int parentId = index > 0 ? nodes[(index - 1) / 2]->id : -1;
+        cells.push_back(LayoutCell(nodes[index]->id, nodes[index]->value, column++,
+                                   depth, parentId, index % 2 == 1));
+        if (depth + 1 > height) {
+            height = depth + 1;
+        }
+
+        int right = 2 * index + 2;
+        current = right < count ? right : -1;
+    }
+}
+
+// ============================================================================
+// LINEAR LAYOUT
+// ============================================================================
+// Lists, stacks and queues: one column per element, in the given order.
+// ============================================================================
+template <typename NodeT>
+void computeLinearLayout(const std::vector<NodeT*>& nodes, std::vector<LayoutCell>& cells) {
+    cells.clear();
+    int previousId = -1;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        cells.push_back(LayoutCell(nodes[i]->id, nodes[i]->value,
+                                   static_cast<int>(i), 0, previousId, false));
+        previousId = nodes[i]->id;
+    }
+}
+
+// ============================================================================
+// POST-ORDER VISIT WITH HEIGHTS
+// ============================================================================
+// Calls visit(node, height) children-first, where height counts levels
+// (a leaf has height 1). Memory is O(tree height), not O(node count), so
+// exporters can stream trees of any size. Returns the height of 'root'.
+// ============================================================================
+template <typename NodeT, typename Visit>
+int visitPostorder(NodeT* root, Visit visit) {
+    struct Frame {
+        NodeT* node;
+        int leftHeight;
+        int stage;          // 0 = go left, 1 = go right, 2 = done
+    };
+
+    if (root == nullptr) return 0;
+    std::vector<Frame> stack;
+    stack.push_back({root, 0, 0});
+    int returned = 0;       // Height of the subtree that just finished
+
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        if (frame.stage == 0) {
+            frame.stage = 1;
+            if (frame.node->left) {
+                stack.push_back({frame.node->left, 0, 0});
+                continue;
+            }
+            returned = 0;
+        }
+        if (frame.stage == 1) {
+            frame.leftHeight = returned;
+            frame.stage = 2;
+            if (frame.node->right) {
+                stack.push_back({frame.node->right, 0, 0});
+                continue;
+            }
+            returned = 0;
+        }
+        int height = 1 + std::max(frame.leftHeight, returned);
+        visit(frame.node, height);
+        stack.pop_back();
+        returned = height;
+    }
+    return returned;
+}
+
+#endif // TREE_LAYOUT_H
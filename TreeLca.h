@@ -0,0 +1,186 @@
+// File: TreeLca.h
+// Description: Constant-time lowest-common-ancestor queries for any binary
+// tree whose nodes have 'id', 'left' and 'right' (BST::Node, AVLNode).
+//
+// build() walks the tree once and records its Euler tour: every node is
+// written when the walk enters it and again after each child returns, with
+// its depth (2n - 1 entries). Between the first occurrences of two nodes
+// the tour passes through their LCA and through nothing shallower, so the
+// LCA is the minimum-depth entry of that range - a range-minimum query.
+//
+// The RMQ uses block decomposition to stay at O(n) memory:
+// - the tour is cut into 64-entry blocks, and a sparse table over the block
+//   minima answers any run of whole blocks with two lookups
+// - inside a block, entry j keeps a 64-bit mask of the positions on the
+//   "increasing depth" stack ending at j; the minimum of [i, j] is the
+//   lowest set bit of that mask at or above i, found with one ctz
+// So build() is O(n) and query() is O(1) with no loops.
+//
+// The index is a snapshot: any change to the tree makes it stale. The trees
+// call invalidate() from every mutation and rebuild on the next query.
+
+#ifndef TREE_LCA_H
+#define TREE_LCA_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+template <typename NodeT>
+class EulerTourLCA {
+private:
+    static const int BLOCK = 64;
+
+    std::vector<NodeT*> tour;           // Euler tour
+    std::vector<int> depth;             // Depth of each tour entry
+    std::vector<uint64_t> stackMask;    // In-block minimum stacks (see above)
+    std::vector<int> firstVisit;        // Node id -> first tour index (-1 = none)
+    std::vector<int> sparse;            // Level k: min over 2^k blocks (tour index)
+    int blockCount;
+    bool valid;
+
+    static int lowestBit(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(mask);
+#else
+        int bit = 0;
+        while ((mask & 1) == 0) {
+            mask >>= 1;
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+    static int highestBit(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(mask);
+#else
+        int bit = 0;
+        while (mask >>= 1) bit++;
+        return bit;
+#endif
+    }
+
+    static int floorLog2(int n) { return highestBit(static_cast<uint64_t>(n)); }
+
+    int shallower(int a, int b) const { return depth[b] < depth[a] ? b : a; }
+
+    // Minimum of [i, j] when both lie in the same block
+    int blockMin(int i, int j) const {
+        int start = i & ~(BLOCK - 1);
+        return start + lowestBit(stackMask[j] & (~0ULL << (i - start)));
+    }
+
+public:
+    EulerTourLCA() : blockCount(0), valid(false) {}
+
+    bool isValid() const { return valid; }
+    void invalidate() { valid = false; }
+
+    void build(NodeT* root) {
+        tour.clear();
+        depth.clear();
+        firstVisit.clear();
+
+        // Iterative walk; 'stage' counts the children already handled
+        struct Frame {
+            NodeT* node;
+            int stage;
+        };
+        std::vector<Frame> stack;
+        if (root) stack.push_back({root, 0});
+        while (!stack.empty()) {
+            Frame& frame = stack.back();
+            NodeT* node = frame.node;
+            int level = static_cast<int>(stack.size()) - 1;
+            if (frame.stage == 0) {
+                if (node->id >= static_cast<int>(firstVisit.size())) {
+                    firstVisit.resize(static_cast<size_t>(node->id) + 1, -1);
+                }
+                firstVisit[node->id] = static_cast<int>(tour.size());
+            }
+            tour.push_back(node);
+            depth.push_back(level);
+
+            NodeT* next = nullptr;
+            while (frame.stage < 2 && next == nullptr) {
+                next = frame.stage == 0 ? node->left : node->right;
+                frame.stage++;
+            }
+            if (next) {
+                stack.push_back({next, 0});
+            } else {
+                // Done; the parent is written again on its next pass
+                stack.pop_back();
+            }
+        }
+
+        // In-block stacks of strictly increasing depth
+        int n = static_cast<int>(tour.size());
+        stackMask.assign(tour.size(), 0);
+        blockCount = (n + BLOCK - 1) / BLOCK;
+        std::vector<int> blockMinimum(static_cast<size_t>(blockCount));
+        for (int block = 0; block < blockCount; block++) {
+            int start = block * BLOCK;
+            uint64_t mask = 0;
+            for (int j = start; j < n && j < start + BLOCK; j++) {
+                // Pop every stack entry at least as deep as j
+                while (mask != 0) {
+                    int top = highestBit(mask);
+                    if (depth[start + top] < depth[j]) break;
+                    mask &= ~(1ULL << top);
+                }
+                mask |= 1ULL << (j - start);
+                stackMask[j] = mask;
+            }
+            int last = std::min(n, start + BLOCK) - 1;
+            blockMinimum[block] = start + lowestBit(stackMask[last]);
+        }
+
+        // Sparse table over the block minima
+        int levels = blockCount > 0 ? floorLog2(blockCount) + 1 : 0;
+        sparse.assign(static_cast<size_t>(levels) * blockCount, 0);
+        for (int b = 0; b < blockCount; b++) sparse[b] = blockMinimum[b];
+        for (int k = 1; k < levels; k++) {
+            const int* below = &sparse[static_cast<size_t>(k - 1) * blockCount];
+            int* row = &sparse[static_cast<size_t>(k) * blockCount];
+            for (int b = 0; b + (1 << k) <= blockCount; b++) {
+                row[b] = shallower(below[b], below[b + (1 << (k - 1))]);
+            }
+        }
+        valid = true;
+    }
+
+    // LCA of two nodes of the indexed tree; nullptr if either is unknown
+    NodeT* query(const NodeT* a, const NodeT* b) const {
+        if (!a || !b || a->id >= static_cast<int>(firstVisit.size()) ||
+            b->id >= static_cast<int>(firstVisit.size())) return nullptr;
+        int i = firstVisit[a->id];
+        int j = firstVisit[b->id];
+        if (i < 0 || j < 0) return nullptr;
+        if (i > j) std::swap(i, j);
+
+        int blockI = i / BLOCK;
+        int blockJ = j / BLOCK;
+        if (blockI == blockJ) return tour[blockMin(i, j)];
+
+        int best = shallower(blockMin(i, blockI * BLOCK + BLOCK - 1), blockMin(blockJ * BLOCK, j));
+        if (blockJ - blockI > 1) {
+            int from = blockI + 1;
+            int k = floorLog2(blockJ - from);
+            const int* row = &sparse[static_cast<size_t>(k) * blockCount];
+            best = shallower(best, shallower(row[from], row[blockJ - (1 << k)]));
+        }
+        return tour[best];
+    }
+
+    // Bytes held by the index
+    size_t memoryBytes() const {
+        return tour.capacity() * sizeof(NodeT*) + depth.capacity() * sizeof(int) +
+               stackMask.capacity() * sizeof(uint64_t) + firstVisit.capacity() * sizeof(int) +
+               sparse.capacity() * sizeof(int);
+    }
+};
+
+#endif // TREE_LCA_H
@@ -0,0 +1,245 @@
+// File: UnrolledList.cpp
+// Description: Unrolled linked list - block splits, merges and lookups
+
+#include "UnrolledList.h"
+#include <algorithm>
+#include <sstream>
+
+const int UnrolledBlock::MAX_CAPACITY;
+
+UnrolledList::UnrolledList(int blockCapacity)
+    : head(nullptr), tail(nullptr), capacity(2), nextBlockId(0), size(0), blockCount(0),
+      lastSplitId(-1), lastMergeId(-1)
+{
+    setCapacity(blockCapacity);
+}
+
+UnrolledList::~UnrolledList() {
+    clear();
+}
+
+UnrolledBlock* UnrolledList::newBlock() {
+    blockCount++;
+    return new UnrolledBlock(nextBlockId++);
+}
+
+// ============================================================================
+// REBALANCING
+// ============================================================================
+
+void UnrolledList::split(UnrolledBlock* block) {
+    UnrolledBlock* upper = newBlock();
+    int keep = block->count / 2;
+    upper->count = block->count - keep;
+    std::copy(block->values + keep, block->values + block->count, upper->values);
+    block->count = keep;
+
+    upper->next = block->next;
+    block->next = upper;
+    if (tail == block) {
+        tail = upper;
+    }
+    lastSplitId = upper->id;
+}
+
+void UnrolledList::refill(UnrolledBlock* block, UnrolledBlock* previous) {
+    int half = capacity / 2;
+    if (block->count >= half) {
+        return;
+    }
+
+    UnrolledBlock* following = block->next;
+    if (following == nullptr) {
+        // The last block may run low, but not empty
+        if (block->count == 0) {
+            if (previous) previous->next = nullptr;
+            else head = nullptr;
+            tail = previous;
+            delete block;
+            blockCount--;
+        }
+        return;
+    }
+
+    if (block->count + following->count <= capacity) {
+        // Merge the successor into this block
+        std::copy(following->values, following->values + following->count, block->values + block->count);
+        block->count += following->count;
+        block->next = following->next;
+        if (tail == following) {
+            tail = block;
+        }
+        lastMergeId = following->id;
+        delete following;
+        blockCount--;
+    } else {
+        // Borrow from the successor until both are at least half full
+        int moved = half - block->count;
+        std::copy(following->values, following->values + moved, block->values + block->count);
+        block->count += moved;
+        std::copy(following->values + moved, following->values + following->count, following->values);
+        following->count -= moved;
+    }
+}
+
+void UnrolledList::eraseFrom(UnrolledBlock* block, UnrolledBlock* previous, int index) {
+    std::copy(block->values + index + 1, block->values + block->count, block->values + index);
+    block->count--;
+    size--;
+    refill(block, previous);
+}
+
+// ============================================================================
+// INSERT
+// ============================================================================
+
+void UnrolledList::insertAtTail(int value) {
+    lastSplitId = lastMergeId = -1;
+    if (tail == nullptr || tail->count == capacity) {
+        // Appends leave full blocks behind
+        UnrolledBlock* block = newBlock();
+        if (tail) tail->next = block;
+        else head = block;
+        tail = block;
+    }
+    tail->values[tail->count++] = value;
+    size++;
+}
+
+void UnrolledList::insertAtHead(int value) {
+    std::vector<UnrolledBlock*> path;
+    insertAt(0, value, path);
+}
+
+bool UnrolledList::insertAt(size_t index, int value, std::vector<UnrolledBlock*>& path) {
+    lastSplitId = lastMergeId = -1;
+    if (index > size) {
+        return false;
+    }
+    if (head == nullptr) {
+        head = tail = newBlock();
+    }
+
+    // Find the block holding position 'index' (the tail for an append)
+    UnrolledBlock* block = head;
+    size_t offset = index;
+    path.push_back(block);
+    while (offset > static_cast<size_t>(block->count) ||
+           (offset == static_cast<size_t>(block->count) && block->next != nullptr)) {
+        offset -= block->count;
+        block = block->next;
+        path.push_back(block);
+    }
+
+    if (block->count == capacity) {
+        split(block);
+        if (offset > static_cast<size_t>(block->count)) {
+            offset -= block->count;
+            block = block->next;
+        }
+    }
+
+    std::copy_backward(block->values + offset, block->values + block->count, block->values + block->count + 1);
+    block->values[offset] = value;
+    block->count++;
+    size++;
+    return true;
+}
+
+// ============================================================================
+// REMOVE / SEARCH
+// ============================================================================
+
+bool UnrolledList::remove(int value, std::vector<UnrolledBlock*>& path) {
+    lastSplitId = lastMergeId = -1;
+    UnrolledBlock* previous = nullptr;
+    for (UnrolledBlock* block = head; block != nullptr; previous = block, block = block->next) {
+        path.push_back(block);
+        int* found = std::find(block->values, block->values + block->count, value);
+        if (found != block->values + block->count) {
+            eraseFrom(block, previous, static_cast<int>(found - block->values));
+            return true;
+        }
+    }
+    return false;
+}
+
+UnrolledBlock* UnrolledList::search(int value, int& offset, std::vector<UnrolledBlock*>& path) const {
+    for (UnrolledBlock* block = head; block != nullptr; block = block->next) {
+        path.push_back(block);
+        const int* found = std::find(block->values, block->values + block->count, value);
+        if (found != block->values + block->count) {
+            offset = static_cast<int>(found - block->values);
+            return block;
+        }
+    }
+    offset = -1;
+    return nullptr;
+}
+
+bool UnrolledList::contains(int value) const {
+    for (UnrolledBlock* block = head; block != nullptr; block = block->next) {
+        if (std::find(block->values, block->values + block->count, value) != block->values + block->count) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int UnrolledList::at(size_t index) const {
+    UnrolledBlock* block = head;
+    while (index >= static_cast<size_t>(block->count)) {
+        index -= block->count;
+        block = block->next;
+    }
+    return block->values[index];
+}
+
+// ============================================================================
+// BULK
+// ============================================================================
+
+void UnrolledList::clear() {
+    UnrolledBlock* block = head;
+    while (block != nullptr) {
+        UnrolledBlock* next = block->next;
+        delete block;
+        block = next;
+    }
+    head = tail = nullptr;
+    size = 0;
+    blockCount = 0;
+    lastSplitId = lastMergeId = -1;
+}
+
+void UnrolledList::setCapacity(int blockCapacity) {
+    clear();
+    capacity = std::max(2, std::min(blockCapacity, UnrolledBlock::MAX_CAPACITY));
+}
+
+void UnrolledList::loadValues(const std::vector<int>& values) {
+    clear();
+    for (int value : values) {
+        insertAtTail(value);
+    }
+    lastSplitId = -1;
+}
+
+std::string UnrolledList::toString() const {
+    if (isEmpty()) {
+        return "[ Empty ]";
+    }
+
+    std::ostringstream ss;
+    for (UnrolledBlock* block = head; block != nullptr; block = block->next) {
+        ss << "[";
+        for (int i = 0; i < block->count; i++) {
+            ss << (i > 0 ? " " : "") << block->values[i];
+        }
+        ss << "]";
+        if (block->next != nullptr) {
+            ss << " -> ";
+        }
+    }
+    return ss.str();
+}
@@ -0,0 +1,118 @@
+// File: UnrolledList.h
+// Description: Unrolled linked list - a singly linked list of blocks that
+// each hold up to 'capacity' values in an inline array.
+//
+// A traversal reads a block's values from consecutive memory and follows
+// one pointer per block instead of one per value, so scans run at close
+// to array speed while inserts in the middle still only shift values
+// within a single block.
+//
+// Invariants: no block is empty, and every block except the last keeps
+// at least half its capacity. An insert into a full block first splits it
+// into two half-full blocks. A remove that leaves a block under half full
+// refills it from the next block: the two merge if they fit into one,
+// otherwise values are borrowed until both are at least half full.
+//
+// Positions are 0-based indices into the sequence; locating one walks the
+// blocks by their counts, O(n / capacity).
+
+#ifndef UNROLLED_LIST_H
+#define UNROLLED_LIST_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "MemoryAccount.h"
+
+// ============================================================================
+// UNROLLED BLOCK
+// ============================================================================
+struct UnrolledBlock : TrackedAllocation<MemoryAccount::STRUCTURE_NODES> {
+    static const int MAX_CAPACITY = 64;
+
+    int count;
+    int values[MAX_CAPACITY];
+    UnrolledBlock* next;
+    int id;                 // For the visualization
+
+    explicit UnrolledBlock(int blockId) : count(0), next(nullptr), id(blockId) {}
+};
+
+// ============================================================================
+// UNROLLED LIST CLASS
+// ============================================================================
+class UnrolledList {
+private:
+    UnrolledBlock* head;
+    UnrolledBlock* tail;
+    int capacity;
+    int nextBlockId;
+    size_t size;
+    size_t blockCount;
+    int lastSplitId;        // New block of the last split, -1 if none
+    int lastMergeId;        // Block absorbed by the last merge, -1 if none
+
+    UnrolledBlock* newBlock();
+
+    // Split a full block in half; the upper half moves to a new block
+    // linked after it
+    void split(UnrolledBlock* block);
+
+    // Restore the half-full invariant of 'block' from its successor
+    void refill(UnrolledBlock* block, UnrolledBlock* previous);
+
+    // Delete values[index] of 'block' and rebalance
+    void eraseFrom(UnrolledBlock* block, UnrolledBlock* previous, int index);
+
+public:
+    // 'blockCapacity' is clamped to [2, UnrolledBlock::MAX_CAPACITY]
+    explicit UnrolledList(int blockCapacity = 32);
+    ~UnrolledList();
+
+    UnrolledList(const UnrolledList&) = delete;
+    UnrolledList& operator=(const UnrolledList&) = delete;
+
+    // Insert at the end / beginning
+    void insertAtTail(int value);
+    void insertAtHead(int value);
+
+    // Insert before position 'index' (index == size appends); false if
+    // index > size. 'path' gets the blocks walked to find the position.
+    bool insertAt(size_t index, int value, std::vector<UnrolledBlock*>& path);
+
+    // Remove the first occurrence of 'value'; 'path' gets the blocks scanned
+    bool remove(int value, std::vector<UnrolledBlock*>& path);
+
+    // Find the first occurrence of 'value': its block (nullptr if absent)
+    // and the offset within it. 'path' gets the blocks scanned.
+    UnrolledBlock* search(int value, int& offset, std::vector<UnrolledBlock*>& path) const;
+
+    bool contains(int value) const;
+
+    // Value at position 'index' (must be < size)
+    int at(size_t index) const;
+
+    // Clear the list; a new capacity applies to the blocks built afterwards
+    void clear();
+    void setCapacity(int blockCapacity);
+
+    // Replace the contents with 'values', packing the blocks full
+    void loadValues(const std::vector<int>& values);
+
+    bool isEmpty() const { return size == 0; }
+    size_t getSize() const { return size; }
+    size_t getBlockCount() const { return blockCount; }
+    int getCapacity() const { return capacity; }
+    UnrolledBlock* getHead() const { return head; }
+
+    // What the last insert / remove did to the blocks (for the animation)
+    int getLastSplitId() const { return lastSplitId; }
+    int getLastMergeId() const { return lastMergeId; }
+
+    // Bytes used by the blocks
+    size_t memoryBytes() const { return blockCount * sizeof(UnrolledBlock); }
+
+    std::string toString() const;
+};
+
+#endif // UNROLLED_LIST_H
@@ -645,6 +645,45 @@ void Visualizer::animateSearch(const std::vector<Node*>& path, bool found) {
     startNextStep();
 }
 
+void Visualizer::animateLCA(const std::vector<Node*>& pathA, const std::vector<Node*>& pathB,
+                            Node* ancestor) {
+    clearAnimations();
+    
+    float stepDuration = Config::DEFAULT_ANIMATION_DURATION;
+    
+    // First root path, like a search
+    for (size_t i = 0; i < pathA.size(); i++) {
+        animationQueue.push(AnimationStep(AnimationStep::HIGHLIGHT_NODE, pathA[i]->id,
+                                          stepDuration * 0.5f));
+        if (i > 0) {
+            animationQueue.push(AnimationStep(AnimationStep::HIGHLIGHT_EDGE, pathA[i]->id,
+                                              stepDuration * 0.2f, sf::Color::White, pathA[i - 1]->id));
+        }
+    }
+    
+    // Second root path: its part above the ancestor is already lit
+    bool below = false;
+    for (size_t i = 0; i < pathB.size(); i++) {
+        if (below) {
+            animationQueue.push(AnimationStep(AnimationStep::HIGHLIGHT_EDGE, pathB[i]->id,
+                                              stepDuration * 0.2f, sf::Color::White, pathB[i - 1]->id));
+            animationQueue.push(AnimationStep(AnimationStep::COLOR_CHANGE, pathB[i]->id,
+                                              stepDuration * 0.5f, Config::STACK_COLOR));
+        }
+        if (pathB[i] == ancestor) below = true;
+    }
+    
+    // The ancestor where the two paths split
+    if (ancestor) {
+        animationQueue.push(AnimationStep(AnimationStep::COLOR_CHANGE, ancestor->id,
+                                          stepDuration * 2.0f, Config::NODE_FOUND_FILL));
+    }
+    
+    animationQueue.push(AnimationStep(AnimationStep::RESET_COLORS, -1, 0.1f));
+    
+    startNextStep();
+}
+
 void Visualizer::animateClear() {
     clearAnimations();
     
@@ -664,6 +703,18 @@ void Visualizer::animateClear() {
     startNextStep();
 }
 
+void Visualizer::animateBatch() {
+    clearAnimations();
+    
+    // Drop visuals of removed nodes and lay out the new tree once
+    syncVisualState();
+    
+    animationQueue.push(AnimationStep(AnimationStep::MOVE_NODES, -1, Config::DEFAULT_ANIMATION_DURATION));
+    animationQueue.push(AnimationStep(AnimationStep::RESET_COLORS, -1, 0.1f));
+    
+    startNextStep();
+}
+
 // ============================================================================
 // LAYOUT AND REFRESH
 // ============================================================================
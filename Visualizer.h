@@ -11,11 +11,13 @@
 
 #include <SFML/Graphics.hpp>
 #include <queue>
+#include <deque>
 #include <vector>
 #include <unordered_map>
 #include <functional>
 #include "BST.h"
 #include "Config.h"
+#include "MemoryAccount.h"
 
 // ============================================================================
 // ANIMATION STEP STRUCTURE
@@ -96,11 +98,15 @@ private:
     sf::Font* font;                             // Font for node labels
     
     // Visual state tracking
-    std::unordered_map<int, NodeVisual> nodeVisuals;  // Node ID -> visual state
-    std::vector<EdgeVisual> edges;                     // All edges
+    std::unordered_map<int, NodeVisual, std::hash<int>, std::equal_to<int>,
+                       TrackingAllocator<std::pair<const int, NodeVisual>, MemoryAccount::NODE_VISUALS>>
+        nodeVisuals;                                   // Node ID -> visual state
+    std::vector<EdgeVisual, TrackingAllocator<EdgeVisual, MemoryAccount::EDGE_VISUALS>>
+        edges;                                         // All edges
     
     // Animation system
-    std::queue<AnimationStep> animationQueue;
+    std::queue<AnimationStep, std::deque<AnimationStep, TrackingAllocator<AnimationStep, MemoryAccount::ANIMATION_STEPS>>>
+        animationQueue;
     AnimationStep currentStep;
     float stepTimer;                            // Time elapsed in current step
     float speedFactor;                          // Multiplier for animation speed
@@ -188,9 +194,19 @@ public:
     // Animate search: highlight each node in path, then result
     void animateSearch(const std::vector<Node*>& path, bool found);
     
+    // Animate a lowest-common-ancestor query: the root path of the first
+    // node in yellow, the part of the second path below the ancestor in
+    // orange, then the ancestor itself in green
+    void animateLCA(const std::vector<Node*>& pathA, const std::vector<Node*>& pathB,
+                    Node* ancestor);
+    
     // Animate clearing the tree
     void animateClear();
     
+    // Animate the result of a batch of operations (console command):
+    // one layout pass and one move, however many nodes changed
+    void animateBatch();
+    
     // ========================================================================
     // LAYOUT AND REFRESH
     // ========================================================================
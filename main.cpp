@@ -11,6 +11,18 @@
 //   2. Linked List - linear, dynamic sequence
 //   3. Stack - LIFO (Last In First Out) 
 //   4. Queue - FIFO (First In First Out)
+//   5. Interval Tree - AVL tree of intervals with stabbing / overlap queries
+//   6. K-d Tree - 2D points with nearest-neighbour and range search
+//   7. Bloom / Cuckoo Filter - approximate membership with false positives
+//   8. Stream Sketches - count-min heavy hitters and HyperLogLog distinct counts
+//   9. Scapegoat Tree - BST balanced by occasional subtree rebuilds
+//  10. Rope - balanced tree of text chunks for editing large files
+//  11. Sliding Window - min / max over a stream with monotonic deques
+//  12. External Sort - sorted runs merged through a MinHeap of run heads
+//  13. Top-K - per-thread bounded MinHeaps behind a block threshold filter
+//  14. Unrolled List - linked blocks of values with split / merge
+//  15. Concurrent AVL - worker threads on an optimistic AVL, locks shown live
+//  16. Typed Keys - AVL trees of int64, double and short-string keys
 //
 // KEY FEATURES:
 // - Animated insert, delete, search operations
@@ -18,6 +30,17 @@
 // - Export visualization to PNG
 // - Error handling with user feedback
 // - Clean, modern GUI using SFML
+// - Headless / terminal mode for machines without a display (--headless)
+// - Command console (F1 or ~) for batch operations, e.g. "insert 1..1000"
+// - Control socket for test harnesses (--control-socket PATH)
+// - Sessions survive "Back to Menu" and crashes (journal + snapshot files)
+// - Built-in benchmarks against naive baselines (--bench NAME)
+// - Stream sketches (count-min, HyperLogLog) over large files (--sketch FILE)
+// - External merge sort of int32 files larger than memory (--sort IN OUT)
+// - Live memory breakdown per structure / visual layer (F3)
+// - Live tree shape chart: depths, balance factors, leaves (F4, BST)
+// - Invariant checks, full and sampled per frame (F5, --headless --check)
+// - Allocations per frame phase and per operation (-DALLOCATION_TRACKER)
 //
 // HOW IT WORKS:
 // 1. Main menu lets user select a data structure
@@ -29,6 +52,17 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <set>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <type_traits>
 #include "Config.h"
 #include "BST.h"
 #include "LinkedList.h"
@@ -36,6 +70,26 @@
 #include "Queue.h"
 #include "Visualizer.h"
 #include "GUIElements.h"
+#include "HeadlessDriver.h"
+#include "CommandLanguage.h"
+#include "ControlServer.h"
+#include "SessionJournal.h"
+#include "StructureExporter.h"
+#include "IntervalTree.h"
+#include "KdTree.h"
+#include "TreeCanvas.h"
+#include "Benchmarks.h"
+#include "BloomFilter.h"
+#include "CuckooFilter.h"
+#include "StreamSketch.h"
+#include "ScapegoatTree.h"
+#include "Rope.h"
+#include "SlidingWindow.h"
+#include "ExternalSort.h"
+#include "UnrolledList.h"
+#include "ConcurrentAVL.h"
+#include "MemoryAccount.h"
+#include "AllocationTracker.h"
 
 // ============================================================================
 // DATA STRUCTURE TYPE ENUMERATION
@@ -46,7 +100,19 @@ enum class DataStructureType {
     BST,            // Binary Search Tree mode
     LINKED_LIST,    // Singly Linked List mode
     STACK,          // Stack (LIFO) mode
-    QUEUE           // Queue (FIFO) mode
+    QUEUE,          // Queue (FIFO) mode
+    INTERVAL_TREE,  // Interval tree mode
+    KD_TREE,        // 2D k-d tree mode
+    FILTERS,        // Bloom / cuckoo filter mode
+    SKETCHES,       // Streaming count-min / HyperLogLog mode
+    SCAPEGOAT,      // Scapegoat tree mode
+    ROPE,           // Rope (large text editing) mode
+    SLIDING_WINDOW, // Sliding-window min / max mode
+    EXTERNAL_SORT,  // External merge sort mode
+    TOP_K,          // Parallel top-K mode
+    UNROLLED_LIST,  // Unrolled linked list mode
+    CONCURRENT_AVL, // Multi-threaded optimistic AVL mode
+    KEYED_TREE      // AVL trees with non-int key types
 };
 
 // ============================================================================
@@ -57,11 +123,56 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font);
 void runLinkedListMode(sf::RenderWindow& window, sf::Font& font);
 void runStackMode(sf::RenderWindow& window, sf::Font& font);
 void runQueueMode(sf::RenderWindow& window, sf::Font& font);
+void runIntervalTreeMode(sf::RenderWindow& window, sf::Font& font);
+void runKdTreeMode(sf::RenderWindow& window, sf::Font& font);
+void runFilterMode(sf::RenderWindow& window, sf::Font& font);
+void runSketchMode(sf::RenderWindow& window, sf::Font& font);
+void runScapegoatMode(sf::RenderWindow& window, sf::Font& font);
+void runRopeMode(sf::RenderWindow& window, sf::Font& font);
+void runWindowMode(sf::RenderWindow& window, sf::Font& font);
+void runExternalSortMode(sf::RenderWindow& window, sf::Font& font);
+void runTopKMode(sf::RenderWindow& window, sf::Font& font);
+void runUnrolledListMode(sf::RenderWindow& window, sf::Font& font);
+void runConcurrentAVLMode(sf::RenderWindow& window, sf::Font& font);
+void runKeyedTreeMode(sf::RenderWindow& window, sf::Font& font);
 
 // Helper function to export any visualization to PNG
 bool exportVisualizationToPNG(sf::RenderWindow& window, const std::string& filename, 
                                float areaX, float areaY, float areaW, float areaH);
 
+// Memory breakdown (and allocations per frame when built with
+// ALLOCATION_TRACKER) overlay, toggled with F3 (drawn by every mode)
+void drawMemoryHud(sf::RenderWindow& window, sf::Font& font);
+
+// Depth histogram and balance-factor chart of a tree, toggled with F4
+void drawShapeHud(sf::RenderWindow& window, sf::Font& font, const ShapeStats& shape);
+
+// Full and per-frame sampled invariant checks of a structure, toggled with F5.
+// Each mode keeps its own state: the last full check and the samples since.
+struct InvariantHudState {
+    InvariantSampler sampler;
+    InvariantReport full;
+    InvariantReport sampleFailure;          // First failed sample since the full check
+    unsigned long long sampledNodes;
+    unsigned long long sampledFrames;
+    bool checked;                           // 'full' belongs to this showing of the HUD
+
+    InvariantHudState() : sampledNodes(0), sampledFrames(0), checked(false) {}
+};
+void drawInvariantHud(sf::RenderWindow& window, sf::Font& font, StructureAdapter& adapter,
+                      InvariantHudState& state);
+
+// Writes <name>_export.dot and <name>_export.json next to the PNG
+bool exportStructureFiles(StructureAdapter& adapter);
+
+// Console helpers shared by all modes
+void attachConsole(ConsolePanel& console, CommandInterpreter& interpreter);
+bool runConsoleCommand(ConsolePanel& console, CommandInterpreter& interpreter);
+
+// Control socket (nullptr unless --control-socket was given)
+ControlServer* controlServer = nullptr;
+bool applyControlCommands(StructureAdapter& adapter, sf::RenderWindow& window);
+
 // ============================================================================
 // FONT LOADER
 // Tries multiple paths for cross-platform compatibility
@@ -88,8 +199,39 @@ bool loadFont(sf::Font& font) {
 // ============================================================================
 // MAIN FUNCTION
 // Entry point - creates window, shows menu, delegates to mode functions
+// With --headless no window is opened; see HeadlessDriver.h for usage.
 // ============================================================================
-int main() {
+int main(int argc, char* argv[]) {
+    HeadlessOptions headlessOptions;
+    if (!HeadlessDriver::parseArguments(argc, argv, headlessOptions)) {
+        return 2;
+    }
+    if (!headlessOptions.benchmark.empty()) {
+        return Benchmarks::run(headlessOptions.benchmark, headlessOptions.benchmarkSize, std::cout);
+    }
+    if (!headlessOptions.sketchPath.empty()) {
+        return StreamSketch::analyzeFile(headlessOptions.sketchPath, std::cout);
+    }
+    if (!headlessOptions.sortInput.empty()) {
+        return ExternalSort::run(headlessOptions.sortInput, headlessOptions.sortOutput,
+                                 headlessOptions.sortMemoryMB << 20, std::cout);
+    }
+    if (headlessOptions.enabled) {
+        HeadlessDriver driver(headlessOptions);
+        return driver.run();
+    }
+    
+    // Optional control socket: clients drive whichever mode is open
+    ControlServer server(headlessOptions.controlSocket);
+    if (!headlessOptions.controlSocket.empty()) {
+        std::string error;
+        if (!server.start(error)) {
+            std::cerr << "Control socket error: " << error << std::endl;
+            return 2;
+        }
+        controlServer = &server;
+    }
+    
     // Create the main application window
     sf::RenderWindow window(
         sf::VideoMode(Config::WINDOW_WIDTH, Config::WINDOW_HEIGHT),
@@ -118,16 +260,49 @@ int main() {
     float buttonHeight = 55.0f;
     float buttonSpacing = 18.0f;
     
-    // Create menu buttons for each data structure
+    // Menu entries in display order. At most five rows fit between the
+    // subtitle and the footer, so further entries start new columns (and
+    // the buttons get narrower once the columns no longer fit).
+    struct MenuEntry {
+        const char* label;
+        DataStructureType mode;
+    };
+    const std::vector<MenuEntry> menuEntries = {
+        {"Binary Search Tree (BST)", DataStructureType::BST},
+        {"Linked List", DataStructureType::LINKED_LIST},
+        {"Stack (LIFO)", DataStructureType::STACK},
+        {"Queue (FIFO)", DataStructureType::QUEUE},
+        {"Interval Tree", DataStructureType::INTERVAL_TREE},
+        {"K-d Tree (2D points)", DataStructureType::KD_TREE},
+        {"Bloom / Cuckoo Filter", DataStructureType::FILTERS},
+        {"Stream Sketches", DataStructureType::SKETCHES},
+        {"Scapegoat Tree", DataStructureType::SCAPEGOAT},
+        {"Rope (Text)", DataStructureType::ROPE},
+        {"Sliding Window", DataStructureType::SLIDING_WINDOW},
+        {"External Sort", DataStructureType::EXTERNAL_SORT},
+        {"Top-K", DataStructureType::TOP_K},
+        {"Unrolled List", DataStructureType::UNROLLED_LIST},
+        {"Concurrent AVL", DataStructureType::CONCURRENT_AVL},
+        {"Typed Keys", DataStructureType::KEYED_TREE}
+    };
+    
+    size_t menuColumns = (menuEntries.size() + 4) / 5;
+    size_t menuRows = (menuEntries.size() + menuColumns - 1) / menuColumns;
+    float columnGap = 30.0f;
+    // Narrow the buttons when the columns would not fit the window
+    buttonWidth = std::min(buttonWidth,
+                           (Config::WINDOW_WIDTH - 60 - (menuColumns - 1) * columnGap) / menuColumns);
+    float menuLeft = menuCenterX - (menuColumns * buttonWidth + (menuColumns - 1) * columnGap) / 2;
+    
+    // Create menu buttons for each data structure (filled column by column)
     std::vector<Button> menuButtons;
-    menuButtons.push_back(Button(menuCenterX - buttonWidth/2, menuStartY, 
-                                  buttonWidth, buttonHeight, "Binary Search Tree (BST)", font));
-    menuButtons.push_back(Button(menuCenterX - buttonWidth/2, menuStartY + (buttonHeight + buttonSpacing), 
-                                  buttonWidth, buttonHeight, "Linked List", font));
-    menuButtons.push_back(Button(menuCenterX - buttonWidth/2, menuStartY + 2*(buttonHeight + buttonSpacing), 
-                                  buttonWidth, buttonHeight, "Stack (LIFO)", font));
-    menuButtons.push_back(Button(menuCenterX - buttonWidth/2, menuStartY + 3*(buttonHeight + buttonSpacing), 
-                                  buttonWidth, buttonHeight, "Queue (FIFO)", font));
+    for (size_t i = 0; i < menuEntries.size(); i++) {
+        size_t column = i / menuRows;
+        size_t row = i % menuRows;
+        menuButtons.push_back(Button(menuLeft + column * (buttonWidth + columnGap),
+                                      menuStartY + row * (buttonHeight + buttonSpacing),
+                                      buttonWidth, buttonHeight, menuEntries[i].label, font));
+    }
     
     // Menu title text
     sf::Text menuTitle;
@@ -158,7 +333,7 @@ int main() {
     instructions.setFillColor(sf::Color(100, 140, 180));
     sf::FloatRect instrBounds = instructions.getLocalBounds();
     instructions.setOrigin(instrBounds.width / 2, instrBounds.height / 2);
-    instructions.setPosition(menuCenterX, menuStartY + 4*(buttonHeight + buttonSpacing) + 40);
+    instructions.setPosition(menuCenterX, menuStartY + menuRows*(buttonHeight + buttonSpacing) + 30);
     
     // Footer
     sf::Text footer;
@@ -184,12 +359,7 @@ int main() {
             if (currentMode == DataStructureType::NONE) {
                 for (size_t i = 0; i < menuButtons.size(); i++) {
                     if (menuButtons[i].handleEvent(event, window)) {
-                        switch (i) {
-                            case 0: currentMode = DataStructureType::BST; break;
-                            case 1: currentMode = DataStructureType::LINKED_LIST; break;
-                            case 2: currentMode = DataStructureType::STACK; break;
-                            case 3: currentMode = DataStructureType::QUEUE; break;
-                        }
+                        currentMode = menuEntries[i].mode;
                     }
                 }
             }
@@ -223,6 +393,42 @@ int main() {
                 case DataStructureType::QUEUE:
                     runQueueMode(window, font);
                     break;
+                case DataStructureType::INTERVAL_TREE:
+                    runIntervalTreeMode(window, font);
+                    break;
+                case DataStructureType::KD_TREE:
+                    runKdTreeMode(window, font);
+                    break;
+                case DataStructureType::FILTERS:
+                    runFilterMode(window, font);
+                    break;
+                case DataStructureType::SKETCHES:
+                    runSketchMode(window, font);
+                    break;
+                case DataStructureType::SCAPEGOAT:
+                    runScapegoatMode(window, font);
+                    break;
+                case DataStructureType::ROPE:
+                    runRopeMode(window, font);
+                    break;
+                case DataStructureType::SLIDING_WINDOW:
+                    runWindowMode(window, font);
+                    break;
+                case DataStructureType::EXTERNAL_SORT:
+                    runExternalSortMode(window, font);
+                    break;
+                case DataStructureType::TOP_K:
+                    runTopKMode(window, font);
+                    break;
+                case DataStructureType::UNROLLED_LIST:
+                    runUnrolledListMode(window, font);
+                    break;
+                case DataStructureType::CONCURRENT_AVL:
+                    runConcurrentAVLMode(window, font);
+                    break;
+                case DataStructureType::KEYED_TREE:
+                    runKeyedTreeMode(window, font);
+                    break;
                 default:
                     break;
             }
@@ -248,6 +454,13 @@ bool exportVisualizationToPNG(sf::RenderWindow& window, const std::string& filen
     // Create a cropped image of just the visualization area
     sf::Image cropped;
     cropped.create(static_cast<unsigned int>(areaW), static_cast<unsigned int>(areaH));
+
+    // sf::Image keeps its pixels in its own storage, out of reach of the
+    // tracking allocators, so both are counted by size (RGBA) instead
+    size_t screenshotBytes = static_cast<size_t>(screenshot.getSize().x) * screenshot.getSize().y * 4;
+    size_t croppedBytes = static_cast<size_t>(cropped.getSize().x) * cropped.getSize().y * 4;
+    MemoryAccount::allocated(MemoryAccount::EXPORT_BUFFERS, screenshotBytes);
+    MemoryAccount::allocated(MemoryAccount::EXPORT_BUFFERS, croppedBytes);
     
     for (unsigned int x = 0; x < static_cast<unsigned int>(areaW); x++) {
         for (unsigned int y = 0; y < static_cast<unsigned int>(areaH); y++) {
@@ -259,7 +472,324 @@ bool exportVisualizationToPNG(sf::RenderWindow& window, const std::string& filen
         }
     }
     
-    return cropped.saveToFile(filename);
+    bool saved = cropped.saveToFile(filename);
+    MemoryAccount::released(MemoryAccount::EXPORT_BUFFERS, screenshotBytes);
+    MemoryAccount::released(MemoryAccount::EXPORT_BUFFERS, croppedBytes);
+    return saved;
+}
+
+bool exportStructureFiles(StructureAdapter& adapter) {
+    std::string error;
+    for (ExportFormat format : {ExportFormat::DOT, ExportFormat::JSON}) {
+        std::string file = StructureExporter::defaultFileName(adapter.kind(), format);
+        if (!StructureExporter::exportStructure(adapter, format, file, error)) {
+            std::cerr << "Export failed: " << error << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// MEMORY HUD
+// Live MemoryAccount counters in the top-right corner of the tree area, and
+// the AllocationTracker numbers of the previous frame
+// ============================================================================
+void drawMemoryHud(sf::RenderWindow& window, sf::Font& font) {
+    // F3 is polled here so the modes' event loops stay untouched
+    static bool visible = false;
+    static bool keyWasDown = false;
+    bool keyDown = window.hasFocus() && sf::Keyboard::isKeyPressed(sf::Keyboard::F3);
+    if (keyDown && !keyWasDown) {
+        visible = !visible;
+    }
+    keyWasDown = keyDown;
+    if (!visible) {
+        return;
+    }
+
+    // Drawing the numbers allocates; keep that out of the frame counts
+    AllocationTracker::Ignore ignore;
+    const bool tracking = AllocationTracker::enabled();
+
+    const float width = 250.0f;
+    const float lineHeight = 16.0f;
+    const float x = Config::WINDOW_WIDTH - width - 25.0f;
+    const float y = Config::TREE_AREA_Y + 5.0f;
+    const int lines = MemoryAccount::CATEGORY_COUNT + 2 + (tracking ? 4 : 0);
+
+    sf::RectangleShape panel(sf::Vector2f(width, lineHeight * lines + 10.0f));
+    panel.setPosition(x, y);
+    panel.setFillColor(sf::Color(20, 20, 30, 220));
+    panel.setOutlineColor(Config::NODE_DEFAULT_OUTLINE);
+    panel.setOutlineThickness(1.0f);
+    window.draw(panel);
+
+    sf::Text text("", font, Config::LABEL_FONT_SIZE);
+    float lineY = y + 5.0f;
+    auto drawLine = [&](const std::string& label, const std::string& value, const sf::Color& color) {
+        text.setFillColor(color);
+        text.setString(label);
+        text.setPosition(x + 8.0f, lineY);
+        window.draw(text);
+        text.setString(value);
+        text.setPosition(x + width - 8.0f - text.getLocalBounds().width, lineY);
+        window.draw(text);
+        lineY += lineHeight;
+    };
+
+    drawLine("Memory (F3)", "live / allocs", Config::NODE_HIGHLIGHT_FILL);
+    for (int c = 0; c < MemoryAccount::CATEGORY_COUNT; c++) {
+        MemoryAccount::Category category = static_cast<MemoryAccount::Category>(c);
+        drawLine(MemoryAccount::name(category),
+                 MemoryAccount::formatBytes(MemoryAccount::bytes(category)) + " / " +
+                     std::to_string(MemoryAccount::blocks(category)),
+                 Config::TEXT_COLOR);
+    }
+    drawLine("total", MemoryAccount::formatBytes(MemoryAccount::totalBytes()), Config::NODE_FOUND_FILL);
+
+    if (tracking) {
+        const AllocationTracker::FrameStats& frame = AllocationTracker::lastFrame();
+        drawLine("Allocations this frame",
+                 std::to_string(frame.totalAllocations()) + " (" + MemoryAccount::formatBytes(frame.totalBytes()) + ")",
+                 frame.totalAllocations() == 0 ? Config::NODE_FOUND_FILL : Config::NODE_HIGHLIGHT_FILL);
+        drawLine("events / update / draw",
+                 std::to_string(frame.allocations[AllocationTracker::EVENTS]) + " / " +
+                     std::to_string(frame.allocations[AllocationTracker::UPDATE]) + " / " +
+                     std::to_string(frame.allocations[AllocationTracker::DRAW]),
+                 Config::TEXT_COLOR);
+        drawLine("frames without any", std::to_string(AllocationTracker::quietFrames()), Config::TEXT_COLOR);
+        const AllocationTracker::OperationStats* operation = AllocationTracker::lastOperation();
+        drawLine(operation ? operation->name : "last operation",
+                 operation ? std::to_string(operation->lastAllocations) + " allocs, " +
+                                 MemoryAccount::formatBytes(operation->lastBytes)
+                           : "-",
+                 Config::TEXT_COLOR);
+    }
+}
+
+// ============================================================================
+// SHAPE HUD
+// Charts the tree's ShapeStats in the top-left corner of the tree area. The
+// numbers are kept up to date by the tree itself, so this costs O(height)
+// per frame whatever the tree size.
+// ============================================================================
+void drawShapeHud(sf::RenderWindow& window, sf::Font& font, const ShapeStats& shape) {
+    static bool visible = false;
+    static bool keyWasDown = false;
+    bool keyDown = window.hasFocus() && sf::Keyboard::isKeyPressed(sf::Keyboard::F4);
+    if (keyDown && !keyWasDown) {
+        visible = !visible;
+    }
+    keyWasDown = keyDown;
+    if (!visible) {
+        return;
+    }
+
+    AllocationTracker::Ignore ignore;
+
+    const float width = 250.0f;
+    const float lineHeight = 16.0f;
+    const float chartHeight = 60.0f;
+    const float x = Config::TREE_AREA_X + 5.0f;
+    const float y = Config::TREE_AREA_Y + 5.0f;
+
+    sf::RectangleShape panel(sf::Vector2f(width, lineHeight * 6 + chartHeight * 2 + 20.0f));
+    panel.setPosition(x, y);
+    panel.setFillColor(sf::Color(20, 20, 30, 220));
+    panel.setOutlineColor(Config::NODE_DEFAULT_OUTLINE);
+    panel.setOutlineThickness(1.0f);
+    window.draw(panel);
+
+    sf::Text text("", font, Config::LABEL_FONT_SIZE);
+    float lineY = y + 5.0f;
+    auto drawLine = [&](const std::string& label, const std::string& value, const sf::Color& color) {
+        text.setFillColor(color);
+        text.setString(label);
+        text.setPosition(x + 8.0f, lineY);
+        window.draw(text);
+        text.setString(value);
+        text.setPosition(x + width - 8.0f - text.getLocalBounds().width, lineY);
+        window.draw(text);
+        lineY += lineHeight;
+    };
+
+    // Bars scaled to the largest count; 'barColor' returns each bar's color
+    sf::RectangleShape bar;
+    auto drawBars = [&](int count, const std::function<size_t(int)>& valueAt,
+                        const std::function<sf::Color(int)>& barColor) {
+        size_t largest = 1;
+        for (int i = 0; i < count; i++) {
+            largest = std::max(largest, valueAt(i));
+        }
+        float slot = (width - 16.0f) / std::max(count, 1);
+        for (int i = 0; i < count; i++) {
+            float h = chartHeight * static_cast<float>(valueAt(i)) / static_cast<float>(largest);
+            bar.setSize(sf::Vector2f(std::max(slot - 1.0f, 1.0f), h));
+            bar.setPosition(x + 8.0f + slot * i, lineY + chartHeight - h);
+            bar.setFillColor(barColor(i));
+            window.draw(bar);
+        }
+        lineY += chartHeight + 4.0f;
+    };
+
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(2) << shape.averageDepth();
+    drawLine("Shape (F4)", std::to_string(shape.size()) + " nodes, " +
+                               std::to_string(shape.leafCount()) + " leaves",
+             Config::NODE_HIGHLIGHT_FILL);
+    drawLine("height / avg depth", std::to_string(shape.height()) + " / " + ss.str(), Config::TEXT_COLOR);
+    drawLine("path length (complete)", std::to_string(shape.internalPathLength()) + " (" +
+                                           std::to_string(ShapeStats::minimumPathLength(shape.size())) + ")",
+             Config::TEXT_COLOR);
+
+    // Nodes per depth; a complete tree doubles from one level to the next,
+    // so levels that are full are drawn in the "found" color
+    drawLine("nodes per depth", "0 .. " + std::to_string(std::max(shape.height() - 1, 0)), Config::TEXT_COLOR);
+    drawBars(shape.height(),
+             [&shape](int depth) { return shape.depthCount(depth); },
+             [&shape](int depth) {
+                 return depth < 31 && shape.depthCount(depth) == (size_t(1) << depth)
+                     ? Config::NODE_FOUND_FILL : Config::NODE_DEFAULT_FILL;
+             });
+
+    // Balance factors; AVL allows -1 .. +1, anything outside is highlighted
+    drawLine("balance factors", std::string(ShapeStats::bucketLabel(0)) + " .. " +
+                                    ShapeStats::bucketLabel(ShapeStats::BALANCE_BUCKETS - 1),
+             Config::TEXT_COLOR);
+    drawBars(ShapeStats::BALANCE_BUCKETS,
+             [&shape](int bucket) { return shape.balanceCount(bucket); },
+             [](int bucket) {
+                 int balance = bucket - 3;
+                 return balance >= -1 && balance <= 1 ? Config::NODE_FOUND_FILL : Config::NODE_HIGHLIGHT_FILL;
+             });
+    std::string counts;
+    for (int b = 0; b < ShapeStats::BALANCE_BUCKETS; b++) {
+        counts += (b ? " " : "") + std::to_string(shape.balanceCount(b));
+    }
+    drawLine("", counts, Config::TEXT_COLOR);
+}
+
+// ============================================================================
+// INVARIANT HUD
+// Showing it runs a full check of the mode's structure (in parallel when it
+// is large). After that every frame checks a sample of at most
+// InvariantSampler::budget() nodes, so whatever the size an operation that
+// breaks an invariant shows up within a few frames.
+// ============================================================================
+void drawInvariantHud(sf::RenderWindow& window, sf::Font& font, StructureAdapter& adapter,
+                      InvariantHudState& state) {
+    static bool visible = false;
+    static bool keyWasDown = false;
+    bool keyDown = window.hasFocus() && sf::Keyboard::isKeyPressed(sf::Keyboard::F5);
+    if (keyDown && !keyWasDown) {
+        visible = !visible;
+        state.checked = false;
+    }
+    keyWasDown = keyDown;
+    if (!visible) {
+        return;
+    }
+
+    // The checks and the text allocate; keep that out of the frame counts
+    AllocationTracker::Ignore ignore;
+
+    if (!state.checked) {
+        state.full = adapter.checkInvariants();
+        state.sampleFailure = InvariantReport();
+        state.sampledNodes = 0;
+        state.sampledFrames = 0;
+        state.checked = true;
+    }
+    InvariantReport frame = adapter.sampleInvariants(state.sampler);
+    state.sampledNodes += frame.nodesChecked;
+    state.sampledFrames++;
+    if (!frame.valid && state.sampleFailure.valid) {
+        state.sampleFailure = frame;
+    }
+    const InvariantReport& full = state.full;
+    const InvariantReport& sampleFailure = state.sampleFailure;
+
+    const float width = 300.0f;
+    const float lineHeight = 16.0f;
+    const float x = Config::WINDOW_WIDTH - width - 250.0f - 35.0f;
+    const float y = Config::TREE_AREA_Y + 5.0f;
+
+    sf::RectangleShape panel(sf::Vector2f(width, lineHeight * 6 + 10.0f));
+    panel.setPosition(x, y);
+    panel.setFillColor(sf::Color(20, 20, 30, 220));
+    panel.setOutlineColor(Config::NODE_DEFAULT_OUTLINE);
+    panel.setOutlineThickness(1.0f);
+    window.draw(panel);
+
+    sf::Text text("", font, Config::LABEL_FONT_SIZE);
+    float lineY = y + 5.0f;
+    auto drawLine = [&](const std::string& label, const std::string& value, const sf::Color& color) {
+        text.setFillColor(color);
+        text.setString(label);
+        text.setPosition(x + 8.0f, lineY);
+        window.draw(text);
+        text.setString(value);
+        text.setPosition(x + width - 8.0f - text.getLocalBounds().width, lineY);
+        window.draw(text);
+        lineY += lineHeight;
+    };
+    // Problems are long; they get a line of their own, cut to fit
+    auto problem = [](const InvariantReport& report) {
+        const size_t MAX_CHARS = 46;
+        return report.error.size() > MAX_CHARS ? report.error.substr(0, MAX_CHARS - 3) + "..." : report.error;
+    };
+
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1) << full.elapsedMs;
+    drawLine("Invariants (F5)", adapter.name(), Config::NODE_HIGHLIGHT_FILL);
+    drawLine("full check", full.valid ? std::to_string(full.nodesChecked) + " nodes, " + ss.str() + " ms"
+                                      : "INVALID",
+             full.valid ? Config::NODE_FOUND_FILL : Config::NODE_DELETE_FILL);
+    drawLine(full.valid ? "" : problem(full), "", Config::NODE_DELETE_FILL);
+    drawLine("sampled this frame", std::to_string(frame.nodesChecked) + " of " +
+                                       std::to_string(state.sampler.budget()) + " nodes",
+             Config::TEXT_COLOR);
+    drawLine("sampled since shown", std::to_string(state.sampledNodes) + " nodes, " +
+                                        std::to_string(state.sampledFrames) + " frames",
+             Config::TEXT_COLOR);
+    drawLine(sampleFailure.valid ? "no sample found a problem" : problem(sampleFailure), "",
+             sampleFailure.valid ? Config::NODE_FOUND_FILL : Config::NODE_DELETE_FILL);
+}
+
+// ============================================================================
+// CONSOLE HELPERS
+// The console runs a whole command as one batch; the mode redraws once after
+// ============================================================================
+void attachConsole(ConsolePanel& console, CommandInterpreter& interpreter) {
+    interpreter.setOutput([&console](const std::string& message, bool isError) {
+        console.print(message, isError);
+    });
+    console.print("Type 'help' for commands. F1 / ~ toggles the console.");
+}
+
+bool runConsoleCommand(ConsolePanel& console, CommandInterpreter& interpreter) {
+    std::string command;
+    if (!console.takeCommand(command)) return false;
+    interpreter.run(command);
+    return true;
+}
+
+bool applyControlCommands(StructureAdapter& adapter, sf::RenderWindow& window) {
+    if (controlServer == nullptr) return false;
+    
+    // Frames naming another structure fail; only the open mode is available
+    StructureAdapter* active = &adapter;
+    ControlServer::SelectFn select = [&adapter](StructureKind kind) {
+        return kind == adapter.kind() ? &adapter : nullptr;
+    };
+    
+    // A few ms per frame keeps 60 FPS; the rest stays queued for later frames
+    bool changed = controlServer->applyPending(active, select, 4.0) > 0;
+    if (controlServer->shutdownRequested()) {
+        window.close();
+    }
+    return changed;
 }
 
 // ============================================================================
@@ -271,9 +801,22 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font) {
     BST bst;
     Visualizer visualizer(&bst, &font);
     
+    // Session journal: restores the last session and records every change
+    BSTAdapter adapter(bst);
+    InvariantHudState invariantHud;
+    SessionJournal journal("bst", adapter);
+    JournaledAdapter journaled(adapter, journal);
+    
+    // Command console operating on the same structure
+    CommandInterpreter interpreter(journaled);
+    ConsolePanel console(Config::TREE_AREA_X, Config::WINDOW_HEIGHT - 230,
+                         Config::TREE_AREA_WIDTH, 220, font);
+    attachConsole(console, interpreter);
+    
     // GUI Layout
     float panelX = Config::CONTROL_PANEL_PADDING;
     float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
+    float halfWidth = (controlWidth - 10) / 2;
     float buttonHeight = 32.0f;
     float spacing = 8.0f;
     float currentY = Config::CONTROL_PANEL_PADDING;
@@ -291,13 +834,14 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font) {
     // Input label and field
     sf::Text inputLabel;
     inputLabel.setFont(font);
-    inputLabel.setString("Enter value:");
+    inputLabel.setString("Enter value:       Second (LCA):");
     inputLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
     inputLabel.setFillColor(Config::TEXT_SECONDARY);
     inputLabel.setPosition(panelX, currentY);
     currentY += 18;
     
-    TextInput valueInput(panelX, currentY, controlWidth, 32, "Integer...", font, true);
+    TextInput valueInput(panelX, currentY, halfWidth, 32, "Integer...", font, true);
+    TextInput secondInput(panelX + halfWidth + 10, currentY, halfWidth, 32, "Integer...", font, true);
     currentY += 40;
     
     // Operation buttons
@@ -310,6 +854,9 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font) {
     Button searchBtn(panelX, currentY, controlWidth, buttonHeight, "Search", font);
     currentY += buttonHeight + spacing;
     
+    Button lcaBtn(panelX, currentY, controlWidth, buttonHeight, "Lowest Common Ancestor", font);
+    currentY += buttonHeight + spacing;
+    
     Button clearBtn(panelX, currentY, controlWidth, buttonHeight, "Clear All", font);
     currentY += buttonHeight + spacing + 10;
     
@@ -352,10 +899,18 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font) {
     controlPanel.setSize(sf::Vector2f(Config::CONTROL_PANEL_WIDTH, Config::WINDOW_HEIGHT));
     controlPanel.setFillColor(Config::CONTROL_PANEL_COLOR);
     
+    // Bring back the previous session (also after a crash)
+    size_t restored = journal.restore();
+    if (restored > 0) {
+        visualizer.refresh();
+        messageBox.show("Restored " + std::to_string(restored) + " values from last session", MessageBox::INFO, 3.0f);
+    }
+    
     sf::Clock clock;
     bool running = true;
     
     while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
         float deltaTime = clock.restart().asSeconds();
         visualizer.setSpeed(speedSlider.getValue());
         
@@ -364,6 +919,7 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font) {
         insertBtn.setEnabled(canInteract);
         deleteBtn.setEnabled(canInteract);
         searchBtn.setEnabled(canInteract);
+        lcaBtn.setEnabled(canInteract);
         clearBtn.setEnabled(canInteract);
         exportBtn.setEnabled(canInteract);
         
@@ -374,11 +930,15 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font) {
                 running = false;
             }
             
+            // Keys typed into the console (including Escape) stay there
+            if (console.handleEvent(event)) continue;
+            
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
                 running = false;
             }
             
             valueInput.handleEvent(event, window);
+            secondInput.handleEvent(event, window);
             speedSlider.handleEvent(event, window);
             
             if (backBtn.handleEvent(event, window)) {
@@ -398,6 +958,7 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font) {
                     std::vector<Node*> path;
                     bool success = bst.insert(value, path);
                     if (success) {
+                        journal.record(SessionJournal::OP_INSERT, value);
                         visualizer.animateInsert(path, path.empty() ? nullptr : path.back());
                         messageBox.show("Inserted: " + std::to_string(value), MessageBox::SUCCESS, 2.0f);
                     } else {
@@ -422,6 +983,7 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font) {
                     Node* deletedNode = nullptr;
                     Node* successor = nullptr;
                     if (bst.remove(value, path, deletedNode, successor)) {
+                        journal.record(SessionJournal::OP_REMOVE, value);
                         visualizer.animateDelete(path, deletedNode, successor);
                         messageBox.show("Deleted: " + std::to_string(value), MessageBox::SUCCESS, 2.0f);
                     } else {
@@ -454,11 +1016,40 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font) {
                 }
             }
             
+            // LOWEST COMMON ANCESTOR of the two values
+            if (lcaBtn.handleEvent(event, window)) {
+                int first, second;
+                if (valueInput.isEmpty() || secondInput.isEmpty()) {
+                    messageBox.show("Error: Enter both values!", MessageBox::ERROR_MSG, 3.0f);
+                }
+                else if (!valueInput.getAsInt(first) || !secondInput.getAsInt(second)) {
+                    messageBox.show("Error: Invalid integer!", MessageBox::ERROR_MSG, 3.0f);
+                }
+                else {
+                    std::vector<Node*> pathA, pathB;
+                    Node* nodeA = bst.search(first, pathA);
+                    Node* nodeB = bst.search(second, pathB);
+                    if (!nodeA || !nodeB) {
+                        visualizer.animateNotFound(nodeA ? pathB : pathA);
+                        messageBox.show(std::to_string(nodeA ? second : first) + " not found.",
+                                        MessageBox::ERROR_MSG, 3.0f);
+                    } else {
+                        Node* ancestor = bst.lowestCommonAncestor(nodeA, nodeB);
+                        visualizer.animateLCA(pathA, pathB, ancestor);
+                        messageBox.show("LCA(" + std::to_string(first) + ", " + std::to_string(second) +
+                                        ") = " + std::to_string(ancestor->value), MessageBox::SUCCESS, 3.0f);
+                    }
+                    valueInput.clear();
+                    secondInput.clear();
+                }
+            }
+            
             // CLEAR operation
             if (clearBtn.handleEvent(event, window)) {
                 if (!bst.isEmpty()) {
                     visualizer.animateClear();
                     bst.clear();
+                    journal.record(SessionJournal::OP_CLEAR);
                     messageBox.show("Tree cleared!", MessageBox::INFO, 2.0f);
                 } else {
                     messageBox.show("Tree is already empty.", MessageBox::INFO, 2.0f);
@@ -470,8 +1061,8 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font) {
                 if (bst.isEmpty()) {
                     messageBox.show("Cannot export empty tree!", MessageBox::ERROR_MSG, 2.0f);
                 } else {
-                    if (visualizer.exportToPNG("bst_export.png")) {
-                        messageBox.show("Exported to bst_export.png", MessageBox::SUCCESS, 3.0f);
+                    if (visualizer.exportToPNG("bst_export.png") && exportStructureFiles(adapter)) {
+                        messageBox.show("Exported bst_export .png/.dot/.json", MessageBox::SUCCESS, 3.0f);
                     } else {
                         messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
                     }
@@ -480,12 +1071,27 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font) {
         }
         
         // Update
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        // Run a submitted console command, then animate the result once
+        if (canInteract && runConsoleCommand(console, interpreter)) {
+            visualizer.animateBatch();
+        }
+        
+        // Apply operations streamed in over the control socket
+        if (canInteract && applyControlCommands(journaled, window)) {
+            visualizer.animateBatch();
+        }
+        journal.sync();
+        
         valueInput.update(deltaTime);
+        secondInput.update(deltaTime);
+        console.update(deltaTime);
         visualizer.update(deltaTime);
         messageBox.update(deltaTime);
         traversalText.setString(visualizer.getInorderString());
         
         // Draw
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
         window.clear(Config::BACKGROUND_COLOR);
         window.draw(controlPanel);
         window.draw(titleText);
@@ -493,14 +1099,20 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font) {
         window.draw(traversalLabel);
         window.draw(traversalText);
         valueInput.draw(window);
+        secondInput.draw(window);
         insertBtn.draw(window);
         deleteBtn.draw(window);
         searchBtn.draw(window);
+        lcaBtn.draw(window);
         clearBtn.draw(window);
         speedSlider.draw(window);
         exportBtn.draw(window);
         backBtn.draw(window);
         visualizer.draw(window);
+        console.draw(window);
+        drawShapeHud(window, font, bst.getShapeStats());
+        drawInvariantHud(window, font, adapter, invariantHud);
+        drawMemoryHud(window, font);
         messageBox.draw(window);
         window.display();
     }
@@ -513,6 +1125,18 @@ void runBSTMode(sf::RenderWindow& window, sf::Font& font) {
 void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
     LinkedList list;
     
+    // Session journal: restores the last session and records every change
+    LinkedListAdapter adapter(list);
+    InvariantHudState invariantHud;
+    SessionJournal journal("list", adapter);
+    JournaledAdapter journaled(adapter, journal);
+    
+    // Command console operating on the same structure
+    CommandInterpreter interpreter(journaled);
+    ConsolePanel console(Config::TREE_AREA_X, Config::WINDOW_HEIGHT - 230,
+                         Config::TREE_AREA_WIDTH, 220, font);
+    attachConsole(console, interpreter);
+    
     // GUI Layout
     float panelX = Config::CONTROL_PANEL_PADDING;
     float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
@@ -546,6 +1170,12 @@ void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
     Button insertTailBtn(panelX, currentY, controlWidth, buttonHeight, "Insert at Tail", font);
     currentY += buttonHeight + spacing;
     
+    // The append itself is O(1) through the tail pointer; the head-to-tail
+    // walk is only generated when this is on
+    Button walkBtn(panelX, currentY, controlWidth, buttonHeight, "Show Tail Walk: Off", font);
+    currentY += buttonHeight + spacing;
+    bool showTailWalk = false;
+    
     Button deleteBtn(panelX, currentY, controlWidth, buttonHeight, "Delete", font);
     currentY += buttonHeight + spacing;
     
@@ -598,10 +1228,17 @@ void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
     bool isAnimating = false;
     ListNode* foundNode = nullptr;
     
+    // Bring back the previous session (also after a crash)
+    size_t restored = journal.restore();
+    if (restored > 0) {
+        messageBox.show("Restored " + std::to_string(restored) + " values from last session", MessageBox::INFO, 3.0f);
+    }
+    
     sf::Clock clock;
     bool running = true;
     
     while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
         float deltaTime = clock.restart().asSeconds();
         animSpeed = speedSlider.getValue();
         
@@ -632,6 +1269,9 @@ void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
                 running = false;
             }
             
+            // Keys typed into the console (including Escape) stay there
+            if (console.handleEvent(event)) continue;
+            
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
                 running = false;
             }
@@ -646,6 +1286,7 @@ void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
                 if (!valueInput.isEmpty() && valueInput.getAsInt(value)) {
                     highlightPath.clear();
                     list.insertAtHead(value, highlightPath);
+                    journal.record(SessionJournal::OP_INSERT_HEAD, value);
                     highlightIndex = 0;
                     highlightTimer = 0;
                     isAnimating = true;
@@ -662,6 +1303,11 @@ void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
                 if (!valueInput.isEmpty() && valueInput.getAsInt(value)) {
                     highlightPath.clear();
                     list.insertAtTail(value, highlightPath);
+                    if (showTailWalk) {
+                        highlightPath.clear();
+                        list.traversalTo(list.getTail(), highlightPath);
+                    }
+                    journal.record(SessionJournal::OP_INSERT, value);
                     highlightIndex = 0;
                     highlightTimer = 0;
                     isAnimating = true;
@@ -673,12 +1319,18 @@ void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
                 }
             }
             
+            if (walkBtn.handleEvent(event, window)) {
+                showTailWalk = !showTailWalk;
+                walkBtn.setText(showTailWalk ? "Show Tail Walk: On" : "Show Tail Walk: Off");
+            }
+            
             if (deleteBtn.handleEvent(event, window) && canInteract) {
                 int value;
                 if (!valueInput.isEmpty() && valueInput.getAsInt(value)) {
                     highlightPath.clear();
                     ListNode* deleted = nullptr;
                     if (list.remove(value, highlightPath, deleted)) {
+                        journal.record(SessionJournal::OP_REMOVE, value);
                         highlightIndex = 0;
                         highlightTimer = 0;
                         isAnimating = true;
@@ -719,6 +1371,7 @@ void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
             
             if (clearBtn.handleEvent(event, window)) {
                 list.clear();
+                journal.record(SessionJournal::OP_CLEAR);
                 highlightPath.clear();
                 isAnimating = false;
                 messageBox.show("List cleared!", MessageBox::INFO, 2.0f);
@@ -733,8 +1386,9 @@ void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
                     window.display();
                     if (exportVisualizationToPNG(window, "linkedlist_export.png", 
                                                   Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
-                                                  Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
-                        messageBox.show("Exported to linkedlist_export.png", MessageBox::SUCCESS, 3.0f);
+                                                  Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50) &&
+                        exportStructureFiles(adapter)) {
+                        messageBox.show("Exported linkedlist_export .png/.dot/.json", MessageBox::SUCCESS, 3.0f);
                     } else {
                         messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
                     }
@@ -742,11 +1396,21 @@ void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
             }
         }
         
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        // Run console / control socket commands (drawn from the structure below)
+        if (canInteract) {
+            runConsoleCommand(console, interpreter);
+            applyControlCommands(journaled, window);
+        }
+        journal.sync();
+        
         valueInput.update(deltaTime);
+        console.update(deltaTime);
         messageBox.update(deltaTime);
         contentText.setString(list.toString());
         
         // Drawing
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
         window.clear(Config::BACKGROUND_COLOR);
         window.draw(controlPanel);
         window.draw(titleText);
@@ -756,6 +1420,7 @@ void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
         valueInput.draw(window);
         insertHeadBtn.draw(window);
         insertTailBtn.draw(window);
+        walkBtn.draw(window);
         deleteBtn.draw(window);
         searchBtn.draw(window);
         clearBtn.draw(window);
@@ -793,8 +1458,12 @@ void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
             sf::Color fillColor = Config::LINKEDLIST_COLOR;
             sf::Color outlineColor = Config::LINKEDLIST_OUTLINE;
             
-            if (isAnimating && (int)i <= highlightIndex) {
-                if (nodes[i] == foundNode && (int)i == highlightIndex) {
+            // Highlight the nodes of the path shown so far (a path need not
+            // start at the head, e.g. a tail append without the walk)
+            int shown = std::min(highlightIndex + 1, (int)highlightPath.size());
+            if (isAnimating && std::find(highlightPath.begin(), highlightPath.begin() + shown, nodes[i]) !=
+                                   highlightPath.begin() + shown) {
+                if (nodes[i] == foundNode && highlightPath[shown - 1] == nodes[i]) {
                     fillColor = Config::NODE_FOUND_FILL;
                     outlineColor = Config::NODE_FOUND_OUTLINE;
                 } else {
@@ -870,6 +1539,9 @@ void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
             window.draw(emptyText);
         }
         
+        console.draw(window);
+        drawInvariantHud(window, font, adapter, invariantHud);
+        drawMemoryHud(window, font);
         messageBox.draw(window);
         window.display();
     }
@@ -882,6 +1554,18 @@ void runLinkedListMode(sf::RenderWindow& window, sf::Font& font) {
 void runStackMode(sf::RenderWindow& window, sf::Font& font) {
     Stack stack;
     
+    // Session journal: restores the last session and records every change
+    StackAdapter adapter(stack);
+    InvariantHudState invariantHud;
+    SessionJournal journal("stack", adapter);
+    JournaledAdapter journaled(adapter, journal);
+    
+    // Command console operating on the same structure
+    CommandInterpreter interpreter(journaled);
+    ConsolePanel console(Config::TREE_AREA_X, Config::WINDOW_HEIGHT - 230,
+                         Config::TREE_AREA_WIDTH, 220, font);
+    attachConsole(console, interpreter);
+    
     float panelX = Config::CONTROL_PANEL_PADDING;
     float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
     float buttonHeight = 32.0f;
@@ -963,10 +1647,17 @@ void runStackMode(sf::RenderWindow& window, sf::Font& font) {
     float animSpeed = 1.0f;
     bool isAnimating = false;
     
+    // Bring back the previous session (also after a crash)
+    size_t restored = journal.restore();
+    if (restored > 0) {
+        messageBox.show("Restored " + std::to_string(restored) + " values from last session", MessageBox::INFO, 3.0f);
+    }
+    
     sf::Clock clock;
     bool running = true;
     
     while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
         float deltaTime = clock.restart().asSeconds();
         animSpeed = speedSlider.getValue();
         
@@ -993,6 +1684,9 @@ void runStackMode(sf::RenderWindow& window, sf::Font& font) {
                 running = false;
             }
             
+            // Keys typed into the console (including Escape) stay there
+            if (console.handleEvent(event)) continue;
+            
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
                 running = false;
             }
@@ -1006,6 +1700,7 @@ void runStackMode(sf::RenderWindow& window, sf::Font& font) {
                 int value;
                 if (!valueInput.isEmpty() && valueInput.getAsInt(value)) {
                     stack.push(value);
+                    journal.record(SessionJournal::OP_INSERT, value);
                     highlightIndex = stack.getSize() - 1;
                     highlightTimer = 0;
                     isAnimating = true;
@@ -1019,6 +1714,7 @@ void runStackMode(sf::RenderWindow& window, sf::Font& font) {
             if (popBtn.handleEvent(event, window) && canInteract) {
                 StackNode* popped = stack.pop();
                 if (popped) {
+                    journal.record(SessionJournal::OP_POP);
                     messageBox.show("Popped: " + std::to_string(popped->value), MessageBox::SUCCESS, 2.0f);
                     delete popped;
                 } else {
@@ -1065,6 +1761,7 @@ void runStackMode(sf::RenderWindow& window, sf::Font& font) {
             
             if (clearBtn.handleEvent(event, window)) {
                 stack.clear();
+                journal.record(SessionJournal::OP_CLEAR);
                 isAnimating = false;
                 highlightIndex = -1;
                 messageBox.show("Stack cleared!", MessageBox::INFO, 2.0f);
@@ -1078,8 +1775,9 @@ void runStackMode(sf::RenderWindow& window, sf::Font& font) {
                     window.display();
                     if (exportVisualizationToPNG(window, "stack_export.png", 
                                                   Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
-                                                  Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
-                        messageBox.show("Exported to stack_export.png", MessageBox::SUCCESS, 3.0f);
+                                                  Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50) &&
+                        exportStructureFiles(adapter)) {
+                        messageBox.show("Exported stack_export .png/.dot/.json", MessageBox::SUCCESS, 3.0f);
                     } else {
                         messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
                     }
@@ -1087,10 +1785,20 @@ void runStackMode(sf::RenderWindow& window, sf::Font& font) {
             }
         }
         
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        // Run console / control socket commands (drawn from the structure below)
+        if (canInteract) {
+            runConsoleCommand(console, interpreter);
+            applyControlCommands(journaled, window);
+        }
+        journal.sync();
+        
         valueInput.update(deltaTime);
+        console.update(deltaTime);
         messageBox.update(deltaTime);
         contentText.setString(stack.toString());
         
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
         window.clear(Config::BACKGROUND_COLOR);
         window.draw(controlPanel);
         window.draw(titleText);
@@ -1190,6 +1898,9 @@ void runStackMode(sf::RenderWindow& window, sf::Font& font) {
             window.draw(emptyText);
         }
         
+        console.draw(window);
+        drawInvariantHud(window, font, adapter, invariantHud);
+        drawMemoryHud(window, font);
         messageBox.draw(window);
         window.display();
     }
@@ -1202,6 +1913,18 @@ void runStackMode(sf::RenderWindow& window, sf::Font& font) {
 void runQueueMode(sf::RenderWindow& window, sf::Font& font) {
     Queue queue;
     
+    // Session journal: restores the last session and records every change
+    QueueAdapter adapter(queue);
+    InvariantHudState invariantHud;
+    SessionJournal journal("queue", adapter);
+    JournaledAdapter journaled(adapter, journal);
+    
+    // Command console operating on the same structure
+    CommandInterpreter interpreter(journaled);
+    ConsolePanel console(Config::TREE_AREA_X, Config::WINDOW_HEIGHT - 230,
+                         Config::TREE_AREA_WIDTH, 220, font);
+    attachConsole(console, interpreter);
+    
     float panelX = Config::CONTROL_PANEL_PADDING;
     float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
     float buttonHeight = 32.0f;
@@ -1283,10 +2006,17 @@ void runQueueMode(sf::RenderWindow& window, sf::Font& font) {
     float animSpeed = 1.0f;
     bool isAnimating = false;
     
+    // Bring back the previous session (also after a crash)
+    size_t restored = journal.restore();
+    if (restored > 0) {
+        messageBox.show("Restored " + std::to_string(restored) + " values from last session", MessageBox::INFO, 3.0f);
+    }
+    
     sf::Clock clock;
     bool running = true;
     
     while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
         float deltaTime = clock.restart().asSeconds();
         animSpeed = speedSlider.getValue();
         
@@ -1313,6 +2043,9 @@ void runQueueMode(sf::RenderWindow& window, sf::Font& font) {
                 running = false;
             }
             
+            // Keys typed into the console (including Escape) stay there
+            if (console.handleEvent(event)) continue;
+            
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
                 running = false;
             }
@@ -1326,6 +2059,7 @@ void runQueueMode(sf::RenderWindow& window, sf::Font& font) {
                 int value;
                 if (!valueInput.isEmpty() && valueInput.getAsInt(value)) {
                     queue.enqueue(value);
+                    journal.record(SessionJournal::OP_INSERT, value);
                     highlightIndex = queue.getSize() - 1;
                     highlightTimer = 0;
                     isAnimating = true;
@@ -1339,6 +2073,7 @@ void runQueueMode(sf::RenderWindow& window, sf::Font& font) {
             if (dequeueBtn.handleEvent(event, window) && canInteract) {
                 QueueNode* dequeued = queue.dequeue();
                 if (dequeued) {
+                    journal.record(SessionJournal::OP_POP);
                     messageBox.show("Dequeued: " + std::to_string(dequeued->value), MessageBox::SUCCESS, 2.0f);
                     delete dequeued;
                 } else {
@@ -1385,6 +2120,7 @@ void runQueueMode(sf::RenderWindow& window, sf::Font& font) {
             
             if (clearBtn.handleEvent(event, window)) {
                 queue.clear();
+                journal.record(SessionJournal::OP_CLEAR);
                 isAnimating = false;
                 highlightIndex = -1;
                 messageBox.show("Queue cleared!", MessageBox::INFO, 2.0f);
@@ -1398,8 +2134,9 @@ void runQueueMode(sf::RenderWindow& window, sf::Font& font) {
                     window.display();
                     if (exportVisualizationToPNG(window, "queue_export.png", 
                                                   Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
-                                                  Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
-                        messageBox.show("Exported to queue_export.png", MessageBox::SUCCESS, 3.0f);
+                                                  Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50) &&
+                        exportStructureFiles(adapter)) {
+                        messageBox.show("Exported queue_export .png/.dot/.json", MessageBox::SUCCESS, 3.0f);
                     } else {
                         messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
                     }
@@ -1407,10 +2144,20 @@ void runQueueMode(sf::RenderWindow& window, sf::Font& font) {
             }
         }
         
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        // Run console / control socket commands (drawn from the structure below)
+        if (canInteract) {
+            runConsoleCommand(console, interpreter);
+            applyControlCommands(journaled, window);
+        }
+        journal.sync();
+        
         valueInput.update(deltaTime);
+        console.update(deltaTime);
         messageBox.update(deltaTime);
         contentText.setString(queue.toString());
         
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
         window.clear(Config::BACKGROUND_COLOR);
         window.draw(controlPanel);
         window.draw(titleText);
@@ -1519,6 +2266,5193 @@ void runQueueMode(sf::RenderWindow& window, sf::Font& font) {
             window.draw(emptyText);
         }
         
+        console.draw(window);
+        drawInvariantHud(window, font, adapter, invariantHud);
+        drawMemoryHud(window, font);
+        messageBox.draw(window);
+        window.display();
+    }
+}
+
+// ============================================================================
+// INTERVAL TREE MODE
+// AVL tree of intervals; queries show which subtrees the max endpoint prunes
+// ============================================================================
+void runIntervalTreeMode(sf::RenderWindow& window, sf::Font& font) {
+    IntervalTree tree;
+    TreeCanvas canvas(Config::TREE_AREA_X, Config::TREE_AREA_Y,
+                      Config::TREE_AREA_WIDTH, Config::TREE_AREA_HEIGHT,
+                      "Interval Tree (node: [low,high], max endpoint below)", font);
+    
+    auto describe = [](IntervalNode* node, std::string& label, std::string& detail) {
+        label = "[" + std::to_string(node->value.low) + "," + std::to_string(node->value.high) + "]";
+        detail = "max " + std::to_string(node->maxHigh);
+    };
+    
+    // GUI Layout
+    float panelX = Config::CONTROL_PANEL_PADDING;
+    float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
+    float halfWidth = (controlWidth - 10) / 2;
+    float buttonHeight = 32.0f;
+    float spacing = 8.0f;
+    float currentY = Config::CONTROL_PANEL_PADDING;
+    
+    // Title
+    sf::Text titleText;
+    titleText.setFont(font);
+    titleText.setString("Interval Tree");
+    titleText.setCharacterSize(Config::TITLE_FONT_SIZE);
+    titleText.setFillColor(Config::TEXT_COLOR);
+    titleText.setStyle(sf::Text::Bold);
+    titleText.setPosition(panelX, currentY);
+    currentY += 30;
+    
+    // Low / high inputs side by side
+    sf::Text inputLabel;
+    inputLabel.setFont(font);
+    inputLabel.setString("Low / point:        High:");
+    inputLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    inputLabel.setFillColor(Config::TEXT_SECONDARY);
+    inputLabel.setPosition(panelX, currentY);
+    currentY += 18;
+    
+    TextInput lowInput(panelX, currentY, halfWidth, 32, "Low...", font, true);
+    TextInput highInput(panelX + halfWidth + 10, currentY, halfWidth, 32, "High...", font, true);
+    currentY += 40;
+    
+    // Operation buttons
+    Button insertBtn(panelX, currentY, controlWidth, buttonHeight, "Insert [low, high]", font);
+    currentY += buttonHeight + spacing;
+    
+    Button deleteBtn(panelX, currentY, controlWidth, buttonHeight, "Delete [low, high]", font);
+    currentY += buttonHeight + spacing;
+    
+    Button stabBtn(panelX, currentY, controlWidth, buttonHeight, "Stab (point = low)", font);
+    currentY += buttonHeight + spacing;
+    
+    Button overlapBtn(panelX, currentY, controlWidth, buttonHeight, "Overlap [low, high]", font);
+    currentY += buttonHeight + spacing;
+    
+    Button randomBtn(panelX, currentY, controlWidth, buttonHeight, "Insert 10 Random", font);
+    currentY += buttonHeight + spacing;
+    
+    Button clearBtn(panelX, currentY, controlWidth, buttonHeight, "Clear All", font);
+    currentY += buttonHeight + spacing + 10;
+    
+    // Speed slider
+    Slider speedSlider(panelX, currentY, controlWidth, 
+                       Config::MIN_ANIMATION_SPEED, Config::MAX_ANIMATION_SPEED, 
+                       Config::DEFAULT_ANIMATION_SPEED, "Animation Speed", font);
+    currentY += 45;
+    
+    // Export button
+    Button exportBtn(panelX, currentY, controlWidth, buttonHeight, "Export PNG", font);
+    currentY += buttonHeight + spacing;
+    
+    // Back button
+    Button backBtn(panelX, currentY, controlWidth, buttonHeight, "<< Back to Menu", font);
+    currentY += buttonHeight + spacing + 10;
+    
+    // Legend and last query result
+    sf::Text legendText;
+    legendText.setFont(font);
+    legendText.setString("Yellow: visited   Green: overlaps\nGray: subtree pruned (max < low,\n          or node low > high)");
+    legendText.setCharacterSize(10);
+    legendText.setFillColor(Config::TEXT_SECONDARY);
+    legendText.setPosition(panelX, currentY);
+    currentY += 48;
+    
+    sf::Text resultText;
+    resultText.setFont(font);
+    resultText.setString("");
+    resultText.setCharacterSize(10);
+    resultText.setFillColor(Config::TEXT_COLOR);
+    resultText.setPosition(panelX, currentY);
+    
+    // Message box for feedback
+    MessageBox messageBox(panelX, Config::WINDOW_HEIGHT - 55, controlWidth, font);
+    
+    // Control panel background
+    sf::RectangleShape controlPanel;
+    controlPanel.setPosition(0, 0);
+    controlPanel.setSize(sf::Vector2f(Config::CONTROL_PANEL_WIDTH, Config::WINDOW_HEIGHT));
+    controlPanel.setFillColor(Config::CONTROL_PANEL_COLOR);
+    
+    // Reads both inputs; a missing high means a point interval [low, low]
+    auto readInterval = [&](int& low, int& high, bool needHigh) {
+        if (lowInput.isEmpty() || !lowInput.getAsInt(low)) {
+            messageBox.show("Error: Enter a valid low value!", MessageBox::ERROR_MSG, 3.0f);
+            return false;
+        }
+        high = low;
+        if (needHigh && !highInput.isEmpty() && !highInput.getAsInt(high)) {
+            messageBox.show("Error: Invalid high value!", MessageBox::ERROR_MSG, 3.0f);
+            return false;
+        }
+        if (high < low) {
+            messageBox.show("Error: high must be >= low!", MessageBox::ERROR_MSG, 3.0f);
+            return false;
+        }
+        return true;
+    };
+    
+    // Animate a query trace and summarize it
+    auto showQuery = [&](const std::vector<IntervalQueryStep>& trace,
+                         const std::vector<IntervalNode*>& matches) {
+        canvas.resetColors();
+        int visited = 0, pruned = 0;
+        for (const IntervalQueryStep& step : trace) {
+            switch (step.kind) {
+                case IntervalQueryStep::VISIT:
+                    canvas.queueStep(step.nodeId, TreeCanvas::VISITED_FILL);
+                    visited++;
+                    break;
+                case IntervalQueryStep::MATCH:
+                    canvas.queueStep(step.nodeId, TreeCanvas::MATCH_FILL);
+                    break;
+                case IntervalQueryStep::PRUNED:
+                    canvas.queueStep(step.nodeId, TreeCanvas::PRUNED_FILL, true);
+                    pruned++;
+                    break;
+            }
+        }
+        
+        std::ostringstream ss;
+        ss << matches.size() << " match(es), " << visited << " of " << tree.size()
+           << " visited,\n" << pruned << " subtree(s) pruned\n";
+        for (size_t i = 0; i < matches.size() && i < 12; i++) {
+            ss << "[" << matches[i]->value.low << "," << matches[i]->value.high << "] ";
+            if (i % 3 == 2) ss << "\n";
+        }
+        if (matches.size() > 12) ss << "...";
+        resultText.setString(ss.str());
+    };
+    
+    unsigned int randomSeed = 1;
+    sf::Clock clock;
+    bool running = true;
+    
+    while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
+        float deltaTime = clock.restart().asSeconds();
+        canvas.setSpeed(speedSlider.getValue());
+        
+        // Disable buttons during animation
+        bool canInteract = !canvas.isAnimating();
+        insertBtn.setEnabled(canInteract);
+        deleteBtn.setEnabled(canInteract);
+        stabBtn.setEnabled(canInteract);
+        overlapBtn.setEnabled(canInteract);
+        randomBtn.setEnabled(canInteract);
+        clearBtn.setEnabled(canInteract);
+        exportBtn.setEnabled(canInteract);
+        
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                running = false;
+            }
+            
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                running = false;
+            }
+            
+            lowInput.handleEvent(event, window);
+            highInput.handleEvent(event, window);
+            speedSlider.handleEvent(event, window);
+            
+            if (backBtn.handleEvent(event, window)) {
+                running = false;
+            }
+            
+            // INSERT operation
+            if (insertBtn.handleEvent(event, window)) {
+                int low, high;
+                if (readInterval(low, high, true)) {
+                    std::vector<IntervalNode*> path;
+                    std::string interval = "[" + std::to_string(low) + ", " + std::to_string(high) + "]";
+                    canvas.resetColors();
+                    if (tree.insert(low, high, path)) {
+                        canvas.setTree(tree.getRoot(), describe);
+                        for (size_t i = 0; i + 1 < path.size(); i++) {
+                            canvas.queueStep(path[i]->id, TreeCanvas::VISITED_FILL);
+                        }
+                        canvas.queueStep(path.back()->id, Config::NODE_NEW_FILL);
+                        messageBox.show("Inserted: " + interval, MessageBox::SUCCESS, 2.0f);
+                    } else {
+                        for (IntervalNode* node : path) {
+                            canvas.queueStep(node->id, TreeCanvas::VISITED_FILL);
+                        }
+                        messageBox.show("Error: " + interval + " already exists!", MessageBox::ERROR_MSG, 3.0f);
+                    }
+                    lowInput.clear();
+                    highInput.clear();
+                }
+            }
+            
+            // DELETE operation
+            if (deleteBtn.handleEvent(event, window)) {
+                int low, high;
+                if (readInterval(low, high, true)) {
+                    std::vector<int> pathIds;
+                    std::string interval = "[" + std::to_string(low) + ", " + std::to_string(high) + "]";
+                    bool removed = tree.remove(low, high, pathIds);
+                    canvas.resetColors();
+                    canvas.setTree(tree.getRoot(), describe);
+                    for (int id : pathIds) {
+                        canvas.queueStep(id, TreeCanvas::VISITED_FILL);
+                    }
+                    if (removed) {
+                        messageBox.show("Deleted: " + interval, MessageBox::SUCCESS, 2.0f);
+                    } else {
+                        messageBox.show("Error: " + interval + " not found!", MessageBox::ERROR_MSG, 3.0f);
+                    }
+                    lowInput.clear();
+                    highInput.clear();
+                }
+            }
+            
+            // STAB / OVERLAP queries
+            bool stabClicked = stabBtn.handleEvent(event, window);
+            bool overlapClicked = overlapBtn.handleEvent(event, window);
+            if (stabClicked || overlapClicked) {
+                int low, high;
+                if (tree.isEmpty()) {
+                    messageBox.show("Tree is empty.", MessageBox::INFO, 2.0f);
+                }
+                else if (readInterval(low, high, overlapClicked)) {
+                    std::vector<IntervalNode*> matches;
+                    std::vector<IntervalQueryStep> trace;
+                    if (stabClicked) {
+                        tree.stab(low, matches, &trace);
+                    } else {
+                        tree.overlap(low, high, matches, &trace);
+                    }
+                    showQuery(trace, matches);
+                    messageBox.show(std::to_string(matches.size()) + " interval(s) found", 
+                                    matches.empty() ? MessageBox::INFO : MessageBox::SUCCESS, 2.0f);
+                }
+            }
+            
+            // RANDOM intervals (small values so overlaps are common)
+            if (randomBtn.handleEvent(event, window)) {
+                std::vector<IntervalNode*> path;
+                int added = 0;
+                for (int i = 0; i < 10; i++) {
+                    randomSeed = randomSeed * 1103515245u + 12345u;
+                    int low = static_cast<int>((randomSeed >> 16) % 100);
+                    randomSeed = randomSeed * 1103515245u + 12345u;
+                    int high = low + static_cast<int>((randomSeed >> 16) % 30);
+                    path.clear();
+                    if (tree.insert(low, high, path)) added++;
+                }
+                canvas.resetColors();
+                canvas.setTree(tree.getRoot(), describe);
+                messageBox.show("Inserted " + std::to_string(added) + " random intervals", MessageBox::SUCCESS, 2.0f);
+            }
+            
+            // CLEAR operation
+            if (clearBtn.handleEvent(event, window)) {
+                if (!tree.isEmpty()) {
+                    tree.clear();
+                    canvas.setTree(tree.getRoot(), describe);
+                    resultText.setString("");
+                    messageBox.show("Tree cleared!", MessageBox::INFO, 2.0f);
+                } else {
+                    messageBox.show("Tree is already empty.", MessageBox::INFO, 2.0f);
+                }
+            }
+            
+            // EXPORT PNG
+            if (exportBtn.handleEvent(event, window)) {
+                if (tree.isEmpty()) {
+                    messageBox.show("Cannot export empty tree!", MessageBox::ERROR_MSG, 2.0f);
+                } else {
+                    window.display();
+                    if (exportVisualizationToPNG(window, "interval_export.png",
+                                                  Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
+                                                  Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
+                        messageBox.show("Exported to interval_export.png", MessageBox::SUCCESS, 3.0f);
+                    } else {
+                        messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
+                    }
+                }
+            }
+        }
+        
+        // Update
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        lowInput.update(deltaTime);
+        highInput.update(deltaTime);
+        canvas.update(deltaTime);
+        messageBox.update(deltaTime);
+        
+        // Draw
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
+        window.clear(Config::BACKGROUND_COLOR);
+        window.draw(controlPanel);
+        window.draw(titleText);
+        window.draw(inputLabel);
+        window.draw(legendText);
+        window.draw(resultText);
+        lowInput.draw(window);
+        highInput.draw(window);
+        insertBtn.draw(window);
+        deleteBtn.draw(window);
+        stabBtn.draw(window);
+        overlapBtn.draw(window);
+        randomBtn.draw(window);
+        clearBtn.draw(window);
+        speedSlider.draw(window);
+        exportBtn.draw(window);
+        backBtn.draw(window);
+        canvas.draw(window);
+        drawMemoryHud(window, font);
+        messageBox.draw(window);
+        window.display();
+    }
+}
+
+// ============================================================================
+// K-D TREE MODE
+// 2D points: the plane with its splitting lines on the left, the tree on the
+// right. Queries gray out the half-planes (subtrees) they never enter.
+// ============================================================================
+void runKdTreeMode(sf::RenderWindow& window, sf::Font& font) {
+    const int WORLD = 100;                  // Coordinates are 0..99
+    const float PLANE_SIZE = 400.0f;
+    const float PLANE_X = Config::TREE_AREA_X;
+    const float PLANE_Y = Config::TREE_AREA_Y;
+    const float SCALE = PLANE_SIZE / WORLD;
+    
+    std::vector<KdPoint> points;
+    KdTree tree;
+    TreeCanvas canvas(PLANE_X + PLANE_SIZE + 30, Config::TREE_AREA_Y,
+                      Config::TREE_AREA_WIDTH - PLANE_SIZE - 30, Config::TREE_AREA_HEIGHT,
+                      "K-d Tree", font);
+    
+    // Pointer-based view of the flat node array for the canvas layout
+    struct ViewNode {
+        int id;
+        int value;
+        ViewNode* left;
+        ViewNode* right;
+    };
+    std::vector<ViewNode> viewNodes;
+    
+    // Region (half-plane intersection) and parent of every node, for drawing
+    struct Region {
+        float x0, y0, x1, y1;
+    };
+    std::vector<Region> regions;
+    std::vector<int> parents;
+    
+    auto rebuild = [&]() {
+        tree.build(points);
+        int count = tree.size();
+        
+        viewNodes.assign(count, ViewNode());
+        for (int i = 0; i < count; i++) {
+            int left = tree.leftChild(i);
+            int right = tree.rightChild(i);
+            viewNodes[i].id = i;
+            viewNodes[i].value = 0;
+            viewNodes[i].left = left >= 0 ? &viewNodes[left] : nullptr;
+            viewNodes[i].right = right >= 0 ? &viewNodes[right] : nullptr;
+        }
+        
+        regions.assign(count, Region());
+        parents.assign(count, -1);
+        if (count > 0) {
+            regions[0] = {0, 0, static_cast<float>(WORLD), static_cast<float>(WORLD)};
+        }
+        // Pre-order: parents come before their children
+        for (int i = 0; i < count; i++) {
+            const KdNode& node = tree.getNode(i);
+            Region below = regions[i];
+            Region above = regions[i];
+            if (node.axis == 0) {
+                below.x1 = above.x0 = static_cast<float>(node.x);
+            } else {
+                below.y1 = above.y0 = static_cast<float>(node.y);
+            }
+            int left = tree.leftChild(i);
+            int right = tree.rightChild(i);
+            if (left >= 0) { regions[left] = below; parents[left] = i; }
+            if (right >= 0) { regions[right] = above; parents[right] = i; }
+        }
+        
+        canvas.resetColors();
+        canvas.setTree(count > 0 ? &viewNodes[0] : static_cast<ViewNode*>(nullptr),
+                       [&tree](ViewNode* view, std::string& label, std::string& detail) {
+                           const KdNode& node = tree.getNode(view->id);
+                           label = "(" + std::to_string(node.x) + "," + std::to_string(node.y) + ")";
+                           detail = node.axis == 0 ? "split x" : "split y";
+                       });
+    };
+    
+    // GUI Layout
+    float panelX = Config::CONTROL_PANEL_PADDING;
+    float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
+    float thirdWidth = (controlWidth - 20) / 3;
+    float buttonHeight = 32.0f;
+    float spacing = 8.0f;
+    float currentY = Config::CONTROL_PANEL_PADDING;
+    
+    // Title
+    sf::Text titleText;
+    titleText.setFont(font);
+    titleText.setString("K-d Tree (2D)");
+    titleText.setCharacterSize(Config::TITLE_FONT_SIZE);
+    titleText.setFillColor(Config::TEXT_COLOR);
+    titleText.setStyle(sf::Text::Bold);
+    titleText.setPosition(panelX, currentY);
+    currentY += 30;
+    
+    // X / Y / k inputs in one row
+    sf::Text inputLabel;
+    inputLabel.setFont(font);
+    inputLabel.setString("X:               Y:               k / r:");
+    inputLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    inputLabel.setFillColor(Config::TEXT_SECONDARY);
+    inputLabel.setPosition(panelX, currentY);
+    currentY += 18;
+    
+    TextInput xInput(panelX, currentY, thirdWidth, 32, "0-99", font, true);
+    TextInput yInput(panelX + thirdWidth + 10, currentY, thirdWidth, 32, "0-99", font, true);
+    TextInput kInput(panelX + 2 * (thirdWidth + 10), currentY, thirdWidth, 32, "3", font, true);
+    currentY += 40;
+    
+    // Operation buttons
+    Button insertBtn(panelX, currentY, controlWidth, buttonHeight, "Insert Point", font);
+    currentY += buttonHeight + spacing;
+    
+    Button nearestBtn(panelX, currentY, controlWidth, buttonHeight, "k Nearest to (X, Y)", font);
+    currentY += buttonHeight + spacing;
+    
+    Button rangeBtn(panelX, currentY, controlWidth, buttonHeight, "Range: (X, Y) +/- r", font);
+    currentY += buttonHeight + spacing;
+    
+    Button randomBtn(panelX, currentY, controlWidth, buttonHeight, "Insert 20 Random", font);
+    currentY += buttonHeight + spacing;
+    
+    Button clearBtn(panelX, currentY, controlWidth, buttonHeight, "Clear All", font);
+    currentY += buttonHeight + spacing + 10;
+    
+    // Speed slider
+    Slider speedSlider(panelX, currentY, controlWidth, 
+                       Config::MIN_ANIMATION_SPEED, Config::MAX_ANIMATION_SPEED, 
+                       Config::DEFAULT_ANIMATION_SPEED, "Animation Speed", font);
+    currentY += 45;
+    
+    // Export button
+    Button exportBtn(panelX, currentY, controlWidth, buttonHeight, "Export PNG", font);
+    currentY += buttonHeight + spacing;
+    
+    // Back button
+    Button backBtn(panelX, currentY, controlWidth, buttonHeight, "<< Back to Menu", font);
+    currentY += buttonHeight + spacing + 10;
+    
+    // Legend and last query result
+    sf::Text legendText;
+    legendText.setFont(font);
+    legendText.setString("Click the plane to add a point.\nYellow: visited   Green: result\nGray: half-plane pruned");
+    legendText.setCharacterSize(10);
+    legendText.setFillColor(Config::TEXT_SECONDARY);
+    legendText.setPosition(panelX, currentY);
+    currentY += 48;
+    
+    sf::Text resultText;
+    resultText.setFont(font);
+    resultText.setString("");
+    resultText.setCharacterSize(10);
+    resultText.setFillColor(Config::TEXT_COLOR);
+    resultText.setPosition(panelX, currentY);
+    
+    // Message box for feedback
+    MessageBox messageBox(panelX, Config::WINDOW_HEIGHT - 55, controlWidth, font);
+    
+    // Control panel background
+    sf::RectangleShape controlPanel;
+    controlPanel.setPosition(0, 0);
+    controlPanel.setSize(sf::Vector2f(Config::CONTROL_PANEL_WIDTH, Config::WINDOW_HEIGHT));
+    controlPanel.setFillColor(Config::CONTROL_PANEL_COLOR);
+    
+    // Current query overlay
+    enum class QueryShape { NONE, NEAREST, RANGE };
+    QueryShape queryShape = QueryShape::NONE;
+    int queryX = 0, queryY = 0, queryRadius = 0;
+    float nearestRadius = 0;
+    
+    auto addPoint = [&](int x, int y) {
+        points.push_back({x, y});
+        rebuild();
+        queryShape = QueryShape::NONE;
+        resultText.setString("");
+        messageBox.show("Inserted (" + std::to_string(x) + ", " + std::to_string(y) + "), " +
+                        std::to_string(points.size()) + " points", MessageBox::SUCCESS, 2.0f);
+    };
+    
+    auto readCoordinate = [&](TextInput& input, int& value) {
+        if (input.isEmpty() || !input.getAsInt(value) || value < 0 || value >= WORLD) {
+            messageBox.show("Error: X and Y must be 0-99!", MessageBox::ERROR_MSG, 3.0f);
+            return false;
+        }
+        return true;
+    };
+    
+    // Animate a query trace. Nearest-neighbour candidates that were later
+    // beaten are turned back to 'visited' at the end.
+    auto playTrace = [&](const std::vector<KdQueryStep>& trace, const std::vector<int>& results) {
+        canvas.resetColors();
+        std::vector<int> candidates;
+        int visited = 0, pruned = 0;
+        for (const KdQueryStep& step : trace) {
+            switch (step.kind) {
+                case KdQueryStep::VISIT:
+                    canvas.queueStep(step.node, TreeCanvas::VISITED_FILL);
+                    visited++;
+                    break;
+                case KdQueryStep::MATCH:
+                    canvas.queueStep(step.node, TreeCanvas::MATCH_FILL);
+                    candidates.push_back(step.node);
+                    break;
+                case KdQueryStep::PRUNED:
+                    canvas.queueStep(step.node, TreeCanvas::PRUNED_FILL, true);
+                    pruned++;
+                    break;
+            }
+        }
+        for (int candidate : candidates) {
+            if (std::find(results.begin(), results.end(), candidate) == results.end()) {
+                canvas.queueStep(candidate, TreeCanvas::VISITED_FILL);
+            }
+        }
+        return std::to_string(visited) + " of " + std::to_string(tree.size()) + " visited, " +
+               std::to_string(pruned) + " pruned";
+    };
+    
+    unsigned int randomSeed = 7;
+    sf::Clock clock;
+    bool running = true;
+    
+    while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
+        float deltaTime = clock.restart().asSeconds();
+        canvas.setSpeed(speedSlider.getValue());
+        
+        // Disable buttons during animation
+        bool canInteract = !canvas.isAnimating();
+        insertBtn.setEnabled(canInteract);
+        nearestBtn.setEnabled(canInteract);
+        rangeBtn.setEnabled(canInteract);
+        randomBtn.setEnabled(canInteract);
+        clearBtn.setEnabled(canInteract);
+        exportBtn.setEnabled(canInteract);
+        
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                running = false;
+            }
+            
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                running = false;
+            }
+            
+            xInput.handleEvent(event, window);
+            yInput.handleEvent(event, window);
+            kInput.handleEvent(event, window);
+            speedSlider.handleEvent(event, window);
+            
+            if (backBtn.handleEvent(event, window)) {
+                running = false;
+            }
+            
+            // Click on the plane inserts a point there
+            if (canInteract && event.type == sf::Event::MouseButtonPressed &&
+                event.mouseButton.button == sf::Mouse::Left) {
+                float mx = static_cast<float>(event.mouseButton.x) - PLANE_X;
+                float my = static_cast<float>(event.mouseButton.y) - PLANE_Y;
+                if (mx >= 0 && my >= 0 && mx < PLANE_SIZE && my < PLANE_SIZE) {
+                    addPoint(static_cast<int>(mx / SCALE), static_cast<int>(my / SCALE));
+                }
+            }
+            
+            // INSERT operation
+            if (insertBtn.handleEvent(event, window)) {
+                int x, y;
+                if (readCoordinate(xInput, x) && readCoordinate(yInput, y)) {
+                    addPoint(x, y);
+                    xInput.clear();
+                    yInput.clear();
+                }
+            }
+            
+            // NEAREST / RANGE queries
+            bool nearestClicked = nearestBtn.handleEvent(event, window);
+            bool rangeClicked = rangeBtn.handleEvent(event, window);
+            if (nearestClicked || rangeClicked) {
+                int x, y;
+                int k = 3;
+                if (tree.isEmpty()) {
+                    messageBox.show("Add some points first.", MessageBox::INFO, 2.0f);
+                }
+                else if (readCoordinate(xInput, x) && readCoordinate(yInput, y)) {
+                    if (!kInput.isEmpty() && (!kInput.getAsInt(k) || k < 1)) {
+                        messageBox.show("Error: k / r must be a positive integer!", MessageBox::ERROR_MSG, 3.0f);
+                        continue;
+                    }
+                    queryX = x;
+                    queryY = y;
+                    std::vector<KdQueryStep> trace;
+                    std::ostringstream ss;
+                    if (nearestClicked) {
+                        std::vector<KdNeighbor> neighbors;
+                        tree.nearest(x, y, k, neighbors, &trace);
+                        std::vector<int> results;
+                        for (const KdNeighbor& neighbor : neighbors) {
+                            results.push_back(neighbor.node);
+                        }
+                        ss << playTrace(trace, results) << "\n";
+                        for (size_t i = 0; i < neighbors.size() && i < 8; i++) {
+                            const KdNode& node = tree.getNode(neighbors[i].node);
+                            ss << "(" << node.x << "," << node.y << ") d="
+                               << std::sqrt(static_cast<double>(neighbors[i].distanceSquared)) << "\n";
+                        }
+                        queryShape = QueryShape::NEAREST;
+                        nearestRadius = neighbors.empty() ? 0.0f
+                            : static_cast<float>(std::sqrt(static_cast<double>(neighbors.back().distanceSquared)));
+                        messageBox.show("Found " + std::to_string(neighbors.size()) + " nearest", MessageBox::SUCCESS, 2.0f);
+                    } else {
+                        std::vector<int> results;
+                        tree.range(x - k, y - k, x + k, y + k, results, &trace);
+                        ss << playTrace(trace, results) << "\n" << results.size() << " point(s) in range";
+                        queryShape = QueryShape::RANGE;
+                        queryRadius = k;
+                        messageBox.show(std::to_string(results.size()) + " point(s) in range", 
+                                        results.empty() ? MessageBox::INFO : MessageBox::SUCCESS, 2.0f);
+                    }
+                    resultText.setString(ss.str());
+                }
+            }
+            
+            // RANDOM points
+            if (randomBtn.handleEvent(event, window)) {
+                for (int i = 0; i < 20; i++) {
+                    randomSeed = randomSeed * 1103515245u + 12345u;
+                    int x = static_cast<int>((randomSeed >> 16) % WORLD);
+                    randomSeed = randomSeed * 1103515245u + 12345u;
+                    int y = static_cast<int>((randomSeed >> 16) % WORLD);
+                    points.push_back({x, y});
+                }
+                rebuild();
+                queryShape = QueryShape::NONE;
+                resultText.setString("");
+                messageBox.show("Inserted 20 random points", MessageBox::SUCCESS, 2.0f);
+            }
+            
+            // CLEAR operation
+            if (clearBtn.handleEvent(event, window)) {
+                if (!points.empty()) {
+                    points.clear();
+                    rebuild();
+                    queryShape = QueryShape::NONE;
+                    resultText.setString("");
+                    messageBox.show("Points cleared!", MessageBox::INFO, 2.0f);
+                } else {
+                    messageBox.show("Already empty.", MessageBox::INFO, 2.0f);
+                }
+            }
+            
+            // EXPORT PNG
+            if (exportBtn.handleEvent(event, window)) {
+                if (tree.isEmpty()) {
+                    messageBox.show("Cannot export empty tree!", MessageBox::ERROR_MSG, 2.0f);
+                } else {
+                    window.display();
+                    if (exportVisualizationToPNG(window, "kdtree_export.png",
+                                                  Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
+                                                  Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
+                        messageBox.show("Exported to kdtree_export.png", MessageBox::SUCCESS, 3.0f);
+                    } else {
+                        messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
+                    }
+                }
+            }
+        }
+        
+        // Update
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        xInput.update(deltaTime);
+        yInput.update(deltaTime);
+        kInput.update(deltaTime);
+        canvas.update(deltaTime);
+        messageBox.update(deltaTime);
+        
+        // Draw
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
+        window.clear(Config::BACKGROUND_COLOR);
+        window.draw(controlPanel);
+        window.draw(titleText);
+        window.draw(inputLabel);
+        window.draw(legendText);
+        window.draw(resultText);
+        xInput.draw(window);
+        yInput.draw(window);
+        kInput.draw(window);
+        insertBtn.draw(window);
+        nearestBtn.draw(window);
+        rangeBtn.draw(window);
+        randomBtn.draw(window);
+        clearBtn.draw(window);
+        speedSlider.draw(window);
+        exportBtn.draw(window);
+        backBtn.draw(window);
+        canvas.draw(window);
+        
+        // Plane view
+        sf::RectangleShape plane;
+        plane.setPosition(PLANE_X - 10, PLANE_Y - 10);
+        plane.setSize(sf::Vector2f(PLANE_SIZE + 20, PLANE_SIZE + 20));
+        plane.setFillColor(Config::TREE_AREA_COLOR);
+        plane.setOutlineThickness(1);
+        plane.setOutlineColor(sf::Color(60, 60, 70));
+        window.draw(plane);
+        
+        sf::Text planeTitle;
+        planeTitle.setFont(font);
+        planeTitle.setString("Plane (0,0 top-left)");
+        planeTitle.setCharacterSize(Config::TITLE_FONT_SIZE);
+        planeTitle.setFillColor(Config::TEXT_SECONDARY);
+        planeTitle.setPosition(PLANE_X, PLANE_Y - 35);
+        window.draw(planeTitle);
+        
+        // Pruned half-planes: the region of every pruned subtree root
+        sf::RectangleShape shade;
+        shade.setFillColor(sf::Color(70, 70, 85, 170));
+        for (int i = 0; i < tree.size(); i++) {
+            sf::Color fill, parentFill;
+            if (!canvas.getColor(i, fill) || fill != TreeCanvas::PRUNED_FILL) continue;
+            if (parents[i] >= 0 && canvas.getColor(parents[i], parentFill) &&
+                parentFill == TreeCanvas::PRUNED_FILL) continue;
+            const Region& region = regions[i];
+            shade.setPosition(PLANE_X + region.x0 * SCALE, PLANE_Y + region.y0 * SCALE);
+            shade.setSize(sf::Vector2f((region.x1 - region.x0) * SCALE, (region.y1 - region.y0) * SCALE));
+            window.draw(shade);
+        }
+        
+        // Splitting lines, each limited to its node's region
+        for (int i = 0; i < tree.size(); i++) {
+            const KdNode& node = tree.getNode(i);
+            const Region& region = regions[i];
+            sf::Vector2f from, to;
+            if (node.axis == 0) {
+                from = sf::Vector2f(PLANE_X + node.x * SCALE, PLANE_Y + region.y0 * SCALE);
+                to = sf::Vector2f(PLANE_X + node.x * SCALE, PLANE_Y + region.y1 * SCALE);
+            } else {
+                from = sf::Vector2f(PLANE_X + region.x0 * SCALE, PLANE_Y + node.y * SCALE);
+                to = sf::Vector2f(PLANE_X + region.x1 * SCALE, PLANE_Y + node.y * SCALE);
+            }
+            sf::Color lineColor = node.axis == 0 ? sf::Color(200, 90, 90) : sf::Color(90, 140, 220);
+            sf::Vertex line[] = { sf::Vertex(from, lineColor), sf::Vertex(to, lineColor) };
+            window.draw(line, 2, sf::Lines);
+        }
+        
+        // Query overlay
+        if (queryShape != QueryShape::NONE) {
+            float qx = PLANE_X + queryX * SCALE;
+            float qy = PLANE_Y + queryY * SCALE;
+            if (queryShape == QueryShape::RANGE) {
+                sf::RectangleShape box;
+                box.setPosition(qx - queryRadius * SCALE, qy - queryRadius * SCALE);
+                box.setSize(sf::Vector2f(2 * queryRadius * SCALE, 2 * queryRadius * SCALE));
+                box.setFillColor(sf::Color::Transparent);
+                box.setOutlineThickness(2);
+                box.setOutlineColor(Config::NODE_HIGHLIGHT_FILL);
+                window.draw(box);
+            } else if (!canvas.isAnimating()) {
+                sf::CircleShape circle(nearestRadius * SCALE);
+                circle.setOrigin(nearestRadius * SCALE, nearestRadius * SCALE);
+                circle.setPosition(qx, qy);
+                circle.setFillColor(sf::Color::Transparent);
+                circle.setOutlineThickness(2);
+                circle.setOutlineColor(TreeCanvas::MATCH_FILL);
+                window.draw(circle);
+            }
+            sf::Vertex cross[] = {
+                sf::Vertex(sf::Vector2f(qx - 6, qy - 6), Config::ERROR_COLOR),
+                sf::Vertex(sf::Vector2f(qx + 6, qy + 6), Config::ERROR_COLOR),
+                sf::Vertex(sf::Vector2f(qx - 6, qy + 6), Config::ERROR_COLOR),
+                sf::Vertex(sf::Vector2f(qx + 6, qy - 6), Config::ERROR_COLOR)
+            };
+            window.draw(cross, 4, sf::Lines);
+        }
+        
+        // Points, colored like their tree nodes
+        sf::CircleShape dot(4.0f);
+        dot.setOrigin(4.0f, 4.0f);
+        for (int i = 0; i < tree.size(); i++) {
+            const KdNode& node = tree.getNode(i);
+            sf::Color fill = Config::NODE_DEFAULT_FILL;
+            canvas.getColor(i, fill);
+            dot.setFillColor(fill == Config::NODE_DEFAULT_FILL ? Config::NODE_DEFAULT_OUTLINE : fill);
+            dot.setPosition(PLANE_X + node.x * SCALE, PLANE_Y + node.y * SCALE);
+            window.draw(dot);
+        }
+        
+        drawMemoryHud(window, font);
+        messageBox.draw(window);
+        window.display();
+    }
+}
+
+// ============================================================================
+// BLOOM / CUCKOO FILTER MODE
+// Every key goes into both filters. The Bloom bit array (two 512-bit blocks)
+// and the cuckoo buckets are drawn with the last key's bits / buckets marked;
+// a std::set of the inserted keys is the ground truth that exposes false
+// positives.
+// ============================================================================
+void runFilterMode(sf::RenderWindow& window, sf::Font& font) {
+    const int GRID_COLUMNS = 64;            // One row = one 64-bit word
+    const float CELL = 12.0f;
+    const float BLOOM_X = Config::TREE_AREA_X;
+    const float BLOOM_Y = Config::TREE_AREA_Y;
+    const float SLOT_WIDTH = 44.0f;
+    const float SLOT_HEIGHT = 22.0f;
+    const sf::Color EMPTY_FILL(45, 45, 58);
+    
+    // Small enough to draw: ~100 keys at 10 bits each, 60 fingerprints
+    BloomFilter bloom(100, 10.0);
+    CuckooFilter<uint8_t> cuckoo(60);
+    std::set<int> inserted;
+    
+    const int bloomRows = static_cast<int>(bloom.sizeInBits()) / GRID_COLUMNS;
+    const float CUCKOO_X = Config::TREE_AREA_X;
+    const float CUCKOO_Y = BLOOM_Y + bloomRows * CELL + 95;
+    
+    // GUI Layout
+    float panelX = Config::CONTROL_PANEL_PADDING;
+    float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
+    float buttonHeight = 32.0f;
+    float spacing = 8.0f;
+    float currentY = Config::CONTROL_PANEL_PADDING;
+    
+    // Title
+    sf::Text titleText;
+    titleText.setFont(font);
+    titleText.setString("Bloom / Cuckoo Filter");
+    titleText.setCharacterSize(Config::TITLE_FONT_SIZE);
+    titleText.setFillColor(Config::TEXT_COLOR);
+    titleText.setStyle(sf::Text::Bold);
+    titleText.setPosition(panelX, currentY);
+    currentY += 30;
+    
+    sf::Text inputLabel;
+    inputLabel.setFont(font);
+    inputLabel.setString("Key:");
+    inputLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    inputLabel.setFillColor(Config::TEXT_SECONDARY);
+    inputLabel.setPosition(panelX, currentY);
+    currentY += 18;
+    
+    TextInput keyInput(panelX, currentY, controlWidth, 32, "Enter key...", font, true);
+    currentY += 40;
+    
+    // Operation buttons
+    Button insertBtn(panelX, currentY, controlWidth, buttonHeight, "Insert", font);
+    currentY += buttonHeight + spacing;
+    
+    Button queryBtn(panelX, currentY, controlWidth, buttonHeight, "Query", font);
+    currentY += buttonHeight + spacing;
+    
+    Button removeBtn(panelX, currentY, controlWidth, buttonHeight, "Remove (cuckoo only)", font);
+    currentY += buttonHeight + spacing;
+    
+    Button randomBtn(panelX, currentY, controlWidth, buttonHeight, "Insert 10 Random", font);
+    currentY += buttonHeight + spacing;
+    
+    Button probeBtn(panelX, currentY, controlWidth, buttonHeight, "Probe 1000 Absent Keys", font);
+    currentY += buttonHeight + spacing;
+    
+    Button clearBtn(panelX, currentY, controlWidth, buttonHeight, "Clear All", font);
+    currentY += buttonHeight + spacing + 10;
+    
+    // Export button
+    Button exportBtn(panelX, currentY, controlWidth, buttonHeight, "Export PNG", font);
+    currentY += buttonHeight + spacing;
+    
+    // Back button
+    Button backBtn(panelX, currentY, controlWidth, buttonHeight, "<< Back to Menu", font);
+    currentY += buttonHeight + spacing + 10;
+    
+    // Legend and last result
+    sf::Text legendText;
+    legendText.setFont(font);
+    legendText.setString("Purple: set by the last insert\nYellow: tested and set\nRed: tested and clear (-> absent)\nGreen: matching fingerprint");
+    legendText.setCharacterSize(10);
+    legendText.setFillColor(Config::TEXT_SECONDARY);
+    legendText.setPosition(panelX, currentY);
+    currentY += 60;
+    
+    sf::Text resultText;
+    resultText.setFont(font);
+    resultText.setString("");
+    resultText.setCharacterSize(10);
+    resultText.setFillColor(Config::TEXT_COLOR);
+    resultText.setPosition(panelX, currentY);
+    
+    // Message box for feedback
+    MessageBox messageBox(panelX, Config::WINDOW_HEIGHT - 55, controlWidth, font);
+    
+    // Control panel background
+    sf::RectangleShape controlPanel;
+    controlPanel.setPosition(0, 0);
+    controlPanel.setSize(sf::Vector2f(Config::CONTROL_PANEL_WIDTH, Config::WINDOW_HEIGHT));
+    controlPanel.setFillColor(Config::CONTROL_PANEL_COLOR);
+    
+    // The key whose bits / buckets are marked
+    enum class LastAction { NONE, INSERT, QUERY };
+    LastAction lastAction = LastAction::NONE;
+    int lastKey = 0;
+    
+    auto readKey = [&](int& key) {
+        if (keyInput.isEmpty() || !keyInput.getAsInt(key)) {
+            messageBox.show("Error: Enter a valid integer key!", MessageBox::ERROR_MSG, 3.0f);
+            return false;
+        }
+        return true;
+    };
+    
+    // Returns false when the cuckoo table has no room left
+    auto addKey = [&](int key) {
+        if (inserted.count(key)) return true;
+        if (cuckoo.isFull()) return false;
+        bloom.insert(key);
+        cuckoo.insert(key);
+        inserted.insert(key);
+        return true;
+    };
+    
+    auto countSetBits = [&]() {
+        size_t set = 0;
+        for (size_t bit = 0; bit < bloom.sizeInBits(); bit++) {
+            if (bloom.testBit(bit)) set++;
+        }
+        return set;
+    };
+    
+    unsigned int randomSeed = 1;
+    sf::Clock clock;
+    bool running = true;
+    
+    while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
+        float deltaTime = clock.restart().asSeconds();
+        
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                running = false;
+            }
+            
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                running = false;
+            }
+            
+            keyInput.handleEvent(event, window);
+            
+            if (backBtn.handleEvent(event, window)) {
+                running = false;
+            }
+            
+            // INSERT operation
+            if (insertBtn.handleEvent(event, window)) {
+                int key;
+                if (readKey(key)) {
+                    if (inserted.count(key)) {
+                        messageBox.show("Error: " + std::to_string(key) + " already inserted!", MessageBox::ERROR_MSG, 3.0f);
+                    } else if (!addKey(key)) {
+                        messageBox.show("Cuckoo filter is full - remove or clear", MessageBox::ERROR_MSG, 3.0f);
+                    } else {
+                        lastKey = key;
+                        lastAction = LastAction::INSERT;
+                        resultText.setString("");
+                        messageBox.show("Inserted: " + std::to_string(key), MessageBox::SUCCESS, 2.0f);
+                    }
+                    keyInput.clear();
+                }
+            }
+            
+            // QUERY operation
+            if (queryBtn.handleEvent(event, window)) {
+                int key;
+                if (readKey(key)) {
+                    bool truth = inserted.count(key) > 0;
+                    bool inBloom = bloom.contains(key);
+                    bool inCuckoo = cuckoo.contains(key);
+                    auto verdict = [truth](bool answer) {
+                        if (!answer) return std::string("definitely absent");
+                        return std::string(truth ? "present" : "FALSE POSITIVE");
+                    };
+                    std::ostringstream ss;
+                    ss << "Key " << key << " (" << (truth ? "inserted" : "never inserted") << ")\n"
+                       << "Bloom:  " << verdict(inBloom) << "\n"
+                       << "Cuckoo: " << verdict(inCuckoo);
+                    resultText.setString(ss.str());
+                    lastKey = key;
+                    lastAction = LastAction::QUERY;
+                    bool falsePositive = !truth && (inBloom || inCuckoo);
+                    messageBox.show(falsePositive ? "False positive!" : (inBloom ? "Probably present" : "Not present"),
+                                    falsePositive ? MessageBox::ERROR_MSG : MessageBox::INFO, 2.0f);
+                }
+            }
+            
+            // REMOVE operation (a Bloom filter can't forget a key)
+            if (removeBtn.handleEvent(event, window)) {
+                int key;
+                if (readKey(key)) {
+                    if (!inserted.count(key)) {
+                        // Removing it could delete another key's matching fingerprint
+                        messageBox.show("Error: " + std::to_string(key) + " was never inserted!", MessageBox::ERROR_MSG, 3.0f);
+                    } else {
+                        cuckoo.remove(key);
+                        inserted.erase(key);
+                        lastKey = key;
+                        lastAction = LastAction::QUERY;
+                        resultText.setString("Removed from the cuckoo filter.\nThe Bloom filter keeps its bits,\nso it now reports a false positive.");
+                        messageBox.show("Removed: " + std::to_string(key), MessageBox::SUCCESS, 2.0f);
+                    }
+                    keyInput.clear();
+                }
+            }
+            
+            // RANDOM keys in 0..999
+            if (randomBtn.handleEvent(event, window)) {
+                int added = 0;
+                for (int i = 0; i < 10; i++) {
+                    randomSeed = randomSeed * 1103515245u + 12345u;
+                    int key = static_cast<int>((randomSeed >> 16) % 1000);
+                    if (inserted.count(key)) continue;
+                    if (!addKey(key)) break;
+                    lastKey = key;
+                    lastAction = LastAction::INSERT;
+                    added++;
+                }
+                resultText.setString("");
+                if (cuckoo.isFull()) {
+                    messageBox.show("Inserted " + std::to_string(added) + "; cuckoo filter is full", MessageBox::INFO, 3.0f);
+                } else {
+                    messageBox.show("Inserted " + std::to_string(added) + " random keys", MessageBox::SUCCESS, 2.0f);
+                }
+            }
+            
+            // Measure the false-positive rate on keys that were never inserted
+            if (probeBtn.handleEvent(event, window)) {
+                int bloomHits = 0, cuckooHits = 0, probed = 0;
+                for (int key = 1000000; probed < 1000; key++) {
+                    if (inserted.count(key)) continue;
+                    probed++;
+                    if (bloom.contains(key)) bloomHits++;
+                    if (cuckoo.contains(key)) cuckooHits++;
+                }
+                std::ostringstream ss;
+                ss << std::fixed << std::setprecision(1)
+                   << "1000 absent keys probed:\n"
+                   << "Bloom:  " << bloomHits / 10.0 << "% false positives\n"
+                   << "Cuckoo: " << cuckooHits / 10.0 << "% false positives\n"
+                   << "(" << inserted.size() << " keys stored)";
+                resultText.setString(ss.str());
+                lastAction = LastAction::NONE;
+                messageBox.show("Probe finished", MessageBox::INFO, 2.0f);
+            }
+            
+            // CLEAR operation
+            if (clearBtn.handleEvent(event, window)) {
+                if (!inserted.empty() || bloom.size() > 0) {
+                    bloom.clear();
+                    cuckoo.clear();
+                    inserted.clear();
+                    lastAction = LastAction::NONE;
+                    resultText.setString("");
+                    messageBox.show("Filters cleared!", MessageBox::INFO, 2.0f);
+                } else {
+                    messageBox.show("Filters are already empty.", MessageBox::INFO, 2.0f);
+                }
+            }
+            
+            // EXPORT PNG
+            if (exportBtn.handleEvent(event, window)) {
+                window.display();
+                if (exportVisualizationToPNG(window, "filter_export.png",
+                                              Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
+                                              Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
+                    messageBox.show("Exported to filter_export.png", MessageBox::SUCCESS, 3.0f);
+                } else {
+                    messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
+                }
+            }
+        }
+        
+        // Update
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        keyInput.update(deltaTime);
+        messageBox.update(deltaTime);
+        
+        // Draw
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
+        window.clear(Config::BACKGROUND_COLOR);
+        window.draw(controlPanel);
+        window.draw(titleText);
+        window.draw(inputLabel);
+        window.draw(legendText);
+        window.draw(resultText);
+        keyInput.draw(window);
+        insertBtn.draw(window);
+        queryBtn.draw(window);
+        removeBtn.draw(window);
+        randomBtn.draw(window);
+        probeBtn.draw(window);
+        clearBtn.draw(window);
+        exportBtn.draw(window);
+        backBtn.draw(window);
+        
+        sf::RectangleShape area;
+        area.setPosition(Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 10);
+        area.setSize(sf::Vector2f(Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 20));
+        area.setFillColor(Config::TREE_AREA_COLOR);
+        area.setOutlineThickness(1);
+        area.setOutlineColor(sf::Color(60, 60, 70));
+        window.draw(area);
+        
+        sf::Text caption;
+        caption.setFont(font);
+        caption.setCharacterSize(Config::TITLE_FONT_SIZE);
+        caption.setFillColor(Config::TEXT_SECONDARY);
+        
+        sf::Text stats;
+        stats.setFont(font);
+        stats.setCharacterSize(11);
+        stats.setFillColor(Config::TEXT_SECONDARY);
+        
+        // Bloom bit array: one row per 64-bit word, one outlined block per
+        // cache line
+        std::vector<size_t> markedBits;
+        size_t markedBlock = bloom.getBlockCount();
+        if (lastAction != LastAction::NONE) {
+            bloom.bitPositions(lastKey, markedBits);
+            markedBlock = markedBits.front() / BloomFilter::BLOCK_BITS;
+        }
+        
+        caption.setString("Blocked Bloom filter (" + std::to_string(bloom.getHashCount()) +
+                          " hashes, one 512-bit block per key)");
+        caption.setPosition(BLOOM_X, BLOOM_Y - 35);
+        window.draw(caption);
+        
+        sf::RectangleShape cell(sf::Vector2f(CELL - 2, CELL - 2));
+        for (size_t bit = 0; bit < bloom.sizeInBits(); bit++) {
+            bool set = bloom.testBit(bit);
+            sf::Color fill = set ? Config::NODE_DEFAULT_FILL : EMPTY_FILL;
+            if (std::find(markedBits.begin(), markedBits.end(), bit) != markedBits.end()) {
+                if (lastAction == LastAction::INSERT) fill = Config::NODE_NEW_FILL;
+                else fill = set ? Config::NODE_HIGHLIGHT_FILL : Config::NODE_DELETE_FILL;
+            }
+            cell.setFillColor(fill);
+            cell.setPosition(BLOOM_X + (bit % GRID_COLUMNS) * CELL + 1,
+                             BLOOM_Y + (bit / GRID_COLUMNS) * CELL + 1);
+            window.draw(cell);
+        }
+        
+        const int rowsPerBlock = BloomFilter::BLOCK_BITS / GRID_COLUMNS;
+        sf::RectangleShape blockOutline(sf::Vector2f(GRID_COLUMNS * CELL, rowsPerBlock * CELL));
+        blockOutline.setFillColor(sf::Color::Transparent);
+        for (uint32_t block = 0; block < bloom.getBlockCount(); block++) {
+            bool marked = block == markedBlock;
+            blockOutline.setOutlineThickness(marked ? 2 : 1);
+            blockOutline.setOutlineColor(marked ? Config::NODE_HIGHLIGHT_OUTLINE : sf::Color(90, 90, 105));
+            blockOutline.setPosition(BLOOM_X, BLOOM_Y + block * rowsPerBlock * CELL);
+            window.draw(blockOutline);
+        }
+        
+        std::ostringstream bloomStats;
+        size_t setBits = countSetBits();
+        bloomStats << std::fixed << std::setprecision(1) << bloom.size() << " keys, "
+                   << setBits << " of " << bloom.sizeInBits() << " bits set ("
+                   << 100.0 * setBits / bloom.sizeInBits() << "%)";
+        stats.setString(bloomStats.str());
+        stats.setPosition(BLOOM_X, BLOOM_Y + bloomRows * CELL + 8);
+        window.draw(stats);
+        
+        // Cuckoo buckets: one column of four slots per bucket
+        size_t firstBucket = cuckoo.getBucketCount(), secondBucket = cuckoo.getBucketCount();
+        uint8_t markedFingerprint = 0;
+        if (lastAction != LastAction::NONE) {
+            cuckoo.candidates(lastKey, firstBucket, secondBucket, markedFingerprint);
+        }
+        
+        caption.setString("Cuckoo filter (8-bit fingerprints, 4 slots per bucket)");
+        caption.setPosition(CUCKOO_X, CUCKOO_Y - 35);
+        window.draw(caption);
+        
+        sf::RectangleShape slotBox(sf::Vector2f(SLOT_WIDTH - 4, SLOT_HEIGHT - 2));
+        sf::Text slotText;
+        slotText.setFont(font);
+        slotText.setCharacterSize(11);
+        for (size_t bucket = 0; bucket < cuckoo.getBucketCount(); bucket++) {
+            bool candidate = bucket == firstBucket || bucket == secondBucket;
+            float x = CUCKOO_X + bucket * SLOT_WIDTH;
+            
+            for (int s = 0; s < CuckooFilter<uint8_t>::SLOTS; s++) {
+                uint8_t fingerprint = cuckoo.slot(bucket, s);
+                sf::Color fill = fingerprint == 0 ? EMPTY_FILL : Config::NODE_DEFAULT_FILL;
+                if (candidate && fingerprint != 0 && fingerprint == markedFingerprint) {
+                    fill = lastAction == LastAction::INSERT ? Config::NODE_NEW_FILL : Config::NODE_FOUND_FILL;
+                }
+                slotBox.setFillColor(fill);
+                slotBox.setOutlineThickness(candidate ? 2 : 0);
+                slotBox.setOutlineColor(Config::NODE_HIGHLIGHT_FILL);
+                slotBox.setPosition(x + 2, CUCKOO_Y + s * SLOT_HEIGHT + 1);
+                window.draw(slotBox);
+                
+                if (fingerprint != 0) {
+                    std::ostringstream hex;
+                    hex << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(fingerprint);
+                    slotText.setString(hex.str());
+                    slotText.setFillColor(Config::TEXT_COLOR);
+                    sf::FloatRect bounds = slotText.getLocalBounds();
+                    slotText.setOrigin(bounds.left + bounds.width / 2, bounds.top + bounds.height / 2);
+                    slotText.setPosition(x + SLOT_WIDTH / 2, CUCKOO_Y + s * SLOT_HEIGHT + SLOT_HEIGHT / 2);
+                    window.draw(slotText);
+                }
+            }
+            
+            slotText.setString(std::to_string(bucket));
+            slotText.setFillColor(candidate ? Config::NODE_HIGHLIGHT_FILL : Config::TEXT_SECONDARY);
+            sf::FloatRect bounds = slotText.getLocalBounds();
+            slotText.setOrigin(bounds.left + bounds.width / 2, 0);
+            slotText.setPosition(x + SLOT_WIDTH / 2, CUCKOO_Y + CuckooFilter<uint8_t>::SLOTS * SLOT_HEIGHT + 4);
+            window.draw(slotText);
+        }
+        
+        std::ostringstream cuckooStats;
+        cuckooStats << std::fixed << std::setprecision(0) << cuckoo.size() << " of "
+                    << cuckoo.capacity() << " slots used (" << 100.0 * cuckoo.loadFactor() << "% load)";
+        if (cuckoo.isFull()) cuckooStats << " - full, one fingerprint stashed";
+        if (lastAction != LastAction::NONE) {
+            std::ostringstream hex;
+            hex << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(markedFingerprint);
+            cuckooStats << "\nKey " << lastKey << ": fingerprint " << hex.str()
+                        << ", buckets " << firstBucket << " and " << secondBucket;
+        }
+        stats.setString(cuckooStats.str());
+        stats.setPosition(CUCKOO_X, CUCKOO_Y + CuckooFilter<uint8_t>::SLOTS * SLOT_HEIGHT + 24);
+        window.draw(stats);
+        
+        // Ground truth
+        std::ostringstream truth;
+        truth << "Inserted keys (" << inserted.size() << "):";
+        int shown = 0;
+        for (int key : inserted) {
+            if (shown % 16 == 0) truth << "\n";
+            if (shown == 96) {
+                truth << "...";
+                break;
+            }
+            truth << key << "  ";
+            shown++;
+        }
+        stats.setString(truth.str());
+        stats.setPosition(CUCKOO_X, CUCKOO_Y + CuckooFilter<uint8_t>::SLOTS * SLOT_HEIGHT + 70);
+        window.draw(stats);
+        
+        drawMemoryHud(window, font);
+        messageBox.draw(window);
+        window.display();
+    }
+}
+
+// ============================================================================
+// STREAM SKETCH MODE
+// Loads (memory-maps) an int32 file or generates a Zipf stream, sketches it
+// in parallel and shows the count-min counters as a heat map and the
+// HyperLogLog registers as a histogram, next to exact hash-map counts.
+// ============================================================================
+void runSketchMode(sf::RenderWindow& window, sf::Font& font) {
+    const uint32_t SKETCH_WIDTH = 768;      // One pixel column per counter
+    const int SKETCH_DEPTH = 4;
+    const int PRECISION = 10;
+    const double PHI = 0.005;               // Heavy hitter: >= 0.5% of the stream
+    const float MAP_X = Config::TREE_AREA_X;
+    const float MAP_Y = Config::TREE_AREA_Y;
+    const float ROW_HEIGHT = 28.0f;
+    const float HISTOGRAM_Y = MAP_Y + SKETCH_DEPTH * ROW_HEIGHT + 110;
+    const float HISTOGRAM_HEIGHT = 150.0f;
+    const sf::Color EMPTY_FILL(45, 45, 58);
+    
+    StreamSketch sketch(SKETCH_WIDTH, SKETCH_DEPTH, PRECISION);
+    std::unordered_map<int, uint64_t> exact;
+    bool loaded = false;
+    
+    // GUI Layout
+    float panelX = Config::CONTROL_PANEL_PADDING;
+    float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
+    float buttonHeight = 32.0f;
+    float spacing = 8.0f;
+    float currentY = Config::CONTROL_PANEL_PADDING;
+    
+    // Title
+    sf::Text titleText;
+    titleText.setFont(font);
+    titleText.setString("Stream Sketches");
+    titleText.setCharacterSize(Config::TITLE_FONT_SIZE);
+    titleText.setFillColor(Config::TEXT_COLOR);
+    titleText.setStyle(sf::Text::Bold);
+    titleText.setPosition(panelX, currentY);
+    currentY += 30;
+    
+    sf::Text pathLabel;
+    pathLabel.setFont(font);
+    pathLabel.setString("File (int32 or .txt trace):");
+    pathLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    pathLabel.setFillColor(Config::TEXT_SECONDARY);
+    pathLabel.setPosition(panelX, currentY);
+    currentY += 18;
+    
+    TextInput pathInput(panelX, currentY, controlWidth, 32, "stream.bin", font, false);
+    currentY += 40;
+    
+    Button loadBtn(panelX, currentY, controlWidth, buttonHeight, "Load File", font);
+    currentY += buttonHeight + spacing;
+    
+    Button generateBtn(panelX, currentY, controlWidth, buttonHeight, "Generate Zipf (1M)", font);
+    currentY += buttonHeight + spacing + 6;
+    
+    sf::Text keyLabel;
+    keyLabel.setFont(font);
+    keyLabel.setString("Key:");
+    keyLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    keyLabel.setFillColor(Config::TEXT_SECONDARY);
+    keyLabel.setPosition(panelX, currentY);
+    currentY += 18;
+    
+    TextInput keyInput(panelX, currentY, controlWidth, 32, "Enter key...", font, true);
+    currentY += 40;
+    
+    Button estimateBtn(panelX, currentY, controlWidth, buttonHeight, "Estimate Count", font);
+    currentY += buttonHeight + spacing;
+    
+    Button clearBtn(panelX, currentY, controlWidth, buttonHeight, "Clear", font);
+    currentY += buttonHeight + spacing + 10;
+    
+    // Export button
+    Button exportBtn(panelX, currentY, controlWidth, buttonHeight, "Export PNG", font);
+    currentY += buttonHeight + spacing;
+    
+    // Back button
+    Button backBtn(panelX, currentY, controlWidth, buttonHeight, "<< Back to Menu", font);
+    currentY += buttonHeight + spacing + 10;
+    
+    sf::Text resultText;
+    resultText.setFont(font);
+    resultText.setString("");
+    resultText.setCharacterSize(10);
+    resultText.setFillColor(Config::TEXT_COLOR);
+    resultText.setPosition(panelX, currentY);
+    
+    // Message box for feedback
+    MessageBox messageBox(panelX, Config::WINDOW_HEIGHT - 55, controlWidth, font);
+    
+    // Control panel background
+    sf::RectangleShape controlPanel;
+    controlPanel.setPosition(0, 0);
+    controlPanel.setSize(sf::Vector2f(Config::CONTROL_PANEL_WIDTH, Config::WINDOW_HEIGHT));
+    controlPanel.setFillColor(Config::CONTROL_PANEL_COLOR);
+    
+    // Summary of the last ingest (drawn under the heat map)
+    sf::Text summaryText;
+    summaryText.setFont(font);
+    summaryText.setCharacterSize(11);
+    summaryText.setFillColor(Config::TEXT_SECONDARY);
+    summaryText.setPosition(MAP_X, MAP_Y + SKETCH_DEPTH * ROW_HEIGHT + 10);
+    
+    sf::Text hittersText;
+    hittersText.setFont(font);
+    hittersText.setCharacterSize(11);
+    hittersText.setFillColor(Config::TEXT_SECONDARY);
+    hittersText.setPosition(MAP_X, HISTOGRAM_Y + HISTOGRAM_HEIGHT + 40);
+    
+    // Counter columns of the last estimated key
+    std::vector<uint32_t> markedColumns;
+    
+    auto ingestFile = [&](const std::string& path) {
+        MappedIntFile file;
+        std::string error;
+        if (!file.open(path, error)) {
+            messageBox.show("Error: " + error, MessageBox::ERROR_MSG, 4.0f);
+            return;
+        }
+        
+        sf::Clock timer;
+        sketch.ingest(file.data(), file.size(), PHI, TaskPool::shared());
+        float sketchMs = timer.restart().asSeconds() * 1000.0f;
+        
+        exact.clear();
+        for (size_t i = 0; i < file.size(); i++) {
+            exact[file.data()[i]]++;
+        }
+        float exactMs = timer.restart().asSeconds() * 1000.0f;
+        
+        loaded = true;
+        markedColumns.clear();
+        resultText.setString("");
+        
+        double distinctEstimate = sketch.getDistinct().estimate();
+        std::ostringstream summary;
+        summary << std::fixed << std::setprecision(1)
+                << file.size() << " values (" << (file.isMapped() ? "memory-mapped" : "parsed") << ")   "
+                << "sketch ingest " << sketchMs << " ms on " << TaskPool::shared().size() << " thread(s), "
+                << "exact hash map " << exactMs << " ms\n"
+                << "Distinct: HyperLogLog " << std::setprecision(0) << distinctEstimate
+                << ", exact " << exact.size() << std::setprecision(2) << " ("
+                << (exact.empty() ? 0.0 : 100.0 * (distinctEstimate - exact.size()) / exact.size())
+                << "% error, expected +/-" << 100.0 * sketch.getDistinct().standardError() << "%)   "
+                << "sketch memory " << std::setprecision(1)
+                << (sketch.getCounts().sizeInBytes() + sketch.getDistinct().getRegisterCount()) / 1024.0 << " KB";
+        summaryText.setString(summary.str());
+        
+        std::ostringstream hitters;
+        hitters << "Heavy hitters (>= " << std::setprecision(1) << 100.0 * PHI << "% of the stream): "
+                << sketch.getHeavyHitters().size() << "\n"
+                << "         key     estimate        exact    overcount\n";
+        for (size_t i = 0; i < sketch.getHeavyHitters().size() && i < 8; i++) {
+            const HeavyHitter& hitter = sketch.getHeavyHitters()[i];
+            uint64_t truth = exact.count(hitter.key) ? exact.at(hitter.key) : 0;
+            hitters << std::setw(12) << hitter.key << std::setw(13) << hitter.estimate
+                    << std::setw(13) << truth << std::setw(13) << hitter.estimate - truth << "\n";
+        }
+        hittersText.setString(hitters.str());
+        messageBox.show("Sketched " + std::to_string(file.size()) + " values", MessageBox::SUCCESS, 2.0f);
+    };
+    
+    sf::Clock clock;
+    bool running = true;
+    
+    while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
+        float deltaTime = clock.restart().asSeconds();
+        
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                running = false;
+            }
+            
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                running = false;
+            }
+            
+            pathInput.handleEvent(event, window);
+            keyInput.handleEvent(event, window);
+            
+            if (backBtn.handleEvent(event, window)) {
+                running = false;
+            }
+            
+            // LOAD a file
+            if (loadBtn.handleEvent(event, window)) {
+                ingestFile(pathInput.isEmpty() ? "stream.bin" : pathInput.getText());
+            }
+            
+            // GENERATE a Zipf stream, write it out and load it back through the mapping
+            if (generateBtn.handleEvent(event, window)) {
+                std::string path = pathInput.isEmpty() ? "stream.bin" : pathInput.getText();
+                std::vector<int> values;
+                StreamSketch::generateZipf(1000000, 100000, 1.1, 7, values);
+                std::string error;
+                if (MappedIntFile::write(path, values, error)) {
+                    ingestFile(path);
+                } else {
+                    messageBox.show("Error: " + error, MessageBox::ERROR_MSG, 4.0f);
+                }
+            }
+            
+            // ESTIMATE one key's count
+            if (estimateBtn.handleEvent(event, window)) {
+                int key;
+                if (!loaded) {
+                    messageBox.show("Load or generate a stream first.", MessageBox::INFO, 2.0f);
+                } else if (keyInput.isEmpty() || !keyInput.getAsInt(key)) {
+                    messageBox.show("Error: Enter a valid integer key!", MessageBox::ERROR_MSG, 3.0f);
+                } else {
+                    sketch.getCounts().cells(key, markedColumns);
+                    uint64_t estimate = sketch.getCounts().estimate(key);
+                    uint64_t truth = exact.count(key) ? exact.at(key) : 0;
+                    std::ostringstream ss;
+                    ss << "Key " << key << "\nestimate " << estimate << "\nexact    " << truth
+                       << "\novercount " << estimate - truth << "\n(min of the " << SKETCH_DEPTH
+                       << " marked cells)";
+                    resultText.setString(ss.str());
+                    keyInput.clear();
+                }
+            }
+            
+            // CLEAR
+            if (clearBtn.handleEvent(event, window)) {
+                sketch = StreamSketch(SKETCH_WIDTH, SKETCH_DEPTH, PRECISION);
+                exact.clear();
+                loaded = false;
+                markedColumns.clear();
+                resultText.setString("");
+                summaryText.setString("");
+                hittersText.setString("");
+                messageBox.show("Sketches cleared!", MessageBox::INFO, 2.0f);
+            }
+            
+            // EXPORT PNG
+            if (exportBtn.handleEvent(event, window)) {
+                window.display();
+                if (exportVisualizationToPNG(window, "sketch_export.png",
+                                              Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
+                                              Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
+                    messageBox.show("Exported to sketch_export.png", MessageBox::SUCCESS, 3.0f);
+                } else {
+                    messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
+                }
+            }
+        }
+        
+        // Update
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        pathInput.update(deltaTime);
+        keyInput.update(deltaTime);
+        messageBox.update(deltaTime);
+        
+        // Draw
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
+        window.clear(Config::BACKGROUND_COLOR);
+        window.draw(controlPanel);
+        window.draw(titleText);
+        window.draw(pathLabel);
+        window.draw(keyLabel);
+        window.draw(resultText);
+        pathInput.draw(window);
+        keyInput.draw(window);
+        loadBtn.draw(window);
+        generateBtn.draw(window);
+        estimateBtn.draw(window);
+        clearBtn.draw(window);
+        exportBtn.draw(window);
+        backBtn.draw(window);
+        
+        sf::RectangleShape area;
+        area.setPosition(Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 10);
+        area.setSize(sf::Vector2f(Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 20));
+        area.setFillColor(Config::TREE_AREA_COLOR);
+        area.setOutlineThickness(1);
+        area.setOutlineColor(sf::Color(60, 60, 70));
+        window.draw(area);
+        
+        sf::Text caption;
+        caption.setFont(font);
+        caption.setCharacterSize(Config::TITLE_FONT_SIZE);
+        caption.setFillColor(Config::TEXT_SECONDARY);
+        
+        // Count-min heat map: one vertical line per counter, log color scale
+        const CountMinSketch& counts = sketch.getCounts();
+        caption.setString("Count-min sketch (" + std::to_string(SKETCH_DEPTH) + " x " +
+                          std::to_string(SKETCH_WIDTH) + " counters, log scale)");
+        caption.setPosition(MAP_X, MAP_Y - 35);
+        window.draw(caption);
+        
+        double logMax = std::log1p(static_cast<double>(std::max<uint32_t>(1, counts.maxCounter())));
+        std::vector<sf::Vertex> heat;
+        heat.reserve(static_cast<size_t>(SKETCH_WIDTH) * SKETCH_DEPTH * 2);
+        for (int row = 0; row < SKETCH_DEPTH; row++) {
+            float top = MAP_Y + row * ROW_HEIGHT;
+            for (uint32_t col = 0; col < SKETCH_WIDTH; col++) {
+                float t = static_cast<float>(std::log1p(static_cast<double>(counts.counter(row, col))) / logMax);
+                // Dark -> steel blue -> yellow as the counter grows
+                const sf::Color& low = t < 0.5f ? EMPTY_FILL : Config::NODE_DEFAULT_FILL;
+                const sf::Color& high = t < 0.5f ? Config::NODE_DEFAULT_FILL : Config::NODE_HIGHLIGHT_FILL;
+                float u = t < 0.5f ? t * 2 : (t - 0.5f) * 2;
+                sf::Color color(static_cast<sf::Uint8>(low.r + (high.r - low.r) * u),
+                                static_cast<sf::Uint8>(low.g + (high.g - low.g) * u),
+                                static_cast<sf::Uint8>(low.b + (high.b - low.b) * u));
+                heat.push_back(sf::Vertex(sf::Vector2f(MAP_X + col + 0.5f, top + 1), color));
+                heat.push_back(sf::Vertex(sf::Vector2f(MAP_X + col + 0.5f, top + ROW_HEIGHT - 1), color));
+            }
+        }
+        window.draw(heat.data(), heat.size(), sf::Lines);
+        
+        // The estimated key's cell in every row
+        sf::RectangleShape marker(sf::Vector2f(5, ROW_HEIGHT));
+        marker.setFillColor(sf::Color::Transparent);
+        marker.setOutlineThickness(1);
+        marker.setOutlineColor(Config::NODE_DELETE_FILL);
+        for (size_t row = 0; row < markedColumns.size(); row++) {
+            marker.setPosition(MAP_X + markedColumns[row] - 2.0f, MAP_Y + row * ROW_HEIGHT);
+            window.draw(marker);
+        }
+        
+        window.draw(summaryText);
+        
+        // HyperLogLog register histogram
+        std::vector<size_t> histogram;
+        sketch.getDistinct().histogram(histogram);
+        caption.setString("HyperLogLog: " + std::to_string(sketch.getDistinct().getRegisterCount()) +
+                          " registers by value (leading zeros + 1)");
+        caption.setPosition(MAP_X, HISTOGRAM_Y - 35);
+        window.draw(caption);
+        
+        size_t tallest = std::max<size_t>(1, *std::max_element(histogram.begin(), histogram.end()));
+        float barWidth = 28.0f;
+        sf::RectangleShape bar;
+        bar.setFillColor(Config::NODE_DEFAULT_FILL);
+        sf::Text barLabel;
+        barLabel.setFont(font);
+        barLabel.setCharacterSize(10);
+        barLabel.setFillColor(Config::TEXT_SECONDARY);
+        for (size_t value = 0; value < histogram.size(); value++) {
+            float height = HISTOGRAM_HEIGHT * histogram[value] / tallest;
+            float x = MAP_X + value * barWidth;
+            bar.setSize(sf::Vector2f(barWidth - 4, height));
+            bar.setPosition(x + 2, HISTOGRAM_Y + HISTOGRAM_HEIGHT - height);
+            window.draw(bar);
+            
+            barLabel.setString(std::to_string(value));
+            sf::FloatRect bounds = barLabel.getLocalBounds();
+            barLabel.setPosition(x + (barWidth - bounds.width) / 2, HISTOGRAM_Y + HISTOGRAM_HEIGHT + 4);
+            window.draw(barLabel);
+            
+            if (histogram[value] > 0) {
+                barLabel.setString(std::to_string(histogram[value]));
+                bounds = barLabel.getLocalBounds();
+                barLabel.setPosition(x + (barWidth - bounds.width) / 2, HISTOGRAM_Y + HISTOGRAM_HEIGHT - height - 14);
+                window.draw(barLabel);
+            }
+        }
+        
+        window.draw(hittersText);
+        
+        if (!loaded) {
+            sf::Text emptyText;
+            emptyText.setFont(font);
+            emptyText.setString("No stream loaded\nLoad an int32 file or generate a Zipf stream");
+            emptyText.setCharacterSize(16);
+            emptyText.setFillColor(sf::Color(120, 120, 130));
+            emptyText.setPosition(MAP_X + 200, HISTOGRAM_Y + HISTOGRAM_HEIGHT + 60);
+            window.draw(emptyText);
+        }
+        
+        drawMemoryHud(window, font);
+        messageBox.draw(window);
+        window.display();
+    }
+}
+
+// ============================================================================
+// SCAPEGOAT TREE MODE
+// Inserts are shown in the shape a plain BST insert leaves; when the new
+// node is too deep, the scapegoat's subtree turns red and then collapses
+// into its rebuilt, perfectly balanced form in one glide.
+// ============================================================================
+void runScapegoatMode(sf::RenderWindow& window, sf::Font& font) {
+    const double ALPHAS[] = {0.55, 2.0 / 3.0, 0.75, 0.9};
+    const int ALPHA_COUNT = 4;
+    int alphaIndex = 1;
+
+    ScapegoatTree tree(ALPHAS[alphaIndex]);
+    ScapegoatAdapter adapter(tree);     // For the invariant HUD
+    InvariantHudState invariantHud;
+    TreeCanvas canvas(Config::TREE_AREA_X, Config::TREE_AREA_Y,
+                      Config::TREE_AREA_WIDTH, Config::TREE_AREA_HEIGHT,
+                      "Scapegoat Tree (no balance data in the nodes)", font);
+
+    auto describe = [](Node* node, std::string& label, std::string& /*detail*/) {
+        label = std::to_string(node->value);
+    };
+
+    // GUI Layout
+    float panelX = Config::CONTROL_PANEL_PADDING;
+    float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
+    float buttonHeight = 32.0f;
+    float spacing = 8.0f;
+    float currentY = Config::CONTROL_PANEL_PADDING;
+
+    // Title
+    sf::Text titleText;
+    titleText.setFont(font);
+    titleText.setString("Scapegoat Tree");
+    titleText.setCharacterSize(Config::TITLE_FONT_SIZE);
+    titleText.setFillColor(Config::TEXT_COLOR);
+    titleText.setStyle(sf::Text::Bold);
+    titleText.setPosition(panelX, currentY);
+    currentY += 30;
+
+    // Value input
+    sf::Text inputLabel;
+    inputLabel.setFont(font);
+    inputLabel.setString("Value:");
+    inputLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    inputLabel.setFillColor(Config::TEXT_SECONDARY);
+    inputLabel.setPosition(panelX, currentY);
+    currentY += 18;
+
+    TextInput valueInput(panelX, currentY, controlWidth, 32, "Enter value...", font, true);
+    currentY += 40;
+
+    // Operation buttons
+    Button insertBtn(panelX, currentY, controlWidth, buttonHeight, "Insert", font);
+    currentY += buttonHeight + spacing;
+
+    Button deleteBtn(panelX, currentY, controlWidth, buttonHeight, "Delete", font);
+    currentY += buttonHeight + spacing;
+
+    Button searchBtn(panelX, currentY, controlWidth, buttonHeight, "Search", font);
+    currentY += buttonHeight + spacing;
+
+    Button ascendingBtn(panelX, currentY, controlWidth, buttonHeight, "Insert Next 10 Ascending", font);
+    currentY += buttonHeight + spacing;
+
+    Button alphaBtn(panelX, currentY, controlWidth, buttonHeight, "", font);
+    currentY += buttonHeight + spacing;
+
+    Button clearBtn(panelX, currentY, controlWidth, buttonHeight, "Clear All", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Speed slider
+    Slider speedSlider(panelX, currentY, controlWidth,
+                       Config::MIN_ANIMATION_SPEED, Config::MAX_ANIMATION_SPEED,
+                       Config::DEFAULT_ANIMATION_SPEED, "Animation Speed", font);
+    currentY += 45;
+
+    // Export button
+    Button exportBtn(panelX, currentY, controlWidth, buttonHeight, "Export PNG", font);
+    currentY += buttonHeight + spacing;
+
+    // Back button
+    Button backBtn(panelX, currentY, controlWidth, buttonHeight, "<< Back to Menu", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Legend and statistics
+    sf::Text legendText;
+    legendText.setFont(font);
+    legendText.setString("Yellow: path   Green: new node\nRed: scapegoat subtree being rebuilt");
+    legendText.setCharacterSize(10);
+    legendText.setFillColor(Config::TEXT_SECONDARY);
+    legendText.setPosition(panelX, currentY);
+    currentY += 32;
+
+    sf::Text statsText;
+    statsText.setFont(font);
+    statsText.setCharacterSize(10);
+    statsText.setFillColor(Config::TEXT_COLOR);
+    statsText.setPosition(panelX, currentY);
+
+    // Message box for feedback
+    MessageBox messageBox(panelX, Config::WINDOW_HEIGHT - 55, controlWidth, font);
+
+    // Control panel background
+    sf::RectangleShape controlPanel;
+    controlPanel.setPosition(0, 0);
+    controlPanel.setSize(sf::Vector2f(Config::CONTROL_PANEL_WIDTH, Config::WINDOW_HEIGHT));
+    controlPanel.setFillColor(Config::CONTROL_PANEL_COLOR);
+
+    auto refreshStats = [&]() {
+        std::ostringstream alpha;
+        alpha << "Alpha: " << std::fixed << std::setprecision(2) << tree.getAlpha() << " (click to change)";
+        alphaBtn.setText(alpha.str());
+
+        std::ostringstream ss;
+        ss << "Nodes: " << tree.size() << "   Height: " << tree.getHeight()
+           << "\nDepth limit log_1/a(n): " << tree.getDepthLimit()
+           << "\nRebuilds: " << tree.getRebuildCount()
+           << " (" << tree.getRebuiltNodeCount() << " nodes moved)";
+        statsText.setString(ss.str());
+    };
+
+    // Red scapegoat subtree; the step is queued twice so it stays on screen
+    // for a moment before the rebuild
+    auto queueScapegoat = [&]() {
+        if (!tree.hasPendingRebuild()) return;
+        canvas.queueStep(tree.pendingScapegoat()->id, Config::NODE_DELETE_FILL, true);
+        canvas.queueStep(tree.pendingScapegoat()->id, Config::NODE_DELETE_FILL, true);
+    };
+
+    int nextAscending = 1;
+    refreshStats();
+    sf::Clock clock;
+    bool running = true;
+
+    while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
+        float deltaTime = clock.restart().asSeconds();
+        canvas.setSpeed(speedSlider.getValue());
+
+        // The collapse-and-rebuild step: once the red subtree has been shown,
+        // rebuild it and let the nodes glide into the balanced layout
+        if (!canvas.isAnimating() && tree.hasPendingRebuild()) {
+            tree.rebuildPending();
+            canvas.resetColors();
+            canvas.setTree(tree.getRoot(), describe);
+            refreshStats();
+        }
+
+        // Disable buttons during animation
+        bool canInteract = !canvas.isAnimating() && !tree.hasPendingRebuild();
+        insertBtn.setEnabled(canInteract);
+        deleteBtn.setEnabled(canInteract);
+        searchBtn.setEnabled(canInteract);
+        ascendingBtn.setEnabled(canInteract);
+        alphaBtn.setEnabled(canInteract);
+        clearBtn.setEnabled(canInteract);
+        exportBtn.setEnabled(canInteract);
+
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                running = false;
+            }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                running = false;
+            }
+
+            valueInput.handleEvent(event, window);
+            speedSlider.handleEvent(event, window);
+
+            if (backBtn.handleEvent(event, window)) {
+                running = false;
+            }
+
+            // INSERT operation
+            if (insertBtn.handleEvent(event, window)) {
+                int value;
+                if (valueInput.isEmpty() || !valueInput.getAsInt(value)) {
+                    messageBox.show("Error: Enter a valid integer!", MessageBox::ERROR_MSG, 3.0f);
+                } else {
+                    std::vector<Node*> path;
+                    canvas.resetColors();
+                    if (tree.insert(value, path, true)) {
+                        canvas.setTree(tree.getRoot(), describe);
+                        for (size_t i = 0; i + 1 < path.size(); i++) {
+                            canvas.queueStep(path[i]->id, TreeCanvas::VISITED_FILL);
+                        }
+                        canvas.queueStep(path.back()->id, Config::NODE_NEW_FILL);
+                        queueScapegoat();
+                        messageBox.show(tree.hasPendingRebuild()
+                                            ? "Inserted " + std::to_string(value) + " - too deep, rebuilding"
+                                            : "Inserted: " + std::to_string(value),
+                                        MessageBox::SUCCESS, 2.0f);
+                    } else {
+                        for (Node* node : path) {
+                            canvas.queueStep(node->id, TreeCanvas::VISITED_FILL);
+                        }
+                        messageBox.show("Error: " + std::to_string(value) + " already exists!",
+                                        MessageBox::ERROR_MSG, 3.0f);
+                    }
+                    refreshStats();
+                    valueInput.clear();
+                }
+            }
+
+            // DELETE operation
+            if (deleteBtn.handleEvent(event, window)) {
+                int value;
+                if (valueInput.isEmpty() || !valueInput.getAsInt(value)) {
+                    messageBox.show("Error: Enter a valid integer!", MessageBox::ERROR_MSG, 3.0f);
+                } else {
+                    std::vector<int> pathIds;
+                    bool removed = tree.remove(value, pathIds, true);
+                    canvas.resetColors();
+                    canvas.setTree(tree.getRoot(), describe);
+                    for (int id : pathIds) {
+                        canvas.queueStep(id, TreeCanvas::VISITED_FILL);
+                    }
+                    queueScapegoat();
+                    if (removed) {
+                        messageBox.show(tree.hasPendingRebuild()
+                                            ? "Deleted " + std::to_string(value) + " - tree shrank, rebuilding"
+                                            : "Deleted: " + std::to_string(value),
+                                        MessageBox::SUCCESS, 2.0f);
+                    } else {
+                        messageBox.show("Error: " + std::to_string(value) + " not found!",
+                                        MessageBox::ERROR_MSG, 3.0f);
+                    }
+                    refreshStats();
+                    valueInput.clear();
+                }
+            }
+
+            // SEARCH operation
+            if (searchBtn.handleEvent(event, window)) {
+                int value;
+                if (valueInput.isEmpty() || !valueInput.getAsInt(value)) {
+                    messageBox.show("Error: Enter a valid integer!", MessageBox::ERROR_MSG, 3.0f);
+                } else {
+                    std::vector<Node*> path;
+                    Node* found = tree.search(value, path);
+                    canvas.resetColors();
+                    for (Node* node : path) {
+                        canvas.queueStep(node->id, node == found ? Config::NODE_FOUND_FILL
+                                                                 : TreeCanvas::VISITED_FILL);
+                    }
+                    messageBox.show(found ? "Found: " + std::to_string(value)
+                                          : std::to_string(value) + " not found",
+                                    found ? MessageBox::SUCCESS : MessageBox::INFO, 2.0f);
+                }
+            }
+
+            // ASCENDING inserts - the worst case for a plain BST; here they
+            // trigger a rebuild every few inserts (applied immediately)
+            if (ascendingBtn.handleEvent(event, window)) {
+                long long before = tree.getRebuildCount();
+                std::vector<Node*> path;
+                int added = 0;
+                for (int i = 0; i < 10; i++) {
+                    path.clear();
+                    if (tree.insert(nextAscending++, path)) added++;
+                }
+                canvas.resetColors();
+                canvas.setTree(tree.getRoot(), describe);
+                refreshStats();
+                messageBox.show("Inserted " + std::to_string(added) + " values, " +
+                                std::to_string(tree.getRebuildCount() - before) + " rebuild(s)",
+                                MessageBox::SUCCESS, 2.0f);
+            }
+
+            // ALPHA: smaller = stricter balance, more frequent rebuilds
+            if (alphaBtn.handleEvent(event, window)) {
+                alphaIndex = (alphaIndex + 1) % ALPHA_COUNT;
+                tree.setAlpha(ALPHAS[alphaIndex]);
+                refreshStats();
+            }
+
+            // CLEAR operation
+            if (clearBtn.handleEvent(event, window)) {
+                if (!tree.isEmpty()) {
+                    tree.clear();
+                    nextAscending = 1;
+                    canvas.setTree(tree.getRoot(), describe);
+                    refreshStats();
+                    messageBox.show("Tree cleared!", MessageBox::INFO, 2.0f);
+                } else {
+                    messageBox.show("Tree is already empty.", MessageBox::INFO, 2.0f);
+                }
+            }
+
+            // EXPORT PNG
+            if (exportBtn.handleEvent(event, window)) {
+                if (tree.isEmpty()) {
+                    messageBox.show("Cannot export empty tree!", MessageBox::ERROR_MSG, 2.0f);
+                } else {
+                    window.display();
+                    if (exportVisualizationToPNG(window, "scapegoat_export.png",
+                                                  Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
+                                                  Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
+                        messageBox.show("Exported to scapegoat_export.png", MessageBox::SUCCESS, 3.0f);
+                    } else {
+                        messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
+                    }
+                }
+            }
+        }
+
+        // Update
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        valueInput.update(deltaTime);
+        canvas.update(deltaTime);
+        messageBox.update(deltaTime);
+
+        // Draw
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
+        window.clear(Config::BACKGROUND_COLOR);
+        window.draw(controlPanel);
+        window.draw(titleText);
+        window.draw(inputLabel);
+        window.draw(legendText);
+        window.draw(statsText);
+        valueInput.draw(window);
+        insertBtn.draw(window);
+        deleteBtn.draw(window);
+        searchBtn.draw(window);
+        ascendingBtn.draw(window);
+        alphaBtn.draw(window);
+        clearBtn.draw(window);
+        speedSlider.draw(window);
+        exportBtn.draw(window);
+        backBtn.draw(window);
+        canvas.draw(window);
+        drawInvariantHud(window, font, adapter, invariantHud);
+        drawMemoryHud(window, font);
+        messageBox.draw(window);
+        window.display();
+    }
+}
+
+// ============================================================================
+// ROPE MODE
+// The canvas shows the top levels of the chunk tree: internal nodes carry
+// their subtree's byte count, leaves their chunk size and whether the bytes
+// still live in the mapped file ("map") or in an edited copy ("own").
+// Deeper levels are folded into their ancestor, which shows the hidden
+// height instead. Each edit lights up the path to the edited offset.
+// ============================================================================
+
+void runRopeMode(sf::RenderWindow& window, sf::Font& font) {
+    const int VIEW_LEVELS = 6;
+    const float PREVIEW_HEIGHT = 90.0f;
+
+    Rope rope;
+    TreeCanvas canvas(Config::TREE_AREA_X, Config::TREE_AREA_Y,
+                      Config::TREE_AREA_WIDTH, Config::TREE_AREA_HEIGHT - PREVIEW_HEIGHT,
+                      "Rope (leaves of up to 4 KB)", font);
+
+    // Folded view of the top levels; ids are the rope's node ids so the
+    // boxes glide when an edit restructures the tree
+    struct ViewNode {
+        int id;
+        int value;
+        ViewNode* left;
+        ViewNode* right;
+        const RopeNode* source;
+        int level;
+    };
+    std::vector<ViewNode> viewNodes;
+
+    auto formatBytes = [](size_t bytes) {
+        std::ostringstream ss;
+        if (bytes >= (1u << 30)) ss << std::fixed << std::setprecision(1) << bytes / double(1u << 30) << "G";
+        else if (bytes >= (1u << 20)) ss << std::fixed << std::setprecision(1) << bytes / double(1u << 20) << "M";
+        else if (bytes >= 10240) ss << bytes / 1024 << "K";
+        else ss << bytes;
+        return ss.str();
+    };
+
+    auto showTree = [&]() {
+        // Breadth-first into a reserved array, so parents come first and
+        // pointers into it stay valid
+        viewNodes.clear();
+        viewNodes.reserve((1u << VIEW_LEVELS) - 1);
+        if (rope.getRoot()) viewNodes.push_back({rope.getRoot()->id, 0, nullptr, nullptr, rope.getRoot(), 0});
+        for (size_t i = 0; i < viewNodes.size(); i++) {
+            ViewNode& view = viewNodes[i];
+            if (view.source->isLeaf() || view.level + 1 == VIEW_LEVELS) continue;
+            const RopeNode* left = view.source->left;
+            const RopeNode* right = view.source->right;
+            viewNodes.push_back({left->id, 0, nullptr, nullptr, left, view.level + 1});
+            view.left = &viewNodes.back();
+            viewNodes.push_back({right->id, 0, nullptr, nullptr, right, view.level + 1});
+            view.right = &viewNodes.back();
+        }
+        canvas.setTree(viewNodes.empty() ? static_cast<ViewNode*>(nullptr) : &viewNodes[0],
+                       [&](ViewNode* view, std::string& label, std::string& detail) {
+                           const RopeNode* node = view->source;
+                           label = formatBytes(node->length);
+                           if (node->isLeaf()) {
+                               detail = node->mapped ? "map" : "own";
+                           } else if (!view->left) {
+                               detail = "+" + std::to_string(node->height - 1) + " lvls";
+                           }
+                       });
+    };
+
+    // GUI Layout
+    float panelX = Config::CONTROL_PANEL_PADDING;
+    float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
+    float halfWidth = (controlWidth - 10) / 2;
+    float buttonHeight = 32.0f;
+    float spacing = 8.0f;
+    float currentY = Config::CONTROL_PANEL_PADDING;
+
+    // Title
+    sf::Text titleText;
+    titleText.setFont(font);
+    titleText.setString("Rope");
+    titleText.setCharacterSize(Config::TITLE_FONT_SIZE);
+    titleText.setFillColor(Config::TEXT_COLOR);
+    titleText.setStyle(sf::Text::Bold);
+    titleText.setPosition(panelX, currentY);
+    currentY += 30;
+
+    // Text to insert
+    sf::Text textLabel;
+    textLabel.setFont(font);
+    textLabel.setString("Text:");
+    textLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    textLabel.setFillColor(Config::TEXT_SECONDARY);
+    textLabel.setPosition(panelX, currentY);
+    currentY += 18;
+
+    TextInput textInput(panelX, currentY, controlWidth, 32, "Text to insert...", font, false);
+    currentY += 40;
+
+    // Offset and length
+    sf::Text positionLabel;
+    positionLabel.setFont(font);
+    positionLabel.setString("Position:        Count:");
+    positionLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    positionLabel.setFillColor(Config::TEXT_SECONDARY);
+    positionLabel.setPosition(panelX, currentY);
+    currentY += 18;
+
+    TextInput positionInput(panelX, currentY, halfWidth, 32, "0", font, true);
+    TextInput countInput(panelX + halfWidth + 10, currentY, halfWidth, 32, "1", font, true);
+    currentY += 40;
+
+    // Operation buttons
+    Button insertBtn(panelX, currentY, controlWidth, buttonHeight, "Insert at Position", font);
+    currentY += buttonHeight + spacing;
+
+    Button deleteBtn(panelX, currentY, controlWidth, buttonHeight, "Delete Count Bytes", font);
+    currentY += buttonHeight + spacing;
+
+    Button swapBtn(panelX, currentY, controlWidth, buttonHeight, "Split & Swap Halves", font);
+    currentY += buttonHeight + spacing;
+
+    // File loading
+    sf::Text pathLabel;
+    pathLabel.setFont(font);
+    pathLabel.setString("File (memory-mapped):");
+    pathLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    pathLabel.setFillColor(Config::TEXT_SECONDARY);
+    pathLabel.setPosition(panelX, currentY);
+    currentY += 18;
+
+    TextInput pathInput(panelX, currentY, controlWidth, 32, "document.txt", font, false);
+    currentY += 40;
+
+    Button loadBtn(panelX, currentY, halfWidth, buttonHeight, "Load File", font);
+    Button saveBtn(panelX + halfWidth + 10, currentY, halfWidth, buttonHeight, "Save As", font);
+    currentY += buttonHeight + spacing;
+
+    Button sampleBtn(panelX, currentY, halfWidth, buttonHeight, "Sample", font);
+    Button clearBtn(panelX + halfWidth + 10, currentY, halfWidth, buttonHeight, "Clear", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Speed slider
+    Slider speedSlider(panelX, currentY, controlWidth,
+                       Config::MIN_ANIMATION_SPEED, Config::MAX_ANIMATION_SPEED,
+                       Config::DEFAULT_ANIMATION_SPEED, "Animation Speed", font);
+    currentY += 45;
+
+    // Export button
+    Button exportBtn(panelX, currentY, controlWidth, buttonHeight, "Export PNG", font);
+    currentY += buttonHeight + spacing;
+
+    // Back button
+    Button backBtn(panelX, currentY, controlWidth, buttonHeight, "<< Back to Menu", font);
+    currentY += buttonHeight + spacing + 10;
+
+    sf::Text statsText;
+    statsText.setFont(font);
+    statsText.setCharacterSize(10);
+    statsText.setFillColor(Config::TEXT_COLOR);
+    statsText.setPosition(panelX, currentY);
+
+    // Text around the last edit, below the tree
+    float previewY = Config::TREE_AREA_Y + Config::TREE_AREA_HEIGHT - PREVIEW_HEIGHT + 10;
+    sf::RectangleShape previewBox;
+    previewBox.setPosition(Config::TREE_AREA_X, previewY);
+    previewBox.setSize(sf::Vector2f(Config::TREE_AREA_WIDTH, PREVIEW_HEIGHT - 10));
+    previewBox.setFillColor(Config::TREE_AREA_COLOR);
+
+    sf::Text previewText;
+    previewText.setFont(font);
+    previewText.setCharacterSize(11);
+    previewText.setFillColor(Config::TEXT_SECONDARY);
+    previewText.setPosition(Config::TREE_AREA_X + 8, previewY + 6);
+
+    // Message box for feedback
+    MessageBox messageBox(panelX, Config::WINDOW_HEIGHT - 55, controlWidth, font);
+
+    // Control panel background
+    sf::RectangleShape controlPanel;
+    controlPanel.setPosition(0, 0);
+    controlPanel.setSize(sf::Vector2f(Config::CONTROL_PANEL_WIDTH, Config::WINDOW_HEIGHT));
+    controlPanel.setFillColor(Config::CONTROL_PANEL_COLOR);
+
+    size_t previewAt = 0;
+
+    auto refresh = [&]() {
+        showTree();
+
+        std::ostringstream ss;
+        ss << "Length: " << rope.length() << " bytes"
+           << "\nLeaves: " << rope.leafCount() << "   Height: " << rope.getHeight()
+           << (rope.usesMappedFile() ? "\nBacked by a mapped file" : "");
+        statsText.setString(ss.str());
+
+        // Three lines of about 110 characters starting a little before the edit
+        const size_t LINE = 110;
+        size_t from = previewAt > LINE / 2 ? previewAt - LINE / 2 : 0;
+        std::string snippet = rope.substr(from, 3 * LINE);
+        for (char& c : snippet) {
+            if (c < 32 || c > 126) c = ' ';
+        }
+        std::string wrapped = "Offset " + std::to_string(from) + ":\n";
+        for (size_t i = 0; i < snippet.size(); i += LINE) {
+            wrapped += snippet.substr(i, LINE) + "\n";
+        }
+        previewText.setString(rope.isEmpty() ? "(empty)" : wrapped);
+    };
+
+    // Light up the shown part of the path to 'pos'; the last node gets 'fill'
+    auto queuePath = [&](size_t pos, const sf::Color& fill) {
+        const RopeNode* node = rope.getRoot();
+        for (int level = 0; node && level < VIEW_LEVELS; level++) {
+            bool last = node->isLeaf() || level + 1 == VIEW_LEVELS;
+            canvas.queueStep(node->id, last ? fill : TreeCanvas::VISITED_FILL);
+            if (last) break;
+            if (pos < node->left->length) {
+                node = node->left;
+            } else {
+                pos -= node->left->length;
+                node = node->right;
+            }
+        }
+    };
+
+    // Position input, clamped to the document
+    auto readPosition = [&](size_t& pos) {
+        int value = 0;
+        if (positionInput.isEmpty()) {
+            pos = 0;
+            return true;
+        }
+        if (!positionInput.getAsInt(value) || value < 0) return false;
+        pos = std::min(static_cast<size_t>(value), rope.length());
+        return true;
+    };
+
+    refresh();
+    sf::Clock clock;
+    bool running = true;
+
+    while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
+        float deltaTime = clock.restart().asSeconds();
+        canvas.setSpeed(speedSlider.getValue());
+
+        // Disable buttons during animation
+        bool canInteract = !canvas.isAnimating();
+        insertBtn.setEnabled(canInteract);
+        deleteBtn.setEnabled(canInteract);
+        swapBtn.setEnabled(canInteract);
+        loadBtn.setEnabled(canInteract);
+        saveBtn.setEnabled(canInteract);
+        sampleBtn.setEnabled(canInteract);
+        clearBtn.setEnabled(canInteract);
+        exportBtn.setEnabled(canInteract);
+
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                running = false;
+            }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                running = false;
+            }
+
+            textInput.handleEvent(event, window);
+            positionInput.handleEvent(event, window);
+            countInput.handleEvent(event, window);
+            pathInput.handleEvent(event, window);
+            speedSlider.handleEvent(event, window);
+
+            if (backBtn.handleEvent(event, window)) {
+                running = false;
+            }
+
+            // INSERT operation
+            if (insertBtn.handleEvent(event, window)) {
+                size_t pos;
+                if (textInput.isEmpty()) {
+                    messageBox.show("Error: Enter some text!", MessageBox::ERROR_MSG, 3.0f);
+                } else if (!readPosition(pos)) {
+                    messageBox.show("Error: Enter a valid position!", MessageBox::ERROR_MSG, 3.0f);
+                } else {
+                    std::string text = textInput.getText();
+                    rope.insert(pos, text);
+                    previewAt = pos;
+                    canvas.resetColors();
+                    refresh();
+                    queuePath(pos, Config::NODE_NEW_FILL);
+                    messageBox.show("Inserted " + std::to_string(text.size()) + " bytes at " +
+                                    std::to_string(pos), MessageBox::SUCCESS, 2.0f);
+                    textInput.clear();
+                }
+            }
+
+            // DELETE operation
+            if (deleteBtn.handleEvent(event, window)) {
+                size_t pos;
+                int count = 1;
+                if (!readPosition(pos) || (!countInput.isEmpty() && !countInput.getAsInt(count)) ||
+                    count <= 0) {
+                    messageBox.show("Error: Enter a valid position and count!", MessageBox::ERROR_MSG, 3.0f);
+                } else if (pos >= rope.length()) {
+                    messageBox.show("Error: Position is past the end!", MessageBox::ERROR_MSG, 3.0f);
+                } else {
+                    size_t removed = std::min(static_cast<size_t>(count), rope.length() - pos);
+                    rope.erase(pos, removed);
+                    previewAt = pos;
+                    canvas.resetColors();
+                    refresh();
+                    queuePath(pos, Config::NODE_DELETE_FILL);
+                    messageBox.show("Deleted " + std::to_string(removed) + " bytes", MessageBox::SUCCESS, 2.0f);
+                }
+            }
+
+            // SPLIT at the position, then join the halves the other way round
+            if (swapBtn.handleEvent(event, window)) {
+                size_t pos;
+                if (rope.isEmpty()) {
+                    messageBox.show("Rope is empty.", MessageBox::INFO, 2.0f);
+                } else if (!readPosition(pos)) {
+                    messageBox.show("Error: Enter a valid position!", MessageBox::ERROR_MSG, 3.0f);
+                } else {
+                    Rope tail = rope.split(pos);
+                    tail.concat(rope);
+                    rope = std::move(tail);
+                    previewAt = rope.length() - pos;
+                    canvas.resetColors();
+                    refresh();
+                    queuePath(previewAt, Config::NODE_NEW_FILL);
+                    messageBox.show("Swapped at " + std::to_string(pos), MessageBox::SUCCESS, 2.0f);
+                }
+            }
+
+            // LOAD: the file is mapped, not read; leaves point into it
+            if (loadBtn.handleEvent(event, window)) {
+                std::string error;
+                if (pathInput.isEmpty()) {
+                    messageBox.show("Error: Enter a file path!", MessageBox::ERROR_MSG, 3.0f);
+                } else if (rope.loadFile(pathInput.getText(), error)) {
+                    previewAt = 0;
+                    canvas.resetColors();
+                    refresh();
+                    messageBox.show("Mapped " + formatBytes(rope.length()) + " bytes",
+                                    MessageBox::SUCCESS, 2.0f);
+                } else {
+                    messageBox.show("Error: " + error, MessageBox::ERROR_MSG, 3.0f);
+                }
+            }
+
+            // SAVE writes the leaves in order
+            if (saveBtn.handleEvent(event, window)) {
+                std::string error;
+                if (pathInput.isEmpty()) {
+                    messageBox.show("Error: Enter a file path!", MessageBox::ERROR_MSG, 3.0f);
+                } else if (rope.saveFile(pathInput.getText(), error)) {
+                    messageBox.show("Saved " + formatBytes(rope.length()) + " bytes",
+                                    MessageBox::SUCCESS, 2.0f);
+                } else {
+                    messageBox.show("Error: " + error, MessageBox::ERROR_MSG, 3.0f);
+                }
+            }
+
+            // SAMPLE: about 256 KB of numbered lines, enough for a few levels
+            if (sampleBtn.handleEvent(event, window)) {
+                std::string text;
+                for (int line = 1; text.size() < (256u << 10); line++) {
+                    text += "Line " + std::to_string(line) +
+                            ": the quick brown fox jumps over the lazy dog.\n";
+                }
+                rope = Rope(text);
+                previewAt = 0;
+                canvas.resetColors();
+                refresh();
+                messageBox.show("Loaded " + formatBytes(rope.length()) + " bytes of sample text",
+                                MessageBox::SUCCESS, 2.0f);
+            }
+
+            // CLEAR operation
+            if (clearBtn.handleEvent(event, window)) {
+                if (!rope.isEmpty()) {
+                    rope.clear();
+                    previewAt = 0;
+                    refresh();
+                    messageBox.show("Rope cleared!", MessageBox::INFO, 2.0f);
+                } else {
+                    messageBox.show("Rope is already empty.", MessageBox::INFO, 2.0f);
+                }
+            }
+
+            // EXPORT PNG
+            if (exportBtn.handleEvent(event, window)) {
+                if (rope.isEmpty()) {
+                    messageBox.show("Cannot export empty rope!", MessageBox::ERROR_MSG, 2.0f);
+                } else {
+                    window.display();
+                    if (exportVisualizationToPNG(window, "rope_export.png",
+                                                  Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
+                                                  Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
+                        messageBox.show("Exported to rope_export.png", MessageBox::SUCCESS, 3.0f);
+                    } else {
+                        messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
+                    }
+                }
+            }
+        }
+
+        // Update
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        textInput.update(deltaTime);
+        positionInput.update(deltaTime);
+        countInput.update(deltaTime);
+        pathInput.update(deltaTime);
+        canvas.update(deltaTime);
+        messageBox.update(deltaTime);
+
+        // Draw
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
+        window.clear(Config::BACKGROUND_COLOR);
+        window.draw(controlPanel);
+        window.draw(titleText);
+        window.draw(textLabel);
+        window.draw(positionLabel);
+        window.draw(pathLabel);
+        window.draw(statsText);
+        textInput.draw(window);
+        positionInput.draw(window);
+        countInput.draw(window);
+        pathInput.draw(window);
+        insertBtn.draw(window);
+        deleteBtn.draw(window);
+        swapBtn.draw(window);
+        loadBtn.draw(window);
+        saveBtn.draw(window);
+        sampleBtn.draw(window);
+        clearBtn.draw(window);
+        speedSlider.draw(window);
+        exportBtn.draw(window);
+        backBtn.draw(window);
+        canvas.draw(window);
+        window.draw(previewBox);
+        window.draw(previewText);
+        drawMemoryHud(window, font);
+        messageBox.draw(window);
+        window.display();
+    }
+}
+
+// ============================================================================
+// SLIDING WINDOW MODE
+// Steps through an integer stream one value at a time. The top row is the
+// stream with the current window outlined; below it the min and max deques
+// (front on the left). Entries a new value dominates rise out of the back
+// in red, entries that slid out of the window leave the front in gray.
+// ============================================================================
+void runWindowMode(sf::RenderWindow& window, sf::Font& font) {
+    const int MAX_WIDTH = 14;
+    const int VISIBLE = 16;                 // Stream cells shown
+    const float CELL = 44.0f;
+    const float CELL_GAP = 6.0f;
+    const float ROW_X = Config::TREE_AREA_X + 10;
+    const float STREAM_Y = Config::TREE_AREA_Y + 20;
+    const float MIN_ROW_Y = Config::TREE_AREA_Y + 150;
+    const float MAX_ROW_Y = Config::TREE_AREA_Y + 270;
+    const float PLOT_Y = Config::TREE_AREA_Y + 380;
+    const float PLOT_HEIGHT = 200.0f;
+    const size_t PLOT_POINTS = 160;
+    const size_t FILE_LIMIT = 1000000;      // Values kept from a loaded file
+
+    std::vector<int> stream;
+    SlidingWindow slider(4);
+    std::vector<SlidingWindow::Eviction> evictions;
+    std::vector<int> minHistory, maxHistory;
+    long long expiredCount = 0;
+    long long dominatedCount = 0;
+
+    // Drawn deque entries glide to their slot; evicted ones fade out
+    std::unordered_map<uint64_t, sf::Vector2f> minPositions, maxPositions;
+    struct Ghost {
+        SlidingWindow::Eviction eviction;
+        sf::Vector2f start;
+        float age;
+    };
+    std::vector<Ghost> ghosts;
+
+    // GUI Layout
+    float panelX = Config::CONTROL_PANEL_PADDING;
+    float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
+    float halfWidth = (controlWidth - 10) / 2;
+    float buttonHeight = 32.0f;
+    float spacing = 8.0f;
+    float currentY = Config::CONTROL_PANEL_PADDING;
+
+    // Title
+    sf::Text titleText;
+    titleText.setFont(font);
+    titleText.setString("Sliding Window");
+    titleText.setCharacterSize(Config::TITLE_FONT_SIZE);
+    titleText.setFillColor(Config::TEXT_COLOR);
+    titleText.setStyle(sf::Text::Bold);
+    titleText.setPosition(panelX, currentY);
+    currentY += 30;
+
+    // Window width
+    sf::Text widthLabel;
+    widthLabel.setFont(font);
+    widthLabel.setString("Window width (1-" + std::to_string(MAX_WIDTH) + "):");
+    widthLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    widthLabel.setFillColor(Config::TEXT_SECONDARY);
+    widthLabel.setPosition(panelX, currentY);
+    currentY += 18;
+
+    TextInput widthInput(panelX, currentY, halfWidth, 32, "4", font, true);
+    Button restartBtn(panelX + halfWidth + 10, currentY, halfWidth, 32, "Restart", font);
+    currentY += 40;
+
+    // Stepping
+    Button stepBtn(panelX, currentY, halfWidth, buttonHeight, "Step", font);
+    Button playBtn(panelX + halfWidth + 10, currentY, halfWidth, buttonHeight, "Play", font);
+    currentY += buttonHeight + spacing;
+
+    Button randomBtn(panelX, currentY, controlWidth, buttonHeight, "Random Stream", font);
+    currentY += buttonHeight + spacing;
+
+    // File loading
+    sf::Text pathLabel;
+    pathLabel.setFont(font);
+    pathLabel.setString("File (int32 or .txt trace):");
+    pathLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    pathLabel.setFillColor(Config::TEXT_SECONDARY);
+    pathLabel.setPosition(panelX, currentY);
+    currentY += 18;
+
+    TextInput pathInput(panelX, currentY, controlWidth, 32, "stream.bin", font, false);
+    currentY += 40;
+
+    Button loadBtn(panelX, currentY, controlWidth, buttonHeight, "Load File", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Speed slider
+    Slider speedSlider(panelX, currentY, controlWidth,
+                       Config::MIN_ANIMATION_SPEED, Config::MAX_ANIMATION_SPEED,
+                       Config::DEFAULT_ANIMATION_SPEED, "Animation Speed", font);
+    currentY += 45;
+
+    // Export button
+    Button exportBtn(panelX, currentY, controlWidth, buttonHeight, "Export PNG", font);
+    currentY += buttonHeight + spacing;
+
+    // Back button
+    Button backBtn(panelX, currentY, controlWidth, buttonHeight, "<< Back to Menu", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Legend and statistics
+    sf::Text legendText;
+    legendText.setFont(font);
+    legendText.setString("Red: dominated by the new value\nGray: slid out of the window");
+    legendText.setCharacterSize(10);
+    legendText.setFillColor(Config::TEXT_SECONDARY);
+    legendText.setPosition(panelX, currentY);
+    currentY += 32;
+
+    sf::Text statsText;
+    statsText.setFont(font);
+    statsText.setCharacterSize(10);
+    statsText.setFillColor(Config::TEXT_COLOR);
+    statsText.setPosition(panelX, currentY);
+
+    // Message box for feedback
+    MessageBox messageBox(panelX, Config::WINDOW_HEIGHT - 55, controlWidth, font);
+
+    // Control panel background
+    sf::RectangleShape controlPanel;
+    controlPanel.setPosition(0, 0);
+    controlPanel.setSize(sf::Vector2f(Config::CONTROL_PANEL_WIDTH, Config::WINDOW_HEIGHT));
+    controlPanel.setFillColor(Config::CONTROL_PANEL_COLOR);
+
+    auto slotX = [&](size_t slot) { return ROW_X + slot * (CELL + CELL_GAP); };
+
+    // Stream cell of 'index' (the newest value is the rightmost cell)
+    auto streamCellX = [&](uint64_t index) {
+        uint64_t first = slider.getPushed() > VISIBLE ? slider.getPushed() - VISIBLE : 0;
+        return slotX(static_cast<size_t>(index - first));
+    };
+
+    auto refreshStats = [&]() {
+        std::ostringstream ss;
+        ss << "Stream: " << stream.size() << " values, at " << slider.getPushed()
+           << "\nWidth: " << slider.getWidth();
+        if (slider.getPushed() > 0) {
+            ss << "   Min: " << slider.getMin() << "   Max: " << slider.getMax();
+        }
+        ss << "\nDeques: min " << slider.minDequeSize() << ", max " << slider.maxDequeSize()
+           << "\nEvicted: " << dominatedCount << " dominated, " << expiredCount << " expired";
+        if (slider.getPushed() > 0) {
+            ss << std::fixed << std::setprecision(2) << "\n(" << (dominatedCount + expiredCount) /
+                  static_cast<double>(slider.getPushed()) << " per value, at most 2)";
+        }
+        statsText.setString(ss.str());
+    };
+
+    auto restart = [&]() {
+        int width = 4;
+        if (!widthInput.isEmpty() && widthInput.getAsInt(width)) {
+            width = std::max(1, std::min(width, MAX_WIDTH));
+        }
+        slider.reset(static_cast<size_t>(width));
+        minHistory.clear();
+        maxHistory.clear();
+        minPositions.clear();
+        maxPositions.clear();
+        ghosts.clear();
+        expiredCount = dominatedCount = 0;
+        refreshStats();
+    };
+
+    // Random walk in 0..99 so the values fit the cells
+    unsigned int randomSeed = 1;
+    auto randomStream = [&]() {
+        stream.assign(500, 0);
+        int level = 50;
+        for (int& value : stream) {
+            randomSeed = randomSeed * 1103515245u + 12345u;
+            level = std::max(0, std::min(99, level + static_cast<int>((randomSeed >> 16) % 25) - 12));
+            value = level;
+        }
+    };
+
+    // Push the next value and start the eviction animation
+    auto stepOnce = [&]() {
+        if (slider.getPushed() >= stream.size()) return false;
+        uint64_t index = slider.getPushed();
+        evictions.clear();
+        slider.push(stream[static_cast<size_t>(index)], &evictions);
+        minHistory.push_back(slider.getMin());
+        maxHistory.push_back(slider.getMax());
+
+        for (const SlidingWindow::Eviction& eviction : evictions) {
+            auto& positions = eviction.fromMax ? maxPositions : minPositions;
+            auto found = positions.find(eviction.entry.index);
+            sf::Vector2f start = found != positions.end() ? found->second
+                                                          : sf::Vector2f(slotX(0), eviction.fromMax ? MAX_ROW_Y : MIN_ROW_Y);
+            if (found != positions.end()) positions.erase(found);
+            ghosts.push_back({eviction, start, 0.0f});
+            (eviction.expired ? expiredCount : dominatedCount)++;
+        }
+
+        // The new value drops from its stream cell into both deques
+        minPositions[index] = sf::Vector2f(streamCellX(index), STREAM_Y);
+        maxPositions[index] = sf::Vector2f(streamCellX(index), STREAM_Y);
+        refreshStats();
+        return true;
+    };
+
+    randomStream();
+    restart();
+
+    bool playing = false;
+    float playTimer = 0;
+    sf::Clock clock;
+    bool running = true;
+
+    while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
+        float deltaTime = clock.restart().asSeconds();
+        float speed = speedSlider.getValue();
+
+        // Glide deque entries toward their slots; age the ghosts
+        bool moving = false;
+        auto glide = [&](std::unordered_map<uint64_t, sf::Vector2f>& positions, bool isMax) {
+            size_t count = isMax ? slider.maxDequeSize() : slider.minDequeSize();
+            float rowY = isMax ? MAX_ROW_Y : MIN_ROW_Y;
+            for (size_t i = 0; i < count; i++) {
+                const WindowEntry& entry = isMax ? slider.maxDequeAt(i) : slider.minDequeAt(i);
+                sf::Vector2f& position = positions[entry.index];
+                sf::Vector2f target(slotX(i), rowY);
+                float blend = std::min(1.0f, deltaTime * 8.0f * speed);
+                position.x += (target.x - position.x) * blend;
+                position.y += (target.y - position.y) * blend;
+                if (std::abs(target.x - position.x) + std::abs(target.y - position.y) > 1.0f) {
+                    moving = true;
+                } else {
+                    position = target;
+                }
+            }
+        };
+        glide(minPositions, false);
+        glide(maxPositions, true);
+
+        float ghostLife = Config::DEFAULT_ANIMATION_DURATION * 1.5f;
+        for (Ghost& ghost : ghosts) ghost.age += deltaTime * speed;
+        ghosts.erase(std::remove_if(ghosts.begin(), ghosts.end(),
+                                    [&](const Ghost& ghost) { return ghost.age >= ghostLife; }),
+                     ghosts.end());
+        bool isAnimating = moving || !ghosts.empty();
+
+        if (playing && !isAnimating) {
+            playTimer += deltaTime * speed;
+            if (playTimer >= 0.3f) {
+                playTimer = 0;
+                if (!stepOnce()) {
+                    playing = false;
+                    messageBox.show("End of stream", MessageBox::INFO, 2.0f);
+                }
+            }
+        }
+        playBtn.setText(playing ? "Pause" : "Play");
+
+        bool canInteract = !isAnimating && !playing;
+        stepBtn.setEnabled(canInteract);
+        restartBtn.setEnabled(canInteract);
+        randomBtn.setEnabled(canInteract);
+        loadBtn.setEnabled(canInteract);
+        exportBtn.setEnabled(canInteract);
+
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                running = false;
+            }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                running = false;
+            }
+
+            widthInput.handleEvent(event, window);
+            pathInput.handleEvent(event, window);
+            speedSlider.handleEvent(event, window);
+
+            if (backBtn.handleEvent(event, window)) {
+                running = false;
+            }
+
+            if (stepBtn.handleEvent(event, window) && canInteract) {
+                if (!stepOnce()) {
+                    messageBox.show("End of stream - press Restart", MessageBox::INFO, 2.0f);
+                }
+            }
+
+            if (playBtn.handleEvent(event, window)) {
+                playing = !playing;
+                playTimer = 0;
+            }
+
+            // RESTART with the width from the input
+            if (restartBtn.handleEvent(event, window) && canInteract) {
+                restart();
+                messageBox.show("Window width " + std::to_string(slider.getWidth()), MessageBox::INFO, 2.0f);
+            }
+
+            if (randomBtn.handleEvent(event, window) && canInteract) {
+                randomStream();
+                restart();
+                messageBox.show("Random walk of 500 values", MessageBox::SUCCESS, 2.0f);
+            }
+
+            // LOAD a stream file (the first FILE_LIMIT values are stepped through)
+            if (loadBtn.handleEvent(event, window) && canInteract) {
+                MappedIntFile file;
+                std::string error;
+                if (pathInput.isEmpty()) {
+                    messageBox.show("Error: Enter a file path!", MessageBox::ERROR_MSG, 3.0f);
+                } else if (!file.open(pathInput.getText(), error)) {
+                    messageBox.show("Error: " + error, MessageBox::ERROR_MSG, 4.0f);
+                } else if (file.size() == 0) {
+                    messageBox.show("Error: File has no values!", MessageBox::ERROR_MSG, 3.0f);
+                } else {
+                    size_t count = std::min(file.size(), FILE_LIMIT);
+                    stream.assign(file.data(), file.data() + count);
+                    restart();
+                    messageBox.show("Loaded " + std::to_string(count) + " of " +
+                                    std::to_string(file.size()) + " values", MessageBox::SUCCESS, 2.0f);
+                }
+            }
+
+            // EXPORT PNG
+            if (exportBtn.handleEvent(event, window) && canInteract) {
+                window.display();
+                if (exportVisualizationToPNG(window, "window_export.png",
+                                              Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
+                                              Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
+                    messageBox.show("Exported to window_export.png", MessageBox::SUCCESS, 3.0f);
+                } else {
+                    messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
+                }
+            }
+        }
+
+        // Update
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        widthInput.update(deltaTime);
+        pathInput.update(deltaTime);
+        messageBox.update(deltaTime);
+
+        // Draw
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
+        window.clear(Config::BACKGROUND_COLOR);
+        window.draw(controlPanel);
+        window.draw(titleText);
+        window.draw(widthLabel);
+        window.draw(pathLabel);
+        window.draw(legendText);
+        window.draw(statsText);
+        widthInput.draw(window);
+        restartBtn.draw(window);
+        stepBtn.draw(window);
+        playBtn.draw(window);
+        randomBtn.draw(window);
+        pathInput.draw(window);
+        loadBtn.draw(window);
+        speedSlider.draw(window);
+        exportBtn.draw(window);
+        backBtn.draw(window);
+
+        sf::RectangleShape area;
+        area.setPosition(Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 10);
+        area.setSize(sf::Vector2f(Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 20));
+        area.setFillColor(Config::TREE_AREA_COLOR);
+        window.draw(area);
+
+        sf::Text areaTitle;
+        areaTitle.setFont(font);
+        areaTitle.setString("Sliding Window Min / Max (monotonic deques)");
+        areaTitle.setCharacterSize(Config::TITLE_FONT_SIZE);
+        areaTitle.setFillColor(Config::TEXT_SECONDARY);
+        areaTitle.setPosition(Config::TREE_AREA_X, Config::TREE_AREA_Y - 35);
+        window.draw(areaTitle);
+
+        auto drawCell = [&](float x, float y, int value, const std::string& caption,
+                            sf::Color fill, sf::Color outline) {
+            sf::RectangleShape box(sf::Vector2f(CELL, CELL));
+            box.setPosition(x, y);
+            box.setFillColor(fill);
+            box.setOutlineColor(outline);
+            box.setOutlineThickness(2);
+            window.draw(box);
+
+            sf::Text valueText;
+            valueText.setFont(font);
+            valueText.setString(std::to_string(value));
+            valueText.setCharacterSize(14);
+            valueText.setFillColor(sf::Color(255, 255, 255, outline.a));
+            sf::FloatRect bounds = valueText.getLocalBounds();
+            valueText.setOrigin(bounds.left + bounds.width / 2, bounds.top + bounds.height / 2);
+            valueText.setPosition(x + CELL / 2, y + CELL / 2);
+            window.draw(valueText);
+
+            if (!caption.empty()) {
+                sf::Text captionText;
+                captionText.setFont(font);
+                captionText.setString(caption);
+                captionText.setCharacterSize(9);
+                captionText.setFillColor(Config::TEXT_SECONDARY);
+                captionText.setPosition(x + 2, y + CELL + 3);
+                window.draw(captionText);
+            }
+        };
+
+        auto drawLabel = [&](const std::string& text, float y) {
+            sf::Text label;
+            label.setFont(font);
+            label.setString(text);
+            label.setCharacterSize(12);
+            label.setFillColor(Config::TEXT_SECONDARY);
+            label.setPosition(ROW_X, y - 22);
+            window.draw(label);
+        };
+
+        // Stream row: the last VISIBLE values, window outlined
+        uint64_t pushed = slider.getPushed();
+        uint64_t first = pushed > VISIBLE ? pushed - VISIBLE : 0;
+        drawLabel("Stream (newest on the right)", STREAM_Y);
+        for (uint64_t index = first; index < pushed; index++) {
+            bool inWindow = index + slider.getWidth() >= pushed;
+            bool newest = index + 1 == pushed;
+            drawCell(streamCellX(index), STREAM_Y, stream[static_cast<size_t>(index)], "#" + std::to_string(index),
+                     newest ? Config::NODE_NEW_FILL : inWindow ? Config::NODE_DEFAULT_FILL : Config::BUTTON_IDLE,
+                     newest ? Config::NODE_NEW_OUTLINE : Config::NODE_DEFAULT_OUTLINE);
+        }
+        if (pushed > 0) {
+            uint64_t windowStart = pushed > slider.getWidth() ? pushed - slider.getWidth() : 0;
+            windowStart = std::max(windowStart, first);
+            float left = streamCellX(windowStart) - 4;
+            float right = streamCellX(pushed - 1) + CELL + 4;
+            sf::RectangleShape bracket(sf::Vector2f(right - left, CELL + 26));
+            bracket.setPosition(left, STREAM_Y - 4);
+            bracket.setFillColor(sf::Color::Transparent);
+            bracket.setOutlineColor(Config::NODE_HIGHLIGHT_FILL);
+            bracket.setOutlineThickness(2);
+            window.draw(bracket);
+        } else {
+            sf::Text emptyText;
+            emptyText.setFont(font);
+            emptyText.setString("Press Step or Play to feed the window");
+            emptyText.setCharacterSize(14);
+            emptyText.setFillColor(sf::Color(120, 120, 130));
+            emptyText.setPosition(ROW_X, STREAM_Y + 10);
+            window.draw(emptyText);
+        }
+
+        // Deques (front = current extreme)
+        drawLabel("Min deque (increasing; front = window minimum)", MIN_ROW_Y);
+        for (size_t i = 0; i < slider.minDequeSize(); i++) {
+            const WindowEntry& entry = slider.minDequeAt(i);
+            const sf::Vector2f& position = minPositions[entry.index];
+            drawCell(position.x, position.y, entry.value, "#" + std::to_string(entry.index),
+                     i == 0 ? Config::NODE_FOUND_FILL : Config::QUEUE_COLOR,
+                     i == 0 ? Config::NODE_FOUND_OUTLINE : Config::QUEUE_OUTLINE);
+        }
+        drawLabel("Max deque (decreasing; front = window maximum)", MAX_ROW_Y);
+        for (size_t i = 0; i < slider.maxDequeSize(); i++) {
+            const WindowEntry& entry = slider.maxDequeAt(i);
+            const sf::Vector2f& position = maxPositions[entry.index];
+            drawCell(position.x, position.y, entry.value, "#" + std::to_string(entry.index),
+                     i == 0 ? Config::NODE_FOUND_FILL : Config::STACK_COLOR,
+                     i == 0 ? Config::NODE_FOUND_OUTLINE : Config::STACK_OUTLINE);
+        }
+
+        // Ghosts: dominated entries rise, expired ones slide off to the left
+        for (const Ghost& ghost : ghosts) {
+            float t = ghost.age / ghostLife;
+            sf::Uint8 alpha = static_cast<sf::Uint8>(255 * (1.0f - t));
+            sf::Vector2f offset = ghost.eviction.expired ? sf::Vector2f(-60 * t, 0) : sf::Vector2f(0, -40 * t);
+            sf::Color fill = ghost.eviction.expired ? sf::Color(110, 110, 120, alpha)
+                                                    : sf::Color(Config::NODE_DELETE_FILL.r, Config::NODE_DELETE_FILL.g,
+                                                                Config::NODE_DELETE_FILL.b, alpha);
+            drawCell(ghost.start.x + offset.x, ghost.start.y + offset.y, ghost.eviction.entry.value, "",
+                     fill, sf::Color(255, 255, 255, alpha));
+        }
+
+        // Plot: recent values with the min / max envelopes
+        drawLabel("Last " + std::to_string(PLOT_POINTS) + " values with window min (green) and max (orange)",
+                  PLOT_Y + 4);
+        size_t plotCount = static_cast<size_t>(std::min<uint64_t>(pushed, PLOT_POINTS));
+        if (plotCount > 0) {
+            size_t plotFirst = static_cast<size_t>(pushed) - plotCount;
+            int low = minHistory[plotFirst];
+            int high = maxHistory[plotFirst];
+            for (size_t i = plotFirst; i < static_cast<size_t>(pushed); i++) {
+                low = std::min(low, minHistory[i]);
+                high = std::max(high, maxHistory[i]);
+            }
+            float plotWidth = Config::TREE_AREA_WIDTH - 20;
+            float stepX = plotWidth / PLOT_POINTS;
+            auto plotY = [&](int value) {
+                double span = high > low ? static_cast<double>(high) - low : 1.0;
+                return PLOT_Y + PLOT_HEIGHT - static_cast<float>((value - static_cast<double>(low)) / span * PLOT_HEIGHT);
+            };
+            sf::VertexArray minLine(sf::LineStrip, plotCount);
+            sf::VertexArray maxLine(sf::LineStrip, plotCount);
+            for (size_t i = 0; i < plotCount; i++) {
+                size_t index = plotFirst + i;
+                float x = ROW_X + i * stepX;
+                minLine[i] = sf::Vertex(sf::Vector2f(x, plotY(minHistory[index])), Config::NODE_FOUND_FILL);
+                maxLine[i] = sf::Vertex(sf::Vector2f(x, plotY(maxHistory[index])), Config::STACK_COLOR);
+
+                sf::CircleShape dot(2.0f);
+                dot.setOrigin(2.0f, 2.0f);
+                dot.setPosition(x, plotY(stream[index]));
+                dot.setFillColor(Config::TEXT_SECONDARY);
+                window.draw(dot);
+            }
+            window.draw(minLine);
+            window.draw(maxLine);
+        }
+
+        drawMemoryHud(window, font);
+        messageBox.draw(window);
+        window.display();
+    }
+}
+
+// ============================================================================
+// EXTERNAL SORT MODE
+// The out-of-core pipeline at toy scale: the input is cut into chunks of
+// "memory" values, each chunk is sorted into a run, and the runs are merged
+// through a MinHeap holding one head per run. Each merge step lights the
+// heap minimum, moves it to the output and sifts the run's next value down
+// from the root in its place (the node keeps its id, so it glides).
+// ============================================================================
+void runExternalSortMode(sf::RenderWindow& window, sf::Font& font) {
+    const int MAX_VALUES = 80;
+    const int MAX_MEMORY = 20;
+    const float CELL = 30.0f;
+    const float CELL_GAP = 3.0f;
+    const float AREA_X = Config::TREE_AREA_X;
+    const float RUNS_Y = Config::TREE_AREA_Y + 20;
+    const float OUTPUT_Y = Config::TREE_AREA_Y + 440;
+    const float HEAP_X = Config::TREE_AREA_X + 420;
+    const int OUTPUT_PER_ROW = 24;
+
+    std::vector<int> input;
+    std::vector<std::vector<int>> runs;
+    std::vector<size_t> runNext;            // Next unread value of each run
+    std::vector<int> output;
+    MinHeap heap;
+    int memoryValues = 8;
+    bool runsFormed = false;
+    bool pendingOutput = false;             // Minimum shown, not yet moved
+
+    TreeCanvas canvas(HEAP_X, Config::TREE_AREA_Y + 20, Config::TREE_AREA_WIDTH - 420, 360,
+                      "MinHeap of run heads", font);
+
+    // Pointer-based view of the heap array for the canvas layout
+    struct ViewNode {
+        int id;
+        int value;
+        ViewNode* left;
+        ViewNode* right;
+        int source;
+    };
+    std::vector<ViewNode> viewNodes;
+
+    auto showHeap = [&]() {
+        std::vector<HeapNode*> nodes = heap.getAllNodes();
+        viewNodes.assign(nodes.size(), ViewNode());
+        for (size_t i = 0; i < nodes.size(); i++) {
+            viewNodes[i] = {nodes[i]->id, nodes[i]->value, nullptr, nullptr, nodes[i]->source};
+            if (2 * i + 1 < nodes.size()) viewNodes[i].left = &viewNodes[2 * i + 1];
+            if (2 * i + 2 < nodes.size()) viewNodes[i].right = &viewNodes[2 * i + 2];
+        }
+        canvas.setTree(viewNodes.empty() ? static_cast<ViewNode*>(nullptr) : &viewNodes[0],
+                       [](ViewNode* view, std::string& label, std::string& detail) {
+                           label = std::to_string(view->value);
+                           detail = "run " + std::to_string(view->source);
+                       });
+    };
+
+    // GUI Layout
+    float panelX = Config::CONTROL_PANEL_PADDING;
+    float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
+    float halfWidth = (controlWidth - 10) / 2;
+    float buttonHeight = 32.0f;
+    float spacing = 8.0f;
+    float currentY = Config::CONTROL_PANEL_PADDING;
+
+    // Title
+    sf::Text titleText;
+    titleText.setFont(font);
+    titleText.setString("External Merge Sort");
+    titleText.setCharacterSize(Config::TITLE_FONT_SIZE);
+    titleText.setFillColor(Config::TEXT_COLOR);
+    titleText.setStyle(sf::Text::Bold);
+    titleText.setPosition(panelX, currentY);
+    currentY += 30;
+
+    sf::Text inputLabel;
+    inputLabel.setFont(font);
+    inputLabel.setString("Values:            Memory:");
+    inputLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    inputLabel.setFillColor(Config::TEXT_SECONDARY);
+    inputLabel.setPosition(panelX, currentY);
+    currentY += 18;
+
+    TextInput countInput(panelX, currentY, halfWidth, 32, "40", font, true);
+    TextInput memoryInput(panelX + halfWidth + 10, currentY, halfWidth, 32, "8", font, true);
+    currentY += 40;
+
+    // Pipeline buttons
+    Button generateBtn(panelX, currentY, controlWidth, buttonHeight, "New Random Input", font);
+    currentY += buttonHeight + spacing;
+
+    Button runsBtn(panelX, currentY, controlWidth, buttonHeight, "1. Form Sorted Runs", font);
+    currentY += buttonHeight + spacing;
+
+    Button stepBtn(panelX, currentY, controlWidth, buttonHeight, "2. Merge Step", font);
+    currentY += buttonHeight + spacing;
+
+    Button playBtn(panelX, currentY, controlWidth, buttonHeight, "Merge All", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Speed slider
+    Slider speedSlider(panelX, currentY, controlWidth,
+                       Config::MIN_ANIMATION_SPEED, Config::MAX_ANIMATION_SPEED,
+                       Config::DEFAULT_ANIMATION_SPEED, "Animation Speed", font);
+    currentY += 45;
+
+    // Export button
+    Button exportBtn(panelX, currentY, controlWidth, buttonHeight, "Export PNG", font);
+    currentY += buttonHeight + spacing;
+
+    // Back button
+    Button backBtn(panelX, currentY, controlWidth, buttonHeight, "<< Back to Menu", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Legend and statistics
+    sf::Text legendText;
+    legendText.setFont(font);
+    legendText.setString("Yellow: run heads (in the heap)\nGreen: heap minimum, output next\n"
+                         "Purple: refill from the same run");
+    legendText.setCharacterSize(10);
+    legendText.setFillColor(Config::TEXT_SECONDARY);
+    legendText.setPosition(panelX, currentY);
+    currentY += 46;
+
+    sf::Text statsText;
+    statsText.setFont(font);
+    statsText.setCharacterSize(10);
+    statsText.setFillColor(Config::TEXT_COLOR);
+    statsText.setPosition(panelX, currentY);
+
+    // Message box for feedback
+    MessageBox messageBox(panelX, Config::WINDOW_HEIGHT - 55, controlWidth, font);
+
+    // Control panel background
+    sf::RectangleShape controlPanel;
+    controlPanel.setPosition(0, 0);
+    controlPanel.setSize(sf::Vector2f(Config::CONTROL_PANEL_WIDTH, Config::WINDOW_HEIGHT));
+    controlPanel.setFillColor(Config::CONTROL_PANEL_COLOR);
+
+    auto refreshStats = [&]() {
+        std::ostringstream ss;
+        ss << "Input: " << input.size() << " values, memory " << memoryValues
+           << "\nRuns: " << runs.size() << "   Heap: " << heap.getSize()
+           << "\nOutput: " << output.size() << " / " << input.size();
+        if (heap.getSize() > 1) {
+            ss << std::fixed << std::setprecision(1)
+               << "\nSift depth per output: <= " << std::floor(std::log2(heap.getSize()));
+        }
+        statsText.setString(ss.str());
+    };
+
+    auto readSettings = [&]() {
+        int count = 40;
+        if (!countInput.isEmpty() && countInput.getAsInt(count)) count = std::max(1, std::min(count, MAX_VALUES));
+        int memory = 8;
+        if (!memoryInput.isEmpty() && memoryInput.getAsInt(memory)) memory = std::max(2, std::min(memory, MAX_MEMORY));
+        memoryValues = memory;
+        return count;
+    };
+
+    unsigned int randomSeed = 7;
+    auto generate = [&]() {
+        int count = readSettings();
+        input.assign(static_cast<size_t>(count), 0);
+        for (int& value : input) {
+            randomSeed = randomSeed * 1103515245u + 12345u;
+            value = static_cast<int>((randomSeed >> 16) % 100);
+        }
+        runs.clear();
+        runNext.clear();
+        output.clear();
+        heap.clear();
+        runsFormed = false;
+        pendingOutput = false;
+        canvas.resetColors();
+        showHeap();
+        refreshStats();
+    };
+
+    // Phase 1: sort each memory-sized chunk, then load every run head
+    auto formRuns = [&]() {
+        readSettings();
+        runs.clear();
+        for (size_t first = 0; first < input.size(); first += memoryValues) {
+            size_t last = std::min(input.size(), first + static_cast<size_t>(memoryValues));
+            runs.emplace_back(input.begin() + first, input.begin() + last);
+            std::sort(runs.back().begin(), runs.back().end());
+        }
+        runNext.assign(runs.size(), 1);
+        output.clear();
+        heap.clear();
+        std::vector<int> path;
+        for (size_t r = 0; r < runs.size(); r++) {
+            path.clear();
+            heap.insert(runs[r][0], path, static_cast<int>(r));
+        }
+        runsFormed = true;
+        canvas.resetColors();
+        showHeap();
+        refreshStats();
+    };
+
+    // Phase 2, first half: light the minimum
+    auto beginStep = [&]() {
+        if (heap.isEmpty()) return false;
+        canvas.resetColors();
+        canvas.queueStep(heap.peekMin()->id, TreeCanvas::MATCH_FILL);
+        pendingOutput = true;
+        return true;
+    };
+
+    // Second half: output it and sift the run's next value down from the root
+    auto finishStep = [&]() {
+        HeapNode* top = heap.peekMin();
+        int run = top->source;
+        int movedId = top->id;
+        output.push_back(top->value);
+        std::vector<int> path;
+        if (runNext[run] < runs[run].size()) {
+            heap.replaceMin(runs[run][runNext[run]++], run, path);
+            canvas.resetColors();
+            showHeap();
+            canvas.queueStep(movedId, Config::NODE_NEW_FILL);
+        } else {
+            delete heap.extractMin(path);
+            canvas.resetColors();
+            showHeap();
+        }
+        pendingOutput = false;
+        refreshStats();
+    };
+
+    generate();
+    bool playing = false;
+    sf::Clock clock;
+    bool running = true;
+
+    while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
+        float deltaTime = clock.restart().asSeconds();
+        canvas.setSpeed(speedSlider.getValue());
+
+        if (pendingOutput && !canvas.isAnimating()) {
+            finishStep();
+        } else if (playing && !canvas.isAnimating() && !pendingOutput) {
+            if (!beginStep()) {
+                playing = false;
+                messageBox.show("Merged " + std::to_string(output.size()) + " values", MessageBox::SUCCESS, 2.0f);
+            }
+        }
+        playBtn.setText(playing ? "Pause" : "Merge All");
+
+        bool canInteract = !canvas.isAnimating() && !pendingOutput && !playing;
+        generateBtn.setEnabled(canInteract);
+        runsBtn.setEnabled(canInteract);
+        stepBtn.setEnabled(canInteract && runsFormed);
+        playBtn.setEnabled(runsFormed);
+        exportBtn.setEnabled(canInteract);
+
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                running = false;
+            }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                running = false;
+            }
+
+            countInput.handleEvent(event, window);
+            memoryInput.handleEvent(event, window);
+            speedSlider.handleEvent(event, window);
+
+            if (backBtn.handleEvent(event, window)) {
+                running = false;
+            }
+
+            if (generateBtn.handleEvent(event, window) && canInteract) {
+                generate();
+                messageBox.show("New input of " + std::to_string(input.size()) + " values", MessageBox::INFO, 2.0f);
+            }
+
+            if (runsBtn.handleEvent(event, window) && canInteract) {
+                formRuns();
+                messageBox.show(std::to_string(runs.size()) + " runs of up to " + std::to_string(memoryValues) +
+                                " values", MessageBox::SUCCESS, 2.0f);
+            }
+
+            if (stepBtn.handleEvent(event, window) && canInteract && runsFormed) {
+                if (!beginStep()) {
+                    messageBox.show("Merge complete", MessageBox::INFO, 2.0f);
+                }
+            }
+
+            if (playBtn.handleEvent(event, window) && runsFormed) {
+                playing = !playing;
+            }
+
+            // EXPORT PNG
+            if (exportBtn.handleEvent(event, window) && canInteract) {
+                window.display();
+                if (exportVisualizationToPNG(window, "external_sort_export.png",
+                                              Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
+                                              Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
+                    messageBox.show("Exported to external_sort_export.png", MessageBox::SUCCESS, 3.0f);
+                } else {
+                    messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
+                }
+            }
+        }
+
+        // Update
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        countInput.update(deltaTime);
+        memoryInput.update(deltaTime);
+        canvas.update(deltaTime);
+        messageBox.update(deltaTime);
+
+        // Draw
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
+        window.clear(Config::BACKGROUND_COLOR);
+        window.draw(controlPanel);
+        window.draw(titleText);
+        window.draw(inputLabel);
+        window.draw(legendText);
+        window.draw(statsText);
+        countInput.draw(window);
+        memoryInput.draw(window);
+        generateBtn.draw(window);
+        runsBtn.draw(window);
+        stepBtn.draw(window);
+        playBtn.draw(window);
+        speedSlider.draw(window);
+        exportBtn.draw(window);
+        backBtn.draw(window);
+
+        sf::RectangleShape area;
+        area.setPosition(Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 10);
+        area.setSize(sf::Vector2f(Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 20));
+        area.setFillColor(Config::TREE_AREA_COLOR);
+        window.draw(area);
+        canvas.draw(window);
+
+        auto drawCell = [&](float x, float y, int value, sf::Color fill) {
+            sf::RectangleShape box(sf::Vector2f(CELL, CELL));
+            box.setPosition(x, y);
+            box.setFillColor(fill);
+            box.setOutlineColor(Config::NODE_DEFAULT_OUTLINE);
+            box.setOutlineThickness(1);
+            window.draw(box);
+
+            sf::Text valueText;
+            valueText.setFont(font);
+            valueText.setString(std::to_string(value));
+            valueText.setCharacterSize(12);
+            valueText.setFillColor(Config::TEXT_COLOR);
+            sf::FloatRect bounds = valueText.getLocalBounds();
+            valueText.setOrigin(bounds.left + bounds.width / 2, bounds.top + bounds.height / 2);
+            valueText.setPosition(x + CELL / 2, y + CELL / 2);
+            window.draw(valueText);
+        };
+
+        auto drawCaption = [&](const std::string& text, float x, float y) {
+            sf::Text caption;
+            caption.setFont(font);
+            caption.setString(text);
+            caption.setCharacterSize(12);
+            caption.setFillColor(Config::TEXT_SECONDARY);
+            caption.setPosition(x, y);
+            window.draw(caption);
+        };
+
+        // Input chunks before phase 1, sorted runs after it
+        int minimumRun = pendingOutput && !heap.isEmpty() ? heap.peekMin()->source : -1;
+        if (!runsFormed) {
+            drawCaption("Input, in chunks of " + std::to_string(memoryValues) + " values (what fits in memory)",
+                        AREA_X, RUNS_Y - 20);
+            for (size_t i = 0; i < input.size(); i++) {
+                size_t chunk = i / memoryValues;
+                size_t column = i % memoryValues;
+                sf::Color fill = chunk % 2 == 0 ? Config::NODE_DEFAULT_FILL : Config::STACK_COLOR;
+                drawCell(AREA_X + 60 + column * (CELL + CELL_GAP), RUNS_Y + chunk * (CELL + 6), input[i], fill);
+            }
+        } else {
+            drawCaption("Sorted runs on disk (dim = already merged)", AREA_X, RUNS_Y - 20);
+            for (size_t r = 0; r < runs.size(); r++) {
+                float y = RUNS_Y + r * (CELL + 6);
+                drawCaption("run " + std::to_string(r), AREA_X, y + 7);
+                for (size_t i = 0; i < runs[r].size(); i++) {
+                    // runNext[r] - 1 is the value currently in the heap
+                    sf::Color fill = Config::NODE_DEFAULT_FILL;
+                    if (i + 1 < runNext[r]) fill = Config::BUTTON_IDLE;
+                    else if (i + 1 == runNext[r]) {
+                        bool inHeap = false;
+                        for (HeapNode* node : heap.getAllNodes()) {
+                            if (node->source == static_cast<int>(r)) inHeap = true;
+                        }
+                        if (!inHeap) fill = Config::BUTTON_IDLE;
+                        else fill = static_cast<int>(r) == minimumRun ? Config::NODE_FOUND_FILL
+                                                                      : Config::NODE_HIGHLIGHT_FILL;
+                    }
+                    drawCell(AREA_X + 60 + i * (CELL + CELL_GAP), y, runs[r][i], fill);
+                }
+            }
+        }
+
+        // Output, wrapped
+        drawCaption("Merged output (" + std::to_string(output.size()) + " values)", AREA_X, OUTPUT_Y - 20);
+        for (size_t i = 0; i < output.size(); i++) {
+            float x = AREA_X + (i % OUTPUT_PER_ROW) * (CELL + CELL_GAP);
+            float y = OUTPUT_Y + (i / OUTPUT_PER_ROW) * (CELL + 6);
+            drawCell(x, y, output[i], i + 1 == output.size() ? Config::NODE_FOUND_FILL : Config::QUEUE_COLOR);
+        }
+
+        drawMemoryHud(window, font);
+        messageBox.draw(window);
+        window.display();
+    }
+}
+
+// ============================================================================
+// TOP-K MODE
+// The parallel query at toy scale: the stream is split between two
+// "threads", each keeping its K largest values in a MinHeap bounded to K.
+// A step takes the next block of BLOCK values of one thread and compares
+// the whole block against that heap's minimum (the threshold) at once, as
+// the SIMD filter does. Values that pass are offered one by one, since the
+// threshold rises with every replacement. Finally the second heap's values
+// are offered to the first, which then holds the answer.
+// ============================================================================
+void runTopKMode(sf::RenderWindow& window, sf::Font& font) {
+    const int THREADS = 2;
+    const size_t BLOCK = 4;
+    const int MAX_PER_THREAD = 24;
+    const int MAX_K = 15;
+    const float CELL = 28.0f;
+    const float CELL_GAP = 3.0f;
+    const float AREA_X = Config::TREE_AREA_X;
+    const float STREAM_Y = Config::TREE_AREA_Y + 20;
+    const float HEAP_Y = Config::TREE_AREA_Y + 150;
+    const float HEAP_WIDTH = (Config::TREE_AREA_WIDTH - 20) / 2;
+    const float RESULT_Y = Config::TREE_AREA_Y + 560;
+
+    // What happened to each stream value
+    enum ValueState { UNREAD, FILTERED, KEPT, REJECTED };
+
+    struct Partition {
+        std::vector<int> values;
+        std::vector<ValueState> states;
+        size_t next;
+        MinHeap heap;
+    };
+    Partition parts[THREADS];
+
+    TreeCanvas canvas0(AREA_X, HEAP_Y, HEAP_WIDTH, 360, "Thread 0 heap", font);
+    TreeCanvas canvas1(AREA_X + HEAP_WIDTH + 20, HEAP_Y, HEAP_WIDTH, 360, "Thread 1 heap", font);
+    TreeCanvas* canvases[THREADS] = {&canvas0, &canvas1};
+
+    // Pointer-based view of a heap array for the canvas layout
+    struct ViewNode {
+        int id;
+        int value;
+        ViewNode* left;
+        ViewNode* right;
+    };
+    std::vector<ViewNode> viewNodes[THREADS];
+
+    auto showHeap = [&](int p) {
+        std::vector<HeapNode*> nodes = parts[p].heap.getAllNodes();
+        std::vector<ViewNode>& view = viewNodes[p];
+        view.assign(nodes.size(), ViewNode());
+        for (size_t i = 0; i < nodes.size(); i++) {
+            view[i] = {nodes[i]->id, nodes[i]->value, nullptr, nullptr};
+            if (2 * i + 1 < nodes.size()) view[i].left = &view[2 * i + 1];
+            if (2 * i + 2 < nodes.size()) view[i].right = &view[2 * i + 2];
+        }
+        canvases[p]->setTree(view.empty() ? static_cast<ViewNode*>(nullptr) : &view[0],
+                             [&](ViewNode* node, std::string& label, std::string& detail) {
+                                 label = std::to_string(node->value);
+                                 detail = node == &viewNodes[p][0] && !parts[p].heap.isEmpty()
+                                              ? "threshold" : "";
+                             });
+    };
+
+    size_t k = 5;
+    int turn = 0;
+    std::vector<int> mergeValues;           // Thread 1's heap, offered to thread 0's
+    size_t mergeNext = 0;
+    bool merging = false;
+    std::vector<int> result;
+    std::string lastBlock;
+
+    // GUI Layout
+    float panelX = Config::CONTROL_PANEL_PADDING;
+    float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
+    float halfWidth = (controlWidth - 10) / 2;
+    float buttonHeight = 32.0f;
+    float spacing = 8.0f;
+    float currentY = Config::CONTROL_PANEL_PADDING;
+
+    // Title
+    sf::Text titleText;
+    titleText.setFont(font);
+    titleText.setString("Parallel Top-K");
+    titleText.setCharacterSize(Config::TITLE_FONT_SIZE);
+    titleText.setFillColor(Config::TEXT_COLOR);
+    titleText.setStyle(sf::Text::Bold);
+    titleText.setPosition(panelX, currentY);
+    currentY += 30;
+
+    sf::Text inputLabel;
+    inputLabel.setFont(font);
+    inputLabel.setString("Per thread:       K:");
+    inputLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    inputLabel.setFillColor(Config::TEXT_SECONDARY);
+    inputLabel.setPosition(panelX, currentY);
+    currentY += 18;
+
+    TextInput countInput(panelX, currentY, halfWidth, 32, "24", font, true);
+    TextInput kInput(panelX + halfWidth + 10, currentY, halfWidth, 32, "5", font, true);
+    currentY += 40;
+
+    Button generateBtn(panelX, currentY, controlWidth, buttonHeight, "New Random Stream", font);
+    currentY += buttonHeight + spacing;
+
+    Button stepBtn(panelX, currentY, controlWidth, buttonHeight, "Step (one block)", font);
+    currentY += buttonHeight + spacing;
+
+    Button playBtn(panelX, currentY, controlWidth, buttonHeight, "Run All", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Speed slider
+    Slider speedSlider(panelX, currentY, controlWidth,
+                       Config::MIN_ANIMATION_SPEED, Config::MAX_ANIMATION_SPEED,
+                       Config::DEFAULT_ANIMATION_SPEED, "Animation Speed", font);
+    currentY += 45;
+
+    // Export button
+    Button exportBtn(panelX, currentY, controlWidth, buttonHeight, "Export PNG", font);
+    currentY += buttonHeight + spacing;
+
+    // Back button
+    Button backBtn(panelX, currentY, controlWidth, buttonHeight, "<< Back to Menu", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Legend and statistics
+    sf::Text legendText;
+    legendText.setFont(font);
+    legendText.setString("Gray: not above the threshold (a\n  block of them costs one compare)\n"
+                         "Green: entered the heap\nYellow: passed the block test,\n"
+                         "  then lost to a raised threshold");
+    legendText.setCharacterSize(10);
+    legendText.setFillColor(Config::TEXT_SECONDARY);
+    legendText.setPosition(panelX, currentY);
+    currentY += 72;
+
+    sf::Text statsText;
+    statsText.setFont(font);
+    statsText.setCharacterSize(10);
+    statsText.setFillColor(Config::TEXT_COLOR);
+    statsText.setPosition(panelX, currentY);
+
+    // Message box for feedback
+    MessageBox messageBox(panelX, Config::WINDOW_HEIGHT - 55, controlWidth, font);
+
+    // Control panel background
+    sf::RectangleShape controlPanel;
+    controlPanel.setPosition(0, 0);
+    controlPanel.setSize(sf::Vector2f(Config::CONTROL_PANEL_WIDTH, Config::WINDOW_HEIGHT));
+    controlPanel.setFillColor(Config::CONTROL_PANEL_COLOR);
+
+    auto refreshStats = [&]() {
+        size_t total = 0, filtered = 0, kept = 0;
+        for (const Partition& part : parts) {
+            total += part.values.size();
+            for (ValueState state : part.states) {
+                if (state == FILTERED) filtered++;
+                if (state == KEPT) kept++;
+            }
+        }
+        std::ostringstream ss;
+        ss << "K = " << k << ", " << THREADS << " threads, blocks of " << BLOCK
+           << "\nSkipped by block test: " << filtered << " / " << total
+           << "\nHeap updates: " << kept;
+        if (!lastBlock.empty()) ss << "\n" << lastBlock;
+        statsText.setString(ss.str());
+    };
+
+    unsigned int randomSeed = 11;
+    auto generate = [&]() {
+        int perThread = 24;
+        if (!countInput.isEmpty() && countInput.getAsInt(perThread)) {
+            perThread = std::max(static_cast<int>(BLOCK), std::min(perThread, MAX_PER_THREAD));
+        }
+        int kValue = 5;
+        if (!kInput.isEmpty() && kInput.getAsInt(kValue)) kValue = std::max(1, std::min(kValue, MAX_K));
+        k = static_cast<size_t>(kValue);
+
+        for (int p = 0; p < THREADS; p++) {
+            Partition& part = parts[p];
+            part.values.assign(static_cast<size_t>(perThread), 0);
+            for (int& value : part.values) {
+                randomSeed = randomSeed * 1103515245u + 12345u;
+                value = static_cast<int>((randomSeed >> 16) % 100);
+            }
+            part.states.assign(part.values.size(), UNREAD);
+            part.next = 0;
+            part.heap.clear();
+            canvases[p]->resetColors();
+            showHeap(p);
+        }
+        turn = 0;
+        mergeValues.clear();
+        mergeNext = 0;
+        merging = false;
+        result.clear();
+        lastBlock.clear();
+        refreshStats();
+    };
+
+    // Offer one value to thread p's heap; returns the id of the node it
+    // landed in, or -1 if it did not beat the threshold
+    auto offerValue = [&](int p, int value) {
+        MinHeap& heap = parts[p].heap;
+        std::vector<int> path;
+        if (static_cast<size_t>(heap.getSize()) < k) {
+            heap.insert(value, path);
+            int newest = -1;
+            for (HeapNode* node : heap.getAllNodes()) newest = std::max(newest, node->id);
+            return newest;
+        }
+        if (value <= heap.peekMin()->value) return -1;
+        int reused = heap.peekMin()->id;
+        heap.replaceMin(value, -1, path);
+        return reused;
+    };
+
+    // One step: a block of one thread, or one value of the merge
+    auto step = [&]() {
+        if (!result.empty()) return false;
+
+        if (!merging) {
+            int p = -1;
+            for (int i = 0; i < THREADS && p < 0; i++) {
+                int candidate = (turn + i) % THREADS;
+                if (parts[candidate].next < parts[candidate].values.size()) p = candidate;
+            }
+            if (p >= 0) {
+                turn = (p + 1) % THREADS;
+                Partition& part = parts[p];
+                size_t end = std::min(part.values.size(), part.next + BLOCK);
+                bool full = static_cast<size_t>(part.heap.getSize()) >= k;
+                int threshold = full ? part.heap.peekMin()->value : 0;
+
+                bool anyPass = !full;
+                for (size_t i = part.next; i < end && full; i++) {
+                    if (part.values[i] > threshold) anyPass = true;
+                }
+
+                std::vector<int> changed;
+                for (size_t i = part.next; i < end; i++) {
+                    if (!anyPass) {
+                        part.states[i] = FILTERED;
+                        continue;
+                    }
+                    int id = offerValue(p, part.values[i]);
+                    part.states[i] = id >= 0 ? KEPT : (full && part.values[i] <= threshold ? FILTERED : REJECTED);
+                    if (id >= 0) changed.push_back(id);
+                }
+                part.next = end;
+
+                canvases[p]->resetColors();
+                showHeap(p);
+                if (!anyPass) {
+                    lastBlock = "Thread " + std::to_string(p) + ": block <= " + std::to_string(threshold) + ", skipped";
+                    canvases[p]->queueStep(part.heap.peekMin()->id, TreeCanvas::VISITED_FILL);
+                } else {
+                    lastBlock = "Thread " + std::to_string(p) + ": " + std::to_string(changed.size()) + " heap update(s)";
+                    for (int id : changed) canvases[p]->queueStep(id, Config::NODE_NEW_FILL);
+                }
+                refreshStats();
+                return true;
+            }
+
+            // Every thread is done: merge the partial heaps
+            merging = true;
+            mergeValues.clear();
+            for (HeapNode* node : parts[1].heap.getAllNodes()) mergeValues.push_back(node->value);
+            mergeNext = 0;
+        }
+
+        if (mergeNext < mergeValues.size()) {
+            int value = mergeValues[mergeNext++];
+            int id = offerValue(0, value);
+            canvases[0]->resetColors();
+            showHeap(0);
+            if (id >= 0) canvases[0]->queueStep(id, Config::NODE_NEW_FILL);
+            else if (!parts[0].heap.isEmpty()) canvases[0]->queueStep(parts[0].heap.peekMin()->id, TreeCanvas::VISITED_FILL);
+            lastBlock = "Merge: offered " + std::to_string(value) + (id >= 0 ? ", kept" : ", below threshold");
+            refreshStats();
+            return true;
+        }
+
+        // Thread 0's heap is the answer
+        for (HeapNode* node : parts[0].heap.getAllNodes()) result.push_back(node->value);
+        std::sort(result.begin(), result.end(), std::greater<int>());
+        lastBlock = "Done";
+        refreshStats();
+        return true;
+    };
+
+    generate();
+    bool playing = false;
+    sf::Clock clock;
+    bool running = true;
+
+    while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
+        float deltaTime = clock.restart().asSeconds();
+        canvas0.setSpeed(speedSlider.getValue());
+        canvas1.setSpeed(speedSlider.getValue());
+        bool animating = canvas0.isAnimating() || canvas1.isAnimating();
+
+        if (playing && !animating) {
+            if (!step()) {
+                playing = false;
+                messageBox.show("Top " + std::to_string(result.size()) + " found", MessageBox::SUCCESS, 2.0f);
+            }
+        }
+        playBtn.setText(playing ? "Pause" : "Run All");
+
+        bool canInteract = !animating && !playing;
+        generateBtn.setEnabled(canInteract);
+        stepBtn.setEnabled(canInteract && result.empty());
+        playBtn.setEnabled(result.empty() || playing);
+        exportBtn.setEnabled(canInteract);
+
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                running = false;
+            }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                running = false;
+            }
+
+            countInput.handleEvent(event, window);
+            kInput.handleEvent(event, window);
+            speedSlider.handleEvent(event, window);
+
+            if (backBtn.handleEvent(event, window)) {
+                running = false;
+            }
+
+            if (generateBtn.handleEvent(event, window) && canInteract) {
+                generate();
+                messageBox.show("New stream, K = " + std::to_string(k), MessageBox::INFO, 2.0f);
+            }
+
+            if (stepBtn.handleEvent(event, window) && canInteract) {
+                step();
+                if (!result.empty()) {
+                    messageBox.show("Top " + std::to_string(result.size()) + " found", MessageBox::SUCCESS, 2.0f);
+                }
+            }
+
+            if (playBtn.handleEvent(event, window) && (result.empty() || playing)) {
+                playing = !playing;
+            }
+
+            // EXPORT PNG
+            if (exportBtn.handleEvent(event, window) && canInteract) {
+                window.display();
+                if (exportVisualizationToPNG(window, "topk_export.png",
+                                              Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
+                                              Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
+                    messageBox.show("Exported to topk_export.png", MessageBox::SUCCESS, 3.0f);
+                } else {
+                    messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
+                }
+            }
+        }
+
+        // Update
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        countInput.update(deltaTime);
+        kInput.update(deltaTime);
+        canvas0.update(deltaTime);
+        canvas1.update(deltaTime);
+        messageBox.update(deltaTime);
+
+        // Draw
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
+        window.clear(Config::BACKGROUND_COLOR);
+        window.draw(controlPanel);
+        window.draw(titleText);
+        window.draw(inputLabel);
+        window.draw(legendText);
+        window.draw(statsText);
+        countInput.draw(window);
+        kInput.draw(window);
+        generateBtn.draw(window);
+        stepBtn.draw(window);
+        playBtn.draw(window);
+        speedSlider.draw(window);
+        exportBtn.draw(window);
+        backBtn.draw(window);
+
+        sf::RectangleShape area;
+        area.setPosition(Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 10);
+        area.setSize(sf::Vector2f(Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 20));
+        area.setFillColor(Config::TREE_AREA_COLOR);
+        window.draw(area);
+        canvas0.draw(window);
+        canvas1.draw(window);
+
+        auto drawCell = [&](float x, float y, int value, sf::Color fill) {
+            sf::RectangleShape box(sf::Vector2f(CELL, CELL));
+            box.setPosition(x, y);
+            box.setFillColor(fill);
+            box.setOutlineColor(Config::NODE_DEFAULT_OUTLINE);
+            box.setOutlineThickness(1);
+            window.draw(box);
+
+            sf::Text valueText;
+            valueText.setFont(font);
+            valueText.setString(std::to_string(value));
+            valueText.setCharacterSize(12);
+            valueText.setFillColor(Config::TEXT_COLOR);
+            sf::FloatRect bounds = valueText.getLocalBounds();
+            valueText.setOrigin(bounds.left + bounds.width / 2, bounds.top + bounds.height / 2);
+            valueText.setPosition(x + CELL / 2, y + CELL / 2);
+            window.draw(valueText);
+        };
+
+        auto drawCaption = [&](const std::string& text, float x, float y) {
+            sf::Text caption;
+            caption.setFont(font);
+            caption.setString(text);
+            caption.setCharacterSize(12);
+            caption.setFillColor(Config::TEXT_SECONDARY);
+            caption.setPosition(x, y);
+            window.draw(caption);
+        };
+
+        // Stream segments; the next block of each thread is outlined
+        for (int p = 0; p < THREADS; p++) {
+            Partition& part = parts[p];
+            float y = STREAM_Y + p * (CELL + 30);
+            std::string caption = "thread " + std::to_string(p);
+            if (static_cast<size_t>(part.heap.getSize()) >= k) {
+                caption += "   threshold " + std::to_string(part.heap.peekMin()->value);
+            }
+            drawCaption(caption, AREA_X, y - 18);
+            for (size_t i = 0; i < part.values.size(); i++) {
+                sf::Color fill = Config::NODE_DEFAULT_FILL;
+                if (part.states[i] == FILTERED) fill = Config::BUTTON_IDLE;
+                else if (part.states[i] == KEPT) fill = Config::NODE_FOUND_FILL;
+                else if (part.states[i] == REJECTED) fill = Config::NODE_HIGHLIGHT_FILL;
+                drawCell(AREA_X + i * (CELL + CELL_GAP), y, part.values[i], fill);
+            }
+            if (part.next < part.values.size()) {
+                size_t count = std::min(BLOCK, part.values.size() - part.next);
+                sf::RectangleShape block(sf::Vector2f(count * (CELL + CELL_GAP) + 1, CELL + 6));
+                block.setPosition(AREA_X + part.next * (CELL + CELL_GAP) - 2, y - 3);
+                block.setFillColor(sf::Color::Transparent);
+                block.setOutlineColor(Config::TEXT_COLOR);
+                block.setOutlineThickness(2);
+                window.draw(block);
+            }
+        }
+
+        // Answer, largest first
+        if (!result.empty()) {
+            drawCaption("Top " + std::to_string(result.size()) + ", largest first", AREA_X, RESULT_Y - 18);
+            for (size_t i = 0; i < result.size(); i++) {
+                drawCell(AREA_X + i * (CELL + CELL_GAP), RESULT_Y, result[i], Config::QUEUE_COLOR);
+            }
+        } else if (merging) {
+            drawCaption("Merging: thread 1's heap values are offered to thread 0's heap (" +
+                        std::to_string(mergeNext) + " / " + std::to_string(mergeValues.size()) + ")",
+                        AREA_X, RESULT_Y - 18);
+        }
+
+        drawMemoryHud(window, font);
+        messageBox.draw(window);
+        window.display();
+    }
+}
+
+// ============================================================================
+// UNROLLED LIST MODE
+// Blocks are drawn as rows of 'capacity' cells (empty slots dimmed) linked
+// left to right. Walks highlight whole blocks, since a block's values sit
+// in one array; a split colors the new block, a merge names the absorbed one.
+// ============================================================================
+void runUnrolledListMode(sf::RenderWindow& window, sf::Font& font) {
+    const float CELL = 30.0f;
+    const float BLOCK_GAP = 34.0f;
+    const float ROW_HEIGHT = 80.0f;
+    const int MAX_VALUES = 120;
+
+    UnrolledList list(4);
+
+    // GUI Layout
+    float panelX = Config::CONTROL_PANEL_PADDING;
+    float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
+    float halfWidth = (controlWidth - 10) / 2;
+    float buttonHeight = 32.0f;
+    float spacing = 7.0f;
+    float currentY = Config::CONTROL_PANEL_PADDING;
+
+    // Title
+    sf::Text titleText;
+    titleText.setFont(font);
+    titleText.setString("Unrolled Linked List");
+    titleText.setCharacterSize(Config::TITLE_FONT_SIZE);
+    titleText.setFillColor(Config::TEXT_COLOR);
+    titleText.setStyle(sf::Text::Bold);
+    titleText.setPosition(panelX, currentY);
+    currentY += 30;
+
+    sf::Text inputLabel;
+    inputLabel.setFont(font);
+    inputLabel.setString("Value:             Index:");
+    inputLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    inputLabel.setFillColor(Config::TEXT_SECONDARY);
+    inputLabel.setPosition(panelX, currentY);
+    currentY += 18;
+
+    TextInput valueInput(panelX, currentY, halfWidth, 32, "Integer", font, true);
+    TextInput indexInput(panelX + halfWidth + 10, currentY, halfWidth, 32, "0", font, true);
+    currentY += 40;
+
+    Button insertTailBtn(panelX, currentY, halfWidth, buttonHeight, "Tail", font);
+    Button insertHeadBtn(panelX + halfWidth + 10, currentY, halfWidth, buttonHeight, "Head", font);
+    currentY += buttonHeight + spacing;
+
+    Button insertAtBtn(panelX, currentY, controlWidth, buttonHeight, "Insert at Index", font);
+    currentY += buttonHeight + spacing;
+
+    Button deleteBtn(panelX, currentY, halfWidth, buttonHeight, "Delete", font);
+    Button searchBtn(panelX + halfWidth + 10, currentY, halfWidth, buttonHeight, "Search", font);
+    currentY += buttonHeight + spacing;
+
+    Button randomBtn(panelX, currentY, halfWidth, buttonHeight, "Random", font);
+    Button clearBtn(panelX + halfWidth + 10, currentY, halfWidth, buttonHeight, "Clear", font);
+    currentY += buttonHeight + spacing + 4;
+
+    sf::Text capacityLabel;
+    capacityLabel.setFont(font);
+    capacityLabel.setString("Block capacity (2-8):");
+    capacityLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    capacityLabel.setFillColor(Config::TEXT_SECONDARY);
+    capacityLabel.setPosition(panelX, currentY);
+    currentY += 18;
+
+    TextInput capacityInput(panelX, currentY, halfWidth, 32, "4", font, true);
+    Button capacityBtn(panelX + halfWidth + 10, currentY, halfWidth, buttonHeight, "Rebuild", font);
+    currentY += 40 + 4;
+
+    // Speed slider
+    Slider speedSlider(panelX, currentY, controlWidth,
+                       Config::MIN_ANIMATION_SPEED, Config::MAX_ANIMATION_SPEED,
+                       Config::DEFAULT_ANIMATION_SPEED, "Animation Speed", font);
+    currentY += 45;
+
+    // Export button
+    Button exportBtn(panelX, currentY, controlWidth, buttonHeight, "Export PNG", font);
+    currentY += buttonHeight + spacing;
+
+    // Back button
+    Button backBtn(panelX, currentY, controlWidth, buttonHeight, "<< Back to Menu", font);
+    currentY += buttonHeight + spacing + 8;
+
+    sf::Text statsText;
+    statsText.setFont(font);
+    statsText.setCharacterSize(10);
+    statsText.setFillColor(Config::TEXT_COLOR);
+    statsText.setPosition(panelX, currentY);
+
+    // Message box for feedback
+    MessageBox messageBox(panelX, Config::WINDOW_HEIGHT - 55, controlWidth, font);
+
+    // Control panel background
+    sf::RectangleShape controlPanel;
+    controlPanel.setPosition(0, 0);
+    controlPanel.setSize(sf::Vector2f(Config::CONTROL_PANEL_WIDTH, Config::WINDOW_HEIGHT));
+    controlPanel.setFillColor(Config::CONTROL_PANEL_COLOR);
+
+    // Animation state: blocks are tracked by id, a merge frees blocks
+    std::vector<int> highlightPath;
+    int highlightIndex = -1;
+    float highlightTimer = 0;
+    bool isAnimating = false;
+    int foundBlockId = -1;
+    int foundOffset = -1;
+    int newBlockId = -1;
+
+    auto startWalk = [&](const std::vector<UnrolledBlock*>& path) {
+        highlightPath.clear();
+        for (UnrolledBlock* block : path) highlightPath.push_back(block->id);
+        highlightIndex = 0;
+        highlightTimer = 0;
+        isAnimating = !highlightPath.empty();
+        newBlockId = list.getLastSplitId();
+    };
+
+    auto refreshStats = [&]() {
+        std::ostringstream ss;
+        ss << "Values: " << list.getSize() << "   Blocks: " << list.getBlockCount()
+           << "\nCapacity: " << list.getCapacity() << " per block";
+        if (list.getBlockCount() > 0) {
+            ss << std::fixed << std::setprecision(0) << "\nFill: "
+               << 100.0 * list.getSize() / (list.getBlockCount() * list.getCapacity()) << "%";
+        }
+        ss << "\nPointers followed per full scan:\n  " << list.getBlockCount()
+           << " (LinkedList: " << list.getSize() << ")";
+        statsText.setString(ss.str());
+    };
+    refreshStats();
+
+    unsigned int randomSeed = 5;
+    sf::Clock clock;
+    bool running = true;
+
+    while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
+        float deltaTime = clock.restart().asSeconds();
+
+        if (isAnimating) {
+            highlightTimer += deltaTime * speedSlider.getValue();
+            if (highlightTimer >= 0.3f) {
+                highlightTimer = 0;
+                highlightIndex++;
+                if (highlightIndex >= (int)highlightPath.size()) {
+                    isAnimating = false;
+                }
+            }
+        }
+
+        bool canInteract = !isAnimating;
+        insertTailBtn.setEnabled(canInteract);
+        insertHeadBtn.setEnabled(canInteract);
+        insertAtBtn.setEnabled(canInteract);
+        deleteBtn.setEnabled(canInteract);
+        searchBtn.setEnabled(canInteract);
+        randomBtn.setEnabled(canInteract);
+        clearBtn.setEnabled(canInteract);
+        capacityBtn.setEnabled(canInteract);
+        exportBtn.setEnabled(canInteract);
+
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                running = false;
+            }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                running = false;
+            }
+
+            valueInput.handleEvent(event, window);
+            indexInput.handleEvent(event, window);
+            capacityInput.handleEvent(event, window);
+            speedSlider.handleEvent(event, window);
+
+            if (backBtn.handleEvent(event, window)) running = false;
+
+            int value;
+            bool haveValue = !valueInput.isEmpty() && valueInput.getAsInt(value);
+
+            if (insertTailBtn.handleEvent(event, window) && canInteract) {
+                if (!haveValue) {
+                    messageBox.show("Error: Enter a valid integer!", MessageBox::ERROR_MSG, 2.0f);
+                } else if (list.getSize() >= static_cast<size_t>(MAX_VALUES)) {
+                    messageBox.show("The view holds " + std::to_string(MAX_VALUES) + " values", MessageBox::ERROR_MSG, 2.0f);
+                } else {
+                    size_t blocksBefore = list.getBlockCount();
+                    list.insertAtTail(value);
+                    startWalk(std::vector<UnrolledBlock*>());
+                    foundBlockId = -1;
+                    newBlockId = list.getBlockCount() > blocksBefore ? -2 : -1;     // -2: the tail
+                    messageBox.show(newBlockId == -2 ? "Tail block was full: new block appended"
+                                                     : "Appended to the tail block", MessageBox::SUCCESS, 2.0f);
+                    valueInput.clear();
+                }
+            }
+
+            // Head inserts are inserts at index 0
+            auto insertValueAt = [&](int index) {
+                if (!haveValue) {
+                    messageBox.show("Error: Enter a valid integer!", MessageBox::ERROR_MSG, 2.0f);
+                } else if (list.getSize() >= static_cast<size_t>(MAX_VALUES)) {
+                    messageBox.show("The view holds " + std::to_string(MAX_VALUES) + " values", MessageBox::ERROR_MSG, 2.0f);
+                } else {
+                    std::vector<UnrolledBlock*> path;
+                    if (list.insertAt(static_cast<size_t>(index), value, path)) {
+                        startWalk(path);
+                        foundBlockId = -1;
+                        messageBox.show(list.getLastSplitId() >= 0 ? "Block was full: split in two"
+                                                                   : "Inserted at " + std::to_string(index),
+                                        MessageBox::SUCCESS, 2.0f);
+                        valueInput.clear();
+                    } else {
+                        messageBox.show("Index past the end (" + std::to_string(list.getSize()) + ")",
+                                        MessageBox::ERROR_MSG, 2.0f);
+                    }
+                }
+            };
+
+            if (insertHeadBtn.handleEvent(event, window) && canInteract) {
+                insertValueAt(0);
+            }
+
+            if (insertAtBtn.handleEvent(event, window) && canInteract) {
+                int index;
+                if (!indexInput.isEmpty() && indexInput.getAsInt(index) && index >= 0) {
+                    insertValueAt(index);
+                } else {
+                    messageBox.show("Error: Enter a valid index!", MessageBox::ERROR_MSG, 2.0f);
+                }
+            }
+
+            if (deleteBtn.handleEvent(event, window) && canInteract) {
+                if (!haveValue) {
+                    messageBox.show("Error: Enter a valid integer!", MessageBox::ERROR_MSG, 2.0f);
+                } else {
+                    std::vector<UnrolledBlock*> path;
+                    int offset;
+                    list.search(value, offset, path);
+                    startWalk(path);
+                    foundBlockId = -1;
+                    path.clear();
+                    if (list.remove(value, path)) {
+                        std::string note = list.getLastMergeId() >= 0
+                            ? ", merged block #" + std::to_string(list.getLastMergeId()) + " in" : "";
+                        messageBox.show("Deleted " + std::to_string(value) + note, MessageBox::SUCCESS, 2.0f);
+                    } else {
+                        messageBox.show("Error: Value not found!", MessageBox::ERROR_MSG, 2.0f);
+                    }
+                    valueInput.clear();
+                }
+            }
+
+            if (searchBtn.handleEvent(event, window) && canInteract) {
+                if (!haveValue) {
+                    messageBox.show("Error: Enter a valid integer!", MessageBox::ERROR_MSG, 2.0f);
+                } else {
+                    std::vector<UnrolledBlock*> path;
+                    UnrolledBlock* found = list.search(value, foundOffset, path);
+                    startWalk(path);
+                    newBlockId = -1;
+                    foundBlockId = found ? found->id : -1;
+                    messageBox.show(found ? "Found " + std::to_string(value) + " after " +
+                                            std::to_string(path.size()) + " block(s)"
+                                          : "Value not found.",
+                                    found ? MessageBox::SUCCESS : MessageBox::INFO, 2.0f);
+                    valueInput.clear();
+                }
+            }
+
+            if (randomBtn.handleEvent(event, window) && canInteract) {
+                std::vector<UnrolledBlock*> path;
+                for (int i = 0; i < 10 && list.getSize() < static_cast<size_t>(MAX_VALUES); i++) {
+                    randomSeed = randomSeed * 1103515245u + 12345u;
+                    int randomValue = static_cast<int>((randomSeed >> 16) % 100);
+                    randomSeed = randomSeed * 1103515245u + 12345u;
+                    path.clear();
+                    list.insertAt((randomSeed >> 16) % (list.getSize() + 1), randomValue, path);
+                }
+                highlightPath.clear();
+                isAnimating = false;
+                foundBlockId = newBlockId = -1;
+                messageBox.show("Inserted random values at random positions", MessageBox::INFO, 2.0f);
+            }
+
+            if (clearBtn.handleEvent(event, window) && canInteract) {
+                list.clear();
+                highlightPath.clear();
+                isAnimating = false;
+                foundBlockId = newBlockId = -1;
+                messageBox.show("List cleared!", MessageBox::INFO, 2.0f);
+            }
+
+            if (capacityBtn.handleEvent(event, window) && canInteract) {
+                int capacity;
+                if (!capacityInput.isEmpty() && capacityInput.getAsInt(capacity) && capacity >= 2 && capacity <= 8) {
+                    std::vector<int> values;
+                    for (UnrolledBlock* block = list.getHead(); block != nullptr; block = block->next) {
+                        values.insert(values.end(), block->values, block->values + block->count);
+                    }
+                    list.setCapacity(capacity);
+                    list.loadValues(values);
+                    highlightPath.clear();
+                    isAnimating = false;
+                    foundBlockId = newBlockId = -1;
+                    messageBox.show("Repacked into full blocks of " + std::to_string(capacity), MessageBox::SUCCESS, 2.0f);
+                } else {
+                    messageBox.show("Error: Capacity must be 2-8", MessageBox::ERROR_MSG, 2.0f);
+                }
+            }
+
+            // EXPORT PNG
+            if (exportBtn.handleEvent(event, window) && canInteract) {
+                window.display();
+                if (exportVisualizationToPNG(window, "unrolled_export.png",
+                                              Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
+                                              Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
+                    messageBox.show("Exported to unrolled_export.png", MessageBox::SUCCESS, 3.0f);
+                } else {
+                    messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
+                }
+            }
+        }
+
+        // Update
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        valueInput.update(deltaTime);
+        indexInput.update(deltaTime);
+        capacityInput.update(deltaTime);
+        messageBox.update(deltaTime);
+        refreshStats();
+
+        // Draw
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
+        window.clear(Config::BACKGROUND_COLOR);
+        window.draw(controlPanel);
+        window.draw(titleText);
+        window.draw(inputLabel);
+        window.draw(capacityLabel);
+        window.draw(statsText);
+        valueInput.draw(window);
+        indexInput.draw(window);
+        capacityInput.draw(window);
+        insertTailBtn.draw(window);
+        insertHeadBtn.draw(window);
+        insertAtBtn.draw(window);
+        deleteBtn.draw(window);
+        searchBtn.draw(window);
+        randomBtn.draw(window);
+        clearBtn.draw(window);
+        capacityBtn.draw(window);
+        speedSlider.draw(window);
+        exportBtn.draw(window);
+        backBtn.draw(window);
+
+        sf::RectangleShape area;
+        area.setPosition(Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 10);
+        area.setSize(sf::Vector2f(Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 20));
+        area.setFillColor(Config::TREE_AREA_COLOR);
+        window.draw(area);
+
+        sf::Text areaTitle;
+        areaTitle.setFont(font);
+        areaTitle.setString("Unrolled List Visualization");
+        areaTitle.setCharacterSize(Config::TITLE_FONT_SIZE);
+        areaTitle.setFillColor(Config::TEXT_SECONDARY);
+        areaTitle.setPosition(Config::TREE_AREA_X, Config::TREE_AREA_Y - 35);
+        window.draw(areaTitle);
+
+        // Blocks, wrapped into rows
+        float blockWidth = list.getCapacity() * CELL;
+        int perRow = std::max(1, static_cast<int>((Config::TREE_AREA_WIDTH + BLOCK_GAP) / (blockWidth + BLOCK_GAP)));
+        int shown = std::min(highlightIndex + 1, (int)highlightPath.size());
+        int blockIndex = 0;
+        for (UnrolledBlock* block = list.getHead(); block != nullptr; block = block->next, blockIndex++) {
+            float x = Config::TREE_AREA_X + (blockIndex % perRow) * (blockWidth + BLOCK_GAP);
+            float y = Config::TREE_AREA_Y + 30 + (blockIndex / perRow) * ROW_HEIGHT;
+
+            bool onPath = isAnimating &&
+                std::find(highlightPath.begin(), highlightPath.begin() + shown, block->id) != highlightPath.begin() + shown;
+            bool walkDone = !isAnimating;
+            bool isNew = walkDone && (block->id == newBlockId || (newBlockId == -2 && block->next == nullptr));
+
+            for (int i = 0; i < list.getCapacity(); i++) {
+                sf::RectangleShape cell(sf::Vector2f(CELL, CELL));
+                cell.setPosition(x + i * CELL, y);
+                sf::Color fill = i < block->count ? Config::LINKEDLIST_COLOR : Config::BUTTON_IDLE;
+                if (i < block->count) {
+                    if (onPath) fill = Config::NODE_HIGHLIGHT_FILL;
+                    if (isNew) fill = Config::NODE_NEW_FILL;
+                    if (walkDone && block->id == foundBlockId && i == foundOffset) fill = Config::NODE_FOUND_FILL;
+                }
+                cell.setFillColor(fill);
+                cell.setOutlineColor(Config::TREE_AREA_COLOR);
+                cell.setOutlineThickness(-1);
+                window.draw(cell);
+
+                if (i < block->count) {
+                    sf::Text valueText;
+                    valueText.setFont(font);
+                    valueText.setString(std::to_string(block->values[i]));
+                    valueText.setCharacterSize(12);
+                    valueText.setFillColor(isNew || onPath ? Config::TEXT_COLOR : Config::BACKGROUND_COLOR);
+                    sf::FloatRect bounds = valueText.getLocalBounds();
+                    valueText.setOrigin(bounds.left + bounds.width / 2, bounds.top + bounds.height / 2);
+                    valueText.setPosition(x + i * CELL + CELL / 2, y + CELL / 2);
+                    window.draw(valueText);
+                }
+            }
+
+            // Block frame and label
+            sf::RectangleShape frame(sf::Vector2f(blockWidth, CELL));
+            frame.setPosition(x, y);
+            frame.setFillColor(sf::Color::Transparent);
+            frame.setOutlineColor(onPath ? Config::NODE_HIGHLIGHT_OUTLINE : Config::LINKEDLIST_OUTLINE);
+            frame.setOutlineThickness(2);
+            window.draw(frame);
+
+            sf::Text label;
+            label.setFont(font);
+            label.setString("#" + std::to_string(block->id) + "  " + std::to_string(block->count) + "/" +
+                            std::to_string(list.getCapacity()));
+            label.setCharacterSize(10);
+            label.setFillColor(Config::TEXT_SECONDARY);
+            label.setPosition(x, y + CELL + 4);
+            window.draw(label);
+
+            // Next pointer: to the right, or down to the next row
+            if (block->next != nullptr) {
+                bool wraps = (blockIndex + 1) % perRow == 0;
+                float startX = x + blockWidth;
+                float startY = y + CELL / 2;
+                float endX = wraps ? Config::TREE_AREA_X : startX + BLOCK_GAP;
+                float endY = wraps ? startY + ROW_HEIGHT : startY;
+                if (wraps) {
+                    sf::Vertex line[] = {
+                        sf::Vertex(sf::Vector2f(startX, startY), Config::ARROW_COLOR),
+                        sf::Vertex(sf::Vector2f(startX + 8, startY), Config::ARROW_COLOR),
+                        sf::Vertex(sf::Vector2f(startX + 8, startY + ROW_HEIGHT / 2 + CELL / 2), Config::ARROW_COLOR),
+                        sf::Vertex(sf::Vector2f(endX - 8, startY + ROW_HEIGHT / 2 + CELL / 2), Config::ARROW_COLOR),
+                        sf::Vertex(sf::Vector2f(endX - 8, endY), Config::ARROW_COLOR),
+                        sf::Vertex(sf::Vector2f(endX, endY), Config::ARROW_COLOR)
+                    };
+                    window.draw(line, 6, sf::LineStrip);
+                } else {
+                    sf::Vertex line[] = {
+                        sf::Vertex(sf::Vector2f(startX, startY), Config::ARROW_COLOR),
+                        sf::Vertex(sf::Vector2f(endX - 2, endY), Config::ARROW_COLOR)
+                    };
+                    window.draw(line, 2, sf::Lines);
+                }
+                sf::CircleShape head(5, 3);
+                head.setOrigin(5, 5);
+                head.setRotation(90);
+                head.setPosition(endX - 5, endY);
+                head.setFillColor(Config::ARROW_COLOR);
+                window.draw(head);
+            }
+        }
+
+        if (list.isEmpty()) {
+            sf::Text emptyText;
+            emptyText.setFont(font);
+            emptyText.setString("Empty - insert values or press Random");
+            emptyText.setCharacterSize(14);
+            emptyText.setFillColor(Config::TEXT_SECONDARY);
+            emptyText.setPosition(Config::TREE_AREA_X + 20, Config::TREE_AREA_Y + 30);
+            window.draw(emptyText);
+        }
+
+        drawMemoryHud(window, font);
+        messageBox.draw(window);
+        window.display();
+    }
+}
+
+// ============================================================================
+// CONCURRENT AVL MODE
+// Worker threads insert, remove and look up random keys in one
+// ConcurrentAVL while the canvas redraws a snapshot every frame. Nodes a
+// writer has locked turn red, nodes in the middle of a rotation yellow, and
+// routing nodes (removed keys still used for the search) gray. Readers
+// never lock, so a read-only mix never shows red. "Lock hold" makes writers
+// sleep while holding their locks, so single locks can be followed.
+// ============================================================================
+void runConcurrentAVLMode(sf::RenderWindow& window, sf::Font& font) {
+    const int KEY_RANGE = 48;
+    const size_t VIEW_LIMIT = 256;
+    const int THREAD_COUNTS[] = {1, 2, 4, 8};
+    const int READ_PERCENTS[] = {50, 90, 100};
+    const int PACES[] = {20, 200, 2000};            // Operations per second per thread
+    const int LOCK_HOLDS_MS[] = {0, 2, 20, 100};
+    int threadIndex = 2;
+    int mixIndex = 0;
+    int paceIndex = 0;
+    int holdIndex = 2;
+
+    ConcurrentAVL tree;
+    tree.setLockHoldMicros(LOCK_HOLDS_MS[holdIndex] * 1000);
+    TreeCanvas canvas(Config::TREE_AREA_X, Config::TREE_AREA_Y,
+                      Config::TREE_AREA_WIDTH, Config::TREE_AREA_HEIGHT,
+                      "Concurrent AVL (optimistic, relaxed balance)", font);
+
+    // Workers; they only share the tree and these atomics with the GUI
+    std::vector<std::thread> workers;
+    std::atomic<bool> stopRequested(false);
+    std::atomic<int> readPercent(READ_PERCENTS[mixIndex]);
+    std::atomic<int> pauseMicros(1000000 / PACES[paceIndex]);
+    std::atomic<unsigned long long> operations(0);
+
+    auto startWorkers = [&]() {
+        stopRequested = false;
+        for (int t = 0; t < THREAD_COUNTS[threadIndex]; t++) {
+            workers.emplace_back([&, t]() {
+                unsigned int seed = 12345u + 7919u * static_cast<unsigned int>(t);
+                while (!stopRequested.load()) {
+                    seed = seed * 1103515245u + 12345u;
+                    int key = static_cast<int>((seed >> 16) % KEY_RANGE);
+                    seed = seed * 1103515245u + 12345u;
+                    int percent = static_cast<int>((seed >> 16) % 100);
+                    if (percent < readPercent.load()) {
+                        tree.contains(key);
+                    } else if (percent % 2 == 0) {
+                        tree.insert(key);
+                    } else {
+                        tree.remove(key);
+                    }
+                    operations++;
+                    std::this_thread::sleep_for(std::chrono::microseconds(pauseMicros.load()));
+                }
+            });
+        }
+    };
+
+    // Retired nodes can only be freed once no thread can still read them
+    auto stopWorkers = [&]() {
+        stopRequested = true;
+        for (std::thread& worker : workers) worker.join();
+        workers.clear();
+        tree.reclaim();
+    };
+
+    // Snapshot copied into linked view nodes for the canvas. A snapshot
+    // taken during a rotation may contain a node twice; the second copy is
+    // dropped with its subtree.
+    struct ViewNode {
+        int id;
+        int value;
+        ViewNode* left;
+        ViewNode* right;
+        const ConcurrentAVL::NodeState* state;
+    };
+    std::vector<ConcurrentAVL::NodeState> states;
+    std::vector<ViewNode> viewNodes;
+    std::vector<std::pair<int, ViewNode**>> pending;
+    std::set<int> seen;
+
+    auto showTree = [&]() {
+        tree.snapshot(states, VIEW_LIMIT);
+        viewNodes.clear();
+        viewNodes.reserve(states.size());
+        seen.clear();
+        ViewNode* root = nullptr;
+        pending.clear();
+        if (!states.empty()) pending.push_back({0, &root});
+        while (!pending.empty()) {
+            std::pair<int, ViewNode**> item = pending.back();
+            pending.pop_back();
+            const ConcurrentAVL::NodeState& state = states[item.first];
+            if (!seen.insert(state.id).second) continue;
+            viewNodes.push_back({state.id, state.value, nullptr, nullptr, &state});
+            ViewNode* view = &viewNodes.back();
+            *item.second = view;
+            if (state.right >= 0) pending.push_back({state.right, &view->right});
+            if (state.left >= 0) pending.push_back({state.left, &view->left});
+        }
+
+        canvas.setTree(root, [](ViewNode* view, std::string& label, std::string& detail) {
+            label = std::to_string(view->value);
+            detail = "h" + std::to_string(view->state->height);
+        });
+        canvas.resetColors();
+        for (const ViewNode& view : viewNodes) {
+            if (view.state->locked) {
+                canvas.setColor(view.id, Config::NODE_DELETE_FILL);
+            } else if (view.state->shrinking) {
+                canvas.setColor(view.id, Config::NODE_HIGHLIGHT_FILL);
+            } else if (!view.state->present) {
+                canvas.setColor(view.id, TreeCanvas::PRUNED_FILL);
+            }
+        }
+    };
+
+    // GUI Layout
+    float panelX = Config::CONTROL_PANEL_PADDING;
+    float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
+    float halfWidth = (controlWidth - 10) / 2;
+    float buttonHeight = 32.0f;
+    float spacing = 8.0f;
+    float currentY = Config::CONTROL_PANEL_PADDING;
+
+    // Title
+    sf::Text titleText;
+    titleText.setFont(font);
+    titleText.setString("Concurrent AVL");
+    titleText.setCharacterSize(Config::TITLE_FONT_SIZE);
+    titleText.setFillColor(Config::TEXT_COLOR);
+    titleText.setStyle(sf::Text::Bold);
+    titleText.setPosition(panelX, currentY);
+    currentY += 30;
+
+    // Value input (works while the workers run)
+    sf::Text inputLabel;
+    inputLabel.setFont(font);
+    inputLabel.setString("Value:");
+    inputLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    inputLabel.setFillColor(Config::TEXT_SECONDARY);
+    inputLabel.setPosition(panelX, currentY);
+    currentY += 18;
+
+    TextInput valueInput(panelX, currentY, controlWidth, 32, "Enter value...", font, true);
+    currentY += 40;
+
+    Button insertBtn(panelX, currentY, halfWidth, buttonHeight, "Insert", font);
+    Button deleteBtn(panelX + halfWidth + 10, currentY, halfWidth, buttonHeight, "Delete", font);
+    currentY += buttonHeight + spacing;
+
+    Button searchBtn(panelX, currentY, controlWidth, buttonHeight, "Search", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Worker controls
+    Button runBtn(panelX, currentY, controlWidth, buttonHeight, "Start Workers", font);
+    currentY += buttonHeight + spacing;
+
+    Button threadsBtn(panelX, currentY, controlWidth, buttonHeight, "", font);
+    currentY += buttonHeight + spacing;
+
+    Button mixBtn(panelX, currentY, controlWidth, buttonHeight, "", font);
+    currentY += buttonHeight + spacing;
+
+    Button paceBtn(panelX, currentY, controlWidth, buttonHeight, "", font);
+    currentY += buttonHeight + spacing;
+
+    Button holdBtn(panelX, currentY, controlWidth, buttonHeight, "", font);
+    currentY += buttonHeight + spacing;
+
+    Button clearBtn(panelX, currentY, controlWidth, buttonHeight, "Clear All", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Export button
+    Button exportBtn(panelX, currentY, controlWidth, buttonHeight, "Export PNG", font);
+    currentY += buttonHeight + spacing;
+
+    // Back button
+    Button backBtn(panelX, currentY, controlWidth, buttonHeight, "<< Back to Menu", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Legend and statistics
+    sf::Text legendText;
+    legendText.setFont(font);
+    legendText.setString("Red: locked by a writer   Yellow: rotating\nGray: routing node (key removed)");
+    legendText.setCharacterSize(10);
+    legendText.setFillColor(Config::TEXT_SECONDARY);
+    legendText.setPosition(panelX, currentY);
+    currentY += 32;
+
+    sf::Text statsText;
+    statsText.setFont(font);
+    statsText.setCharacterSize(10);
+    statsText.setFillColor(Config::TEXT_COLOR);
+    statsText.setPosition(panelX, currentY);
+
+    // Message box for feedback
+    MessageBox messageBox(panelX, Config::WINDOW_HEIGHT - 55, controlWidth, font);
+
+    // Control panel background
+    sf::RectangleShape controlPanel;
+    controlPanel.setPosition(0, 0);
+    controlPanel.setSize(sf::Vector2f(Config::CONTROL_PANEL_WIDTH, Config::WINDOW_HEIGHT));
+    controlPanel.setFillColor(Config::CONTROL_PANEL_COLOR);
+
+    double opsPerSecond = 0;
+    auto refreshStats = [&]() {
+        bool running = !workers.empty();
+        runBtn.setText(running ? "Stop Workers" : "Start Workers");
+        threadsBtn.setText("Threads: " + std::to_string(THREAD_COUNTS[threadIndex]) + " (click to change)");
+        mixBtn.setText("Reads: " + std::to_string(READ_PERCENTS[mixIndex]) +
+                       "%, writes: " + std::to_string(100 - READ_PERCENTS[mixIndex]) + "%");
+        paceBtn.setText("Pace: " + std::to_string(PACES[paceIndex]) + " ops/s per thread");
+        holdBtn.setText("Lock hold: " + std::to_string(LOCK_HOLDS_MS[holdIndex]) + " ms");
+
+        int routing = 0;
+        for (const ViewNode& view : viewNodes) {
+            if (!view.state->present) routing++;
+        }
+        std::ostringstream ss;
+        ss << "Keys: " << viewNodes.size() - routing << "   Routing: " << routing
+           << "   Height: " << tree.getHeight()
+           << "\nOps/s: " << static_cast<long long>(opsPerSecond)
+           << "   Retries: " << tree.retries()
+           << "\nRetired nodes: " << tree.retiredCount();
+        if (!running) {
+            std::string error;
+            ss << "\n" << (tree.validate(error) ? "Strict AVL, no locks held" : "Invalid: " + error);
+        } else {
+            ss << "\nBalance is relaxed while updates run";
+        }
+        statsText.setString(ss.str());
+    };
+
+    auto readValue = [&](int& value) {
+        if (valueInput.isEmpty() || !valueInput.getAsInt(value)) {
+            messageBox.show("Error: Enter a valid integer!", MessageBox::ERROR_MSG, 3.0f);
+            return false;
+        }
+        return true;
+    };
+
+    showTree();
+    refreshStats();
+    sf::Clock clock;
+    float rateTimer = 0;
+    unsigned long long lastOperations = 0;
+    bool running = true;
+
+    while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
+        float deltaTime = clock.restart().asSeconds();
+
+        clearBtn.setEnabled(workers.empty());
+
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                running = false;
+            }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                running = false;
+            }
+
+            valueInput.handleEvent(event, window);
+
+            if (backBtn.handleEvent(event, window)) {
+                running = false;
+            }
+
+            // INSERT / DELETE / SEARCH run alongside the workers
+            int value;
+            if (insertBtn.handleEvent(event, window) && readValue(value)) {
+                bool inserted = tree.insert(value);
+                messageBox.show(inserted ? "Inserted: " + std::to_string(value)
+                                         : "Error: " + std::to_string(value) + " already exists!",
+                                inserted ? MessageBox::SUCCESS : MessageBox::ERROR_MSG, 2.0f);
+                valueInput.clear();
+            }
+            if (deleteBtn.handleEvent(event, window) && readValue(value)) {
+                bool removed = tree.remove(value);
+                messageBox.show(removed ? "Deleted: " + std::to_string(value)
+                                        : "Error: " + std::to_string(value) + " not found!",
+                                removed ? MessageBox::SUCCESS : MessageBox::ERROR_MSG, 2.0f);
+                valueInput.clear();
+            }
+            if (searchBtn.handleEvent(event, window) && readValue(value)) {
+                bool found = tree.contains(value);
+                messageBox.show(found ? "Found: " + std::to_string(value)
+                                      : std::to_string(value) + " not found",
+                                found ? MessageBox::SUCCESS : MessageBox::INFO, 2.0f);
+            }
+
+            if (runBtn.handleEvent(event, window)) {
+                if (workers.empty()) {
+                    startWorkers();
+                    messageBox.show("Started " + std::to_string(workers.size()) + " worker thread(s)",
+                                    MessageBox::INFO, 2.0f);
+                } else {
+                    stopWorkers();
+                    messageBox.show("Workers stopped", MessageBox::INFO, 2.0f);
+                }
+                refreshStats();
+            }
+
+            // Changing the thread count restarts running workers
+            if (threadsBtn.handleEvent(event, window)) {
+                threadIndex = (threadIndex + 1) % 4;
+                if (!workers.empty()) {
+                    stopWorkers();
+                    startWorkers();
+                }
+                refreshStats();
+            }
+
+            if (mixBtn.handleEvent(event, window)) {
+                mixIndex = (mixIndex + 1) % 3;
+                readPercent = READ_PERCENTS[mixIndex];
+                refreshStats();
+            }
+
+            if (paceBtn.handleEvent(event, window)) {
+                paceIndex = (paceIndex + 1) % 3;
+                pauseMicros = 1000000 / PACES[paceIndex];
+                refreshStats();
+            }
+
+            if (holdBtn.handleEvent(event, window)) {
+                holdIndex = (holdIndex + 1) % 4;
+                tree.setLockHoldMicros(LOCK_HOLDS_MS[holdIndex] * 1000);
+                refreshStats();
+            }
+
+            // CLEAR operation (not thread-safe, so only while stopped)
+            if (clearBtn.handleEvent(event, window)) {
+                tree.clear();
+                messageBox.show("Tree cleared!", MessageBox::INFO, 2.0f);
+            }
+
+            // EXPORT PNG
+            if (exportBtn.handleEvent(event, window)) {
+                if (viewNodes.empty()) {
+                    messageBox.show("Cannot export empty tree!", MessageBox::ERROR_MSG, 2.0f);
+                } else {
+                    window.display();
+                    if (exportVisualizationToPNG(window, "concurrent_avl_export.png",
+                                                  Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
+                                                  Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
+                        messageBox.show("Exported to concurrent_avl_export.png", MessageBox::SUCCESS, 3.0f);
+                    } else {
+                        messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
+                    }
+                }
+            }
+        }
+
+        // Update
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        showTree();
+        rateTimer += deltaTime;
+        if (rateTimer >= 0.5f) {
+            unsigned long long total = operations.load();
+            opsPerSecond = (total - lastOperations) / rateTimer;
+            lastOperations = total;
+            rateTimer = 0;
+        }
+        refreshStats();
+        valueInput.update(deltaTime);
+        canvas.update(deltaTime);
+        messageBox.update(deltaTime);
+
+        // Draw
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
+        window.clear(Config::BACKGROUND_COLOR);
+        window.draw(controlPanel);
+        window.draw(titleText);
+        window.draw(inputLabel);
+        window.draw(legendText);
+        window.draw(statsText);
+        valueInput.draw(window);
+        insertBtn.draw(window);
+        deleteBtn.draw(window);
+        searchBtn.draw(window);
+        runBtn.draw(window);
+        threadsBtn.draw(window);
+        mixBtn.draw(window);
+        paceBtn.draw(window);
+        holdBtn.draw(window);
+        clearBtn.draw(window);
+        exportBtn.draw(window);
+        backBtn.draw(window);
+        canvas.draw(window);
+        drawMemoryHud(window, font);
+        messageBox.draw(window);
+        window.display();
+    }
+
+    stopWorkers();
+}
+
+// ============================================================================
+// TYPED KEYS MODE
+// One BasicAVLTree per key type: int, 64-bit int, double and string
+// (ShortKey). "Key Type" switches the tree on screen, and the input then
+// accepts that type. String nodes that keep their key on the heap (longer
+// than ShortKey::INLINE_CAPACITY) say so under the box.
+// ============================================================================
+
+// Random keys for "Insert 10 Random", one overload per key type
+void makeRandomKey(std::mt19937& random, int& key) {
+    key = static_cast<int>(random() % 1999) - 999;
+}
+
+void makeRandomKey(std::mt19937& random, long long& key) {
+    // Just past the int range, like 64-bit ids
+    key = (1LL << 32) + static_cast<long long>(random() % 1000000);
+}
+
+void makeRandomKey(std::mt19937& random, double& key) {
+    key = static_cast<double>(random() % 20001) / 100.0 - 100.0;
+}
+
+void makeRandomKey(std::mt19937& random, ShortKey& key) {
+    static const char* const SYLLABLES[] = {"ka", "lo", "mi", "ne", "ru", "sa", "to", "vi"};
+    std::string text;
+    int count = 2 + static_cast<int>(random() % 9);      // 4 to 20 characters
+    for (int i = 0; i < count; i++) {
+        text += SYLLABLES[random() % 8];
+    }
+    key = ShortKey(text);
+}
+
+// Text under a node's box
+std::string keyDetail(const ShortKey& key) {
+    return key.isInline() ? std::string() : "heap, " + std::to_string(key.size()) + " B";
+}
+
+template <typename Key>
+std::string keyDetail(const Key&) {
+    return std::string();
+}
+
+void runKeyedTreeMode(sf::RenderWindow& window, sf::Font& font) {
+    const char* const KEY_TYPE_NAMES[] = {"int", "int64", "double", "string"};
+    const int KEY_TYPE_COUNT = 4;
+    const size_t LABEL_CHARS = 10;
+    int keyType = 0;
+
+    BasicAVLTree<int> intTree;
+    BasicAVLTree<long long> int64Tree;
+    BasicAVLTree<double> doubleTree;
+    BasicAVLTree<ShortKey> stringTree;
+    std::mt19937 random(12345);
+
+    TreeCanvas canvas(Config::TREE_AREA_X, Config::TREE_AREA_Y,
+                      Config::TREE_AREA_WIDTH, Config::TREE_AREA_HEIGHT,
+                      "Typed keys (BasicAVLTree)", font);
+
+    // Run 'action' on the tree of the selected key type
+    auto withTree = [&](auto action) {
+        switch (keyType) {
+            case 0: action(intTree); break;
+            case 1: action(int64Tree); break;
+            case 2: action(doubleTree); break;
+            default: action(stringTree); break;
+        }
+    };
+
+    auto describe = [&](auto* node, std::string& label, std::string& detail) {
+        typedef typename std::decay<decltype(node->value)>::type Key;
+        label = KeyFormat<Key>::format(node->value);
+        if (label.size() > LABEL_CHARS) {
+            label = label.substr(0, LABEL_CHARS - 1) + "~";
+        }
+        detail = keyDetail(node->value);
+    };
+
+    // GUI Layout
+    float panelX = Config::CONTROL_PANEL_PADDING;
+    float controlWidth = Config::CONTROL_PANEL_WIDTH - 2 * Config::CONTROL_PANEL_PADDING;
+    float buttonHeight = 32.0f;
+    float spacing = 8.0f;
+    float currentY = Config::CONTROL_PANEL_PADDING;
+
+    // Title
+    sf::Text titleText;
+    titleText.setFont(font);
+    titleText.setString("Typed Keys");
+    titleText.setCharacterSize(Config::TITLE_FONT_SIZE);
+    titleText.setFillColor(Config::TEXT_COLOR);
+    titleText.setStyle(sf::Text::Bold);
+    titleText.setPosition(panelX, currentY);
+    currentY += 30;
+
+    Button keyTypeBtn(panelX, currentY, controlWidth, buttonHeight, "", font);
+    currentY += buttonHeight + spacing;
+
+    // Key input
+    sf::Text inputLabel;
+    inputLabel.setFont(font);
+    inputLabel.setCharacterSize(Config::LABEL_FONT_SIZE);
+    inputLabel.setFillColor(Config::TEXT_SECONDARY);
+    inputLabel.setPosition(panelX, currentY);
+    currentY += 18;
+
+    TextInput valueInput(panelX, currentY, controlWidth, 32, "Enter key...", font, true);
+    currentY += 40;
+
+    // Operation buttons
+    Button insertBtn(panelX, currentY, controlWidth, buttonHeight, "Insert", font);
+    currentY += buttonHeight + spacing;
+
+    Button deleteBtn(panelX, currentY, controlWidth, buttonHeight, "Delete", font);
+    currentY += buttonHeight + spacing;
+
+    Button searchBtn(panelX, currentY, controlWidth, buttonHeight, "Search", font);
+    currentY += buttonHeight + spacing;
+
+    Button randomBtn(panelX, currentY, controlWidth, buttonHeight, "Insert 10 Random", font);
+    currentY += buttonHeight + spacing;
+
+    Button clearBtn(panelX, currentY, controlWidth, buttonHeight, "Clear All", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Speed slider
+    Slider speedSlider(panelX, currentY, controlWidth,
+                       Config::MIN_ANIMATION_SPEED, Config::MAX_ANIMATION_SPEED,
+                       Config::DEFAULT_ANIMATION_SPEED, "Animation Speed", font);
+    currentY += 45;
+
+    // Export button
+    Button exportBtn(panelX, currentY, controlWidth, buttonHeight, "Export PNG", font);
+    currentY += buttonHeight + spacing;
+
+    // Back button
+    Button backBtn(panelX, currentY, controlWidth, buttonHeight, "<< Back to Menu", font);
+    currentY += buttonHeight + spacing + 10;
+
+    // Legend and statistics
+    sf::Text legendText;
+    legendText.setFont(font);
+    legendText.setString("Yellow: path   Green: found\nPurple: new node");
+    legendText.setCharacterSize(10);
+    legendText.setFillColor(Config::TEXT_SECONDARY);
+    legendText.setPosition(panelX, currentY);
+    currentY += 32;
+
+    sf::Text statsText;
+    statsText.setFont(font);
+    statsText.setCharacterSize(10);
+    statsText.setFillColor(Config::TEXT_COLOR);
+    statsText.setPosition(panelX, currentY);
+
+    // Message box for feedback
+    MessageBox messageBox(panelX, Config::WINDOW_HEIGHT - 55, controlWidth, font);
+
+    // Control panel background
+    sf::RectangleShape controlPanel;
+    controlPanel.setPosition(0, 0);
+    controlPanel.setSize(sf::Vector2f(Config::CONTROL_PANEL_WIDTH, Config::WINDOW_HEIGHT));
+    controlPanel.setFillColor(Config::CONTROL_PANEL_COLOR);
+
+    auto showTree = [&]() {
+        withTree([&](auto& tree) { canvas.setTree(tree.getRoot(), describe); });
+    };
+
+    auto refreshStats = [&]() {
+        withTree([&](auto& tree) {
+            typedef typename std::decay<decltype(tree)>::type TreeType;
+            typedef typename TreeType::KeyType Key;
+            std::ostringstream ss;
+            ss << "Keys: " << tree.getShapeStats().size() << "   Height: " << tree.getTreeHeight()
+               << "\nNode size: " << sizeof(typename TreeType::NodeType) << " B (key "
+               << sizeof(Key) << " B)"
+               << "\nSearch: " << (KeySearch<Key, KeyCompare<Key>>::BRANCHLESS
+                                       ? "branchless (conditional moves)"
+                                       : "three-way compare");
+            statsText.setString(ss.str());
+        });
+    };
+
+    // Input filter and labels follow the selected key type
+    auto applyKeyType = [&]() {
+        withTree([&](auto& tree) {
+            typedef typename std::decay<decltype(tree)>::type::KeyType Key;
+            TextInput::Kind kind = std::is_integral<Key>::value ? TextInput::INTEGER
+                                   : std::is_floating_point<Key>::value ? TextInput::DECIMAL
+                                   : TextInput::TEXT;
+            valueInput.setKind(kind, KeyFormat<Key>::MAX_INPUT);
+        });
+        keyTypeBtn.setText(std::string("Key Type: ") + KEY_TYPE_NAMES[keyType] + " (click to change)");
+        inputLabel.setString(std::string(KEY_TYPE_NAMES[keyType]) + " key:");
+        canvas.resetColors();
+        canvas.clearSteps();
+        showTree();
+        refreshStats();
+    };
+
+    // Parse the input as the tree's key type; shows an error and returns
+    // false when it is not one
+    auto readKey = [&](auto& tree, auto& key) {
+        typedef typename std::decay<decltype(tree)>::type::KeyType Key;
+        if (!KeyFormat<Key>::parse(valueInput.getText(), key)) {
+            messageBox.show(std::string("Error: Enter a valid ") + KeyFormat<Key>::name() + " key!",
+                            MessageBox::ERROR_MSG, 3.0f);
+            return false;
+        }
+        return true;
+    };
+
+    // Color the search path of 'key'; the last node gets 'lastFill' if it
+    // holds the key
+    auto queuePath = [&](auto& tree, const auto& key, const sf::Color& lastFill) {
+        typedef typename std::decay<decltype(tree)>::type::NodeType NodeType;
+        std::vector<NodeType*> path;
+        const NodeType* found = tree.search(key, path);
+        for (const NodeType* node : path) {
+            canvas.queueStep(node->id, node == found ? lastFill : TreeCanvas::VISITED_FILL);
+        }
+        return found != nullptr;
+    };
+
+    // Insert / remove without the rotation and path the AVL mode animates
+    auto insertKey = [&](auto& tree, const auto& key) {
+        std::vector<typename std::decay<decltype(tree)>::type::NodeType*> path;
+        RotationType rotation;
+        return tree.insert(key, path, rotation);
+    };
+
+    auto removeKey = [&](auto& tree, const auto& key) {
+        typedef typename std::decay<decltype(tree)>::type::NodeType NodeType;
+        std::vector<NodeType*> path;
+        NodeType* deletedNode = nullptr;
+        RotationType rotation;
+        bool success = tree.remove(key, path, deletedNode, rotation);
+        if (success && deletedNode) {
+            delete deletedNode;
+        }
+        return success;
+    };
+
+    applyKeyType();
+    sf::Clock clock;
+    bool running = true;
+
+    while (running && window.isOpen()) {
+        AllocationTracker::beginFrame();
+        float deltaTime = clock.restart().asSeconds();
+        canvas.setSpeed(speedSlider.getValue());
+
+        // Disable buttons during animation
+        bool canInteract = !canvas.isAnimating();
+        keyTypeBtn.setEnabled(canInteract);
+        insertBtn.setEnabled(canInteract);
+        deleteBtn.setEnabled(canInteract);
+        searchBtn.setEnabled(canInteract);
+        randomBtn.setEnabled(canInteract);
+        clearBtn.setEnabled(canInteract);
+        exportBtn.setEnabled(canInteract);
+
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                running = false;
+            }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                running = false;
+            }
+
+            valueInput.handleEvent(event, window);
+            speedSlider.handleEvent(event, window);
+
+            if (backBtn.handleEvent(event, window)) {
+                running = false;
+            }
+
+            // KEY TYPE: each type keeps its own tree
+            if (keyTypeBtn.handleEvent(event, window)) {
+                keyType = (keyType + 1) % KEY_TYPE_COUNT;
+                applyKeyType();
+            }
+
+            // INSERT operation
+            if (insertBtn.handleEvent(event, window)) {
+                withTree([&](auto& tree) {
+                    typename std::decay<decltype(tree)>::type::KeyType key;
+                    if (!readKey(tree, key)) return;
+                    std::string text = KeyFormat<decltype(key)>::format(key);
+                    canvas.resetColors();
+                    if (insertKey(tree, key)) {
+                        showTree();
+                        queuePath(tree, key, Config::NODE_NEW_FILL);
+                        messageBox.show("Inserted: " + text, MessageBox::SUCCESS, 2.0f);
+                    } else {
+                        queuePath(tree, key, Config::NODE_FOUND_FILL);
+                        messageBox.show("Error: " + text + " already exists!", MessageBox::ERROR_MSG, 3.0f);
+                    }
+                    refreshStats();
+                    valueInput.clear();
+                });
+            }
+
+            // DELETE operation
+            if (deleteBtn.handleEvent(event, window)) {
+                withTree([&](auto& tree) {
+                    typename std::decay<decltype(tree)>::type::KeyType key;
+                    if (!readKey(tree, key)) return;
+                    std::string text = KeyFormat<decltype(key)>::format(key);
+                    canvas.resetColors();
+                    if (removeKey(tree, key)) {
+                        showTree();
+                        messageBox.show("Deleted: " + text, MessageBox::SUCCESS, 2.0f);
+                    } else {
+                        queuePath(tree, key, Config::NODE_FOUND_FILL);
+                        messageBox.show("Error: " + text + " not found!", MessageBox::ERROR_MSG, 3.0f);
+                    }
+                    refreshStats();
+                    valueInput.clear();
+                });
+            }
+
+            // SEARCH operation
+            if (searchBtn.handleEvent(event, window)) {
+                withTree([&](auto& tree) {
+                    typename std::decay<decltype(tree)>::type::KeyType key;
+                    if (!readKey(tree, key)) return;
+                    std::string text = KeyFormat<decltype(key)>::format(key);
+                    canvas.resetColors();
+                    bool found = queuePath(tree, key, Config::NODE_FOUND_FILL);
+                    messageBox.show(found ? "Found: " + text : text + " not found",
+                                    found ? MessageBox::SUCCESS : MessageBox::INFO, 2.0f);
+                });
+            }
+
+            // RANDOM keys of the selected type
+            if (randomBtn.handleEvent(event, window)) {
+                withTree([&](auto& tree) {
+                    typename std::decay<decltype(tree)>::type::KeyType key;
+                    int added = 0;
+                    for (int i = 0; i < 10; i++) {
+                        makeRandomKey(random, key);
+                        if (insertKey(tree, key)) added++;
+                    }
+                    messageBox.show("Inserted " + std::to_string(added) + " random keys",
+                                    MessageBox::SUCCESS, 2.0f);
+                });
+                canvas.resetColors();
+                showTree();
+                refreshStats();
+            }
+
+            // CLEAR operation
+            if (clearBtn.handleEvent(event, window)) {
+                withTree([&](auto& tree) {
+                    if (!tree.isEmpty()) {
+                        tree.clear();
+                        messageBox.show("Tree cleared!", MessageBox::INFO, 2.0f);
+                    } else {
+                        messageBox.show("Tree is already empty.", MessageBox::INFO, 2.0f);
+                    }
+                });
+                showTree();
+                refreshStats();
+            }
+
+            // EXPORT PNG
+            if (exportBtn.handleEvent(event, window)) {
+                if (canvas.isEmpty()) {
+                    messageBox.show("Cannot export empty tree!", MessageBox::ERROR_MSG, 2.0f);
+                } else {
+                    window.display();
+                    if (exportVisualizationToPNG(window, "typed_keys_export.png",
+                                                  Config::TREE_AREA_X - 10, Config::TREE_AREA_Y - 40,
+                                                  Config::TREE_AREA_WIDTH + 20, Config::TREE_AREA_HEIGHT + 50)) {
+                        messageBox.show("Exported to typed_keys_export.png", MessageBox::SUCCESS, 3.0f);
+                    } else {
+                        messageBox.show("Export failed!", MessageBox::ERROR_MSG, 3.0f);
+                    }
+                }
+            }
+        }
+
+        // Update
+        AllocationTracker::setPhase(AllocationTracker::UPDATE);
+        valueInput.update(deltaTime);
+        canvas.update(deltaTime);
+        messageBox.update(deltaTime);
+
+        // Draw
+        AllocationTracker::setPhase(AllocationTracker::DRAW);
+        window.clear(Config::BACKGROUND_COLOR);
+        window.draw(controlPanel);
+        window.draw(titleText);
+        window.draw(inputLabel);
+        window.draw(legendText);
+        window.draw(statsText);
+        keyTypeBtn.draw(window);
+        valueInput.draw(window);
+        insertBtn.draw(window);
+        deleteBtn.draw(window);
+        searchBtn.draw(window);
+        randomBtn.draw(window);
+        clearBtn.draw(window);
+        speedSlider.draw(window);
+        exportBtn.draw(window);
+        backBtn.draw(window);
+        canvas.draw(window);
+        drawMemoryHud(window, font);
         messageBox.draw(window);
         window.display();
     }